@@ -0,0 +1,174 @@
+#include "Game/AIScheduler.hpp"
+#include "Game/Entity.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr double UPDATE_COST_SMOOTHING = 0.05;		// weight of the newest sample in the running average
+
+
+//-------------------------------------------------------------------------------------------------------------
+AIScheduler::AIScheduler( ai_scheduler_options_t const& options )
+{
+	SetOptions( options );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void AIScheduler::SetOptions( ai_scheduler_options_t const& options )
+{
+	m_options = options;
+	m_options.num_buckets = options.num_buckets < 1 ? 1 : options.num_buckets;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void AIScheduler::BeginFrame( std::vector<Entity*> const& entities, Vec2 const& playerPosition, float deltaSeconds )
+{
+	++m_frameIndex;
+	m_stats = AISchedulerStats();
+	m_candidates.clear();
+
+	int dueBucket = m_frameIndex % m_options.num_buckets;
+	float fullRateRadiusSquared = m_options.full_rate_radius * m_options.full_rate_radius;
+	float alwaysFullRateRadiusSquared = m_options.always_full_rate_radius * m_options.always_full_rate_radius;
+	for( Entity const* entity : entities )
+	{
+		if( entity == nullptr || !entity->IsNPC() || entity->IsPlayer() || entity->IsReadyToBeDeleted() )
+		{
+			continue;
+		}
+
+		auto found = m_npcs.find( entity );
+		if( found == m_npcs.end() )
+		{
+			ScheduledNPC newNPC;
+			newNPC.m_bucket = m_nextBucket++ % m_options.num_buckets;
+			newNPC.m_fromPosition = entity->m_position;
+			found = m_npcs.emplace( entity, newNPC ).first;
+		}
+		ScheduledNPC& npc = found->second;
+		npc.m_lastListedFrame = m_frameIndex;
+		++m_stats.m_numScheduled;
+
+		npc.m_owedSeconds += deltaSeconds;
+		float distanceSquared = GetDistanceSquared2D( entity->m_position, playerPosition );
+		npc.m_isFullRate = !m_options.is_enabled || distanceSquared <= alwaysFullRateRadiusSquared || ( entity->m_isSeenByPlayer && distanceSquared <= fullRateRadiusSquared );
+		npc.m_isDue = npc.m_isFullRate;
+		if( npc.m_isFullRate )
+		{
+			++m_stats.m_numFullRate;
+		}
+		else if( npc.m_bucket == dueBucket || npc.m_isBehind || npc.m_owedSeconds >= m_options.max_tick_seconds )
+		{
+			m_candidates.push_back( &npc );
+		}
+	}
+
+	// Left the list some other way than RemoveEntity, or stopped being an NPC we schedule
+	for( auto npcIter = m_npcs.begin(); npcIter != m_npcs.end(); )
+	{
+		if( npcIter->second.m_lastListedFrame != m_frameIndex )
+		{
+			npcIter = m_npcs.erase( npcIter );
+		}
+		else
+		{
+			++npcIter;
+		}
+	}
+
+	// Stalest first, so whatever the budget cannot cover this frame is the least overdue
+	std::sort( m_candidates.begin(), m_candidates.end(), []( ScheduledNPC const* a, ScheduledNPC const* b ) { return a->m_owedSeconds > b->m_owedSeconds; } );
+
+	double budgetLeft = m_options.budget_seconds;
+	for( int candidateIdx = 0; candidateIdx < (int)m_candidates.size(); ++candidateIdx )
+	{
+		ScheduledNPC& npc = *m_candidates[candidateIdx];
+		if( npc.m_owedSeconds >= m_options.max_tick_seconds || budgetLeft >= m_averageUpdateSeconds )
+		{
+			npc.m_isDue = true;
+			budgetLeft -= m_averageUpdateSeconds;
+		}
+		else
+		{
+			npc.m_isBehind = true;
+			++m_stats.m_numDeferred;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool AIScheduler::ShouldUpdate( Entity const* entity, float& inout_deltaSeconds )
+{
+	auto found = m_npcs.find( entity );
+	if( found == m_npcs.end() )
+	{
+		return true;	// not ours, or spawned mid-frame
+	}
+
+	ScheduledNPC& npc = found->second;
+	if( !npc.m_isDue )
+	{
+		return false;
+	}
+
+	inout_deltaSeconds = npc.m_owedSeconds;
+	npc.m_fromPosition = entity->GetRenderPosition();
+	npc.m_lastUpdateSeconds = npc.m_owedSeconds;
+	npc.m_owedSeconds = 0.f;
+	npc.m_isBehind = false;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void AIScheduler::RecordUpdate( Entity const* entity, double seconds )
+{
+	if( m_npcs.find( entity ) == m_npcs.end() )
+	{
+		return;
+	}
+
+	++m_stats.m_numUpdated;
+	if( m_averageUpdateSeconds == 0.0 )
+	{
+		m_averageUpdateSeconds = seconds;
+	}
+	else
+	{
+		m_averageUpdateSeconds += ( seconds - m_averageUpdateSeconds ) * UPDATE_COST_SMOOTHING;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void AIScheduler::EndFrame( std::vector<Entity*> const& entities )
+{
+	for( Entity* entity : entities )
+	{
+		if( entity == nullptr )
+		{
+			continue;
+		}
+
+		auto found = m_npcs.find( entity );
+		if( found == m_npcs.end() )
+		{
+			continue;
+		}
+
+		ScheduledNPC const& npc = found->second;
+		if( npc.m_isFullRate || npc.m_lastUpdateSeconds <= 0.f )
+		{
+			entity->m_isRenderPositionInterpolated = false;
+			continue;
+		}
+
+		float fractionOfMove = ClampZeroToOne( npc.m_owedSeconds / npc.m_lastUpdateSeconds );
+		entity->m_renderPosition = npc.m_fromPosition + ( entity->m_position - npc.m_fromPosition ) * fractionOfMove;
+		entity->m_isRenderPositionInterpolated = true;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void AIScheduler::RemoveEntity( Entity const* entity )
+{
+	m_npcs.erase( entity );
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include <unordered_map>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+class Entity;
+
+//-------------------------------------------------------------------------------------------------------------
+struct ai_scheduler_options_t
+{
+	bool	is_enabled = true;					// false updates every NPC every frame
+	float	full_rate_radius = 12.f;			// seen NPCs this close to the player update every frame
+	float	always_full_rate_radius = 3.f;		// and any NPC this close, seen or not, since it may be attacking
+	int		num_buckets = 4;					// everyone else updates once every this many frames, round-robin
+	double	budget_seconds = 0.001;				// for the reduced-rate updates each frame; the stalest go first
+	float	max_tick_seconds = 0.25f;			// an NPC this far behind updates regardless of the budget
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct AISchedulerStats
+{
+	int		m_numScheduled = 0;			// NPCs the scheduler considered this frame
+	int		m_numFullRate = 0;
+	int		m_numUpdated = 0;			// full-rate ones included
+	int		m_numDeferred = 0;			// due by bucket but over budget; first in line next frame
+};
+
+//-------------------------------------------------------------------------------------------------------------
+// Update level of detail for NPCs. Close NPCs the player can see update every frame; the rest are spread over
+// round-robin buckets and update with the time they are owed, within a per-frame budget estimated from the
+// measured cost of recent updates. Between their updates, reduced-rate NPCs render at a position interpolated
+// from where they were drawn toward where they now are, one update behind.
+//
+//	Per frame: BeginFrame, then for each entity ShouldUpdate and, if it did, RecordUpdate, then EndFrame.
+//	Entities are identified by pointer, so the list may be reordered or shrink between and during frames; call
+//	RemoveEntity before deleting one, since a new entity can be allocated at the same address. Players,
+//	projectiles and anything else that is not an NPC always update, with the frame's deltaSeconds.
+//-------------------------------------------------------------------------------------------------------------
+class AIScheduler
+{
+public:
+	explicit AIScheduler( ai_scheduler_options_t const& options = ai_scheduler_options_t() );
+
+	// Whether the player can see an NPC comes from its m_isSeenByPlayer
+	void	BeginFrame( std::vector<Entity*> const& entities, Vec2 const& playerPosition, float deltaSeconds );
+	bool	ShouldUpdate( Entity const* entity, float& inout_deltaSeconds );
+	void	RecordUpdate( Entity const* entity, double seconds );
+	void	EndFrame( std::vector<Entity*> const& entities );
+	void	RemoveEntity( Entity const* entity );
+
+	void							SetOptions( ai_scheduler_options_t const& options );
+	ai_scheduler_options_t const&	GetOptions() const				{ return m_options; }
+	AISchedulerStats const&			GetLastFrameStats() const		{ return m_stats; }
+	double							GetAverageUpdateSeconds() const	{ return m_averageUpdateSeconds; }
+
+private:
+	struct ScheduledNPC
+	{
+		int				m_bucket = 0;
+		float			m_owedSeconds = 0.f;		// simulated time since its last update
+		float			m_lastUpdateSeconds = 0.f;	// what that update covered; its move is interpolated over as long
+		Vec2			m_fromPosition;				// where it was drawn when it last updated
+		bool			m_isFullRate = false;
+		bool			m_isDue = false;
+		bool			m_isBehind = false;			// missed its bucket to the budget
+		int				m_lastListedFrame = 0;		// dropped once a BeginFrame no longer finds it in the list
+	};
+
+private:
+	ai_scheduler_options_t		m_options;
+	std::unordered_map<Entity const*, ScheduledNPC>	m_npcs;
+	std::vector<ScheduledNPC*>	m_candidates;		// into m_npcs, whose elements stay put until erased
+	int							m_frameIndex = 0;
+	int							m_nextBucket = 0;
+	double						m_averageUpdateSeconds = 0.0;
+	AISchedulerStats			m_stats;
+};
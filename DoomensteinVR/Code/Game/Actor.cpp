@@ -1,4 +1,5 @@
 #include "Game/Actor.hpp"
+#include "Game/Map.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/MeshUtils.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
@@ -56,7 +57,8 @@ void Actor::Update( float deltaSeconds )
 			g_theDebugRenderSystem->DebugAddWorldLine( p1, Rgba8::RED, p2, Rgba8::RED, 0.02f );
 		}
 
-		bool hasSeenPlayer = IsPointInForwardSector2D( player->m_position, m_position, m_yawDegrees, 80.f, PINKY_MAX_VISION_RANGE );
+		bool hasSeenPlayer = IsPointInForwardSector2D( player->m_position, m_position, m_yawDegrees, 80.f, PINKY_MAX_VISION_RANGE )
+			&& m_map->IsPotentiallyVisible( m_position, player->m_position );
 		if( hasSeenPlayer )
 		{
 			m_state = AIState::CHASE_TARGET;
@@ -68,8 +70,24 @@ void Actor::Update( float deltaSeconds )
 	{
 		Vec2 dispToPlayer = ( player->m_position - m_position ).GetNormalized();
 
+		// Follow the map's flow field around walls. It comes up empty before its first build and in the tile it was
+		// built toward, which lags a frame or more behind the player, so then ask the pathfinder for the next tile;
+		// straight at the player once next to them
+		Vec2 chaseDirection = m_map->GetChaseDirection( m_position );
+		if( chaseDirection == Vec2::ZERO )
+		{
+			chaseDirection = dispToPlayer;
+
+			std::vector<IntVec2> pathTiles;
+			if( m_map->FindPath( m_position, player->m_position, pathTiles ) && pathTiles.size() > 2 )
+			{
+				Vec2 nextTileCenter( (float)pathTiles[1].x + 0.5f, (float)pathTiles[1].y + 0.5f );
+				chaseDirection = ( nextTileCenter - m_position ).GetNormalized();
+			}
+		}
+
 		// Turn toward player
-		float goalAngle = Atan2Degrees( dispToPlayer.y, dispToPlayer.x );
+		float goalAngle = Atan2Degrees( chaseDirection.y, chaseDirection.x );
 		
 		while( fabsf( m_yawDegrees - goalAngle ) > 5.f )
 		{
@@ -177,7 +195,7 @@ void Actor::Render( Camera& camera )
 		default: g_theConsole->Error( "Invalid AI State!" );
 	}
 
-	Vec2 dispToCam = Vec2( camera.m_transform.m_position.x, camera.m_transform.m_position.y ) - m_position;
+	Vec2 dispToCam = Vec2( camera.m_transform.m_position.x, camera.m_transform.m_position.y ) - GetRenderPosition();
 	Vec2 dispToCamerLocal = dispToCam.GetRotatedDegrees( -m_yawDegrees );
 	float largestDotProduct = -9999.f;
 	int spriteIndex = 0;
@@ -211,7 +229,7 @@ void Actor::Render( Camera& camera )
 	}
 
 	
-	Vec3 centerPos = Vec3( m_position.x, m_position.y, m_flyingHeight ) + Vec3( 0.f, 0.f, 0.5f * m_spriteSize.y );
+	Vec3 centerPos = Vec3( GetRenderPosition(), m_flyingHeight ) + Vec3( 0.f, 0.f, 0.5f * m_spriteSize.y );
 	Vec3 BL, BR, TR, TL;
 	GetBillboardQuad( BL, BR, TR, TL, camera, centerPos, m_spriteSize, m_billboardMode );
 	Rgba8 tint = Rgba8::WHITE;
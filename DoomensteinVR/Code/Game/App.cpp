@@ -8,6 +8,7 @@
 #include "Engine/Core/Time.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Profiler.hpp"
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Network/NetworkSystem.hpp"
@@ -39,10 +40,14 @@ App::~App()
 void App::Startup( )
 {
 	Clock::SystemStartup();
+	Profiler::SystemStartup();
+
+	// Workers first: maps loaded by Game::StartUp post their PVS builds
+	g_theJobSystem = new JobSystem();
+	g_theJobSystem->StartUp();
 
 	g_theGame =  new Game();
 	g_theInput = new InputSystem();
-	//g_theJobSystem = new JobSystem();
 	g_theAudio = new AudioSystem();
 	g_theConsole = new DevConsole();
 	g_theRenderer = new RenderContext();
@@ -67,7 +72,6 @@ void App::Startup( )
 
 	// Initialize debug render system
 	g_theDebugRenderSystem->DebugRenderSystemStartup();
-	//g_theJobSystem->StartUp();
 }
 
 
@@ -76,11 +80,17 @@ void App::Shutdown()
 	g_theGame->ShutDown();
 	g_theConsole->Shutdown();
 	g_theLighthouse->ShutDown();
+	g_theDebugRenderSystem->DebugRenderSystemShutdown();	// owns render buffers, so before the renderer
 	g_theRenderer->Shutdown();
 	g_theNetwork->ShutDown();
-	g_theDebugRenderSystem->DebugRenderSystemShutdown();
 	Clock::SystemShutdown();
-	//g_theJobSystem->ShutDown();
+
+	// Last, so nothing shut down above is still waiting on a job
+	g_theJobSystem->ShutDown();
+	delete g_theJobSystem;
+	g_theJobSystem = nullptr;
+
+	Profiler::SystemShutdown();
 }
 
 void App::RunFrame()
@@ -93,14 +103,22 @@ void App::RunFrame()
 	{
 		deltaSeconds = 0.1f;
 	}
-	BeginFrame(); // For all engine systems( Not the game )
-	g_theGame->Update( static_cast<float>( deltaSeconds ) );
-	g_theLighthouse->RunMainLoop();
-	g_theConsole->Update( (float) deltaSeconds );
-	g_theRenderer->UpdateFrameTime( (float) deltaSeconds);
-	g_theDebugRenderSystem->DebugRenderBeginFrame();
-	Render();												 
-	EndFrame();
+	Profiler::BeginFrame();
+	{
+		PROFILE_SCOPE( "App::RunFrame" );
+		BeginFrame(); // For all engine systems( Not the game )
+		g_theGame->Update( static_cast<float>( deltaSeconds ) );
+		{
+			PROFILE_SCOPE( "LighthouseTracking::RunMainLoop" );
+			g_theLighthouse->RunMainLoop();
+		}
+		g_theConsole->Update( (float) deltaSeconds );
+		g_theRenderer->UpdateFrameTime( (float) deltaSeconds);
+		g_theDebugRenderSystem->DebugRenderBeginFrame();
+		Render();
+		EndFrame();
+	}
+	Profiler::EndFrame();	// after the frame scope closes, so this frame's tree is complete
 }
 
 bool App::HandleQuitRequested()
@@ -130,6 +148,8 @@ void App::BeginFrame()
 	g_theNetwork->BeginFrame();
 	g_theConsole->BeginFrame();
 	Clock::GetMaster()->BeginFrame();
+	g_theJobSystem->ClaimAndDeleteAllCompletedJobs();
+	g_theEventSystem->DispatchQueuedEvents();	// deliver events raised by worker/network threads last frame
 }
 
 void App::Render() const
@@ -10,3 +10,8 @@
 
 //#define ENGINE_DISABLE_AUDIO	// (If uncommented) Disables AudioSystem code and fmod linkage.
 
+//#define ENGINE_DISABLE_PROFILING	// (If uncommented) Compiles out PROFILE_SCOPE markers and the Profiler.
+
+#if defined( NDEBUG )
+	#define ENGINE_DISABLE_PROFILING	// shipping builds never pay for profiling markers
+#endif
@@ -5,10 +5,12 @@
 #include "Engine/Renderer/MeshUtils.hpp"
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Engine/Renderer/SpriteAnimDefinition.hpp"
+#include <cmath>
 
 Entity::Entity( EntityDef const& entityDef, Map* map )
 {
 	m_map = map;
+	m_def = &entityDef;
 
 	m_radius				= entityDef.m_physicsRadius;
 	m_height				= entityDef.m_height;
@@ -47,7 +49,7 @@ void Entity::Render( Camera& camera )
 	}
 
 	Anim* walkAnim = m_anims.at( "Walk" );
-	Vec2 dispToCam = Vec2( camera.m_transform.m_position.x, camera.m_transform.m_position.y ) - m_position;
+	Vec2 dispToCam = Vec2( camera.m_transform.m_position.x, camera.m_transform.m_position.y ) - GetRenderPosition();
 	Vec2 dispToCamerLocal = dispToCam.GetRotatedDegrees( -m_yawDegrees );
 	float largestDotProduct = -9999.f;
 	int spriteIndex = 0;
@@ -69,7 +71,7 @@ void Entity::Render( Camera& camera )
 	Vec2 uvMins, uvMaxs;
 	spriteDef.GetUVs( uvMins, uvMaxs );
 
-	Vec3 centerPos = Vec3( m_position.x, m_position.y, 0.f ) + Vec3( 0.f, 0.f, 0.5f * m_spriteSize.y );
+	Vec3 centerPos = Vec3( GetRenderPosition(), 0.f ) + Vec3( 0.f, 0.f, 0.5f * m_spriteSize.y );
 	Vec3 BL, BR, TR, TL;
 	GetBillboardQuad( BL, BR, TR, TL, camera, centerPos, m_spriteSize, m_billboardMode );
 	Rgba8 tint = Rgba8::WHITE;
@@ -143,6 +145,20 @@ Vec3 Entity::GetEyePosition() const
 	return eyePosition;
 }
 
+//-------------------------------------------------------------------------------------------------------------
+// Centered on the billboard; big enough for the quad at any facing and for the debug cylinder
+//-------------------------------------------------------------------------------------------------------------
+void Entity::GetCullingSphere( Vec3& out_center, float& out_radius ) const
+{
+	float halfSpriteHeight = 0.5f * m_spriteSize.y;
+	out_center = Vec3( GetRenderPosition(), halfSpriteHeight );
+
+	float spriteRadius = sqrtf( 0.25f * m_spriteSize.x * m_spriteSize.x + halfSpriteHeight * halfSpriteHeight );
+	float cylinderHalfHeight = halfSpriteHeight > m_height - halfSpriteHeight ? halfSpriteHeight : m_height - halfSpriteHeight;
+	float cylinderRadius = sqrtf( m_radius * m_radius + cylinderHalfHeight * cylinderHalfHeight );
+	out_radius = spriteRadius > cylinderRadius ? spriteRadius : cylinderRadius;
+}
+
 void Entity::SetIsPlayer( bool isPlayer )
 {
 	m_isPlayer = isPlayer;
@@ -51,7 +51,9 @@ public:
 	virtual void		AddDebugDrawVertsToMesh( Mesh_PCT& mesh, Camera const& camera ) const;
 	virtual FloatRange	GetZRange() const;
 	virtual Vec3		GetEyePosition() const;
+	virtual void		GetCullingSphere( Vec3& out_center, float& out_radius ) const;
 	virtual Vec2		GetForwardVector() const;
+	Vec2				GetRenderPosition() const		{ return m_isRenderPositionInterpolated ? m_renderPosition : m_position; }
 	virtual void		SetIsPlayer( bool isPlayer );
 	virtual void		SetFaction( Faction faction );
 
@@ -59,6 +61,9 @@ public:
 	float				m_lifeTime = 0.f;
 
 	Vec2				m_position;
+	Vec2				m_renderPosition;						// set by the AIScheduler between reduced-rate updates
+	bool				m_isRenderPositionInterpolated = false;
+	bool				m_isSeenByPlayer = true;				// from the map's last visibility pass; read by the AIScheduler
 	int					m_health = 100;
 	float				m_yawDegrees = 0.f;
 	bool				m_isDead = false;
@@ -88,6 +93,10 @@ public:
 
 	AIState				m_state = AIState::IDLE;
 
+	// Replication
+	EntityDef const*	m_def = nullptr;
+	uint16_t			m_netId = 0;		// assigned by Map::AddEntityToMap; same on every peer that loaded the same map
+
 protected:
 	Map*				m_map  = nullptr;
 };
\ No newline at end of file
@@ -105,8 +105,11 @@ EntityDef::EntityDef( XmlElement const& entityDef )
 				return;
 			}
 
-			Texture* spriteSheetTexture = g_theRenderer->CreateOrGetTextureFromFile( m_spriteSheetFilePath.c_str() );
-			m_spriteSheet = new SpriteSheet( *spriteSheetTexture, m_spriteSheetLayout );
+			if( g_theRenderer )	// headless runs only need the gameplay data
+			{
+				Texture* spriteSheetTexture = g_theRenderer->CreateOrGetTextureFromFile( m_spriteSheetFilePath.c_str() );
+				m_spriteSheet = new SpriteSheet( *spriteSheetTexture, m_spriteSheetLayout );
+			}
 			//if( !spriteSheetTexture )
 			//{
 			//	g_theConsole->Error( "ERROR:Failed to create texture for %s: %s", m_className.c_str(), m_typeName.c_str() );
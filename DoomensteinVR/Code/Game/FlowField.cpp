@@ -0,0 +1,185 @@
+#include "Game/FlowField.hpp"
+#include "Game/TileMap.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <utility>
+
+//-------------------------------------------------------------------------------------------------------------
+extern JobSystem*	g_theJobSystem;
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr float DIAGONAL_STEP_COST = 1.41421356f;
+
+//-------------------------------------------------------------------------------------------------------------
+void FlowField::Build( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, IntVec2 const& goalTile )
+{
+	m_dimensions = dimensions;
+	m_goalTile = goalTile;
+	int numTiles = dimensions.x * dimensions.y;
+	m_distances.assign( numTiles, FLOW_FIELD_UNREACHABLE );
+	m_nextTiles.assign( numTiles, -1 );
+
+	if( goalTile.x < 0 || goalTile.x >= dimensions.x || goalTile.y < 0 || goalTile.y >= dimensions.y )
+	{
+		return;
+	}
+
+	// Dijkstra outward from the goal; each tile's next step is the tile it was reached from
+	typedef std::pair<float, int> OpenTile;
+	std::priority_queue< OpenTile, std::vector<OpenTile>, std::greater<OpenTile> > openTiles;
+	int goalIndex = goalTile.x + ( dimensions.x * goalTile.y );
+	m_distances[goalIndex] = 0.f;
+	openTiles.push( OpenTile( 0.f, goalIndex ) );
+
+	while( !openTiles.empty() )
+	{
+		OpenTile current = openTiles.top();
+		openTiles.pop();
+		float distance = current.first;
+		int tileIndex = current.second;
+		if( distance > m_distances[tileIndex] )
+		{
+			continue;	// already settled through a shorter route
+		}
+
+		int tileX = tileIndex % dimensions.x;
+		int tileY = tileIndex / dimensions.x;
+		bool isOpenEast  = tileX + 1 < dimensions.x && !isSolid[tileIndex + 1];
+		bool isOpenWest  = tileX > 0 && !isSolid[tileIndex - 1];
+		bool isOpenNorth = tileY + 1 < dimensions.y && !isSolid[tileIndex + dimensions.x];
+		bool isOpenSouth = tileY > 0 && !isSolid[tileIndex - dimensions.x];
+
+		int neighbors[8];
+		float stepCosts[8];
+		int numNeighbors = 0;
+		if( isOpenEast )	{ neighbors[numNeighbors] = tileIndex + 1;				stepCosts[numNeighbors++] = 1.f; }
+		if( isOpenWest )	{ neighbors[numNeighbors] = tileIndex - 1;				stepCosts[numNeighbors++] = 1.f; }
+		if( isOpenNorth )	{ neighbors[numNeighbors] = tileIndex + dimensions.x;	stepCosts[numNeighbors++] = 1.f; }
+		if( isOpenSouth )	{ neighbors[numNeighbors] = tileIndex - dimensions.x;	stepCosts[numNeighbors++] = 1.f; }
+
+		// Diagonals only past two open sides, so nobody is led into a wall corner
+		if( isOpenNorth && isOpenEast && !isSolid[tileIndex + dimensions.x + 1] )	{ neighbors[numNeighbors] = tileIndex + dimensions.x + 1;	stepCosts[numNeighbors++] = DIAGONAL_STEP_COST; }
+		if( isOpenNorth && isOpenWest && !isSolid[tileIndex + dimensions.x - 1] )	{ neighbors[numNeighbors] = tileIndex + dimensions.x - 1;	stepCosts[numNeighbors++] = DIAGONAL_STEP_COST; }
+		if( isOpenSouth && isOpenEast && !isSolid[tileIndex - dimensions.x + 1] )	{ neighbors[numNeighbors] = tileIndex - dimensions.x + 1;	stepCosts[numNeighbors++] = DIAGONAL_STEP_COST; }
+		if( isOpenSouth && isOpenWest && !isSolid[tileIndex - dimensions.x - 1] )	{ neighbors[numNeighbors] = tileIndex - dimensions.x - 1;	stepCosts[numNeighbors++] = DIAGONAL_STEP_COST; }
+
+		for( int neighborIdx = 0; neighborIdx < numNeighbors; ++neighborIdx )
+		{
+			int neighbor = neighbors[neighborIdx];
+			float neighborDistance = distance + stepCosts[neighborIdx];
+			if( neighborDistance < m_distances[neighbor] )
+			{
+				m_distances[neighbor] = neighborDistance;
+				m_nextTiles[neighbor] = tileIndex;
+				openTiles.push( OpenTile( neighborDistance, neighbor ) );
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+float FlowField::GetDistanceToGoal( Vec2 const& position ) const
+{
+	int tileIndex = GetTileIndex( position );
+	return tileIndex < 0 ? FLOW_FIELD_UNREACHABLE : m_distances[tileIndex];
+}
+
+//-------------------------------------------------------------------------------------------------------------
+Vec2 FlowField::GetFlowDirection( Vec2 const& position ) const
+{
+	int tileIndex = GetTileIndex( position );
+	if( tileIndex < 0 || m_nextTiles[tileIndex] < 0 )
+	{
+		return Vec2::ZERO;
+	}
+
+	int nextTile = m_nextTiles[tileIndex];
+	Vec2 nextTileCenter( (float)( nextTile % m_dimensions.x ) + 0.5f, (float)( nextTile / m_dimensions.x ) + 0.5f );
+	return ( nextTileCenter - position ).GetNormalized();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int FlowField::GetTileIndex( Vec2 const& position ) const
+{
+	int tileX = (int)floorf( position.x );
+	int tileY = (int)floorf( position.y );
+	if( !IsValid() || tileX < 0 || tileX >= m_dimensions.x || tileY < 0 || tileY >= m_dimensions.y )
+	{
+		return -1;
+	}
+
+	return tileX + ( m_dimensions.x * tileY );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+class FlowFieldJob : public Job
+{
+public:
+	explicit FlowFieldJob( SharedFlowField* owner )
+		: Job(),
+		m_owner( owner )
+	{
+		m_jobFlags = JOB_FLAG_DELETE_ON_COMPLETE;
+	}
+
+	virtual void Execute() override
+	{
+		m_owner->m_nextField.Build( m_owner->m_nextIsSolid, m_owner->m_nextDimensions, m_owner->m_nextGoalTile );
+		m_owner->m_isBuilding.store( false );	// Update may swap the fields, or the destructor return, as soon as this is seen
+	}
+
+	virtual void OnCompleteCallback() override
+	{
+	}
+
+public:
+	SharedFlowField*	m_owner = nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+SharedFlowField::~SharedFlowField()
+{
+	while( m_isBuilding.load() )
+	{
+		std::this_thread::yield();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SharedFlowField::Update( TileMap const& tileMap, IntVec2 const& goalTile )
+{
+	if( m_isBuilding.load() )
+	{
+		return;
+	}
+
+	if( m_hasNextField )
+	{
+		std::swap( m_currentField, m_nextField );
+		m_hasNextField = false;
+	}
+
+	if( m_currentField.IsValid() && m_currentField.GetGoalTile() == goalTile )
+	{
+		return;
+	}
+
+	tileMap.GetTileSolidity( m_nextIsSolid );
+	m_nextDimensions = tileMap.GetTileDimensions();
+	m_nextGoalTile = goalTile;
+	++m_numBuilds;
+
+	// The first field is built inline, so chasers always have one to sample
+	if( !m_currentField.IsValid() || g_theJobSystem == nullptr || !g_theJobSystem->AreWorkersRunning() )
+	{
+		m_currentField.Build( m_nextIsSolid, m_nextDimensions, m_nextGoalTile );
+		return;
+	}
+
+	m_isBuilding.store( true );
+	m_hasNextField = true;
+	g_theJobSystem->PostJob( new FlowFieldJob( this ) );
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+class TileMap;
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr float FLOW_FIELD_UNREACHABLE = 3.402823466e+38f;	// FLT_MAX
+
+//-------------------------------------------------------------------------------------------------------------
+// Dijkstra distances from every open tile to one goal tile, over 8-connected moves (diagonals cost sqrt(2) and
+// may not cut a solid corner), plus the first step of a shortest path from each tile. Built once per goal and
+// sampled in O(1) by any number of agents.
+//-------------------------------------------------------------------------------------------------------------
+class FlowField
+{
+public:
+	void	Build( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, IntVec2 const& goalTile );	// isSolid is x-fastest, one per tile
+
+	bool	IsValid() const						{ return !m_nextTiles.empty(); }
+	IntVec2	GetGoalTile() const					{ return m_goalTile; }
+	float	GetDistanceToGoal( Vec2 const& position ) const;	// in tiles; FLOW_FIELD_UNREACHABLE off the map or walled off
+
+	// Unit direction from position toward the center of the next tile on its shortest path; zero in the goal tile,
+	// in unreachable tiles and off the map, where the caller should head straight for the goal instead
+	Vec2	GetFlowDirection( Vec2 const& position ) const;
+
+private:
+	int		GetTileIndex( Vec2 const& position ) const;	// -1 off the map
+
+private:
+	IntVec2				m_dimensions = IntVec2::ZERO;
+	IntVec2				m_goalTile = IntVec2::ZERO;
+	std::vector<float>	m_distances;
+	std::vector<int>	m_nextTiles;		// tile index of the first step toward the goal; -1 for the goal and unreachable tiles
+};
+
+//-------------------------------------------------------------------------------------------------------------
+// One FlowField toward a goal that moves between tiles, shared by every agent chasing it. When the goal changes
+// tile the next field is built from a snapshot of the map on a JobSystem worker, while agents keep sampling the
+// current one; it is swapped in by the first Update after it finishes. Without workers it is built inline.
+//-------------------------------------------------------------------------------------------------------------
+class SharedFlowField
+{
+public:
+	~SharedFlowField();		// waits out a build still in flight
+
+	void				Update( TileMap const& tileMap, IntVec2 const& goalTile );
+	FlowField const&	GetField() const		{ return m_currentField; }
+	int					GetNumBuilds() const	{ return m_numBuilds; }
+
+private:
+	friend class FlowFieldJob;
+
+	FlowField				m_currentField;
+	FlowField				m_nextField;			// only touched by the worker while m_isBuilding
+	std::vector<uint8_t>	m_nextIsSolid;
+	IntVec2					m_nextDimensions = IntVec2::ZERO;
+	IntVec2					m_nextGoalTile = IntVec2::ZERO;
+	std::atomic<bool>		m_isBuilding = false;
+	bool					m_hasNextField = false;
+	int						m_numBuilds = 0;
+};
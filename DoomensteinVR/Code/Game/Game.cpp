@@ -7,11 +7,15 @@
 #include "Game/Actor.hpp"
 #include "Game/Projectile.hpp"
 #include "Game/LighthouseTracking.hpp"
+#include "Game/SnapshotReplication.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Profiler.hpp"
 #include "Engine/Core/Image.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Renderer/MeshUtils.hpp"
+#include "Engine/Renderer/MeshFile.hpp"
+#include "Engine/Renderer/MeshOptimizer.hpp"
 #include "Engine/Renderer/ShaderState.hpp"
 #include "Engine/Renderer/Material.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
@@ -20,6 +24,7 @@
 #include "Engine/Input/InputSystem.hpp"
 #include "Engine/Physics/GameObject.hpp"
 #include "Engine/Math/MatrixUtils.hpp"
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -40,6 +45,9 @@ Game::~Game()
 {
 	m_teleportingState = eVRControllerTeleportingState::INVALID;
 
+	delete m_snapshotSession;
+	m_snapshotSession = nullptr;
+
 	delete m_theWorld;
 	m_theWorld = nullptr;
 }
@@ -136,11 +144,27 @@ void Game::StartUp()
 	std::vector<uint32_t> indices;
 	mesh_import_options_t options;
 	LoadModel( vertices, indices, "Data/Models/Bullet.obj", options );
+	BuildMeshLODChain( vertices, indices, m_bulletLODs );
 	m_bulletMesh = new GPUMesh( g_theRenderer );
 	m_bulletMesh->UpdateVertices( vertices );
 	m_bulletMesh->UpdateIndices( indices );
 }
 
+//-------------------------------------------------------------------------------------------------------------
+void Game::StartUpHeadless()
+{
+	m_physics = new Physics2D();
+	m_physics->StartUp();
+
+	g_rng = new RandomNumberGenerator();
+
+	EntityDef::LoadDefinitions( "Data/Definitions/EntityTypes.xml" );
+	MapMaterial::LoadDefinitions( "Data/Definitions/MapMaterialTypes.xml" );
+	MapRegionType::LoadDefinitions( "Data/Definitions/MapRegionTypes.xml" );
+
+	m_theWorld = new World( m_worldCameraLeft, m_worldCameraRight );
+}
+
 void Game::ShutDown()
 {
 	// should for loop through s_definitions instead to delete
@@ -159,6 +183,9 @@ void Game::ShutDown()
 	delete m_physics; 
 	m_physics = nullptr;
 
+	delete g_rng;
+	g_rng = nullptr;
+
 	delete m_meshCube;
 	m_meshCube = nullptr;
 
@@ -185,6 +212,16 @@ void Game::ShutDown()
 #endif
 }
 
+//-------------------------------------------------------------------------------------------------------------
+void Game::ShutDownHeadless()
+{
+	delete m_physics;
+	m_physics = nullptr;
+
+	delete g_rng;
+	g_rng = nullptr;
+}
+
 void Game::EndFrame()
 {
 	m_physics->EndFrame();
@@ -192,6 +229,7 @@ void Game::EndFrame()
 
 void Game::Update( float deltaSeconds )
 {
+	PROFILE_FUNCTION();
 	m_worldCameraLeft.SetClearMode( CLEAR_COLOR_BIT, m_colorClearScreen );
 	m_worldCameraRight.SetClearMode( CLEAR_COLOR_BIT, m_colorClearScreen );
 
@@ -210,6 +248,9 @@ void Game::Update( float deltaSeconds )
 	//m_lightMaster.lightConstants.lights[0].direction = cameraModel.TransformVector3D( Vec3(0,0,-1) ).GetNormalized(); 
 
 	m_theWorld->Update( deltaSeconds );
+	if( m_snapshotSession && m_theWorld->m_currentMap ) {
+		m_snapshotSession->Update( *m_theWorld->m_currentMap, deltaSeconds );
+	}
 
 	// Snap camera to player entity's current eye position and orientation
 	Entity* player = GetPlayer();
@@ -325,17 +366,32 @@ void Game::RenderUI() const
 //-------------------------------------------------------------------------------------------------------------
 void Game::Render()
 {
+	PROFILE_FUNCTION();
 	// setup lights for the scene
 	g_theRenderer->SetAmbientLight( m_ambientLightColor, m_ambientIntensity );
 
-	for( int idx = 0; idx < MAX_NUM_LIGHTS; ++idx ) {
-		g_theRenderer->EnableLight( idx, m_lightMaster.lightConstants.lights[idx] );
-	}
+	// clusters need the eyes' perspective projections, which only the headset provides
+	m_isLightClusteringEnabled = g_theLighthouse->IsValid();
+	GatherSceneLights();
+
+	// Each eye's projection split from its head pose: the clusters are built in the static eye space
+	Mat44 leftEyeProjection;
+	Mat44 leftEyeFromWorld;
+	Mat44 rightEyeProjection;
+	Mat44 rightEyeFromWorld;
 
 	if( g_theLighthouse->IsValid() )
 	{
 		g_theLighthouse->RenderFrame();
 
+		leftEyeProjection = ConvertMatrix4ToMat44( g_theLighthouse->m_mat4ProjectionLeft );
+		leftEyeFromWorld = ConvertMatrix4ToMat44( g_theLighthouse->m_mat4eyePosLeft * g_theLighthouse->m_mat4HMDPose );
+		leftEyeFromWorld.TransformBy( m_worldCameraLeft.GetViewMatrix() );
+
+		rightEyeProjection = ConvertMatrix4ToMat44( g_theLighthouse->m_mat4ProjectionRight );
+		rightEyeFromWorld = ConvertMatrix4ToMat44( g_theLighthouse->m_mat4eyePosRight * g_theLighthouse->m_mat4HMDPose );
+		rightEyeFromWorld.TransformBy( m_worldCameraRight.GetViewMatrix() );
+
 		// Set Cameras' Projection Matrix
 		Mat44 currentLeftEyeProjectionMat = ConvertMatrix4ToMat44( g_theLighthouse->GetCurrentViewProjectionMatrix( vr::Eye_Left ) );
 		m_worldCameraLeft.SetProjectionMatrix( currentLeftEyeProjectionMat );
@@ -344,10 +400,14 @@ void Game::Render()
 		m_worldCameraRight.SetProjectionMatrix( currentRightEyeProjectionMat );
 	}
 
+	// Cull once for both eyes
+	m_theWorld->UpdateVisibility();
+
 	//-------------------------------------------------------------------------------------------------------------
 	// -----Render right world camera -----
 	//-------------------------------------------------------------------------------------------------------------
 	m_worldCameraRight.SetColorTarget( g_theRenderer->GetBackBuffer() );
+	BindLightClustersForEye( rightEyeProjection, rightEyeFromWorld, m_rightEyeLightClusters );
 	g_theRenderer->BeginCamera( m_worldCameraRight );
 
 	g_theRenderer->BindMaterial( m_stoneMaterial );
@@ -362,12 +422,13 @@ void Game::Render()
 
 	g_theRenderer->EndCamera( m_worldCameraRight );
 
-	Texture noMSAARightEyeTex = Texture( g_theRenderer->GetBackBuffer() );
-	g_theRenderer->m_context->ResolveSubresource( noMSAARightEyeTex.GetHandle(), D3D11CalcSubresource(0, 0, 1), g_theRenderer->GetBackBuffer()->GetHandle(), D3D11CalcSubresource(0, 0, 1), DXGI_FORMAT_R8G8B8A8_UNORM );
+	Texture* noMSAARightEyeTex = g_theRenderer->AcquireRenderTargetMatching( g_theRenderer->GetBackBuffer() );
+	g_theRenderer->ResolveTexture( noMSAARightEyeTex, g_theRenderer->GetBackBuffer() );
 	//-------------------------------------------------------------------------------------------------------------
 	// -----Render left world camera -----
 	//-------------------------------------------------------------------------------------------------------------
 	m_worldCameraLeft.SetColorTarget( g_theRenderer->GetBackBuffer() );
+	BindLightClustersForEye( leftEyeProjection, leftEyeFromWorld, m_leftEyeLightClusters );
 	g_theRenderer->BeginCamera( m_worldCameraLeft );
 
 	// Render the World
@@ -383,16 +444,16 @@ void Game::Render()
 
 	g_theRenderer->EndCamera( m_worldCameraLeft );
 
-	Texture noMSAALeftEyeTex = Texture( g_theRenderer->GetBackBuffer() );
-	g_theRenderer->m_context->ResolveSubresource( noMSAALeftEyeTex.GetHandle(), D3D11CalcSubresource( 0, 0, 1 ), g_theRenderer->GetBackBuffer()->GetHandle(), D3D11CalcSubresource( 0, 0, 1 ), DXGI_FORMAT_R8G8B8A8_UNORM );
+	Texture* noMSAALeftEyeTex = g_theRenderer->AcquireRenderTargetMatching( g_theRenderer->GetBackBuffer() );
+	g_theRenderer->ResolveTexture( noMSAALeftEyeTex, g_theRenderer->GetBackBuffer() );
 	//-------------------------------------------------------------------------------------------------------------
 	// Submit both eyes texture to the vr compositor
 	if( g_theLighthouse->IsValid() )
 	{
 		//g_theLighthouse->RenderFrame();
 		
-		vr::Texture_t leftEyeTexture ={ noMSAALeftEyeTex.GetHandle(), vr::TextureType_DirectX, vr::ColorSpace_Auto };
-		vr::Texture_t rightEyeTexture ={ noMSAARightEyeTex.GetHandle(), vr::TextureType_DirectX, vr::ColorSpace_Auto };
+		vr::Texture_t leftEyeTexture ={ noMSAALeftEyeTex->GetHandle(), vr::TextureType_DirectX, vr::ColorSpace_Auto };
+		vr::Texture_t rightEyeTexture ={ noMSAARightEyeTex->GetHandle(), vr::TextureType_DirectX, vr::ColorSpace_Auto };
 
 		vr::EVRCompositorError error1 = vr::VRCompositor()->Submit( vr::Eye_Left, &leftEyeTexture );
 		if( error1 ) {
@@ -404,6 +465,8 @@ void Game::Render()
 			g_theConsole->Error( "Error: Call to VRCompositor()->Submit right eye texture failed, error= %d", error2 );
 		}
 	}
+	g_theRenderer->ReleaseRenderTarget( noMSAALeftEyeTex );
+	g_theRenderer->ReleaseRenderTarget( noMSAARightEyeTex );
 		  
 	g_theDebugRenderSystem->DebugRenderScreenTo( g_theRenderer->GetBackBuffer() );
 
@@ -467,6 +530,7 @@ void Game::CreateSphereTBN()
 	std::vector<uint> indices;
 
 	AddUVSphereToIndexedVertexArrayTBN( vertices, indices, Vec3::ZERO/*Vec3( -5.f, 0.f, -5.f )*/, 1.5f, 20, 20, Rgba8::WHITE );
+	OptimizeIndexedMesh( vertices, indices );
 
 	meshSphereTBN->UpdateVertices( vertices );
 	meshSphereTBN->UpdateIndices( indices );
@@ -510,6 +574,7 @@ void Game::CreateSphereMesh()
 	std::vector<uint> indices;
 
 	AddUVSphereToIndexedVertexArray( vertices, indices, Vec3( 5.f, 5.f, -15.f ), 2.f, 20, 20, Rgba8::WHITE );
+	OptimizeIndexedMesh( vertices, indices );
 
 	m_meshSphere->UpdateVertices( vertices );
 	m_meshSphere->UpdateIndices( indices );
@@ -588,7 +653,7 @@ void Game::AddHUDScreenRender()
 {
 	// Add HUD element
 	Texture* hudTexture = g_theRenderer->CreateOrGetTextureFromFile( "Data/Images/Hud_Base.png" );
-	float hudWidth = g_theRenderer->m_swapchain->GetBackBuffer()->GetDimensions().x;
+	float hudWidth = g_theRenderer->GetBackBuffer()->GetDimensions().x;
 	float hudHeight =  hudWidth / hudTexture->GetAspect();
 	AABB2 hudBounds = AABB2( Vec2::ZERO, Vec2( hudWidth, hudHeight ) );
 	g_theDebugRenderSystem->DebugAddScreenTexturedQuad( hudBounds, hudTexture );
@@ -663,14 +728,9 @@ void Game::ProcessInput( float deltaSeconds )
 
 void Game::TestOBJLoader()
 {
-	std::vector<Vertex_PCUTBN> verts;
-	std::vector<uint> indices;
 	char const* filename = "Data/Models/Miku.obj";
 	mesh_import_options_t meshImportOptionsData;
-	LoadOBJToVertexArray( verts, indices, filename, meshImportOptionsData );
-
-	GPUMesh* mesh = new GPUMesh( g_theRenderer );
-	mesh->UpdateVertices( verts );
+	GPUMesh* mesh = LoadCookedOBJMesh( g_theRenderer, filename, meshImportOptionsData );
 	
 	GameObject* miku = new GameObject();
 	miku->SetMesh( mesh );
@@ -680,15 +740,10 @@ void Game::TestOBJLoader()
 
 void Game::CreateFighterMesh()
 {
-	std::vector<Vertex_PCUTBN> verts;
-	std::vector<uint> indices;
 	char const* filename = "Data/Models/vr_controller_vive_1_5.obj";
 	mesh_import_options_t meshImportOptionsData;
 	meshImportOptionsData.generate_tangents = true;
-	LoadOBJToVertexArray( verts, indices, filename, meshImportOptionsData );
-
-	GPUMesh* mesh = new GPUMesh( g_theRenderer );
-	mesh->UpdateVertices( verts );
+	GPUMesh* mesh = LoadCookedOBJMesh( g_theRenderer, filename, meshImportOptionsData );
 
 	GameObject* fighter = new GameObject();
 	fighter->SetMesh( mesh );
@@ -698,15 +753,10 @@ void Game::CreateFighterMesh()
 
 void Game::CreateCane()
 {
-	std::vector<Vertex_PCUTBN> verts;
-	std::vector<uint> indices;
 	char const* filename = "Data/Models/Cane.obj";
 	mesh_import_options_t meshImportOptionsData;
 	meshImportOptionsData.generate_tangents = true;
-	LoadOBJToVertexArray( verts, indices, filename, meshImportOptionsData );
-
-	GPUMesh* mesh = new GPUMesh( g_theRenderer );
-	mesh->UpdateVertices( verts );
+	GPUMesh* mesh = LoadCookedOBJMesh( g_theRenderer, filename, meshImportOptionsData );
 
 	GameObject* go = new GameObject();
 	go->SetMesh( mesh );
@@ -1144,6 +1194,69 @@ void Game::UpdateLightBehaviors()
 	//}
 }
 
+//-------------------------------------------------------------------------------------------------------------
+// Directional lights always take their light constant. The rest go to the clusters when clustering is on, which
+// also gives every live projectile a small glow; otherwise they take their constants as before.
+//-------------------------------------------------------------------------------------------------------------
+void Game::GatherSceneLights()
+{
+	m_clusteredLights.clear();
+	for( int idx = 0; idx < MAX_NUM_LIGHTS; ++idx )
+	{
+		light_t const& light = m_lightMaster.lightConstants.lights[idx];
+		if( m_isLightClusteringEnabled && light.direction_factor < 1.f )
+		{
+			m_clusteredLights.push_back( light );
+			g_theRenderer->DisableLight( idx );
+		}
+		else
+		{
+			g_theRenderer->EnableLight( idx, light );
+		}
+	}
+
+	Map* map = m_theWorld != nullptr ? m_theWorld->m_currentMap : nullptr;
+	if( !m_isLightClusteringEnabled || map == nullptr )
+	{
+		return;
+	}
+
+	for( Entity* entity : map->m_projectiles )
+	{
+		if( entity == nullptr || entity->IsDead() )
+		{
+			continue;
+		}
+
+		light_t glow;
+		glow.color = Vec3( 0.45f, 0.65f, 1.f );
+		glow.intensity = 0.5f;
+		glow.position = static_cast<Projectile*>( entity )->m_transform.m_position;
+		glow.attenuation = Vec3( 0.f, 0.f, 4.f );		// fades out within about 5 units
+		m_clusteredLights.push_back( glow );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void Game::BindLightClustersForEye( Mat44 const& eyeProjection, Mat44 const& eyeFromWorld, LightClusterGrid& grid )
+{
+	if( !m_isLightClusteringEnabled )
+	{
+		g_theRenderer->DisableLightClusters();
+		return;
+	}
+
+	// The cluster bounds cost milliseconds to rebuild, so they follow the eye's fixed projection only; the head pose
+	// goes into eyeFromWorld, and eyeProjection * eyeFromWorld is the camera's PROJECTION * VIEW the shader uses.
+	// Depth range is the headset's clip planes (LighthouseTracking).
+	if( memcmp( &grid.GetProjection(), &eyeProjection, sizeof( Mat44 ) ) != 0 )
+	{
+		grid.SetProjection( eyeProjection, g_theLighthouse->m_fNearClip, g_theLighthouse->m_fFarClip );
+	}
+	grid.Build( eyeFromWorld, m_clusteredLights );
+	g_theRenderer->BindLightClusters( grid );
+}
+
 //-------------------------------------------------------------------------------------------------------------
 void Game::DectectVRControllerRaycast()
 {
@@ -2,7 +2,9 @@
 #include "Game/World.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/MeshSimplifier.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
+#include "Engine/Renderer/LightClusters.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/OBB2.hpp"
@@ -22,6 +24,7 @@ class GameObject;
 class Entity;
 class LighthouseTracking;
 class Matrix4;
+class SnapshotSession;
 
 //-------------------------------------------------------------------------------------------------------------------------
 enum class eVRControllerTeleportingState
@@ -68,7 +71,9 @@ public:
 	~Game();
 
 	void StartUp();
+	void StartUpHeadless();		// simulation data only: no renderer, audio or VR
 	void ShutDown();
+	void ShutDownHeadless();		// pairs with StartUpHeadless
 	void EndFrame();
 	void Update( float deltaSeconds );
 	void Render();
@@ -85,6 +90,8 @@ public:
 	void UpdateMaterialConstants();
 	void AddCameraInfoScreenText();
 	void UpdateLightBehaviors();
+	void GatherSceneLights();
+	void BindLightClustersForEye( Mat44 const& eyeProjection, Mat44 const& eyeFromWorld, LightClusterGrid& grid );
 
 	// Accessors
 	bool GetIsDebugRenderingActive() { return m_isDebugRenderingActive; }
@@ -136,6 +143,9 @@ public:
 	// World
 	World* m_theWorld = nullptr;
 
+	// Co-op replication, started with coop_host / coop_join
+	SnapshotSession* m_snapshotSession = nullptr;
+
 	// Player
 	//Entity* m_player = nullptr;
 
@@ -165,6 +175,13 @@ public:
 	light_t m_pointLight;
 	LightMaster m_lightMaster;
 
+	// With a headset, point and spot lights (the master's and a glow per projectile) are clustered per eye instead
+	// of taking the eight light constants
+	bool m_isLightClusteringEnabled = false;
+	std::vector<light_t> m_clusteredLights;
+	LightClusterGrid m_rightEyeLightClusters;
+	LightClusterGrid m_leftEyeLightClusters;
+
 	Rgba8 m_ambientLightColor = Rgba8::WHITE;
 	float m_ambientIntensity = 0.01f;
 
@@ -196,4 +213,5 @@ public:
 	eLocomotion m_locomoiton = eLocomotion::TELEPORTATION;
 
 	GPUMesh* m_bulletMesh = nullptr;
+	MeshLODChain m_bulletLODs;			// index ranges of m_bulletMesh, finest first
 };
\ No newline at end of file
@@ -0,0 +1,1021 @@
+#include "Game/HierarchicalPathfinder.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <utility>
+
+//-------------------------------------------------------------------------------------------------------------
+extern JobSystem*	g_theJobSystem;
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr float DIAGONAL_STEP_COST		= 1.41421356f;
+constexpr int	ENTRANCE_SPLIT_LENGTH	= 6;		// runs at least this long get an entrance at each end
+
+typedef std::pair<float, int> OpenEntry;			// f cost, index
+
+//-------------------------------------------------------------------------------------------------------------
+// Per-thread search state. Stamps mark which entries belong to the current search, so nothing is cleared between
+// searches; the arrays only ever grow.
+//-------------------------------------------------------------------------------------------------------------
+struct SearchScratch
+{
+	std::vector<float>		m_costs;
+	std::vector<int>		m_parents;
+	std::vector<uint32_t>	m_seenStamps;
+	std::vector<uint32_t>	m_closedStamps;
+	std::vector<OpenEntry>	m_open;				// min-heap
+	uint32_t				m_stamp = 0;
+
+	void Begin( int numEntries )
+	{
+		if( (int)m_costs.size() < numEntries )
+		{
+			m_costs.resize( numEntries );
+			m_parents.resize( numEntries );
+			m_seenStamps.resize( numEntries, 0 );
+			m_closedStamps.resize( numEntries, 0 );
+		}
+
+		++m_stamp;
+		if( m_stamp == 0 )	// wrapped; old stamps could read as current
+		{
+			std::fill( m_seenStamps.begin(), m_seenStamps.end(), 0 );
+			std::fill( m_closedStamps.begin(), m_closedStamps.end(), 0 );
+			m_stamp = 1;
+		}
+		m_open.clear();
+	}
+
+	bool	WasSeen( int index ) const		{ return m_seenStamps[index] == m_stamp; }
+	bool	IsClosed( int index ) const		{ return m_closedStamps[index] == m_stamp; }
+	float	GetCost( int index ) const		{ return WasSeen( index ) ? m_costs[index] : PATH_COST_UNREACHABLE; }
+
+	void Relax( int index, int parent, float cost, float estimateToGoal )
+	{
+		if( WasSeen( index ) && cost >= m_costs[index] )
+		{
+			return;
+		}
+
+		m_seenStamps[index] = m_stamp;
+		m_costs[index] = cost;
+		m_parents[index] = parent;
+		m_open.push_back( OpenEntry( cost + estimateToGoal, index ) );
+		std::push_heap( m_open.begin(), m_open.end(), std::greater<OpenEntry>() );
+	}
+
+	// The next index to close, or -1 once the open list runs dry
+	int CloseNext()
+	{
+		while( !m_open.empty() )
+		{
+			std::pop_heap( m_open.begin(), m_open.end(), std::greater<OpenEntry>() );
+			int index = m_open.back().second;
+			m_open.pop_back();
+			if( !IsClosed( index ) )
+			{
+				m_closedStamps[index] = m_stamp;
+				return index;
+			}
+		}
+		return -1;
+	}
+};
+
+static thread_local SearchScratch	t_tileSearch;
+static thread_local SearchScratch	t_nodeSearch;
+
+//-------------------------------------------------------------------------------------------------------------
+static float GetOctileDistance( int fromX, int fromY, int toX, int toY )
+{
+	int deltaX = abs( toX - fromX );
+	int deltaY = abs( toY - fromY );
+	int numDiagonals = deltaX < deltaY ? deltaX : deltaY;
+	return (float)( deltaX + deltaY ) + ( DIAGONAL_STEP_COST - 2.f ) * (float)numDiagonals;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// A* from startTile over the tiles inside [mins, maxs). With goalTile -1 it runs to exhaustion as Dijkstra, leaving
+// every reachable tile's cost in scratch, indexed relative to the bounds. Returns the goal's cost.
+//-------------------------------------------------------------------------------------------------------------
+static float SearchTiles( uint8_t const* isSolid, int mapWidth, IntVec2 const& mins, IntVec2 const& maxs, int startTile, int goalTile, SearchScratch& scratch )
+{
+	int boundsWidth = maxs.x - mins.x;
+	int boundsHeight = maxs.y - mins.y;
+	scratch.Begin( boundsWidth * boundsHeight );
+
+	int goalX = goalTile >= 0 ? goalTile % mapWidth - mins.x : 0;
+	int goalY = goalTile >= 0 ? goalTile / mapWidth - mins.y : 0;
+	int goalLocal = goalTile >= 0 ? goalX + goalY * boundsWidth : -1;
+	int startX = startTile % mapWidth - mins.x;
+	int startY = startTile / mapWidth - mins.y;
+	scratch.Relax( startX + startY * boundsWidth, -1, 0.f, 0.f );
+
+	for( int local = scratch.CloseNext(); local >= 0; local = scratch.CloseNext() )
+	{
+		if( local == goalLocal )
+		{
+			return scratch.m_costs[local];
+		}
+
+		int localX = local % boundsWidth;
+		int localY = local / boundsWidth;
+		int tile = ( mins.x + localX ) + ( mins.y + localY ) * mapWidth;
+		float cost = scratch.m_costs[local];
+		bool isOpenEast  = localX + 1 < boundsWidth && !isSolid[tile + 1];
+		bool isOpenWest  = localX > 0 && !isSolid[tile - 1];
+		bool isOpenNorth = localY + 1 < boundsHeight && !isSolid[tile + mapWidth];
+		bool isOpenSouth = localY > 0 && !isSolid[tile - mapWidth];
+
+		int steps[8][2];
+		float stepCosts[8];
+		int numSteps = 0;
+		if( isOpenEast )	{ steps[numSteps][0] = 1;	steps[numSteps][1] = 0;		stepCosts[numSteps++] = 1.f; }
+		if( isOpenWest )	{ steps[numSteps][0] = -1;	steps[numSteps][1] = 0;		stepCosts[numSteps++] = 1.f; }
+		if( isOpenNorth )	{ steps[numSteps][0] = 0;	steps[numSteps][1] = 1;		stepCosts[numSteps++] = 1.f; }
+		if( isOpenSouth )	{ steps[numSteps][0] = 0;	steps[numSteps][1] = -1;	stepCosts[numSteps++] = 1.f; }
+		if( isOpenNorth && isOpenEast && !isSolid[tile + mapWidth + 1] )	{ steps[numSteps][0] = 1;	steps[numSteps][1] = 1;		stepCosts[numSteps++] = DIAGONAL_STEP_COST; }
+		if( isOpenNorth && isOpenWest && !isSolid[tile + mapWidth - 1] )	{ steps[numSteps][0] = -1;	steps[numSteps][1] = 1;		stepCosts[numSteps++] = DIAGONAL_STEP_COST; }
+		if( isOpenSouth && isOpenEast && !isSolid[tile - mapWidth + 1] )	{ steps[numSteps][0] = 1;	steps[numSteps][1] = -1;	stepCosts[numSteps++] = DIAGONAL_STEP_COST; }
+		if( isOpenSouth && isOpenWest && !isSolid[tile - mapWidth - 1] )	{ steps[numSteps][0] = -1;	steps[numSteps][1] = -1;	stepCosts[numSteps++] = DIAGONAL_STEP_COST; }
+
+		for( int stepIdx = 0; stepIdx < numSteps; ++stepIdx )
+		{
+			int neighborX = localX + steps[stepIdx][0];
+			int neighborY = localY + steps[stepIdx][1];
+			float estimate = goalLocal >= 0 ? GetOctileDistance( neighborX, neighborY, goalX, goalY ) : 0.f;
+			scratch.Relax( neighborX + ( neighborY * boundsWidth ), local, cost + stepCosts[stepIdx], estimate );
+		}
+	}
+
+	return PATH_COST_UNREACHABLE;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static float GetSearchedTileCost( SearchScratch const& scratch, int mapWidth, IntVec2 const& mins, IntVec2 const& maxs, int tile )
+{
+	int local = ( tile % mapWidth - mins.x ) + ( tile / mapWidth - mins.y ) * ( maxs.x - mins.x );
+	return scratch.GetCost( local );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Appends the path SearchTiles found to goalTile, skipping its first tile if skipStart
+static void AppendSearchedPath( SearchScratch const& scratch, int mapWidth, IntVec2 const& mins, IntVec2 const& maxs, int goalTile, bool skipStart, std::vector<IntVec2>& out_tiles )
+{
+	int boundsWidth = maxs.x - mins.x;
+	size_t firstNewTile = out_tiles.size();
+	for( int local = ( goalTile % mapWidth - mins.x ) + ( goalTile / mapWidth - mins.y ) * boundsWidth; local >= 0; local = scratch.m_parents[local] )
+	{
+		out_tiles.push_back( IntVec2( mins.x + local % boundsWidth, mins.y + local / boundsWidth ) );
+	}
+
+	if( skipStart )
+	{
+		out_tiles.pop_back();
+	}
+	std::reverse( out_tiles.begin() + firstNewTile, out_tiles.end() );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+float FindTilePathAStar( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, IntVec2 const& startTile, IntVec2 const& goalTile, std::vector<IntVec2>* out_tiles )
+{
+	if( out_tiles )
+	{
+		out_tiles->clear();
+	}
+
+	bool isStartOnMap = startTile.x >= 0 && startTile.x < dimensions.x && startTile.y >= 0 && startTile.y < dimensions.y;
+	bool isGoalOnMap = goalTile.x >= 0 && goalTile.x < dimensions.x && goalTile.y >= 0 && goalTile.y < dimensions.y;
+	int start = startTile.x + startTile.y * dimensions.x;
+	int goal = goalTile.x + goalTile.y * dimensions.x;
+	if( !isStartOnMap || !isGoalOnMap || isSolid[start] || isSolid[goal] )
+	{
+		return PATH_COST_UNREACHABLE;
+	}
+
+	SearchScratch& scratch = t_tileSearch;
+	float cost = SearchTiles( isSolid.data(), dimensions.x, IntVec2::ZERO, dimensions, start, goal, scratch );
+	if( out_tiles && cost < PATH_COST_UNREACHABLE )
+	{
+		AppendSearchedPath( scratch, dimensions.x, IntVec2::ZERO, dimensions, goal, false, *out_tiles );
+	}
+	return cost;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::Build( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, hpa_options_t const& options )
+{
+	m_isSolid = isSolid;
+	m_dimensions = dimensions;
+	m_options = options;
+	m_options.cluster_size = options.cluster_size < 4 ? 4 : options.cluster_size;
+
+	// Entrances on one border are separated by at least one blocked tile, so there are at most half as many as tiles
+	int clusterSize = m_options.cluster_size;
+	m_clusterCounts = IntVec2( ( dimensions.x + clusterSize - 1 ) / clusterSize, ( dimensions.y + clusterSize - 1 ) / clusterSize );
+	m_maxNodesPerBorder = ( clusterSize + 1 ) / 2;
+	m_slotsPerCluster = NUM_CLUSTER_BORDERS * m_maxNodesPerBorder;
+
+	m_clusters.clear();
+	m_clusters.resize( m_clusterCounts.x * m_clusterCounts.y );
+	for( int clusterIndex = 0; clusterIndex < (int)m_clusters.size(); ++clusterIndex )
+	{
+		PathCluster& cluster = m_clusters[clusterIndex];
+		cluster.m_mins = IntVec2( ( clusterIndex % m_clusterCounts.x ) * clusterSize, ( clusterIndex / m_clusterCounts.x ) * clusterSize );
+		cluster.m_maxs = IntVec2( std::min( cluster.m_mins.x + clusterSize, dimensions.x ), std::min( cluster.m_mins.y + clusterSize, dimensions.y ) );
+	}
+
+	for( int clusterIndex = 0; clusterIndex < (int)m_clusters.size(); ++clusterIndex )
+	{
+		BuildBorderEntrances( clusterIndex, BORDER_EAST );
+		BuildBorderEntrances( clusterIndex, BORDER_NORTH );
+	}
+
+	for( int clusterIndex = 0; clusterIndex < (int)m_clusters.size(); ++clusterIndex )
+	{
+		BuildClusterEdges( clusterIndex );
+	}
+
+	ClearCache();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::SetTileSolid( IntVec2 const& tile, bool isSolid )
+{
+	if( tile.x < 0 || tile.x >= m_dimensions.x || tile.y < 0 || tile.y >= m_dimensions.y )
+	{
+		return;
+	}
+
+	int tileIndex = tile.x + tile.y * m_dimensions.x;
+	if( ( m_isSolid[tileIndex] != 0 ) == isSolid )
+	{
+		return;
+	}
+	m_isSolid[tileIndex] = isSolid ? 1 : 0;
+
+	// A tile on a border can open or close entrances, which renumbers nodes on both sides of it
+	int clusterIndex = GetClusterIndexForTile( tile.x, tile.y );
+	PathCluster const& cluster = m_clusters[clusterIndex];
+	bool isOnBorder[NUM_CLUSTER_BORDERS] = { tile.x == cluster.m_maxs.x - 1, tile.y == cluster.m_maxs.y - 1, tile.x == cluster.m_mins.x, tile.y == cluster.m_mins.y };
+	std::vector<int> changedClusters;
+	changedClusters.push_back( clusterIndex );
+	for( int border = 0; border < NUM_CLUSTER_BORDERS; ++border )
+	{
+		int neighborIndex = GetNeighborCluster( clusterIndex, border );
+		if( isOnBorder[border] && neighborIndex >= 0 )
+		{
+			RebuildClusterBorder( clusterIndex, border );
+			changedClusters.push_back( neighborIndex );
+		}
+	}
+
+	for( int changedIdx = 0; changedIdx < (int)changedClusters.size(); ++changedIdx )
+	{
+		BuildClusterEdges( changedClusters[changedIdx] );
+	}
+
+	// Cached paths elsewhere stay walkable; one that a newly opened tile would shorten stays until it ages out
+	EvictCachedPathsThrough( changedClusters );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+float HierarchicalPathfinder::FindPath( IntVec2 const& startTile, IntVec2 const& goalTile, std::vector<IntVec2>& out_tiles )
+{
+	out_tiles.clear();
+	bool isStartOnMap = startTile.x >= 0 && startTile.x < m_dimensions.x && startTile.y >= 0 && startTile.y < m_dimensions.y;
+	bool isGoalOnMap = goalTile.x >= 0 && goalTile.x < m_dimensions.x && goalTile.y >= 0 && goalTile.y < m_dimensions.y;
+	if( !IsBuilt() || !isStartOnMap || !isGoalOnMap )
+	{
+		return PATH_COST_UNREACHABLE;
+	}
+
+	int start = startTile.x + startTile.y * m_dimensions.x;
+	int goal = goalTile.x + goalTile.y * m_dimensions.x;
+	if( m_isSolid[start] || m_isSolid[goal] )
+	{
+		return PATH_COST_UNREACHABLE;
+	}
+	if( start == goal )
+	{
+		out_tiles.push_back( startTile );
+		return 0.f;
+	}
+
+	uint64_t key = ( (uint64_t)start << 32 ) | (uint64_t)(uint32_t)goal;
+	float cost = PATH_COST_UNREACHABLE;
+	if( m_options.cache_capacity > 0 && GetCachedPath( key, out_tiles, cost ) )
+	{
+		++m_numCacheHits;
+		return cost;
+	}
+	++m_numCacheMisses;
+
+	// Start and goal in the same or neighbouring clusters: the abstract path has to bend through entrance nodes, which
+	// for a short hop can cost several times the best path, so first try a search bounded to both clusters and one
+	// cluster of margin around them. Unless it comes out as short as the open-floor distance, the abstract path still
+	// gets a go, and the cheaper one wins.
+	PathCluster const& startCluster = m_clusters[GetClusterIndexForTile( startTile.x, startTile.y )];
+	PathCluster const& goalCluster = m_clusters[GetClusterIndexForTile( goalTile.x, goalTile.y )];
+	IntVec2 boundsMins( std::min( startCluster.m_mins.x, goalCluster.m_mins.x ), std::min( startCluster.m_mins.y, goalCluster.m_mins.y ) );
+	IntVec2 boundsMaxs( std::max( startCluster.m_maxs.x, goalCluster.m_maxs.x ), std::max( startCluster.m_maxs.y, goalCluster.m_maxs.y ) );
+	bool areClustersNeighbours = boundsMaxs.x - boundsMins.x <= 2 * m_options.cluster_size && boundsMaxs.y - boundsMins.y <= 2 * m_options.cluster_size;
+	boundsMins = IntVec2( std::max( boundsMins.x - m_options.cluster_size, 0 ), std::max( boundsMins.y - m_options.cluster_size, 0 ) );
+	boundsMaxs = IntVec2( std::min( boundsMaxs.x + m_options.cluster_size, m_dimensions.x ), std::min( boundsMaxs.y + m_options.cluster_size, m_dimensions.y ) );
+	if( !areClustersNeighbours )
+	{
+		cost = FindAbstractPath( start, goal, out_tiles );
+	}
+	else
+	{
+		cost = SearchTiles( m_isSolid.data(), m_dimensions.x, boundsMins, boundsMaxs, start, goal, t_tileSearch );
+		if( cost < PATH_COST_UNREACHABLE )
+		{
+			AppendSearchedPath( t_tileSearch, m_dimensions.x, boundsMins, boundsMaxs, goal, false, out_tiles );
+		}
+
+		if( cost > GetOctileDistance( startTile.x, startTile.y, goalTile.x, goalTile.y ) + 0.001f )
+		{
+			std::vector<IntVec2> abstractTiles;
+			float abstractCost = FindAbstractPath( start, goal, abstractTiles );
+			if( abstractCost < cost )
+			{
+				cost = abstractCost;
+				out_tiles.swap( abstractTiles );
+			}
+		}
+	}
+
+	if( m_options.cache_capacity > 0 )
+	{
+		AddCachedPath( key, out_tiles, cost );
+	}
+	return cost;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+class PathQueryJob : public Job
+{
+public:
+	PathQueryJob( HierarchicalPathfinder* pathfinder, PathQuery* queries, int firstQuery, int endQuery, std::atomic<int>* numBandsLeft )
+		: Job(),
+		m_pathfinder( pathfinder ),
+		m_queries( queries ),
+		m_firstQuery( firstQuery ),
+		m_endQuery( endQuery ),
+		m_numBandsLeft( numBandsLeft )
+	{
+		m_jobFlags = JOB_FLAG_DELETE_ON_COMPLETE;
+	}
+
+	virtual void Execute() override
+	{
+		for( int queryIdx = m_firstQuery; queryIdx < m_endQuery; ++queryIdx )
+		{
+			PathQuery& query = m_queries[queryIdx];
+			query.m_cost = m_pathfinder->FindPath( query.m_startTile, query.m_goalTile, query.m_tiles );
+		}
+		m_numBandsLeft->fetch_sub( 1 );	// the queries and this counter belong to FindPaths, which may now return
+	}
+
+	virtual void OnCompleteCallback() override
+	{
+	}
+
+public:
+	HierarchicalPathfinder*	m_pathfinder = nullptr;
+	PathQuery*				m_queries = nullptr;
+	int						m_firstQuery = 0;
+	int						m_endQuery = 0;
+	std::atomic<int>*		m_numBandsLeft = nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::FindPaths( PathQuery* queries, int numQueries )
+{
+	if( numQueries <= 0 )
+	{
+		return;
+	}
+
+	int numBands = 1;
+	if( g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning() )
+	{
+		int bandsWanted = 4 * ( (int)g_theJobSystem->m_workerThreads.size() + 1 );	// path lengths vary a lot, so more bands than threads
+		numBands = bandsWanted < numQueries ? bandsWanted : numQueries;
+	}
+
+	// The calling thread takes the first band and waits out the rest
+	std::atomic<int> numBandsLeft( numBands - 1 );
+	for( int bandIdx = 1; bandIdx < numBands; ++bandIdx )
+	{
+		int firstQuery = numQueries * bandIdx / numBands;
+		int endQuery = numQueries * ( bandIdx + 1 ) / numBands;
+		g_theJobSystem->PostJob( new PathQueryJob( this, queries, firstQuery, endQuery, &numBandsLeft ) );
+	}
+
+	for( int queryIdx = 0; queryIdx < numQueries / numBands; ++queryIdx )
+	{
+		queries[queryIdx].m_cost = FindPath( queries[queryIdx].m_startTile, queries[queryIdx].m_goalTile, queries[queryIdx].m_tiles );
+	}
+	while( numBandsLeft.load() > 0 )
+	{
+		std::this_thread::yield();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int HierarchicalPathfinder::GetNumNodes() const
+{
+	int numNodes = 0;
+	for( int clusterIndex = 0; clusterIndex < (int)m_clusters.size(); ++clusterIndex )
+	{
+		for( int border = 0; border < NUM_CLUSTER_BORDERS; ++border )
+		{
+			numNodes += (int)m_clusters[clusterIndex].m_borderNodes[border].size();
+		}
+	}
+	return numNodes;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int HierarchicalPathfinder::GetNumEdges() const
+{
+	int numEdges = 0;
+	for( int clusterIndex = 0; clusterIndex < (int)m_clusters.size(); ++clusterIndex )
+	{
+		numEdges += (int)m_clusters[clusterIndex].m_edges.size();
+	}
+	return numEdges;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+size_t HierarchicalPathfinder::GetMemoryBytes() const
+{
+	size_t numBytes = m_clusters.capacity() * sizeof( PathCluster );
+	for( int clusterIndex = 0; clusterIndex < (int)m_clusters.size(); ++clusterIndex )
+	{
+		PathCluster const& cluster = m_clusters[clusterIndex];
+		for( int border = 0; border < NUM_CLUSTER_BORDERS; ++border )
+		{
+			numBytes += cluster.m_borderNodes[border].capacity() * sizeof( PathNode );
+		}
+		numBytes += cluster.m_firstEdges.capacity() * sizeof( int );
+		numBytes += cluster.m_edges.capacity() * sizeof( PathEdge );
+	}
+	return numBytes;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::ClearCache()
+{
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	m_cachedPaths.clear();
+	m_cachedPathsByKey.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int HierarchicalPathfinder::GetClusterIndexForTile( int tileX, int tileY ) const
+{
+	return ( tileX / m_options.cluster_size ) + ( tileY / m_options.cluster_size ) * m_clusterCounts.x;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int HierarchicalPathfinder::GetNeighborCluster( int clusterIndex, int border ) const
+{
+	int clusterX = clusterIndex % m_clusterCounts.x;
+	int clusterY = clusterIndex / m_clusterCounts.x;
+	switch( border )
+	{
+	case BORDER_EAST:	return clusterX + 1 < m_clusterCounts.x ? clusterIndex + 1 : -1;
+	case BORDER_NORTH:	return clusterY + 1 < m_clusterCounts.y ? clusterIndex + m_clusterCounts.x : -1;
+	case BORDER_WEST:	return clusterX > 0 ? clusterIndex - 1 : -1;
+	default:			return clusterY > 0 ? clusterIndex - m_clusterCounts.x : -1;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+HierarchicalPathfinder::PathNode* HierarchicalPathfinder::GetNode( int nodeId )
+{
+	int slot = nodeId % m_slotsPerCluster;
+	std::vector<PathNode>& borderNodes = m_clusters[nodeId / m_slotsPerCluster].m_borderNodes[slot / m_maxNodesPerBorder];
+	int nodeIdx = slot % m_maxNodesPerBorder;
+	return nodeIdx < (int)borderNodes.size() ? &borderNodes[nodeIdx] : nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+HierarchicalPathfinder::PathNode const* HierarchicalPathfinder::GetNode( int nodeId ) const
+{
+	return const_cast<HierarchicalPathfinder*>( this )->GetNode( nodeId );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::BuildBorderEntrances( int clusterIndex, int border )
+{
+	int neighborIndex = GetNeighborCluster( clusterIndex, border );
+	if( neighborIndex < 0 )
+	{
+		return;
+	}
+
+	// Walk the border, one tile pair (this side, other side) at a time
+	PathCluster& cluster = m_clusters[clusterIndex];
+	PathCluster& neighbor = m_clusters[neighborIndex];
+	int oppositeBorder = ( border + 2 ) % NUM_CLUSTER_BORDERS;
+	bool isEast = border == BORDER_EAST;
+	int firstTile = isEast ? ( cluster.m_maxs.x - 1 ) + cluster.m_mins.y * m_dimensions.x : cluster.m_mins.x + ( cluster.m_maxs.y - 1 ) * m_dimensions.x;
+	int alongStep = isEast ? m_dimensions.x : 1;
+	int acrossStep = isEast ? 1 : m_dimensions.x;
+	int borderLength = isEast ? cluster.m_maxs.y - cluster.m_mins.y : cluster.m_maxs.x - cluster.m_mins.x;
+
+	int runStart = -1;
+	for( int along = 0; along <= borderLength; ++along )
+	{
+		int tile = firstTile + along * alongStep;
+		bool isOpen = along < borderLength && !m_isSolid[tile] && !m_isSolid[tile + acrossStep];
+		if( isOpen && runStart < 0 )
+		{
+			runStart = along;
+		}
+		if( isOpen || runStart < 0 )
+		{
+			continue;
+		}
+
+		// The run just ended
+		int runEnd = along - 1;
+		int entrances[2] = { ( runStart + runEnd ) / 2, -1 };
+		if( runEnd - runStart + 1 >= ENTRANCE_SPLIT_LENGTH )
+		{
+			entrances[0] = runStart;
+			entrances[1] = runEnd;
+		}
+
+		for( int entranceIdx = 0; entranceIdx < 2 && entrances[entranceIdx] >= 0; ++entranceIdx )
+		{
+			std::vector<PathNode>& nearNodes = cluster.m_borderNodes[border];
+			std::vector<PathNode>& farNodes = neighbor.m_borderNodes[oppositeBorder];
+			GUARANTEE_OR_DIE( (int)nearNodes.size() < m_maxNodesPerBorder, "HierarchicalPathfinder: too many entrances on one border" );
+
+			int nearTile = firstTile + entrances[entranceIdx] * alongStep;
+			PathNode nearNode;
+			PathNode farNode;
+			nearNode.m_tile = nearTile;
+			nearNode.m_partnerNode = neighborIndex * m_slotsPerCluster + oppositeBorder * m_maxNodesPerBorder + (int)farNodes.size();
+			farNode.m_tile = nearTile + acrossStep;
+			farNode.m_partnerNode = clusterIndex * m_slotsPerCluster + border * m_maxNodesPerBorder + (int)nearNodes.size();
+			nearNodes.push_back( nearNode );
+			farNodes.push_back( farNode );
+		}
+		runStart = -1;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::RebuildClusterBorder( int clusterIndex, int border )
+{
+	// Entrances belong to the cluster to the west or south of the border
+	int neighborIndex = GetNeighborCluster( clusterIndex, border );
+	int ownerIndex = ( border == BORDER_EAST || border == BORDER_NORTH ) ? clusterIndex : neighborIndex;
+	int ownerBorder = ( border == BORDER_EAST || border == BORDER_NORTH ) ? border : ( border + 2 ) % NUM_CLUSTER_BORDERS;
+	int otherIndex = ownerIndex == clusterIndex ? neighborIndex : clusterIndex;
+
+	m_clusters[ownerIndex].m_borderNodes[ownerBorder].clear();
+	m_clusters[otherIndex].m_borderNodes[( ownerBorder + 2 ) % NUM_CLUSTER_BORDERS].clear();
+	BuildBorderEntrances( ownerIndex, ownerBorder );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Shortest in-cluster cost between every pair of the cluster's nodes, one Dijkstra per node
+void HierarchicalPathfinder::BuildClusterEdges( int clusterIndex )
+{
+	PathCluster& cluster = m_clusters[clusterIndex];
+	cluster.m_firstEdges.assign( m_slotsPerCluster + 1, 0 );
+	cluster.m_edges.clear();
+
+	SearchScratch& scratch = t_tileSearch;
+	for( int slot = 0; slot < m_slotsPerCluster; ++slot )
+	{
+		cluster.m_firstEdges[slot] = (int)cluster.m_edges.size();
+		PathNode const* node = GetNode( clusterIndex * m_slotsPerCluster + slot );
+		if( node == nullptr )
+		{
+			continue;
+		}
+
+		SearchTiles( m_isSolid.data(), m_dimensions.x, cluster.m_mins, cluster.m_maxs, node->m_tile, -1, scratch );
+		for( int otherSlot = 0; otherSlot < m_slotsPerCluster; ++otherSlot )
+		{
+			PathNode const* otherNode = GetNode( clusterIndex * m_slotsPerCluster + otherSlot );
+			if( otherSlot == slot || otherNode == nullptr )
+			{
+				continue;
+			}
+
+			PathEdge edge;
+			edge.m_toSlot = otherSlot;
+			edge.m_cost = GetSearchedTileCost( scratch, m_dimensions.x, cluster.m_mins, cluster.m_maxs, otherNode->m_tile );
+			if( edge.m_cost < PATH_COST_UNREACHABLE )
+			{
+				cluster.m_edges.push_back( edge );
+			}
+		}
+	}
+	cluster.m_firstEdges[m_slotsPerCluster] = (int)cluster.m_edges.size();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// A* over the cluster graph, with start and goal joined to the nodes of their clusters, then refined into tiles
+float HierarchicalPathfinder::FindAbstractPath( int startTile, int goalTile, std::vector<IntVec2>& out_tiles ) const
+{
+	out_tiles.clear();
+	int mapWidth = m_dimensions.x;
+	int goalX = goalTile % mapWidth;
+	int goalY = goalTile / mapWidth;
+	int startCluster = GetClusterIndexForTile( startTile % mapWidth, startTile / mapWidth );
+	int goalCluster = GetClusterIndexForTile( goalX, goalY );
+	PathCluster const& startClusterRef = m_clusters[startCluster];
+	PathCluster const& goalClusterRef = m_clusters[goalCluster];
+
+	// Cost from each goal-cluster node to the goal
+	SearchScratch& tileScratch = t_tileSearch;
+	std::vector<float> goalCosts( m_slotsPerCluster, PATH_COST_UNREACHABLE );
+	SearchTiles( m_isSolid.data(), mapWidth, goalClusterRef.m_mins, goalClusterRef.m_maxs, goalTile, -1, tileScratch );
+	for( int slot = 0; slot < m_slotsPerCluster; ++slot )
+	{
+		PathNode const* node = GetNode( goalCluster * m_slotsPerCluster + slot );
+		if( node )
+		{
+			goalCosts[slot] = GetSearchedTileCost( tileScratch, mapWidth, goalClusterRef.m_mins, goalClusterRef.m_maxs, node->m_tile );
+		}
+	}
+
+	int numNodeIds = (int)m_clusters.size() * m_slotsPerCluster;
+	int startId = numNodeIds;
+	int goalId = numNodeIds + 1;
+	SearchScratch& nodeScratch = t_nodeSearch;
+	nodeScratch.Begin( numNodeIds + 2 );
+	nodeScratch.Relax( startId, -1, 0.f, 0.f );
+	nodeScratch.CloseNext();
+
+	SearchTiles( m_isSolid.data(), mapWidth, startClusterRef.m_mins, startClusterRef.m_maxs, startTile, -1, tileScratch );
+	for( int slot = 0; slot < m_slotsPerCluster; ++slot )
+	{
+		PathNode const* node = GetNode( startCluster * m_slotsPerCluster + slot );
+		if( node )
+		{
+			float cost = GetSearchedTileCost( tileScratch, mapWidth, startClusterRef.m_mins, startClusterRef.m_maxs, node->m_tile );
+			if( cost < PATH_COST_UNREACHABLE )
+			{
+				nodeScratch.Relax( startCluster * m_slotsPerCluster + slot, startId, cost, GetOctileDistance( node->m_tile % mapWidth, node->m_tile / mapWidth, goalX, goalY ) );
+			}
+		}
+	}
+
+	for( int nodeId = nodeScratch.CloseNext(); nodeId >= 0 && nodeId != goalId; nodeId = nodeScratch.CloseNext() )
+	{
+		int clusterIndex = nodeId / m_slotsPerCluster;
+		int slot = nodeId % m_slotsPerCluster;
+		PathCluster const& cluster = m_clusters[clusterIndex];
+		PathNode const* node = GetNode( nodeId );
+		float cost = nodeScratch.m_costs[nodeId];
+
+		for( int edgeIdx = cluster.m_firstEdges[slot]; edgeIdx < cluster.m_firstEdges[slot + 1]; ++edgeIdx )
+		{
+			PathEdge const& edge = cluster.m_edges[edgeIdx];
+			int toId = clusterIndex * m_slotsPerCluster + edge.m_toSlot;
+			int toTile = GetNode( toId )->m_tile;
+			nodeScratch.Relax( toId, nodeId, cost + edge.m_cost, GetOctileDistance( toTile % mapWidth, toTile / mapWidth, goalX, goalY ) );
+		}
+
+		int partnerTile = GetNode( node->m_partnerNode )->m_tile;
+		nodeScratch.Relax( node->m_partnerNode, nodeId, cost + 1.f, GetOctileDistance( partnerTile % mapWidth, partnerTile / mapWidth, goalX, goalY ) );
+
+		if( clusterIndex == goalCluster && goalCosts[slot] < PATH_COST_UNREACHABLE )
+		{
+			nodeScratch.Relax( goalId, nodeId, cost + goalCosts[slot], 0.f );
+		}
+	}
+
+	if( !nodeScratch.IsClosed( goalId ) )
+	{
+		return PATH_COST_UNREACHABLE;
+	}
+
+	// Node chain from start to goal
+	std::vector<int> chain;
+	for( int nodeId = goalId; nodeId >= 0; nodeId = nodeScratch.m_parents[nodeId] )
+	{
+		chain.push_back( nodeId );
+	}
+	std::reverse( chain.begin(), chain.end() );
+
+	// Refine: a border crossing is one step, everything else a search bounded to the cluster it stays in
+	out_tiles.push_back( IntVec2( startTile % mapWidth, startTile / mapWidth ) );
+	int fromTile = startTile;
+	for( int chainIdx = 1; chainIdx < (int)chain.size(); ++chainIdx )
+	{
+		int fromId = chain[chainIdx - 1];
+		int toId = chain[chainIdx];
+		int toTile = toId == goalId ? goalTile : GetNode( toId )->m_tile;
+		if( toTile == fromTile )
+		{
+			continue;
+		}
+
+		if( fromId != startId && toId != goalId && GetNode( fromId )->m_partnerNode == toId )
+		{
+			out_tiles.push_back( IntVec2( toTile % mapWidth, toTile / mapWidth ) );
+		}
+		else
+		{
+			int clusterIndex = fromId == startId ? startCluster : fromId / m_slotsPerCluster;
+			PathCluster const& cluster = m_clusters[clusterIndex];
+			SearchTiles( m_isSolid.data(), mapWidth, cluster.m_mins, cluster.m_maxs, fromTile, toTile, tileScratch );
+			AppendSearchedPath( tileScratch, mapWidth, cluster.m_mins, cluster.m_maxs, toTile, true, out_tiles );
+		}
+		fromTile = toTile;
+	}
+
+	return nodeScratch.m_costs[goalId];
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool HierarchicalPathfinder::GetCachedPath( uint64_t key, std::vector<IntVec2>& out_tiles, float& out_cost )
+{
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	auto found = m_cachedPathsByKey.find( key );
+	if( found == m_cachedPathsByKey.end() )
+	{
+		return false;
+	}
+
+	m_cachedPaths.splice( m_cachedPaths.begin(), m_cachedPaths, found->second );
+	out_tiles = found->second->m_tiles;
+	out_cost = found->second->m_cost;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::AddCachedPath( uint64_t key, std::vector<IntVec2> const& tiles, float cost )
+{
+	CachedPath cachedPath;
+	cachedPath.m_key = key;
+	cachedPath.m_tiles = tiles;
+	cachedPath.m_cost = cost;
+	for( int tileIdx = 0; tileIdx < (int)tiles.size(); ++tileIdx )
+	{
+		int clusterIndex = GetClusterIndexForTile( tiles[tileIdx].x, tiles[tileIdx].y );
+		if( cachedPath.m_clusters.empty() || cachedPath.m_clusters.back() != clusterIndex )
+		{
+			cachedPath.m_clusters.push_back( clusterIndex );
+		}
+	}
+	std::sort( cachedPath.m_clusters.begin(), cachedPath.m_clusters.end() );
+	cachedPath.m_clusters.erase( std::unique( cachedPath.m_clusters.begin(), cachedPath.m_clusters.end() ), cachedPath.m_clusters.end() );
+
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	if( m_cachedPathsByKey.find( key ) != m_cachedPathsByKey.end() )
+	{
+		return;		// another thread found it first
+	}
+
+	m_cachedPaths.push_front( std::move( cachedPath ) );
+	m_cachedPathsByKey[key] = m_cachedPaths.begin();
+	if( (int)m_cachedPaths.size() > m_options.cache_capacity )
+	{
+		m_cachedPathsByKey.erase( m_cachedPaths.back().m_key );
+		m_cachedPaths.pop_back();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void HierarchicalPathfinder::EvictCachedPathsThrough( std::vector<int> const& clusterIndices )
+{
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	for( auto cachedPath = m_cachedPaths.begin(); cachedPath != m_cachedPaths.end(); )
+	{
+		// An unreachable pair could be connected by a tile opening anywhere
+		bool passesThrough = cachedPath->m_tiles.empty();
+		for( int clusterIdx = 0; clusterIdx < (int)clusterIndices.size() && !passesThrough; ++clusterIdx )
+		{
+			passesThrough = std::binary_search( cachedPath->m_clusters.begin(), cachedPath->m_clusters.end(), clusterIndices[clusterIdx] );
+		}
+
+		if( passesThrough )
+		{
+			m_cachedPathsByKey.erase( cachedPath->m_key );
+			cachedPath = m_cachedPaths.erase( cachedPath );
+		}
+		else
+		{
+			++cachedPath;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void GenerateBenchmarkTileMaze( int size, unsigned int seed, std::vector<uint8_t>& out_isSolid )
+{
+	constexpr int ROOM_PITCH = 9;	// 8 open tiles and a wall
+	RandomNumberGenerator rng;
+	rng.Reset( seed );
+
+	out_isSolid.assign( size * size, 0 );
+	for( int tileY = 0; tileY < size; ++tileY )
+	{
+		for( int tileX = 0; tileX < size; ++tileX )
+		{
+			bool isWall = tileX % ROOM_PITCH == 0 || tileY % ROOM_PITCH == 0 || tileX == size - 1 || tileY == size - 1;
+			out_isSolid[tileX + tileY * size] = isWall || rng.RollPercentChance( 0.08f ) ? 1 : 0;
+		}
+	}
+
+	for( int wallY = 0; wallY < size; wallY += ROOM_PITCH )
+	{
+		for( int wallX = 0; wallX < size; wallX += ROOM_PITCH )
+		{
+			// A door in the wall segment north of this corner, and one in the segment east of it
+			for( int segment = 0; segment < 2; ++segment )
+			{
+				if( !rng.RollPercentChance( 0.67f ) )
+				{
+					continue;
+				}
+
+				int doorWidth = rng.RollRandomIntInRange( 1, 3 );
+				int doorStart = rng.RollRandomIntInRange( 1, ROOM_PITCH - doorWidth );
+				for( int doorIdx = 0; doorIdx < doorWidth; ++doorIdx )
+				{
+					int tileX = segment == 0 ? wallX : wallX + doorStart + doorIdx;
+					int tileY = segment == 0 ? wallY + doorStart + doorIdx : wallY;
+					if( tileX > 0 && tileY > 0 && tileX < size - 1 && tileY < size - 1 )
+					{
+						out_isSolid[tileX + tileY * size] = 0;
+					}
+				}
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// benchmark_pathfinding: HPA* against flat A* on generated 256x256 and 1024x1024 mazes, with plenty of dead ends
+// and detours, like a scaled-up TwistyMaze. HPA* must find a path exactly when A* does, and after random tile
+// edits repaired in place it must agree with a pathfinder built from scratch.
+//-------------------------------------------------------------------------------------------------------------
+static IntVec2 RollOpenTile( RandomNumberGenerator& rng, std::vector<uint8_t> const& isSolid, int size )
+{
+	for( ;; )
+	{
+		IntVec2 tile( rng.RollRandomIntLessThan( size ), rng.RollRandomIntLessThan( size ) );
+		if( !isSolid[tile.x + tile.y * size] )
+		{
+			return tile;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static bool RunPathfindingBenchmark( int size, int numQueries, unsigned int seed )
+{
+	std::vector<uint8_t> isSolid;
+	GenerateBenchmarkTileMaze( size, seed, isSolid );
+	IntVec2 dimensions( size, size );
+
+	HierarchicalPathfinder pathfinder;
+	double buildStartSeconds = GetCurrentTimeSeconds();
+	pathfinder.Build( isSolid, dimensions );
+	double buildSeconds = GetCurrentTimeSeconds() - buildStartSeconds;
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  %ix%i: built in %.1f ms, %i nodes, %i edges, %.2f MB", size, size,
+		buildSeconds * 1000.0, pathfinder.GetNumNodes(), pathfinder.GetNumEdges(), (double)pathfinder.GetMemoryBytes() / ( 1024.0 * 1024.0 ) ) );
+
+	RandomNumberGenerator rng;
+	rng.Reset( seed + 1 );
+	std::vector<PathQuery> queries( numQueries );
+	for( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		queries[queryIdx].m_startTile = RollOpenTile( rng, isSolid, size );
+		queries[queryIdx].m_goalTile = RollOpenTile( rng, isSolid, size );
+	}
+
+	// Flat A*, the reference
+	std::vector<float> optimalCosts( numQueries );
+	std::vector<IntVec2> tiles;
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		optimalCosts[queryIdx] = FindTilePathAStar( isSolid, dimensions, queries[queryIdx].m_startTile, queries[queryIdx].m_goalTile, &tiles );
+	}
+	double flatSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+	// HPA* one query at a time, cold then warm cache
+	std::vector<float> costs( numQueries );
+	startSeconds = GetCurrentTimeSeconds();
+	for( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		costs[queryIdx] = pathfinder.FindPath( queries[queryIdx].m_startTile, queries[queryIdx].m_goalTile, tiles );
+	}
+	double coldSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+	startSeconds = GetCurrentTimeSeconds();
+	for( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		pathfinder.FindPath( queries[queryIdx].m_startTile, queries[queryIdx].m_goalTile, tiles );
+	}
+	double warmSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+	pathfinder.ClearCache();
+	startSeconds = GetCurrentTimeSeconds();
+	pathfinder.FindPaths( queries.data(), numQueries );
+	double batchSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+	int numFound = 0;
+	int numMismatches = 0;
+	double totalRatio = 0.0;
+	double worstRatio = 1.0;
+	for( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		bool wasFound = optimalCosts[queryIdx] < PATH_COST_UNREACHABLE;
+		bool isShorterThanOptimal = wasFound && costs[queryIdx] < optimalCosts[queryIdx] - 0.001f;
+		if( wasFound != ( costs[queryIdx] < PATH_COST_UNREACHABLE ) || isShorterThanOptimal || costs[queryIdx] != queries[queryIdx].m_cost )
+		{
+			++numMismatches;
+		}
+		if( wasFound && optimalCosts[queryIdx] > 0.f )
+		{
+			double ratio = (double)costs[queryIdx] / (double)optimalCosts[queryIdx];
+			totalRatio += ratio;
+			worstRatio = ratio > worstRatio ? ratio : worstRatio;
+			++numFound;
+		}
+	}
+
+	double msPerQuery = 1000.0 / (double)numQueries;
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    ms/query: flat A* %.3f | HPA* %.3f cold, %.4f cached, %.3f batched (%s)",
+		flatSeconds * msPerQuery, coldSeconds * msPerQuery, warmSeconds * msPerQuery, batchSeconds * msPerQuery,
+		g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning() ? "job workers" : "inline" ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    %i of %i pairs connected; HPA* path cost %.3fx optimal on average, %.3fx worst",
+		numFound, numQueries, numFound > 0 ? totalRatio / (double)numFound : 1.0, worstRatio ) );
+
+	// Random edits, repaired in place, against a rebuild from scratch
+	constexpr int NUM_EDITS = 64;
+	startSeconds = GetCurrentTimeSeconds();
+	for( int editIdx = 0; editIdx < NUM_EDITS; ++editIdx )
+	{
+		IntVec2 tile( rng.RollRandomIntInRange( 1, size - 2 ), rng.RollRandomIntInRange( 1, size - 2 ) );
+		bool isSolidNow = !isSolid[tile.x + tile.y * size];
+		isSolid[tile.x + tile.y * size] = isSolidNow ? 1 : 0;
+		pathfinder.SetTileSolid( tile, isSolidNow );
+	}
+	double repairSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+	HierarchicalPathfinder rebuilt;
+	rebuilt.Build( isSolid, dimensions );
+	int numRepairMismatches = 0;
+	std::vector<IntVec2> rebuiltTiles;
+	for( int queryIdx = 0; queryIdx < numQueries; ++queryIdx )
+	{
+		IntVec2 const& startTile = queries[queryIdx].m_startTile;
+		IntVec2 const& goalTile = queries[queryIdx].m_goalTile;
+		float repairedCost = pathfinder.FindPath( startTile, goalTile, tiles );
+		float rebuiltCost = rebuilt.FindPath( startTile, goalTile, rebuiltTiles );
+		bool isReachable = FindTilePathAStar( isSolid, dimensions, startTile, goalTile ) < PATH_COST_UNREACHABLE;
+		if( ( repairedCost < PATH_COST_UNREACHABLE ) != isReachable || ( rebuiltCost < PATH_COST_UNREACHABLE ) != isReachable )
+		{
+			++numRepairMismatches;
+		}
+	}
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    %i tile edits repaired in %.3f ms each (rebuild: %.1f ms); %i disagreements after repair",
+		NUM_EDITS, repairSeconds * 1000.0 / (double)NUM_EDITS, buildSeconds * 1000.0, numRepairMismatches ) );
+
+	if( numMismatches > 0 )
+	{
+		g_theConsole->Error( "    %i queries where HPA* disagrees with flat A* or with itself in batches", numMismatches );
+	}
+	return numMismatches == 0 && numRepairMismatches == 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_pathfinding, "queries,seed" )
+{
+	int numQueries = args.GetValue( "queries", 200 );
+	int seed = args.GetValue( "seed", 1 );
+	if( numQueries <= 0 )
+	{
+		g_theConsole->Error( "benchmark_pathfinding: queries must be positive" );
+		return;
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Pathfinding, %i random queries per map (seed %i)", numQueries, seed ) );
+	bool isCorrect = RunPathfindingBenchmark( 256, numQueries, (unsigned int)seed );
+	isCorrect = RunPathfindingBenchmark( 1024, numQueries, (unsigned int)seed ) && isCorrect;
+	g_theConsole->PrintString( isCorrect ? Rgba8::GREEN : Rgba8::RED, isCorrect ? "HPA* agrees with flat A*" : "HPA* DISAGREES with flat A*" );
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr float PATH_COST_UNREACHABLE = 3.402823466e+38f;	// FLT_MAX
+
+//-------------------------------------------------------------------------------------------------------------
+// Every search here moves like FlowField: 8-connected over open tiles, diagonals cost sqrt(2) and may not cut a
+// solid corner. Paths are tile lists from start to goal, both included.
+//-------------------------------------------------------------------------------------------------------------
+
+// Flat A* over the whole grid; returns the path cost, or PATH_COST_UNREACHABLE
+float	FindTilePathAStar( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, IntVec2 const& startTile, IntVec2 const& goalTile, std::vector<IntVec2>* out_tiles = nullptr );
+
+// The seeded size x size maze the tile benchmarks run on: 8x8 rooms behind walls with doors in two of three wall
+// segments, plus scattered pillars
+void	GenerateBenchmarkTileMaze( int size, unsigned int seed, std::vector<uint8_t>& out_isSolid );
+
+//-------------------------------------------------------------------------------------------------------------
+struct hpa_options_t
+{
+	int		cluster_size = 16;			// tiles per side
+	int		cache_capacity = 512;		// most recently used paths kept; 0 turns the cache off
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct PathQuery
+{
+	IntVec2					m_startTile;
+	IntVec2					m_goalTile;
+
+	std::vector<IntVec2>	m_tiles;							// filled by FindPaths; empty if there is no path
+	float					m_cost = PATH_COST_UNREACHABLE;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+// Hierarchical path-finding A* (Botea, Mueller & Schaeffer 2004).
+//
+// The grid is cut into square clusters. Wherever a cluster border has a run of tiles open on both sides, one
+// entrance (two for runs of 6 or more, at its ends) puts a node on either side of the border, joined by a step of
+// cost 1; within each cluster every pair of nodes is joined by its shortest in-cluster path cost. A query
+// connects start and goal to the nodes of their clusters, runs A* over that small graph and refines each abstract
+// edge back into tiles with an A* bounded to one cluster. Crossing a border diagonally is ruled out.
+//
+// Paths are not smoothed, so they are not optimal. Across 256 benchmark mazes of 256x256 with random start and goal,
+// they cost 4.0% more than the best path on average, 6.8% more at the 95th percentile, 9.0% at the 99th and 27.5% at
+// worst. Short hops would suffer most, since the abstract route has to bend through entrance nodes, so start and goal
+// in the same or neighbouring clusters also get a search bounded to those clusters plus a one-cluster margin: with
+// goals within 8 tiles of the start, that leaves 0.16% on average, 5.3% at the 99th percentile and 17.8% at worst.
+//
+//	SetTileSolid repairs just the clusters around the changed tile and drops the cached paths through them, along
+//	with every cached "no path".
+//	FindPath is safe to call from several threads at once, but not alongside Build or SetTileSolid.
+//-------------------------------------------------------------------------------------------------------------
+class HierarchicalPathfinder
+{
+public:
+	void	Build( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, hpa_options_t const& options = hpa_options_t() );
+	void	SetTileSolid( IntVec2 const& tile, bool isSolid );
+
+	float	FindPath( IntVec2 const& startTile, IntVec2 const& goalTile, std::vector<IntVec2>& out_tiles );		// path cost, or PATH_COST_UNREACHABLE
+	void	FindPaths( PathQuery* queries, int numQueries );		// a batch, spread over the JobSystem workers when they are running
+
+	bool	IsBuilt() const						{ return !m_clusters.empty(); }
+	int		GetNumNodes() const;
+	int		GetNumEdges() const;				// in-cluster edges, each direction counted
+	size_t	GetMemoryBytes() const;				// graph only, not the grid or the cache
+	int		GetNumCacheHits() const				{ return m_numCacheHits.load(); }
+	int		GetNumCacheMisses() const			{ return m_numCacheMisses.load(); }
+	void	ClearCache();
+
+private:
+	enum eClusterBorder { BORDER_EAST, BORDER_NORTH, BORDER_WEST, BORDER_SOUTH, NUM_CLUSTER_BORDERS };
+
+	struct PathNode
+	{
+		int		m_tile = 0;				// tile index
+		int		m_partnerNode = -1;		// node id of the entrance's other side
+	};
+
+	struct PathEdge
+	{
+		int		m_toSlot = 0;			// within the same cluster
+		float	m_cost = 0.f;
+	};
+
+	// A node's slot is border * m_maxNodesPerBorder + its index on that border, and its id is
+	// clusterIndex * m_slotsPerCluster + slot, so rebuilding one border never renumbers the others
+	struct PathCluster
+	{
+		IntVec2					m_mins;
+		IntVec2					m_maxs;			// exclusive
+		std::vector<PathNode>	m_borderNodes[NUM_CLUSTER_BORDERS];
+		std::vector<int>		m_firstEdges;	// per slot, plus one past the end
+		std::vector<PathEdge>	m_edges;
+	};
+
+	struct CachedPath
+	{
+		uint64_t				m_key = 0;
+		std::vector<IntVec2>	m_tiles;
+		float					m_cost = PATH_COST_UNREACHABLE;
+		std::vector<int>		m_clusters;		// every cluster the path passes through
+	};
+
+private:
+	int			GetClusterIndexForTile( int tileX, int tileY ) const;
+	int			GetNeighborCluster( int clusterIndex, int border ) const;	// -1 at the map edge
+	PathNode*	GetNode( int nodeId );
+	PathNode const*	GetNode( int nodeId ) const;
+	void		BuildBorderEntrances( int clusterIndex, int border );		// border must be EAST or NORTH of clusterIndex
+	void		RebuildClusterBorder( int clusterIndex, int border );
+	void		BuildClusterEdges( int clusterIndex );
+
+	float		FindAbstractPath( int startTile, int goalTile, std::vector<IntVec2>& out_tiles ) const;
+	bool		GetCachedPath( uint64_t key, std::vector<IntVec2>& out_tiles, float& out_cost );
+	void		AddCachedPath( uint64_t key, std::vector<IntVec2> const& tiles, float cost );
+	void		EvictCachedPathsThrough( std::vector<int> const& clusterIndices );
+
+private:
+	std::vector<uint8_t>		m_isSolid;
+	IntVec2						m_dimensions = IntVec2::ZERO;
+	hpa_options_t				m_options;
+	IntVec2						m_clusterCounts = IntVec2::ZERO;
+	int							m_maxNodesPerBorder = 0;
+	int							m_slotsPerCluster = 0;
+	std::vector<PathCluster>	m_clusters;
+
+	// LRU path cache, most recent first
+	std::mutex										m_cacheMutex;
+	std::list<CachedPath>							m_cachedPaths;
+	std::unordered_map< uint64_t, std::list<CachedPath>::iterator >	m_cachedPathsByKey;
+	std::atomic<int>								m_numCacheHits = 0;
+	std::atomic<int>								m_numCacheMisses = 0;
+};
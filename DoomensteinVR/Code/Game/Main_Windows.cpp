@@ -5,12 +5,16 @@
 #include <crtdbg.h>
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/UnitTest.hpp"
 #include "Engine/Platform//Window.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/App.hpp"
+#include "Game/SimulationBenchmark.hpp"
 
 App* g_theApp = nullptr;
 Window* g_theWindow = nullptr;
+extern JobSystem* g_theJobSystem;
 
 
 //-----------------------------------------------------------------------------------------------
@@ -35,9 +39,29 @@ int WINAPI WinMain( HINSTANCE applicationInstanceHandle, HINSTANCE, LPSTR comman
 	const std::string coordinate = g_gameConfigBlackboard.GetValue( "coordinate", "XnZY" ); 
 	
 
-	UNUSED( commandLineString );
 	UNUSED( applicationInstanceHandle );
 
+	const std::string commandLine = commandLineString ? commandLineString : "";
+
+	// Headless unit tests; the exit code is the number that failed. Workers run, so the threaded paths are covered too
+	if( IsUnitTestRunRequested( commandLine ) )
+	{
+		g_theJobSystem = new JobSystem();
+		g_theJobSystem->StartUp();
+		int numFailed = RunUnitTestsFromCommandLine( commandLine );
+		g_theJobSystem->ShutDown();
+		delete g_theJobSystem;
+		g_theJobSystem = nullptr;
+		return numFailed;
+	}
+
+	// Headless simulation benchmark; never opens a window
+	if( SimulationBenchmark::IsRequested( commandLine ) )
+	{
+		SimulationBenchmark benchmark( SimulationBenchmarkConfig::ParseCommandLine( commandLine ) );
+		return benchmark.Run() ? 0 : 1;
+	}
+
 
 	g_theWindow = new Window();
 	g_theWindow->Open( APP_NAME, theWindowAspect, 0.85f );
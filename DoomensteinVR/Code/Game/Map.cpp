@@ -9,6 +9,10 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Time.hpp"
+
+//----------------------------------------------------------------------------
+constexpr double NET_ID_REUSE_DELAY_SECONDS = 10.0;	// well past SNAPSHOT_HISTORY_SIZE sends at any send rate
 
 Map::Map( char const* mapName )
 {
@@ -97,6 +101,10 @@ void Map::AddEntityToMap( Entity* e )
 		return; 
 	}
 
+	if( e->m_netId == 0 ) {
+		e->m_netId = AllocateNetId();
+	}
+
 	AddEntityToList( e, m_allEntities );
 	if( e->IsPlayer() )
 	{
@@ -112,6 +120,42 @@ void Map::AddEntityToMap( Entity* e )
 	}
 }
 
+uint16_t Map::AllocateNetId()
+{
+	if( m_nextNetId < m_endNetId ) {
+		return (uint16_t)m_nextNetId++;
+	}
+
+	if( !m_releasedNetIds.empty() && GetCurrentTimeSeconds() - m_releasedNetIds.front().m_releaseSeconds >= NET_ID_REUSE_DELAY_SECONDS ) {
+		uint16_t netId = m_releasedNetIds.front().m_netId;
+		m_releasedNetIds.pop_front();
+		return netId;
+	}
+
+	ERROR_AND_DIE( Stringf( "Map \"%s\" ran out of net ids: %i live, %i cooling down", m_mapName.c_str(),
+		m_endNetId - m_firstNetId - (int)m_releasedNetIds.size(), (int)m_releasedNetIds.size() ) );
+}
+
+void Map::ReleaseNetId( uint16_t netId )
+{
+	if( netId < m_firstNetId || (int)netId >= m_endNetId ) {
+		return;
+	}
+
+	ReleasedNetId released;
+	released.m_netId = netId;
+	released.m_releaseSeconds = GetCurrentTimeSeconds();
+	m_releasedNetIds.push_back( released );
+}
+
+void Map::SetNetIdRange( uint16_t firstNetId, int endNetId )
+{
+	m_firstNetId = firstNetId;
+	m_endNetId = endNetId;
+	m_nextNetId = firstNetId;
+	m_releasedNetIds.clear();
+}
+
 void Map::RemoveEntityFromList( Entity* e, EntityList& list )
 {
 	for( int i = 0; i < (int)list.size(); ++i )
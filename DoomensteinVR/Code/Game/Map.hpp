@@ -1,14 +1,27 @@
 #pragma once
 #include "Game/Entity.hpp"
 #include "Game/RaycastResult.hpp"
+#include "Engine/Math/IntVec2.hpp"
 #include "Engine/Math/Vec3.hpp"
+#include <deque>
 #include <string>
 #include <vector>
 
+struct Frustum;
+
 
 //----------------------------------------------------------------------------
 typedef std::vector<Entity*> EntityList;
 
+//----------------------------------------------------------------------------
+// Where the last Update() spent its time; read by the headless simulation benchmark
+struct MapUpdateTimings
+{
+	double	m_entityCollisionSeconds = 0.0;
+	double	m_entityUpdateSeconds = 0.0;	// AI, movement and wall pushes
+	double	m_chaseFieldSeconds = 0.0;		// swapping in or (without job workers) building the chase flow field
+};
+
 //----------------------------------------------------------------------------
 
 class Map
@@ -20,6 +33,7 @@ public:
 	virtual void	Update( float deltaSeconds ) = 0;
 	virtual void	Render( Camera& camera ) const = 0;
 	virtual void	UpdateMeshes() = 0;
+	virtual void	UpdateVisibility( Frustum const& frustum ) = 0;	// once per frame, before any eye renders
 
 	// Entity Management
 	virtual Entity* SpawnNewEntityOfType( std::string const& typeName );
@@ -29,6 +43,11 @@ public:
 	virtual void	RemoveEntityFromList( Entity* e, EntityList& list );
 	virtual void	AddEntityToList( Entity* e, EntityList& list ); 
 
+	// Net ids
+	uint16_t		AllocateNetId();								// dies once every id in the range is live or cooling down
+	void			ReleaseNetId( uint16_t netId );					// ignores ids from outside this peer's range
+	void			SetNetIdRange( uint16_t firstNetId, int endNetId );	// [first, end); forgets released ids
+
 	// Entity Physics
 	virtual void	ResolveEntityCollision();
 	virtual void	PushEntityVsEntity(Entity& a, Entity& b );
@@ -37,6 +56,11 @@ public:
 	virtual void	PushMobileEntityOffImmobileEntiity( Entity& mobile, Entity& immobile ); 
 	virtual bool	DoEntitiesOverlap( Entity& a, Entity& b );
 
+	// AI
+	virtual Vec2	GetChaseDirection( Vec2 const& position ) const = 0;	// unit step toward the player; zero to head straight for them
+	virtual bool	FindPath( Vec2 const& start, Vec2 const& goal, std::vector<IntVec2>& out_tiles ) = 0;	// tiles from start to goal, both included
+	virtual bool	IsPotentiallyVisible( Vec2 const& from, Vec2 const& to ) const = 0;	// false only if walls certainly block every sight line
+
 	// Raycast
 	virtual RaycastResult	Raycast( Vec2 const& start, Vec2 const& forwardDirection, float maxDistance ) = 0;
 
@@ -48,6 +72,20 @@ public:
 	EntityList		m_NPCs;	// non-Player Actors only (does not include players)
 	EntityList		m_projectiles;
 	EntityList		m_players;
+
+	// Host ids stay below SNAPSHOT_FIRST_LOCAL_NET_ID; a client moves its own range above it.
+	// Released ids wait NET_ID_REUSE_DELAY_SECONDS so no snapshot baseline still names the old entity.
+	struct ReleasedNetId
+	{
+		uint16_t	m_netId = 0;
+		double		m_releaseSeconds = 0.0;
+	};
+	uint16_t					m_firstNetId = 1;		// 0 means "no id"
+	int							m_endNetId = 0x8000;
+	int							m_nextNetId = 1;
+	std::deque<ReleasedNetId>	m_releasedNetIds;		// oldest first
+
+	MapUpdateTimings	m_lastUpdateTimings;
 };
 
 
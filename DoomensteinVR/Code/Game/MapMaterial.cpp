@@ -42,8 +42,11 @@ MaterialsSheet::MaterialsSheet( XmlElement const& materialsDef )
 	
 	// #ToDo: check error
 	//Texture const* spriteSheetTexture  = g_theRenderer->CreateOrGetTextureFromFile( imagePath.c_str() );
-	m_diffuseTexture = g_theRenderer->CreateOrGetTextureFromFile( imagePath.c_str() );
-	m_diffuseSheet = new SpriteSheet( *m_diffuseTexture, m_layout );
+	if( g_theRenderer )	// headless runs only need the gameplay data
+	{
+		m_diffuseTexture = g_theRenderer->CreateOrGetTextureFromFile( imagePath.c_str() );
+		m_diffuseSheet = new SpriteSheet( *m_diffuseTexture, m_layout );
+	}
 }
 
 SpriteSheet* MaterialsSheet::CreateMaterialsSpriteSheetFromElement( XmlElement const& materialsDef )
@@ -4,6 +4,7 @@
 #include "Game/LighthouseTracking.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/MeshSimplifier.hpp"
 #include "Engine/Renderer/MeshUtils.hpp"
 #include <vector>
 
@@ -51,17 +52,21 @@ void Projectile::Render( Camera& camera )
 {
 	UNUSED( camera );
 
-	if( m_faction == Faction::GOOD && m_mesh )
+	if( ( m_faction == Faction::GOOD || m_faction == Faction::EVIL ) && m_mesh )
 	{
-		g_theRenderer->SetModelMatrix( m_transform.ToMatrix() );
+		Mat44 modelMatrix = m_transform.ToMatrix();
+		g_theRenderer->SetModelMatrix( modelMatrix );
 		g_theRenderer->BindTexture( g_theRenderer->CreateOrGetTextureFromFile( "Data/Textures/Bullet.png" ) );
-		g_theRenderer->DrawMesh( m_mesh );
-	}
-	else if( m_faction == Faction::EVIL && m_mesh )
-	{
-		g_theRenderer->SetModelMatrix( m_transform.ToMatrix() );
-		g_theRenderer->BindTexture( g_theRenderer->CreateOrGetTextureFromFile( "Data/Textures/Bullet.png" ) );
-		g_theRenderer->DrawMesh( m_mesh );
+
+		// picked against both eyes so they always draw the same LOD
+		MeshLODChain const& lods = g_theGame->m_bulletLODs;
+		if( lods.m_lods.empty() ) {
+			g_theRenderer->DrawMesh( m_mesh );
+			return;
+		}
+		Camera const* eyeCameras[] = { &g_theGame->m_worldCameraLeft, &g_theGame->m_worldCameraRight };
+		MeshLOD const& lod = lods.m_lods[SelectMeshLOD( lods, modelMatrix, eyeCameras, 2 )];
+		g_theRenderer->DrawMesh( m_mesh, (int)lod.m_indexOffset, (int)lod.m_indexCount );
 	}
 }
 
@@ -108,8 +113,11 @@ void Projectile::CheckCollision()
 				m_hasAppliedDamage = true;
 				m_isDead = true;	// Mark self as dead
 
-				g_theLighthouse->AddHapticPulse( vr::TrackedControllerRole_LeftHand, 0.25f );
-				g_theLighthouse->AddHapticPulse( vr::TrackedControllerRole_RightHand, 0.25f );
+				if( g_theLighthouse && g_theLighthouse->IsValid() )
+				{
+					g_theLighthouse->AddHapticPulse( vr::TrackedControllerRole_LeftHand, 0.25f );
+					g_theLighthouse->AddHapticPulse( vr::TrackedControllerRole_RightHand, 0.25f );
+				}
 			}
 		}
 		
@@ -33,7 +33,8 @@ void RangedEnemy::Update( float deltaSeconds )
 	{
 	case AIState::IDLE: {
 		constexpr float maxVisionRange = 5.0f;
-		bool hasSeenPlayer = IsPointInForwardSector2D( player->m_position, m_position, m_yawDegrees, 80.f, maxVisionRange );
+		bool hasSeenPlayer = IsPointInForwardSector2D( player->m_position, m_position, m_yawDegrees, 80.f, maxVisionRange )
+			&& m_map->IsPotentiallyVisible( m_position, player->m_position );
 		if( hasSeenPlayer )
 		{
 			m_state = AIState::ATTACK;
@@ -78,7 +79,7 @@ void RangedEnemy::Render( Camera& camera )
 	Anim* animation = m_anims.at( "Idle" );
 	SpriteDefinition const* spriteDef = nullptr;
 
-	Vec2 dispToCam = Vec2( camera.m_transform.m_position.x, camera.m_transform.m_position.y ) - m_position;
+	Vec2 dispToCam = Vec2( camera.m_transform.m_position.x, camera.m_transform.m_position.y ) - GetRenderPosition();
 	Vec2 dispToCamerLocal = dispToCam.GetRotatedDegrees( -m_yawDegrees );
 	float largestDotProduct = -999999.f;
 	int spriteIndex = 0;
@@ -125,7 +126,7 @@ void RangedEnemy::Render( Camera& camera )
 	Vec2 uvMins, uvMaxs;
 	spriteDef->GetUVs( uvMins, uvMaxs );
 
-	Vec3 centerPos = Vec3( m_position.x, m_position.y, 0 ) + Vec3( 0.f, 0.f, 0.5f * m_spriteSize.y );
+	Vec3 centerPos = Vec3( GetRenderPosition(), 0.f ) + Vec3( 0.f, 0.f, 0.5f * m_spriteSize.y );
 	Vec3 BL, BR, TR, TL;
 	GetBillboardQuad( BL, BR, TR, TL, camera, centerPos, m_spriteSize, m_billboardMode );
 
@@ -0,0 +1,428 @@
+#include "Game/SimulationBenchmark.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/TileMap.hpp"
+#include "Game/Entity.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Clock.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/NamedStrings.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Physics/Physics2D.hpp"
+#include "Engine/Physics/Rigidbody2D.hpp"
+#include "Engine/Physics/DiscCollider2D.hpp"
+#include <algorithm>
+#include <cmath>
+
+extern JobSystem*	g_theJobSystem;
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr float	SCRIPTED_PLAYER_SPEED				= 1.5f;
+constexpr float	SCRIPTED_PLAYER_GOAL_RADIUS			= 0.25f;
+constexpr float	SCRIPTED_PLAYER_MAX_SECONDS_PER_GOAL	= 6.f;		// give up on goals behind walls
+constexpr int	SCRIPTED_PLAYER_HEALTH				= 1000000000;	// the player never dies mid-run
+
+
+//-------------------------------------------------------------------------------------------------------------
+static std::string GetJsonEscaped( std::string const& text )
+{
+	std::string escaped;
+	escaped.reserve( text.size() );
+	for( char c : text )
+	{
+		if( c == '"' || c == '\\' ) {
+			escaped += '\\';
+			escaped += c;
+		} else if( (unsigned char)c < 0x20 ) {
+			escaped += Stringf( "\\u%04x", (unsigned int)(unsigned char)c );
+		} else {
+			escaped += c;
+		}
+	}
+	return escaped;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static double GetPercentile( std::vector<double> const& sortedValues, double percentile )
+{
+	if( sortedValues.empty() ) {
+		return 0.0;
+	}
+
+	// nearest-rank
+	int rank = (int)ceil( percentile / 100.0 * (double)sortedValues.size() );
+	rank = Clamp( rank, 1, (int)sortedValues.size() );
+	return sortedValues[rank - 1];
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static std::string GetStatsAsJson( std::vector<double> values )
+{
+	std::sort( values.begin(), values.end() );
+
+	double sum = 0.0;
+	for( double value : values ) {
+		sum += value;
+	}
+	double mean = values.empty() ? 0.0 : sum / (double)values.size();
+	double max = values.empty() ? 0.0 : values.back();
+
+	return Stringf( "{ \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }",
+		mean * 1000.0, GetPercentile( values, 50.0 ) * 1000.0, GetPercentile( values, 95.0 ) * 1000.0,
+		GetPercentile( values, 99.0 ) * 1000.0, max * 1000.0 );
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+static std::string GetCountStatsAsJson( std::vector<double> values )
+{
+	std::sort( values.begin(), values.end() );
+
+	double sum = 0.0;
+	for( double value : values ) {
+		sum += value;
+	}
+	double mean = values.empty() ? 0.0 : sum / (double)values.size();
+	double max = values.empty() ? 0.0 : values.back();
+
+	return Stringf( "{ \"mean\": %.2f, \"p50\": %.0f, \"p95\": %.0f, \"max\": %.0f }",
+		mean, GetPercentile( values, 50.0 ), GetPercentile( values, 95.0 ), max );
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+STATIC SimulationBenchmarkConfig SimulationBenchmarkConfig::ParseCommandLine( std::string const& commandLine )
+{
+	NamedStrings args;
+	Strings tokens = SplitStringOnDelimiter( commandLine, ' ' );
+	for( int tokenIdx = 0; tokenIdx < (int)tokens.size(); ++tokenIdx )
+	{
+		Strings keyAndValue = SplitStringOnDelimiter( tokens[tokenIdx], '=' );
+		if( keyAndValue.size() == 2 ) {
+			args.SetValue( keyAndValue[0], keyAndValue[1] );
+		}
+	}
+
+	SimulationBenchmarkConfig config;
+	config.m_mapName			= args.GetValue( "map", config.m_mapName );
+	config.m_numFrames			= args.GetValue( "frames", config.m_numFrames );
+	config.m_numWarmupFrames	= args.GetValue( "warmup", config.m_numWarmupFrames );
+	config.m_fixedDeltaSeconds	= args.GetValue( "dt", config.m_fixedDeltaSeconds );
+	config.m_seed				= (unsigned int)args.GetValue( "seed", (int)config.m_seed );
+	config.m_numActors			= args.GetValue( "actors", config.m_numActors );
+	config.m_numRangedEnemies	= args.GetValue( "ranged", config.m_numRangedEnemies );
+	config.m_isAILODEnabled		= args.GetValue( "ailod", config.m_isAILODEnabled );
+	config.m_areJobWorkersEnabled	= args.GetValue( "workers", config.m_areJobWorkersEnabled );
+	config.m_outputFilePath		= args.GetValue( "out", config.m_outputFilePath );
+	return config;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+SimulationBenchmark::SimulationBenchmark( SimulationBenchmarkConfig const& config )
+	:m_config( config )
+{
+	m_rng.Reset( config.m_seed );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+SimulationBenchmark::~SimulationBenchmark()
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------
+STATIC bool SimulationBenchmark::IsRequested( std::string const& commandLine )
+{
+	Strings tokens = SplitStringOnDelimiter( commandLine, ' ' );
+	return std::find( tokens.begin(), tokens.end(), "-benchmark" ) != tokens.end();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool SimulationBenchmark::Run()
+{
+	if( !StartUp() ) {
+		ShutDown();
+		return false;
+	}
+
+	FrameTimings timings;
+	for( int frameIdx = 0; frameIdx < m_config.m_numWarmupFrames; ++frameIdx )
+	{
+		StepFrame( timings );
+	}
+
+	m_frameTimings.reserve( m_config.m_numFrames );
+	for( int frameIdx = 0; frameIdx < m_config.m_numFrames; ++frameIdx )
+	{
+		StepFrame( timings );
+		m_frameTimings.push_back( timings );
+	}
+
+	std::string results = GetResultsAsJson();
+	bool wasWritten = WriteStringToFile( m_config.m_outputFilePath, results );
+	if( !wasWritten ) {
+		DebuggerPrintf( "Benchmark: could not write results to \"%s\"\n", m_config.m_outputFilePath.c_str() );
+	}
+
+	ShutDown();
+	return wasWritten;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool SimulationBenchmark::StartUp()
+{
+	Clock::SystemStartup();
+
+	g_theConsole = new DevConsole();
+	g_theEventSystem = new EventSystem();
+	g_theInput = new InputSystem();
+
+	g_theJobSystem = new JobSystem();
+	if( m_config.m_areJobWorkersEnabled ) {
+		g_theJobSystem->StartUp();
+	}
+
+	g_theGame = new Game();
+	g_theGame->StartUpHeadless();
+
+	World* world = g_theGame->m_theWorld;
+	Map* map = world->GetMap( m_config.m_mapName.c_str() );
+	TileMap* tileMap = dynamic_cast<TileMap*>( map );
+	if( tileMap == nullptr ) {
+		ReportFailure( Stringf( "no tile map named \"%s\" in Data/Maps", m_config.m_mapName.c_str() ) );
+		return false;
+	}
+	world->EnterMap( tileMap );
+
+	ai_scheduler_options_t aiOptions = tileMap->m_aiScheduler.GetOptions();
+	aiOptions.is_enabled = m_config.m_isAILODEnabled;
+	tileMap->m_aiScheduler.SetOptions( aiOptions );
+
+	Entity* player = g_theGame->GetPlayer();
+	if( player == nullptr ) {
+		ReportFailure( Stringf( "map \"%s\" has no player start", m_config.m_mapName.c_str() ) );
+		return false;
+	}
+	player->m_health = SCRIPTED_PLAYER_HEALTH;
+	m_playerGoal = RollOpenTileCenter( *tileMap );
+
+	SpawnPopulation( *tileMap );
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SimulationBenchmark::ShutDown()
+{
+	// the bodies belong to Physics2D, which goes down with the headless game
+	m_bodies.clear();
+	m_population.clear();
+
+	if( g_theGame ) {
+		g_theGame->ShutDownHeadless();
+	}
+	delete g_theGame;
+	g_theGame = nullptr;
+
+	if( g_theJobSystem ) {
+		g_theJobSystem->ShutDown();
+	}
+	delete g_theJobSystem;
+	g_theJobSystem = nullptr;
+
+	delete g_theInput;
+	g_theInput = nullptr;
+
+	delete g_theEventSystem;
+	g_theEventSystem = nullptr;
+
+	delete g_theConsole;
+	g_theConsole = nullptr;
+
+	Clock::SystemShutdown();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// The app has no console window, so a failed setup is written where the results would have gone
+//-------------------------------------------------------------------------------------------------------------
+void SimulationBenchmark::ReportFailure( std::string const& reason ) const
+{
+	DebuggerPrintf( "Benchmark: %s\n", reason.c_str() );
+	WriteStringToFile( m_config.m_outputFilePath, Stringf( "{ \"error\": \"%s\" }\n", GetJsonEscaped( reason ).c_str() ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SimulationBenchmark::SpawnPopulation( TileMap& tileMap )
+{
+	Physics2D* physics = g_theGame->m_physics;
+
+	int numToSpawn = m_config.m_numActors + m_config.m_numRangedEnemies;
+	for( int spawnIdx = 0; spawnIdx < numToSpawn; ++spawnIdx )
+	{
+		char const* typeName = ( spawnIdx < m_config.m_numActors ) ? "Pinky" : "RangedEnemy";
+		Entity* npc = tileMap.SpawnNewEntityOfType( typeName );
+		if( npc == nullptr ) {
+			continue;
+		}
+
+		npc->m_position = RollOpenTileCenter( tileMap );
+		npc->m_yawDegrees = m_rng.RollRandomFloatInRange( 0.f, 360.f );
+		m_population.push_back( npc );
+
+		Rigidbody2D* body = physics->CreateRigidbody();
+		body->TakeCollider( physics->CreateDiscCollider( Vec2::ZERO, npc->m_radius ) );
+		body->SetSimulationMode( SIMULATION_MODE_KINEMATIC );
+		body->SetPosition( npc->m_position );
+		m_bodies.push_back( body );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+Vec2 SimulationBenchmark::RollOpenTileCenter( TileMap& tileMap )
+{
+	IntVec2 dimensions = tileMap.GetTileDimensions();
+	int numTiles = dimensions.x * dimensions.y;
+	for( int attempt = 0; attempt < numTiles * 4; ++attempt )
+	{
+		IntVec2 tileCoords( m_rng.RollRandomIntLessThan( dimensions.x ), m_rng.RollRandomIntLessThan( dimensions.y ) );
+		if( !tileMap.IsTileSolid( tileCoords ) ) {
+			return Vec2( (float)tileCoords.x + 0.5f, (float)tileCoords.y + 0.5f );
+		}
+	}
+
+	return Vec2( tileMap.m_playerStartPos.x, tileMap.m_playerStartPos.y );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Stands in for the headset: walks the player from one random open tile to the next
+//-------------------------------------------------------------------------------------------------------------
+void SimulationBenchmark::UpdateScriptedPlayer( float deltaSeconds )
+{
+	Entity* player = g_theGame->GetPlayer();
+	TileMap* tileMap = dynamic_cast<TileMap*>( g_theGame->m_theWorld->m_currentMap );
+	if( player == nullptr || tileMap == nullptr ) {
+		return;
+	}
+
+	m_secondsTowardGoal += deltaSeconds;
+	Vec2 dispToGoal = m_playerGoal - player->m_position;
+	if( dispToGoal.GetLength() < SCRIPTED_PLAYER_GOAL_RADIUS || m_secondsTowardGoal > SCRIPTED_PLAYER_MAX_SECONDS_PER_GOAL )
+	{
+		m_playerGoal = RollOpenTileCenter( *tileMap );
+		m_secondsTowardGoal = 0.f;
+		dispToGoal = m_playerGoal - player->m_position;
+	}
+
+	player->m_yawDegrees = dispToGoal.GetAngleDegrees();
+	player->m_position += dispToGoal.GetNormalized() * SCRIPTED_PLAYER_SPEED * deltaSeconds;
+
+	// Game::Update snaps both eye cameras to the player; projectiles aim and hit-test against them
+	Vec3 eyePosition = Vec3( player->m_position, 0.f );
+	g_theGame->m_worldCameraLeft.m_transform.SetPosition( eyePosition );
+	g_theGame->m_worldCameraRight.m_transform.SetPosition( eyePosition );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SimulationBenchmark::SyncPhysicsBodies()
+{
+	for( int bodyIdx = 0; bodyIdx < (int)m_bodies.size(); ++bodyIdx )
+	{
+		m_bodies[bodyIdx]->SetPosition( m_population[bodyIdx]->m_position );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SimulationBenchmark::StepFrame( FrameTimings& out_timings )
+{
+	double secondsPerCount = GetSecondsPerPerformanceCount();
+	float deltaSeconds = m_config.m_fixedDeltaSeconds;
+
+	uint64_t frameStartCount = GetPerformanceCounter();
+	Clock::GetMaster()->Update( deltaSeconds );
+	UpdateScriptedPlayer( deltaSeconds );
+
+	uint64_t worldStartCount = GetPerformanceCounter();
+	World* world = g_theGame->m_theWorld;
+	world->Update( deltaSeconds );
+
+	uint64_t physicsStartCount = GetPerformanceCounter();
+	SyncPhysicsBodies();
+	g_theGame->m_physics->Update( deltaSeconds );
+	g_theGame->m_physics->EndFrame();
+	uint64_t frameEndCount = GetPerformanceCounter();
+
+	MapUpdateTimings const& mapTimings = world->m_currentMap->m_lastUpdateTimings;
+	out_timings.m_frameSeconds				= (double)( frameEndCount - frameStartCount ) * secondsPerCount;
+	out_timings.m_worldSeconds				= (double)( physicsStartCount - worldStartCount ) * secondsPerCount;
+	out_timings.m_entityCollisionSeconds	= mapTimings.m_entityCollisionSeconds;
+	out_timings.m_entityUpdateSeconds		= mapTimings.m_entityUpdateSeconds;
+	out_timings.m_chaseFieldSeconds			= mapTimings.m_chaseFieldSeconds;
+	out_timings.m_physicsSeconds			= (double)( frameEndCount - physicsStartCount ) * secondsPerCount;
+
+	TileMap const* tileMap = dynamic_cast<TileMap const*>( world->m_currentMap );
+	if( tileMap ) {
+		AISchedulerStats const& aiStats = tileMap->m_aiScheduler.GetLastFrameStats();
+		out_timings.m_numNPCsScheduled	= aiStats.m_numScheduled;
+		out_timings.m_numNPCsUpdated	= aiStats.m_numUpdated;
+		out_timings.m_numNPCsFullRate	= aiStats.m_numFullRate;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+std::string SimulationBenchmark::GetResultsAsJson() const
+{
+	int numSamples = (int)m_frameTimings.size();
+	std::vector<double> frameSeconds( numSamples );
+	std::vector<double> worldSeconds( numSamples );
+	std::vector<double> entityCollisionSeconds( numSamples );
+	std::vector<double> entityUpdateSeconds( numSamples );
+	std::vector<double> chaseFieldSeconds( numSamples );
+	std::vector<double> physicsSeconds( numSamples );
+	std::vector<double> npcsUpdated( numSamples );
+	std::vector<double> npcsFullRate( numSamples );
+	double sumNPCsScheduled = 0.0;
+	for( int frameIdx = 0; frameIdx < numSamples; ++frameIdx )
+	{
+		FrameTimings const& timings = m_frameTimings[frameIdx];
+		frameSeconds[frameIdx]				= timings.m_frameSeconds;
+		worldSeconds[frameIdx]				= timings.m_worldSeconds;
+		entityCollisionSeconds[frameIdx]	= timings.m_entityCollisionSeconds;
+		entityUpdateSeconds[frameIdx]		= timings.m_entityUpdateSeconds;
+		chaseFieldSeconds[frameIdx]			= timings.m_chaseFieldSeconds;
+		physicsSeconds[frameIdx]			= timings.m_physicsSeconds;
+		npcsUpdated[frameIdx]				= (double)timings.m_numNPCsUpdated;
+		npcsFullRate[frameIdx]				= (double)timings.m_numNPCsFullRate;
+		sumNPCsScheduled					+= (double)timings.m_numNPCsScheduled;
+	}
+
+	Map const* map = g_theGame->m_theWorld->m_currentMap;
+
+	std::string json = "{\n";
+	json += Stringf( "  \"map\": \"%s\",\n", GetJsonEscaped( m_config.m_mapName ).c_str() );
+	json += Stringf( "  \"seed\": %u,\n", m_config.m_seed );
+	json += Stringf( "  \"frames\": %i,\n", numSamples );
+	json += Stringf( "  \"warmupFrames\": %i,\n", m_config.m_numWarmupFrames );
+	json += Stringf( "  \"fixedDeltaSeconds\": %.6f,\n", m_config.m_fixedDeltaSeconds );
+	json += Stringf( "  \"population\": { \"actors\": %i, \"rangedEnemies\": %i, \"entitiesAtEnd\": %i },\n",
+		m_config.m_numActors, m_config.m_numRangedEnemies, (int)map->m_allEntities.size() );
+	json += "  \"frameMs\": " + GetStatsAsJson( frameSeconds ) + ",\n";
+	json += "  \"subsystemsMs\": {\n";
+	json += "    \"world\": " + GetStatsAsJson( worldSeconds ) + ",\n";
+	json += "    \"entityCollision\": " + GetStatsAsJson( entityCollisionSeconds ) + ",\n";
+	json += "    \"entityUpdate\": " + GetStatsAsJson( entityUpdateSeconds ) + ",\n";
+	json += "    \"chaseField\": " + GetStatsAsJson( chaseFieldSeconds ) + ",\n";
+	json += "    \"physics2D\": " + GetStatsAsJson( physicsSeconds ) + "\n";
+	json += "  },\n";
+	json += Stringf( "  \"aiLOD\": %s,\n", m_config.m_isAILODEnabled ? "true" : "false" );
+	json += Stringf( "  \"jobWorkers\": %i,\n", g_theJobSystem ? (int)g_theJobSystem->m_workerThreads.size() : 0 );
+	json += "  \"npcsPerFrame\": {\n";
+	json += Stringf( "    \"scheduled\": %.2f,\n", numSamples > 0 ? sumNPCsScheduled / (double)numSamples : 0.0 );
+	json += "    \"updated\": " + GetCountStatsAsJson( npcsUpdated ) + ",\n";
+	json += "    \"fullRate\": " + GetCountStatsAsJson( npcsFullRate ) + "\n";
+	json += "  }\n";
+	json += "}\n";
+	return json;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+class Entity;
+class Rigidbody2D;
+class TileMap;
+
+//-------------------------------------------------------------------------------------------------------------
+// Headless simulation benchmark, started from the command line:
+//	DoomensteinVR.exe -benchmark map=TwistyMaze frames=3000 seed=7 actors=64 ranged=16 ailod=1 workers=1 out=Benchmark.json
+//
+// Loads the map from Data/Maps, spawns a seeded population of Actors and RangedEnemies on open tiles,
+// walks the player along a scripted (seeded) route and steps World::Update, Physics2D and the AI for a
+// fixed number of fixed-dt frames. No window, renderer, audio or VR is created.
+// Writes p50/p95/p99 frame times, per-subsystem timings and NPC updates per frame as JSON. ailod=0 turns off
+// the AIScheduler, so every NPC updates every frame; workers=0 leaves the JobSystem stopped, so flow field,
+// PVS and path jobs run inline on the main thread. If the map can't be set up, the output file gets
+// { "error": "..." } instead.
+//-------------------------------------------------------------------------------------------------------------
+struct SimulationBenchmarkConfig
+{
+	std::string		m_mapName			= "TestLevel";
+	int				m_numFrames			= 2000;
+	int				m_numWarmupFrames	= 60;
+	float			m_fixedDeltaSeconds	= 1.f / 90.f;	// headset refresh rate
+	unsigned int	m_seed				= 1;
+	int				m_numActors			= 32;
+	int				m_numRangedEnemies	= 8;
+	bool			m_isAILODEnabled	= true;
+	bool			m_areJobWorkersEnabled	= true;
+	std::string		m_outputFilePath	= "BenchmarkResults.json";
+
+	static SimulationBenchmarkConfig ParseCommandLine( std::string const& commandLine );
+};
+
+//-------------------------------------------------------------------------------------------------------------
+class SimulationBenchmark
+{
+public:
+	explicit SimulationBenchmark( SimulationBenchmarkConfig const& config );
+	~SimulationBenchmark();
+
+	static bool	IsRequested( std::string const& commandLine );
+
+	bool		Run();		// false if the benchmark could not be set up or the results not written
+
+private:
+	struct FrameTimings
+	{
+		double	m_frameSeconds = 0.0;
+		double	m_worldSeconds = 0.0;
+		double	m_entityCollisionSeconds = 0.0;
+		double	m_entityUpdateSeconds = 0.0;
+		double	m_chaseFieldSeconds = 0.0;
+		double	m_physicsSeconds = 0.0;
+		int		m_numNPCsScheduled = 0;
+		int		m_numNPCsUpdated = 0;
+		int		m_numNPCsFullRate = 0;
+	};
+
+	bool		StartUp();
+	void		ShutDown();
+	void		ReportFailure( std::string const& reason ) const;
+	void		SpawnPopulation( TileMap& tileMap );
+	Vec2		RollOpenTileCenter( TileMap& tileMap );
+	void		UpdateScriptedPlayer( float deltaSeconds );
+	void		SyncPhysicsBodies();
+	void		StepFrame( FrameTimings& out_timings );
+	std::string	GetResultsAsJson() const;
+
+private:
+	SimulationBenchmarkConfig	m_config;
+	RandomNumberGenerator		m_rng;
+	std::vector<FrameTimings>	m_frameTimings;
+
+	// Each spawned NPC is mirrored by a kinematic disc in Physics2D. Nothing damages NPCs
+	// during a benchmark run, so the entities outlive it.
+	std::vector<Entity*>		m_population;
+	std::vector<Rigidbody2D*>	m_bodies;
+
+	Vec2						m_playerGoal;
+	float						m_secondsTowardGoal = 0.f;
+};
@@ -0,0 +1,841 @@
+#include "Game/SnapshotReplication.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Game.hpp"
+#include "Game/Map.hpp"
+#include "Game/Entity.hpp"
+#include "Game/EntityDef.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Network/BitStream.hpp"
+#include "Engine/Network/NetworkSystem.hpp"
+#include <algorithm>
+#include <cmath>
+
+//-------------------------------------------------------------------------------------------------------------
+// Wire format. Every datagram starts with a byte-aligned header so the counts can be patched in once
+// the snapshot has been split:
+//	tick 32 | baselineTick 32 (0 = full state) | datagramIdx 16 | numDatagrams 16 | numRecords 16
+// followed by numRecords entity records, in ascending netId order:
+//	isNextNetId 1 [netId 16] | kind 2 | payload
+//	RECORD_DELTA:	positionChanged 1 [x, y: isSmall 1, delta 8 or absolute 20] | yawChanged 1 [yaw 10]
+//					| healthChanged 1 [health 10] | aiStateChanged 1 [aiState 3]
+//	RECORD_FULL:	type 8 | x 20 | y 20 | yaw 10 | health 10 | aiState 3
+//	RECORD_REMOVED:	-
+//-------------------------------------------------------------------------------------------------------------
+constexpr int	HEADER_BYTES				= 14;
+constexpr int	NUM_DATAGRAMS_BYTE_OFFSET	= 10;
+constexpr int	NUM_RECORDS_BYTE_OFFSET		= 12;
+
+constexpr int	NET_ID_BITS					= 16;
+constexpr int	RECORD_KIND_BITS			= 2;
+constexpr int	TYPE_INDEX_BITS				= 8;
+constexpr int	POSITION_BITS				= 20;		// +-4096m at 1/128m
+constexpr int	POSITION_DELTA_BITS			= 8;		// +-1m per snapshot
+constexpr int	YAW_BITS					= 10;		// ~0.35 degrees
+constexpr int	HEALTH_BITS					= 10;
+constexpr int	AI_STATE_BITS				= 3;
+
+constexpr int32_t	MAX_POSITION			= ( 1 << ( POSITION_BITS - 1 ) ) - 1;
+constexpr int32_t	MAX_POSITION_DELTA		= ( 1 << ( POSITION_DELTA_BITS - 1 ) ) - 1;
+constexpr uint16_t	MAX_HEALTH				= ( 1 << HEALTH_BITS ) - 1;
+constexpr uint32_t	YAW_STEPS				= 1 << YAW_BITS;
+
+enum eSnapshotRecordKind : uint32_t
+{
+	RECORD_DELTA,
+	RECORD_FULL,
+	RECORD_REMOVED,
+};
+
+
+//-------------------------------------------------------------------------------------------------------------
+bool EntityNetState::operator==( EntityNetState const& other ) const
+{
+	return m_netId == other.m_netId && m_typeIndex == other.m_typeIndex
+		&& m_positionX == other.m_positionX && m_positionY == other.m_positionY
+		&& m_yaw == other.m_yaw && m_health == other.m_health && m_aiState == other.m_aiState;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static bool IsNetIdLess( EntityNetState const& state, uint16_t netId )
+{
+	return state.m_netId < netId;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static EntityNetState const* FindEntityState( std::vector<EntityNetState> const& states, uint16_t netId )
+{
+	auto found = std::lower_bound( states.begin(), states.end(), netId, IsNetIdLess );
+	if( found == states.end() || found->m_netId != netId ) {
+		return nullptr;
+	}
+	return &( *found );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static std::vector<EntityDef const*> const& GetEntityDefsByTypeIndex()
+{
+	// s_entityTypes is a std::map, so every peer with the same definitions gets the same order
+	static std::vector<EntityDef const*> s_entityDefsByTypeIndex;
+	if( s_entityDefsByTypeIndex.size() != EntityDef::s_entityTypes.size() ) {
+		s_entityDefsByTypeIndex.clear();
+		for( auto const& entityType : EntityDef::s_entityTypes ) {
+			s_entityDefsByTypeIndex.push_back( entityType.second );
+		}
+	}
+	return s_entityDefsByTypeIndex;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static uint8_t GetTypeIndex( EntityDef const* entityDef )
+{
+	std::vector<EntityDef const*> const& entityDefs = GetEntityDefsByTypeIndex();
+	for( int typeIdx = 0; typeIdx < (int)entityDefs.size() && typeIdx < ( 1 << TYPE_INDEX_BITS ); ++typeIdx ) {
+		if( entityDefs[typeIdx] == entityDef ) {
+			return (uint8_t)typeIdx;
+		}
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void QuantizeEntity( Entity const& entity, EntityNetState& out_state )
+{
+	out_state.m_netId = entity.m_netId;
+	out_state.m_typeIndex = GetTypeIndex( entity.m_def );
+	out_state.m_positionX = Clamp( (int)std::floor( entity.m_position.x * SNAPSHOT_POSITION_UNITS_PER_METER + 0.5f ), -MAX_POSITION, MAX_POSITION );
+	out_state.m_positionY = Clamp( (int)std::floor( entity.m_position.y * SNAPSHOT_POSITION_UNITS_PER_METER + 0.5f ), -MAX_POSITION, MAX_POSITION );
+
+	float yawFraction = entity.m_yawDegrees / 360.f;
+	yawFraction -= std::floor( yawFraction );
+	out_state.m_yaw = (uint16_t)( (uint32_t)std::floor( yawFraction * (float)YAW_STEPS + 0.5f ) & ( YAW_STEPS - 1 ) );
+
+	out_state.m_health = (uint16_t)Clamp( entity.m_health, 0, (int)MAX_HEALTH );
+	out_state.m_aiState = (uint8_t)Clamp( (int)entity.m_state, 0, ( 1 << AI_STATE_BITS ) - 1 );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void DequantizeEntity( EntityNetState const& state, Entity& entity )
+{
+	entity.m_position = Vec2( (float)state.m_positionX, (float)state.m_positionY ) / SNAPSHOT_POSITION_UNITS_PER_METER;
+	entity.m_yawDegrees = (float)state.m_yaw * ( 360.f / (float)YAW_STEPS );
+	entity.m_health = (int)state.m_health;
+	entity.m_state = (AIState)state.m_aiState;
+	entity.m_isDead = entity.m_state == AIState::DEAD;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static bool IsReplicated( Entity const* entity )
+{
+	return entity != nullptr && !entity->IsPlayer() && entity->m_netId != 0 && entity->m_netId < SNAPSHOT_FIRST_LOCAL_NET_ID;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+void CaptureSnapshot( Map const& map, uint32_t tick, EntitySnapshot& out_snapshot )
+{
+	out_snapshot.m_tick = tick;
+	out_snapshot.m_entities.clear();
+
+	for( Entity const* entity : map.m_allEntities ) {
+		if( !IsReplicated( entity ) || entity->IsReadyToBeDeleted() ) {
+			continue;
+		}
+		out_snapshot.m_entities.emplace_back();
+		QuantizeEntity( *entity, out_snapshot.m_entities.back() );
+	}
+
+	std::sort( out_snapshot.m_entities.begin(), out_snapshot.m_entities.end(),
+		[]( EntityNetState const& a, EntityNetState const& b ) { return a.m_netId < b.m_netId; } );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void ApplySnapshot( EntitySnapshot const& snapshot, Map& map )
+{
+	static std::vector<uint16_t> s_existingNetIds;
+	s_existingNetIds.clear();
+
+	for( Entity* entity : map.m_allEntities ) {
+		if( !IsReplicated( entity ) ) {
+			continue;
+		}
+
+		EntityNetState const* state = FindEntityState( snapshot.m_entities, entity->m_netId );
+		if( state == nullptr ) {
+			entity->m_isReadyToBeDeleted = true;	// gone on the host; the map deletes it in its next Update
+			continue;
+		}
+		DequantizeEntity( *state, *entity );
+		s_existingNetIds.push_back( entity->m_netId );
+	}
+
+	std::sort( s_existingNetIds.begin(), s_existingNetIds.end() );
+	std::vector<EntityDef const*> const& entityDefs = GetEntityDefsByTypeIndex();
+	for( EntityNetState const& state : snapshot.m_entities ) {
+		if( std::binary_search( s_existingNetIds.begin(), s_existingNetIds.end(), state.m_netId ) ) {
+			continue;
+		}
+		if( state.m_typeIndex >= entityDefs.size() || entityDefs[state.m_typeIndex] == nullptr ) {
+			continue;
+		}
+
+		Entity* entity = map.SpawnNewEntityOfType( *entityDefs[state.m_typeIndex] );
+		if( entity ) {
+			map.ReleaseNetId( entity->m_netId );	// the local id the spawn handed out
+			entity->m_netId = state.m_netId;
+			DequantizeEntity( state, *entity );
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+static void WriteNetId( BitWriter& writer, uint16_t netId, uint16_t& inout_previousNetId )
+{
+	bool isNextNetId = netId == (uint16_t)( inout_previousNetId + 1 );
+	writer.WriteBool( isNextNetId );
+	if( !isNextNetId ) {
+		writer.WriteBits( netId, NET_ID_BITS );
+	}
+	inout_previousNetId = netId;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void WritePositionDelta( BitWriter& writer, int32_t position, int32_t baselinePosition )
+{
+	int32_t delta = position - baselinePosition;
+	bool isSmall = delta >= -MAX_POSITION_DELTA && delta <= MAX_POSITION_DELTA;
+	writer.WriteBool( isSmall );
+	if( isSmall ) {
+		writer.WriteSigned( delta, POSITION_DELTA_BITS );
+	}
+	else {
+		writer.WriteSigned( position, POSITION_BITS );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// current == nullptr writes a removal of baseline; baseline == nullptr writes current in full
+static void WriteEntityRecord( BitWriter& writer, EntityNetState const* current, EntityNetState const* baseline, uint16_t& inout_previousNetId )
+{
+	if( current == nullptr ) {
+		WriteNetId( writer, baseline->m_netId, inout_previousNetId );
+		writer.WriteBits( RECORD_REMOVED, RECORD_KIND_BITS );
+		return;
+	}
+
+	WriteNetId( writer, current->m_netId, inout_previousNetId );
+	if( baseline == nullptr || baseline->m_typeIndex != current->m_typeIndex ) {
+		writer.WriteBits( RECORD_FULL, RECORD_KIND_BITS );
+		writer.WriteBits( current->m_typeIndex, TYPE_INDEX_BITS );
+		writer.WriteSigned( current->m_positionX, POSITION_BITS );
+		writer.WriteSigned( current->m_positionY, POSITION_BITS );
+		writer.WriteBits( current->m_yaw, YAW_BITS );
+		writer.WriteBits( current->m_health, HEALTH_BITS );
+		writer.WriteBits( current->m_aiState, AI_STATE_BITS );
+		return;
+	}
+
+	writer.WriteBits( RECORD_DELTA, RECORD_KIND_BITS );
+	bool hasPositionChanged = current->m_positionX != baseline->m_positionX || current->m_positionY != baseline->m_positionY;
+	writer.WriteBool( hasPositionChanged );
+	if( hasPositionChanged ) {
+		WritePositionDelta( writer, current->m_positionX, baseline->m_positionX );
+		WritePositionDelta( writer, current->m_positionY, baseline->m_positionY );
+	}
+
+	writer.WriteBool( current->m_yaw != baseline->m_yaw );
+	if( current->m_yaw != baseline->m_yaw ) {
+		writer.WriteBits( current->m_yaw, YAW_BITS );
+	}
+	writer.WriteBool( current->m_health != baseline->m_health );
+	if( current->m_health != baseline->m_health ) {
+		writer.WriteBits( current->m_health, HEALTH_BITS );
+	}
+	writer.WriteBool( current->m_aiState != baseline->m_aiState );
+	if( current->m_aiState != baseline->m_aiState ) {
+		writer.WriteBits( current->m_aiState, AI_STATE_BITS );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void PatchUint16( uint8_t* data, int byteOffset, uint16_t value )
+{
+	// BitWriter is LSB first, so byte-aligned fields are little endian
+	data[byteOffset] = (uint8_t)( value & 0xFF );
+	data[byteOffset + 1] = (uint8_t)( value >> 8 );
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+void SnapshotSender::WriteSnapshot( EntitySnapshot const& snapshot, std::vector<SnapshotDatagram>& out_datagrams )
+{
+	EntitySnapshot const* baseline = FindSentSnapshot( m_ackedTick );
+	uint32_t baselineTick = baseline ? baseline->m_tick : 0;
+	static std::vector<EntityNetState> const s_noEntities;
+	std::vector<EntityNetState> const& baselineEntities = baseline ? baseline->m_entities : s_noEntities;
+
+	int numDatagrams = 0;
+	int numRecords = 0;
+	uint16_t previousNetId = 0;
+	BitWriter writer( nullptr, 0 );
+
+	auto beginDatagram = [&]() {
+		if( numDatagrams == (int)out_datagrams.size() ) {
+			out_datagrams.emplace_back();
+		}
+		writer = BitWriter( out_datagrams[numDatagrams].m_data, SNAPSHOT_MAX_DATAGRAM_BYTES );
+		writer.WriteBits( snapshot.m_tick, 32 );
+		writer.WriteBits( baselineTick, 32 );
+		writer.WriteBits( (uint32_t)numDatagrams, 16 );
+		writer.WriteBits( 0, 16 );		// numDatagrams, patched at the end
+		writer.WriteBits( 0, 16 );		// numRecords, patched in endDatagram
+		++numDatagrams;
+		numRecords = 0;
+		previousNetId = 0;
+	};
+	auto endDatagram = [&]() {
+		SnapshotDatagram& datagram = out_datagrams[numDatagrams - 1];
+		datagram.m_numBytes = (int)writer.GetNumBytesWritten();
+		PatchUint16( datagram.m_data, NUM_RECORDS_BYTE_OFFSET, (uint16_t)numRecords );
+	};
+	auto writeRecord = [&]( EntityNetState const* current, EntityNetState const* baselineState ) {
+		size_t recordStart = writer.GetBitPosition();
+		WriteEntityRecord( writer, current, baselineState, previousNetId );
+		if( writer.HasOverflowed() ) {
+			// doesn't fit; close this datagram and start the record over in a fresh one
+			writer.Rewind( recordStart );
+			endDatagram();
+			beginDatagram();
+			WriteEntityRecord( writer, current, baselineState, previousNetId );
+		}
+		++numRecords;
+	};
+
+	beginDatagram();
+
+	// Merge walk over both sorted lists: new and changed entities from snapshot, removals from baseline
+	size_t currentIdx = 0;
+	size_t baselineIdx = 0;
+	while( currentIdx < snapshot.m_entities.size() || baselineIdx < baselineEntities.size() ) {
+		EntityNetState const* current = currentIdx < snapshot.m_entities.size() ? &snapshot.m_entities[currentIdx] : nullptr;
+		EntityNetState const* baselineState = baselineIdx < baselineEntities.size() ? &baselineEntities[baselineIdx] : nullptr;
+
+		if( baselineState == nullptr || ( current != nullptr && current->m_netId < baselineState->m_netId ) ) {
+			writeRecord( current, nullptr );
+			++currentIdx;
+		}
+		else if( current == nullptr || baselineState->m_netId < current->m_netId ) {
+			writeRecord( nullptr, baselineState );
+			++baselineIdx;
+		}
+		else {
+			if( *current != *baselineState ) {
+				writeRecord( current, baselineState );
+			}
+			++currentIdx;
+			++baselineIdx;
+		}
+	}
+
+	endDatagram();
+	out_datagrams.resize( numDatagrams );
+	for( SnapshotDatagram& datagram : out_datagrams ) {
+		PatchUint16( datagram.m_data, NUM_DATAGRAMS_BYTE_OFFSET, (uint16_t)numDatagrams );
+	}
+
+	// keep it as a baseline; assignment reuses the slot's capacity
+	EntitySnapshot& sent = m_history[snapshot.m_tick % SNAPSHOT_HISTORY_SIZE];
+	sent.m_tick = snapshot.m_tick;
+	sent.m_entities = snapshot.m_entities;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SnapshotSender::ReceiveAck( uint32_t ackedTick )
+{
+	if( ackedTick > m_ackedTick && FindSentSnapshot( ackedTick ) != nullptr ) {
+		m_ackedTick = ackedTick;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+EntitySnapshot const* SnapshotSender::FindSentSnapshot( uint32_t tick ) const
+{
+	if( tick == 0 ) {
+		return nullptr;
+	}
+	EntitySnapshot const& sent = m_history[tick % SNAPSHOT_HISTORY_SIZE];
+	return sent.m_tick == tick ? &sent : nullptr;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+static int32_t ReadPosition( BitReader& reader, int32_t baselinePosition )
+{
+	bool isSmall = reader.ReadBool();
+	if( isSmall ) {
+		return baselinePosition + reader.ReadSigned( POSITION_DELTA_BITS );
+	}
+	return reader.ReadSigned( POSITION_BITS );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool SnapshotReceiver::ReceiveDatagram( uint8_t const* data, int numBytes )
+{
+	if( numBytes < HEADER_BYTES ) {
+		++m_numDroppedDatagrams;
+		return false;
+	}
+
+	BitReader reader( data, (size_t)numBytes );
+	uint32_t tick = reader.ReadBits( 32 );
+	uint32_t baselineTick = reader.ReadBits( 32 );
+	int datagramIdx = (int)reader.ReadBits( 16 );
+	int numDatagrams = (int)reader.ReadBits( 16 );
+	int numRecords = (int)reader.ReadBits( 16 );
+
+	if( reader.HasOverflowed() || tick == 0 || numDatagrams == 0 || datagramIdx >= numDatagrams || tick <= m_latestTick ) {
+		++m_numDroppedDatagrams;	// corrupt or older than what we already have
+		return false;
+	}
+
+	EntitySnapshot const* baseline = nullptr;
+	if( baselineTick != 0 ) {
+		baseline = FindCompletedSnapshot( baselineTick );
+		if( baseline == nullptr ) {
+			++m_numDroppedDatagrams;	// baseline fell out of our history
+			return false;
+		}
+	}
+
+	PendingSnapshot& pending = m_pending[tick % ( sizeof( m_pending ) / sizeof( m_pending[0] ) )];
+	if( pending.m_tick != tick ) {
+		pending.m_tick = tick;
+		pending.m_baselineTick = baselineTick;
+		pending.m_numDatagrams = numDatagrams;
+		pending.m_numReceived = 0;
+		pending.m_isDatagramReceived.assign( numDatagrams, false );
+		pending.m_changes.clear();
+	}
+	else if( pending.m_baselineTick != baselineTick || pending.m_numDatagrams != numDatagrams || pending.m_isDatagramReceived[datagramIdx] ) {
+		++m_numDroppedDatagrams;	// duplicate or inconsistent
+		return false;
+	}
+
+	size_t numChangesBefore = pending.m_changes.size();
+	uint16_t previousNetId = 0;
+	for( int recordIdx = 0; recordIdx < numRecords; ++recordIdx ) {
+		EntityChange change;
+		bool isNextNetId = reader.ReadBool();
+		change.m_state.m_netId = isNextNetId ? (uint16_t)( previousNetId + 1 ) : (uint16_t)reader.ReadBits( NET_ID_BITS );
+		previousNetId = change.m_state.m_netId;
+
+		uint32_t recordKind = reader.ReadBits( RECORD_KIND_BITS );
+		if( recordKind == RECORD_REMOVED ) {
+			change.m_isRemoved = true;
+		}
+		else if( recordKind == RECORD_FULL ) {
+			change.m_state.m_typeIndex = (uint8_t)reader.ReadBits( TYPE_INDEX_BITS );
+			change.m_state.m_positionX = reader.ReadSigned( POSITION_BITS );
+			change.m_state.m_positionY = reader.ReadSigned( POSITION_BITS );
+			change.m_state.m_yaw = (uint16_t)reader.ReadBits( YAW_BITS );
+			change.m_state.m_health = (uint16_t)reader.ReadBits( HEALTH_BITS );
+			change.m_state.m_aiState = (uint8_t)reader.ReadBits( AI_STATE_BITS );
+		}
+		else {
+			EntityNetState const* baselineState = baseline ? FindEntityState( baseline->m_entities, change.m_state.m_netId ) : nullptr;
+			if( baselineState == nullptr || recordKind != RECORD_DELTA ) {
+				pending.m_changes.resize( numChangesBefore );
+				++m_numDroppedDatagrams;
+				return false;
+			}
+
+			change.m_state = *baselineState;
+			if( reader.ReadBool() ) {
+				change.m_state.m_positionX = ReadPosition( reader, baselineState->m_positionX );
+				change.m_state.m_positionY = ReadPosition( reader, baselineState->m_positionY );
+			}
+			if( reader.ReadBool() ) {
+				change.m_state.m_yaw = (uint16_t)reader.ReadBits( YAW_BITS );
+			}
+			if( reader.ReadBool() ) {
+				change.m_state.m_health = (uint16_t)reader.ReadBits( HEALTH_BITS );
+			}
+			if( reader.ReadBool() ) {
+				change.m_state.m_aiState = (uint8_t)reader.ReadBits( AI_STATE_BITS );
+			}
+		}
+		pending.m_changes.push_back( change );
+	}
+
+	if( reader.HasOverflowed() ) {
+		pending.m_changes.resize( numChangesBefore );
+		++m_numDroppedDatagrams;
+		return false;
+	}
+
+	pending.m_isDatagramReceived[datagramIdx] = true;
+	++pending.m_numReceived;
+	if( pending.m_numReceived < pending.m_numDatagrams ) {
+		return false;
+	}
+
+	CompleteSnapshot( pending, baseline );
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SnapshotReceiver::CompleteSnapshot( PendingSnapshot& pending, EntitySnapshot const* baseline )
+{
+	// datagrams can arrive in any order
+	std::sort( pending.m_changes.begin(), pending.m_changes.end(),
+		[]( EntityChange const& a, EntityChange const& b ) { return a.m_state.m_netId < b.m_state.m_netId; } );
+
+	EntitySnapshot& completed = m_history[pending.m_tick % SNAPSHOT_HISTORY_SIZE];
+	completed.m_tick = pending.m_tick;
+	completed.m_entities.clear();
+
+	// Baseline entities without a record are unchanged
+	size_t baselineIdx = 0;
+	size_t numBaselineEntities = baseline ? baseline->m_entities.size() : 0;
+	for( EntityChange const& change : pending.m_changes ) {
+		while( baselineIdx < numBaselineEntities && baseline->m_entities[baselineIdx].m_netId < change.m_state.m_netId ) {
+			completed.m_entities.push_back( baseline->m_entities[baselineIdx] );
+			++baselineIdx;
+		}
+		if( baselineIdx < numBaselineEntities && baseline->m_entities[baselineIdx].m_netId == change.m_state.m_netId ) {
+			++baselineIdx;
+		}
+		if( !change.m_isRemoved ) {
+			completed.m_entities.push_back( change.m_state );
+		}
+	}
+	while( baselineIdx < numBaselineEntities ) {
+		completed.m_entities.push_back( baseline->m_entities[baselineIdx] );
+		++baselineIdx;
+	}
+
+	m_latestTick = pending.m_tick;
+	pending.m_tick = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+EntitySnapshot const& SnapshotReceiver::GetLatestSnapshot() const
+{
+	static EntitySnapshot const s_emptySnapshot;
+	EntitySnapshot const* latest = FindCompletedSnapshot( m_latestTick );
+	return latest ? *latest : s_emptySnapshot;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+EntitySnapshot const* SnapshotReceiver::FindCompletedSnapshot( uint32_t tick ) const
+{
+	if( tick == 0 ) {
+		return nullptr;
+	}
+	EntitySnapshot const& completed = m_history[tick % SNAPSHOT_HISTORY_SIZE];
+	return completed.m_tick == tick ? &completed : nullptr;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+SnapshotSession::SnapshotSession( bool isHost )
+	:m_isHost( isHost )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SnapshotSession::Update( Map& map, float deltaSeconds )
+{
+	if( g_theNetwork == nullptr || g_theNetwork->GetUDPSocket() == nullptr ) {
+		return;
+	}
+
+	if( m_isHost ) {
+		UpdateHost( map, deltaSeconds );
+	}
+	else {
+		UpdateClient( map );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SnapshotSession::UpdateHost( Map& map, float deltaSeconds )
+{
+	for( UDPSocket::Message const& message : g_theNetwork->GetReceivedUDPMessages() ) {
+		if( message.m_id == (uint16_t)eMessageType::SNAPSHOT_ACK ) {
+			BitReader reader( reinterpret_cast<uint8_t const*>( message.m_data ), (size_t)message.m_size );
+			uint32_t ackedTick = reader.ReadBits( 32 );
+			if( !reader.HasOverflowed() ) {
+				m_sender.ReceiveAck( ackedTick );
+			}
+		}
+	}
+
+	m_secondsSinceLastSend += deltaSeconds;
+	if( m_secondsSinceLastSend < m_sendIntervalSeconds ) {
+		return;
+	}
+	m_secondsSinceLastSend = fmodf( m_secondsSinceLastSend, m_sendIntervalSeconds );
+
+	CaptureSnapshot( map, m_nextTick++, m_captureSnapshot );
+	m_sender.WriteSnapshot( m_captureSnapshot, m_datagrams );
+
+	UDPSocket* socket = g_theNetwork->GetUDPSocket();
+	for( SnapshotDatagram const& datagram : m_datagrams ) {
+		if( !socket->PushMsgIntoQueue( eMessageType::SNAPSHOT, reinterpret_cast<char const*>( datagram.m_data ), datagram.m_numBytes ) ) {
+			break;	// send queue full; the client just won't complete (or ack) this snapshot
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void SnapshotSession::UpdateClient( Map& map )
+{
+	// Entities we spawn ourselves must never collide with host ids
+	if( map.m_firstNetId != SNAPSHOT_FIRST_LOCAL_NET_ID ) {
+		map.SetNetIdRange( SNAPSHOT_FIRST_LOCAL_NET_ID, 0x10000 );
+	}
+
+	bool hasNewSnapshot = false;
+	for( UDPSocket::Message const& message : g_theNetwork->GetReceivedUDPMessages() ) {
+		if( message.m_id == (uint16_t)eMessageType::SNAPSHOT ) {
+			hasNewSnapshot |= m_receiver.ReceiveDatagram( reinterpret_cast<uint8_t const*>( message.m_data ), message.m_size );
+		}
+	}
+
+	if( hasNewSnapshot ) {
+		ApplySnapshot( m_receiver.GetLatestSnapshot(), map );
+
+		uint8_t ack[4];
+		BitWriter writer( ack, sizeof( ack ) );
+		writer.WriteBits( m_receiver.GetLatestTick(), 32 );
+		g_theNetwork->GetUDPSocket()->PushMsgIntoQueue( eMessageType::SNAPSHOT_ACK, reinterpret_cast<char const*>( ack ), (int)sizeof( ack ) );
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+static void StartSnapshotSession( bool isHost )
+{
+	if( g_theNetwork->GetUDPSocket() == nullptr ) {
+		g_theConsole->Error( "Open a UDP port first: OpenUDPPort bindPort=<port> sendToPort=<port>" );
+		return;
+	}
+
+	delete g_theGame->m_snapshotSession;
+	g_theGame->m_snapshotSession = new SnapshotSession( isHost );
+	g_theConsole->PrintString( Rgba8::CYAN, isHost ? "Hosting co-op session" : "Joined co-op session" );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( coop_host, " " )
+{
+	UNUSED( args );
+	StartSnapshotSession( true );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( coop_join, " " )
+{
+	UNUSED( args );
+	StartSnapshotSession( false );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( coop_leave, " " )
+{
+	UNUSED( args );
+	delete g_theGame->m_snapshotSession;
+	g_theGame->m_snapshotSession = nullptr;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+// Benchmark: a synthetic population in a 64x64m area where most entities walk every tick and a few take
+// damage, change AI state, die or spawn. Datagrams go through a real loopback socket pair; acks come back
+// the same way, so the sender deltas against genuinely acknowledged baselines.
+//-------------------------------------------------------------------------------------------------------------
+constexpr float	BENCHMARK_MOVING_PERCENT	= 0.6f;
+constexpr float	BENCHMARK_DAMAGE_PERCENT	= 0.01f;
+constexpr float	BENCHMARK_AI_STATE_PERCENT	= 0.02f;
+constexpr float	BENCHMARK_CHURN_PERCENT		= 0.005f;
+constexpr int	IP_UDP_HEADER_BYTES			= 28;
+
+//-------------------------------------------------------------------------------------------------------------
+static void SpawnBenchmarkEntity( EntitySnapshot& snapshot, uint16_t netId, RandomNumberGenerator& rng )
+{
+	EntityNetState state;
+	state.m_netId = netId;
+	state.m_typeIndex = (uint8_t)rng.RollRandomIntLessThan( 4 );
+	state.m_positionX = rng.RollRandomIntLessThan( 64 * (int)SNAPSHOT_POSITION_UNITS_PER_METER );
+	state.m_positionY = rng.RollRandomIntLessThan( 64 * (int)SNAPSHOT_POSITION_UNITS_PER_METER );
+	state.m_yaw = (uint16_t)rng.RollRandomIntLessThan( (int)YAW_STEPS );
+	state.m_health = 100;
+	state.m_aiState = (uint8_t)rng.RollRandomIntLessThan( 5 );
+	snapshot.m_entities.push_back( state );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void SimulateBenchmarkTick( EntitySnapshot& snapshot, uint16_t& inout_nextNetId, RandomNumberGenerator& rng )
+{
+	for( EntityNetState& state : snapshot.m_entities ) {
+		if( rng.RollPercentChance( BENCHMARK_MOVING_PERCENT ) ) {
+			state.m_positionX += rng.RollRandomIntInRange( -6, 6 );		// ~1.5m/s at 30 snapshots/s
+			state.m_positionY += rng.RollRandomIntInRange( -6, 6 );
+			state.m_yaw = (uint16_t)( ( state.m_yaw + rng.RollRandomIntInRange( -8, 8 ) ) & ( YAW_STEPS - 1 ) );
+		}
+		if( rng.RollPercentChance( BENCHMARK_DAMAGE_PERCENT ) ) {
+			state.m_health = (uint16_t)( state.m_health > 10 ? state.m_health - 10 : 0 );
+		}
+		if( rng.RollPercentChance( BENCHMARK_AI_STATE_PERCENT ) ) {
+			state.m_aiState = (uint8_t)rng.RollRandomIntLessThan( 5 );
+		}
+	}
+
+	// churn keeps the list sorted: removals erase, new ids are always the largest
+	int numEntities = (int)snapshot.m_entities.size();
+	for( int churnIdx = 0; churnIdx < numEntities; ++churnIdx ) {
+		if( rng.RollPercentChance( BENCHMARK_CHURN_PERCENT ) ) {
+			snapshot.m_entities.erase( snapshot.m_entities.begin() + rng.RollRandomIntLessThan( (int)snapshot.m_entities.size() ) );
+			SpawnBenchmarkEntity( snapshot, inout_nextNetId++, rng );
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static bool ReceiveBenchmarkDatagram( UDPSocket& socket, eMessageType expectedId, uint8_t const*& out_payload, int& out_numBytes )
+{
+	if( !socket.IsDataAvailable() ) {
+		return false;
+	}
+	int length = socket.Receive();
+	if( length < (int)sizeof( MessageHeader ) ) {
+		return false;
+	}
+
+	MessageHeader const* header = reinterpret_cast<MessageHeader const*>( &socket.GetReceiveBuffer()[0] );
+	out_payload = reinterpret_cast<uint8_t const*>( &socket.GetReceiveBuffer()[sizeof( MessageHeader )] );
+	out_numBytes = length - (int)sizeof( MessageHeader );
+	return header->m_id == (uint16_t)expectedId;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void RunSnapshotBenchmark( int numEntities, int numTicks, int port )
+{
+	UDPSocket hostSocket( "127.0.0.1", port + 1 );
+	hostSocket.Bind( port );
+	UDPSocket clientSocket( "127.0.0.1", port );
+	clientSocket.Bind( port + 1 );
+	if( !hostSocket.IsValid() || !clientSocket.IsValid() ) {
+		g_theConsole->Error( "benchmark_snapshots: failed to open loopback sockets on ports %i/%i", port, port + 1 );
+		return;
+	}
+
+	RandomNumberGenerator rng;
+	rng.Reset( 1 );
+	EntitySnapshot snapshot;
+	uint16_t nextNetId = 1;
+	for( int entityIdx = 0; entityIdx < numEntities; ++entityIdx ) {
+		SpawnBenchmarkEntity( snapshot, nextNetId++, rng );
+	}
+
+	SnapshotSender sender;
+	SnapshotReceiver receiver;
+	std::vector<SnapshotDatagram> datagrams;
+
+	double encodeSeconds = 0.0;
+	double decodeSeconds = 0.0;
+	size_t payloadBytes = 0;
+	size_t wireBytes = 0;
+	size_t numDatagramsSent = 0;
+	size_t fullStateBytes = 0;
+	int numIncomplete = 0;
+	int numMismatched = 0;
+
+	for( uint32_t tick = 1; tick <= (uint32_t)numTicks; ++tick ) {
+		if( tick > 1 ) {
+			SimulateBenchmarkTick( snapshot, nextNetId, rng );
+		}
+		snapshot.m_tick = tick;
+
+		double encodeStart = GetCurrentTimeSeconds();
+		sender.WriteSnapshot( snapshot, datagrams );
+		encodeSeconds += GetCurrentTimeSeconds() - encodeStart;
+
+		size_t tickPayloadBytes = 0;
+		for( SnapshotDatagram const& datagram : datagrams ) {
+			hostSocket.SendMsg( eMessageType::SNAPSHOT, reinterpret_cast<char const*>( datagram.m_data ), datagram.m_numBytes );
+			tickPayloadBytes += datagram.m_numBytes;
+			wireBytes += datagram.m_numBytes + sizeof( MessageHeader ) + IP_UDP_HEADER_BYTES;
+		}
+		payloadBytes += tickPayloadBytes;
+		numDatagramsSent += datagrams.size();
+		if( tick == 1 ) {
+			fullStateBytes = tickPayloadBytes;
+		}
+
+		bool isComplete = false;
+		for( size_t datagramIdx = 0; datagramIdx < datagrams.size(); ++datagramIdx ) {
+			uint8_t const* payload = nullptr;
+			int numBytes = 0;
+			if( !ReceiveBenchmarkDatagram( clientSocket, eMessageType::SNAPSHOT, payload, numBytes ) ) {
+				break;
+			}
+			double decodeStart = GetCurrentTimeSeconds();
+			isComplete |= receiver.ReceiveDatagram( payload, numBytes );
+			decodeSeconds += GetCurrentTimeSeconds() - decodeStart;
+		}
+
+		if( !isComplete ) {
+			++numIncomplete;
+			continue;
+		}
+		if( receiver.GetLatestSnapshot().m_entities != snapshot.m_entities ) {
+			++numMismatched;
+		}
+
+		uint8_t ack[4];
+		BitWriter ackWriter( ack, sizeof( ack ) );
+		ackWriter.WriteBits( receiver.GetLatestTick(), 32 );
+		clientSocket.SendMsg( eMessageType::SNAPSHOT_ACK, reinterpret_cast<char const*>( ack ), (int)sizeof( ack ) );
+
+		uint8_t const* ackPayload = nullptr;
+		int ackNumBytes = 0;
+		if( ReceiveBenchmarkDatagram( hostSocket, eMessageType::SNAPSHOT_ACK, ackPayload, ackNumBytes ) ) {
+			BitReader ackReader( ackPayload, (size_t)ackNumBytes );
+			sender.ReceiveAck( ackReader.ReadBits( 32 ) );
+		}
+	}
+
+	double ticks = (double)numTicks;
+	g_theConsole->PrintString( numMismatched == 0 ? Rgba8::WHITE : Rgba8::RED,
+		Stringf( "%5i entities: %8.1f bytes/tick (%8.1f on the wire, %.2f datagrams), full state %u bytes, encode %7.1f us, decode %7.1f us, %i incomplete, %i mismatched",
+			numEntities, (double)payloadBytes / ticks, (double)wireBytes / ticks, (double)numDatagramsSent / ticks, (unsigned int)fullStateBytes,
+			encodeSeconds / ticks * 1000000.0, decodeSeconds / ticks * 1000000.0, numIncomplete, numMismatched ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_snapshots, "entities,ticks,port" )
+{
+	int numEntities = args.GetValue( "entities", 0 );
+	int numTicks = args.GetValue( "ticks", 300 );
+	int port = args.GetValue( "port", 48100 );
+	if( numTicks <= 0 ) {
+		g_theConsole->Error( "benchmark_snapshots: ticks must be positive" );
+		return;
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Snapshot replication over loopback, %i ticks", numTicks ) );
+	if( numEntities > 0 ) {
+		RunSnapshotBenchmark( numEntities, numTicks, port );
+		return;
+	}
+
+	RunSnapshotBenchmark( 50, numTicks, port );
+	RunSnapshotBenchmark( 500, numTicks, port );
+	RunSnapshotBenchmark( 5000, numTicks, port );
+}
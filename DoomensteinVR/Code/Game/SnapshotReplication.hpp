@@ -0,0 +1,150 @@
+#pragma once
+#include "Engine/Network/UDPSocket.hpp"
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+class Map;
+
+//-------------------------------------------------------------------------------------------------------------
+// Entity snapshot replication for co-op sessions.
+//
+// The host captures every non-player entity of the current Map into an EntitySnapshot of quantized
+// state (position, yaw, health, AI state), delta-encodes it against the newest snapshot the client has
+// acknowledged and bit-packs the changes into datagrams of at most SNAPSHOT_MAX_DATAGRAM_BYTES. Unchanged
+// entities cost nothing; each datagram decodes on its own, and a snapshot is acked (and becomes a
+// baseline) only once all of its datagrams have arrived, so loss just means deltas against an older
+// baseline.
+//
+//	coop_host / coop_join		start a session over the socket opened with OpenUDPPort
+//	benchmark_snapshots			bytes/tick and encode/decode cost for 50/500/5000 entities over loopback
+//-------------------------------------------------------------------------------------------------------------
+constexpr int		SNAPSHOT_MAX_DATAGRAM_BYTES		= UDPSocket::MaxPayloadSize;
+constexpr int		SNAPSHOT_HISTORY_SIZE			= 32;		// baselines older than this many snapshots fall back to full state
+constexpr float		SNAPSHOT_POSITION_UNITS_PER_METER	= 128.f;
+constexpr uint16_t	SNAPSHOT_FIRST_LOCAL_NET_ID		= 0x8000;	// clients number their own entities from here
+
+
+//-------------------------------------------------------------------------------------------------------------
+// Replicated state of one entity, already quantized so sender and receiver compare bit-exact values
+struct EntityNetState
+{
+	uint16_t	m_netId = 0;
+	uint8_t		m_typeIndex = 0;	// index into EntityDef::s_entityTypes; every peer loads the same definitions
+	int32_t		m_positionX = 0;	// 1/SNAPSHOT_POSITION_UNITS_PER_METER
+	int32_t		m_positionY = 0;
+	uint16_t	m_yaw = 0;
+	uint16_t	m_health = 0;
+	uint8_t		m_aiState = 0;
+
+	bool operator==( EntityNetState const& other ) const;
+	bool operator!=( EntityNetState const& other ) const	{ return !( *this == other ); }
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct EntitySnapshot
+{
+	uint32_t					m_tick = 0;			// 0 is never a valid tick
+	std::vector<EntityNetState>	m_entities;			// sorted by m_netId
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct SnapshotDatagram
+{
+	int			m_numBytes = 0;
+	uint8_t		m_data[SNAPSHOT_MAX_DATAGRAM_BYTES];
+};
+
+//-------------------------------------------------------------------------------------------------------------
+void	CaptureSnapshot( Map const& map, uint32_t tick, EntitySnapshot& out_snapshot );
+void	ApplySnapshot( EntitySnapshot const& snapshot, Map& map );
+
+
+//-------------------------------------------------------------------------------------------------------------
+// Host side: remembers what it sent so it can delta against whatever the client acknowledges
+//-------------------------------------------------------------------------------------------------------------
+class SnapshotSender
+{
+public:
+	// Packs snapshot into out_datagrams (resized, slots reused) and keeps it as a potential baseline
+	void			WriteSnapshot( EntitySnapshot const& snapshot, std::vector<SnapshotDatagram>& out_datagrams );
+	void			ReceiveAck( uint32_t ackedTick );
+
+	uint32_t		GetAckedTick() const	{ return m_ackedTick; }
+
+private:
+	EntitySnapshot const*	FindSentSnapshot( uint32_t tick ) const;
+
+private:
+	EntitySnapshot	m_history[SNAPSHOT_HISTORY_SIZE];
+	uint32_t		m_ackedTick = 0;
+};
+
+
+//-------------------------------------------------------------------------------------------------------------
+// Client side: reassembles datagrams into snapshots against the baselines it has acknowledged
+//-------------------------------------------------------------------------------------------------------------
+class SnapshotReceiver
+{
+public:
+	// Returns true when this datagram completed a snapshot newer than the last completed one
+	bool					ReceiveDatagram( uint8_t const* data, int numBytes );
+
+	EntitySnapshot const&	GetLatestSnapshot() const;
+	uint32_t				GetLatestTick() const		{ return m_latestTick; }	// what to ack
+	int						GetNumDroppedDatagrams() const	{ return m_numDroppedDatagrams; }
+
+private:
+	struct EntityChange
+	{
+		EntityNetState	m_state;
+		bool			m_isRemoved = false;
+	};
+
+	struct PendingSnapshot
+	{
+		uint32_t					m_tick = 0;
+		uint32_t					m_baselineTick = 0;
+		int							m_numDatagrams = 0;
+		int							m_numReceived = 0;
+		std::vector<bool>			m_isDatagramReceived;
+		std::vector<EntityChange>	m_changes;
+	};
+
+	EntitySnapshot const*	FindCompletedSnapshot( uint32_t tick ) const;
+	void					CompleteSnapshot( PendingSnapshot& pending, EntitySnapshot const* baseline );
+
+private:
+	EntitySnapshot		m_history[SNAPSHOT_HISTORY_SIZE];
+	PendingSnapshot		m_pending[4];
+	uint32_t			m_latestTick = 0;
+	int					m_numDroppedDatagrams = 0;
+};
+
+
+//-------------------------------------------------------------------------------------------------------------
+// Drives a sender or receiver from Game::Update using the NetworkSystem's UDP socket
+//-------------------------------------------------------------------------------------------------------------
+class SnapshotSession
+{
+public:
+	explicit SnapshotSession( bool isHost );
+
+	void		Update( Map& map, float deltaSeconds );
+	bool		IsHost() const		{ return m_isHost; }
+
+private:
+	void		UpdateHost( Map& map, float deltaSeconds );
+	void		UpdateClient( Map& map );
+
+private:
+	bool							m_isHost = false;
+	float							m_sendIntervalSeconds = 1.f / 30.f;
+	float							m_secondsSinceLastSend = 0.f;
+	uint32_t						m_nextTick = 1;
+
+	SnapshotSender					m_sender;
+	SnapshotReceiver				m_receiver;
+	EntitySnapshot					m_captureSnapshot;
+	std::vector<SnapshotDatagram>	m_datagrams;
+};
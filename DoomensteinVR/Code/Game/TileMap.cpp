@@ -6,9 +6,13 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/LineSegment.hpp"
 #include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/Time.hpp"
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 #include "Engine/Renderer/GPUMesh.hpp"
 #include "Engine/Renderer/MeshUtils.hpp"
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -21,7 +25,26 @@ TileMap::TileMap( char const* mapName, XmlElement const& mapDef )
 	PopulateTiles( mapDef );
 	PopulateEntities( mapDef );
 
-	m_worldMesh = new GPUMesh( g_theRenderer );
+	std::vector<uint8_t> isSolid;
+	GetTileSolidity( isSolid );
+	m_pathfinder.Build( isSolid, m_tileDimensions );
+
+	pvs_build_options_t pvsOptions;
+	pvsOptions.chunk_size = TILE_MAP_CHUNK_SIZE;
+	std::string pvsPath = GetPVSCachePath();
+	if( !m_pvs.ReadFromFile( pvsPath.c_str(), TilePVS::HashSolidity( isSolid, m_tileDimensions ) ) )
+	{
+		m_pvs.StartBuild( isSolid, m_tileDimensions, pvsOptions );
+		m_isPVSCookPending = true;
+	}
+
+	if( g_theRenderer )	// headless runs simulate without a renderer
+	{
+		m_worldMesh = new GPUMesh( g_theRenderer );
+		m_diffuseTexture = g_theRenderer->CreateOrGetTextureFromFile( "Data/Textures/Diffuse_4x4.png" );
+		m_normalTexture = g_theRenderer->CreateOrGetTextureFromFile( "Data/Textures/Normal_4x4.png" );
+		m_flatNormalTexture = g_theRenderer->CreateOrGetTextureFromFile( "Data/Textures/normal_flat.png" );
+	}
 }
 
 //-------------------------------------------------------------------------------------------------------------
@@ -34,36 +57,75 @@ TileMap::~TileMap()
 //-------------------------------------------------------------------------------------------------------------
 void TileMap::Update( float deltaSeconds )
 {
-	ResolveEntityCollision();
+	PROFILE_FUNCTION();
+	uint64_t startCount = GetPerformanceCounter();
+	{
+		PROFILE_SCOPE( "TileMap::ResolveEntityCollision" );
+		ResolveEntityCollision();
+	}
+	uint64_t collisionEndCount = GetPerformanceCounter();
+
+	// One flow field toward the player's tile serves every chaser, so pathing cost does not grow with their number
+	Entity* player = g_theGame->GetPlayer();
+	if( player )
+	{
+		PROFILE_SCOPE( "TileMap::UpdateChaseField" );
+		m_chaseField.Update( *this, GetTileCoordsForWorldPosition( player->m_position ) );
+	}
+	uint64_t chaseFieldEndCount = GetPerformanceCounter();
+
+	if( m_isPVSCookPending && m_pvs.IsBuilt() )
+	{
+		std::string pvsPath = GetPVSCachePath();
+		if( !m_pvs.WriteToFile( pvsPath.c_str() ) )
+		{
+			g_theConsole->Error( "Failed to cook PVS for map %s to \"%s\"", m_mapName.c_str(), pvsPath.c_str() );
+		}
+		m_isPVSCookPending = false;
+	}
+
+	// Far and unseen NPCs update at reduced rates, within a time budget
+	m_aiScheduler.BeginFrame( m_allEntities, player ? player->m_position : Vec2::ZERO, deltaSeconds );
 	
 	for( int i = 0; i < m_allEntities.size(); ++i )
 	{
 		Entity* entity = m_allEntities[i];
 		if( entity != nullptr )
 		{
-			if( !entity->IsReadyToBeDeleted() )
+			float entityDeltaSeconds = deltaSeconds;
+			if( !entity->IsReadyToBeDeleted() && m_aiScheduler.ShouldUpdate( entity, entityDeltaSeconds ) )
 			{
-				entity->Update( deltaSeconds );
+				uint64_t entityStartCount = GetPerformanceCounter();
+				entity->Update( entityDeltaSeconds );
 				PushEntityOutOfWalls( *entity );
+				m_aiScheduler.RecordUpdate( entity, (double)( GetPerformanceCounter() - entityStartCount ) * GetSecondsPerPerformanceCount() );
 			}
 	
 
 			if( entity->IsReadyToBeDeleted() && !entity->IsPlayer() )
 			{
+				// Erased from m_allEntities, so the next entity moves down into slot i
 				RemoveEntityFromMap( entity );
-
-				delete m_allEntities[i];
-				m_allEntities[i] = nullptr;
+				ReleaseNetId( entity->m_netId );
+				delete entity;
+				--i;
 			}
 		}
 	}
 
+	m_aiScheduler.EndFrame( m_allEntities );
+
+	double secondsPerCount = GetSecondsPerPerformanceCount();
+	m_lastUpdateTimings.m_entityCollisionSeconds = (double)( collisionEndCount - startCount ) * secondsPerCount;
+	m_lastUpdateTimings.m_chaseFieldSeconds = (double)( chaseFieldEndCount - collisionEndCount ) * secondsPerCount;
+	m_lastUpdateTimings.m_entityUpdateSeconds = (double)( GetPerformanceCounter() - chaseFieldEndCount ) * secondsPerCount;
+
 
 #ifndef RAYCAST_DISABLED
 	//--------------------------------------------------------------------------------------------------------------------
 	// Hack way to test Raycast
-	Entity* player = m_allEntities[0];
-	RaycastResult result = Raycast( player->m_position, player->GetForwardVector(), 2.f );
+	Entity* raycastEntity = m_allEntities[0];
+	RaycastResult result = Raycast( raycastEntity->m_position, raycastEntity->GetForwardVector(), 2.f );
 	Vec3 endPos;
 	Vec3 startPos = Vec3( result.m_startPosition.x, result.m_startPosition.y, 0.3f );
 	if( result.m_didImpact )
@@ -72,7 +134,7 @@ void TileMap::Update( float deltaSeconds )
 	}
 	else
 	{
-		Vec2 endPos2D = player->m_position + 2.f * player->GetForwardVector();
+		Vec2 endPos2D = raycastEntity->m_position + 2.f * raycastEntity->GetForwardVector();
 		endPos = Vec3( endPos2D.x, endPos2D.y, 0.3f );
 	}
 	Rgba8 lineColor = ( result.m_didImpact ) ? Rgba8::RED : Rgba8::BLUE;
@@ -82,9 +144,9 @@ void TileMap::Update( float deltaSeconds )
 
 	//--------------------------------------------------------------------------------------------------------------------
 	// Test Raycast entity
-	Vec2 startPoint2D = player->m_position + player->m_radius * 1.f * player->GetForwardVector();
+	Vec2 startPoint2D = raycastEntity->m_position + raycastEntity->m_radius * 1.f * raycastEntity->GetForwardVector();
 	Vec3 startPoint = Vec3( startPoint2D.x, startPoint2D.y, 0.3f ); 
-	RaycastResult raycastResult = RaycastAgainstEntitiesXY( startPoint2D, player->GetForwardVector(), 2.f );
+	RaycastResult raycastResult = RaycastAgainstEntities2D( startPoint2D, raycastEntity->GetForwardVector(), 2.f );
 	//g_theDebugRenderSystem->DebugAddWorldPoint( startPoint, 0.01f,Rgba8::MAGENTA );
 	if( raycastResult.m_didImpact )
 	{
@@ -95,12 +157,12 @@ void TileMap::Update( float deltaSeconds )
 	//--------------------------------------------------------------------------------------------------------------------
 	// Test Raycast Ceiling and Floor
 	Vec3 cameraForward = g_theGame->m_worldCameraLeft.GetForwardVector();
-	//cameraForward = Vec3( player->GetForwardVector(), 0.7f ).GetNormalized();
+	//cameraForward = Vec3( raycastEntity->GetForwardVector(), 0.7f ).GetNormalized();
 	Vec2 forwardVectorForCeilingAndFloor = Vec2( sqrtf( cameraForward.x * cameraForward.x + cameraForward.y * cameraForward.y ), cameraForward.z );
 	RaycastResult ZTestResult = RaycastAgainstCeilingAndFloor( Vec2( 0.f, 0.65f ), forwardVectorForCeilingAndFloor, 10.f );
 	if( ZTestResult.m_didImpact )
 	{
-		Vec3 impactPoint = Vec3( player->m_position, 0.65f ) + cameraForward * ZTestResult.m_impactFraction * ZTestResult.m_maxDistance;
+		Vec3 impactPoint = Vec3( raycastEntity->m_position, 0.65f ) + cameraForward * ZTestResult.m_impactFraction * ZTestResult.m_maxDistance;
 		g_theDebugRenderSystem->DebugAddWorldPoint( impactPoint, 0.1f, Rgba8::GREEN );
 	}
 #endif
@@ -114,10 +176,37 @@ void TileMap::UpdateMeshes()
 	//int estimatedNumVerts = 3 * estimatedNumTris;
 	//m_vertices.reserve( estimatedNumVerts );
 	m_vertices.clear();
+	m_chunks.clear();
+	m_chunkBounds.Clear();
 
-	for( int tileIndex = 0; tileIndex < m_numTiles; ++tileIndex )
+	for( int chunkMinY = 0; chunkMinY < m_tileDimensions.y; chunkMinY += TILE_MAP_CHUNK_SIZE )
 	{
-		AddVertsForTile( m_worldMesh, tileIndex );
+		for( int chunkMinX = 0; chunkMinX < m_tileDimensions.x; chunkMinX += TILE_MAP_CHUNK_SIZE )
+		{
+			int chunkMaxX = chunkMinX + TILE_MAP_CHUNK_SIZE < m_tileDimensions.x ? chunkMinX + TILE_MAP_CHUNK_SIZE : m_tileDimensions.x;
+			int chunkMaxY = chunkMinY + TILE_MAP_CHUNK_SIZE < m_tileDimensions.y ? chunkMinY + TILE_MAP_CHUNK_SIZE : m_tileDimensions.y;
+
+			TileMapChunk chunk;
+			chunk.m_chunkCoords = IntVec2( chunkMinX / TILE_MAP_CHUNK_SIZE, chunkMinY / TILE_MAP_CHUNK_SIZE );
+			chunk.m_firstVertex = (int)m_vertices.size();
+			for( int tileY = chunkMinY; tileY < chunkMaxY; ++tileY )
+			{
+				for( int tileX = chunkMinX; tileX < chunkMaxX; ++tileX )
+				{
+					AddVertsForTile( m_worldMesh, GetTileIndexForTileCoords( tileX, tileY ) );
+				}
+			}
+			chunk.m_numVertices = (int)m_vertices.size() - chunk.m_firstVertex;
+			if( chunk.m_numVertices == 0 )
+			{
+				continue;
+			}
+
+			AABB3 firstTileBounds = Get3DBoundsForTile( IntVec2( chunkMinX, chunkMinY ) );
+			AABB3 lastTileBounds = Get3DBoundsForTile( IntVec2( chunkMaxX - 1, chunkMaxY - 1 ) );
+			m_chunks.push_back( chunk );
+			m_chunkBounds.Add( AABB3( firstTileBounds.mins, lastTileBounds.maxs ) );
+		}
 	}
 
 	if( !m_vertices.empty() )
@@ -131,33 +220,155 @@ void TileMap::UpdateMeshes()
 }
 
 //-------------------------------------------------------------------------------------------------------------
-void TileMap::Render( Camera& camera ) const
+// Culls world chunks (boxes) and entities (spheres) against one frustum enclosing both eyes, then against what
+// the player's tile can see; Render() then draws only what survived, for either eye
+//-------------------------------------------------------------------------------------------------------------
+void TileMap::UpdateVisibility( Frustum const& frustum )
 {
-	g_theRenderer->SetModelMatrix( Mat44::IDENTITY );
+	PROFILE_FUNCTION();
+	Entity* player = g_theGame->GetPlayer();
+	IntVec2 playerTile( -1, -1 );
+	if( player )
+	{
+		playerTile = IntVec2( (int)floorf( player->m_position.x ), (int)floorf( player->m_position.y ) );
+	}
+
+	m_visibleChunks.clear();
+	frustum.CullAABBs( m_chunkBounds, m_visibleChunks );
+	m_visibleChunks.erase( std::remove_if( m_visibleChunks.begin(), m_visibleChunks.end(), [&]( int chunkIdx ) {
+		return !m_pvs.IsChunkVisible( playerTile, m_chunks[chunkIdx].m_chunkCoords );
+	} ), m_visibleChunks.end() );
+
+	m_entitySpheres.Clear();
+	m_entitySphereOwners.clear();
+	for( int entityIdx = 0; entityIdx < (int)m_allEntities.size(); ++entityIdx )
+	{
+		if( m_allEntities[entityIdx] )
+		{
+			Vec3 center;
+			float radius = 0.f;
+			m_allEntities[entityIdx]->GetCullingSphere( center, radius );
+			m_entitySpheres.Add( center, radius );
+			m_entitySphereOwners.push_back( entityIdx );
+		}
+	}
 
-	// Bind Diffuse and Normal Texture
-	Texture* terrainTex = g_theRenderer->CreateOrGetTextureFromFile( "Data/Textures/Diffuse_4x4.png" );
-	g_theRenderer->BindTexture( terrainTex );
+	m_visibleEntities.clear();
+	frustum.CullSpheres( m_entitySpheres, m_visibleEntities );
+	for( int& visibleIdx : m_visibleEntities )
+	{
+		visibleIdx = m_entitySphereOwners[visibleIdx];
+	}
 
-	Texture* normalTex = g_theRenderer->CreateOrGetTextureFromFile( "Data/Textures/Normal_4x4.png" );
-	g_theRenderer->BindNormalTexture( normalTex );
+	// An entity is kept if any tile its disc overlaps can be seen
+	m_visibleEntities.erase( std::remove_if( m_visibleEntities.begin(), m_visibleEntities.end(), [&]( int entityIdx ) {
+		Entity const* entity = m_allEntities[entityIdx];
+		if( player == nullptr || entity == player )
+		{
+			return false;
+		}
 
-	if( m_worldMesh ) 
+		int minX = (int)floorf( entity->m_position.x - entity->m_radius );
+		int maxX = (int)floorf( entity->m_position.x + entity->m_radius );
+		int minY = (int)floorf( entity->m_position.y - entity->m_radius );
+		int maxY = (int)floorf( entity->m_position.y + entity->m_radius );
+		for( int tileY = minY; tileY <= maxY; ++tileY )
+		{
+			for( int tileX = minX; tileX <= maxX; ++tileX )
+			{
+				if( m_pvs.CanTilesSee( playerTile, IntVec2( tileX, tileY ) ) )
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	} ), m_visibleEntities.end() );
+
+	// Read by the AIScheduler next Update; the flag lives on the entity so removals cannot shift it onto another
+	for( Entity* entity : m_allEntities )
 	{
+		if( entity )
+		{
+			entity->m_isSeenByPlayer = false;
+		}
+	}
+	for( int entityIdx : m_visibleEntities )
+	{
+		m_allEntities[entityIdx]->m_isSeenByPlayer = true;
+	}
+
+	m_hasVisibility = true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TileMap::Render( Camera& camera ) const
+{
+	PROFILE_FUNCTION();
+	g_theRenderer->SetModelMatrix( Mat44::IDENTITY );	// entities draw world-space vertices
+
+	if( m_worldMesh && !m_hasVisibility ) 
+	{
+		// Bind Diffuse and Normal Texture
+		g_theRenderer->BindTexture( m_diffuseTexture );
+		g_theRenderer->BindNormalTexture( m_normalTexture );
 		g_theRenderer->DrawMesh( m_worldMesh );
 	}
+	else if( m_worldMesh )
+	{
+		// Keeps the shader (and the rest of the material) the game bound for the world
+		m_worldCommands.Reset();
+		m_worldCommands.SetShader( g_theRenderer->m_currentShader );
+		m_worldCommands.SetTexture( m_diffuseTexture );
+		m_worldCommands.SetNormalTexture( m_normalTexture );
+
+		// Chunks next to each other in m_chunks are next to each other in the vertex buffer, so runs of them are one draw
+		int numVisibleChunks = (int)m_visibleChunks.size();
+		for( int visibleIdx = 0; visibleIdx < numVisibleChunks; ++visibleIdx )
+		{
+			TileMapChunk const& firstChunk = m_chunks[ m_visibleChunks[visibleIdx] ];
+			int numVertices = firstChunk.m_numVertices;
+			while( visibleIdx + 1 < numVisibleChunks && m_visibleChunks[visibleIdx + 1] == m_visibleChunks[visibleIdx] + 1 )
+			{
+				++visibleIdx;
+				numVertices += m_chunks[ m_visibleChunks[visibleIdx] ].m_numVertices;
+			}
+			m_worldCommands.DrawMesh( m_worldMesh, firstChunk.m_firstVertex, numVertices );
+		}
+		g_theRenderer->SubmitCommandBuffer( m_worldCommands );
+	}
+
+	g_theRenderer->BindNormalTexture( m_flatNormalTexture );
+	if( !m_hasVisibility )
+	{
+		for( int i = 0; i < (int) m_allEntities.size(); ++i )
+		{
+			if( m_allEntities[i] )
+			{
+				m_allEntities[i]->Render( camera );
+				m_allEntities[i]->DebugRender( camera );
+			}
+		}
+		return;
+	}
 
-	g_theRenderer->BindNormalTexture( g_theRenderer->CreateOrGetTextureFromFile("Data/Textures/normal_flat.png") );
-	for( int i = 0; i < (int) m_allEntities.size(); ++i )
+	for( int entityIdx : m_visibleEntities )
 	{
-		if( m_allEntities[i] )
+		if( entityIdx < (int)m_allEntities.size() && m_allEntities[entityIdx] )
 		{
-			m_allEntities[i]->Render( camera );
-			m_allEntities[i]->DebugRender( camera );
+			m_allEntities[entityIdx]->Render( camera );
+			m_allEntities[entityIdx]->DebugRender( camera );
 		}
 	}
 }
 
+//-------------------------------------------------------------------------------------------------------------
+void TileMap::RemoveEntityFromMap( Entity* e )
+{
+	Map::RemoveEntityFromMap( e );
+	m_aiScheduler.RemoveEntity( e );
+}
+
 //-------------------------------------------------------------------------------------------------------------
 void TileMap::PushEntityOutOfWalls( Entity& e )
 {
@@ -178,6 +389,32 @@ void TileMap::PushEntityOutOfWalls( Entity& e )
 	PushEntityOutOfTileIfSolid( e, pos + IntVec2( 1, -1 ) );
 }
 
+//-------------------------------------------------------------------------------------------------------------
+Vec2 TileMap::GetChaseDirection( Vec2 const& position ) const
+{
+	return m_chaseField.GetField().GetFlowDirection( position );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TileMap::FindPath( Vec2 const& start, Vec2 const& goal, std::vector<IntVec2>& out_tiles )
+{
+	return m_pathfinder.FindPath( GetTileCoordsForWorldPosition( start ), GetTileCoordsForWorldPosition( goal ), out_tiles ) < PATH_COST_UNREACHABLE;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+std::string TileMap::GetPVSCachePath() const
+{
+	return GetUserCacheFolder( "PVS" ) + m_mapName + ".pvs";
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TileMap::IsPotentiallyVisible( Vec2 const& from, Vec2 const& to ) const
+{
+	IntVec2 fromTile( (int)floorf( from.x ), (int)floorf( from.y ) );
+	IntVec2 toTile( (int)floorf( to.x ), (int)floorf( to.y ) );
+	return m_pvs.CanTilesSee( fromTile, toTile );
+}
+
 //-------------------------------------------------------------------------------------------------------------
 void TileMap::PushEntityOutOfTileIfSolid( Entity& e, IntVec2 const& tileCoords )
 {
@@ -582,6 +819,16 @@ bool TileMap::IsTileSolid( IntVec2 const& tileCoords ) const
 	return tile.IsSolid();
 }
 
+//-------------------------------------------------------------------------------------------------------------
+void TileMap::GetTileSolidity( std::vector<uint8_t>& out_isSolid ) const
+{
+	out_isSolid.resize( m_tiles.size() );
+	for( int tileIndex = 0; tileIndex < (int)m_tiles.size(); ++tileIndex )
+	{
+		out_isSolid[tileIndex] = m_tiles[tileIndex].IsSolid() ? 1 : 0;
+	}
+}
+
 //-------------------------------------------------------------------------------------------------------------
 int TileMap::GetTileIndexForTileCoords( int tileX, int tileY ) const
 {
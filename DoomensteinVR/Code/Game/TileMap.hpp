@@ -1,8 +1,14 @@
 #pragma once
 #include "Game/Map.hpp"
 #include "Game/MapRegionType.hpp"
+#include "Game/AIScheduler.hpp"
+#include "Game/FlowField.hpp"
+#include "Game/HierarchicalPathfinder.hpp"
+#include "Game/TilePVS.hpp"
 #include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Frustum.hpp"
 #include "Engine/Core/XmlUtils.hpp"
+#include "Engine/Renderer/RenderCommandBuffer.hpp"
 #include <vector>
 
 //-----------------------------------------------------------------------------------------------------------------------------------------------
@@ -10,6 +16,7 @@
 struct AABB3;
 class MapRegionType;
 class GPUMesh;
+class Texture;
 struct Vertex_PCUTBN;
 //struct Vertex_PCU;
 //-----------------------------------------------------------------------------------------------------------------------------------------------
@@ -44,6 +51,17 @@ public:
 	Vec3 bounds[2];
 };
 
+//-----------------------------------------------------------------------------------------------------------------------------------------------
+// The world mesh is built chunk by chunk, so every chunk is one contiguous vertex range that can be culled and drawn on its own
+constexpr int TILE_MAP_CHUNK_SIZE = 8;	// tiles per side
+
+struct TileMapChunk
+{
+	int		m_firstVertex = 0;
+	int		m_numVertices = 0;
+	IntVec2	m_chunkCoords = IntVec2::ZERO;	// in chunks
+};
+
 class MapTile
 {
 private:
@@ -64,14 +82,21 @@ public:
 
 	virtual void	Update( float deltaSeconds ) override;
 	virtual void	UpdateMeshes() override;
+	virtual void	UpdateVisibility( Frustum const& frustum ) override;
 	virtual void	Render( Camera& camera ) const override;
 	virtual void	PushEntityOutOfWalls( Entity& e ) override;
+	virtual void	RemoveEntityFromMap( Entity* e ) override;
+	virtual Vec2	GetChaseDirection( Vec2 const& position ) const override;
+	virtual bool	FindPath( Vec2 const& start, Vec2 const& goal, std::vector<IntVec2>& out_tiles ) override;
+	virtual bool	IsPotentiallyVisible( Vec2 const& from, Vec2 const& to ) const override;
 	void			PushEntityOutOfTileIfSolid( Entity& e, IntVec2 const& tileCoords );
 	int				GetTileIndexForTileCoords( int tileX, int tileY ) const;
 	bool			IsTileSolid( IntVec2 const& tileCoords ) const;
 	AABB3			Get3DBoundsForTile( IntVec2 tileCoords ) const;
 	AABB2			Get2DBoundsForTile( IntVec2 tileCoords ) const;
 	IntVec2			GetTileCoordsForWorldPosition( Vec2 const& worldPosition );
+	IntVec2			GetTileDimensions() const	{ return m_tileDimensions; }
+	void			GetTileSolidity( std::vector<uint8_t>& out_isSolid ) const;	// one per tile, x-fastest
 
 	// Raycast
 	virtual RaycastResult	Raycast( Vec2 const& start, Vec2 const& forwardDirection, float maxDistance ) override;
@@ -98,6 +123,8 @@ protected:
 	void			AddVertsForOpenTile( GPUMesh* mesh, MapTile const& tile );
 	//void			AddVertsForOpenTile( Mesh_PCT& mesh, MapTile const& tile ) const;
 
+	std::string		GetPVSCachePath() const;	// in the per-user cache; the shipped Data tree stays read-only
+
 
 private:
 	IntVec2					m_tileDimensions = IntVec2::ZERO;
@@ -108,7 +135,34 @@ private:
 public:
 	//Mesh_PCT				m_worldMesh;
 	GPUMesh* m_worldMesh = nullptr;
+	Texture* m_diffuseTexture = nullptr;		// looked up once, not by path every frame
+	Texture* m_normalTexture = nullptr;
+	Texture* m_flatNormalTexture = nullptr;
 	std::vector<Vertex_PCUTBN> m_vertices;
 	std::vector<uint> m_indices;
+
+	// Visibility, shared by both eye passes
+	std::vector<TileMapChunk>	m_chunks;				// non-empty chunks, in vertex order
+	FrustumAABBList				m_chunkBounds;
+	FrustumSphereList			m_entitySpheres;
+	std::vector<int>			m_entitySphereOwners;	// index into m_allEntities per sphere
+	std::vector<int>			m_visibleChunks;
+	std::vector<int>			m_visibleEntities;		// indices into m_allEntities
+	bool						m_hasVisibility = false;
+	mutable RenderCommandBuffer	m_worldCommands;		// visible chunk draws, re-recorded by each eye's Render
+
+	// Pathing toward the player, shared by every chasing Actor
+	SharedFlowField				m_chaseField;
+
+	// Point-to-point paths for long-range goals
+	HierarchicalPathfinder		m_pathfinder;
+
+	// Update rates for NPCs by distance and visibility
+	AIScheduler					m_aiScheduler;
+
+	// Which tiles can see which, for sight checks and chunk culling; loaded from the .pvs cooked into the user
+	// cache when it is current, otherwise built in the background and cooked there once done
+	TilePVS						m_pvs;
+	bool						m_isPVSCookPending = false;
 };
 
@@ -0,0 +1,933 @@
+#include "Game/TilePVS.hpp"
+#include "Game/HierarchicalPathfinder.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/UnitTest.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+//-------------------------------------------------------------------------------------------------------------
+extern JobSystem*	g_theJobSystem;
+
+//-------------------------------------------------------------------------------------------------------------
+// The sweeps below follow precise permissive field of view (Duerig). In each quadrant, with coordinates mirrored so
+// that the source tile is the unit square at the origin, the tiles still in sight lie inside views: wedges between
+// a shallow and a steep line, each through corners of the source tile or of solid tiles met so far (bumps). Tiles
+// are visited a diagonal at a time; one that overlaps a view is marked, and if solid it lifts the view's shallow
+// line, lowers its steep line, or splits it in two. Lines and corners are integers, so every test is exact.
+//-------------------------------------------------------------------------------------------------------------
+struct PVSLine
+{
+	int		m_startX = 0;
+	int		m_startY = 0;
+	int		m_endX = 0;
+	int		m_endY = 0;
+
+	// Positive left of the line, looking from its start to its end; zero on it
+	int GetSide( int x, int y ) const
+	{
+		return ( ( m_endX - m_startX ) * ( y - m_startY ) ) - ( ( m_endY - m_startY ) * ( x - m_startX ) );
+	}
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct PVSBump
+{
+	int		m_x = 0;
+	int		m_y = 0;
+	int		m_parent = -1;		// the bump this line rested on before; bumps are never changed once added
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct PVSView
+{
+	PVSLine	m_shallowLine;		// the view lies left of it
+	PVSLine	m_steepLine;		// and right of this one
+	int		m_shallowBump = -1;
+	int		m_steepBump = -1;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+// Tiles marked by the sweeps from one tile; stamps mean nothing is cleared between tiles
+//-------------------------------------------------------------------------------------------------------------
+struct PVSBuildScratch
+{
+	std::vector<uint32_t>	m_stamps;
+	std::vector<int>		m_markedTiles;
+	uint32_t				m_stamp = 0;
+	std::vector<PVSView>	m_views;		// of the quadrant being swept, shallowest first
+	std::vector<PVSBump>	m_bumps;
+
+	void Begin( int numTiles )
+	{
+		if( (int)m_stamps.size() < numTiles )
+		{
+			m_stamps.resize( numTiles, 0 );
+		}
+
+		++m_stamp;
+		if( m_stamp == 0 )
+		{
+			std::fill( m_stamps.begin(), m_stamps.end(), 0 );
+			m_stamp = 1;
+		}
+		m_markedTiles.clear();
+	}
+
+	void Mark( int tile )
+	{
+		if( m_stamps[tile] != m_stamp )
+		{
+			m_stamps[tile] = m_stamp;
+			m_markedTiles.push_back( tile );
+		}
+	}
+};
+
+//-------------------------------------------------------------------------------------------------------------
+static void AddShallowBump( int x, int y, PVSView& view, std::vector<PVSBump>& bumps )
+{
+	view.m_shallowLine.m_endX = x;
+	view.m_shallowLine.m_endY = y;
+	bumps.push_back( PVSBump{ x, y, view.m_shallowBump } );
+	view.m_shallowBump = (int)bumps.size() - 1;
+
+	// Pivot the line up onto the steep bump it would otherwise cut through
+	for( int bumpIdx = view.m_steepBump; bumpIdx >= 0; bumpIdx = bumps[bumpIdx].m_parent )
+	{
+		if( view.m_shallowLine.GetSide( bumps[bumpIdx].m_x, bumps[bumpIdx].m_y ) < 0 )
+		{
+			view.m_shallowLine.m_startX = bumps[bumpIdx].m_x;
+			view.m_shallowLine.m_startY = bumps[bumpIdx].m_y;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void AddSteepBump( int x, int y, PVSView& view, std::vector<PVSBump>& bumps )
+{
+	view.m_steepLine.m_endX = x;
+	view.m_steepLine.m_endY = y;
+	bumps.push_back( PVSBump{ x, y, view.m_steepBump } );
+	view.m_steepBump = (int)bumps.size() - 1;
+
+	for( int bumpIdx = view.m_shallowBump; bumpIdx >= 0; bumpIdx = bumps[bumpIdx].m_parent )
+	{
+		if( view.m_steepLine.GetSide( bumps[bumpIdx].m_x, bumps[bumpIdx].m_y ) > 0 )
+		{
+			view.m_steepLine.m_startX = bumps[bumpIdx].m_x;
+			view.m_steepLine.m_startY = bumps[bumpIdx].m_y;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// A view whose lines have closed onto one line through a corner of the source tile has nothing left to see
+//-------------------------------------------------------------------------------------------------------------
+static bool IsViewOpen( PVSView const& view )
+{
+	PVSLine const& shallowLine = view.m_shallowLine;
+	PVSLine const& steepLine = view.m_steepLine;
+	bool areLinesCollinear = shallowLine.GetSide( steepLine.m_startX, steepLine.m_startY ) == 0 && shallowLine.GetSide( steepLine.m_endX, steepLine.m_endY ) == 0;
+	return !areLinesCollinear || ( shallowLine.GetSide( 0, 1 ) != 0 && shallowLine.GetSide( 1, 0 ) != 0 );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void VisitQuadrantTile( uint8_t const* isSolid, IntVec2 const& dimensions, IntVec2 const& sourceTile, int directionX, int directionY,
+	int x, int y, int& viewIdx, PVSBuildScratch& scratch )
+{
+	std::vector<PVSView>& views = scratch.m_views;
+	while( viewIdx < (int)views.size() && views[viewIdx].m_steepLine.GetSide( x + 1, y ) >= 0 )
+	{
+		++viewIdx;		// the tile is past this view's steep line; a steeper view may still hold it
+	}
+	if( viewIdx == (int)views.size() || views[viewIdx].m_shallowLine.GetSide( x, y + 1 ) <= 0 )
+	{
+		return;			// past every view, or under this one and so under the rest too
+	}
+
+	int tile = ( sourceTile.x + ( x * directionX ) ) + ( ( sourceTile.y + ( y * directionY ) ) * dimensions.x );
+	scratch.Mark( tile );
+	if( !isSolid[tile] )
+	{
+		return;
+	}
+
+	bool isShallowLineCut = views[viewIdx].m_shallowLine.GetSide( x + 1, y ) < 0;
+	bool isSteepLineCut = views[viewIdx].m_steepLine.GetSide( x, y + 1 ) > 0;
+	if( isShallowLineCut && isSteepLineCut )
+	{
+		views.erase( views.begin() + viewIdx );
+	}
+	else if( isShallowLineCut )
+	{
+		AddShallowBump( x, y + 1, views[viewIdx], scratch.m_bumps );
+		if( !IsViewOpen( views[viewIdx] ) )
+		{
+			views.erase( views.begin() + viewIdx );
+		}
+	}
+	else if( isSteepLineCut )
+	{
+		AddSteepBump( x + 1, y, views[viewIdx], scratch.m_bumps );
+		if( !IsViewOpen( views[viewIdx] ) )
+		{
+			views.erase( views.begin() + viewIdx );
+		}
+	}
+	else
+	{
+		// Strictly inside the view: one part passes under the tile, the other over it
+		PVSView steepView = views[viewIdx];
+		AddSteepBump( x + 1, y, views[viewIdx], scratch.m_bumps );
+		AddShallowBump( x, y + 1, steepView, scratch.m_bumps );
+		int steepViewIdx = viewIdx + 1;
+		if( !IsViewOpen( views[viewIdx] ) )
+		{
+			views.erase( views.begin() + viewIdx );
+			--steepViewIdx;
+		}
+		if( IsViewOpen( steepView ) )
+		{
+			views.insert( views.begin() + steepViewIdx, steepView );
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Marks every tile of one quadrant that some segment from the source tile reaches without crossing the inside of
+// a solid tile, plus the solid tiles those segments end on. extentX and extentY are the tiles on the map beyond the
+// source in the quadrant's directions.
+//-------------------------------------------------------------------------------------------------------------
+static void SweepQuadrant( uint8_t const* isSolid, IntVec2 const& dimensions, IntVec2 const& sourceTile, int directionX, int directionY,
+	int extentX, int extentY, PVSBuildScratch& scratch )
+{
+	std::vector<PVSView>& views = scratch.m_views;
+	views.clear();
+	scratch.m_bumps.clear();
+	PVSView firstView;
+	firstView.m_shallowLine = PVSLine{ 0, 1, extentX, 0 };
+	firstView.m_steepLine = PVSLine{ 1, 0, 0, extentY };
+	views.push_back( firstView );
+
+	for( int diagonal = 1; diagonal <= extentX + extentY && !views.empty(); ++diagonal )
+	{
+		int firstY = std::max( 0, diagonal - extentX );
+		int lastY = std::min( diagonal, extentY );
+
+		// Skip straight to the shallowest view: along a diagonal, the side of a tile's top left corner changes
+		// linearly with y, and every tile before it passes under the view
+		PVSLine const& shallowLine = views[0].m_shallowLine;
+		int sideStep = ( shallowLine.m_endX - shallowLine.m_startX ) + ( shallowLine.m_endY - shallowLine.m_startY );
+		if( sideStep > 0 )
+		{
+			int sideAtZero = shallowLine.GetSide( diagonal, 1 );
+			int firstInsideY = sideAtZero > 0 ? 0 : ( -sideAtZero / sideStep ) + 1;
+			firstY = std::max( firstY, firstInsideY - 1 );
+		}
+
+		int viewIdx = 0;
+		for( int y = firstY; y <= lastY && viewIdx < (int)views.size(); ++y )
+		{
+			VisitQuadrantTile( isSolid, dimensions, sourceTile, directionX, directionY, diagonal - y, y, viewIdx, scratch );
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void SweepVisibleTiles( uint8_t const* isSolid, IntVec2 const& dimensions, IntVec2 const& sourceTile, PVSBuildScratch& scratch )
+{
+	scratch.Mark( sourceTile.x + ( sourceTile.y * dimensions.x ) );
+	int extentEast = dimensions.x - 1 - sourceTile.x;
+	int extentNorth = dimensions.y - 1 - sourceTile.y;
+	SweepQuadrant( isSolid, dimensions, sourceTile, 1, 1, extentEast, extentNorth, scratch );
+	SweepQuadrant( isSolid, dimensions, sourceTile, -1, 1, sourceTile.x, extentNorth, scratch );
+	SweepQuadrant( isSolid, dimensions, sourceTile, -1, -1, sourceTile.x, sourceTile.y, scratch );
+	SweepQuadrant( isSolid, dimensions, sourceTile, 1, -1, extentEast, sourceTile.y, scratch );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static uint64_t HashWords( int32_t const* mins, int32_t const* size, std::vector<uint32_t> const& words )
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	int32_t window[4] = { mins[0], mins[1], size[0], size[1] };
+	unsigned char const* windowBytes = reinterpret_cast<unsigned char const*>( window );
+	for( size_t byteIdx = 0; byteIdx < sizeof( window ); ++byteIdx )
+	{
+		hash = ( hash ^ windowBytes[byteIdx] ) * 1099511628211ull;
+	}
+	for( uint32_t word : words )
+	{
+		hash = ( hash ^ word ) * 1099511628211ull;
+	}
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static int CountSetBits( uint32_t word )
+{
+	int numBits = 0;
+	for( ; word != 0; word &= word - 1 )
+	{
+		++numBits;
+	}
+	return numBits;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+TilePVS::~TilePVS()
+{
+	while( m_isBuilding.load() )
+	{
+		std::this_thread::yield();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TilePVS::Build( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, pvs_build_options_t const& options )
+{
+	m_isBuilt.store( false );
+	m_dimensions = dimensions;
+	m_chunkSize = options.chunk_size < 1 ? 1 : options.chunk_size;
+	m_solidityHash = HashSolidity( isSolid, dimensions );
+
+	int numTiles = dimensions.x * dimensions.y;
+	m_setIndexForTile.assign( numTiles, -1 );
+	m_sets.clear();
+	m_words.clear();
+
+	PVSBuildScratch scratch;
+	std::unordered_map< uint64_t, std::vector<int> > setsByHash;
+	std::vector<uint32_t> tileWords;
+	std::vector<uint32_t> chunkWords;
+	for( int tile = 0; tile < numTiles; ++tile )
+	{
+		if( isSolid[tile] )
+		{
+			continue;
+		}
+
+		scratch.Begin( numTiles );
+		SweepVisibleTiles( isSolid.data(), dimensions, IntVec2( tile % dimensions.x, tile / dimensions.x ), scratch );
+
+		// Tile bits over the bounding rectangle of what was marked
+		PVSSet set;
+		set.m_mins[0] = dimensions.x;
+		set.m_mins[1] = dimensions.y;
+		int maxX = -1;
+		int maxY = -1;
+		for( int markedTile : scratch.m_markedTiles )
+		{
+			set.m_mins[0] = std::min( set.m_mins[0], markedTile % dimensions.x );
+			set.m_mins[1] = std::min( set.m_mins[1], markedTile / dimensions.x );
+			maxX = std::max( maxX, markedTile % dimensions.x );
+			maxY = std::max( maxY, markedTile / dimensions.x );
+		}
+		set.m_size[0] = maxX - set.m_mins[0] + 1;
+		set.m_size[1] = maxY - set.m_mins[1] + 1;
+		tileWords.assign( ( set.m_size[0] * set.m_size[1] + 31 ) / 32, 0 );
+		for( int markedTile : scratch.m_markedTiles )
+		{
+			int bit = ( markedTile % dimensions.x - set.m_mins[0] ) + ( ( markedTile / dimensions.x - set.m_mins[1] ) * set.m_size[0] );
+			tileWords[bit / 32] |= 1u << ( bit % 32 );
+		}
+
+		// Sets are shared by identical tile bits; chunk bits follow from them
+		uint64_t hash = HashWords( set.m_mins, set.m_size, tileWords );
+		std::vector<int>& sameHashSets = setsByHash[hash];
+		int setIndex = -1;
+		for( int candidate : sameHashSets )
+		{
+			PVSSet const& other = m_sets[candidate];
+			if( other.m_mins[0] == set.m_mins[0] && other.m_mins[1] == set.m_mins[1] && other.m_size[0] == set.m_size[0] && other.m_size[1] == set.m_size[1]
+				&& memcmp( &m_words[other.m_firstWord], tileWords.data(), tileWords.size() * sizeof( uint32_t ) ) == 0 )
+			{
+				setIndex = candidate;
+				break;
+			}
+		}
+
+		if( setIndex < 0 )
+		{
+			// Chunk bits over every chunk within a tile of a marked tile
+			set.m_chunkMins[0] = std::max( set.m_mins[0] - 1, 0 ) / m_chunkSize;
+			set.m_chunkMins[1] = std::max( set.m_mins[1] - 1, 0 ) / m_chunkSize;
+			set.m_chunkSize[0] = std::min( maxX + 1, dimensions.x - 1 ) / m_chunkSize - set.m_chunkMins[0] + 1;
+			set.m_chunkSize[1] = std::min( maxY + 1, dimensions.y - 1 ) / m_chunkSize - set.m_chunkMins[1] + 1;
+			chunkWords.assign( ( set.m_chunkSize[0] * set.m_chunkSize[1] + 31 ) / 32, 0 );
+			for( int markedTile : scratch.m_markedTiles )
+			{
+				for( int offsetY = -1; offsetY <= 1; ++offsetY )
+				{
+					for( int offsetX = -1; offsetX <= 1; ++offsetX )
+					{
+						int nearX = markedTile % dimensions.x + offsetX;
+						int nearY = markedTile / dimensions.x + offsetY;
+						if( nearX >= 0 && nearX < dimensions.x && nearY >= 0 && nearY < dimensions.y )
+						{
+							int bit = ( nearX / m_chunkSize - set.m_chunkMins[0] ) + ( ( nearY / m_chunkSize - set.m_chunkMins[1] ) * set.m_chunkSize[0] );
+							chunkWords[bit / 32] |= 1u << ( bit % 32 );
+						}
+					}
+				}
+			}
+
+			set.m_firstWord = (uint32_t)m_words.size();
+			m_words.insert( m_words.end(), tileWords.begin(), tileWords.end() );
+			set.m_firstChunkWord = (uint32_t)m_words.size();
+			m_words.insert( m_words.end(), chunkWords.begin(), chunkWords.end() );
+
+			setIndex = (int)m_sets.size();
+			m_sets.push_back( set );
+			sameHashSets.push_back( setIndex );
+		}
+		m_setIndexForTile[tile] = setIndex;
+	}
+
+	m_isBuilt.store( true );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+class TilePVSJob : public Job
+{
+public:
+	explicit TilePVSJob( TilePVS* owner )
+		: Job(),
+		m_owner( owner )
+	{
+		m_jobFlags = JOB_FLAG_DELETE_ON_COMPLETE;
+	}
+
+	virtual void Execute() override
+	{
+		m_owner->Build( m_owner->m_buildIsSolid, m_owner->m_buildDimensions, m_owner->m_buildOptions );
+		m_owner->m_isBuilding.store( false );	// releases StartBuild and the destructor, which wait on this flag
+	}
+
+	virtual void OnCompleteCallback() override
+	{
+	}
+
+public:
+	TilePVS*	m_owner = nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+void TilePVS::StartBuild( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, pvs_build_options_t const& options )
+{
+	while( m_isBuilding.load() )
+	{
+		std::this_thread::yield();
+	}
+
+	// Cleared here, on the querying thread, so no query is still reading the sets when the worker replaces them
+	m_isBuilt.store( false );
+	if( g_theJobSystem == nullptr || !g_theJobSystem->AreWorkersRunning() )
+	{
+		Build( isSolid, dimensions, options );
+		return;
+	}
+
+	m_buildIsSolid = isSolid;
+	m_buildDimensions = dimensions;
+	m_buildOptions = options;
+	m_isBuilding.store( true );
+	g_theJobSystem->PostJob( new TilePVSJob( this ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TilePVS::WriteToFile( char const* pvsPath ) const
+{
+	if( !IsBuilt() )
+	{
+		return false;
+	}
+
+	PVSFileHeader header;
+	header.m_solidityHash = m_solidityHash;
+	header.m_dimensions[0] = m_dimensions.x;
+	header.m_dimensions[1] = m_dimensions.y;
+	header.m_chunkSize = m_chunkSize;
+	header.m_numTiles = (uint32_t)m_setIndexForTile.size();
+	header.m_numSets = (uint32_t)m_sets.size();
+	header.m_numWords = (uint32_t)m_words.size();
+
+	size_t tilesByteSize = m_setIndexForTile.size() * sizeof( int32_t );
+	size_t setsByteSize = m_sets.size() * sizeof( PVSSet );
+	size_t wordsByteSize = m_words.size() * sizeof( uint32_t );
+	std::vector<uint8_t> fileBytes( sizeof( PVSFileHeader ) + tilesByteSize + setsByteSize + wordsByteSize );
+	uint8_t* writePos = fileBytes.data();
+	memcpy( writePos, &header, sizeof( PVSFileHeader ) );
+	writePos += sizeof( PVSFileHeader );
+	if( tilesByteSize > 0 )
+	{
+		memcpy( writePos, m_setIndexForTile.data(), tilesByteSize );
+		writePos += tilesByteSize;
+	}
+	if( setsByteSize > 0 )
+	{
+		memcpy( writePos, m_sets.data(), setsByteSize );
+		writePos += setsByteSize;
+	}
+	if( wordsByteSize > 0 )
+	{
+		memcpy( writePos, m_words.data(), wordsByteSize );
+	}
+
+	return WriteBufferToFile( pvsPath, fileBytes.data(), fileBytes.size() );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TilePVS::ReadFromFile( char const* pvsPath, uint64_t solidityHash )
+{
+	std::vector<uint8_t> fileBytes;
+	if( m_isBuilding.load() || !ReadFileToBuffer( pvsPath, fileBytes ) || fileBytes.size() < sizeof( PVSFileHeader ) )
+	{
+		return false;
+	}
+
+	PVSFileHeader header;
+	memcpy( &header, fileBytes.data(), sizeof( PVSFileHeader ) );
+	uint64_t expectedByteSize = sizeof( PVSFileHeader ) + (uint64_t)header.m_numTiles * sizeof( int32_t ) + (uint64_t)header.m_numSets * sizeof( PVSSet ) + (uint64_t)header.m_numWords * sizeof( uint32_t );
+	bool isValid = header.m_magic == PVS_FILE_MAGIC
+		&& header.m_version == PVS_FILE_VERSION
+		&& header.m_solidityHash == solidityHash
+		&& header.m_chunkSize > 0
+		&& header.m_dimensions[0] > 0 && header.m_dimensions[1] > 0
+		&& (uint64_t)header.m_dimensions[0] * (uint64_t)header.m_dimensions[1] == header.m_numTiles
+		&& expectedByteSize == fileBytes.size();
+	if( !isValid )
+	{
+		return false;
+	}
+
+	m_isBuilt.store( false );
+	m_dimensions = IntVec2( header.m_dimensions[0], header.m_dimensions[1] );
+	m_chunkSize = header.m_chunkSize;
+	m_solidityHash = header.m_solidityHash;
+	m_setIndexForTile.resize( header.m_numTiles );
+	m_sets.resize( header.m_numSets );
+	m_words.resize( header.m_numWords );
+
+	uint8_t const* readPos = fileBytes.data() + sizeof( PVSFileHeader );
+	memcpy( m_setIndexForTile.data(), readPos, m_setIndexForTile.size() * sizeof( int32_t ) );
+	readPos += m_setIndexForTile.size() * sizeof( int32_t );
+	if( !m_sets.empty() )
+	{
+		memcpy( m_sets.data(), readPos, m_sets.size() * sizeof( PVSSet ) );
+		readPos += m_sets.size() * sizeof( PVSSet );
+	}
+	if( !m_words.empty() )
+	{
+		memcpy( m_words.data(), readPos, m_words.size() * sizeof( uint32_t ) );
+	}
+
+	// Every index and window must stay inside the arrays, so queries need no checks of their own
+	for( int32_t setIndex : m_setIndexForTile )
+	{
+		isValid = isValid && setIndex >= -1 && setIndex < (int32_t)m_sets.size();
+	}
+	for( PVSSet const& set : m_sets )
+	{
+		uint64_t numTileWords = ( (uint64_t)set.m_size[0] * (uint64_t)set.m_size[1] + 31 ) / 32;
+		uint64_t numChunkWords = ( (uint64_t)set.m_chunkSize[0] * (uint64_t)set.m_chunkSize[1] + 31 ) / 32;
+		isValid = isValid && set.m_size[0] >= 0 && set.m_size[1] >= 0 && set.m_chunkSize[0] >= 0 && set.m_chunkSize[1] >= 0
+			&& set.m_firstWord + numTileWords <= m_words.size() && set.m_firstChunkWord + numChunkWords <= m_words.size();
+	}
+	if( !isValid )
+	{
+		m_setIndexForTile.clear();
+		m_sets.clear();
+		m_words.clear();
+		return false;
+	}
+
+	m_isBuilt.store( true );
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+STATIC uint64_t TilePVS::HashSolidity( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions )
+{
+	// FNV-1a over the dimensions and one bit per tile
+	uint64_t hash = 14695981039346656037ull;
+	int32_t const dimensionValues[2] = { dimensions.x, dimensions.y };
+	unsigned char const* dimensionBytes = reinterpret_cast<unsigned char const*>( dimensionValues );
+	for( size_t byteIdx = 0; byteIdx < sizeof( dimensionValues ); ++byteIdx )
+	{
+		hash = ( hash ^ dimensionBytes[byteIdx] ) * 1099511628211ull;
+	}
+	for( uint8_t tileIsSolid : isSolid )
+	{
+		hash = ( hash ^ ( tileIsSolid ? 1u : 0u ) ) * 1099511628211ull;
+	}
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int TilePVS::GetSetIndex( IntVec2 const& fromTile ) const
+{
+	if( !IsBuilt() || fromTile.x < 0 || fromTile.x >= m_dimensions.x || fromTile.y < 0 || fromTile.y >= m_dimensions.y )
+	{
+		return -1;
+	}
+	return m_setIndexForTile[fromTile.x + ( fromTile.y * m_dimensions.x )];
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TilePVS::IsBitSet( uint32_t firstWord, int32_t const* mins, int32_t const* size, IntVec2 const& coords ) const
+{
+	int localX = coords.x - mins[0];
+	int localY = coords.y - mins[1];
+	if( localX < 0 || localX >= size[0] || localY < 0 || localY >= size[1] )
+	{
+		return false;
+	}
+
+	int bit = localX + ( localY * size[0] );
+	return ( m_words[firstWord + bit / 32] >> ( bit % 32 ) & 1u ) != 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TilePVS::IsTileVisible( IntVec2 const& fromTile, IntVec2 const& toTile ) const
+{
+	int setIndex = GetSetIndex( fromTile );
+	if( setIndex < 0 )
+	{
+		return true;
+	}
+
+	PVSSet const& set = m_sets[setIndex];
+	return IsBitSet( set.m_firstWord, set.m_mins, set.m_size, toTile );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TilePVS::CanTilesSee( IntVec2 const& tileA, IntVec2 const& tileB ) const
+{
+	// A segment clear one way is clear the other, so between open tiles the sets agree and one lookup does
+	return IsTileVisible( tileA, tileB );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TilePVS::IsChunkVisible( IntVec2 const& fromTile, IntVec2 const& chunkCoords ) const
+{
+	int setIndex = GetSetIndex( fromTile );
+	if( setIndex < 0 )
+	{
+		return true;
+	}
+
+	PVSSet const& set = m_sets[setIndex];
+	return IsBitSet( set.m_firstChunkWord, set.m_chunkMins, set.m_chunkSize, chunkCoords );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int TilePVS::GetNumOpenTiles() const
+{
+	int numOpenTiles = 0;
+	for( int32_t setIndex : m_setIndexForTile )
+	{
+		numOpenTiles += setIndex >= 0 ? 1 : 0;
+	}
+	return numOpenTiles;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+size_t TilePVS::GetMemoryBytes() const
+{
+	return m_setIndexForTile.capacity() * sizeof( int32_t ) + m_sets.capacity() * sizeof( PVSSet ) + m_words.capacity() * sizeof( uint32_t );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+float TilePVS::GetAverageVisibleTiles() const
+{
+	std::vector<int> numVisiblePerSet( m_sets.size() );
+	for( int setIdx = 0; setIdx < (int)m_sets.size(); ++setIdx )
+	{
+		PVSSet const& set = m_sets[setIdx];
+		int numWords = ( set.m_size[0] * set.m_size[1] + 31 ) / 32;
+		for( int wordIdx = 0; wordIdx < numWords; ++wordIdx )
+		{
+			numVisiblePerSet[setIdx] += CountSetBits( m_words[set.m_firstWord + wordIdx] );
+		}
+	}
+
+	double totalVisible = 0.0;
+	int numOpenTiles = 0;
+	for( int32_t setIndex : m_setIndexForTile )
+	{
+		if( setIndex >= 0 )
+		{
+			totalVisible += (double)numVisiblePerSet[setIndex];
+			++numOpenTiles;
+		}
+	}
+	return numOpenTiles > 0 ? (float)( totalVisible / (double)numOpenTiles ) : 0.f;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// benchmark_pvs: builds the PVS of generated mazes and reports build time, memory and how much of each map a
+// tile sees. Sampled pairs of open tiles are then checked against brute force: a grid of points in one tile
+// against a grid in the other, any clear segment between them meaning the pair is visible. A pair the PVS
+// says cannot see each other must have no clear segment.
+//-------------------------------------------------------------------------------------------------------------
+static bool IsSegmentClear( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, Vec2 const& start, Vec2 const& end )
+{
+	Vec2 displacement = end - start;
+	float length = displacement.GetLength();
+	if( length <= 0.f )
+	{
+		return true;
+	}
+
+	float directionX = displacement.x / length;
+	float directionY = displacement.y / length;
+	int tileX = (int)floorf( start.x );
+	int tileY = (int)floorf( start.y );
+	int stepX = directionX > 0.f ? 1 : -1;
+	int stepY = directionY > 0.f ? 1 : -1;
+	float tDeltaX = directionX != 0.f ? 1.f / fabsf( directionX ) : 3.402823466e+38f;
+	float tDeltaY = directionY != 0.f ? 1.f / fabsf( directionY ) : 3.402823466e+38f;
+	float tMaxX = directionX > 0.f ? ( (float)( tileX + 1 ) - start.x ) * tDeltaX : ( start.x - (float)tileX ) * tDeltaX;
+	float tMaxY = directionY > 0.f ? ( (float)( tileY + 1 ) - start.y ) * tDeltaY : ( start.y - (float)tileY ) * tDeltaY;
+	while( ( tMaxX < tMaxY ? tMaxX : tMaxY ) < length )
+	{
+		if( tMaxX < tMaxY )
+		{
+			tileX += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			tileY += stepY;
+			tMaxY += tDeltaY;
+		}
+
+		if( isSolid[tileX + ( tileY * dimensions.x )] )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static bool RunPVSBenchmark( int size, unsigned int seed, int numPairs )
+{
+	std::vector<uint8_t> isSolid;
+	GenerateBenchmarkTileMaze( size, seed, isSolid );
+	IntVec2 dimensions( size, size );
+
+	TilePVS pvs;
+	double startSeconds = GetCurrentTimeSeconds();
+	pvs.Build( isSolid, dimensions );
+	double buildSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+	int numOpenTiles = pvs.GetNumOpenTiles();
+	float averageVisibleTiles = pvs.GetAverageVisibleTiles();
+	size_t memoryBytes = pvs.GetMemoryBytes();
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  %ix%i: %i open tiles, built in %.2f s (%.1f us per tile)", size, size, numOpenTiles,
+		buildSeconds, buildSeconds * 1000000.0 / (double)( numOpenTiles > 0 ? numOpenTiles : 1 ) ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    %i distinct sets, %.2f MB (%.1f bytes per open tile, %.1f KB as one flat bitset per tile)",
+		pvs.GetNumSets(), (double)memoryBytes / ( 1024.0 * 1024.0 ), (double)memoryBytes / (double)( numOpenTiles > 0 ? numOpenTiles : 1 ),
+		(double)numOpenTiles * (double)( size * size ) / 8.0 / 1024.0 ) );
+
+	// How much of the map one tile's chunk set keeps
+	int chunkSize = pvs.GetChunkSize();
+	IntVec2 chunkCounts( ( size + chunkSize - 1 ) / chunkSize, ( size + chunkSize - 1 ) / chunkSize );
+	RandomNumberGenerator rng;
+	rng.Reset( seed + 1 );
+	double totalChunkFraction = 0.0;
+	constexpr int NUM_CHUNK_SAMPLES = 64;
+	for( int sampleIdx = 0; sampleIdx < NUM_CHUNK_SAMPLES; ++sampleIdx )
+	{
+		IntVec2 tile( rng.RollRandomIntLessThan( size ), rng.RollRandomIntLessThan( size ) );
+		if( isSolid[tile.x + ( tile.y * size )] )
+		{
+			--sampleIdx;
+			continue;
+		}
+
+		int numVisibleChunks = 0;
+		for( int chunkY = 0; chunkY < chunkCounts.y; ++chunkY )
+		{
+			for( int chunkX = 0; chunkX < chunkCounts.x; ++chunkX )
+			{
+				numVisibleChunks += pvs.IsChunkVisible( tile, IntVec2( chunkX, chunkY ) ) ? 1 : 0;
+			}
+		}
+		totalChunkFraction += (double)numVisibleChunks / (double)( chunkCounts.x * chunkCounts.y );
+	}
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    a tile sees %.1f tiles on average (%.3f%% of the open ones) and keeps %.3f%% of the chunks",
+		averageVisibleTiles, 100.0 * (double)averageVisibleTiles / (double)( numOpenTiles > 0 ? numOpenTiles : 1 ), 100.0 * totalChunkFraction / (double)NUM_CHUNK_SAMPLES ) );
+
+	// Query cost, between open tiles so every query reads a set
+	std::vector<IntVec2> queryTiles( 2048 );
+	for( IntVec2& tile : queryTiles )
+	{
+		do
+		{
+			tile = IntVec2( rng.RollRandomIntLessThan( size ), rng.RollRandomIntLessThan( size ) );
+		} while( isSolid[tile.x + ( tile.y * size )] );
+	}
+	constexpr int NUM_QUERY_ROUNDS = 256;
+	int numVisibleAnswers = 0;
+	startSeconds = GetCurrentTimeSeconds();
+	for( int roundIdx = 0; roundIdx < NUM_QUERY_ROUNDS; ++roundIdx )
+	{
+		for( int tileIdx = 0; tileIdx + 1 < (int)queryTiles.size(); ++tileIdx )
+		{
+			numVisibleAnswers += pvs.CanTilesSee( queryTiles[tileIdx], queryTiles[tileIdx + 1] ) ? 1 : 0;
+		}
+	}
+	double querySeconds = GetCurrentTimeSeconds() - startSeconds;
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    CanTilesSee: %.1f ns per query (%i visible)", querySeconds * 1000000000.0 / (double)( NUM_QUERY_ROUNDS * ( queryTiles.size() - 1 ) ), numVisibleAnswers ) );
+
+	// Brute force on nearby pairs, where sight lines are likely to exist
+	constexpr int POINTS_PER_SIDE = 4;
+	constexpr int MAX_PAIR_DISTANCE = 16;
+	int numVisiblePairs = 0;
+	int numMissedPairs = 0;
+	for( int pairIdx = 0; pairIdx < numPairs; ++pairIdx )
+	{
+		IntVec2 tileA( rng.RollRandomIntLessThan( size ), rng.RollRandomIntLessThan( size ) );
+		IntVec2 tileB = tileA + IntVec2( rng.RollRandomIntInRange( -MAX_PAIR_DISTANCE, MAX_PAIR_DISTANCE ), rng.RollRandomIntInRange( -MAX_PAIR_DISTANCE, MAX_PAIR_DISTANCE ) );
+		if( tileB.x < 0 || tileB.x >= size || tileB.y < 0 || tileB.y >= size || isSolid[tileA.x + ( tileA.y * size )] || isSolid[tileB.x + ( tileB.y * size )] )
+		{
+			--pairIdx;
+			continue;
+		}
+
+		bool isVisible = false;
+		for( int pointA = 0; pointA < POINTS_PER_SIDE * POINTS_PER_SIDE && !isVisible; ++pointA )
+		{
+			Vec2 start( (float)tileA.x + ( (float)( pointA % POINTS_PER_SIDE ) + 0.5f ) / (float)POINTS_PER_SIDE, (float)tileA.y + ( (float)( pointA / POINTS_PER_SIDE ) + 0.5f ) / (float)POINTS_PER_SIDE );
+			for( int pointB = 0; pointB < POINTS_PER_SIDE * POINTS_PER_SIDE && !isVisible; ++pointB )
+			{
+				Vec2 end( (float)tileB.x + ( (float)( pointB % POINTS_PER_SIDE ) + 0.5f ) / (float)POINTS_PER_SIDE, (float)tileB.y + ( (float)( pointB / POINTS_PER_SIDE ) + 0.5f ) / (float)POINTS_PER_SIDE );
+				isVisible = IsSegmentClear( isSolid, dimensions, start, end );
+			}
+		}
+
+		if( isVisible )
+		{
+			++numVisiblePairs;
+			numMissedPairs += pvs.CanTilesSee( tileA, tileB ) ? 0 : 1;
+		}
+	}
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    %i of %i nearby pairs visible by brute force; %i of them missing from the PVS", numVisiblePairs, numPairs, numMissedPairs ) );
+
+	// And back from a cooked file
+	std::string pvsPath = Stringf( "BenchmarkPVS_%i.pvs", size );
+	TilePVS loaded;
+	startSeconds = GetCurrentTimeSeconds();
+	bool isRoundTripped = pvs.WriteToFile( pvsPath.c_str() ) && loaded.ReadFromFile( pvsPath.c_str(), TilePVS::HashSolidity( isSolid, dimensions ) );
+	double loadSeconds = GetCurrentTimeSeconds() - startSeconds;
+	for( int tileIdx = 0; tileIdx + 1 < (int)queryTiles.size() && isRoundTripped; ++tileIdx )
+	{
+		isRoundTripped = loaded.CanTilesSee( queryTiles[tileIdx], queryTiles[tileIdx + 1] ) == pvs.CanTilesSee( queryTiles[tileIdx], queryTiles[tileIdx + 1] );
+	}
+	remove( pvsPath.c_str() );
+	g_theConsole->PrintString( isRoundTripped ? Rgba8::WHITE : Rgba8::RED, Stringf( "    written and read back in %.1f ms%s", loadSeconds * 1000.0, isRoundTripped ? "" : ", WITH DIFFERENCES" ) );
+
+	return numMissedPairs == 0 && isRoundTripped;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_pvs, "size,seed" )
+{
+	int size = args.GetValue( "size", 0 );
+	int seed = args.GetValue( "seed", 1 );
+	int const defaultSizes[] = { 128, 256, 512 };
+	int numSizes = size > 0 ? 1 : 3;
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Tile PVS on generated mazes (seed %i)", seed ) );
+	bool isConservative = true;
+	for( int sizeIdx = 0; sizeIdx < numSizes; ++sizeIdx )
+	{
+		isConservative = RunPVSBenchmark( size > 0 ? size : defaultSizes[sizeIdx], (unsigned int)seed, 2000 ) && isConservative;
+	}
+	g_theConsole->PrintString( isConservative ? Rgba8::GREEN : Rgba8::RED, isConservative ? "PVS holds every brute-force sight line" : "PVS MISSES sight lines" );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Brute force against the built sets: random clear segments, each from a point anywhere in an open tile to a point
+// short of the first wall in a random direction, plus a narrow sight line the old ray sweeps missed. Both end tiles
+// must see each other and the chunk at the other end.
+//-------------------------------------------------------------------------------------------------------------
+UNIT_TEST( TilePVSHoldsEverySightLine, "Game" )
+{
+	constexpr int MAZE_SIZE = 64;
+	constexpr int NUM_SEGMENTS = 50000;
+	IntVec2 dimensions( MAZE_SIZE, MAZE_SIZE );
+	for( unsigned int seed = 1; seed <= 3; ++seed )
+	{
+		std::vector<uint8_t> isSolid;
+		GenerateBenchmarkTileMaze( MAZE_SIZE, seed, isSolid );
+		TilePVS pvs;
+		pvs.Build( isSolid, dimensions );
+		int chunkSize = pvs.GetChunkSize();
+
+		RandomNumberGenerator rng;
+		rng.Reset( seed );
+		int numClearSegments = 0;
+		int numMissedSegments = 0;
+		std::string firstMiss;
+		for( int segmentIdx = 0; segmentIdx <= NUM_SEGMENTS; ++segmentIdx )
+		{
+			Vec2 start( 36.083f, 5.75f );
+			Vec2 end( 30.75f, 16.917f );
+			if( segmentIdx < NUM_SEGMENTS )
+			{
+				do
+				{
+					start = Vec2( rng.RollRandomFloatLessThan( (float)MAZE_SIZE ), rng.RollRandomFloatLessThan( (float)MAZE_SIZE ) );
+				} while( isSolid[(int)start.x + ( (int)start.y * MAZE_SIZE )] );
+
+				// Bisect for how far the segment stays clear, then end anywhere short of that
+				Vec2 direction = rng.RollRandomDirection2D();
+				float clearLength = 0.f;
+				float blockedLength = 2.f * (float)MAZE_SIZE;
+				for( int halvingIdx = 0; halvingIdx < 24; ++halvingIdx )
+				{
+					float length = 0.5f * ( clearLength + blockedLength );
+					Vec2 probe = start + ( direction * length );
+					bool isClear = probe.x >= 0.f && probe.x < (float)MAZE_SIZE && probe.y >= 0.f && probe.y < (float)MAZE_SIZE && IsSegmentClear( isSolid, dimensions, start, probe );
+					( isClear ? clearLength : blockedLength ) = length;
+				}
+				end = start + ( direction * ( clearLength * rng.RollRandomFloatZeroToOneInclusive() ) );
+			}
+
+			IntVec2 startTile( (int)floorf( start.x ), (int)floorf( start.y ) );
+			IntVec2 endTile( (int)floorf( end.x ), (int)floorf( end.y ) );
+			if( isSolid[startTile.x + ( startTile.y * MAZE_SIZE )] || !IsSegmentClear( isSolid, dimensions, start, end ) )
+			{
+				continue;
+			}
+
+			++numClearSegments;
+			bool isHeld = pvs.IsTileVisible( startTile, endTile ) && pvs.IsTileVisible( endTile, startTile )
+				&& pvs.IsChunkVisible( startTile, IntVec2( endTile.x / chunkSize, endTile.y / chunkSize ) )
+				&& pvs.IsChunkVisible( endTile, IntVec2( startTile.x / chunkSize, startTile.y / chunkSize ) );
+			if( !isHeld && numMissedSegments++ == 0 )
+			{
+				firstMiss = Stringf( "(%.3f,%.3f)->(%.3f,%.3f)", start.x, start.y, end.x, end.y );
+			}
+		}
+
+		UNIT_TEST_CHECK_MSG( numClearSegments > NUM_SEGMENTS / 2, Stringf( "seed %u: only %i clear segments", seed, numClearSegments ) );
+		UNIT_TEST_CHECK_MSG( numMissedSegments == 0, Stringf( "seed %u: %i of %i clear segments missing from the PVS, first %s", seed, numMissedSegments, numClearSegments, firstMiss.c_str() ) );
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Engine/Math/IntVec2.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr uint32_t PVS_FILE_MAGIC = 0x20535650;		// "PVS " read as a little-endian uint32
+constexpr uint32_t PVS_FILE_VERSION = 2;
+
+//-------------------------------------------------------------------------------------------------------------
+struct pvs_build_options_t
+{
+	int		chunk_size = 8;				// tiles per side of the chunks IsChunkVisible answers for
+};
+
+//-------------------------------------------------------------------------------------------------------------
+// A cooked .pvs file is this header followed by the per-tile set indices, the sets and the bit words, each array
+// tightly packed in that order. The solidity hash ties it to the map it was built from.
+//-------------------------------------------------------------------------------------------------------------
+struct PVSFileHeader
+{
+	uint32_t	m_magic = PVS_FILE_MAGIC;
+	uint32_t	m_version = PVS_FILE_VERSION;
+	uint64_t	m_solidityHash = 0;
+	int32_t		m_dimensions[2] = {};
+	int32_t		m_chunkSize = 0;
+	uint32_t	m_numTiles = 0;
+	uint32_t	m_numSets = 0;
+	uint32_t	m_numWords = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+// Tile-to-tile potentially visible sets. For every open tile, a precise permissive field-of-view sweep marks every
+// tile that some segment from anywhere in it reaches without crossing the inside of a solid tile, along with the
+// solid tiles such segments end on. Segments that only graze a corner count as clear, so the sets are conservative:
+// no sight line between two points is ever missing from them.
+//
+// Each set is kept as a bitset over the bounding rectangle of what it contains, plus a coarser one over chunks,
+// dilated by a tile so that anything straddling a chunk border is kept. Sets shared by several tiles (those
+// of one room often are) are stored once. Every query is O(1), and answers true wherever there is no set to ask:
+// before the build finishes, from solid tiles and from off the map.
+//
+//	StartBuild runs on a JobSystem worker when any are running; queries are safe from the main thread meanwhile.
+//-------------------------------------------------------------------------------------------------------------
+class TilePVS
+{
+public:
+	~TilePVS();		// waits out a build still in flight
+
+	void	Build( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, pvs_build_options_t const& options = pvs_build_options_t() );
+	void	StartBuild( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions, pvs_build_options_t const& options = pvs_build_options_t() );
+	bool	WriteToFile( char const* pvsPath ) const;
+	bool	ReadFromFile( char const* pvsPath, uint64_t solidityHash );	// false if missing, damaged or built for another map
+
+	static uint64_t	HashSolidity( std::vector<uint8_t> const& isSolid, IntVec2 const& dimensions );
+
+	bool	IsBuilt() const						{ return m_isBuilt.load(); }
+	bool	IsTileVisible( IntVec2 const& fromTile, IntVec2 const& toTile ) const;		// toTile may be solid
+	bool	CanTilesSee( IntVec2 const& tileA, IntVec2 const& tileB ) const;			// either way round
+	bool	IsChunkVisible( IntVec2 const& fromTile, IntVec2 const& chunkCoords ) const;
+
+	int		GetChunkSize() const				{ return m_chunkSize; }
+	int		GetNumSets() const					{ return (int)m_sets.size(); }
+	int		GetNumOpenTiles() const;
+	size_t	GetMemoryBytes() const;
+	float	GetAverageVisibleTiles() const;		// per open tile
+
+private:
+	friend class TilePVSJob;
+
+	struct PVSSet
+	{
+		int32_t		m_mins[2] = {};				// tile window
+		int32_t		m_size[2] = {};
+		uint32_t	m_firstWord = 0;
+		int32_t		m_chunkMins[2] = {};		// chunk window
+		int32_t		m_chunkSize[2] = {};
+		uint32_t	m_firstChunkWord = 0;
+	};
+
+private:
+	int		GetSetIndex( IntVec2 const& fromTile ) const;	// -1 if there is none
+	bool	IsBitSet( uint32_t firstWord, int32_t const* mins, int32_t const* size, IntVec2 const& coords ) const;
+
+private:
+	IntVec2					m_dimensions = IntVec2::ZERO;
+	int						m_chunkSize = 8;
+	uint64_t				m_solidityHash = 0;
+	std::vector<int32_t>	m_setIndexForTile;	// -1 for solid tiles
+	std::vector<PVSSet>		m_sets;
+	std::vector<uint32_t>	m_words;			// every set's tile bits, then its chunk bits
+	std::atomic<bool>		m_isBuilt = false;
+	std::atomic<bool>		m_isBuilding = false;
+
+	// StartBuild's copy of its inputs, for the worker
+	std::vector<uint8_t>	m_buildIsSolid;
+	IntVec2					m_buildDimensions = IntVec2::ZERO;
+	pvs_build_options_t		m_buildOptions;
+};
@@ -6,6 +6,8 @@
 #include "Engine/Physics/GameObject.hpp"
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Math/Frustum.hpp"
 
 World::World( Camera& cameraLeft, Camera& cameraRight )
 	:m_cameraLeft( cameraLeft )
@@ -23,14 +25,26 @@ World::~World()
 
 void World::Update( float deltaSeconds )
 {
+	PROFILE_FUNCTION();
 	m_currentMap->Update( deltaSeconds );
 }
 
+void World::UpdateVisibility()
+{
+	PROFILE_FUNCTION();
+	if( m_currentMap )
+	{
+		m_currentMap->UpdateMeshes();
+
+		Frustum stereoFrustum = Frustum::CreateStereoEnclosing( m_cameraLeft.GetWorldToClipMatrix(), m_cameraRight.GetWorldToClipMatrix() );
+		m_currentMap->UpdateVisibility( stereoFrustum );
+	}
+}
+
 void World::Render( Camera& camera ) const
 { 
 	if( m_currentMap )
 	{
-		m_currentMap->UpdateMeshes();
 		m_currentMap->Render( camera );
 	}
 }
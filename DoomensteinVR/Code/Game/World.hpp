@@ -21,6 +21,7 @@ public:
 	~World();
 
 	void Update( float deltaSeconds );
+	void UpdateVisibility();	// rebuilds the map mesh and culls it for both eyes; once per frame, before the eye passes
 	void Render( Camera& camera ) const;
 	void Render( eCameras cameraToRender ) const;
 
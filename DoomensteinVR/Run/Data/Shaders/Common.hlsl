@@ -91,6 +91,25 @@ cbuffer light_constants : register(b4)
     float fog_pad01;  
 };
 
+//------------------------------------------------------------------------
+// clustered point and spot lights (RenderContext::BindLightClusters); CLUSTER_SLICES 0 means none are bound
+cbuffer light_cluster_constants : register(b6)
+{
+    uint CLUSTER_TILES_X;
+    uint CLUSTER_TILES_Y;
+    uint CLUSTER_SLICES;
+    uint cluster_pad00;
+
+    float CLUSTER_NEAR_DEPTH;   // clip w
+    float CLUSTER_FAR_DEPTH;
+    float CLUSTER_SLICE_SCALE;  // slice = log( depth / near ) * scale
+    float cluster_pad01;
+};
+
+StructuredBuffer<light_t> CLUSTER_LIGHTS : register(t14);
+StructuredBuffer<uint2> CLUSTER_RANGES : register(t15);         // offset, count into CLUSTER_LIGHT_INDICES
+StructuredBuffer<uint> CLUSTER_LIGHT_INDICES : register(t16);   // into CLUSTER_LIGHTS
+
 //cbuffer material_constants : register(b5)
 //{
 //    float3 FRESNEL_COLOR; 
@@ -90,6 +90,33 @@ float2 ComputeLightFactor( light_t light, float3 world_pos, float3 world_normal,
 };
 //--------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------
+// The same cluster LightClusterGrid::GetClusterIndexForViewPosition picks: tiles split NDC evenly, x fastest,
+// bottom row first, then slices spaced exponentially in clip w
+void AddClusteredLights( float3 world_pos, float3 world_normal, float3 dir_to_eye, inout float3 diffuse, inout float3 spec )
+{
+   if (CLUSTER_SLICES == 0)
+      return;
+
+   float4 clip_pos = mul( PROJECTION, mul( VIEW, float4( world_pos, 1.0f ) ) );
+   if (clip_pos.w < CLUSTER_NEAR_DEPTH || clip_pos.w >= CLUSTER_FAR_DEPTH)
+      return;
+
+   float2 tile_count = float2( CLUSTER_TILES_X, CLUSTER_TILES_Y );
+   uint2 tile = (uint2) clamp( floor( (clip_pos.xy / clip_pos.w + 1.0f) * 0.5f * tile_count ), float2( 0.0f, 0.0f ), tile_count - 1.0f );
+   uint slice = min( (uint) (log( clip_pos.w / CLUSTER_NEAR_DEPTH ) * CLUSTER_SLICE_SCALE), CLUSTER_SLICES - 1 );
+
+   uint2 range = CLUSTER_RANGES[(slice * CLUSTER_TILES_Y + tile.y) * CLUSTER_TILES_X + tile.x];
+   for (uint i = 0; i < range.y; ++i)
+   {
+      light_t light = CLUSTER_LIGHTS[CLUSTER_LIGHT_INDICES[range.x + i]];
+      float2 light_factors = ComputeLightFactor( light, world_pos, world_normal, dir_to_eye );
+
+      diffuse += light_factors.x * light.color;
+      spec += light_factors.y * light.color;
+   }
+}
+
 //------------------------------------------------------------------------
 // be sure colors are in linear space when passed in; 
 float3 ComputeLightingAt( float3 world_pos, float3 world_normal, 
@@ -109,6 +136,7 @@ float3 ComputeLightingAt( float3 world_pos, float3 world_normal,
       diffuse += light_factors.x * light_color; 
       spec += light_factors.y * light_color; 
    }
+   AddClusteredLights( world_pos, world_normal, dir_to_eye, diffuse, spec );
 
    // limit it
    diffuse = min( diffuse, float3(1,1,1) );
@@ -138,6 +166,7 @@ float3 GetBloom( float3 world_pos, float3 world_normal,
         diffuse += light_factors.x * light_color; 
         spec += light_factors.y * light_color; 
     }
+    AddClusteredLights( world_pos, world_normal, dir_to_eye, diffuse, spec );
 
     diffuse = min( diffuse, float3(1,1,1) );
     float3 bloom = max( float3(0,0,0), spec - float3(1,1,1) );
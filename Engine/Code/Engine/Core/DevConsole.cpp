@@ -5,6 +5,8 @@
 #include "Engine/Renderer/Camera.hpp"
 #include <stdio.h>      /* printf */
 #include <stdarg.h>     /* va_list, va_start, va_arg, va_end */
+#define WIN32_LEAN_AND_MEAN		// Always #define this before #including <windows.h>
+#include <windows.h>			// the clipboard
 
 extern DevConsole* g_theConsole;
 
@@ -237,8 +239,26 @@ void DevConsole::AddToCommandHistory( std::string commandName )
 
 void DevConsole::PrintString( const Rgba8& textColor, const std::string& devConsolePrintString )
 {
-	m_textColors.push_back(textColor);
-	m_devConsolePrintStrings.push_back(devConsolePrintString);
+	std::lock_guard<std::mutex> lock( m_logLock );
+
+	if( m_logLines.empty() ) {
+		m_logLines.resize( DEV_CONSOLE_MAX_LOG_LINES );
+	}
+
+	int lineIdx;
+	if( m_numLogLines < DEV_CONSOLE_MAX_LOG_LINES ) {
+		lineIdx = ( m_firstLogLine + m_numLogLines ) % DEV_CONSOLE_MAX_LOG_LINES;
+		++m_numLogLines;
+	}
+	else {
+		lineIdx = m_firstLogLine;
+		m_firstLogLine = ( m_firstLogLine + 1 ) % DEV_CONSOLE_MAX_LOG_LINES;
+	}
+
+	ColoredLine& line = m_logLines[lineIdx];
+	line.m_color = textColor;
+	line.m_text.assign( devConsolePrintString );
+	line.m_layoutFont = nullptr;
 }
 
 void DevConsole::Render( RenderContext& renderer, const Camera& camera, float lineHeight, BitmapFont* font )
@@ -248,7 +268,7 @@ void DevConsole::Render( RenderContext& renderer, const Camera& camera, float li
 	if( m_isActive )
 	{
 		renderer.BindTexture( nullptr );
-		Vec2 dimensions = renderer.m_swapchain->GetBackBuffer()->GetDimensions();
+		Vec2 dimensions = renderer.GetBackBuffer()->GetDimensions();
 
 		std::vector<Vertex_PCU> backgroundVerts;
 		//AABB2 background = AABB2( camera.GetOrthoBottonLeft(), camera.GetOrthoTopRight() );
@@ -260,14 +280,35 @@ void DevConsole::Render( RenderContext& renderer, const Camera& camera, float li
 		renderer.DrawAABB2( inputTextBoxBackground, Rgba8( 128, 128, 128, 255 ) );
 
 		renderer.BindTexture( nullptr );
-		std::vector<Vertex_PCU> textVerts;
-		for( int index = (int)m_devConsolePrintStrings.size() - 1; index >= 0; index-- )
+		std::vector<Vertex_PCU>& textVerts = m_textVerts;
+		textVerts.clear();
 		{
-			Vec2 textMins = background.mins + Vec2( 0, lineHeight ) * (float)( m_devConsolePrintStrings.size() /*- 1*/ - index );
-			if( (textMins.y + lineHeight) <= background.maxs.y ) // Draws only log print lines that fit on screen 
+			std::lock_guard<std::mutex> lock( m_logLock );
+
+			// only the newest lines that fit on screen, above the input box
+			int numVisibleLines = (int)( ( background.maxs.y - background.mins.y ) / lineHeight ) - 1;
+			if( numVisibleLines > m_numLogLines ) {
+				numVisibleLines = m_numLogLines;
+			}
+
+			for( int lineFromNewest = 0; lineFromNewest < numVisibleLines; ++lineFromNewest )
 			{
-				//font->AddVertsForText2D( textVerts, textMins, 3.f, m_devConsolePrintStrings[index], m_textColors[index] );
-				font->AddVertsForText2D( textVerts, textMins, lineHeight, m_devConsolePrintStrings[index],  m_textColors[index] );
+				int lineIdx = ( m_firstLogLine + m_numLogLines - 1 - lineFromNewest ) % DEV_CONSOLE_MAX_LOG_LINES;
+				ColoredLine& line = m_logLines[lineIdx];
+				if( line.m_layoutFont != font || line.m_layoutLineHeight != lineHeight )
+				{
+					line.m_glyphVerts.clear();
+					font->AddVertsForText2D( line.m_glyphVerts, Vec2::ZERO, lineHeight, line.m_text, line.m_color );
+					line.m_layoutFont = font;
+					line.m_layoutLineHeight = lineHeight;
+				}
+
+				Vec3 offset = Vec3( background.mins.x, background.mins.y + lineHeight * (float)( lineFromNewest + 1 ), 0.f );
+				for( Vertex_PCU const& glyphVert : line.m_glyphVerts )
+				{
+					textVerts.push_back( glyphVert );
+					textVerts.back().m_position += offset;
+				}
 			}
 		}
 
@@ -1,8 +1,10 @@
  #pragma once
 #include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
  
 class RenderContext;
 class Camera;
@@ -10,10 +12,17 @@ class BitmapFont;
 
 extern BitmapFont*  g_theFont;
 
+constexpr int DEV_CONSOLE_MAX_LOG_LINES = 1024;
+
 struct ColoredLine
 {
 	Rgba8 m_color;
 	std::string m_text;
+
+	// glyph quads laid out at the origin; rebuilt only when the text, font or line height changes
+	std::vector<Vertex_PCU> m_glyphVerts;
+	BitmapFont* m_layoutFont = nullptr;
+	float m_layoutLineHeight = 0.f;
 };
 
 class DevConsole
@@ -60,8 +69,13 @@ public:
 	std::vector<std::string> m_commandHistory;
 	int m_cmHistoryIdx = 0;
 
-	std::vector<Rgba8> m_textColors;
-	std::vector<std::string> m_devConsolePrintStrings;
+	// scrollback ring: the oldest line is overwritten once it is full, and the slots (strings and cached quads) are re-used
+	std::vector<ColoredLine> m_logLines;
+	int m_firstLogLine = 0;
+	int m_numLogLines = 0;
+	std::mutex m_logLock;		// lines come in from the tracking and network threads too
+
+	std::vector<Vertex_PCU> m_textVerts;
 	bool m_isActive = false;
 
 	// Caret
@@ -1,6 +1,10 @@
 #include "Engine/Core/EventSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/UnitTest.hpp"
+#include <algorithm>
+#include <new>
+#include <thread>
 
 static uint constexpr MAX_REGISTERED_EVENTS( 128 );
 static EventSubscription* gRegistrarList[MAX_REGISTERED_EVENTS];
@@ -18,6 +22,12 @@ EventSubscription::EventSubscription( std::string eventName, EventCallbackFuncti
 	gRegistrarCount++;
 }
 
+EventSubscription::EventSubscription( std::string eventName, EventCallbackFunctionPtrType eventCallbackPtrType )
+	:m_callbackFuncPtr( eventCallbackPtrType )
+	, m_eventName(eventName)
+{
+}
+
 
 EventSystem::EventSystem()
 {
@@ -29,6 +39,22 @@ EventSystem::EventSystem()
 
 EventSystem::~EventSystem()
 {
+	for( EventSubscription* subscription : m_ownedSubscriptions )
+	{
+		delete subscription;
+	}
+	m_ownedSubscriptions.clear();
+	m_eventSubsrciptions.clear();
+
+	// queued but never dispatched; their args may own strings
+	for( int queueIdx = 0; queueIdx < 2; ++queueIdx )
+	{
+		for( QueuedEvent* queuedEvent : m_queuedEvents[queueIdx] )
+		{
+			queuedEvent->~QueuedEvent();
+		}
+		m_queuedEvents[queueIdx].clear();
+	}
 }
 
 void EventSystem::StartUp()
@@ -38,15 +64,16 @@ void EventSystem::StartUp()
 
 void EventSystem::SubscribeToEvent( const std::string& eventName, EventCallbackFunctionPtrType eventCallbackPtrType )
 {
-	EventSubscription* newSubscrition = new EventSubscription( eventName, eventCallbackPtrType, nullptr );
-	newSubscrition->m_eventName = eventName;
-	newSubscrition->m_callbackFuncPtr = eventCallbackPtrType;
+	std::lock_guard<std::recursive_mutex> subscriptionsLock( m_subscriptionsMutex );
+	EventSubscription* newSubscrition = new EventSubscription( eventName, eventCallbackPtrType );
 	m_eventSubsrciptions.push_back( newSubscrition );
+	m_ownedSubscriptions.push_back( newSubscrition );
 }
 
 
 void EventSystem::FireEvent( const std::string& eventName )
 {
+	std::lock_guard<std::recursive_mutex> subscriptionsLock( m_subscriptionsMutex );
 	for( int i = 0; i < (int)m_eventSubsrciptions.size(); i++ )
 	{
 		EventSubscription* subscription = m_eventSubsrciptions[ i ];
@@ -58,20 +85,22 @@ void EventSystem::FireEvent( const std::string& eventName )
 }
 
 
-void EventSystem::FireEvent( const std::string& eventName, NamedProperties value )
+void EventSystem::FireEvent( const std::string& eventName, NamedProperties& args )
 {
+	std::lock_guard<std::recursive_mutex> subscriptionsLock( m_subscriptionsMutex );
 	for( int i = 0; i < (int)m_eventSubsrciptions.size(); i++ )
 	{
 		EventSubscription* subscription = m_eventSubsrciptions[i];
 		if( subscription->m_eventName == eventName )
 		{
-			m_eventSubsrciptions[i]->m_callbackFuncPtr( value );
+			m_eventSubsrciptions[i]->m_callbackFuncPtr( args );
 		}
 	}
 }
 
 void EventSystem::FireEventWithValue( const std::string& eventNameWithValue )
 {
+	std::lock_guard<std::recursive_mutex> subscriptionsLock( m_subscriptionsMutex );
 	Strings strings = SplitStringOnDelimiter( eventNameWithValue, ' ' );
 
 	EventSubscription* subscription = nullptr;
@@ -110,3 +139,231 @@ void EventSystem::FireEventWithValue( const std::string& eventNameWithValue )
 		subscription->m_callbackFuncPtr( subscription->m_input );
 	}
 }
+
+//-------------------------------------------------------------------------------------------------------------
+EventID EventSystem::GetEventID( const std::string& eventName )
+{
+	std::lock_guard<std::mutex> queueLock( m_queueMutex );
+
+	auto found = m_eventIDsByName.find( eventName );
+	if( found != m_eventIDsByName.end() )
+	{
+		return found->second;
+	}
+
+	EventID newID = (EventID)m_eventNamesByID.size();
+	m_eventIDsByName[eventName] = newID;
+	m_eventNamesByID.push_back( eventName );
+	return newID;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent( const std::string& eventName )
+{
+	QueueEvent( GetEventID( eventName ), NamedProperties() );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent( const std::string& eventName, NamedProperties const& args )
+{
+	QueueEvent( GetEventID( eventName ), args );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent( EventID eventID, NamedProperties const& args )
+{
+	std::lock_guard<std::mutex> queueLock( m_queueMutex );
+
+	LinearAllocator& arena = m_queueArenas[m_recordingQueueIdx];
+	void* memory = arena.Allocate( sizeof( QueuedEvent ), alignof( QueuedEvent ) );
+	QueuedEvent* queuedEvent = new( memory ) QueuedEvent();
+	queuedEvent->m_eventID = eventID;
+	queuedEvent->m_sequence = m_nextSequence++;
+	queuedEvent->m_args = args;
+
+	m_queuedEvents[m_recordingQueueIdx].push_back( queuedEvent );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void EventSystem::QueueEvent( EventID eventID, NamedProperties&& args )
+{
+	std::lock_guard<std::mutex> queueLock( m_queueMutex );
+
+	LinearAllocator& arena = m_queueArenas[m_recordingQueueIdx];
+	void* memory = arena.Allocate( sizeof( QueuedEvent ), alignof( QueuedEvent ) );
+	QueuedEvent* queuedEvent = new( memory ) QueuedEvent();
+	queuedEvent->m_eventID = eventID;
+	queuedEvent->m_sequence = m_nextSequence++;
+	queuedEvent->m_args = std::move( args );
+
+	m_queuedEvents[m_recordingQueueIdx].push_back( queuedEvent );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int EventSystem::GetNumQueuedEvents()
+{
+	std::lock_guard<std::mutex> queueLock( m_queueMutex );
+	return (int)m_queuedEvents[m_recordingQueueIdx].size();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void EventSystem::DispatchQueuedEvents()
+{
+	// Swap buffers so producers keep recording into the other arena while we dispatch this one
+	int dispatchQueueIdx = 0;
+	{
+		std::lock_guard<std::mutex> queueLock( m_queueMutex );
+		dispatchQueueIdx = m_recordingQueueIdx;
+		m_recordingQueueIdx = 1 - m_recordingQueueIdx;
+	}
+
+	std::vector<QueuedEvent*>& events = m_queuedEvents[dispatchQueueIdx];
+	if( events.empty() )
+	{
+		return;
+	}
+
+	std::stable_sort( events.begin(), events.end(), []( QueuedEvent const* a, QueuedEvent const* b ) { 
+		return a->m_eventID < b->m_eventID; 
+	} );
+
+	std::lock_guard<std::recursive_mutex> subscriptionsLock( m_subscriptionsMutex );
+
+	int groupStart = 0;
+	while( groupStart < (int)events.size() )
+	{
+		EventID eventID = events[groupStart]->m_eventID;
+		int groupEnd = groupStart + 1;
+		while( groupEnd < (int)events.size() && events[groupEnd]->m_eventID == eventID )
+		{
+			++groupEnd;
+		}
+
+		// Resolve subscribers once for the whole group
+		std::string eventName;
+		{
+			std::lock_guard<std::mutex> queueLock( m_queueMutex );
+			eventName = m_eventNamesByID[eventID];
+		}
+		GetSubscriptionsForEvent( eventName, m_dispatchSubscriptions );
+
+		for( int eventIdx = groupStart; eventIdx < groupEnd; ++eventIdx )
+		{
+			for( int subIdx = 0; subIdx < (int)m_dispatchSubscriptions.size(); ++subIdx )
+			{
+				m_dispatchSubscriptions[subIdx]->m_callbackFuncPtr( events[eventIdx]->m_args );
+			}
+		}
+
+		groupStart = groupEnd;
+	}
+
+	for( int eventIdx = 0; eventIdx < (int)events.size(); ++eventIdx )
+	{
+		events[eventIdx]->~QueuedEvent();
+	}
+	events.clear();
+	m_queueArenas[dispatchQueueIdx].Reset();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void EventSystem::GetSubscriptionsForEvent( const std::string& eventName, std::vector<EventSubscription*>& out_subscriptions )
+{
+	out_subscriptions.clear();
+	for( int i = 0; i < (int)m_eventSubsrciptions.size(); ++i )
+	{
+		if( m_eventSubsrciptions[i]->m_eventName == eventName )
+		{
+			out_subscriptions.push_back( m_eventSubsrciptions[i] );
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Two producer threads queue while the main thread watches; nothing may arrive before the drain point, and
+// everything must arrive at it, each producer's events in the order it queued them
+//-------------------------------------------------------------------------------------------------------------
+constexpr int NUM_TEST_EVENTS_PER_PRODUCER = 5000;
+static std::vector<int> s_deliveredValues[2];
+static int s_numDeliveredOther = 0;
+
+static void OnTestEventQueued( NamedProperties& args )
+{
+	int producer = args.GetValue( "producer", -1 );
+	if( producer == 0 || producer == 1 )
+	{
+		s_deliveredValues[producer].push_back( args.GetValue( "value", -1 ) );
+	}
+}
+
+static void OnTestOtherEventQueued( NamedProperties& args )
+{
+	UNUSED( args );
+	++s_numDeliveredOther;
+}
+
+UNIT_TEST( QueuedEventsFromOtherThreads, "Core" )
+{
+	EventSystem eventSystem;
+	eventSystem.SubscribeToEvent( "UnitTestQueued", OnTestEventQueued );
+	eventSystem.SubscribeToEvent( "UnitTestQueuedOther", OnTestOtherEventQueued );
+	s_deliveredValues[0].clear();
+	s_deliveredValues[1].clear();
+	s_numDeliveredOther = 0;
+
+	auto produce = [&eventSystem]( int producer ) {
+		EventID eventID = eventSystem.GetEventID( "UnitTestQueued" );
+		for( int value = 0; value < NUM_TEST_EVENTS_PER_PRODUCER; ++value )
+		{
+			NamedProperties args;
+			args.SetValue( "producer", producer );
+			args.SetValue( "value", value );
+			eventSystem.QueueEvent( eventID, std::move( args ) );
+			if( value % 100 == 0 )
+			{
+				eventSystem.QueueEvent( "UnitTestQueuedOther" );
+			}
+		}
+	};
+	std::thread producerA( produce, 0 );
+	std::thread producerB( produce, 1 );
+
+	// draining while the producers run must only ever deliver whole, in-order prefixes
+	int numDrainsDuringProduction = 0;
+	while( s_deliveredValues[0].size() + s_deliveredValues[1].size() < 2 * NUM_TEST_EVENTS_PER_PRODUCER && numDrainsDuringProduction < 100000 )
+	{
+		eventSystem.DispatchQueuedEvents();
+		++numDrainsDuringProduction;
+	}
+	producerA.join();
+	producerB.join();
+	eventSystem.DispatchQueuedEvents();
+
+	for( int producer = 0; producer < 2; ++producer )
+	{
+		std::vector<int> const& values = s_deliveredValues[producer];
+		UNIT_TEST_CHECK_MSG( (int)values.size() == NUM_TEST_EVENTS_PER_PRODUCER,
+			Stringf( "producer %i: %i of %i events delivered", producer, (int)values.size(), NUM_TEST_EVENTS_PER_PRODUCER ) );
+		bool isInOrder = true;
+		for( int valueIdx = 0; valueIdx < (int)values.size(); ++valueIdx )
+		{
+			isInOrder = isInOrder && values[valueIdx] == valueIdx;
+		}
+		UNIT_TEST_CHECK_MSG( isInOrder, Stringf( "producer %i: events delivered out of order", producer ) );
+	}
+	UNIT_TEST_CHECK( s_numDeliveredOther == 2 * ( NUM_TEST_EVENTS_PER_PRODUCER / 100 ) );
+
+	// queued, not fired: nothing is delivered until the next drain
+	std::thread lateProducer( [&eventSystem]() {
+		NamedProperties args;
+		args.SetValue( "producer", 0 );
+		args.SetValue( "value", NUM_TEST_EVENTS_PER_PRODUCER );
+		eventSystem.QueueEvent( "UnitTestQueued", args );
+	} );
+	lateProducer.join();
+	UNIT_TEST_CHECK( (int)s_deliveredValues[0].size() == NUM_TEST_EVENTS_PER_PRODUCER );
+	UNIT_TEST_CHECK( eventSystem.GetNumQueuedEvents() == 1 );
+	eventSystem.DispatchQueuedEvents();
+	UNIT_TEST_CHECK( (int)s_deliveredValues[0].size() == NUM_TEST_EVENTS_PER_PRODUCER + 1 );
+	UNIT_TEST_CHECK( eventSystem.GetNumQueuedEvents() == 0 );
+}
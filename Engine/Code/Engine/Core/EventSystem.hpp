@@ -1,16 +1,21 @@
 #pragma once
 #include "Engine/Core/NamedStrings.hpp"
 #include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/LinearAllocator.hpp"
 #include <string>
 #include <vector>
+#include <map>
+#include <mutex>
 
 typedef unsigned int EntityID;
+typedef unsigned int EventID;
 typedef void(*EventCallbackFunctionPtrType)( NamedProperties& args );
 
 
 struct EventSubscription
 {
-	EventSubscription( std::string eventName, EventCallbackFunctionPtrType eventCallbackPtrType, const std::string& inputValue );
+	EventSubscription( std::string eventName, EventCallbackFunctionPtrType eventCallbackPtrType, const std::string& inputValue );	// static COMMAND registration
+	EventSubscription( std::string eventName, EventCallbackFunctionPtrType eventCallbackPtrType );	// runtime subscription; not registered
 	std::string m_eventName; // e.g, "Sunrise"
 	NamedProperties m_input;
 	EventCallbackFunctionPtrType m_callbackFuncPtr = nullptr;
@@ -23,6 +28,15 @@ struct EventSubscription
 	static EventSubscription name##_register( #name, name##_impl, inputA ); \
 	static void name##_impl( NamedProperties& args )
 
+//-------------------------------------------------------------------------------------------------------------
+// An event recorded by QueueEvent; lives in the event system's frame arena until dispatched
+struct QueuedEvent
+{
+	EventID			m_eventID = 0;
+	uint			m_sequence = 0;
+	NamedProperties	m_args;
+};
+
 class EventSystem
 {
 public:
@@ -32,9 +46,39 @@ public:
 	void StartUp();
 	void SubscribeToEvent( const std::string& eventName, EventCallbackFunctionPtrType eventCallbackPtrType );
 	void FireEvent( const std::string& eventName );
-	void FireEvent( const std::string& eventName, NamedProperties value );
+	void FireEvent( const std::string& eventName, NamedProperties& args );
 
 	void FireEventWithValue( const std::string& eventNameWithValue );
 
+	// Deferred events - safe to call from any thread (job workers, network threads, ...)
+	EventID	GetEventID( const std::string& eventName );
+	void	QueueEvent( const std::string& eventName );
+	void	QueueEvent( const std::string& eventName, NamedProperties const& args );
+	void	QueueEvent( EventID eventID, NamedProperties const& args );
+	void	QueueEvent( EventID eventID, NamedProperties&& args );
+
+	// Main thread only; delivers everything queued before the call, grouped by event ID
+	// and in queue order within a group. Events queued by the callbacks go out next dispatch.
+	void	DispatchQueuedEvents();
+	int		GetNumQueuedEvents();
+
 	std::vector< EventSubscription* > m_eventSubsrciptions;
+	std::vector< EventSubscription* > m_ownedSubscriptions;	// made by SubscribeToEvent; the COMMAND ones are static
+	std::recursive_mutex m_subscriptionsMutex;
+
+private:
+	void	GetSubscriptionsForEvent( const std::string& eventName, std::vector<EventSubscription*>& out_subscriptions );
+
+private:
+	// Producer side; m_queueMutex guards everything in this block
+	std::mutex						m_queueMutex;
+	std::map< std::string, EventID > m_eventIDsByName;
+	std::vector< std::string >		m_eventNamesByID;
+	LinearAllocator					m_queueArenas[2];
+	std::vector< QueuedEvent* >		m_queuedEvents[2];
+	int								m_recordingQueueIdx = 0;
+	uint							m_nextSequence = 0;
+
+	// Consumer side scratch, main thread only
+	std::vector< EventSubscription* > m_dispatchSubscriptions;
 };
@@ -1,5 +1,11 @@
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include <direct.h>
+#include <errno.h>
 #include <io.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/stat.h>
 
 Strings GetFileNamesInFolder( const FilePath& folderPath, const char* filePattern )
 {
@@ -19,3 +25,122 @@ Strings GetFileNamesInFolder( const FilePath& folderPath, const char* filePatter
 
 	return fileNamesInFolder;
 }
+
+bool WriteStringToFile( const FilePath& filePath, const std::string& contents )
+{
+	return WriteBufferToFile( filePath, contents.data(), contents.size() );
+}
+
+bool WriteBufferToFile( const FilePath& filePath, void const* data, size_t byteSize )
+{
+	FILE* fp = nullptr;
+	fopen_s( &fp, filePath.c_str(), "wb" );
+	if( fp == nullptr )
+	{
+		return false;
+	}
+
+	size_t numWritten = fwrite( data, 1, byteSize, fp );
+	fclose( fp );
+	return numWritten == byteSize;
+}
+
+bool ReadFileToBuffer( const FilePath& filePath, std::vector<uint8_t>& out_buffer )
+{
+	out_buffer.clear();
+
+	FILE* fp = nullptr;
+	fopen_s( &fp, filePath.c_str(), "rb" );
+	if( fp == nullptr )
+	{
+		return false;
+	}
+
+	_fseeki64( fp, 0, SEEK_END );
+	long long byteSize = _ftelli64( fp );
+	_fseeki64( fp, 0, SEEK_SET );
+	if( byteSize < 0 )
+	{
+		fclose( fp );
+		return false;
+	}
+
+	out_buffer.resize( (size_t)byteSize );
+	size_t numRead = byteSize > 0 ? fread( out_buffer.data(), 1, (size_t)byteSize, fp ) : 0;
+	fclose( fp );
+	return numRead == (size_t)byteSize;
+}
+
+bool OverwriteFileBytes( const FilePath& filePath, size_t byteOffset, void const* data, size_t byteSize )
+{
+	FILE* fp = nullptr;
+	fopen_s( &fp, filePath.c_str(), "r+b" );
+	if( fp == nullptr )
+	{
+		return false;
+	}
+
+	_fseeki64( fp, 0, SEEK_END );
+	long long fileByteSize = _ftelli64( fp );
+	if( fileByteSize < 0 || (unsigned long long)fileByteSize < (unsigned long long)( byteOffset + byteSize ) )
+	{
+		fclose( fp );
+		return false;
+	}
+
+	_fseeki64( fp, (long long)byteOffset, SEEK_SET );
+	size_t numWritten = fwrite( data, 1, byteSize, fp );
+	fclose( fp );
+	return numWritten == byteSize;
+}
+
+bool CreateFolders( const FilePath& folderPath )
+{
+	for( size_t separator = folderPath.find_first_of( "/\\" ); ; separator = folderPath.find_first_of( "/\\", separator + 1 ) )
+	{
+		FilePath parentPath = folderPath.substr( 0, separator );
+		bool isDriveOrRoot = parentPath.empty() || parentPath.back() == ':';
+		if( !isDriveOrRoot && _mkdir( parentPath.c_str() ) != 0 && errno != EEXIST )
+		{
+			return false;
+		}
+		if( separator == std::string::npos )
+		{
+			return true;
+		}
+	}
+}
+
+FilePath GetUserCacheFolder( const char* subFolder )
+{
+	FilePath root;
+	char* localAppData = nullptr;
+	size_t length = 0;
+	if( _dupenv_s( &localAppData, &length, "LOCALAPPDATA" ) == 0 && localAppData != nullptr )
+	{
+		root = localAppData;
+		root += "/";
+	}
+	free( localAppData );
+
+	// no per-user folder (headless tools, other platforms): next to the working directory, still outside Data
+	FilePath folderPath = root + g_gameConfigBlackboard.GetValue( "appName", "Engine" ) + "/Cache/" + subFolder + "/";
+	if( !CreateFolders( folderPath ) )
+	{
+		return FilePath();
+	}
+	return folderPath;
+}
+
+bool GetFileSizeAndWriteTime( const FilePath& filePath, uint64_t& out_byteSize, uint64_t& out_writeTime )
+{
+	struct _stat64 fileStatus;
+	if( _stat64( filePath.c_str(), &fileStatus ) != 0 )
+	{
+		return false;
+	}
+
+	out_byteSize = (uint64_t)fileStatus.st_size;
+	out_writeTime = (uint64_t)fileStatus.st_mtime;
+	return true;
+}
@@ -1,7 +1,23 @@
 #pragma once
 #include "Engine/Core/StringUtils.hpp"
+#include <cstdint>
+#include <vector>
 
 typedef std::string FilePath;
 
 Strings GetFileNamesInFolder( const FilePath& folderPath, const char* filePattern = nullptr );
- 
\ No newline at end of file
+ 
+bool	WriteStringToFile( const FilePath& filePath, const std::string& contents );
+bool	WriteBufferToFile( const FilePath& filePath, void const* data, size_t byteSize );
+bool	ReadFileToBuffer( const FilePath& filePath, std::vector<uint8_t>& out_buffer );
+bool	OverwriteFileBytes( const FilePath& filePath, size_t byteOffset, void const* data, size_t byteSize );	// in place; the file must already be that long
+
+// Creates every missing folder along the path
+bool	CreateFolders( const FilePath& folderPath );
+
+// Per-user, writable folder for derived data (cooked meshes, PVS, ...), never the shipped Data tree:
+// %LOCALAPPDATA%/<appName>/Cache/<subFolder>/, with appName from the game config. Created on first use.
+FilePath GetUserCacheFolder( const char* subFolder );
+
+// Cheap staleness check: no file contents are read
+bool	GetFileSizeAndWriteTime( const FilePath& filePath, uint64_t& out_byteSize, uint64_t& out_writeTime );
@@ -1,5 +1,6 @@
 #include "Engine/Core/JobSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Profiler.hpp"
 #include "Game/GameCommon.hpp"	// #ToDo: Don't include game related header in engine code
 
 extern JobSystem*	g_theJobSystem;
@@ -23,6 +24,7 @@ void JobSystemWorkerThread::WorkThreadMain( int threadID )
 {
 	//g_theConsole->Printf( "Started worker thread %i...", threadID );
 	printf( "Started worker thread #%i...\n", threadID );
+	PROFILER_SET_THREAD_NAME( Stringf( "Job Worker %i", threadID ).c_str() );
 
 	while( !g_theJobSystem->IsQuitting() )
 	{
@@ -33,8 +35,10 @@ void JobSystemWorkerThread::WorkThreadMain( int threadID )
 			Job* jobAtFrontOfQueue = g_theJobSystem->m_jobsQueued.front();
 			g_theJobSystem->m_jobsQueued.pop_front();
 			g_theJobSystem->m_jobsQueuedMutex.unlock();
-			printf( "Thread #%i is working on job#%i\n", threadID, jobAtFrontOfQueue->m_jobID );
-			jobAtFrontOfQueue->Execute();
+			{
+				PROFILE_SCOPE( "Job::Execute" );
+				jobAtFrontOfQueue->Execute();
+			}
 			g_theJobSystem->OnJobCompleted( jobAtFrontOfQueue );
 		}
 		else
@@ -63,19 +67,30 @@ JobSystem::~JobSystem()
 void JobSystem::StartUp()
 {
 	StartWorkerThreads();
-
-	//Sleep( 5000 );
-
-	StopWorkerThreads();
 }
 
+//-------------------------------------------------------------------------------------------------------------
+// Called last, after every system that waits on its own jobs has shut down
+//-------------------------------------------------------------------------------------------------------------
 void JobSystem::ShutDown()
 {
+	StopWorkerThreads();
+	ClaimAndDeleteAllCompletedJobs();
+
+	// Nothing is left to run these, and whoever posted them is already gone
+	m_jobsQueuedMutex.lock();
+	for( Job* job : m_jobsQueued )
+	{
+		delete job;
+	}
+	m_jobsQueued.clear();
+	m_jobsQueuedMutex.unlock();
 }
 
 //-------------------------------------------------------------------------------------------------------------
 void JobSystem::StartWorkerThreads()
 {
+	m_isQuitting = false;
 	m_workerThreads.reserve( NUM_WORKER_THREADS );
 	for( int i = 0; i < NUM_WORKER_THREADS; ++i )
 	{
@@ -88,16 +103,17 @@ void JobSystem::StartWorkerThreads()
 void JobSystem::StopWorkerThreads()
 {
 	m_isQuitting = true;
-	for( int i = 0; i < NUM_WORKER_THREADS; ++i )
+	for( int i = 0; i < (int)m_workerThreads.size(); ++i )
 	{
 		m_workerThreads[i]->m_threadObject->join();
 	}
 
-	for( int i = 0; i < NUM_WORKER_THREADS; ++i )
+	for( int i = 0; i < (int)m_workerThreads.size(); ++i )
 	{
 		delete m_workerThreads[i];
 		m_workerThreads[i] = nullptr;
 	}
+	m_workerThreads.clear();
 }
 
 //-------------------------------------------------------------------------------------------------------------
@@ -110,6 +126,12 @@ void JobSystem::PostJob( Job* job )
 
 void JobSystem::OnJobCompleted( Job* job )
 {
+	if( job->m_jobFlags & JOB_FLAG_DELETE_ON_COMPLETE )
+	{
+		delete job;
+		return;
+	}
+
 	m_jobsCompletedMutex.lock();
 	m_jobsCompleted.push_back( job );
 	m_jobsCompletedMutex.unlock();
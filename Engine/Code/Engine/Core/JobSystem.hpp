@@ -5,6 +5,12 @@
 #include <atomic>
 #include <thread>
 
+//-------------------------------------------------------------------------------------------------------------
+enum eJobFlag : unsigned int
+{
+	JOB_FLAG_DELETE_ON_COMPLETE = 1 << 0,	// no callback to deliver; the worker deletes the job once Execute returns
+};
+
 //-------------------------------------------------------------------------------------------------------------
 class Job
 {
@@ -17,7 +23,7 @@ public:
 //protected:
 	int				m_jobID = 0;
 	//unsigned int	m_jobType = 0;
-	//unsigned int	m_jobFlags = 0;
+	unsigned int	m_jobFlags = 0;
 };
 
 //-------------------------------------------------------------------------------------------------------------
@@ -69,6 +75,7 @@ public:
 	Job*	GetBestAvailableJob();
 	
 	bool	IsQuitting() const { return m_isQuitting; }
+	bool	AreWorkersRunning() const { return !m_isQuitting && !m_workerThreads.empty(); }
 
 //protected:
 public:
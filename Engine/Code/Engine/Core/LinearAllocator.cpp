@@ -0,0 +1,87 @@
+#include "Engine/Core/LinearAllocator.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <utility>
+
+//-------------------------------------------------------------------------------------------------------------
+LinearAllocator::LinearAllocator( size_t blockSizeBytes )
+	:m_blockSizeBytes( blockSizeBytes )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------
+LinearAllocator::~LinearAllocator()
+{
+	for( int blockIdx = 0; blockIdx < (int)m_blocks.size(); ++blockIdx )
+	{
+		delete[] m_blocks[blockIdx].m_data;
+		m_blocks[blockIdx].m_data = nullptr;
+	}
+	m_blocks.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void* LinearAllocator::Allocate( size_t numBytes, size_t alignment )
+{
+	GUARANTEE_OR_DIE( alignment != 0 && ( alignment & ( alignment - 1 ) ) == 0, "LinearAllocator alignment must be a power of two" );
+
+	// worst case padding is alignment - 1, so reserve for it when picking a block
+	size_t worstCaseBytes = numBytes + alignment - 1;
+	if( m_currentBlockIdx < 0 || m_currentOffset + worstCaseBytes > m_blocks[m_currentBlockIdx].m_sizeBytes )
+	{
+		AdvanceToNextBlock( worstCaseBytes );
+	}
+
+	Block& block = m_blocks[m_currentBlockIdx];
+	size_t address = reinterpret_cast<size_t>( block.m_data ) + m_currentOffset;
+	size_t alignedAddress = ( address + alignment - 1 ) & ~( alignment - 1 );
+	size_t padding = alignedAddress - address;
+
+	m_currentOffset += padding + numBytes;
+	m_bytesUsed += padding + numBytes;
+	return reinterpret_cast<void*>( alignedAddress );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void LinearAllocator::Reset()
+{
+	m_currentBlockIdx = m_blocks.empty() ? -1 : 0;
+	m_currentOffset = 0;
+	m_bytesUsed = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+size_t LinearAllocator::GetBytesReserved() const
+{
+	size_t totalBytes = 0;
+	for( int blockIdx = 0; blockIdx < (int)m_blocks.size(); ++blockIdx )
+	{
+		totalBytes += m_blocks[blockIdx].m_sizeBytes;
+	}
+	return totalBytes;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void LinearAllocator::AdvanceToNextBlock( size_t minBytes )
+{
+	// reuse blocks kept from previous frames if they are big enough
+	for( int blockIdx = m_currentBlockIdx + 1; blockIdx < (int)m_blocks.size(); ++blockIdx )
+	{
+		if( m_blocks[blockIdx].m_sizeBytes >= minBytes )
+		{
+			if( blockIdx != m_currentBlockIdx + 1 )
+			{
+				std::swap( m_blocks[blockIdx], m_blocks[m_currentBlockIdx + 1] );
+			}
+			m_currentBlockIdx++;
+			m_currentOffset = 0;
+			return;
+		}
+	}
+
+	Block newBlock;
+	newBlock.m_sizeBytes = ( minBytes > m_blockSizeBytes ) ? minBytes : m_blockSizeBytes;
+	newBlock.m_data = new unsigned char[newBlock.m_sizeBytes];
+	m_blocks.insert( m_blocks.begin() + ( m_currentBlockIdx + 1 ), newBlock );
+	m_currentBlockIdx++;
+	m_currentOffset = 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+// Bump allocator that hands out memory from a list of fixed size blocks.
+// Nothing is freed individually; Reset() rewinds to the first block and keeps every block for reuse,
+// so once it has grown to a frame's high-water mark it stops touching the heap.
+// Not thread-safe - the owner is responsible for locking.
+//-------------------------------------------------------------------------------------------------------------
+class LinearAllocator
+{
+public:
+	explicit LinearAllocator( size_t blockSizeBytes = 64 * 1024 );
+	~LinearAllocator();
+
+	LinearAllocator( LinearAllocator const& ) = delete;
+	LinearAllocator& operator=( LinearAllocator const& ) = delete;
+
+	void*	Allocate( size_t numBytes, size_t alignment = alignof( std::max_align_t ) );
+	void	Reset();
+
+	size_t	GetBytesUsed() const			{ return m_bytesUsed; }
+	size_t	GetBytesReserved() const;
+
+private:
+	void	AdvanceToNextBlock( size_t minBytes );
+
+private:
+	struct Block
+	{
+		unsigned char*	m_data = nullptr;
+		size_t			m_sizeBytes = 0;
+	};
+
+	std::vector<Block>	m_blocks;
+	size_t				m_blockSizeBytes = 0;
+	int					m_currentBlockIdx = -1;
+	size_t				m_currentOffset = 0;
+	size_t				m_bytesUsed = 0;
+};
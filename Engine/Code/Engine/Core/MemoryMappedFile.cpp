@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------------------------
+// MemoryMappedFile.cpp
+//
+
+//-----------------------------------------------------------------------------------------------
+#include "Engine/Core/MemoryMappedFile.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+
+//-----------------------------------------------------------------------------------------------
+MemoryMappedFile::~MemoryMappedFile()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------------------------
+bool MemoryMappedFile::Open( char const* filePath )
+{
+	Close();
+
+	HANDLE file = CreateFileA( filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+	if( file == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+	m_fileHandle = file;
+
+	// an empty file can't be mapped; there is nothing to read from it anyway
+	LARGE_INTEGER fileSize;
+	if( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart <= 0 || (unsigned long long)fileSize.QuadPart > (size_t)-1 ) {
+		Close();
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	if( mapping == nullptr ) {
+		Close();
+		return false;
+	}
+	m_mappingHandle = mapping;
+
+	m_data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	if( m_data == nullptr ) {
+		Close();
+		return false;
+	}
+	m_size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+void MemoryMappedFile::Close()
+{
+	if( m_data != nullptr ) {
+		UnmapViewOfFile( m_data );
+		m_data = nullptr;
+	}
+	if( m_mappingHandle != nullptr ) {
+		CloseHandle( (HANDLE)m_mappingHandle );
+		m_mappingHandle = nullptr;
+	}
+	if( m_fileHandle != nullptr ) {
+		CloseHandle( (HANDLE)m_fileHandle );
+		m_fileHandle = nullptr;
+	}
+	m_size = 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+//-----------------------------------------------------------------------------------------------
+// MemoryMappedFile.hpp
+//
+// Read-only view of a whole file, mapped into the address space instead of read into a buffer.
+// Pages are faulted in as they are touched, so "opening" a large file costs a few system calls
+// and the data can be handed to the GPU straight from the mapping. The view is page aligned.
+//
+#include <cstddef>
+
+
+//-----------------------------------------------------------------------------------------------
+class MemoryMappedFile
+{
+public:
+	MemoryMappedFile() {}
+	~MemoryMappedFile();
+
+	MemoryMappedFile( MemoryMappedFile const& ) = delete;
+	MemoryMappedFile& operator=( MemoryMappedFile const& ) = delete;
+
+	bool		Open( char const* filePath );		// closes any file already open; false if it can't be mapped
+	void		Close();
+
+	bool		IsOpen() const				{ return m_data != nullptr; }
+	void const*	GetData() const				{ return m_data; }
+	size_t		GetSize() const				{ return m_size; }
+
+private:
+	void*		m_fileHandle = nullptr;
+	void*		m_mappingHandle = nullptr;
+	void const*	m_data = nullptr;
+	size_t		m_size = 0;
+};
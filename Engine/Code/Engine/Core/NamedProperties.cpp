@@ -1,10 +1,205 @@
 #include "NamedProperties.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
+//------------------------------------------------------------------------
+// Key interning. Names are found by hash, then compared in place, so a
+// lookup never builds a std::string; lookups share the lock, interning
+// takes it alone.
+//------------------------------------------------------------------------
+constexpr uint NO_PROPERTY_KEY = 0xffffffff;
 
+static std::shared_timed_mutex				s_propertyKeyMutex;
+static std::unordered_map<uint64_t, uint>	s_firstPropertyKeyForHash;
+static std::vector<uint>					s_nextPropertyKeyWithSameHash;
+static std::vector<std::string*>			s_propertyKeyNames;	// pointers stay valid as the table grows
+
+
+//------------------------------------------------------------------------
+static uint64_t HashPropertyKeyName( PropertyKeyName keyName )
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for( size_t charIdx = 0; charIdx < keyName.m_length; ++charIdx ) {
+		hash = ( hash ^ (unsigned char)keyName.m_chars[charIdx] ) * 1099511628211ull;
+	}
+	return hash;
+}
+
+//------------------------------------------------------------------------
+// Caller holds s_propertyKeyMutex, shared or not
+static uint FindPropertyKeyID( PropertyKeyName keyName, uint64_t hash )
+{
+	auto found = s_firstPropertyKeyForHash.find( hash );
+	uint keyID = found != s_firstPropertyKeyForHash.end() ? found->second : NO_PROPERTY_KEY;
+	while( keyID != NO_PROPERTY_KEY ) {
+		std::string const& name = *s_propertyKeyNames[keyID];
+		if( name.size() == keyName.m_length && std::memcmp( name.data(), keyName.m_chars, keyName.m_length ) == 0 ) {
+			return keyID;
+		}
+		keyID = s_nextPropertyKeyWithSameHash[keyID];
+	}
+	return NO_PROPERTY_KEY;
+}
+
+//------------------------------------------------------------------------
+PropertyKey PropertyKey::Intern( PropertyKeyName keyName )
+{
+	PropertyKey key;
+	if( Find( keyName, key ) ) {
+		return key;
+	}
+
+	std::unique_lock<std::shared_timed_mutex> keyLock( s_propertyKeyMutex );
+	uint64_t hash = HashPropertyKeyName( keyName );
+	key.m_id = FindPropertyKeyID( keyName, hash );	// someone may have beaten us to it
+	if( key.m_id != NO_PROPERTY_KEY ) {
+		return key;
+	}
+
+	key.m_id = (uint)s_propertyKeyNames.size();
+	auto found = s_firstPropertyKeyForHash.find( hash );
+	s_nextPropertyKeyWithSameHash.push_back( found != s_firstPropertyKeyForHash.end() ? found->second : NO_PROPERTY_KEY );
+	s_firstPropertyKeyForHash[hash] = key.m_id;
+	s_propertyKeyNames.push_back( new std::string( keyName.m_chars, keyName.m_length ) );
+	return key;
+}
+
+//------------------------------------------------------------------------
+bool PropertyKey::Find( PropertyKeyName keyName, PropertyKey& out_key )
+{
+	uint64_t hash = HashPropertyKeyName( keyName );
+	std::shared_lock<std::shared_timed_mutex> keyLock( s_propertyKeyMutex );
+	uint keyID = FindPropertyKeyID( keyName, hash );
+	if( keyID == NO_PROPERTY_KEY ) {
+		return false;
+	}
+
+	out_key.m_id = keyID;
+	return true;
+}
+
+//------------------------------------------------------------------------
+std::string const& PropertyKey::GetName() const
+{
+	std::shared_lock<std::shared_timed_mutex> keyLock( s_propertyKeyMutex );
+	return *s_propertyKeyNames[m_id];
+}
+
+
+//------------------------------------------------------------------------
+// NamedProperties
+//------------------------------------------------------------------------
+NamedProperties::NamedProperties( NamedProperties const& other )
+{
+	*this = other;
+}
+
+//------------------------------------------------------------------------
+NamedProperties::NamedProperties( NamedProperties&& other )
+{
+	*this = std::move( other );
+}
+
+//------------------------------------------------------------------------
+NamedProperties& NamedProperties::operator=( NamedProperties const& other )
+{
+	if( this == &other ) {
+		return *this;
+	}
+
+	Clear();
+	m_numProperties = other.m_numProperties;
+	if( other.m_overflowProperties.empty() ) {
+		std::copy( other.m_inlineProperties, other.m_inlineProperties + other.m_numProperties, m_inlineProperties );
+	}
+	else {
+		m_overflowProperties.assign( other.m_overflowProperties.begin(), other.m_overflowProperties.end() );
+	}
+
+	// the byte copy above only moved keys and types along; copy-construct the inline values properly
+	Property* properties = GetProperties();
+	Property const* otherProperties = other.GetProperties();
+	for( int propIdx = 0; propIdx < m_numProperties; ++propIdx ) {
+		PropertyType const* type = properties[propIdx].m_type;
+		if( type->m_copy ) {
+			type->m_copy( properties[propIdx].m_inlineValue, otherProperties[propIdx].m_inlineValue );
+		}
+	}
+
+	// string slots keep their indices, reuse our own string capacity where we can
+	if( (int)m_strings.size() < other.m_numStringsUsed ) {
+		m_strings.resize( other.m_numStringsUsed );
+	}
+	for( int stringIdx = 0; stringIdx < other.m_numStringsUsed; ++stringIdx ) {
+		m_strings[stringIdx] = other.m_strings[stringIdx];
+	}
+	m_numStringsUsed = other.m_numStringsUsed;
+	m_freeStringSlots = other.m_freeStringSlots;
+	return *this;
+}
+
+//------------------------------------------------------------------------
+NamedProperties& NamedProperties::operator=( NamedProperties&& other )
+{
+	if( this == &other ) {
+		return *this;
+	}
+
+	// values are relocated, not copied; other gives up ownership without destroying them
+	Clear();
+	m_numProperties = other.m_numProperties;
+	std::copy( other.m_inlineProperties, other.m_inlineProperties + NUM_INLINE_PROPERTIES, m_inlineProperties );
+	m_overflowProperties.swap( other.m_overflowProperties );
+	m_strings.swap( other.m_strings );
+	m_numStringsUsed = other.m_numStringsUsed;
+	m_freeStringSlots.swap( other.m_freeStringSlots );
+
+	other.m_numProperties = 0;
+	other.m_overflowProperties.clear();
+	other.m_numStringsUsed = 0;
+	other.m_freeStringSlots.clear();
+	for( int stringIdx = 0; stringIdx < (int)other.m_strings.size(); ++stringIdx ) {
+		other.m_strings[stringIdx].clear();
+	}
+	return *this;
+}
+
+//------------------------------------------------------------------------
+void NamedProperties::Clear()
+{
+	Property* properties = GetProperties();
+	for( int propIdx = 0; propIdx < m_numProperties; ++propIdx ) {
+		DestroyValue( properties[propIdx] );
+	}
+
+	m_numProperties = 0;
+	m_overflowProperties.clear();
+	for( int stringIdx = 0; stringIdx < m_numStringsUsed; ++stringIdx ) {
+		m_strings[stringIdx].clear();
+	}
+	m_numStringsUsed = 0;
+	m_freeStringSlots.clear();
+}
+
+//------------------------------------------------------------------------
+void NamedProperties::ResetValues()
+{
+	Property* properties = GetProperties();
+	for( int propIdx = 0; propIdx < m_numProperties; ++propIdx ) {
+		SetValue( properties[propIdx].m_key, std::string() );
+	}
+}
+
+//------------------------------------------------------------------------
 void NamedProperties::PopulateFromEvent( const std::string& commandInputWithValue )
 {
 	Strings strings = SplitStringOnDelimiter( commandInputWithValue, ' ' );
-	
+
 	if( strings.size() <= 1 )
 	{
 		return;
@@ -12,3 +207,139 @@ void NamedProperties::PopulateFromEvent( const std::string& commandInputWithValu
 
 	SetValue( strings[0], strings[1].c_str() );
 }
+
+//------------------------------------------------------------------------
+void NamedProperties::SetValue( PropertyKey key, std::string const& value )
+{
+	Property& prop = FindOrAddProperty( key );
+	if( prop.m_type != GetStringPropertyType() ) {
+		DestroyValue( prop );
+
+		// claim a string slot, preferring one a type change gave back
+		int stringIdx = 0;
+		if( !m_freeStringSlots.empty() ) {
+			stringIdx = m_freeStringSlots.back();
+			m_freeStringSlots.pop_back();
+		}
+		else {
+			stringIdx = m_numStringsUsed++;
+			if( stringIdx >= (int)m_strings.size() ) {
+				m_strings.emplace_back();
+			}
+		}
+		prop.m_type = GetStringPropertyType();
+		std::memcpy( prop.m_inlineValue, &stringIdx, sizeof( stringIdx ) );
+	}
+
+	int stringIdx = 0;
+	std::memcpy( &stringIdx, prop.m_inlineValue, sizeof( stringIdx ) );
+	m_strings[stringIdx].assign( value );
+}
+
+//------------------------------------------------------------------------
+std::string NamedProperties::GetValue( PropertyKey key, std::string const& defValue ) const
+{
+	Property const* prop = FindProperty( key );
+	if( nullptr == prop ) {
+		return defValue;
+	}
+	else if( prop->m_type == GetStringPropertyType() ) {
+		return GetStringValue( *prop );
+	}
+	else {
+		return prop->m_type->m_toString( prop->m_inlineValue );
+	}
+}
+
+//------------------------------------------------------------------------
+std::string NamedProperties::GetValue( PropertyKeyName keyName, std::string const& defValue ) const
+{
+	PropertyKey key;
+	if( !PropertyKey::Find( keyName, key ) ) {
+		return defValue;
+	}
+	return GetValue( key, defValue );
+}
+
+//------------------------------------------------------------------------
+std::string NamedProperties::GetValue( PropertyKeyName keyName, char const* val ) const
+{
+	PropertyKey key;
+	if( !PropertyKey::Find( keyName, key ) ) {
+		return std::string( val );
+	}
+	return GetValue( key, std::string( val ) );
+}
+
+//------------------------------------------------------------------------
+PropertyType const* NamedProperties::GetStringPropertyType()
+{
+	// string values only ever get converted through GetStringValue
+	static PropertyType const s_type = { nullptr, nullptr, nullptr };
+	return &s_type;
+}
+
+//------------------------------------------------------------------------
+NamedProperties::Property const* NamedProperties::FindProperty( PropertyKey key ) const
+{
+	Property const* first = GetProperties();
+	Property const* last = first + m_numProperties;
+	Property const* found = std::lower_bound( first, last, key, []( Property const& prop, PropertyKey k ) { return prop.m_key < k; } );
+	if( found != last && found->m_key == key ) {
+		return found;
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------
+NamedProperties::Property& NamedProperties::FindOrAddProperty( PropertyKey key )
+{
+	Property* first = GetProperties();
+	Property* last = first + m_numProperties;
+	Property* found = std::lower_bound( first, last, key, []( Property const& prop, PropertyKey k ) { return prop.m_key < k; } );
+	if( found != last && found->m_key == key ) {
+		return *found;
+	}
+
+	int insertIdx = (int)( found - first );
+	Property newProp;
+	newProp.m_key = key;
+
+	if( m_overflowProperties.empty() && m_numProperties < NUM_INLINE_PROPERTIES ) {
+		std::copy_backward( m_inlineProperties + insertIdx, m_inlineProperties + m_numProperties, m_inlineProperties + m_numProperties + 1 );
+		m_inlineProperties[insertIdx] = newProp;
+		m_numProperties++;
+		return m_inlineProperties[insertIdx];
+	}
+
+	if( m_overflowProperties.empty() ) {
+		// outgrew the inline storage, move everything over
+		m_overflowProperties.assign( m_inlineProperties, m_inlineProperties + m_numProperties );
+	}
+	m_overflowProperties.insert( m_overflowProperties.begin() + insertIdx, newProp );
+	m_numProperties++;
+	return m_overflowProperties[insertIdx];
+}
+
+//------------------------------------------------------------------------
+std::string const& NamedProperties::GetStringValue( Property const& prop ) const
+{
+	int stringIdx = 0;
+	std::memcpy( &stringIdx, prop.m_inlineValue, sizeof( stringIdx ) );
+	return m_strings[stringIdx];
+}
+
+//------------------------------------------------------------------------
+void NamedProperties::DestroyValue( Property& prop )
+{
+	if( prop.m_type == GetStringPropertyType() ) {
+		int stringIdx = 0;
+		std::memcpy( &stringIdx, prop.m_inlineValue, sizeof( stringIdx ) );
+		m_strings[stringIdx].clear();
+		m_freeStringSlots.push_back( stringIdx );
+	}
+	else if( prop.m_type && prop.m_type->m_destroy ) {
+		prop.m_type->m_destroy( prop.m_inlineValue );
+	}
+	prop.m_type = nullptr;
+}
@@ -1,168 +1,205 @@
 #pragma once
 #include "Engine/Core/StringUtils.hpp"
+#include <cstring>
 #include <string>
-#include <map>
+#include <type_traits>
+#include <vector>
+#include <new>
 
 //------------------------------------------------------------------------
+// A key name as passed in, either a std::string or a C string; never copied
 //------------------------------------------------------------------------
-class TypedPropertyBase
+struct PropertyKeyName
 {
 public:
-	virtual ~TypedPropertyBase() {}
+	PropertyKeyName( std::string const& name )	: m_chars( name.c_str() ), m_length( name.size() ) {}
+	PropertyKeyName( char const* name )			: m_chars( name ), m_length( std::strlen( name ) ) {}
 
-	virtual std::string GetAsString() const = 0;
-	virtual void const* GetUniqueID() const = 0;
-
-	template <typename T>
-	bool Is() const;
+public:
+	char const*	m_chars = nullptr;
+	size_t		m_length = 0;
 };
 
 //------------------------------------------------------------------------
+// Keys are interned once into a process-wide table (thread-safe), so a
+// property lookup compares integers instead of strings. Only setting a value
+// interns its key; getting one by name just looks the key up, since a name
+// that was never interned cannot be in any bag.
+// Hot paths can cache the key: static PropertyKey s_colorKey = PropertyKey::Intern( "color" );
 //------------------------------------------------------------------------
-template <typename VALUE_TYPE>
-class TypedProperty : public TypedPropertyBase
+struct PropertyKey
 {
 public:
-	virtual std::string GetAsString() const final { return ToString( m_value ).c_str(); }
-	virtual void const* GetUniqueID() const final { return StaticUniqueID(); }
+	static PropertyKey	Intern( PropertyKeyName keyName );
+	static bool			Find( PropertyKeyName keyName, PropertyKey& out_key );	// false if never interned
+	std::string const&	GetName() const;
 
-public:
-	// std::string m_key;
-	VALUE_TYPE m_value;
+	bool operator==( PropertyKey const& other ) const	{ return m_id == other.m_id; }
+	bool operator<( PropertyKey const& other ) const	{ return m_id < other.m_id; }
 
 public:
-	static void const* const StaticUniqueID()
-	{
-		static int s_local = 0;
-		return &s_local;
-	}
+	uint m_id = 0;
 };
 
+//------------------------------------------------------------------------
+// Per-type info shared by every property of that type. The address of the
+// struct doubles as the type's unique id (works without RTTI).
+//------------------------------------------------------------------------
+struct PropertyType
+{
+	std::string (*m_toString)( void const* data ) = nullptr;
+	void		(*m_copy)( void* dst, void const* src ) = nullptr;
+	void		(*m_destroy)( void* data ) = nullptr;
+};
 
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
 class NamedProperties
 {
+public:
+	// Values up to this size are stored inside the property itself
+	static constexpr int INLINE_VALUE_BYTES = 16;
+	// Bags with up to this many properties never touch the heap (strings aside)
+	static constexpr int NUM_INLINE_PROPERTIES = 4;
+
 public:
 	//------------------------------------------------------------------------
-	~NamedProperties()
-	{
-		for( auto iter : m_keyValuePairs ) {
-			delete iter.second;
-		}
+	NamedProperties() = default;
+	NamedProperties( NamedProperties const& other );
+	NamedProperties( NamedProperties&& other );
+	NamedProperties& operator=( NamedProperties const& other );
+	NamedProperties& operator=( NamedProperties&& other );
+	~NamedProperties()	{ Clear(); }
 
-		m_keyValuePairs.clear();
-	}
 	//------------------------------------------------------------------------
-	void ResetValues()
-	{
-		for( auto iter : m_keyValuePairs )
-		{
-			SetValue( iter.first, "" );
-		}
-	}
+	// Removes every property but keeps the storage, so the bag can be reused
+	void Clear();
 
+	// Keeps the keys, sets every value to an empty string
+	void ResetValues();
 
-	//------------------------------------------------------------------------
+	int	 GetNumProperties() const	{ return m_numProperties; }
 
-	 void PopulateFromEvent( const std::string& commandInputWithValue );
+	//------------------------------------------------------------------------
+	void PopulateFromEvent( const std::string& commandInputWithValue );
 
 	//------------------------------------------------------------------------
 	// for everything else, there's templates!
+	// T must fit inline (<= INLINE_VALUE_BYTES, and trivially copyable since moves relocate values with a byte copy),
+	// or be a std::string
 	template <typename T>
-	void SetValue( std::string const& keyName, T const& value )
+	void SetValue( PropertyKey key, T const& value )
 	{
-		TypedPropertyBase* base = FindInMap( keyName );
-		if( base == nullptr ) {
-			// doesn't exist, make a new one            
-			TypedProperty<T>* prop = new TypedProperty<T>();
-			prop->m_value = value;
-			m_keyValuePairs[keyName] = prop;
+		static_assert( sizeof( T ) <= INLINE_VALUE_BYTES && alignof( T ) <= alignof( double ) && std::is_trivially_copyable<T>::value,
+			"NamedProperties only stores small, trivially copyable values inline; use std::string for anything else" );
 
-		}
-		else {
-			// it exists?
-			if( base->Is<T>() ) {
-				TypedProperty<T>* prop = (TypedProperty<T>*)base;
-				prop->m_value = value;
-			}
-			else {
-				// not the same thing
-				// delete and remake
-				delete base;
-
-				// doesn't exist, make a new one            
-				TypedProperty<T>* prop = new TypedProperty<T>();
-				prop->m_value = value;
-				m_keyValuePairs[keyName] = prop;
-			}
-		} 
+		Property& prop = FindOrAddProperty( key );
+		DestroyValue( prop );
+		prop.m_type = GetPropertyType<T>();
+		new( prop.m_inlineValue ) T( value );
+	}
+
+	template <typename T>
+	void SetValue( PropertyKeyName keyName, T const& value )
+	{
+		SetValue<T>( PropertyKey::Intern( keyName ), value );
 	}
 
 	//------------------------------------------------------------------------
 	template <typename T>
-	T GetValue( std::string const& keyName, T const& defValue ) const
+	T GetValue( PropertyKey key, T const& defValue ) const
 	{
-		TypedPropertyBase* base = FindInMap( keyName );
-		if( nullptr != base ) {
-
-			// this works WITHOUT RTTI enabled
-			// but will not work if prop is inherited from T
-			if( base->Is<T>() ) {
-				// make sure this is safe!  how....?
-				TypedProperty<T>* prop = (TypedProperty<T>*)base;
-				return prop->m_value;
-			}
-			else {
-				std::string strValue = base->GetAsString();
-				return GetValueFromString( strValue.c_str(), defValue );
-			}
+		Property const* prop = FindProperty( key );
+		if( nullptr == prop ) { // failed to find
+			return defValue;
+		}
+
+		if( prop->m_type == GetStringPropertyType() ) {
+			// commands store everything as strings; parse without building a new one
+			return GetValueFromString( GetStringValue( *prop ).c_str(), defValue );
+		}
+		else if( prop->m_type == GetPropertyType<T>() ) {
+			return *reinterpret_cast<T const*>( prop->m_inlineValue );
+		}
+		else {
+			std::string strValue = prop->m_type->m_toString( prop->m_inlineValue );
+			return GetValueFromString( strValue.c_str(), defValue );
 		}
-		else { // failed to find
+	}
+
+	template <typename T>
+	T GetValue( PropertyKeyName keyName, T const& defValue ) const
+	{
+		PropertyKey key;
+		if( !PropertyKey::Find( keyName, key ) ) {
 			return defValue;
 		}
+		return GetValue<T>( key, defValue );
 	}
 
 	//------------------------------------------------------------------------
-	// specialized for char const
-	void SetValue( std::string const& keyname, char const* val )
+	// specialized for strings; the only values stored out of line
+	void SetValue( PropertyKey key, std::string const& value );
+	void SetValue( PropertyKeyName keyName, std::string const& value )	{ SetValue( PropertyKey::Intern( keyName ), value ); }
+	void SetValue( PropertyKeyName keyName, char const* val )			{ SetValue( PropertyKey::Intern( keyName ), std::string( val ) ); }
+
+	std::string GetValue( PropertyKey key, std::string const& defValue ) const;
+	std::string GetValue( PropertyKeyName keyName, std::string const& defValue ) const;
+	std::string GetValue( PropertyKeyName keyName, char const* val ) const;
+
+private:
+	//------------------------------------------------------------------------
+	struct Property
 	{
-		SetValue<std::string>( keyname, val );
-	}
+		PropertyKey			m_key;
+		PropertyType const*	m_type = nullptr;
+		alignas( double ) unsigned char m_inlineValue[INLINE_VALUE_BYTES];	// the value, or an index into m_strings
+	};
 
 	//------------------------------------------------------------------------
-	std::string GetValue( std::string const& keyName, char const* val ) const
+	template <typename T>
+	static std::string InlineValueToString( void const* data )
 	{
- 		return GetValue<std::string>( keyName, val );
+		return ToString( *reinterpret_cast<T const*>( data ) );
 	}
 
-private:
-	//------------------------------------------------------------------------
-	TypedPropertyBase* FindInMap( std::string const& key ) const
+	template <typename T>
+	static void InlineValueCopy( void* dst, void const* src )
 	{
-		auto iter = m_keyValuePairs.find( key );
-		if( iter != m_keyValuePairs.end() ) {
-			return iter->second;
-		}
-		else {
-			return nullptr;
-		}
+		new( dst ) T( *reinterpret_cast<T const*>( src ) );
 	}
-	//------------------------------------------------------------------------
-	
-	// this is going to be different
-	// std::map<std::string, std::string> m_keyValuePairs;
-	// std::map<std::string, void*> m_keyValuePointers;
-
-	// We need to type type in a map
-	// But we can't store the temlate argument... or can we?
-	std::map<std::string, TypedPropertyBase*> m_keyValuePairs;
+
+	template <typename T>
+	static void InlineValueDestroy( void* data )
+	{
+		reinterpret_cast<T*>( data )->~T();
+	}
+
+	template <typename T>
+	static PropertyType const* GetPropertyType()
+	{
+		static PropertyType const s_type = { &InlineValueToString<T>, &InlineValueCopy<T>, &InlineValueDestroy<T> };
+		return &s_type;
+	}
+
+	static PropertyType const*	GetStringPropertyType();
+
+	Property*			GetProperties()			{ return m_overflowProperties.empty() ? m_inlineProperties : m_overflowProperties.data(); }
+	Property const*		GetProperties() const	{ return m_overflowProperties.empty() ? m_inlineProperties : m_overflowProperties.data(); }
+	Property const*		FindProperty( PropertyKey key ) const;
+	Property&			FindOrAddProperty( PropertyKey key );
+	void				DestroyValue( Property& prop );		// gives a string's slot back too
+	std::string const&	GetStringValue( Property const& prop ) const;
+
+private:
+	// Sorted by key. Lives in m_inlineProperties until it outgrows it, then moves wholesale to m_overflowProperties.
+	Property					m_inlineProperties[NUM_INLINE_PROPERTIES];
+	std::vector<Property>		m_overflowProperties;
+	int							m_numProperties = 0;
+
+	// String payloads; slots are reused across Clear() so their capacity sticks around
+	std::vector<std::string>	m_strings;
+	int							m_numStringsUsed = 0;		// slots below this were handed out at some point
+	std::vector<int>			m_freeStringSlots;			// of those, the ones given back by a type change
 };
 
-template<typename T>
-inline bool TypedPropertyBase::Is() const
-{
-	//TypedProperty<T> prop;
-	//return( prop.GetUniqueID() == /*TypedProperty<T>::*/GetUniqueID() );
-	return GetUniqueID() == TypedProperty<T>::StaticUniqueID();
-}
@@ -0,0 +1,534 @@
+#include "Engine/Core/Profiler.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+
+#if defined( PROFILING_ENABLED )
+//-----------------------------------------------------------------------------------------------
+// Per-thread single-producer/single-consumer ring. The owning thread is the only writer,
+// Profiler::EndFrame (main thread) the only reader; no locks on either side.
+//-----------------------------------------------------------------------------------------------
+constexpr uint32_t	THREAD_LOG_CAPACITY	= 8 * 1024;		// power of two
+constexpr uint32_t	THREAD_LOG_MASK		= THREAD_LOG_CAPACITY - 1;
+constexpr size_t	CACHE_LINE_BYTES	= 64;
+
+struct ProfilerThreadLog
+{
+	ProfilerSample			m_samples[THREAD_LOG_CAPACITY];
+
+	// writer and reader indices on separate cache lines so the two threads don't fight over them
+	char					m_padA[CACHE_LINE_BYTES];
+	std::atomic<uint32_t>	m_writeIdx;
+	char					m_padB[CACHE_LINE_BYTES - sizeof( std::atomic<uint32_t> )];
+	std::atomic<uint32_t>	m_readIdx;
+	char					m_padC[CACHE_LINE_BYTES - sizeof( std::atomic<uint32_t> )];
+
+	std::atomic<uint32_t>	m_numDropped;
+	uint32_t				m_threadIdx = 0;
+	bool					m_isThreadAlive = true;		// under s_threadLogsMutex
+};
+
+//-----------------------------------------------------------------------------------------------
+// Lives in each registered thread's storage only to hear when that thread exits
+struct ProfilerThreadExitHook
+{
+	~ProfilerThreadExitHook();
+	bool	m_isRegistered = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// A log is freed once its thread has exited and EndFrame has drained it, or at shutdown. Live
+// threads' logs are never freed under them: past shutdown, each thread frees its own on exit.
+static std::mutex						s_threadLogsMutex;
+static std::vector<ProfilerThreadLog*>	s_threadLogs;		// by thread index; null once freed
+static std::vector<std::string>			s_threadNames;		// by thread index; kept after the log is freed
+static bool								s_isShutDown	= false;
+
+static thread_local ProfilerThreadLog*		t_threadLog		= nullptr;
+static thread_local uint32_t				t_scopeDepth	= 0;
+static thread_local ProfilerThreadExitHook	t_threadExitHook;
+
+static double							s_secondsPerCount = 0.0;
+static std::vector<ProfilerSample>		s_frameSamples;		// drained this frame, reused
+static std::vector<ProfilerNode>		s_lastFrameTree;
+
+static int								s_captureFramesLeft = 0;
+static int								s_captureNumFrames	= 0;
+static std::string						s_captureFilePath;
+static std::vector<ProfilerSample>		s_captureSamples;
+static std::vector<ProfilerNode>		s_captureTree;
+
+
+//-----------------------------------------------------------------------------------------------
+// Null once the profiler has shut down; the thread then goes unprofiled
+//-----------------------------------------------------------------------------------------------
+static ProfilerThreadLog* RegisterCurrentThread()
+{
+	std::lock_guard<std::mutex> lock( s_threadLogsMutex );
+	if( s_isShutDown ) {
+		return nullptr;
+	}
+
+	ProfilerThreadLog* log = new ProfilerThreadLog();
+	log->m_writeIdx.store( 0 );
+	log->m_readIdx.store( 0 );
+	log->m_numDropped.store( 0 );
+	log->m_threadIdx = (uint32_t)s_threadLogs.size();
+	s_threadLogs.push_back( log );
+	s_threadNames.push_back( Stringf( "Thread %u", log->m_threadIdx ) );
+	t_threadLog = log;
+	t_threadExitHook.m_isRegistered = true;
+	return log;
+}
+
+//-----------------------------------------------------------------------------------------------
+ProfilerThreadExitHook::~ProfilerThreadExitHook()
+{
+	if( !m_isRegistered || t_threadLog == nullptr ) {
+		return;
+	}
+
+	// Before shutdown the log may still hold samples, so EndFrame frees it after draining them;
+	// after shutdown nobody else knows about it anymore
+	std::lock_guard<std::mutex> lock( s_threadLogsMutex );
+	if( s_isShutDown ) {
+		delete t_threadLog;
+	}
+	else {
+		t_threadLog->m_isThreadAlive = false;
+	}
+	t_threadLog = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Merges one thread's samples (sorted by start) into the tree; children merge by label under
+// the same parent, so a loop calling the same scope 100 times becomes one node with 100 calls.
+//-----------------------------------------------------------------------------------------------
+static int FindOrAddNode( std::vector<ProfilerNode>& tree, int parentIdx, uint32_t threadIdx, char const* label )
+{
+	for( int nodeIdx = parentIdx + 1; nodeIdx < (int)tree.size(); ++nodeIdx ) {
+		ProfilerNode const& node = tree[nodeIdx];
+		if( node.m_parentIdx == parentIdx && node.m_threadIdx == (int)threadIdx
+			&& ( node.m_label == label || strcmp( node.m_label, label ) == 0 ) ) {
+			return nodeIdx;
+		}
+	}
+
+	ProfilerNode newNode;
+	newNode.m_label = label;
+	newNode.m_parentIdx = parentIdx;
+	newNode.m_threadIdx = (int)threadIdx;
+	newNode.m_depth = ( parentIdx < 0 ) ? 0 : tree[parentIdx].m_depth + 1;
+	tree.push_back( newNode );
+	return (int)tree.size() - 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+static void AccumulateThreadSamples( std::vector<ProfilerNode>& tree, ProfilerSample const* samples, size_t numSamples )
+{
+	struct OpenScope
+	{
+		int			m_nodeIdx;
+		uint64_t	m_endCount;
+	};
+	OpenScope openScopes[64];
+	int numOpenScopes = 0;
+
+	for( size_t sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx ) {
+		ProfilerSample const& sample = samples[sampleIdx];
+		while( numOpenScopes > 0 && openScopes[numOpenScopes - 1].m_endCount <= sample.m_startCount ) {
+			--numOpenScopes;
+		}
+
+		int parentIdx = ( numOpenScopes > 0 ) ? openScopes[numOpenScopes - 1].m_nodeIdx : -1;
+		int nodeIdx = FindOrAddNode( tree, parentIdx, sample.m_threadIdx, sample.m_label );
+		double seconds = (double)( sample.m_endCount - sample.m_startCount ) * s_secondsPerCount;
+
+		tree[nodeIdx].m_callCount++;
+		tree[nodeIdx].m_totalSeconds += seconds;
+		if( parentIdx >= 0 ) {
+			tree[parentIdx].m_childSeconds += seconds;
+		}
+
+		if( numOpenScopes < 64 ) {
+			openScopes[numOpenScopes++] = { nodeIdx, sample.m_endCount };
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+static void AccumulateSamples( std::vector<ProfilerNode>& tree, std::vector<ProfilerSample>& samples )
+{
+	// samples are grouped by thread already; within a thread they land in end order (children first)
+	std::stable_sort( samples.begin(), samples.end(), []( ProfilerSample const& a, ProfilerSample const& b ) {
+		if( a.m_threadIdx != b.m_threadIdx ) {
+			return a.m_threadIdx < b.m_threadIdx;
+		}
+		if( a.m_startCount != b.m_startCount ) {
+			return a.m_startCount < b.m_startCount;
+		}
+		return a.m_depth < b.m_depth;
+	} );
+
+	size_t threadStart = 0;
+	while( threadStart < samples.size() ) {
+		size_t threadEnd = threadStart;
+		while( threadEnd < samples.size() && samples[threadEnd].m_threadIdx == samples[threadStart].m_threadIdx ) {
+			++threadEnd;
+		}
+		AccumulateThreadSamples( tree, &samples[threadStart], threadEnd - threadStart );
+		threadStart = threadEnd;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+static std::string GetThreadName( int threadIdx )
+{
+	std::lock_guard<std::mutex> lock( s_threadLogsMutex );
+	if( threadIdx >= 0 && threadIdx < (int)s_threadNames.size() ) {
+		return s_threadNames[threadIdx];
+	}
+	return Stringf( "Thread %i", threadIdx );
+}
+
+//-----------------------------------------------------------------------------------------------
+static void PrintNodeAndChildren( std::vector<ProfilerNode> const& tree, int parentIdx, int threadIdx, int numFrames, double minSecondsToShow )
+{
+	std::vector<int> children;
+	for( int nodeIdx = parentIdx + 1; nodeIdx < (int)tree.size(); ++nodeIdx ) {
+		if( tree[nodeIdx].m_parentIdx == parentIdx && tree[nodeIdx].m_threadIdx == threadIdx ) {
+			children.push_back( nodeIdx );
+		}
+	}
+	std::sort( children.begin(), children.end(), [&]( int a, int b ) { return tree[a].m_totalSeconds > tree[b].m_totalSeconds; } );
+
+	double frameScale = 1.0 / (double)numFrames;
+	for( int childIdx : children ) {
+		ProfilerNode const& node = tree[childIdx];
+		if( node.m_totalSeconds * frameScale < minSecondsToShow ) {
+			continue;
+		}
+
+		g_theConsole->PrintString( Rgba8::WHITE, Stringf( "%*s%-40s %9.3f ms  self %9.3f ms  calls %7.1f",
+			node.m_depth * 2, "", node.m_label,
+			node.m_totalSeconds * frameScale * 1000.0, node.GetSelfSeconds() * frameScale * 1000.0,
+			(double)node.m_callCount * frameScale ) );
+		PrintNodeAndChildren( tree, childIdx, threadIdx, numFrames, minSecondsToShow );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+static void AppendJsonEscaped( std::string& out, char const* text )
+{
+	for( char const* c = text; *c != '\0'; ++c ) {
+		if( *c == '"' || *c == '\\' ) {
+			out.push_back( '\\' );
+		}
+		out.push_back( *c );
+	}
+}
+
+
+//-----------------------------------------------------------------------------------------------
+ProfileScope::ProfileScope( char const* label )
+	: m_label( label )
+	, m_depth( t_scopeDepth++ )
+{
+	m_startCount = GetPerformanceCounter();
+}
+
+//-----------------------------------------------------------------------------------------------
+ProfileScope::~ProfileScope()
+{
+	uint64_t endCount = GetPerformanceCounter();
+	--t_scopeDepth;
+	Profiler::PushSample( m_label, m_startCount, endCount, m_depth );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::SystemStartup()
+{
+	s_secondsPerCount = GetSecondsPerPerformanceCount();
+	SetThreadName( "Main" );
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::SystemShutdown()
+{
+	// Threads still running (UDP readers, unjoined job workers) keep writing into their logs, so
+	// only this thread's and those of exited threads are freed here; the rest free themselves
+	std::lock_guard<std::mutex> lock( s_threadLogsMutex );
+	for( ProfilerThreadLog* log : s_threadLogs ) {
+		if( log != nullptr && ( !log->m_isThreadAlive || log == t_threadLog ) ) {
+			delete log;
+		}
+	}
+	s_threadLogs.clear();
+	s_threadNames.clear();
+	s_isShutDown = true;
+	t_threadLog = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::BeginFrame()
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::EndFrame()
+{
+	s_frameSamples.clear();
+	uint32_t numDropped = 0;
+	{
+		std::lock_guard<std::mutex> lock( s_threadLogsMutex );
+		for( ProfilerThreadLog*& log : s_threadLogs ) {
+			if( log == nullptr ) {
+				continue;
+			}
+
+			uint32_t readIdx = log->m_readIdx.load( std::memory_order_relaxed );
+			uint32_t writeIdx = log->m_writeIdx.load( std::memory_order_acquire );
+			for( uint32_t sampleIdx = readIdx; sampleIdx != writeIdx; ++sampleIdx ) {
+				s_frameSamples.push_back( log->m_samples[sampleIdx & THREAD_LOG_MASK] );
+			}
+			log->m_readIdx.store( writeIdx, std::memory_order_release );
+			numDropped += log->m_numDropped.exchange( 0, std::memory_order_relaxed );
+
+			if( !log->m_isThreadAlive ) {
+				delete log;
+				log = nullptr;
+			}
+		}
+	}
+
+	if( s_captureFramesLeft > 0 ) {
+		s_captureSamples.insert( s_captureSamples.end(), s_frameSamples.begin(), s_frameSamples.end() );
+	}
+
+	s_lastFrameTree.clear();
+	AccumulateSamples( s_lastFrameTree, s_frameSamples );
+
+	if( s_captureFramesLeft <= 0 ) {
+		return;
+	}
+
+	if( numDropped > 0 ) {
+		g_theConsole->PrintString( Rgba8::YELLOW, Stringf( "Profiler: dropped %u samples, a thread's buffer filled up", numDropped ) );
+	}
+
+	AccumulateSamples( s_captureTree, s_frameSamples );
+	if( --s_captureFramesLeft > 0 ) {
+		return;
+	}
+
+	PrintTree( s_captureTree, s_captureNumFrames, 0.000001 );
+	if( WriteChromeTrace( s_captureFilePath, s_captureSamples ) ) {
+		g_theConsole->PrintString( Rgba8::GREEN, Stringf( "Profiler: wrote %i samples to %s", (int)s_captureSamples.size(), s_captureFilePath.c_str() ) );
+	}
+	else {
+		g_theConsole->PrintString( Rgba8::RED, Stringf( "Profiler: failed to write %s", s_captureFilePath.c_str() ) );
+	}
+
+	s_captureSamples.clear();
+	s_captureSamples.shrink_to_fit();
+	s_captureTree.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::SetThreadName( char const* threadName )
+{
+	ProfilerThreadLog* log = t_threadLog ? t_threadLog : RegisterCurrentThread();
+	if( log == nullptr ) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock( s_threadLogsMutex );
+	s_threadNames[log->m_threadIdx] = threadName;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::StartCapture( int numFrames, std::string const& traceFilePath )
+{
+	s_captureNumFrames = numFrames > 0 ? numFrames : 1;
+	s_captureFramesLeft = s_captureNumFrames;
+	s_captureFilePath = traceFilePath;
+	s_captureSamples.clear();
+	s_captureTree.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+bool Profiler::IsCapturing()
+{
+	return s_captureFramesLeft > 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+std::vector<ProfilerNode> const& Profiler::GetLastFrameTree()
+{
+	return s_lastFrameTree;
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::PrintTree( std::vector<ProfilerNode> const& tree, int numFrames, double minSecondsToShow )
+{
+	g_theConsole->PrintString( Rgba8::CYAN, Stringf( "---- Profile: average of %i frame(s) ----", numFrames ) );
+
+	std::vector<int> threadIndices;
+	for( ProfilerNode const& node : tree ) {
+		if( std::find( threadIndices.begin(), threadIndices.end(), node.m_threadIdx ) == threadIndices.end() ) {
+			threadIndices.push_back( node.m_threadIdx );
+		}
+	}
+	std::sort( threadIndices.begin(), threadIndices.end() );
+
+	for( int threadIdx : threadIndices ) {
+		g_theConsole->PrintString( Rgba8::YELLOW, Stringf( "[%s]", GetThreadName( threadIdx ).c_str() ) );
+		PrintNodeAndChildren( tree, -1, threadIdx, numFrames, minSecondsToShow );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Chrome trace event format: one complete ("X") event per sample, timestamps in microseconds
+//-----------------------------------------------------------------------------------------------
+bool Profiler::WriteChromeTrace( std::string const& filePath, std::vector<ProfilerSample> const& samples )
+{
+	uint64_t firstCount = ~0ull;
+	std::vector<int> threadIndices;
+	for( ProfilerSample const& sample : samples ) {
+		firstCount = std::min( firstCount, sample.m_startCount );
+		if( std::find( threadIndices.begin(), threadIndices.end(), (int)sample.m_threadIdx ) == threadIndices.end() ) {
+			threadIndices.push_back( (int)sample.m_threadIdx );
+		}
+	}
+
+	double microsecondsPerCount = s_secondsPerCount * 1000000.0;
+	std::string json;
+	json.reserve( samples.size() * 96 + 256 );
+	json += "{\"traceEvents\":[\n";
+
+	bool isFirstEvent = true;
+	for( int threadIdx : threadIndices ) {
+		json += isFirstEvent ? "" : ",\n";
+		isFirstEvent = false;
+		json += Stringf( "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"", threadIdx );
+		AppendJsonEscaped( json, GetThreadName( threadIdx ).c_str() );
+		json += "\"}}";
+	}
+
+	for( ProfilerSample const& sample : samples ) {
+		json += isFirstEvent ? "" : ",\n";
+		isFirstEvent = false;
+		json += "{\"name\":\"";
+		AppendJsonEscaped( json, sample.m_label );
+		json += Stringf( "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+			sample.m_threadIdx,
+			(double)( sample.m_startCount - firstCount ) * microsecondsPerCount,
+			(double)( sample.m_endCount - sample.m_startCount ) * microsecondsPerCount );
+	}
+
+	json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return WriteStringToFile( filePath, json );
+}
+
+//-----------------------------------------------------------------------------------------------
+void Profiler::PushSample( char const* label, uint64_t startCount, uint64_t endCount, uint32_t depth )
+{
+	ProfilerThreadLog* log = t_threadLog ? t_threadLog : RegisterCurrentThread();
+	if( log == nullptr ) {
+		return;
+	}
+
+	uint32_t writeIdx = log->m_writeIdx.load( std::memory_order_relaxed );
+	uint32_t readIdx = log->m_readIdx.load( std::memory_order_acquire );
+	if( writeIdx - readIdx >= THREAD_LOG_CAPACITY ) {
+		log->m_numDropped.fetch_add( 1, std::memory_order_relaxed );
+		return;
+	}
+
+	ProfilerSample& sample = log->m_samples[writeIdx & THREAD_LOG_MASK];
+	sample.m_label = label;
+	sample.m_startCount = startCount;
+	sample.m_endCount = endCount;
+	sample.m_depth = depth;
+	sample.m_threadIdx = log->m_threadIdx;
+	log->m_writeIdx.store( writeIdx + 1, std::memory_order_release );
+}
+
+#endif	// PROFILING_ENABLED
+
+
+//-----------------------------------------------------------------------------------------------
+COMMAND( profile, "frames,file" )
+{
+#if defined( PROFILING_ENABLED )
+	int numFrames = args.GetValue( "frames", 1 );
+	std::string filePath = args.GetValue( "file", "ProfileTrace.json" );
+	Profiler::StartCapture( numFrames, filePath );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Profiler: capturing %i frame(s)...", numFrames ) );
+#else
+	UNUSED( args );
+	g_theConsole->PrintString( Rgba8::RED, "Profiling is compiled out of this build (ENGINE_DISABLE_PROFILING)" );
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+// Times empty PROFILE_SCOPEs: two counter reads and a ring write each. Every batch runs on a fresh
+// thread, so it starts with an empty log and no sample is dropped (a dropped sample is cheaper and
+// would flatter the number); the batches show up under "Profiler Benchmark" next frame.
+//-----------------------------------------------------------------------------------------------
+COMMAND( benchmark_profiler, "batches" )
+{
+#if defined( PROFILING_ENABLED )
+	constexpr int SCOPES_PER_BATCH = (int)THREAD_LOG_CAPACITY - 1;
+	int numBatches = args.GetValue( "batches", 16 );
+	if( numBatches <= 0 ) {
+		g_theConsole->Error( "benchmark_profiler: batches must be positive" );
+		return;
+	}
+
+	double bestNanoseconds = 1.0e30;
+	double totalSeconds = 0.0;
+	for( int batchIdx = 0; batchIdx < numBatches; ++batchIdx ) {
+		double batchSeconds = 0.0;
+		std::thread batchThread( [&batchSeconds]() {
+			PROFILER_SET_THREAD_NAME( "Profiler Benchmark" );
+			uint64_t startCount = GetPerformanceCounter();
+			for( int scopeIdx = 0; scopeIdx < SCOPES_PER_BATCH; ++scopeIdx ) {
+				PROFILE_SCOPE( "EmptyScope" );
+			}
+			batchSeconds = (double)( GetPerformanceCounter() - startCount ) * GetSecondsPerPerformanceCount();
+		} );
+		batchThread.join();
+
+		totalSeconds += batchSeconds;
+		bestNanoseconds = std::min( bestNanoseconds, batchSeconds * 1.0e9 / (double)SCOPES_PER_BATCH );
+	}
+
+	// the two counter reads are the floor; the rest is the profiler's own bookkeeping
+	constexpr int NUM_COUNTER_READS = 1 << 20;
+	uint64_t startCount = GetPerformanceCounter();
+	for( int readIdx = 0; readIdx < NUM_COUNTER_READS; ++readIdx ) {
+		GetPerformanceCounter();
+	}
+	double counterReadNanoseconds = (double)( GetPerformanceCounter() - startCount ) * GetSecondsPerPerformanceCount() * 1.0e9 / (double)NUM_COUNTER_READS;
+
+	double meanNanoseconds = totalSeconds * 1.0e9 / ( (double)numBatches * (double)SCOPES_PER_BATCH );
+	g_theConsole->PrintString( meanNanoseconds < 50.0 ? Rgba8::WHITE : Rgba8::YELLOW,
+		Stringf( "Profiler: %i empty scopes, %.1f ns per scope (best batch %.1f ns), target < 50 ns; one counter read %.1f ns",
+			numBatches * SCOPES_PER_BATCH, meanNanoseconds, bestNanoseconds, counterReadNanoseconds ) );
+#else
+	UNUSED( args );
+	g_theConsole->PrintString( Rgba8::RED, "Profiling is compiled out of this build (ENGINE_DISABLE_PROFILING)" );
+#endif
+}
@@ -0,0 +1,117 @@
+#pragma once
+//-----------------------------------------------------------------------------------------------
+// Profiler.hpp
+//
+// Hierarchical scoped CPU profiler.
+//	PROFILE_SCOPE( "TileMap::Update" );		// times the enclosing scope on whichever thread runs it
+//	PROFILE_FUNCTION();						// same, labelled with the function name
+//	PROFILER_SET_THREAD_NAME( "UDP Reader" );	// names the calling thread in reports and traces
+//
+// Every thread writes finished scopes into its own lock-free ring buffer; the main thread drains
+// them once a frame in Profiler::EndFrame(), builds the per-frame call tree and, while a capture
+// is running (DevConsole: "profile frames=N"), keeps the raw samples for Chrome trace export
+// (open the written .json in chrome://tracing or ui.perfetto.dev).
+//
+// #define ENGINE_DISABLE_PROFILING in your game's Code/Game/EngineBuildPreferences.hpp to compile
+// all of this out; the markers then expand to nothing.
+//
+#include "Game/EngineBuildPreferences.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if !defined( ENGINE_DISABLE_PROFILING )
+	#define PROFILING_ENABLED
+#endif
+
+
+#if defined( PROFILING_ENABLED )
+//-----------------------------------------------------------------------------------------------
+struct ProfilerSample
+{
+	char const*		m_label = nullptr;		// must be a string literal (or otherwise outlive the profiler)
+	uint64_t		m_startCount = 0;
+	uint64_t		m_endCount = 0;
+	uint32_t		m_depth = 0;
+	uint32_t		m_threadIdx = 0;
+};
+
+//-----------------------------------------------------------------------------------------------
+// One node of the aggregated per-frame call tree
+struct ProfilerNode
+{
+	char const*		m_label = nullptr;
+	int				m_parentIdx = -1;
+	int				m_threadIdx = 0;
+	int				m_depth = 0;
+	int				m_callCount = 0;
+	double			m_totalSeconds = 0.0;	// inclusive
+	double			m_childSeconds = 0.0;
+
+	double			GetSelfSeconds() const { return m_totalSeconds - m_childSeconds; }
+};
+
+//-----------------------------------------------------------------------------------------------
+class Profiler
+{
+public:
+	static void		SystemStartup();
+	static void		SystemShutdown();
+	static void		BeginFrame();
+	static void		EndFrame();		// main thread; drains all thread buffers
+
+	static void		SetThreadName( char const* threadName );
+
+	// Captures the next numFrames frames, then prints the averaged tree and writes a Chrome trace
+	static void		StartCapture( int numFrames, std::string const& traceFilePath );
+	static bool		IsCapturing();
+
+	static std::vector<ProfilerNode> const&	GetLastFrameTree();
+	static void		PrintTree( std::vector<ProfilerNode> const& tree, int numFrames, double minSecondsToShow );
+	static bool		WriteChromeTrace( std::string const& filePath, std::vector<ProfilerSample> const& samples );
+
+	// Hot path, called by ProfileScope
+	static void		PushSample( char const* label, uint64_t startCount, uint64_t endCount, uint32_t depth );
+};
+
+//-----------------------------------------------------------------------------------------------
+class ProfileScope
+{
+public:
+	explicit ProfileScope( char const* label );
+	~ProfileScope();
+
+	ProfileScope( ProfileScope const& ) = delete;
+	ProfileScope& operator=( ProfileScope const& ) = delete;
+
+private:
+	char const*		m_label = nullptr;
+	uint64_t		m_startCount = 0;
+	uint32_t		m_depth = 0;
+};
+
+#define PROFILE_COMBINE_INNER( a, b )	a##b
+#define PROFILE_COMBINE( a, b )			PROFILE_COMBINE_INNER( a, b )
+
+#define PROFILE_SCOPE( label )				ProfileScope PROFILE_COMBINE( __profileScope_, __LINE__ )( label )
+#define PROFILE_FUNCTION()					PROFILE_SCOPE( __FUNCTION__ )
+#define PROFILER_SET_THREAD_NAME( name )	Profiler::SetThreadName( name )
+
+#else	// !PROFILING_ENABLED
+
+//-----------------------------------------------------------------------------------------------
+// Lifecycle calls stay valid so App doesn't need to #if around them
+class Profiler
+{
+public:
+	static void		SystemStartup()		{}
+	static void		SystemShutdown()	{}
+	static void		BeginFrame()		{}
+	static void		EndFrame()			{}
+};
+
+#define PROFILE_SCOPE( label )
+#define PROFILE_FUNCTION()
+#define PROFILER_SET_THREAD_NAME( name )
+
+#endif	// PROFILING_ENABLED
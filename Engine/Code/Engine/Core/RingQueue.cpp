@@ -0,0 +1,131 @@
+#include "Engine/Core/RingQueue.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Network/SynchronizedNonBlockingQueue.h"
+#include <thread>
+
+
+//-----------------------------------------------------------------------------------------------
+// Throughput benchmark: moves numItems integers through each queue with the given number of
+// producer and consumer threads. Values start at 1 because SynchronizedNonBlockingQueue::Pop
+// returns 0 for "empty". Bounded queues yield when full/empty instead of spinning hard.
+//-----------------------------------------------------------------------------------------------
+struct QueueBenchmarkResult
+{
+	double		m_seconds = 0.0;
+	bool		m_isChecksumValid = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+template <typename TryPushFunc, typename TryPopFunc>
+static QueueBenchmarkResult RunQueueBenchmark( int numProducers, int numConsumers, uint64_t numItems, TryPushFunc tryPush, TryPopFunc tryPop )
+{
+	uint64_t itemsPerProducer = numItems / numProducers;
+	uint64_t totalItems = itemsPerProducer * numProducers;
+
+	std::atomic<uint64_t> numConsumed{ 0 };
+	std::atomic<uint64_t> consumedSum{ 0 };
+	std::atomic<bool> isStarted{ false };
+
+	std::vector<std::thread> threads;
+	for( int producerIdx = 0; producerIdx < numProducers; ++producerIdx ) {
+		threads.emplace_back( [&, producerIdx]() {
+			while( !isStarted.load( std::memory_order_acquire ) ) {
+				std::this_thread::yield();
+			}
+			uint64_t firstValue = 1 + producerIdx * itemsPerProducer;
+			for( uint64_t value = firstValue; value < firstValue + itemsPerProducer; ++value ) {
+				while( !tryPush( value ) ) {
+					std::this_thread::yield();
+				}
+			}
+		} );
+	}
+	for( int consumerIdx = 0; consumerIdx < numConsumers; ++consumerIdx ) {
+		threads.emplace_back( [&]() {
+			while( !isStarted.load( std::memory_order_acquire ) ) {
+				std::this_thread::yield();
+			}
+			uint64_t localSum = 0;
+			uint64_t value = 0;
+			while( numConsumed.load( std::memory_order_relaxed ) < totalItems ) {
+				if( tryPop( value ) ) {
+					localSum += value;
+					numConsumed.fetch_add( 1, std::memory_order_relaxed );
+				}
+				else {
+					std::this_thread::yield();
+				}
+			}
+			consumedSum.fetch_add( localSum, std::memory_order_relaxed );
+		} );
+	}
+
+	double startSeconds = GetCurrentTimeSeconds();
+	isStarted.store( true, std::memory_order_release );
+	for( std::thread& thread : threads ) {
+		thread.join();
+	}
+
+	QueueBenchmarkResult result;
+	result.m_seconds = GetCurrentTimeSeconds() - startSeconds;
+	result.m_isChecksumValid = consumedSum.load() == totalItems * ( totalItems + 1 ) / 2;
+	return result;
+}
+
+//-----------------------------------------------------------------------------------------------
+static void PrintQueueBenchmarkResult( char const* queueName, int numProducers, int numConsumers, uint64_t numItems, QueueBenchmarkResult const& result )
+{
+	double millionItemsPerSecond = result.m_seconds > 0.0 ? (double)numItems / result.m_seconds / 1000000.0 : 0.0;
+	g_theConsole->PrintString( result.m_isChecksumValid ? Rgba8::WHITE : Rgba8::RED,
+		Stringf( "%-30s %iP/%iC: %8.2f ms  %7.2f M items/s%s", queueName, numProducers, numConsumers,
+			result.m_seconds * 1000.0, millionItemsPerSecond, result.m_isChecksumValid ? "" : "  CHECKSUM MISMATCH" ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+static void BenchmarkQueues( int numProducers, int numConsumers, uint64_t numItems, size_t capacity )
+{
+	numItems = ( numItems / numProducers ) * numProducers;
+
+	{
+		SynchronizedNonBlockingQueue<uint64_t> queue;
+		QueueBenchmarkResult result = RunQueueBenchmark( numProducers, numConsumers, numItems,
+			[&]( uint64_t value ) { queue.Push( value ); return true; },
+			[&]( uint64_t& out_value ) { out_value = queue.Pop(); return out_value != 0; } );
+		PrintQueueBenchmarkResult( "SynchronizedNonBlockingQueue", numProducers, numConsumers, numItems, result );
+	}
+
+	if( numProducers == 1 && numConsumers == 1 ) {
+		SPSCRingQueue<uint64_t> queue( capacity );
+		QueueBenchmarkResult result = RunQueueBenchmark( numProducers, numConsumers, numItems,
+			[&]( uint64_t value ) { return queue.TryPush( value ); },
+			[&]( uint64_t& out_value ) { return queue.TryPop( out_value ); } );
+		PrintQueueBenchmarkResult( "SPSCRingQueue", numProducers, numConsumers, numItems, result );
+	}
+
+	{
+		MPMCRingQueue<uint64_t> queue( capacity );
+		QueueBenchmarkResult result = RunQueueBenchmark( numProducers, numConsumers, numItems,
+			[&]( uint64_t value ) { return queue.TryPush( value ); },
+			[&]( uint64_t& out_value ) { return queue.TryPop( out_value ); } );
+		PrintQueueBenchmarkResult( "MPMCRingQueue", numProducers, numConsumers, numItems, result );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+COMMAND( benchmark_queues, "items,capacity,threads" )
+{
+	int numItems = args.GetValue( "items", 2000000 );
+	int capacity = args.GetValue( "capacity", 1024 );
+	int numThreads = args.GetValue( "threads", 4 );
+	if( numItems <= 0 || capacity <= 0 || numThreads <= 0 ) {
+		g_theConsole->Error( "benchmark_queues: items, capacity and threads must be positive" );
+		return;
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Queue throughput, %i items, capacity %i", numItems, capacity ) );
+	BenchmarkQueues( 1, 1, (uint64_t)numItems, (size_t)capacity );
+	BenchmarkQueues( numThreads, numThreads, (uint64_t)numItems, (size_t)capacity );
+}
@@ -0,0 +1,427 @@
+#pragma once
+//-----------------------------------------------------------------------------------------------
+// RingQueue.hpp
+//
+// Bounded lock-free queues for handing work between threads.
+//	SPSCRingQueue<T>	exactly one producer thread and one consumer thread
+//	MPMCRingQueue<T>	any number of producers and consumers (Dmitry Vyukov's bounded MPMC queue)
+//
+// Capacity is rounded up to a power of two and fixed at construction. Slots are allocated once
+// and values are move-assigned in and out of them, so T must be default-constructible and a
+// queue of fixed-size messages never touches the heap after construction.
+//
+// TryPush/TryPop/PopBatch never block; they report full/empty instead. WaitPop sleeps until an
+// item arrives or WakeAll() is called (shutdown). Producers only take a lock to wake a consumer
+// when one is actually sleeping.
+//
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+constexpr size_t RING_QUEUE_CACHE_LINE_BYTES = 64;
+
+//-----------------------------------------------------------------------------------------------
+inline size_t GetRingQueueCapacity( size_t requestedCapacity )
+{
+	size_t capacity = 2;
+	while( capacity < requestedCapacity ) {
+		capacity <<= 1;
+	}
+	return capacity;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Lets consumers sleep on an otherwise lock-free queue
+//-----------------------------------------------------------------------------------------------
+class RingQueueWaiter
+{
+public:
+	// Producers call this after publishing an item
+	void NotifyIfWaiting()
+	{
+		// Pairs with the fence in Wait(): either we see the waiter, or the waiter sees our item
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if( m_numWaiters.load( std::memory_order_relaxed ) > 0 ) {
+			std::lock_guard<std::mutex> lock( m_mutex );
+			m_condition.notify_all();
+		}
+	}
+
+	// Sleeps until hasItem() is true; returns false if woken by WakeAll() instead
+	template <typename HasItemFunc>
+	bool Wait( HasItemFunc hasItem )
+	{
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_numWaiters.fetch_add( 1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		m_condition.wait( lock, [&]() { return m_isWakeRequested || hasItem(); } );
+		m_numWaiters.fetch_sub( 1, std::memory_order_relaxed );
+		return !m_isWakeRequested;
+	}
+
+	// Releases every current and future waiter, e.g. so a worker thread can exit
+	void WakeAll()
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_isWakeRequested = true;
+		m_condition.notify_all();
+	}
+
+private:
+	std::mutex				m_mutex;
+	std::condition_variable	m_condition;
+	std::atomic<int>		m_numWaiters{ 0 };
+	bool					m_isWakeRequested = false;
+};
+
+
+//-----------------------------------------------------------------------------------------------
+// Single producer, single consumer
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+class SPSCRingQueue
+{
+public:
+	explicit SPSCRingQueue( size_t capacity );
+	SPSCRingQueue( SPSCRingQueue const& ) = delete;
+	SPSCRingQueue& operator=( SPSCRingQueue const& ) = delete;
+
+	// Producer thread only
+	bool		TryPush( T const& value );
+	bool		TryPush( T&& value );
+	T*			TryBeginPush();			// fill the returned slot in place, then CommitPush(); nullptr when full
+	void		CommitPush();
+
+	// Consumer thread only
+	bool		TryPop( T& out_value );
+	size_t		PopBatch( T* out_values, size_t maxCount );
+	T*			TryBeginPop();			// read the slot in place, then CommitPop(); nullptr when empty
+	void		CommitPop();
+	bool		WaitPop( T& out_value );	// false once WakeAll() was called and the queue is drained
+	bool		WaitForItem();				// sleeps until not empty; false once WakeAll() was called
+
+	void		WakeAll()					{ m_waiter.WakeAll(); }
+	bool		IsEmpty() const;
+	size_t		GetCapacity() const			{ return m_mask + 1; }
+
+private:
+	std::vector<T>		m_slots;
+	size_t				m_mask = 0;
+
+	// producer's cache line
+	char				m_padA[RING_QUEUE_CACHE_LINE_BYTES];
+	std::atomic<size_t>	m_writeIdx{ 0 };
+	size_t				m_cachedReadIdx = 0;
+	char				m_padB[RING_QUEUE_CACHE_LINE_BYTES - sizeof( std::atomic<size_t> ) - sizeof( size_t )];
+
+	// consumer's cache line
+	std::atomic<size_t>	m_readIdx{ 0 };
+	size_t				m_cachedWriteIdx = 0;
+	char				m_padC[RING_QUEUE_CACHE_LINE_BYTES - sizeof( std::atomic<size_t> ) - sizeof( size_t )];
+
+	RingQueueWaiter		m_waiter;
+};
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+SPSCRingQueue<T>::SPSCRingQueue( size_t capacity )
+	: m_slots( GetRingQueueCapacity( capacity ) )
+{
+	m_mask = m_slots.size() - 1;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool SPSCRingQueue<T>::TryPush( T const& value )
+{
+	T* slot = TryBeginPush();
+	if( slot == nullptr ) {
+		return false;
+	}
+	*slot = value;
+	CommitPush();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool SPSCRingQueue<T>::TryPush( T&& value )
+{
+	T* slot = TryBeginPush();
+	if( slot == nullptr ) {
+		return false;
+	}
+	*slot = std::move( value );
+	CommitPush();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+T* SPSCRingQueue<T>::TryBeginPush()
+{
+	size_t writeIdx = m_writeIdx.load( std::memory_order_relaxed );
+	if( writeIdx - m_cachedReadIdx > m_mask ) {
+		// looks full; only now pay for reading the consumer's index
+		m_cachedReadIdx = m_readIdx.load( std::memory_order_acquire );
+		if( writeIdx - m_cachedReadIdx > m_mask ) {
+			return nullptr;
+		}
+	}
+	return &m_slots[writeIdx & m_mask];
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+void SPSCRingQueue<T>::CommitPush()
+{
+	m_writeIdx.store( m_writeIdx.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+	m_waiter.NotifyIfWaiting();
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool SPSCRingQueue<T>::TryPop( T& out_value )
+{
+	T* slot = TryBeginPop();
+	if( slot == nullptr ) {
+		return false;
+	}
+	out_value = std::move( *slot );
+	CommitPop();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+size_t SPSCRingQueue<T>::PopBatch( T* out_values, size_t maxCount )
+{
+	size_t readIdx = m_readIdx.load( std::memory_order_relaxed );
+	if( m_cachedWriteIdx - readIdx < maxCount ) {
+		m_cachedWriteIdx = m_writeIdx.load( std::memory_order_acquire );
+	}
+
+	size_t numAvailable = m_cachedWriteIdx - readIdx;
+	size_t numToPop = numAvailable < maxCount ? numAvailable : maxCount;
+	for( size_t popIdx = 0; popIdx < numToPop; ++popIdx ) {
+		out_values[popIdx] = std::move( m_slots[( readIdx + popIdx ) & m_mask] );
+	}
+	m_readIdx.store( readIdx + numToPop, std::memory_order_release );
+	return numToPop;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+T* SPSCRingQueue<T>::TryBeginPop()
+{
+	size_t readIdx = m_readIdx.load( std::memory_order_relaxed );
+	if( readIdx == m_cachedWriteIdx ) {
+		m_cachedWriteIdx = m_writeIdx.load( std::memory_order_acquire );
+		if( readIdx == m_cachedWriteIdx ) {
+			return nullptr;
+		}
+	}
+	return &m_slots[readIdx & m_mask];
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+void SPSCRingQueue<T>::CommitPop()
+{
+	m_readIdx.store( m_readIdx.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool SPSCRingQueue<T>::WaitPop( T& out_value )
+{
+	while( !TryPop( out_value ) ) {
+		if( !WaitForItem() ) {
+			return TryPop( out_value );
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool SPSCRingQueue<T>::WaitForItem()
+{
+	return m_waiter.Wait( [this]() { return !IsEmpty(); } );
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool SPSCRingQueue<T>::IsEmpty() const
+{
+	return m_readIdx.load( std::memory_order_acquire ) == m_writeIdx.load( std::memory_order_acquire );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// Multiple producers, multiple consumers. Every slot carries a sequence number that tells
+// producers and consumers whose turn it is, so each operation is a single CAS on an index.
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+class MPMCRingQueue
+{
+public:
+	explicit MPMCRingQueue( size_t capacity );
+	MPMCRingQueue( MPMCRingQueue const& ) = delete;
+	MPMCRingQueue& operator=( MPMCRingQueue const& ) = delete;
+
+	bool		TryPush( T const& value );
+	bool		TryPush( T&& value );
+	bool		TryPop( T& out_value );
+	size_t		PopBatch( T* out_values, size_t maxCount );
+	bool		WaitPop( T& out_value );	// false once WakeAll() was called and the queue is drained
+
+	void		WakeAll()					{ m_waiter.WakeAll(); }
+	bool		IsEmpty() const;
+	size_t		GetCapacity() const			{ return m_mask + 1; }
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t>	m_sequence;
+		T					m_value;
+	};
+
+	template <typename U>
+	bool		Push( U&& value );
+
+private:
+	std::unique_ptr<Cell[]>	m_cells;
+	size_t					m_mask = 0;
+
+	char					m_padA[RING_QUEUE_CACHE_LINE_BYTES];
+	std::atomic<size_t>		m_enqueueIdx{ 0 };
+	char					m_padB[RING_QUEUE_CACHE_LINE_BYTES - sizeof( std::atomic<size_t> )];
+	std::atomic<size_t>		m_dequeueIdx{ 0 };
+	char					m_padC[RING_QUEUE_CACHE_LINE_BYTES - sizeof( std::atomic<size_t> )];
+
+	RingQueueWaiter			m_waiter;
+};
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+MPMCRingQueue<T>::MPMCRingQueue( size_t capacity )
+{
+	size_t numCells = GetRingQueueCapacity( capacity );
+	m_cells.reset( new Cell[numCells] );
+	m_mask = numCells - 1;
+	for( size_t cellIdx = 0; cellIdx < numCells; ++cellIdx ) {
+		m_cells[cellIdx].m_sequence.store( cellIdx, std::memory_order_relaxed );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool MPMCRingQueue<T>::TryPush( T const& value )
+{
+	return Push( value );
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool MPMCRingQueue<T>::TryPush( T&& value )
+{
+	return Push( std::move( value ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+template <typename U>
+bool MPMCRingQueue<T>::Push( U&& value )
+{
+	Cell* cell = nullptr;
+	size_t enqueueIdx = m_enqueueIdx.load( std::memory_order_relaxed );
+	for( ;; ) {
+		cell = &m_cells[enqueueIdx & m_mask];
+		size_t sequence = cell->m_sequence.load( std::memory_order_acquire );
+		intptr_t diff = (intptr_t)sequence - (intptr_t)enqueueIdx;
+		if( diff == 0 ) {
+			// slot is free for this lap; claim it
+			if( m_enqueueIdx.compare_exchange_weak( enqueueIdx, enqueueIdx + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		}
+		else if( diff < 0 ) {
+			return false;	// full: the consumer of the previous lap hasn't freed it yet
+		}
+		else {
+			enqueueIdx = m_enqueueIdx.load( std::memory_order_relaxed );
+		}
+	}
+
+	cell->m_value = std::forward<U>( value );
+	cell->m_sequence.store( enqueueIdx + 1, std::memory_order_release );
+	m_waiter.NotifyIfWaiting();
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool MPMCRingQueue<T>::TryPop( T& out_value )
+{
+	Cell* cell = nullptr;
+	size_t dequeueIdx = m_dequeueIdx.load( std::memory_order_relaxed );
+	for( ;; ) {
+		cell = &m_cells[dequeueIdx & m_mask];
+		size_t sequence = cell->m_sequence.load( std::memory_order_acquire );
+		intptr_t diff = (intptr_t)sequence - (intptr_t)( dequeueIdx + 1 );
+		if( diff == 0 ) {
+			if( m_dequeueIdx.compare_exchange_weak( dequeueIdx, dequeueIdx + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		}
+		else if( diff < 0 ) {
+			return false;	// empty
+		}
+		else {
+			dequeueIdx = m_dequeueIdx.load( std::memory_order_relaxed );
+		}
+	}
+
+	out_value = std::move( cell->m_value );
+	cell->m_sequence.store( dequeueIdx + m_mask + 1, std::memory_order_release );	// free for the next lap
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+size_t MPMCRingQueue<T>::PopBatch( T* out_values, size_t maxCount )
+{
+	size_t numPopped = 0;
+	while( numPopped < maxCount && TryPop( out_values[numPopped] ) ) {
+		++numPopped;
+	}
+	return numPopped;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool MPMCRingQueue<T>::WaitPop( T& out_value )
+{
+	while( !TryPop( out_value ) ) {
+		if( !m_waiter.Wait( [this]() { return !IsEmpty(); } ) ) {
+			return TryPop( out_value );
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+bool MPMCRingQueue<T>::IsEmpty() const
+{
+	size_t dequeueIdx = m_dequeueIdx.load( std::memory_order_acquire );
+	Cell const& cell = m_cells[dequeueIdx & m_mask];
+	return cell.m_sequence.load( std::memory_order_acquire ) != dequeueIdx + 1;
+}
@@ -32,3 +32,24 @@ double GetCurrentTimeSeconds()
 }
 
 
+//-----------------------------------------------------------------------------------------------
+uint64_t GetPerformanceCounter()
+{
+	LARGE_INTEGER currentCount;
+	QueryPerformanceCounter( &currentCount );
+	return static_cast< uint64_t >( currentCount.QuadPart );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+double GetSecondsPerPerformanceCount()
+{
+	static double secondsPerCount = 0.0;
+	if( secondsPerCount == 0.0 )
+	{
+		LARGE_INTEGER countsPerSecond;
+		QueryPerformanceFrequency( &countsPerSecond );
+		secondsPerCount = 1.0 / static_cast< double >( countsPerSecond.QuadPart );
+	}
+	return secondsPerCount;
+}
@@ -2,8 +2,13 @@
 // Time.hpp
 //
 #pragma once
+#include <cstdint>
 
 
 //-----------------------------------------------------------------------------------------------
 double GetCurrentTimeSeconds();
 
+// Raw high resolution counter; cheaper than GetCurrentTimeSeconds when only differences matter
+uint64_t GetPerformanceCounter();
+double	 GetSecondsPerPerformanceCount();
+
@@ -0,0 +1,147 @@
+#include "Engine/Core/UnitTest.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+
+constexpr int MAX_REPORTED_FAILURES_PER_TEST = 8;
+
+//-------------------------------------------------------------------------------------------------------------
+// A function-local list, so tests registered from any translation unit's static init find it constructed
+//-------------------------------------------------------------------------------------------------------------
+static std::vector<UnitTest*>& GetRegisteredUnitTests()
+{
+	static std::vector<UnitTest*> s_unitTests;
+	return s_unitTests;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+UnitTest::UnitTest( char const* name, char const* category, UnitTestFunctionPtrType testFunction )
+	:m_name( name )
+	,m_category( category )
+	,m_testFunction( testFunction )
+{
+	GetRegisteredUnitTests().push_back( this );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void UnitTestResult::Check( bool isPassed, std::string const& description, char const* filePath, int lineNum )
+{
+	++m_numChecks;
+	if( isPassed )
+	{
+		return;
+	}
+
+	++m_numFailedChecks;
+	if( (int)m_failures.size() < MAX_REPORTED_FAILURES_PER_TEST )
+	{
+		m_failures.push_back( Stringf( "%s(%i): %s", filePath, lineNum, description.c_str() ) );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int RunUnitTests( std::string const& category, std::vector<std::string>& out_reportLines )
+{
+	std::vector<UnitTest*> unitTests = GetRegisteredUnitTests();
+	std::sort( unitTests.begin(), unitTests.end(), []( UnitTest const* a, UnitTest const* b ) {
+		int categoryOrder = strcmp( a->m_category, b->m_category );
+		return categoryOrder != 0 ? categoryOrder < 0 : strcmp( a->m_name, b->m_name ) < 0;
+	} );
+
+	int numRun = 0;
+	int numFailed = 0;
+	for( UnitTest const* unitTest : unitTests )
+	{
+		if( !category.empty() && category != unitTest->m_category )
+		{
+			continue;
+		}
+
+		UnitTestResult result;
+		double startSeconds = GetCurrentTimeSeconds();
+		unitTest->m_testFunction( result );
+		double elapsedSeconds = GetCurrentTimeSeconds() - startSeconds;
+
+		bool isPassed = result.m_numFailedChecks == 0 && result.m_numChecks > 0;	// a test that checked nothing proved nothing
+		out_reportLines.push_back( Stringf( "%s %s/%s: %i checks, %i failed (%.1f ms)", isPassed ? "[PASS]" : "[FAIL]",
+			unitTest->m_category, unitTest->m_name, result.m_numChecks, result.m_numFailedChecks, elapsedSeconds * 1000.0 ) );
+		for( std::string const& failure : result.m_failures )
+		{
+			out_reportLines.push_back( "    " + failure );
+		}
+
+		++numRun;
+		numFailed += isPassed ? 0 : 1;
+	}
+
+	if( numRun == 0 )
+	{
+		out_reportLines.push_back( Stringf( "[FAIL] no tests in category \"%s\"", category.c_str() ) );
+		return 1;
+	}
+	out_reportLines.push_back( Stringf( "%i of %i tests passed", numRun - numFailed, numRun ) );
+	return numFailed;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool IsUnitTestRunRequested( std::string const& commandLine )
+{
+	Strings tokens = SplitStringOnDelimiter( commandLine, ' ' );
+	return std::find( tokens.begin(), tokens.end(), "-test" ) != tokens.end();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// The app has no console window, so the report goes to the debugger and to a file
+//-------------------------------------------------------------------------------------------------------------
+int RunUnitTestsFromCommandLine( std::string const& commandLine )
+{
+	std::string category;
+	std::string outputFilePath = "TestResults.txt";
+	Strings tokens = SplitStringOnDelimiter( commandLine, ' ' );
+	for( std::string const& token : tokens )
+	{
+		Strings keyAndValue = SplitStringOnDelimiter( token, '=' );
+		if( keyAndValue.size() == 2 && keyAndValue[0] == "category" )
+		{
+			category = keyAndValue[1];
+		}
+		else if( keyAndValue.size() == 2 && keyAndValue[0] == "out" )
+		{
+			outputFilePath = keyAndValue[1];
+		}
+	}
+
+	std::vector<std::string> reportLines;
+	int numFailed = RunUnitTests( category, reportLines );
+
+	std::string report;
+	for( std::string const& line : reportLines )
+	{
+		DebuggerPrintf( "%s\n", line.c_str() );
+		report += line + "\n";
+	}
+	WriteStringToFile( outputFilePath, report );
+	return numFailed;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( run_tests, "category" )
+{
+	std::string category = args.GetValue( "category", "" );
+
+	std::vector<std::string> reportLines;
+	int numFailed = RunUnitTests( category, reportLines );
+	for( std::string const& line : reportLines )
+	{
+		bool isFailure = line.compare( 0, 6, "[FAIL]" ) == 0 || line.compare( 0, 4, "    " ) == 0;
+		g_theConsole->PrintString( isFailure ? Rgba8::RED : Rgba8::WHITE, line );
+	}
+	if( numFailed > 0 )
+	{
+		g_theConsole->Error( "run_tests: %i failed", numFailed );
+	}
+}
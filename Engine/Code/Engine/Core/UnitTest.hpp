@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+// Self-registering tests, declared next to the code they check, the way COMMAND declares console commands:
+//
+//	UNIT_TEST( Vec2Length, "Math" )
+//	{
+//		UNIT_TEST_CHECK( Vec2( 3.f, 4.f ).GetLength() == 5.f );
+//	}
+//
+// Run from the console with run_tests [category=Math], or headless with "DoomensteinVR.exe -test [category=Math]",
+// which exits with the number of failed tests. A failed check records the condition and carries on.
+//-------------------------------------------------------------------------------------------------------------
+struct UnitTestResult
+{
+	int							m_numChecks = 0;
+	int							m_numFailedChecks = 0;
+	std::vector<std::string>	m_failures;		// first few only, "file(line): condition or message"
+
+	void	Check( bool isPassed, std::string const& description, char const* filePath, int lineNum );
+};
+
+typedef void(*UnitTestFunctionPtrType)( UnitTestResult& result );
+
+//-------------------------------------------------------------------------------------------------------------
+struct UnitTest
+{
+	UnitTest( char const* name, char const* category, UnitTestFunctionPtrType testFunction );
+
+	char const*				m_name = nullptr;
+	char const*				m_category = nullptr;
+	UnitTestFunctionPtrType	m_testFunction = nullptr;
+};
+
+#define UNIT_TEST( name, category ) \
+	static void name##_test( UnitTestResult& result ); \
+	static UnitTest name##_testRegister( #name, category, name##_test ); \
+	static void name##_test( UnitTestResult& result )
+
+#define UNIT_TEST_CHECK( condition )				result.Check( ( condition ), #condition, __FILE__, __LINE__ )
+#define UNIT_TEST_CHECK_MSG( condition, message )	result.Check( ( condition ), message, __FILE__, __LINE__ )
+
+// Runs every registered test whose category matches (empty runs all); appends a line per test and a summary.
+// Returns the number of tests that failed.
+int		RunUnitTests( std::string const& category, std::vector<std::string>& out_reportLines );
+
+// The headless entry point: "-test" on the command line, optionally "category=X" and "out=File.txt"
+bool	IsUnitTestRunRequested( std::string const& commandLine );
+int		RunUnitTestsFromCommandLine( std::string const& commandLine );
@@ -0,0 +1,523 @@
+#include "Engine/Math/Frustum.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MatrixUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <cmath>
+
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) || defined( __SSE__ )
+	#define FRUSTUM_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
+
+//-----------------------------------------------------------------------------------------------
+void FrustumAABBList::Clear()
+{
+	m_centerX.clear();
+	m_centerY.clear();
+	m_centerZ.clear();
+	m_extentX.clear();
+	m_extentY.clear();
+	m_extentZ.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+void FrustumAABBList::Reserve( int count )
+{
+	m_centerX.reserve( count );
+	m_centerY.reserve( count );
+	m_centerZ.reserve( count );
+	m_extentX.reserve( count );
+	m_extentY.reserve( count );
+	m_extentZ.reserve( count );
+}
+
+//-----------------------------------------------------------------------------------------------
+void FrustumAABBList::Add( AABB3 const& bounds )
+{
+	m_centerX.push_back( 0.5f * ( bounds.mins.x + bounds.maxs.x ) );
+	m_centerY.push_back( 0.5f * ( bounds.mins.y + bounds.maxs.y ) );
+	m_centerZ.push_back( 0.5f * ( bounds.mins.z + bounds.maxs.z ) );
+	m_extentX.push_back( 0.5f * ( bounds.maxs.x - bounds.mins.x ) );
+	m_extentY.push_back( 0.5f * ( bounds.maxs.y - bounds.mins.y ) );
+	m_extentZ.push_back( 0.5f * ( bounds.maxs.z - bounds.mins.z ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+void FrustumSphereList::Clear()
+{
+	m_centerX.clear();
+	m_centerY.clear();
+	m_centerZ.clear();
+	m_radius.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+void FrustumSphereList::Reserve( int count )
+{
+	m_centerX.reserve( count );
+	m_centerY.reserve( count );
+	m_centerZ.reserve( count );
+	m_radius.reserve( count );
+}
+
+//-----------------------------------------------------------------------------------------------
+void FrustumSphereList::Add( Vec3 const& center, float radius )
+{
+	m_centerX.push_back( center.x );
+	m_centerY.push_back( center.y );
+	m_centerZ.push_back( center.z );
+	m_radius.push_back( radius );
+}
+
+//-----------------------------------------------------------------------------------------------
+static Vec4 MakeNormalizedPlane( float a, float b, float c, float d )
+{
+	float length = sqrtf( a * a + b * b + c * c );
+	if( length < 1e-6f )
+	{
+		// e.g. the far plane of an infinite projection; never rejects anything
+		return Vec4( 0.f, 0.f, 0.f, 1.f );
+	}
+
+	float invLength = 1.f / length;
+	return Vec4( a * invLength, b * invLength, c * invLength, d * invLength );
+}
+
+//-----------------------------------------------------------------------------------------------
+static float GetDistanceToPlane( Vec4 const& plane, Vec3 const& point )
+{
+	return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Gribb/Hartmann: the planes are sums and differences of the clip matrix rows. Mat44 is stored
+// basis-major, so row r is ( I[r], J[r], K[r], T[r] ).
+//-----------------------------------------------------------------------------------------------
+Frustum Frustum::CreateFromWorldToClip( Mat44 const& m )
+{
+	Frustum frustum;
+	frustum.m_planes[FRUSTUM_PLANE_LEFT]	= MakeNormalizedPlane( m.Iw + m.Ix, m.Jw + m.Jx, m.Kw + m.Kx, m.Tw + m.Tx );
+	frustum.m_planes[FRUSTUM_PLANE_RIGHT]	= MakeNormalizedPlane( m.Iw - m.Ix, m.Jw - m.Jx, m.Kw - m.Kx, m.Tw - m.Tx );
+	frustum.m_planes[FRUSTUM_PLANE_BOTTOM]	= MakeNormalizedPlane( m.Iw + m.Iy, m.Jw + m.Jy, m.Kw + m.Ky, m.Tw + m.Ty );
+	frustum.m_planes[FRUSTUM_PLANE_TOP]		= MakeNormalizedPlane( m.Iw - m.Iy, m.Jw - m.Jy, m.Kw - m.Ky, m.Tw - m.Ty );
+	frustum.m_planes[FRUSTUM_PLANE_NEAR]	= MakeNormalizedPlane( m.Iz, m.Jz, m.Kz, m.Tz );	// D3D depth starts at 0
+	frustum.m_planes[FRUSTUM_PLANE_FAR]		= MakeNormalizedPlane( m.Iw - m.Iz, m.Jw - m.Jz, m.Kw - m.Kz, m.Tw - m.Tz );
+	return frustum;
+}
+
+//-----------------------------------------------------------------------------------------------
+void GetFrustumCorners( Mat44 const& worldToClip, Vec3 out_corners[8] )
+{
+	Mat44 clipToWorld = GetInvert( worldToClip );
+	int cornerIdx = 0;
+	for( int zIdx = 0; zIdx < 2; ++zIdx )
+	{
+		for( int yIdx = 0; yIdx < 2; ++yIdx )
+		{
+			for( int xIdx = 0; xIdx < 2; ++xIdx )
+			{
+				Vec4 ndc( xIdx ? 1.f : -1.f, yIdx ? 1.f : -1.f, (float)zIdx, 1.f );
+				Vec4 world = clipToWorld.TransformHomogeneousPoint3D( ndc );
+				world /= world.w;
+				out_corners[cornerIdx++] = Vec3( world.x, world.y, world.z );
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// How far the plane has to move outward before every corner is inside it
+//-----------------------------------------------------------------------------------------------
+static float GetSlackToContainCorners( Vec4 const& plane, Vec3 const corners[8] )
+{
+	float slack = 0.f;
+	for( int cornerIdx = 0; cornerIdx < 8; ++cornerIdx )
+	{
+		float distance = GetDistanceToPlane( plane, corners[cornerIdx] );
+		if( -distance > slack )
+		{
+			slack = -distance;
+		}
+	}
+	return slack;
+}
+
+//-----------------------------------------------------------------------------------------------
+// For side-by-side parallel eyes the left eye's left plane already contains the right eye (and
+// vice versa) and the shared planes coincide, so the slack is ~0. Canted displays need a little
+// slack on top/bottom, which pushes the chosen plane out just far enough to stay conservative.
+//-----------------------------------------------------------------------------------------------
+Frustum Frustum::CreateStereoEnclosing( Mat44 const& leftWorldToClip, Mat44 const& rightWorldToClip )
+{
+	Frustum left = CreateFromWorldToClip( leftWorldToClip );
+	Frustum right = CreateFromWorldToClip( rightWorldToClip );
+
+	Vec3 leftCorners[8];
+	Vec3 rightCorners[8];
+	GetFrustumCorners( leftWorldToClip, leftCorners );
+	GetFrustumCorners( rightWorldToClip, rightCorners );
+
+	Frustum enclosing;
+	for( int planeIdx = 0; planeIdx < NUM_FRUSTUM_PLANES; ++planeIdx )
+	{
+		Vec4 leftPlane = left.m_planes[planeIdx];
+		Vec4 rightPlane = right.m_planes[planeIdx];
+		float leftSlack = GetSlackToContainCorners( leftPlane, rightCorners );
+		float rightSlack = GetSlackToContainCorners( rightPlane, leftCorners );
+
+		Vec4 plane = leftSlack <= rightSlack ? leftPlane : rightPlane;
+		plane.w += leftSlack <= rightSlack ? leftSlack : rightSlack;
+		enclosing.m_planes[planeIdx] = plane;
+	}
+	return enclosing;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool Frustum::IsPointInside( Vec3 const& point ) const
+{
+	for( int planeIdx = 0; planeIdx < NUM_FRUSTUM_PLANES; ++planeIdx )
+	{
+		if( GetDistanceToPlane( m_planes[planeIdx], point ) < 0.f )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Conservative: a box straddling two planes outside a corner of the frustum still counts as visible
+//-----------------------------------------------------------------------------------------------
+static bool IsAABBOutsideAnyPlane( Vec4 const planes[NUM_FRUSTUM_PLANES], float centerX, float centerY, float centerZ, float extentX, float extentY, float extentZ )
+{
+	for( int planeIdx = 0; planeIdx < NUM_FRUSTUM_PLANES; ++planeIdx )
+	{
+		Vec4 const& plane = planes[planeIdx];
+		float distance = ( centerX * plane.x + centerY * plane.y ) + ( centerZ * plane.z + plane.w );
+		float radius = ( extentX * fabsf( plane.x ) + extentY * fabsf( plane.y ) ) + extentZ * fabsf( plane.z );
+		if( distance + radius < 0.f )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+static bool IsSphereOutsideAnyPlane( Vec4 const planes[NUM_FRUSTUM_PLANES], float centerX, float centerY, float centerZ, float radius )
+{
+	for( int planeIdx = 0; planeIdx < NUM_FRUSTUM_PLANES; ++planeIdx )
+	{
+		Vec4 const& plane = planes[planeIdx];
+		float distance = ( centerX * plane.x + centerY * plane.y ) + ( centerZ * plane.z + plane.w );
+		if( distance + radius < 0.f )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+bool Frustum::IsAABBVisible( AABB3 const& bounds ) const
+{
+	Vec3 center = bounds.GetCenter();
+	Vec3 extents = ( bounds.maxs - bounds.mins ) * 0.5f;
+	return !IsAABBOutsideAnyPlane( m_planes, center.x, center.y, center.z, extents.x, extents.y, extents.z );
+}
+
+//-----------------------------------------------------------------------------------------------
+bool Frustum::IsSphereVisible( Vec3 const& center, float radius ) const
+{
+	return !IsSphereOutsideAnyPlane( m_planes, center.x, center.y, center.z, radius );
+}
+
+//-----------------------------------------------------------------------------------------------
+int Frustum::CullAABBsScalar( FrustumAABBList const& bounds, std::vector<int>& out_visibleIndices ) const
+{
+	size_t firstOutput = out_visibleIndices.size();
+	int count = bounds.GetCount();
+	for( int idx = 0; idx < count; ++idx )
+	{
+		if( !IsAABBOutsideAnyPlane( m_planes, bounds.m_centerX[idx], bounds.m_centerY[idx], bounds.m_centerZ[idx], bounds.m_extentX[idx], bounds.m_extentY[idx], bounds.m_extentZ[idx] ) )
+		{
+			out_visibleIndices.push_back( idx );
+		}
+	}
+	return (int)( out_visibleIndices.size() - firstOutput );
+}
+
+//-----------------------------------------------------------------------------------------------
+int Frustum::CullSpheresScalar( FrustumSphereList const& spheres, std::vector<int>& out_visibleIndices ) const
+{
+	size_t firstOutput = out_visibleIndices.size();
+	int count = spheres.GetCount();
+	for( int idx = 0; idx < count; ++idx )
+	{
+		if( !IsSphereOutsideAnyPlane( m_planes, spheres.m_centerX[idx], spheres.m_centerY[idx], spheres.m_centerZ[idx], spheres.m_radius[idx] ) )
+		{
+			out_visibleIndices.push_back( idx );
+		}
+	}
+	return (int)( out_visibleIndices.size() - firstOutput );
+}
+
+#if defined( FRUSTUM_USE_SSE )
+//-----------------------------------------------------------------------------------------------
+// Four objects per iteration against one broadcast plane at a time. The arithmetic is grouped
+// exactly like the scalar helpers above, so both paths agree bit for bit.
+//-----------------------------------------------------------------------------------------------
+struct FrustumPlanesSSE
+{
+	__m128	m_x[NUM_FRUSTUM_PLANES];
+	__m128	m_y[NUM_FRUSTUM_PLANES];
+	__m128	m_z[NUM_FRUSTUM_PLANES];
+	__m128	m_w[NUM_FRUSTUM_PLANES];
+	__m128	m_absX[NUM_FRUSTUM_PLANES];
+	__m128	m_absY[NUM_FRUSTUM_PLANES];
+	__m128	m_absZ[NUM_FRUSTUM_PLANES];
+
+	explicit FrustumPlanesSSE( Vec4 const planes[NUM_FRUSTUM_PLANES] )
+	{
+		for( int planeIdx = 0; planeIdx < NUM_FRUSTUM_PLANES; ++planeIdx )
+		{
+			m_x[planeIdx] = _mm_set1_ps( planes[planeIdx].x );
+			m_y[planeIdx] = _mm_set1_ps( planes[planeIdx].y );
+			m_z[planeIdx] = _mm_set1_ps( planes[planeIdx].z );
+			m_w[planeIdx] = _mm_set1_ps( planes[planeIdx].w );
+			m_absX[planeIdx] = _mm_set1_ps( fabsf( planes[planeIdx].x ) );
+			m_absY[planeIdx] = _mm_set1_ps( fabsf( planes[planeIdx].y ) );
+			m_absZ[planeIdx] = _mm_set1_ps( fabsf( planes[planeIdx].z ) );
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------------------------
+static void AppendVisibleLanes( int visibleMask, int firstIdx, std::vector<int>& out_visibleIndices )
+{
+	for( int lane = 0; lane < 4; ++lane )
+	{
+		if( visibleMask & ( 1 << lane ) )
+		{
+			out_visibleIndices.push_back( firstIdx + lane );
+		}
+	}
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+int Frustum::CullAABBs( FrustumAABBList const& bounds, std::vector<int>& out_visibleIndices ) const
+{
+#if defined( FRUSTUM_USE_SSE )
+	size_t firstOutput = out_visibleIndices.size();
+	int count = bounds.GetCount();
+	FrustumPlanesSSE planes( m_planes );
+	__m128 zero = _mm_setzero_ps();
+
+	int idx = 0;
+	for( ; idx + 4 <= count; idx += 4 )
+	{
+		__m128 centerX = _mm_loadu_ps( &bounds.m_centerX[idx] );
+		__m128 centerY = _mm_loadu_ps( &bounds.m_centerY[idx] );
+		__m128 centerZ = _mm_loadu_ps( &bounds.m_centerZ[idx] );
+		__m128 extentX = _mm_loadu_ps( &bounds.m_extentX[idx] );
+		__m128 extentY = _mm_loadu_ps( &bounds.m_extentY[idx] );
+		__m128 extentZ = _mm_loadu_ps( &bounds.m_extentZ[idx] );
+
+		__m128 isOutside = zero;
+		for( int planeIdx = 0; planeIdx < NUM_FRUSTUM_PLANES; ++planeIdx )
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps( _mm_mul_ps( centerX, planes.m_x[planeIdx] ), _mm_mul_ps( centerY, planes.m_y[planeIdx] ) ),
+				_mm_add_ps( _mm_mul_ps( centerZ, planes.m_z[planeIdx] ), planes.m_w[planeIdx] ) );
+			__m128 radius = _mm_add_ps(
+				_mm_add_ps( _mm_mul_ps( extentX, planes.m_absX[planeIdx] ), _mm_mul_ps( extentY, planes.m_absY[planeIdx] ) ),
+				_mm_mul_ps( extentZ, planes.m_absZ[planeIdx] ) );
+			isOutside = _mm_or_ps( isOutside, _mm_cmplt_ps( _mm_add_ps( distance, radius ), zero ) );
+		}
+
+		AppendVisibleLanes( ~_mm_movemask_ps( isOutside ) & 0xF, idx, out_visibleIndices );
+	}
+
+	for( ; idx < count; ++idx )
+	{
+		if( !IsAABBOutsideAnyPlane( m_planes, bounds.m_centerX[idx], bounds.m_centerY[idx], bounds.m_centerZ[idx], bounds.m_extentX[idx], bounds.m_extentY[idx], bounds.m_extentZ[idx] ) )
+		{
+			out_visibleIndices.push_back( idx );
+		}
+	}
+	return (int)( out_visibleIndices.size() - firstOutput );
+#else
+	return CullAABBsScalar( bounds, out_visibleIndices );
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+int Frustum::CullSpheres( FrustumSphereList const& spheres, std::vector<int>& out_visibleIndices ) const
+{
+#if defined( FRUSTUM_USE_SSE )
+	size_t firstOutput = out_visibleIndices.size();
+	int count = spheres.GetCount();
+	FrustumPlanesSSE planes( m_planes );
+	__m128 zero = _mm_setzero_ps();
+
+	int idx = 0;
+	for( ; idx + 4 <= count; idx += 4 )
+	{
+		__m128 centerX = _mm_loadu_ps( &spheres.m_centerX[idx] );
+		__m128 centerY = _mm_loadu_ps( &spheres.m_centerY[idx] );
+		__m128 centerZ = _mm_loadu_ps( &spheres.m_centerZ[idx] );
+		__m128 radius = _mm_loadu_ps( &spheres.m_radius[idx] );
+
+		__m128 isOutside = zero;
+		for( int planeIdx = 0; planeIdx < NUM_FRUSTUM_PLANES; ++planeIdx )
+		{
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps( _mm_mul_ps( centerX, planes.m_x[planeIdx] ), _mm_mul_ps( centerY, planes.m_y[planeIdx] ) ),
+				_mm_add_ps( _mm_mul_ps( centerZ, planes.m_z[planeIdx] ), planes.m_w[planeIdx] ) );
+			isOutside = _mm_or_ps( isOutside, _mm_cmplt_ps( _mm_add_ps( distance, radius ), zero ) );
+		}
+
+		AppendVisibleLanes( ~_mm_movemask_ps( isOutside ) & 0xF, idx, out_visibleIndices );
+	}
+
+	for( ; idx < count; ++idx )
+	{
+		if( !IsSphereOutsideAnyPlane( m_planes, spheres.m_centerX[idx], spheres.m_centerY[idx], spheres.m_centerZ[idx], spheres.m_radius[idx] ) )
+		{
+			out_visibleIndices.push_back( idx );
+		}
+	}
+	return (int)( out_visibleIndices.size() - firstOutput );
+#else
+	return CullSpheresScalar( spheres, out_visibleIndices );
+#endif
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// CPU-only culling benchmark: a headset-like eye pair (64mm apart, looking down -Z) against random
+// boxes and spheres. Compares culling each eye separately with one pass against the enclosing
+// frustum, scalar against SSE, and checks the two paths agree.
+//-----------------------------------------------------------------------------------------------
+static Mat44 MakeBenchmarkEyeWorldToClip( float eyeOffsetX )
+{
+	float const fovDegrees = 110.f;
+	float const aspect = 0.9f;
+	float const nearZ = 0.05f;
+	float const farZ = 100.f;
+
+	// Right-handed, depth 0 at nearZ and 1 at farZ (what OpenVR hands back for D3D)
+	float height = 1.f / tanf( ConvertDegreesToRadians( fovDegrees * 0.5f ) );
+	float q = farZ / ( nearZ - farZ );
+	float projection[] = {
+		height / aspect,	0.f,		0.f,				0.f,
+		0.f,				height,		0.f,				0.f,
+		0.f,				0.f,		q,					-1.f,
+		0.f,				0.f,		nearZ * q,			0.f
+	};
+
+	Mat44 worldToClip( projection );
+	worldToClip.Translate3D( Vec3( -eyeOffsetX, 0.f, 0.f ) );
+	return worldToClip;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename CullFunc>
+static double TimeCulling( int numIterations, std::vector<int>& visibleIndices, CullFunc cull )
+{
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int iteration = 0; iteration < numIterations; ++iteration )
+	{
+		visibleIndices.clear();
+		cull();
+	}
+	return GetCurrentTimeSeconds() - startSeconds;
+}
+
+//-----------------------------------------------------------------------------------------------
+COMMAND( benchmark_culling, "objects,iterations" )
+{
+	int numObjects = args.GetValue( "objects", 100000 );
+	int numIterations = args.GetValue( "iterations", 100 );
+	if( numObjects <= 0 || numIterations <= 0 ) {
+		g_theConsole->Error( "benchmark_culling: objects and iterations must be positive" );
+		return;
+	}
+
+	RandomNumberGenerator rng;
+	rng.Reset( 1234 );
+	FrustumAABBList boxes;
+	FrustumSphereList spheres;
+	boxes.Reserve( numObjects );
+	spheres.Reserve( numObjects );
+	for( int idx = 0; idx < numObjects; ++idx ) {
+		Vec3 center( rng.RollRandomFloatInRange( -80.f, 80.f ), rng.RollRandomFloatInRange( -80.f, 80.f ), rng.RollRandomFloatInRange( -120.f, 20.f ) );
+		Vec3 halfSize( rng.RollRandomFloatInRange( 0.1f, 2.f ), rng.RollRandomFloatInRange( 0.1f, 2.f ), rng.RollRandomFloatInRange( 0.1f, 2.f ) );
+		boxes.Add( AABB3( center - halfSize, center + halfSize ) );
+		spheres.Add( center, halfSize.GetLength() );
+	}
+
+	Mat44 leftWorldToClip = MakeBenchmarkEyeWorldToClip( -0.032f );
+	Mat44 rightWorldToClip = MakeBenchmarkEyeWorldToClip( 0.032f );
+	Frustum left = Frustum::CreateFromWorldToClip( leftWorldToClip );
+	Frustum right = Frustum::CreateFromWorldToClip( rightWorldToClip );
+	Frustum stereo = Frustum::CreateStereoEnclosing( leftWorldToClip, rightWorldToClip );
+
+	std::vector<int> visible;
+	visible.reserve( 2 * numObjects );
+
+	double perEyeScalar = TimeCulling( numIterations, visible, [&]() { left.CullAABBsScalar( boxes, visible ); right.CullAABBsScalar( boxes, visible ); } );
+	double perEyeSIMD = TimeCulling( numIterations, visible, [&]() { left.CullAABBs( boxes, visible ); right.CullAABBs( boxes, visible ); } );
+	double stereoScalar = TimeCulling( numIterations, visible, [&]() { stereo.CullAABBsScalar( boxes, visible ); } );
+	double stereoSIMD = TimeCulling( numIterations, visible, [&]() { stereo.CullAABBs( boxes, visible ); } );
+	double sphereScalar = TimeCulling( numIterations, visible, [&]() { stereo.CullSpheresScalar( spheres, visible ); } );
+	double sphereSIMD = TimeCulling( numIterations, visible, [&]() { stereo.CullSpheres( spheres, visible ); } );
+
+	// Correctness: SSE == scalar, and the stereo set covers everything either eye sees
+	std::vector<int> scalarVisible;
+	std::vector<int> simdVisible;
+	stereo.CullAABBsScalar( boxes, scalarVisible );
+	stereo.CullAABBs( boxes, simdVisible );
+	bool doPathsAgree = scalarVisible == simdVisible;
+	scalarVisible.clear();
+	simdVisible.clear();
+	stereo.CullSpheresScalar( spheres, scalarVisible );
+	stereo.CullSpheres( spheres, simdVisible );
+	doPathsAgree = doPathsAgree && scalarVisible == simdVisible;
+
+	std::vector<int> stereoVisible;
+	std::vector<int> leftVisible;
+	std::vector<int> rightVisible;
+	stereo.CullAABBs( boxes, stereoVisible );
+	left.CullAABBs( boxes, leftVisible );
+	right.CullAABBs( boxes, rightVisible );
+	std::vector<bool> isInStereoSet( numObjects, false );
+	for( int idx : stereoVisible ) {
+		isInStereoSet[idx] = true;
+	}
+	int numMissed = 0;
+	for( int idx : leftVisible ) {
+		numMissed += isInStereoSet[idx] ? 0 : 1;
+	}
+	for( int idx : rightVisible ) {
+		numMissed += isInStereoSet[idx] ? 0 : 1;
+	}
+
+	double nsPerObject = 1e9 / ( (double)numObjects * (double)numIterations );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Frustum culling, %i objects x %i iterations (ns per object per frame)", numObjects, numIterations ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  AABB per-eye x2:  scalar %.2f  SIMD %.2f", perEyeScalar * nsPerObject, perEyeSIMD * nsPerObject ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  AABB stereo x1:   scalar %.2f  SIMD %.2f", stereoScalar * nsPerObject, stereoSIMD * nsPerObject ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  Sphere stereo x1: scalar %.2f  SIMD %.2f", sphereScalar * nsPerObject, sphereSIMD * nsPerObject ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  visible: left %i, right %i, stereo %i", (int)leftVisible.size(), (int)rightVisible.size(), (int)stereoVisible.size() ) );
+
+	Rgba8 resultColor = doPathsAgree && numMissed == 0 ? Rgba8::GREEN : Rgba8::RED;
+	g_theConsole->PrintString( resultColor, Stringf( "  SIMD matches scalar: %s, objects lost by stereo culling: %i", doPathsAgree ? "yes" : "NO", numMissed ) );
+}
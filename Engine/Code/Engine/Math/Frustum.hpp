@@ -0,0 +1,87 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vec4.hpp"
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+struct AABB3;
+struct Mat44;
+//-----------------------------------------------------------------------------------------------
+
+enum eFrustumPlane
+{
+	FRUSTUM_PLANE_LEFT,
+	FRUSTUM_PLANE_RIGHT,
+	FRUSTUM_PLANE_BOTTOM,
+	FRUSTUM_PLANE_TOP,
+	FRUSTUM_PLANE_NEAR,
+	FRUSTUM_PLANE_FAR,
+
+	NUM_FRUSTUM_PLANES
+};
+
+//-----------------------------------------------------------------------------------------------
+// Bounds laid out structure-of-arrays so the culling kernels can test four at a time
+//-----------------------------------------------------------------------------------------------
+struct FrustumAABBList
+{
+	std::vector<float>	m_centerX;
+	std::vector<float>	m_centerY;
+	std::vector<float>	m_centerZ;
+	std::vector<float>	m_extentX;
+	std::vector<float>	m_extentY;
+	std::vector<float>	m_extentZ;
+
+	void	Clear();
+	void	Reserve( int count );
+	void	Add( AABB3 const& bounds );
+	int		GetCount() const		{ return (int)m_centerX.size(); }
+};
+
+//-----------------------------------------------------------------------------------------------
+struct FrustumSphereList
+{
+	std::vector<float>	m_centerX;
+	std::vector<float>	m_centerY;
+	std::vector<float>	m_centerZ;
+	std::vector<float>	m_radius;
+
+	void	Clear();
+	void	Reserve( int count );
+	void	Add( Vec3 const& center, float radius );
+	int		GetCount() const		{ return (int)m_centerX.size(); }
+};
+
+//-----------------------------------------------------------------------------------------------
+// Six normalized planes (xyz = inward normal, w = distance) built from a D3D-style world-to-clip
+// matrix, clip z in [0,w]. A point p is inside a plane when dot( normal, p ) + w >= 0.
+//-----------------------------------------------------------------------------------------------
+struct Frustum
+{
+public:
+	Vec4 m_planes[NUM_FRUSTUM_PLANES];
+
+public:
+	static Frustum	CreateFromWorldToClip( Mat44 const& worldToClip );
+
+	// One frustum enclosing both eyes' frusta, so a stereo frame culls once for both passes.
+	// Each plane is taken from whichever eye needs the least slack to contain the other eye's
+	// corners, then pushed out by that slack, so it can only keep extra objects, never lose one.
+	static Frustum	CreateStereoEnclosing( Mat44 const& leftWorldToClip, Mat44 const& rightWorldToClip );
+
+	bool	IsPointInside( Vec3 const& point ) const;
+	bool	IsAABBVisible( AABB3 const& bounds ) const;
+	bool	IsSphereVisible( Vec3 const& center, float radius ) const;
+
+	// Appends the index of every visible entry; returns how many were appended. SSE when available.
+	int		CullAABBs( FrustumAABBList const& bounds, std::vector<int>& out_visibleIndices ) const;
+	int		CullSpheres( FrustumSphereList const& spheres, std::vector<int>& out_visibleIndices ) const;
+
+	// Plain C++ versions of the above, for platforms without SSE and for checking the SIMD path
+	int		CullAABBsScalar( FrustumAABBList const& bounds, std::vector<int>& out_visibleIndices ) const;
+	int		CullSpheresScalar( FrustumSphereList const& spheres, std::vector<int>& out_visibleIndices ) const;
+};
+
+//-----------------------------------------------------------------------------------------------
+// The eight corners of a world-to-clip matrix's view volume, in world space
+void GetFrustumCorners( Mat44 const& worldToClip, Vec3 out_corners[8] );
@@ -6,6 +6,11 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) || defined( __SSE__ )
+	#define MAT44_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
 
 Mat44::Mat44( float const* sixteenValuesBasisMajor )
 {
@@ -356,10 +361,44 @@ void Mat44::ScaleNonUniform3D( const Vec3& scaleFactorsXYZ )
 //	return *theRealTranslation;
 //}
 
+#if defined( MAT44_USE_SSE )
+//-----------------------------------------------------------------------------------------------
+// One column of a * b: ( ( a.I * b.x + a.J * b.y ) + a.K * b.z ) + a.T * b.w, the same products summed in the same
+// order as TransformByScalar, so every lane rounds identically
+static __m128 CombineColumns( __m128 aI, __m128 aJ, __m128 aK, __m128 aT, __m128 bColumn )
+{
+	__m128 sum = _mm_mul_ps( aI, _mm_shuffle_ps( bColumn, bColumn, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+	sum = _mm_add_ps( sum, _mm_mul_ps( aJ, _mm_shuffle_ps( bColumn, bColumn, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+	sum = _mm_add_ps( sum, _mm_mul_ps( aK, _mm_shuffle_ps( bColumn, bColumn, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+	return _mm_add_ps( sum, _mm_mul_ps( aT, _mm_shuffle_ps( bColumn, bColumn, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+}
+#endif
+
 void Mat44::TransformBy( const Mat44& arbitraryTransformationToAppend )
+{
+#if defined( MAT44_USE_SSE )
+	// Both matrices are fully loaded before anything is stored, so appending a matrix to itself is safe
+	__m128 aI = _mm_loadu_ps( &Ix );
+	__m128 aJ = _mm_loadu_ps( &Jx );
+	__m128 aK = _mm_loadu_ps( &Kx );
+	__m128 aT = _mm_loadu_ps( &Tx );
+	__m128 bI = _mm_loadu_ps( &arbitraryTransformationToAppend.Ix );
+	__m128 bJ = _mm_loadu_ps( &arbitraryTransformationToAppend.Jx );
+	__m128 bK = _mm_loadu_ps( &arbitraryTransformationToAppend.Kx );
+	__m128 bT = _mm_loadu_ps( &arbitraryTransformationToAppend.Tx );
+	_mm_storeu_ps( &Ix, CombineColumns( aI, aJ, aK, aT, bI ) );
+	_mm_storeu_ps( &Jx, CombineColumns( aI, aJ, aK, aT, bJ ) );
+	_mm_storeu_ps( &Kx, CombineColumns( aI, aJ, aK, aT, bK ) );
+	_mm_storeu_ps( &Tx, CombineColumns( aI, aJ, aK, aT, bT ) );
+#else
+	TransformByScalar( arbitraryTransformationToAppend );
+#endif
+}
+
+void Mat44::TransformByScalar( const Mat44& arbitraryTransformationToAppend )
 {
 	const Mat44 a = *this;
-	const Mat44& b = arbitraryTransformationToAppend; // Nickname
+	const Mat44 b = arbitraryTransformationToAppend; // copied too, so appending a matrix to itself is safe
 	Ix = (a.Ix * b.Ix) + (a.Jx * b.Iy) + (a.Kx * b.Iz) + (a.Tx * b.Iw);
 	Jx = (a.Ix * b.Jx) + (a.Jx * b.Jy) + (a.Kx * b.Jz) + (a.Tx * b.Jw);
 	Kx = (a.Ix * b.Kx) + (a.Jx * b.Ky) + (a.Kx * b.Kz) + (a.Tx * b.Kw);
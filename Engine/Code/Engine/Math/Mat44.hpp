@@ -78,7 +78,8 @@ public:
 	void ScaleNonUniform2D( const Vec2& scaleFactorsXY );
 	void ScaleUniform3D( float uniformScaleXYZ );
 	void ScaleNonUniform3D( const Vec3& scaleFactorsXYZ );
-	void TransformBy( const Mat44& arbitraryTransformationToAppend );
+	void TransformBy( const Mat44& arbitraryTransformationToAppend );		// SSE when available; bit-identical to TransformByScalar
+	void TransformByScalar( const Mat44& arbitraryTransformationToAppend );	// plain C++, for platforms without SSE and for checking the SIMD path
 	// void PushMatrix 
 
 	// Static creation methods to create a matrix of a certain transformation type
@@ -2,11 +2,14 @@
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vec4.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/OBB2.hpp"
 #include "Engine/Math/Capsule2.hpp"
 #include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MatrixUtils.hpp"
 #include <cmath>
 #include <math.h>
 
@@ -127,6 +130,10 @@ float DotProduct( const Vec3& a, const Vec3& b )
 {
 	return ( a.x * b.x ) + ( a.y * b.y ) + ( a.z * b.z );
 }
+float DotProduct4D( const Vec4& a, const Vec4& b )
+{
+	return ( a.x * b.x ) + ( a.y * b.y ) + ( a.z * b.z ) + ( a.w * b.w );
+}
 float CrossProductLength( float Ax, float Ay, float Bx, float By, float Cx, float Cy )
 {
 	// Get the vectors' coordinates.
@@ -565,10 +572,11 @@ const void TransfromVertex( Vertex_PCU& vertex, float uniformScale, float rotati
 
 const void TransfromVertexesArray( const int& numVertexes, Vertex_PCU* vertexesArray, float uniformScale, float rotationDegrees, const Vec2& translation )
 {
-	for( int index = 0; index < numVertexes; index++ ) 
-	{
-		TransfromVertex( vertexesArray[index], uniformScale, rotationDegrees, translation );
-	}
+	// One sin/cos for the whole array, then the batched transform; z is left as it was
+	float c = CosDegrees( rotationDegrees ) * uniformScale;
+	float s = SinDegrees( rotationDegrees ) * uniformScale;
+	Mat44 transform( Vec2( c, s ), Vec2( -s, c ), translation );
+	TransformVertices( transform, vertexesArray, numVertexes );
 }
 
 
@@ -630,6 +638,12 @@ float Round( float value )
 	return (float)(int)value;
 }
 
+float SmoothStep3( float inputZeroToOne )
+{
+	float t = inputZeroToOne;
+	return t * t * ( 3.f - ( 2.f * t ) );
+}
+
 int RoundDownToInt( float value )
 {
 	return (int)floor( value );
@@ -1,10 +1,12 @@
 #pragma once
 #include <vector>
 constexpr float PI = 3.1415926535897932384626433832795f;
+constexpr float fSQRT_3_OVER_3 = 0.5773502691896257645091f;
 
 //Forward type declarations
 struct Vec2;
 struct Vec3;
+struct Vec4;
 struct IntVec2; 
 struct Vertex_PCU;
 struct AABB2;
@@ -28,6 +30,7 @@ float	ClampZeroToOne( float value );
 float	Round( float value );					// round to nearest whole float; x.5 rounds up to x+1
 int		RoundDownToInt( float value );
 int		RoundToNearestInt( float value );
+float	SmoothStep3( float inputZeroToOne );	// 3t^2 - 2t^3, evaluated as t * t * ( 3 - 2t )
 
 //Angle utilities
 float	ConvertDegreesToRadians( float degrees );
@@ -51,6 +54,7 @@ int		GetTaxicabDistance2D( const IntVec2& positionA, const IntVec2& positionB );
 // Dot product
 float	DotProduct2D( const Vec2& a, const Vec2& b );
 float	DotProduct( const Vec3& a, const Vec3& b );
+float	DotProduct4D( const Vec4& a, const Vec4& b );
 float	perpDot( Vec2 A, Vec2 B );
 
 // Cross product
@@ -2,8 +2,22 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/UnitTest.hpp"
 #include <math.h>
+#include <cstring>
+#include <vector>
+
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) || defined( __SSE__ )
+	#define MATRIX_USE_SSE
+	#include <xmmintrin.h>
+#endif
 
 
 const Mat44 MakeOrthographicProjectionMatrixD3D( const Vec3& min, const Vec3& max )
@@ -46,6 +60,17 @@ Mat44 MakePerpsectiveProjectionMatrixD3D( float fovDegrees, float aspectRatio, f
 
 void MatrixTranspose( Mat44& mat )
 {
+#if defined( MATRIX_USE_SSE )
+	__m128 iBasis = _mm_loadu_ps( &mat.Ix );
+	__m128 jBasis = _mm_loadu_ps( &mat.Jx );
+	__m128 kBasis = _mm_loadu_ps( &mat.Kx );
+	__m128 translation = _mm_loadu_ps( &mat.Tx );
+	_MM_TRANSPOSE4_PS( iBasis, jBasis, kBasis, translation );
+	_mm_storeu_ps( &mat.Ix, iBasis );
+	_mm_storeu_ps( &mat.Jx, jBasis );
+	_mm_storeu_ps( &mat.Kx, kBasis );
+	_mm_storeu_ps( &mat.Tx, translation );
+#else
 	/*float transpose[] = {
 		mat.Ix,	mat.Iy, mat.Iz, mat.Iw,
 		mat.Jx, mat.Jy, mat.Jz, mat.Jw,
@@ -74,6 +99,7 @@ void MatrixTranspose( Mat44& mat )
 	mat.Ty = copy.Jw;
 	mat.Tz = copy.Kw;
 	mat.Tw = copy.Tw;
+#endif
 }
 
 void MatrixInvertOrthoNormal( Mat44& mat )
@@ -351,3 +377,525 @@ Mat44 GetInvert( Mat44 const& mat )
 
 	return ret;
 }
+
+//-----------------------------------------------------------------------------------------------
+Mat44 GetAffineInverse( Mat44 const& mat )
+{
+#if defined( MATRIX_USE_SSE )
+	__m128 iBasis = _mm_loadu_ps( &mat.Ix );
+	__m128 jBasis = _mm_loadu_ps( &mat.Jx );
+	__m128 kBasis = _mm_loadu_ps( &mat.Kx );
+	__m128 translation = _mm_loadu_ps( &mat.Tx );
+
+	// Rows of the inverse 3x3 are ( j x k, k x i, i x j ) / det; the w lanes of the cross products come out 0
+	__m128 iYZX = _mm_shuffle_ps( iBasis, iBasis, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	__m128 jYZX = _mm_shuffle_ps( jBasis, jBasis, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	__m128 kYZX = _mm_shuffle_ps( kBasis, kBasis, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	__m128 iZXY = _mm_shuffle_ps( iBasis, iBasis, _MM_SHUFFLE( 3, 1, 0, 2 ) );
+	__m128 jZXY = _mm_shuffle_ps( jBasis, jBasis, _MM_SHUFFLE( 3, 1, 0, 2 ) );
+	__m128 kZXY = _mm_shuffle_ps( kBasis, kBasis, _MM_SHUFFLE( 3, 1, 0, 2 ) );
+	__m128 row0 = _mm_sub_ps( _mm_mul_ps( jYZX, kZXY ), _mm_mul_ps( jZXY, kYZX ) );
+	__m128 row1 = _mm_sub_ps( _mm_mul_ps( kYZX, iZXY ), _mm_mul_ps( kZXY, iYZX ) );
+	__m128 row2 = _mm_sub_ps( _mm_mul_ps( iYZX, jZXY ), _mm_mul_ps( iZXY, jYZX ) );
+
+	__m128 products = _mm_mul_ps( iBasis, row0 );
+	__m128 determinant = _mm_add_ps( products, _mm_shuffle_ps( products, products, _MM_SHUFFLE( 3, 0, 2, 1 ) ) );
+	determinant = _mm_add_ps( determinant, _mm_shuffle_ps( products, products, _MM_SHUFFLE( 3, 1, 0, 2 ) ) );
+	__m128 inverseDeterminant = _mm_div_ps( _mm_set1_ps( 1.f ), _mm_shuffle_ps( determinant, determinant, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+	row0 = _mm_mul_ps( row0, inverseDeterminant );
+	row1 = _mm_mul_ps( row1, inverseDeterminant );
+	row2 = _mm_mul_ps( row2, inverseDeterminant );
+
+	__m128 row3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS( row0, row1, row2, row3 );
+
+	// row0..2 are now the inverse's basis columns; its translation is -( inverse3x3 * t ), with w = 1
+	__m128 rotatedTranslation = _mm_mul_ps( row0, _mm_shuffle_ps( translation, translation, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+	rotatedTranslation = _mm_add_ps( rotatedTranslation, _mm_mul_ps( row1, _mm_shuffle_ps( translation, translation, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+	rotatedTranslation = _mm_add_ps( rotatedTranslation, _mm_mul_ps( row2, _mm_shuffle_ps( translation, translation, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+
+	Mat44 inverse;
+	_mm_storeu_ps( &inverse.Ix, row0 );
+	_mm_storeu_ps( &inverse.Jx, row1 );
+	_mm_storeu_ps( &inverse.Kx, row2 );
+	_mm_storeu_ps( &inverse.Tx, _mm_sub_ps( _mm_set_ps( 1.f, 0.f, 0.f, 0.f ), rotatedTranslation ) );
+	return inverse;
+#else
+	return GetAffineInverseScalar( mat );
+#endif
+}
+
+//-----------------------------------------------------------------------------------------------
+Mat44 GetAffineInverseScalar( Mat44 const& mat )
+{
+	Vec3 iBasis = mat.GetIBasis3D();
+	Vec3 jBasis = mat.GetJBasis3D();
+	Vec3 kBasis = mat.GetKBasis3D();
+	Vec3 row0 = CrossProduct( jBasis, kBasis );
+	Vec3 row1 = CrossProduct( kBasis, iBasis );
+	Vec3 row2 = CrossProduct( iBasis, jBasis );
+
+	float inverseDeterminant = 1.f / DotProduct( iBasis, row0 );
+	row0 *= inverseDeterminant;
+	row1 *= inverseDeterminant;
+	row2 *= inverseDeterminant;
+
+	Mat44 inverse;
+	inverse.SetBasisVectors3D( Vec3( row0.x, row1.x, row2.x ), Vec3( row0.y, row1.y, row2.y ), Vec3( row0.z, row1.z, row2.z ) );
+	inverse.SetTranslation3D( -inverse.TransformVector3D( mat.GetTranslation3D() ) );
+	return inverse;
+}
+
+#if defined( MATRIX_USE_SSE )
+//-----------------------------------------------------------------------------------------------
+// The matrix as one broadcast register per element, to transform four points at once structure-of-arrays
+//-----------------------------------------------------------------------------------------------
+struct MatrixLanes
+{
+	__m128 m_ix, m_iy, m_iz;
+	__m128 m_jx, m_jy, m_jz;
+	__m128 m_kx, m_ky, m_kz;
+	__m128 m_tx, m_ty, m_tz;
+
+	explicit MatrixLanes( Mat44 const& mat )
+		: m_ix( _mm_set1_ps( mat.Ix ) ), m_iy( _mm_set1_ps( mat.Iy ) ), m_iz( _mm_set1_ps( mat.Iz ) )
+		, m_jx( _mm_set1_ps( mat.Jx ) ), m_jy( _mm_set1_ps( mat.Jy ) ), m_jz( _mm_set1_ps( mat.Jz ) )
+		, m_kx( _mm_set1_ps( mat.Kx ) ), m_ky( _mm_set1_ps( mat.Ky ) ), m_kz( _mm_set1_ps( mat.Kz ) )
+		, m_tx( _mm_set1_ps( mat.Tx ) ), m_ty( _mm_set1_ps( mat.Ty ) ), m_tz( _mm_set1_ps( mat.Tz ) )
+	{
+	}
+
+	// ( ( I * x + J * y ) + K * z ) [ + T ], the order Mat44::TransformPosition3D / TransformVector3D use
+	void TransformVectors( __m128& x, __m128& y, __m128& z ) const
+	{
+		__m128 outX = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m_ix, x ), _mm_mul_ps( m_jx, y ) ), _mm_mul_ps( m_kx, z ) );
+		__m128 outY = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m_iy, x ), _mm_mul_ps( m_jy, y ) ), _mm_mul_ps( m_ky, z ) );
+		__m128 outZ = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m_iz, x ), _mm_mul_ps( m_jz, y ) ), _mm_mul_ps( m_kz, z ) );
+		x = outX;
+		y = outY;
+		z = outZ;
+	}
+
+	void TransformPositions( __m128& x, __m128& y, __m128& z ) const
+	{
+		TransformVectors( x, y, z );
+		x = _mm_add_ps( x, m_tx );
+		y = _mm_add_ps( y, m_ty );
+		z = _mm_add_ps( z, m_tz );
+	}
+};
+
+//-----------------------------------------------------------------------------------------------
+// Four packed Vec3s (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) to and from x, y, z registers
+static void LoadVec3x4( Vec3 const* vectors, __m128& out_x, __m128& out_y, __m128& out_z )
+{
+	__m128 a = _mm_loadu_ps( &vectors[0].x );
+	__m128 b = _mm_loadu_ps( &vectors[1].y );
+	__m128 c = _mm_loadu_ps( &vectors[2].z );
+	out_x = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 3, 0 ) );
+	out_y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) ), _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+	out_z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 3, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+}
+
+static void StoreVec3x4( Vec3* out_vectors, __m128 x, __m128 y, __m128 z )
+{
+	__m128 a = _mm_shuffle_ps( _mm_shuffle_ps( x, y, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _mm_shuffle_ps( z, x, _MM_SHUFFLE( 1, 1, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+	__m128 b = _mm_shuffle_ps( _mm_shuffle_ps( y, z, _MM_SHUFFLE( 1, 1, 1, 1 ) ), _mm_shuffle_ps( x, y, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+	__m128 c = _mm_shuffle_ps( _mm_shuffle_ps( z, x, _MM_SHUFFLE( 3, 3, 2, 2 ) ), _mm_shuffle_ps( y, z, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+	_mm_storeu_ps( &out_vectors[0].x, a );
+	_mm_storeu_ps( &out_vectors[1].y, b );
+	_mm_storeu_ps( &out_vectors[2].z, c );
+}
+
+//-----------------------------------------------------------------------------------------------
+// The same for one Vec3 member of four consecutive vertices, which are too far apart to load as one
+template <typename VERTEX_TYPE>
+static void GatherVec3x4( VERTEX_TYPE const* vertices, Vec3 VERTEX_TYPE::* member, __m128& out_x, __m128& out_y, __m128& out_z )
+{
+	Vec3 const& v0 = vertices[0].*member;
+	Vec3 const& v1 = vertices[1].*member;
+	Vec3 const& v2 = vertices[2].*member;
+	Vec3 const& v3 = vertices[3].*member;
+	out_x = _mm_setr_ps( v0.x, v1.x, v2.x, v3.x );
+	out_y = _mm_setr_ps( v0.y, v1.y, v2.y, v3.y );
+	out_z = _mm_setr_ps( v0.z, v1.z, v2.z, v3.z );
+}
+
+template <typename VERTEX_TYPE>
+static void ScatterVec3x4( VERTEX_TYPE* vertices, Vec3 VERTEX_TYPE::* member, __m128 x, __m128 y, __m128 z )
+{
+	float xs[4];
+	float ys[4];
+	float zs[4];
+	_mm_storeu_ps( xs, x );
+	_mm_storeu_ps( ys, y );
+	_mm_storeu_ps( zs, z );
+	for( int lane = 0; lane < 4; ++lane ) {
+		Vec3& vec = vertices[lane].*member;
+		vec.x = xs[lane];
+		vec.y = ys[lane];
+		vec.z = zs[lane];
+	}
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+void TransformPositions( Mat44 const& mat, Vec3 const* positions, Vec3* out_positions, int count )
+{
+	int idx = 0;
+#if defined( MATRIX_USE_SSE )
+	MatrixLanes lanes( mat );
+	for( ; idx + 4 <= count; idx += 4 ) {
+		__m128 x, y, z;
+		LoadVec3x4( &positions[idx], x, y, z );
+		lanes.TransformPositions( x, y, z );
+		StoreVec3x4( &out_positions[idx], x, y, z );
+	}
+#endif
+	for( ; idx < count; ++idx ) {
+		out_positions[idx] = mat.TransformPosition3D( positions[idx] );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void TransformVectors( Mat44 const& mat, Vec3 const* vectors, Vec3* out_vectors, int count )
+{
+	int idx = 0;
+#if defined( MATRIX_USE_SSE )
+	MatrixLanes lanes( mat );
+	for( ; idx + 4 <= count; idx += 4 ) {
+		__m128 x, y, z;
+		LoadVec3x4( &vectors[idx], x, y, z );
+		lanes.TransformVectors( x, y, z );
+		StoreVec3x4( &out_vectors[idx], x, y, z );
+	}
+#endif
+	for( ; idx < count; ++idx ) {
+		out_vectors[idx] = mat.TransformVector3D( vectors[idx] );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void TransformVertices( Mat44 const& mat, Vertex_PCU* vertices, int count )
+{
+	int idx = 0;
+#if defined( MATRIX_USE_SSE )
+	MatrixLanes lanes( mat );
+	for( ; idx + 4 <= count; idx += 4 ) {
+		__m128 x, y, z;
+		GatherVec3x4( &vertices[idx], &Vertex_PCU::m_position, x, y, z );
+		lanes.TransformPositions( x, y, z );
+		ScatterVec3x4( &vertices[idx], &Vertex_PCU::m_position, x, y, z );
+	}
+#endif
+	for( ; idx < count; ++idx ) {
+		vertices[idx].m_position = mat.TransformPosition3D( vertices[idx].m_position );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void TransformVertices( Mat44 const& mat, Vertex_PCUTBN* vertices, int count )
+{
+	int idx = 0;
+#if defined( MATRIX_USE_SSE )
+	MatrixLanes lanes( mat );
+	for( ; idx + 4 <= count; idx += 4 ) {
+		__m128 x, y, z;
+		GatherVec3x4( &vertices[idx], &Vertex_PCUTBN::m_position, x, y, z );
+		lanes.TransformPositions( x, y, z );
+		ScatterVec3x4( &vertices[idx], &Vertex_PCUTBN::m_position, x, y, z );
+
+		Vec3 Vertex_PCUTBN::* const frame[] = { &Vertex_PCUTBN::m_tangent, &Vertex_PCUTBN::m_bitangent, &Vertex_PCUTBN::m_normal };
+		for( Vec3 Vertex_PCUTBN::* member : frame ) {
+			GatherVec3x4( &vertices[idx], member, x, y, z );
+			lanes.TransformVectors( x, y, z );
+			ScatterVec3x4( &vertices[idx], member, x, y, z );
+		}
+	}
+#endif
+	for( ; idx < count; ++idx ) {
+		Vertex_PCUTBN& vertex = vertices[idx];
+		vertex.m_position = mat.TransformPosition3D( vertex.m_position );
+		vertex.m_tangent = mat.TransformVector3D( vertex.m_tangent );
+		vertex.m_bitangent = mat.TransformVector3D( vertex.m_bitangent );
+		vertex.m_normal = mat.TransformVector3D( vertex.m_normal );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// benchmark_matrix: SSE kernels against the scalar paths they replace.
+//	- TransformBy and the batched transforms must be bit-identical to the scalar versions
+//	- GetAffineInverse must agree with the general double-precision GetInvert to a relative 1e-5
+// Random matrices are rotation * non-uniform scale (0.5 to 2) * translation.
+//-----------------------------------------------------------------------------------------------
+static Mat44 MakeBenchmarkMatrix( RandomNumberGenerator& rng, bool isRigid )
+{
+	Vec3 translation( rng.RollRandomFloatInRange( -50.f, 50.f ), rng.RollRandomFloatInRange( -50.f, 50.f ), rng.RollRandomFloatInRange( -50.f, 50.f ) );
+	Vec3 pitchRollYaw( rng.RollRandomFloatInRange( -180.f, 180.f ), rng.RollRandomFloatInRange( -180.f, 180.f ), rng.RollRandomFloatInRange( -180.f, 180.f ) );
+	Mat44 mat = Mat44::FromRotationTranslation( pitchRollYaw, translation );
+	if( !isRigid ) {
+		mat.ScaleNonUniform3D( Vec3( rng.RollRandomFloatInRange( 0.5f, 2.f ), rng.RollRandomFloatInRange( 0.5f, 2.f ), rng.RollRandomFloatInRange( 0.5f, 2.f ) ) );
+	}
+	return mat;
+}
+
+//-----------------------------------------------------------------------------------------------
+static bool AreBitIdentical( float const* a, float const* b, size_t numFloats )
+{
+	return memcmp( a, b, numFloats * sizeof( float ) ) == 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+template <typename BenchFunc>
+static double TimeMatrixBenchmark( int numIterations, BenchFunc bench )
+{
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int iteration = 0; iteration < numIterations; ++iteration ) {
+		bench();
+	}
+	return GetCurrentTimeSeconds() - startSeconds;
+}
+
+//-----------------------------------------------------------------------------------------------
+COMMAND( benchmark_matrix, "count,iterations" )
+{
+	int count = args.GetValue( "count", 100000 );
+	int numIterations = args.GetValue( "iterations", 100 );
+	if( count <= 0 || numIterations <= 0 ) {
+		g_theConsole->Error( "benchmark_matrix: count and iterations must be positive" );
+		return;
+	}
+
+	RandomNumberGenerator rng;
+	rng.Reset( 1234 );
+	int numMatrices = count / 16 + 1;
+	std::vector<Mat44> matrices;
+	matrices.reserve( numMatrices );
+	for( int idx = 0; idx < numMatrices; ++idx ) {
+		matrices.push_back( MakeBenchmarkMatrix( rng, false ) );
+	}
+	std::vector<Vec3> positions;
+	std::vector<Vertex_PCU> pcuVerts( count );
+	std::vector<Vertex_PCUTBN> tbnVerts( count );
+	positions.reserve( count );
+	for( int idx = 0; idx < count; ++idx ) {
+		Vec3 position( rng.RollRandomFloatInRange( -10.f, 10.f ), rng.RollRandomFloatInRange( -10.f, 10.f ), rng.RollRandomFloatInRange( -10.f, 10.f ) );
+		positions.push_back( position );
+		pcuVerts[idx].m_position = position;
+		tbnVerts[idx].m_position = position;
+		tbnVerts[idx].m_tangent = Vec3( 1.f, 0.f, 0.f );
+		tbnVerts[idx].m_bitangent = Vec3( 0.f, 1.f, 0.f );
+		tbnVerts[idx].m_normal = Vec3( position.x, position.y, position.z ).GetNormalized();
+	}
+	Mat44 transform = MakeBenchmarkMatrix( rng, false );
+	Mat44 rigid = MakeBenchmarkMatrix( rng, true );	// for the in-place timings, so repeated passes never overflow
+
+	// Multiply: every matrix with the same transform appended
+	Mat44 scalarProduct;
+	Mat44 simdProduct;
+	double multiplyScalar = TimeMatrixBenchmark( numIterations, [&]() { for( Mat44 const& mat : matrices ) { scalarProduct = mat; scalarProduct.TransformByScalar( transform ); } } );
+	double multiplySIMD = TimeMatrixBenchmark( numIterations, [&]() { for( Mat44 const& mat : matrices ) { simdProduct = mat; simdProduct.TransformBy( transform ); } } );
+	bool isMultiplyExact = true;
+	for( Mat44 const& mat : matrices ) {
+		scalarProduct = mat;
+		simdProduct = mat;
+		scalarProduct.TransformByScalar( transform );
+		simdProduct.TransformBy( transform );
+		isMultiplyExact = isMultiplyExact && AreBitIdentical( scalarProduct.GetAsFloatArray(), simdProduct.GetAsFloatArray(), 16 );
+	}
+
+	// Transpose: exact by construction, checked element by element
+	Mat44 transposed = transform;
+	MatrixTranspose( transposed );
+	bool isTransposeExact = true;
+	for( int row = 0; row < 4; ++row ) {
+		for( int column = 0; column < 4; ++column ) {
+			isTransposeExact = isTransposeExact && transposed.GetAsFloatArray()[column * 4 + row] == transform.GetAsFloatArray()[row * 4 + column];
+		}
+	}
+
+	// Inverse
+	Mat44 inverse;
+	double inverseGeneral = TimeMatrixBenchmark( numIterations, [&]() { for( Mat44 const& mat : matrices ) { inverse = GetInvert( mat ); } } );
+	double inverseScalar = TimeMatrixBenchmark( numIterations, [&]() { for( Mat44 const& mat : matrices ) { inverse = GetAffineInverseScalar( mat ); } } );
+	double inverseSIMD = TimeMatrixBenchmark( numIterations, [&]() { for( Mat44 const& mat : matrices ) { inverse = GetAffineInverse( mat ); } } );
+	float maxInverseError = 0.f;
+	for( Mat44 const& mat : matrices ) {
+		Mat44 reference = GetInvert( mat );
+		Mat44 const candidates[] = { GetAffineInverse( mat ), GetAffineInverseScalar( mat ) };
+		for( Mat44 const& candidate : candidates ) {
+			for( int element = 0; element < 16; ++element ) {
+				float expected = reference.GetAsFloatArray()[element];
+				float error = fabsf( candidate.GetAsFloatArray()[element] - expected ) / ( fabsf( expected ) > 1.f ? fabsf( expected ) : 1.f );
+				maxInverseError = error > maxInverseError ? error : maxInverseError;
+			}
+		}
+	}
+
+	// Positions, out of place
+	std::vector<Vec3> scalarOut( count );
+	std::vector<Vec3> simdOut( count );
+	double positionsScalar = TimeMatrixBenchmark( numIterations, [&]() { for( int idx = 0; idx < count; ++idx ) { scalarOut[idx] = transform.TransformPosition3D( positions[idx] ); } } );
+	double positionsSIMD = TimeMatrixBenchmark( numIterations, [&]() { TransformPositions( transform, positions.data(), simdOut.data(), count ); } );
+	bool isPositionsExact = AreBitIdentical( &scalarOut[0].x, &simdOut[0].x, 3 * (size_t)count );
+	for( int idx = 0; idx < count; ++idx ) {
+		scalarOut[idx] = transform.TransformVector3D( positions[idx] );
+	}
+	TransformVectors( transform, positions.data(), simdOut.data(), count );
+	bool isVectorsExact = AreBitIdentical( &scalarOut[0].x, &simdOut[0].x, 3 * (size_t)count );
+	simdOut = positions;
+	TransformPositions( transform, simdOut.data(), simdOut.data(), count );
+	for( int idx = 0; idx < count; ++idx ) {
+		scalarOut[idx] = transform.TransformPosition3D( positions[idx] );
+	}
+	bool isInPlaceExact = AreBitIdentical( &scalarOut[0].x, &simdOut[0].x, 3 * (size_t)count );
+
+	// Vertex streams, in place
+	std::vector<Vertex_PCU> pcuScalar = pcuVerts;
+	std::vector<Vertex_PCUTBN> tbnScalar = tbnVerts;
+	double pcuScalarTime = TimeMatrixBenchmark( numIterations, [&]() { for( Vertex_PCU& vertex : pcuScalar ) { vertex.m_position = rigid.TransformPosition3D( vertex.m_position ); } } );
+	double pcuSIMDTime = TimeMatrixBenchmark( numIterations, [&]() { TransformVertices( rigid, pcuVerts.data(), count ); } );
+	double tbnScalarTime = TimeMatrixBenchmark( numIterations, [&]() {
+		for( Vertex_PCUTBN& vertex : tbnScalar ) {
+			vertex.m_position = rigid.TransformPosition3D( vertex.m_position );
+			vertex.m_tangent = rigid.TransformVector3D( vertex.m_tangent );
+			vertex.m_bitangent = rigid.TransformVector3D( vertex.m_bitangent );
+			vertex.m_normal = rigid.TransformVector3D( vertex.m_normal );
+		}
+	} );
+	double tbnSIMDTime = TimeMatrixBenchmark( numIterations, [&]() { TransformVertices( rigid, tbnVerts.data(), count ); } );
+	bool isVerticesExact = true;
+	for( int idx = 0; idx < count; ++idx ) {
+		isVerticesExact = isVerticesExact && AreBitIdentical( &pcuScalar[idx].m_position.x, &pcuVerts[idx].m_position.x, 3 );
+		isVerticesExact = isVerticesExact && AreBitIdentical( &tbnScalar[idx].m_position.x, &tbnVerts[idx].m_position.x, 3 );
+		isVerticesExact = isVerticesExact && AreBitIdentical( &tbnScalar[idx].m_tangent.x, &tbnVerts[idx].m_tangent.x, 3 );
+		isVerticesExact = isVerticesExact && AreBitIdentical( &tbnScalar[idx].m_bitangent.x, &tbnVerts[idx].m_bitangent.x, 3 );
+		isVerticesExact = isVerticesExact && AreBitIdentical( &tbnScalar[idx].m_normal.x, &tbnVerts[idx].m_normal.x, 3 );
+	}
+
+	double nsPerMatrix = 1e9 / ( (double)numMatrices * (double)numIterations );
+	double nsPerItem = 1e9 / ( (double)count * (double)numIterations );
+#if defined( MATRIX_USE_SSE )
+	char const* kernelName = "SSE";
+#else
+	char const* kernelName = "scalar fallback";
+#endif
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Matrix kernels (%s), %i matrices / %i points x %i iterations (ns each)", kernelName, numMatrices, count, numIterations ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  multiply:           scalar %.2f  SIMD %.2f  %s", multiplyScalar * nsPerMatrix, multiplySIMD * nsPerMatrix, isMultiplyExact ? "bit-identical" : "MISMATCH" ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  inverse:            general %.2f  affine scalar %.2f  affine SIMD %.2f  max relative error %.2e", inverseGeneral * nsPerMatrix, inverseScalar * nsPerMatrix, inverseSIMD * nsPerMatrix, maxInverseError ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  transpose:          %s", isTransposeExact ? "exact" : "WRONG" ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  positions:          scalar %.2f  SIMD %.2f  %s (vectors %s, in place %s)", positionsScalar * nsPerItem, positionsSIMD * nsPerItem,
+		isPositionsExact ? "bit-identical" : "MISMATCH", isVectorsExact ? "bit-identical" : "MISMATCH", isInPlaceExact ? "bit-identical" : "MISMATCH" ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  Vertex_PCU:         scalar %.2f  SIMD %.2f", pcuScalarTime * nsPerItem, pcuSIMDTime * nsPerItem ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  Vertex_PCUTBN:      scalar %.2f  SIMD %.2f  %s", tbnScalarTime * nsPerItem, tbnSIMDTime * nsPerItem, isVerticesExact ? "bit-identical" : "MISMATCH" ) );
+
+	bool isCorrect = isMultiplyExact && isTransposeExact && maxInverseError <= 1e-5f && isPositionsExact && isVectorsExact && isInPlaceExact && isVerticesExact;
+	g_theConsole->PrintString( isCorrect ? Rgba8::GREEN : Rgba8::RED, isCorrect ? "SIMD matrix kernels match the scalar paths" : "SIMD matrix kernels DISAGREE with the scalar paths" );
+}
+
+//-----------------------------------------------------------------------------------------------
+// The same promises as benchmark_matrix, asserted. Without SSE both sides are the scalar path and this
+// passes trivially; it means something on the SSE build
+//-----------------------------------------------------------------------------------------------
+static bool AreEqualElementwise( float const* a, float const* b, size_t numFloats )
+{
+	for( size_t idx = 0; idx < numFloats; ++idx ) {
+		if( a[idx] != b[idx] ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+UNIT_TEST( MatrixKernelsMatchScalar, "Math" )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 1234 );
+	constexpr int NUM_MATRICES = 200;
+	constexpr int NUM_POINTS = 1003;	// not a multiple of four, so the scalar tail runs too
+
+	int numMultiplyMismatches = 0;
+	int numInverseMismatches = 0;
+	float maxInverseError = 0.f;
+	Mat44 transform = MakeBenchmarkMatrix( rng, false );
+	for( int matrixIdx = 0; matrixIdx < NUM_MATRICES; ++matrixIdx ) {
+		Mat44 mat = MakeBenchmarkMatrix( rng, false );
+		Mat44 scalarProduct = mat;
+		Mat44 simdProduct = mat;
+		scalarProduct.TransformByScalar( transform );
+		simdProduct.TransformBy( transform );
+		numMultiplyMismatches += AreBitIdentical( scalarProduct.GetAsFloatArray(), simdProduct.GetAsFloatArray(), 16 ) ? 0 : 1;
+
+		Mat44 selfProduct = mat;
+		Mat44 expectedSelfProduct = mat;
+		selfProduct.TransformBy( selfProduct );
+		expectedSelfProduct.TransformByScalar( mat );
+		numMultiplyMismatches += AreBitIdentical( selfProduct.GetAsFloatArray(), expectedSelfProduct.GetAsFloatArray(), 16 ) ? 0 : 1;
+
+		// Element equality rather than bits: 0 - 0 and -( 0 ) give zeros of different sign
+		Mat44 simdInverse = GetAffineInverse( mat );
+		Mat44 scalarInverse = GetAffineInverseScalar( mat );
+		numInverseMismatches += AreEqualElementwise( simdInverse.GetAsFloatArray(), scalarInverse.GetAsFloatArray(), 16 ) ? 0 : 1;
+		Mat44 reference = GetInvert( mat );
+		for( int element = 0; element < 16; ++element ) {
+			float expected = reference.GetAsFloatArray()[element];
+			float error = fabsf( simdInverse.GetAsFloatArray()[element] - expected ) / ( fabsf( expected ) > 1.f ? fabsf( expected ) : 1.f );
+			maxInverseError = error > maxInverseError ? error : maxInverseError;
+		}
+	}
+	UNIT_TEST_CHECK_MSG( numMultiplyMismatches == 0, Stringf( "%i products differ from TransformByScalar", numMultiplyMismatches ) );
+	UNIT_TEST_CHECK_MSG( numInverseMismatches == 0, Stringf( "%i affine inverses differ from GetAffineInverseScalar", numInverseMismatches ) );
+	UNIT_TEST_CHECK_MSG( maxInverseError <= 1e-5f, Stringf( "affine inverse off GetInvert by %.2e", maxInverseError ) );
+
+	Mat44 transposed = transform;
+	MatrixTranspose( transposed );
+	bool isTransposeExact = true;
+	for( int row = 0; row < 4; ++row ) {
+		for( int column = 0; column < 4; ++column ) {
+			isTransposeExact = isTransposeExact && transposed.GetAsFloatArray()[column * 4 + row] == transform.GetAsFloatArray()[row * 4 + column];
+		}
+	}
+	UNIT_TEST_CHECK( isTransposeExact );
+
+	std::vector<Vec3> positions;
+	std::vector<Vertex_PCUTBN> vertices( NUM_POINTS );
+	for( int idx = 0; idx < NUM_POINTS; ++idx ) {
+		Vec3 position( rng.RollRandomFloatInRange( -10.f, 10.f ), rng.RollRandomFloatInRange( -10.f, 10.f ), rng.RollRandomFloatInRange( -10.f, 10.f ) );
+		positions.push_back( position );
+		vertices[idx].m_position = position;
+		vertices[idx].m_tangent = Vec3( 1.f, 0.f, 0.f );
+		vertices[idx].m_bitangent = Vec3( 0.f, 1.f, 0.f );
+		vertices[idx].m_normal = position.GetNormalized();
+	}
+	std::vector<Vec3> expectedPositions( NUM_POINTS );
+	std::vector<Vec3> expectedVectors( NUM_POINTS );
+	std::vector<Vertex_PCUTBN> expectedVertices = vertices;
+	for( int idx = 0; idx < NUM_POINTS; ++idx ) {
+		expectedPositions[idx] = transform.TransformPosition3D( positions[idx] );
+		expectedVectors[idx] = transform.TransformVector3D( positions[idx] );
+		expectedVertices[idx].m_position = transform.TransformPosition3D( vertices[idx].m_position );
+		expectedVertices[idx].m_tangent = transform.TransformVector3D( vertices[idx].m_tangent );
+		expectedVertices[idx].m_bitangent = transform.TransformVector3D( vertices[idx].m_bitangent );
+		expectedVertices[idx].m_normal = transform.TransformVector3D( vertices[idx].m_normal );
+	}
+
+	std::vector<Vec3> batched( NUM_POINTS );
+	TransformPositions( transform, positions.data(), batched.data(), NUM_POINTS );
+	UNIT_TEST_CHECK( AreBitIdentical( &expectedPositions[0].x, &batched[0].x, 3 * (size_t)NUM_POINTS ) );
+	TransformVectors( transform, positions.data(), batched.data(), NUM_POINTS );
+	UNIT_TEST_CHECK( AreBitIdentical( &expectedVectors[0].x, &batched[0].x, 3 * (size_t)NUM_POINTS ) );
+	batched = positions;
+	TransformPositions( transform, batched.data(), batched.data(), NUM_POINTS );
+	UNIT_TEST_CHECK( AreBitIdentical( &expectedPositions[0].x, &batched[0].x, 3 * (size_t)NUM_POINTS ) );
+
+	TransformVertices( transform, vertices.data(), NUM_POINTS );
+	bool isVerticesExact = true;
+	for( int idx = 0; idx < NUM_POINTS; ++idx ) {
+		isVerticesExact = isVerticesExact && AreBitIdentical( &expectedVertices[idx].m_position.x, &vertices[idx].m_position.x, 3 );
+		isVerticesExact = isVerticesExact && AreBitIdentical( &expectedVertices[idx].m_tangent.x, &vertices[idx].m_tangent.x, 3 );
+		isVerticesExact = isVerticesExact && AreBitIdentical( &expectedVertices[idx].m_bitangent.x, &vertices[idx].m_bitangent.x, 3 );
+		isVerticesExact = isVerticesExact && AreBitIdentical( &expectedVertices[idx].m_normal.x, &vertices[idx].m_normal.x, 3 );
+	}
+	UNIT_TEST_CHECK( isVerticesExact );
+}
@@ -2,6 +2,8 @@
 
 struct Mat44;
 struct Vec3;
+struct Vertex_PCU;
+struct Vertex_PCUTBN;
 
 const Mat44 MakeOrthographicProjectionMatrixD3D( const Vec3& min, const Vec3& max );
 
@@ -9,8 +11,24 @@ Mat44 MakePerpsectiveProjectionMatrixD3D( float fovDegrees, float aspectRatio, f
 
 
  // Utilities
-void MatrixTranspose( Mat44& mat );
+void MatrixTranspose( Mat44& mat );			// SSE when available
 void MatrixInvertOrthoNormal( Mat44& mat );
 void MatrixInvert( Mat44& mat );
 
 Mat44 GetInvert( Mat44 const& mat );
+
+// Inverse of an affine matrix (bottom row 0,0,0,1) with any invertible 3x3 part, scale and shear included: the
+// linear part by cross products, then the translation. Much cheaper than GetInvert; agrees with it to float precision.
+Mat44 GetAffineInverse( Mat44 const& mat );		// SSE when available
+Mat44 GetAffineInverseScalar( Mat44 const& mat );
+
+// Batched transforms, four at a time with SSE when available. Every lane does the same multiplies and adds, in the
+// same order, as Mat44::TransformPosition3D / TransformVector3D, so results are bit-identical to calling those.
+// The input and output arrays may be the same array.
+void TransformPositions( Mat44 const& mat, Vec3 const* positions, Vec3* out_positions, int count );
+void TransformVectors( Mat44 const& mat, Vec3 const* vectors, Vec3* out_vectors, int count );
+
+// In place on a vertex stream: positions as points and, for Vertex_PCUTBN, the tangent, bitangent and normal as
+// vectors (not renormalized, and not inverse-transposed: use a matrix without non-uniform scale)
+void TransformVertices( Mat44 const& mat, Vertex_PCU* vertices, int count );
+void TransformVertices( Mat44 const& mat, Vertex_PCUTBN* vertices, int count );
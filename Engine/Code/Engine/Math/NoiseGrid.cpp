@@ -0,0 +1,618 @@
+#include "Engine/Math/NoiseGrid.hpp"
+#include "Engine/Math/SmoothNoise.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/UnitTest.hpp"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) || defined( __SSE2__ )
+	#define NOISE_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+extern JobSystem*	g_theJobSystem;
+
+//-----------------------------------------------------------------------------------------------
+// What a band of rows needs to know about the whole grid; 2D grids have depth 1 and mins.z 0
+struct NoiseGrid
+{
+	float*					m_values = nullptr;
+	int						m_width = 0;
+	int						m_height = 0;
+	int						m_depth = 1;
+	int						m_dimensions = 2;
+	Vec3					m_mins;
+	float					m_spacing = 1.f;
+	noise_grid_options_t	m_options;
+};
+
+//-----------------------------------------------------------------------------------------------
+static float ComputeNoiseSample( NoiseGrid const& grid, float posX, float posY, float posZ )
+{
+	noise_grid_options_t const& o = grid.m_options;
+	if( grid.m_dimensions == 2 ) {
+		switch( o.type ) {
+		case NOISE_FRACTAL:	return Compute2dFractalNoise( posX, posY, o.scale, o.num_octaves, o.octave_persistence, o.octave_scale, o.renormalize, o.seed );
+		case NOISE_PERLIN:	return Compute2dPerlinNoise( posX, posY, o.scale, o.num_octaves, o.octave_persistence, o.octave_scale, o.renormalize, o.seed );
+		default:			return Compute2dSimplexNoise( posX, posY, o.scale, o.num_octaves, o.octave_persistence, o.octave_scale, o.renormalize, o.seed );
+		}
+	}
+
+	switch( o.type ) {
+	case NOISE_FRACTAL:	return Compute3dFractalNoise( posX, posY, posZ, o.scale, o.num_octaves, o.octave_persistence, o.octave_scale, o.renormalize, o.seed );
+	case NOISE_PERLIN:	return Compute3dPerlinNoise( posX, posY, posZ, o.scale, o.num_octaves, o.octave_persistence, o.octave_scale, o.renormalize, o.seed );
+	default:			return Compute3dSimplexNoise( posX, posY, posZ, o.scale, o.num_octaves, o.octave_persistence, o.octave_scale, o.renormalize, o.seed );
+	}
+}
+
+#if defined( NOISE_USE_SSE2 )
+//-----------------------------------------------------------------------------------------------
+// Four-lane versions of the SmoothNoise / RawNoise building blocks. Each one performs the same float operations, in
+// the same order, as the scalar code it mirrors, so every lane rounds exactly as a Compute*Noise call would.
+//-----------------------------------------------------------------------------------------------
+constexpr float NOISE_OCTAVE_OFFSET = 0.636764989593174f;		// SmoothNoise.cpp's OCTAVE_OFFSET
+
+//-----------------------------------------------------------------------------------------------
+// SSE2 has no 32-bit mullo; multiply the even and odd lanes as 64-bit and keep the low halves
+static __m128i MultiplyLow32( __m128i a, __m128i b )
+{
+	__m128i evens = _mm_mul_epu32( a, b );
+	__m128i odds = _mm_mul_epu32( _mm_srli_si128( a, 4 ), _mm_srli_si128( b, 4 ) );
+	return _mm_unpacklo_epi32( _mm_shuffle_epi32( evens, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odds, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+// Get1dNoiseUint (SquirrelNoise4); the constants must match RawNoise.hpp
+static __m128i Get1dNoiseUint4( __m128i positions, unsigned int seed )
+{
+	__m128i mangledBits = MultiplyLow32( positions, _mm_set1_epi32( (int) 0xd2a80a23 ) );
+	mangledBits = _mm_add_epi32( mangledBits, _mm_set1_epi32( (int) seed ) );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 7 ) );
+	mangledBits = _mm_add_epi32( mangledBits, _mm_set1_epi32( (int) 0xa884f197 ) );
+	mangledBits = _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 8 ) );
+	mangledBits = MultiplyLow32( mangledBits, _mm_set1_epi32( (int) 0x1b56c4e9 ) );
+	return _mm_xor_si128( mangledBits, _mm_srli_epi32( mangledBits, 11 ) );
+}
+
+static __m128i Get2dNoiseUint4( __m128i indexX, __m128i indexY, unsigned int seed )
+{
+	return Get1dNoiseUint4( _mm_add_epi32( indexX, MultiplyLow32( _mm_set1_epi32( 198491317 ), indexY ) ), seed );
+}
+
+static __m128i Get3dNoiseUint4( __m128i indexX, __m128i indexY, __m128i indexZ, unsigned int seed )
+{
+	__m128i index = _mm_add_epi32( indexX, MultiplyLow32( _mm_set1_epi32( 198491317 ), indexY ) );
+	return Get1dNoiseUint4( _mm_add_epi32( index, MultiplyLow32( _mm_set1_epi32( 6542989 ), indexZ ) ), seed );
+}
+
+//-----------------------------------------------------------------------------------------------
+// Get*NoiseZeroToOne: ( 1 / 0xFFFFFFFF ) * (double) noise, rounded to float; the unsigned noise is offset into int
+// range for the signed conversion and the offset added back, exactly, in double
+static __m128 GetNoiseZeroToOne4( __m128i noise )
+{
+	const double ONE_OVER_MAX_UINT = (1.0 / (double) 0xFFFFFFFF);
+	__m128i offsetNoise = _mm_xor_si128( noise, _mm_set1_epi32( (int) 0x80000000 ) );
+	__m128d offset = _mm_set1_pd( 2147483648.0 );
+	__m128d scale = _mm_set1_pd( ONE_OVER_MAX_UINT );
+	__m128d low = _mm_mul_pd( scale, _mm_add_pd( _mm_cvtepi32_pd( offsetNoise ), offset ) );
+	__m128d high = _mm_mul_pd( scale, _mm_add_pd( _mm_cvtepi32_pd( _mm_shuffle_epi32( offsetNoise, _MM_SHUFFLE( 1, 0, 3, 2 ) ) ), offset ) );
+	return _mm_movelh_ps( _mm_cvtpd_ps( low ), _mm_cvtpd_ps( high ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+// floorf without SSE4.1's roundps: truncate, then step down the lanes that truncation rounded up. Lanes of 2^23 or more
+// are already whole and pass through, and the input's sign is kept so floorf( -0 ) stays -0.
+static __m128 Floor4( __m128 values, __m128i& out_indices )
+{
+	__m128 signBit = _mm_set1_ps( -0.f );
+	__m128i truncated = _mm_cvttps_epi32( values );
+	__m128 floored = _mm_cvtepi32_ps( truncated );
+	__m128 wasRoundedUp = _mm_cmpgt_ps( floored, values );
+	floored = _mm_sub_ps( floored, _mm_and_ps( wasRoundedUp, _mm_set1_ps( 1.f ) ) );
+	out_indices = _mm_add_epi32( truncated, _mm_castps_si128( wasRoundedUp ) );	// the mask is -1 where we stepped down
+
+	__m128 isWhole = _mm_cmpge_ps( _mm_andnot_ps( signBit, values ), _mm_set1_ps( 8388608.f ) );
+	floored = _mm_or_ps( _mm_and_ps( isWhole, values ), _mm_andnot_ps( isWhole, floored ) );
+	return _mm_or_ps( floored, _mm_and_ps( values, signBit ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+static __m128 SmoothStep3_4( __m128 t )
+{
+	return _mm_mul_ps( _mm_mul_ps( t, t ), _mm_sub_ps( _mm_set1_ps( 3.f ), _mm_mul_ps( _mm_set1_ps( 2.f ), t ) ) );
+}
+
+// ( weightA * valueA ) + ( weightB * valueB )
+static __m128 Blend4( __m128 weightA, __m128 valueA, __m128 weightB, __m128 valueB )
+{
+	return _mm_add_ps( _mm_mul_ps( weightA, valueA ), _mm_mul_ps( weightB, valueB ) );
+}
+
+static __m128 Select4( __m128 mask, __m128 ifTrue, __m128 ifFalse )
+{
+	return _mm_or_ps( _mm_and_ps( mask, ifTrue ), _mm_andnot_ps( mask, ifFalse ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+// The 2D Perlin gradient table, computed from the low three bits instead of looked up: entries 0,3,4,7 are (A,B) and
+// the rest (B,A), x is negative for 2-5 and y for 4-7
+static void GetPerlinGradient2D4( __m128i noise, __m128& out_x, __m128& out_y )
+{
+	__m128 a = _mm_set1_ps( 0.923879533f );
+	__m128 b = _mm_set1_ps( 0.382683432f );
+	__m128i index = _mm_and_si128( noise, _mm_set1_epi32( 7 ) );
+	__m128i zero = _mm_setzero_si128();
+	__m128 isXLong = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( _mm_add_epi32( index, _mm_set1_epi32( 1 ) ), _mm_set1_epi32( 2 ) ), zero ) );
+	__m128 xSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( _mm_add_epi32( index, _mm_set1_epi32( 2 ) ), _mm_set1_epi32( 4 ) ), 29 ) );
+	__m128 ySign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( index, _mm_set1_epi32( 4 ) ), 29 ) );
+	out_x = _mm_xor_ps( Select4( isXLong, a, b ), xSign );
+	out_y = _mm_xor_ps( Select4( isXLong, b, a ), ySign );
+}
+
+// The 3D Perlin gradient table: every component is sqrt(3)/3, negative where bit 0 (x), 1 (y) or 2 (z) is set
+static void GetPerlinGradient3D4( __m128i noise, __m128& out_x, __m128& out_y, __m128& out_z )
+{
+	__m128 component = _mm_set1_ps( fSQRT_3_OVER_3 );
+	out_x = _mm_xor_ps( component, _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( noise, _mm_set1_epi32( 1 ) ), 31 ) ) );
+	out_y = _mm_xor_ps( component, _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( noise, _mm_set1_epi32( 2 ) ), 30 ) ) );
+	out_z = _mm_xor_ps( component, _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( noise, _mm_set1_epi32( 4 ) ), 29 ) ) );
+}
+
+//-----------------------------------------------------------------------------------------------
+static __m128 RenormalizeNoise4( __m128 totalNoise, float totalAmplitude, bool renormalize )
+{
+	if( renormalize && totalAmplitude > 0.f ) {
+		totalNoise = _mm_div_ps( totalNoise, _mm_set1_ps( totalAmplitude ) );
+		totalNoise = _mm_add_ps( _mm_mul_ps( totalNoise, _mm_set1_ps( 0.5f ) ), _mm_set1_ps( 0.5f ) );
+		totalNoise = SmoothStep3_4( totalNoise );
+		totalNoise = _mm_sub_ps( _mm_mul_ps( totalNoise, _mm_set1_ps( 2.f ) ), _mm_set1_ps( 1.f ) );
+	}
+	return totalNoise;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Compute2dFractalNoise / Compute2dPerlinNoise on four positions
+static __m128 ComputeNoise2D4( __m128 posX, __m128 posY, noise_grid_options_t const& o )
+{
+	__m128 totalNoise = _mm_setzero_ps();
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	unsigned int seed = o.seed;
+	__m128 invScale = _mm_set1_ps( 1.f / o.scale );
+	__m128 currentX = _mm_mul_ps( posX, invScale );
+	__m128 currentY = _mm_mul_ps( posY, invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < o.num_octaves; ++octaveNum ) {
+		__m128i indexWestX;
+		__m128i indexSouthY;
+		__m128 cellMinsX = Floor4( currentX, indexWestX );
+		__m128 cellMinsY = Floor4( currentY, indexSouthY );
+		__m128i indexEastX = _mm_add_epi32( indexWestX, _mm_set1_epi32( 1 ) );
+		__m128i indexNorthY = _mm_add_epi32( indexSouthY, _mm_set1_epi32( 1 ) );
+		__m128i noiseSW = Get2dNoiseUint4( indexWestX, indexSouthY, seed );
+		__m128i noiseSE = Get2dNoiseUint4( indexEastX, indexSouthY, seed );
+		__m128i noiseNW = Get2dNoiseUint4( indexWestX, indexNorthY, seed );
+		__m128i noiseNE = Get2dNoiseUint4( indexEastX, indexNorthY, seed );
+
+		__m128 displacementX = _mm_sub_ps( currentX, cellMinsX );
+		__m128 displacementY = _mm_sub_ps( currentY, cellMinsY );
+		__m128 weightEast = SmoothStep3_4( displacementX );
+		__m128 weightNorth = SmoothStep3_4( displacementY );
+		__m128 weightWest = _mm_sub_ps( _mm_set1_ps( 1.f ), weightEast );
+		__m128 weightSouth = _mm_sub_ps( _mm_set1_ps( 1.f ), weightNorth );
+
+		__m128 noiseThisOctave;
+		if( o.type == NOISE_FRACTAL ) {
+			__m128 blendSouth = Blend4( weightEast, GetNoiseZeroToOne4( noiseSE ), weightWest, GetNoiseZeroToOne4( noiseSW ) );
+			__m128 blendNorth = Blend4( weightEast, GetNoiseZeroToOne4( noiseNE ), weightWest, GetNoiseZeroToOne4( noiseNW ) );
+			__m128 blendTotal = Blend4( weightSouth, blendSouth, weightNorth, blendNorth );
+			noiseThisOctave = _mm_mul_ps( _mm_set1_ps( 2.f ), _mm_sub_ps( blendTotal, _mm_set1_ps( 0.5f ) ) );
+		}
+		else {
+			__m128 toEastX = _mm_sub_ps( currentX, _mm_add_ps( cellMinsX, _mm_set1_ps( 1.f ) ) );
+			__m128 toNorthY = _mm_sub_ps( currentY, _mm_add_ps( cellMinsY, _mm_set1_ps( 1.f ) ) );
+			__m128 gradientX;
+			__m128 gradientY;
+			GetPerlinGradient2D4( noiseSW, gradientX, gradientY );
+			__m128 dotSouthWest = Blend4( gradientX, displacementX, gradientY, displacementY );
+			GetPerlinGradient2D4( noiseSE, gradientX, gradientY );
+			__m128 dotSouthEast = Blend4( gradientX, toEastX, gradientY, displacementY );
+			GetPerlinGradient2D4( noiseNW, gradientX, gradientY );
+			__m128 dotNorthWest = Blend4( gradientX, displacementX, gradientY, toNorthY );
+			GetPerlinGradient2D4( noiseNE, gradientX, gradientY );
+			__m128 dotNorthEast = Blend4( gradientX, toEastX, gradientY, toNorthY );
+
+			__m128 blendSouth = Blend4( weightEast, dotSouthEast, weightWest, dotSouthWest );
+			__m128 blendNorth = Blend4( weightEast, dotNorthEast, weightWest, dotNorthWest );
+			__m128 blendTotal = Blend4( weightSouth, blendSouth, weightNorth, blendNorth );
+			noiseThisOctave = _mm_mul_ps( blendTotal, _mm_set1_ps( 1.f / 0.662578106f ) );
+		}
+
+		totalNoise = _mm_add_ps( totalNoise, _mm_mul_ps( noiseThisOctave, _mm_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= o.octave_persistence;
+		currentX = _mm_add_ps( _mm_mul_ps( currentX, _mm_set1_ps( o.octave_scale ) ), _mm_set1_ps( NOISE_OCTAVE_OFFSET ) );
+		currentY = _mm_add_ps( _mm_mul_ps( currentY, _mm_set1_ps( o.octave_scale ) ), _mm_set1_ps( NOISE_OCTAVE_OFFSET ) );
+		++seed;
+	}
+
+	return RenormalizeNoise4( totalNoise, totalAmplitude, o.renormalize );
+}
+
+//-----------------------------------------------------------------------------------------------
+// Compute3dFractalNoise / Compute3dPerlinNoise on four positions
+static __m128 ComputeNoise3D4( __m128 posX, __m128 posY, __m128 posZ, noise_grid_options_t const& o )
+{
+	__m128 totalNoise = _mm_setzero_ps();
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	unsigned int seed = o.seed;
+	__m128 invScale = _mm_set1_ps( 1.f / o.scale );
+	__m128 currentX = _mm_mul_ps( posX, invScale );
+	__m128 currentY = _mm_mul_ps( posY, invScale );
+	__m128 currentZ = _mm_mul_ps( posZ, invScale );
+	__m128 one = _mm_set1_ps( 1.f );
+
+	for( unsigned int octaveNum = 0; octaveNum < o.num_octaves; ++octaveNum ) {
+		__m128i indexWestX;
+		__m128i indexSouthY;
+		__m128i indexBelowZ;
+		__m128 cellMinsX = Floor4( currentX, indexWestX );
+		__m128 cellMinsY = Floor4( currentY, indexSouthY );
+		__m128 cellMinsZ = Floor4( currentZ, indexBelowZ );
+		__m128i indexEastX = _mm_add_epi32( indexWestX, _mm_set1_epi32( 1 ) );
+		__m128i indexNorthY = _mm_add_epi32( indexSouthY, _mm_set1_epi32( 1 ) );
+		__m128i indexAboveZ = _mm_add_epi32( indexBelowZ, _mm_set1_epi32( 1 ) );
+		__m128i noiseBelowSW = Get3dNoiseUint4( indexWestX, indexSouthY, indexBelowZ, seed );
+		__m128i noiseBelowSE = Get3dNoiseUint4( indexEastX, indexSouthY, indexBelowZ, seed );
+		__m128i noiseBelowNW = Get3dNoiseUint4( indexWestX, indexNorthY, indexBelowZ, seed );
+		__m128i noiseBelowNE = Get3dNoiseUint4( indexEastX, indexNorthY, indexBelowZ, seed );
+		__m128i noiseAboveSW = Get3dNoiseUint4( indexWestX, indexSouthY, indexAboveZ, seed );
+		__m128i noiseAboveSE = Get3dNoiseUint4( indexEastX, indexSouthY, indexAboveZ, seed );
+		__m128i noiseAboveNW = Get3dNoiseUint4( indexWestX, indexNorthY, indexAboveZ, seed );
+		__m128i noiseAboveNE = Get3dNoiseUint4( indexEastX, indexNorthY, indexAboveZ, seed );
+
+		__m128 displacementX = _mm_sub_ps( currentX, cellMinsX );
+		__m128 displacementY = _mm_sub_ps( currentY, cellMinsY );
+		__m128 displacementZ = _mm_sub_ps( currentZ, cellMinsZ );
+		__m128 weightEast = SmoothStep3_4( displacementX );
+		__m128 weightNorth = SmoothStep3_4( displacementY );
+		__m128 weightAbove = SmoothStep3_4( displacementZ );
+		__m128 weightWest = _mm_sub_ps( one, weightEast );
+		__m128 weightSouth = _mm_sub_ps( one, weightNorth );
+		__m128 weightBelow = _mm_sub_ps( one, weightAbove );
+
+		__m128 belowSW, belowSE, belowNW, belowNE, aboveSW, aboveSE, aboveNW, aboveNE;
+		if( o.type == NOISE_FRACTAL ) {
+			belowSW = GetNoiseZeroToOne4( noiseBelowSW );
+			belowSE = GetNoiseZeroToOne4( noiseBelowSE );
+			belowNW = GetNoiseZeroToOne4( noiseBelowNW );
+			belowNE = GetNoiseZeroToOne4( noiseBelowNE );
+			aboveSW = GetNoiseZeroToOne4( noiseAboveSW );
+			aboveSE = GetNoiseZeroToOne4( noiseAboveSE );
+			aboveNW = GetNoiseZeroToOne4( noiseAboveNW );
+			aboveNE = GetNoiseZeroToOne4( noiseAboveNE );
+		}
+		else {
+			// DotProduct( gradient, displacementFromCorner ) for each corner, as ( gx * dx ) + ( gy * dy ) + ( gz * dz )
+			__m128 toEastX = _mm_sub_ps( currentX, _mm_add_ps( cellMinsX, one ) );
+			__m128 toNorthY = _mm_sub_ps( currentY, _mm_add_ps( cellMinsY, one ) );
+			__m128 toAboveZ = _mm_sub_ps( currentZ, _mm_add_ps( cellMinsZ, one ) );
+			__m128 gradientX;
+			__m128 gradientY;
+			__m128 gradientZ;
+			#define PERLIN_CORNER_DOT( noise, dx, dy, dz ) \
+				( GetPerlinGradient3D4( noise, gradientX, gradientY, gradientZ ), \
+				  _mm_add_ps( Blend4( gradientX, dx, gradientY, dy ), _mm_mul_ps( gradientZ, dz ) ) )
+			belowSW = PERLIN_CORNER_DOT( noiseBelowSW, displacementX, displacementY, displacementZ );
+			belowSE = PERLIN_CORNER_DOT( noiseBelowSE, toEastX, displacementY, displacementZ );
+			belowNW = PERLIN_CORNER_DOT( noiseBelowNW, displacementX, toNorthY, displacementZ );
+			belowNE = PERLIN_CORNER_DOT( noiseBelowNE, toEastX, toNorthY, displacementZ );
+			aboveSW = PERLIN_CORNER_DOT( noiseAboveSW, displacementX, displacementY, toAboveZ );
+			aboveSE = PERLIN_CORNER_DOT( noiseAboveSE, toEastX, displacementY, toAboveZ );
+			aboveNW = PERLIN_CORNER_DOT( noiseAboveNW, displacementX, toNorthY, toAboveZ );
+			aboveNE = PERLIN_CORNER_DOT( noiseAboveNE, toEastX, toNorthY, toAboveZ );
+			#undef PERLIN_CORNER_DOT
+		}
+
+		// 8-way blend (8 -> 4 -> 2 -> 1)
+		__m128 blendBelowSouth = Blend4( weightEast, belowSE, weightWest, belowSW );
+		__m128 blendBelowNorth = Blend4( weightEast, belowNE, weightWest, belowNW );
+		__m128 blendAboveSouth = Blend4( weightEast, aboveSE, weightWest, aboveSW );
+		__m128 blendAboveNorth = Blend4( weightEast, aboveNE, weightWest, aboveNW );
+		__m128 blendBelow = Blend4( weightSouth, blendBelowSouth, weightNorth, blendBelowNorth );
+		__m128 blendAbove = Blend4( weightSouth, blendAboveSouth, weightNorth, blendAboveNorth );
+		__m128 blendTotal = Blend4( weightBelow, blendBelow, weightAbove, blendAbove );
+		__m128 noiseThisOctave;
+		if( o.type == NOISE_FRACTAL ) {
+			noiseThisOctave = _mm_mul_ps( _mm_set1_ps( 2.f ), _mm_sub_ps( blendTotal, _mm_set1_ps( 0.5f ) ) );
+		}
+		else {
+			noiseThisOctave = _mm_mul_ps( blendTotal, _mm_set1_ps( 1.f / 0.793856621f ) );
+		}
+
+		totalNoise = _mm_add_ps( totalNoise, _mm_mul_ps( noiseThisOctave, _mm_set1_ps( currentAmplitude ) ) );
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= o.octave_persistence;
+		currentX = _mm_add_ps( _mm_mul_ps( currentX, _mm_set1_ps( o.octave_scale ) ), _mm_set1_ps( NOISE_OCTAVE_OFFSET ) );
+		currentY = _mm_add_ps( _mm_mul_ps( currentY, _mm_set1_ps( o.octave_scale ) ), _mm_set1_ps( NOISE_OCTAVE_OFFSET ) );
+		currentZ = _mm_add_ps( _mm_mul_ps( currentZ, _mm_set1_ps( o.octave_scale ) ), _mm_set1_ps( NOISE_OCTAVE_OFFSET ) );
+		++seed;
+	}
+
+	return RenormalizeNoise4( totalNoise, totalAmplitude, o.renormalize );
+}
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// One row of the grid, at the given y and z sample indices
+static void FillNoiseRow( NoiseGrid const& grid, int y, int z )
+{
+	float* values = &grid.m_values[ ( (size_t)z * grid.m_height + y ) * grid.m_width ];
+	float posY = grid.m_mins.y + (float)y * grid.m_spacing;
+	float posZ = grid.m_mins.z + (float)z * grid.m_spacing;
+	int x = 0;
+
+#if defined( NOISE_USE_SSE2 )
+	if( grid.m_options.type != NOISE_SIMPLEX ) {
+		__m128 lanePosY = _mm_set1_ps( posY );
+		__m128 lanePosZ = _mm_set1_ps( posZ );
+		__m128 minsX = _mm_set1_ps( grid.m_mins.x );
+		__m128 spacing = _mm_set1_ps( grid.m_spacing );
+		for( ; x + 4 <= grid.m_width; x += 4 ) {
+			__m128 lanePosX = _mm_add_ps( minsX, _mm_mul_ps( _mm_cvtepi32_ps( _mm_setr_epi32( x, x + 1, x + 2, x + 3 ) ), spacing ) );
+			__m128 noise = grid.m_dimensions == 2 ? ComputeNoise2D4( lanePosX, lanePosY, grid.m_options ) : ComputeNoise3D4( lanePosX, lanePosY, lanePosZ, grid.m_options );
+			_mm_storeu_ps( &values[x], noise );
+		}
+	}
+#endif
+
+	for( ; x < grid.m_width; ++x ) {
+		values[x] = ComputeNoiseSample( grid, grid.m_mins.x + (float)x * grid.m_spacing, posY, posZ );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+// Rows are numbered z * height + y
+static void FillNoiseRows( NoiseGrid const& grid, int firstRow, int endRow )
+{
+	for( int row = firstRow; row < endRow; ++row ) {
+		FillNoiseRow( grid, row % grid.m_height, row / grid.m_height );
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+class NoiseGridJob : public Job
+{
+public:
+	NoiseGridJob( NoiseGrid const* grid, int firstRow, int endRow, std::atomic<int>* numBandsLeft )
+		: Job(),
+		m_grid( grid ),
+		m_firstRow( firstRow ),
+		m_endRow( endRow ),
+		m_numBandsLeft( numBandsLeft )
+	{
+		m_jobFlags = JOB_FLAG_DELETE_ON_COMPLETE;
+	}
+
+	virtual void Execute() override
+	{
+		FillNoiseRows( *m_grid, m_firstRow, m_endRow );
+		m_numBandsLeft->fetch_sub( 1 );	// FillNoiseGrid returns, and the grid goes away, once this reaches zero
+	}
+
+	virtual void OnCompleteCallback() override
+	{
+	}
+
+public:
+	NoiseGrid const*	m_grid = nullptr;
+	int					m_firstRow = 0;
+	int					m_endRow = 0;
+	std::atomic<int>*	m_numBandsLeft = nullptr;
+};
+
+//-----------------------------------------------------------------------------------------------
+// Every sample depends only on its own position, so bands of rows can be filled in any order, on any thread
+static void FillNoiseGrid( NoiseGrid const& grid )
+{
+	int numRows = grid.m_height * grid.m_depth;
+	if( grid.m_width <= 0 || numRows <= 0 ) {
+		return;
+	}
+
+	int numBands = 1;
+	if( grid.m_options.use_job_system && g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning() ) {
+		int bandsWanted = 4 * ( (int)g_theJobSystem->m_workerThreads.size() + 1 );	// 4x the threads, so a worker that falls behind holds up little
+		numBands = bandsWanted < numRows ? bandsWanted : numRows;
+	}
+
+	// bands after the first go to the workers; this thread fills band 0 and then waits on the counter
+	std::atomic<int> numBandsLeft( numBands - 1 );
+	for( int bandIdx = 1; bandIdx < numBands; ++bandIdx ) {
+		int firstRow = (int)( (long long)numRows * bandIdx / numBands );
+		int endRow = (int)( (long long)numRows * ( bandIdx + 1 ) / numBands );
+		g_theJobSystem->PostJob( new NoiseGridJob( &grid, firstRow, endRow, &numBandsLeft ) );
+	}
+	FillNoiseRows( grid, 0, (int)( (long long)numRows / numBands ) );
+	while( numBandsLeft.load() > 0 ) {
+		std::this_thread::yield();
+	}
+}
+
+//-----------------------------------------------------------------------------------------------
+void FillNoiseGrid2D( float* out_values, int width, int height, Vec2 const& mins, float spacing, noise_grid_options_t const& options )
+{
+	NoiseGrid grid;
+	grid.m_values = out_values;
+	grid.m_width = width;
+	grid.m_height = height;
+	grid.m_depth = 1;
+	grid.m_dimensions = 2;
+	grid.m_mins = Vec3( mins.x, mins.y, 0.f );
+	grid.m_spacing = spacing;
+	grid.m_options = options;
+	FillNoiseGrid( grid );
+}
+
+//-----------------------------------------------------------------------------------------------
+void FillNoiseGrid3D( float* out_values, int width, int height, int depth, Vec3 const& mins, float spacing, noise_grid_options_t const& options )
+{
+	NoiseGrid grid;
+	grid.m_values = out_values;
+	grid.m_width = width;
+	grid.m_height = height;
+	grid.m_depth = depth;
+	grid.m_dimensions = 3;
+	grid.m_mins = mins;
+	grid.m_spacing = spacing;
+	grid.m_options = options;
+	FillNoiseGrid( grid );
+}
+
+//-----------------------------------------------------------------------------------------------
+// benchmark_noise: per-sample SmoothNoise calls against FillNoiseGrid2D/3D, inline and on the job workers, for each
+// noise type; every grid must match the per-sample loop bit for bit. Also times simplex against Perlin, which
+// SmoothNoise.hpp asks for. 2D grids are size x size; 3D grids are (size/4)^3.
+//-----------------------------------------------------------------------------------------------
+static double FillReferenceGrid( NoiseGrid const& grid, std::vector<float>& out_values )
+{
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int z = 0; z < grid.m_depth; ++z ) {
+		for( int y = 0; y < grid.m_height; ++y ) {
+			for( int x = 0; x < grid.m_width; ++x ) {
+				float posX = grid.m_mins.x + (float)x * grid.m_spacing;
+				float posY = grid.m_mins.y + (float)y * grid.m_spacing;
+				float posZ = grid.m_mins.z + (float)z * grid.m_spacing;
+				out_values[ ( (size_t)z * grid.m_height + y ) * grid.m_width + x ] = ComputeNoiseSample( grid, posX, posY, posZ );
+			}
+		}
+	}
+	return GetCurrentTimeSeconds() - startSeconds;
+}
+
+//-----------------------------------------------------------------------------------------------
+static double FillGridTimed( NoiseGrid const& grid, bool useJobSystem, std::vector<float>& out_values )
+{
+	noise_grid_options_t options = grid.m_options;
+	options.use_job_system = useJobSystem;
+	double startSeconds = GetCurrentTimeSeconds();
+	if( grid.m_dimensions == 2 ) {
+		FillNoiseGrid2D( out_values.data(), grid.m_width, grid.m_height, Vec2( grid.m_mins.x, grid.m_mins.y ), grid.m_spacing, options );
+	}
+	else {
+		FillNoiseGrid3D( out_values.data(), grid.m_width, grid.m_height, grid.m_depth, grid.m_mins, grid.m_spacing, options );
+	}
+	return GetCurrentTimeSeconds() - startSeconds;
+}
+
+//-----------------------------------------------------------------------------------------------
+COMMAND( benchmark_noise, "size,octaves,iterations" )
+{
+	int size = args.GetValue( "size", 256 );
+	int numOctaves = args.GetValue( "octaves", 4 );
+	int numIterations = args.GetValue( "iterations", 5 );
+	if( size < 4 || numOctaves <= 0 || numIterations <= 0 ) {
+		g_theConsole->Error( "benchmark_noise: size must be at least 4, octaves and iterations positive" );
+		return;
+	}
+
+	char const* typeNames[] = { "fractal", "Perlin", "simplex" };
+	bool areAllIdentical = true;
+	double scalarSeconds[2][3] = {};
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Noise grids, %i octaves, %i iterations (ns per sample; %s)", numOctaves, numIterations,
+		g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning() ? "jobs on the JobSystem workers" : "no job workers running, jobs column runs inline" ) );
+
+	for( int dimensions = 2; dimensions <= 3; ++dimensions ) {
+		NoiseGrid grid;
+		grid.m_dimensions = dimensions;
+		grid.m_width = dimensions == 2 ? size : size / 4;
+		grid.m_height = grid.m_width;
+		grid.m_depth = dimensions == 2 ? 1 : grid.m_width;
+		grid.m_mins = Vec3( -37.3f, -12.9f, dimensions == 2 ? 0.f : -5.1f );	// straddles 0, so negative floors are covered
+		grid.m_spacing = 0.173f;
+		grid.m_options.scale = 3.f;
+		grid.m_options.num_octaves = (unsigned int)numOctaves;
+		grid.m_options.seed = 7;
+
+		size_t numSamples = (size_t)grid.m_width * grid.m_height * grid.m_depth;
+		std::vector<float> reference( numSamples );
+		std::vector<float> inlineValues( numSamples );
+		std::vector<float> jobValues( numSamples );
+		double nsPerSample = 1e9 / ( (double)numSamples * (double)numIterations );
+		g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  %iD, %i samples:      per-sample   grid inline   grid jobs", dimensions, (int)numSamples ) );
+
+		for( int typeIdx = 0; typeIdx < 3; ++typeIdx ) {
+			grid.m_options.type = (eNoiseType)typeIdx;
+			double referenceSeconds = 0.0;
+			double inlineSeconds = 0.0;
+			double jobSeconds = 0.0;
+			for( int iteration = 0; iteration < numIterations; ++iteration ) {
+				referenceSeconds += FillReferenceGrid( grid, reference );
+				inlineSeconds += FillGridTimed( grid, false, inlineValues );
+				jobSeconds += FillGridTimed( grid, true, jobValues );
+			}
+			scalarSeconds[dimensions - 2][typeIdx] = referenceSeconds;
+
+			bool isIdentical = memcmp( reference.data(), inlineValues.data(), numSamples * sizeof( float ) ) == 0
+				&& memcmp( reference.data(), jobValues.data(), numSamples * sizeof( float ) ) == 0;
+			areAllIdentical = areAllIdentical && isIdentical;
+			g_theConsole->PrintString( Rgba8::WHITE, Stringf( "    %-8s            %8.1f      %8.1f    %8.1f   %s", typeNames[typeIdx],
+				referenceSeconds * nsPerSample, inlineSeconds * nsPerSample, jobSeconds * nsPerSample, isIdentical ? "bit-identical" : "MISMATCH" ) );
+		}
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  simplex vs Perlin, per-sample: 2D %.2fx, 3D %.2fx the time", scalarSeconds[0][2] / scalarSeconds[0][1], scalarSeconds[1][2] / scalarSeconds[1][1] ) );
+	g_theConsole->PrintString( areAllIdentical ? Rgba8::GREEN : Rgba8::RED, areAllIdentical ? "Noise grids match the per-sample functions" : "Noise grids DIFFER from the per-sample functions" );
+}
+
+//-----------------------------------------------------------------------------------------------
+// Every noise type in 2D and 3D, with one and several octaves, renormalized or not, on grids whose width is not a
+// multiple of four and whose mins straddle 0: FillNoiseGrid2D/3D must match the SmoothNoise calls bit for bit, inline
+// and on the job workers (inline when they are not running)
+//-----------------------------------------------------------------------------------------------
+UNIT_TEST( NoiseGridMatchesSmoothNoise, "Math" )
+{
+	char const* typeNames[] = { "fractal", "Perlin", "simplex" };
+	unsigned int const octaveCounts[] = { 1, 4 };
+	for( int dimensions = 2; dimensions <= 3; ++dimensions ) {
+		NoiseGrid grid;
+		grid.m_dimensions = dimensions;
+		grid.m_width = dimensions == 2 ? 37 : 11;
+		grid.m_height = dimensions == 2 ? 29 : 9;
+		grid.m_depth = dimensions == 2 ? 1 : 7;
+		grid.m_mins = Vec3( -3.3f, -1.9f, dimensions == 2 ? 0.f : -0.7f );
+		grid.m_spacing = 0.173f;
+		grid.m_options.scale = 1.7f;
+		grid.m_options.seed = 11;
+
+		size_t numSamples = (size_t)grid.m_width * grid.m_height * grid.m_depth;
+		std::vector<float> reference( numSamples );
+		std::vector<float> inlineValues( numSamples );
+		std::vector<float> jobValues( numSamples );
+		for( int typeIdx = 0; typeIdx < 3; ++typeIdx ) {
+			for( unsigned int numOctaves : octaveCounts ) {
+				for( int renormalize = 0; renormalize < 2; ++renormalize ) {
+					grid.m_options.type = (eNoiseType)typeIdx;
+					grid.m_options.num_octaves = numOctaves;
+					grid.m_options.renormalize = renormalize != 0;
+					FillReferenceGrid( grid, reference );
+					FillGridTimed( grid, false, inlineValues );
+					FillGridTimed( grid, true, jobValues );
+
+					std::string caseName = Stringf( "%iD %s, %u octaves%s", dimensions, typeNames[typeIdx], numOctaves, renormalize ? ", renormalized" : "" );
+					UNIT_TEST_CHECK_MSG( memcmp( reference.data(), inlineValues.data(), numSamples * sizeof( float ) ) == 0, caseName + ": inline grid differs" );
+					UNIT_TEST_CHECK_MSG( memcmp( reference.data(), jobValues.data(), numSamples * sizeof( float ) ) == 0, caseName + ": job grid differs" );
+				}
+			}
+		}
+	}
+}
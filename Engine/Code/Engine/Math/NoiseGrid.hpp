@@ -0,0 +1,35 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+//-----------------------------------------------------------------------------------------------
+enum eNoiseType
+{
+	NOISE_FRACTAL,
+	NOISE_PERLIN,
+	NOISE_SIMPLEX,
+};
+
+//-----------------------------------------------------------------------------------------------
+// The parameters of the Compute*Noise functions in SmoothNoise.hpp, with the same defaults
+struct noise_grid_options_t
+{
+	eNoiseType		type = NOISE_PERLIN;
+	float			scale = 1.f;
+	unsigned int	num_octaves = 1;
+	float			octave_persistence = 0.5f;
+	float			octave_scale = 2.f;
+	bool			renormalize = true;
+	unsigned int	seed = 0;
+	bool			use_job_system = true;		// spread rows over the JobSystem workers, when they are running
+};
+
+//-----------------------------------------------------------------------------------------------
+// Grids of noise samples, x fastest, bit-identical to calling the SmoothNoise functions per sample:
+//	FillNoiseGrid2D: out_values[ y * width + x ] = Compute2d*Noise( mins.x + (float) x * spacing, mins.y + (float) y * spacing, ... )
+//	FillNoiseGrid3D: out_values[ ( z * height + y ) * width + x ], likewise with mins.z + (float) z * spacing
+// Fractal and Perlin rows are evaluated four samples at a time with SSE2, hashing included; simplex rows one sample
+// at a time. Like the (int) casts in the scalar functions, this assumes scaled positions stay within +/-2^31.
+//-----------------------------------------------------------------------------------------------
+void	FillNoiseGrid2D( float* out_values, int width, int height, Vec2 const& mins, float spacing, noise_grid_options_t const& options = noise_grid_options_t() );
+void	FillNoiseGrid3D( float* out_values, int width, int height, int depth, Vec3 const& mins, float spacing, noise_grid_options_t const& options = noise_grid_options_t() );
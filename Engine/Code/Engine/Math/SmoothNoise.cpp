@@ -1,8 +1,9 @@
 //-----------------------------------------------------------------------------------------------
 // SmoothNoise.cpp
 //
+#include "Engine/Math/SmoothNoise.hpp"
 #include "Engine/Math/RawNoise.hpp"		// for raw bit-noise base functions (SquirrelNoise4)
-#include "Engine/Math/MathUtils.hpp"	// for SmoothStep3(); see "SmoothStep" on Wikipedia
+#include "Engine/Math/MathUtils.hpp"	// for SmoothStep3(), DotProduct(), DotProduct4D(); see "SmoothStep" on Wikipedia
 #include "Engine/Math/Vec2.hpp"			// for Vec2( float x,y ) class/struct
 #include "Engine/Math/Vec3.hpp"			// for Vec3( float x,y,z ) class/struct
 #include "Engine/Math/Vec4.hpp"			// for Vec4( float x,y,z,w ) class/struct
@@ -517,14 +518,14 @@ float Compute3dPerlinNoise( float posX, float posY, float posZ, float scale, uns
 		Vec3 displacementFromAboveNW( currentPos.x - cellMins.x, currentPos.y - cellMaxs.y, currentPos.z - cellMaxs.z );
 		Vec3 displacementFromAboveNE( currentPos.x - cellMaxs.x, currentPos.y - cellMaxs.y, currentPos.z - cellMaxs.z );
 
-		float dotBelowSW = DotProduct3D( gradientBelowSW, displacementFromBelowSW );
-		float dotBelowSE = DotProduct3D( gradientBelowSE, displacementFromBelowSE );
-		float dotBelowNW = DotProduct3D( gradientBelowNW, displacementFromBelowNW );
-		float dotBelowNE = DotProduct3D( gradientBelowNE, displacementFromBelowNE );
-		float dotAboveSW = DotProduct3D( gradientAboveSW, displacementFromAboveSW );
-		float dotAboveSE = DotProduct3D( gradientAboveSE, displacementFromAboveSE );
-		float dotAboveNW = DotProduct3D( gradientAboveNW, displacementFromAboveNW );
-		float dotAboveNE = DotProduct3D( gradientAboveNE, displacementFromAboveNE );
+		float dotBelowSW = DotProduct( gradientBelowSW, displacementFromBelowSW );
+		float dotBelowSE = DotProduct( gradientBelowSE, displacementFromBelowSE );
+		float dotBelowNW = DotProduct( gradientBelowNW, displacementFromBelowNW );
+		float dotBelowNE = DotProduct( gradientBelowNE, displacementFromBelowNE );
+		float dotAboveSW = DotProduct( gradientAboveSW, displacementFromAboveSW );
+		float dotAboveSE = DotProduct( gradientAboveSE, displacementFromAboveSE );
+		float dotAboveNW = DotProduct( gradientAboveNW, displacementFromAboveNW );
+		float dotAboveNE = DotProduct( gradientAboveNE, displacementFromAboveNE );
 
 		// Do a smoothed (nonlinear) weighted average of dot results
 		float weightEast  = SmoothStep3( displacementFromBelowSW.x );
@@ -740,3 +741,205 @@ float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, floa
 	return totalNoise;
 }
 
+
+
+//-----------------------------------------------------------------------------------------------
+// Simplex noise sums one radial "kernel" per corner of the simplex (triangle, tetrahedron) that
+//	contains the position, instead of blending every corner of a square cell: 3 corners in 2D
+//	and 4 in 3D, vs. Perlin's 4 and 8.  Each kernel is (r^2 - d^2)^4 * dot( gradient, d ), and
+//	falls to zero at r^2 = 0.5, so no kernel reaches past its own simplex's neighbors and the
+//	result is continuous.  Gradients, seeding and octaves are the same as Perlin noise above.
+//
+static float GetSimplexCornerContribution2D( const Vec2& gradient, const Vec2& displacementFromCorner )
+{
+	float falloff = 0.5f - DotProduct2D( displacementFromCorner, displacementFromCorner );
+	if( falloff <= 0.f )
+		return 0.f;
+
+	falloff *= falloff;
+	return falloff * falloff * DotProduct2D( gradient, displacementFromCorner );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+static float GetSimplexCornerContribution3D( const Vec3& gradient, const Vec3& displacementFromCorner )
+{
+	float falloff = 0.5f - DotProduct( displacementFromCorner, displacementFromCorner );
+	if( falloff <= 0.f )
+		return 0.f;
+
+	falloff *= falloff;
+	return falloff * falloff * DotProduct( gradient, displacementFromCorner );
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// In 2D, the plane is skewed so that pairs of equilateral triangles become unit squares; the
+//	position's square and which half of it (east-first or north-first) give the 3 corners.
+//
+float Compute2dSimplexNoise( float posX, float posY, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+	const float SKEW_2D = 0.366025403784438647f;	// ( sqrt(3) - 1 ) / 2; triangle grid -> square grid
+	const float UNSKEW_2D = 0.211324865405187118f;	// ( 3 - sqrt(3) ) / 6; square grid -> triangle grid
+	static const Vec2 gradients[ 8 ] = // Same 8 quarter-cardinal unit vectors as 2D Perlin
+	{
+		Vec2( +0.923879533f, +0.382683432f ),	//  22.5 degrees (ENE)
+		Vec2( +0.382683432f, +0.923879533f ),	//  67.5 degrees (NNE)
+		Vec2( -0.382683432f, +0.923879533f ),	// 112.5 degrees (NNW)
+		Vec2( -0.923879533f, +0.382683432f ),	// 157.5 degrees (WNW)
+		Vec2( -0.923879533f, -0.382683432f ),	// 202.5 degrees (WSW)
+		Vec2( -0.382683432f, -0.923879533f ),	// 247.5 degrees (SSW)
+		Vec2( +0.382683432f, -0.923879533f ),	// 292.5 degrees (SSE)
+		Vec2( +0.923879533f, -0.382683432f )	// 337.5 degrees (ESE)
+	};
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vec2 currentPos( posX * invScale, posY * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		// Find the skewed cell, and the position relative to its first (south-west) corner
+		float skew = (currentPos.x + currentPos.y) * SKEW_2D;
+		float cellX = floorf( currentPos.x + skew );
+		float cellY = floorf( currentPos.y + skew );
+		float unskew = (cellX + cellY) * UNSKEW_2D;
+		Vec2 displacementFromFirst( currentPos.x - (cellX - unskew), currentPos.y - (cellY - unskew) );
+
+		// The middle corner is one step east (lower triangle) or one step north (upper triangle)
+		int middleStepX = (displacementFromFirst.x > displacementFromFirst.y) ? 1 : 0;
+		int middleStepY = 1 - middleStepX;
+		Vec2 displacementFromMiddle( displacementFromFirst.x - (float) middleStepX + UNSKEW_2D, displacementFromFirst.y - (float) middleStepY + UNSKEW_2D );
+		Vec2 displacementFromLast( displacementFromFirst.x - 1.f + (2.f * UNSKEW_2D), displacementFromFirst.y - 1.f + (2.f * UNSKEW_2D) );
+
+		int indexX = (int) cellX;
+		int indexY = (int) cellY;
+		unsigned int noiseFirst  = Get2dNoiseUint( indexX, indexY, seed );
+		unsigned int noiseMiddle = Get2dNoiseUint( indexX + middleStepX, indexY + middleStepY, seed );
+		unsigned int noiseLast   = Get2dNoiseUint( indexX + 1, indexY + 1, seed );
+
+		float blendTotal = GetSimplexCornerContribution2D( gradients[ noiseFirst & 0x00000007 ], displacementFromFirst )
+			+ GetSimplexCornerContribution2D( gradients[ noiseMiddle & 0x00000007 ], displacementFromMiddle )
+			+ GetSimplexCornerContribution2D( gradients[ noiseLast & 0x00000007 ], displacementFromLast );
+		float noiseThisOctave = blendTotal * (1.f / SIMPLEX_2D_MAX_VALUE);
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
+
+
+//-----------------------------------------------------------------------------------------------
+// In 3D, space is skewed so that groups of 6 tetrahedra become unit cubes; ranking the position's
+//	x, y, z within its cube picks the tetrahedron, i.e. the order in which to step to the far corner.
+//
+float Compute3dSimplexNoise( float posX, float posY, float posZ, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed )
+{
+	const float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+	const float SKEW_3D = 1.f / 3.f;	// tetrahedral grid -> cube grid
+	const float UNSKEW_3D = 1.f / 6.f;	// cube grid -> tetrahedral grid
+	static const Vec3 gradients[ 8 ] = // Same 8 cube-corner unit vectors as 3D Perlin
+	{
+		Vec3( +fSQRT_3_OVER_3, +fSQRT_3_OVER_3, +fSQRT_3_OVER_3 ),
+		Vec3( -fSQRT_3_OVER_3, +fSQRT_3_OVER_3, +fSQRT_3_OVER_3 ),
+		Vec3( +fSQRT_3_OVER_3, -fSQRT_3_OVER_3, +fSQRT_3_OVER_3 ),
+		Vec3( -fSQRT_3_OVER_3, -fSQRT_3_OVER_3, +fSQRT_3_OVER_3 ),
+		Vec3( +fSQRT_3_OVER_3, +fSQRT_3_OVER_3, -fSQRT_3_OVER_3 ),
+		Vec3( -fSQRT_3_OVER_3, +fSQRT_3_OVER_3, -fSQRT_3_OVER_3 ),
+		Vec3( +fSQRT_3_OVER_3, -fSQRT_3_OVER_3, -fSQRT_3_OVER_3 ),
+		Vec3( -fSQRT_3_OVER_3, -fSQRT_3_OVER_3, -fSQRT_3_OVER_3 )
+	};
+
+	float totalNoise = 0.f;
+	float totalAmplitude = 0.f;
+	float currentAmplitude = 1.f;
+	float invScale = (1.f / scale);
+	Vec3 currentPos( posX * invScale, posY * invScale, posZ * invScale );
+
+	for( unsigned int octaveNum = 0; octaveNum < numOctaves; ++ octaveNum )
+	{
+		// Find the skewed cell, and the position relative to its first (below-south-west) corner
+		float skew = (currentPos.x + currentPos.y + currentPos.z) * SKEW_3D;
+		float cellX = floorf( currentPos.x + skew );
+		float cellY = floorf( currentPos.y + skew );
+		float cellZ = floorf( currentPos.z + skew );
+		float unskew = (cellX + cellY + cellZ) * UNSKEW_3D;
+		Vec3 displacementFromFirst( currentPos.x - (cellX - unskew), currentPos.y - (cellY - unskew), currentPos.z - (cellZ - unskew) );
+
+		// Step along the largest displacement component first, then the next largest
+		const Vec3& d = displacementFromFirst;
+		int secondStepX, secondStepY, secondStepZ; // offsets of the second corner (one step)
+		int thirdStepX, thirdStepY, thirdStepZ; // offsets of the third corner (two steps)
+		if( d.x >= d.y )
+		{
+			if( d.y >= d.z )		{ secondStepX = 1; secondStepY = 0; secondStepZ = 0; thirdStepX = 1; thirdStepY = 1; thirdStepZ = 0; } // X Y Z
+			else if( d.x >= d.z )	{ secondStepX = 1; secondStepY = 0; secondStepZ = 0; thirdStepX = 1; thirdStepY = 0; thirdStepZ = 1; } // X Z Y
+			else					{ secondStepX = 0; secondStepY = 0; secondStepZ = 1; thirdStepX = 1; thirdStepY = 0; thirdStepZ = 1; } // Z X Y
+		}
+		else
+		{
+			if( d.y < d.z )			{ secondStepX = 0; secondStepY = 0; secondStepZ = 1; thirdStepX = 0; thirdStepY = 1; thirdStepZ = 1; } // Z Y X
+			else if( d.x < d.z )	{ secondStepX = 0; secondStepY = 1; secondStepZ = 0; thirdStepX = 0; thirdStepY = 1; thirdStepZ = 1; } // Y Z X
+			else					{ secondStepX = 0; secondStepY = 1; secondStepZ = 0; thirdStepX = 1; thirdStepY = 1; thirdStepZ = 0; } // Y X Z
+		}
+
+		Vec3 displacementFromSecond( d.x - (float) secondStepX + UNSKEW_3D, d.y - (float) secondStepY + UNSKEW_3D, d.z - (float) secondStepZ + UNSKEW_3D );
+		Vec3 displacementFromThird( d.x - (float) thirdStepX + (2.f * UNSKEW_3D), d.y - (float) thirdStepY + (2.f * UNSKEW_3D), d.z - (float) thirdStepZ + (2.f * UNSKEW_3D) );
+		Vec3 displacementFromLast( d.x - 1.f + (3.f * UNSKEW_3D), d.y - 1.f + (3.f * UNSKEW_3D), d.z - 1.f + (3.f * UNSKEW_3D) );
+
+		int indexX = (int) cellX;
+		int indexY = (int) cellY;
+		int indexZ = (int) cellZ;
+		unsigned int noiseFirst  = Get3dNoiseUint( indexX, indexY, indexZ, seed );
+		unsigned int noiseSecond = Get3dNoiseUint( indexX + secondStepX, indexY + secondStepY, indexZ + secondStepZ, seed );
+		unsigned int noiseThird  = Get3dNoiseUint( indexX + thirdStepX, indexY + thirdStepY, indexZ + thirdStepZ, seed );
+		unsigned int noiseLast   = Get3dNoiseUint( indexX + 1, indexY + 1, indexZ + 1, seed );
+
+		float blendTotal = GetSimplexCornerContribution3D( gradients[ noiseFirst & 0x00000007 ], displacementFromFirst )
+			+ GetSimplexCornerContribution3D( gradients[ noiseSecond & 0x00000007 ], displacementFromSecond )
+			+ GetSimplexCornerContribution3D( gradients[ noiseThird & 0x00000007 ], displacementFromThird )
+			+ GetSimplexCornerContribution3D( gradients[ noiseLast & 0x00000007 ], displacementFromLast );
+		float noiseThisOctave = blendTotal * (1.f / SIMPLEX_3D_MAX_VALUE);
+
+		// Accumulate results and prepare for next octave (if any)
+		totalNoise += noiseThisOctave * currentAmplitude;
+		totalAmplitude += currentAmplitude;
+		currentAmplitude *= octavePersistence;
+		currentPos *= octaveScale;
+		currentPos.x += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.y += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		currentPos.z += OCTAVE_OFFSET; // Add "irrational" offset to de-align octave grids
+		++ seed; // Eliminates octaves "echoing" each other (since each octave is uniquely seeded)
+	}
+
+	// Re-normalize total noise to within [-1,1] and fix octaves pulling us far away from limits
+	if( renormalize && totalAmplitude > 0.f )
+	{
+		totalNoise /= totalAmplitude;				// Amplitude exceeds 1.0 if octaves are used
+		totalNoise = (totalNoise * 0.5f) + 0.5f;	// Map to [0,1]
+		totalNoise = SmoothStep3( totalNoise );		// Push towards extents (octaves pull us away)
+		totalNoise = (totalNoise * 2.0f) - 1.f;		// Map back to [-1,1]
+	}
+
+	return totalNoise;
+}
@@ -87,12 +87,20 @@ float Compute4dPerlinNoise( float posX, float posY, float posZ, float posT, floa
 //
 // I'm also not empirically certain firsthand (or entirely convinced) that it's actually
 //	that much faster (if at all) in 2D and 3D (my primary use-cases).  Need to test.
+//	(Tested: see the benchmark_noise console command in NoiseGrid.cpp.)
 //
-// #TODO: Implement simplex noise in 2D, 3D, 4D (1D simplex is identical to 1D Perlin, I think?)
-// #TODO: Test comparative simplex noise implementation in 2D/3D to compare speeds.
+// Same parameters, gradients, seeding and octave handling as the Perlin functions above.
+//
+// #TODO: Implement simplex noise in 4D (1D simplex is identical to 1D Perlin, I think?)
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // WARNING: 3D+ Simplex Noise for texture/image synthesis is protected by U.S. Patent 6,867,776!
+//	(Filed 2002; expired as of 2022.)
 /////////////////////////////////////////////////////////////////////////////////////////////////
+constexpr float SIMPLEX_2D_MAX_VALUE = 0.009996f;	// raw 2D simplex is in [-.009996,.009996] (measured); mapped to ~[-1,1]
+constexpr float SIMPLEX_3D_MAX_VALUE = 0.009289f;	// raw 3D simplex is in [-.009289,.009289] (measured); mapped to ~[-1,1]
+
+float Compute2dSimplexNoise( float posX, float posY, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
+float Compute3dSimplexNoise( float posX, float posY, float posZ, float scale=1.f, unsigned int numOctaves=1, float octavePersistence=0.5f, float octaveScale=2.f, bool renormalize=true, unsigned int seed=0 );
 
 
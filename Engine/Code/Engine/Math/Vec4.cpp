@@ -16,6 +16,11 @@ Vec4::Vec4( float initialX, float initialY, float initialZ, float initialW )
 {
 }
 
+const Vec4 Vec4::operator-( const Vec4& vecToSubtract ) const
+{
+	return Vec4( x - vecToSubtract.x, y - vecToSubtract.y, z - vecToSubtract.z, w - vecToSubtract.w );
+}
+
 const Vec4 Vec4::operator*( const Vec4& vecToMultiply ) const
 {
 	return Vec4( x * vecToMultiply.x, y * vecToMultiply.y, z * vecToMultiply.z, w * vecToMultiply.w );
@@ -28,3 +33,11 @@ void Vec4::operator/=( const float uniformDivisor )
 	z /= uniformDivisor;
 	w /= uniformDivisor;
 }
+
+void Vec4::operator*=( const float uniformScale )
+{
+	x *= uniformScale;
+	y *= uniformScale;
+	z *= uniformScale;
+	w *= uniformScale;
+}
@@ -34,7 +34,7 @@ public:
 	//bool		operator==( const Vec4& compare ) const;		
 	//bool		operator!=( const Vec4& compare ) const;		
 	//const Vec4	operator+( const Vec4& vecToAdd ) const;		
-	//const Vec4	operator-( const Vec4& vecToSubtract ) const;	
+	const Vec4	operator-( const Vec4& vecToSubtract ) const;	
 	//const Vec4	operator-() const;								
 	//const Vec4	operator*( float uniformScale ) const;			
 	const Vec4	operator*( const Vec4& vecToMultiply ) const;	
@@ -43,7 +43,7 @@ public:
 
 	//void		operator+=( const Vec4& vecToAdd );
 	//void		operator-=( const Vec4& vecToSubtract );
-	//void		operator*=( const float uniformScale );
+	void		operator*=( const float uniformScale );
 	void		operator/=( const float uniformDivisor );
 	//void		operator=( const Vec4& copyFrom );
 
@@ -0,0 +1,190 @@
+#include "Engine/Network/BitStream.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cstring>
+
+
+//-------------------------------------------------------------------------------------------------------------
+BitWriter::BitWriter( uint8_t* buffer, size_t capacityBytes )
+	:m_buffer( buffer )
+	,m_capacityBits( capacityBytes * 8 )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void BitWriter::WriteBits( uint32_t value, int numBits )
+{
+	ASSERT_OR_DIE( numBits >= 0 && numBits <= 32, "BitWriter can write at most 32 bits at a time" );
+	if( m_bitPosition + numBits > m_capacityBits )
+	{
+		m_hasOverflowed = true;
+		return;
+	}
+
+	// At most 5 partial bytes; the first write into a byte assigns, so the buffer needn't be cleared
+	while( numBits > 0 )
+	{
+		size_t byteIdx = m_bitPosition >> 3;
+		int bitOffset = (int)( m_bitPosition & 7 );
+		int numBitsThisByte = 8 - bitOffset < numBits ? 8 - bitOffset : numBits;
+		uint8_t chunk = (uint8_t)( ( value & ( ( 1u << numBitsThisByte ) - 1u ) ) << bitOffset );
+
+		if( bitOffset == 0 )
+		{
+			m_buffer[byteIdx] = chunk;
+		}
+		else
+		{
+			m_buffer[byteIdx] |= chunk;
+		}
+
+		value = numBitsThisByte < 32 ? value >> numBitsThisByte : 0;
+		numBits -= numBitsThisByte;
+		m_bitPosition += numBitsThisByte;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void BitWriter::WriteSigned( int32_t value, int numBits )
+{
+	uint32_t zigZag = ( (uint32_t)value << 1 ) ^ (uint32_t)( value >> 31 );
+	WriteBits( zigZag, numBits );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void BitWriter::WriteAlign()
+{
+	int bitOffset = (int)( m_bitPosition & 7 );
+	if( bitOffset != 0 )
+	{
+		WriteBits( 0, 8 - bitOffset );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void BitWriter::WriteBytes( void const* data, size_t numBytes )
+{
+	uint8_t const* bytes = static_cast<uint8_t const*>( data );
+	if( ( m_bitPosition & 7 ) != 0 )
+	{
+		for( size_t byteIdx = 0; byteIdx < numBytes; ++byteIdx )
+		{
+			WriteBits( bytes[byteIdx], 8 );
+		}
+		return;
+	}
+
+	if( m_bitPosition + numBytes * 8 > m_capacityBits )
+	{
+		m_hasOverflowed = true;
+		return;
+	}
+	std::memcpy( &m_buffer[m_bitPosition >> 3], bytes, numBytes );
+	m_bitPosition += numBytes * 8;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void BitWriter::Rewind( size_t bitPosition )
+{
+	m_hasOverflowed = false;
+	if( bitPosition >= m_bitPosition )
+	{
+		return;
+	}
+
+	m_bitPosition = bitPosition;
+
+	// clear the stale high bits of the partial byte so later writes can OR into it
+	int bitOffset = (int)( m_bitPosition & 7 );
+	if( bitOffset != 0 )
+	{
+		m_buffer[m_bitPosition >> 3] &= (uint8_t)( ( 1u << bitOffset ) - 1u );
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+BitReader::BitReader( uint8_t const* buffer, size_t sizeBytes )
+	:m_buffer( buffer )
+	,m_sizeBits( sizeBytes * 8 )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------
+uint32_t BitReader::ReadBits( int numBits )
+{
+	ASSERT_OR_DIE( numBits >= 0 && numBits <= 32, "BitReader can read at most 32 bits at a time" );
+	if( m_bitPosition + numBits > m_sizeBits )
+	{
+		m_hasOverflowed = true;
+		m_bitPosition = m_sizeBits;
+		return 0;
+	}
+
+	uint32_t value = 0;
+	int numBitsRead = 0;
+	while( numBitsRead < numBits )
+	{
+		int bitOffset = (int)( m_bitPosition & 7 );
+		int numBitsThisByte = 8 - bitOffset < numBits - numBitsRead ? 8 - bitOffset : numBits - numBitsRead;
+		uint32_t chunk = ( (uint32_t)m_buffer[m_bitPosition >> 3] >> bitOffset ) & ( ( 1u << numBitsThisByte ) - 1u );
+
+		value |= chunk << numBitsRead;
+		numBitsRead += numBitsThisByte;
+		m_bitPosition += numBitsThisByte;
+	}
+	return value;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int32_t BitReader::ReadSigned( int numBits )
+{
+	uint32_t zigZag = ReadBits( numBits );
+	return (int32_t)( zigZag >> 1 ) ^ -(int32_t)( zigZag & 1u );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void BitReader::ReadAlign()
+{
+	int bitOffset = (int)( m_bitPosition & 7 );
+	if( bitOffset != 0 )
+	{
+		ReadBits( 8 - bitOffset );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool BitReader::ReadBytes( void* out_data, size_t numBytes )
+{
+	uint8_t* bytes = static_cast<uint8_t*>( out_data );
+	if( ( m_bitPosition & 7 ) != 0 )
+	{
+		for( size_t byteIdx = 0; byteIdx < numBytes; ++byteIdx )
+		{
+			bytes[byteIdx] = (uint8_t)ReadBits( 8 );
+		}
+		return !m_hasOverflowed;
+	}
+
+	uint8_t const* source = ReadBytesInPlace( numBytes );
+	if( source == nullptr )
+	{
+		return false;
+	}
+	std::memcpy( bytes, source, numBytes );
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+uint8_t const* BitReader::ReadBytesInPlace( size_t numBytes )
+{
+	if( ( m_bitPosition & 7 ) != 0 || m_bitPosition + numBytes * 8 > m_sizeBits )
+	{
+		m_hasOverflowed = true;
+		m_bitPosition = m_sizeBits;
+		return nullptr;
+	}
+
+	uint8_t const* source = &m_buffer[m_bitPosition >> 3];
+	m_bitPosition += numBytes * 8;
+	return source;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//-------------------------------------------------------------------------------------------------------------
+// Bit-level packing for network payloads. Values are written LSB first into a caller owned byte buffer;
+// writing past the end sets an overflow flag instead of asserting, so a packer can try to fit one more
+// record, Rewind() on overflow and close the datagram.
+//-------------------------------------------------------------------------------------------------------------
+class BitWriter
+{
+public:
+	BitWriter( uint8_t* buffer, size_t capacityBytes );
+
+	void		WriteBits( uint32_t value, int numBits );		// numBits in [0,32]
+	void		WriteBool( bool value )							{ WriteBits( value ? 1u : 0u, 1 ); }
+	void		WriteSigned( int32_t value, int numBits );		// zig-zag encoded, so small magnitudes stay small
+	void		WriteAlign();									// pads with zeros to the next byte boundary
+	void		WriteBytes( void const* data, size_t numBytes );	// memcpy when byte aligned
+
+	size_t		GetBitPosition() const							{ return m_bitPosition; }
+	size_t		GetNumBytesWritten() const						{ return ( m_bitPosition + 7 ) >> 3; }
+	bool		HasOverflowed() const							{ return m_hasOverflowed; }
+	void		Rewind( size_t bitPosition );					// drops everything written after bitPosition
+
+private:
+	uint8_t*	m_buffer = nullptr;
+	size_t		m_capacityBits = 0;
+	size_t		m_bitPosition = 0;
+	bool		m_hasOverflowed = false;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+class BitReader
+{
+public:
+	BitReader( uint8_t const* buffer, size_t sizeBytes );
+
+	uint32_t	ReadBits( int numBits );
+	bool		ReadBool()										{ return ReadBits( 1 ) != 0; }
+	int32_t		ReadSigned( int numBits );
+	void		ReadAlign();
+	bool		ReadBytes( void* out_data, size_t numBytes );
+	uint8_t const*	ReadBytesInPlace( size_t numBytes );			// byte aligned only; nullptr on overflow
+
+	size_t		GetBitPosition() const							{ return m_bitPosition; }
+	bool		HasOverflowed() const							{ return m_hasOverflowed; }	// read past the end; the payload is corrupt
+
+private:
+	uint8_t const*	m_buffer = nullptr;
+	size_t			m_sizeBits = 0;
+	size_t			m_bitPosition = 0;
+	bool			m_hasOverflowed = false;
+};
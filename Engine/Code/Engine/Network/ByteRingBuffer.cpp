@@ -0,0 +1,113 @@
+#include "Engine/Network/ByteRingBuffer.hpp"
+#include <cstring>
+
+
+//-------------------------------------------------------------------------------------------------------------
+ByteRingBuffer::ByteRingBuffer( uint32_t capacity )
+{
+	Reset( capacity );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void ByteRingBuffer::Reset( uint32_t capacity )
+{
+	uint32_t powerOfTwo = 1;
+	while( powerOfTwo < capacity )
+	{
+		powerOfTwo <<= 1;
+	}
+
+	m_buffer.assign( powerOfTwo, 0 );
+	m_mask = powerOfTwo - 1;
+	Clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int ByteRingBuffer::GetReadableSpans( ByteSpan out_spans[2] )
+{
+	uint32_t numReadable = GetNumReadable();
+	if( numReadable == 0 )
+	{
+		return 0;
+	}
+
+	uint32_t start = m_readIndex & m_mask;
+	uint32_t firstBytes = GetCapacity() - start < numReadable ? GetCapacity() - start : numReadable;
+	out_spans[0].m_data = &m_buffer[start];
+	out_spans[0].m_numBytes = firstBytes;
+	if( firstBytes == numReadable )
+	{
+		return 1;
+	}
+
+	out_spans[1].m_data = &m_buffer[0];
+	out_spans[1].m_numBytes = numReadable - firstBytes;
+	return 2;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int ByteRingBuffer::GetWritableSpans( ByteSpan out_spans[2] )
+{
+	uint32_t numWritable = GetNumWritable();
+	if( numWritable == 0 )
+	{
+		return 0;
+	}
+
+	uint32_t start = m_writeIndex & m_mask;
+	uint32_t firstBytes = GetCapacity() - start < numWritable ? GetCapacity() - start : numWritable;
+	out_spans[0].m_data = &m_buffer[start];
+	out_spans[0].m_numBytes = firstBytes;
+	if( firstBytes == numWritable )
+	{
+		return 1;
+	}
+
+	out_spans[1].m_data = &m_buffer[0];
+	out_spans[1].m_numBytes = numWritable - firstBytes;
+	return 2;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool ByteRingBuffer::Write( void const* data, uint32_t numBytes )
+{
+	if( numBytes > GetNumWritable() )
+	{
+		return false;
+	}
+
+	uint8_t const* bytes = static_cast<uint8_t const*>( data );
+	uint32_t start = m_writeIndex & m_mask;
+	uint32_t firstBytes = GetCapacity() - start < numBytes ? GetCapacity() - start : numBytes;
+	std::memcpy( &m_buffer[start], bytes, firstBytes );
+	if( firstBytes < numBytes )
+	{
+		std::memcpy( &m_buffer[0], bytes + firstBytes, numBytes - firstBytes );
+	}
+	m_writeIndex += numBytes;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void ByteRingBuffer::Peek( void* out_data, uint32_t numBytes ) const
+{
+	uint8_t* bytes = static_cast<uint8_t*>( out_data );
+	uint32_t start = m_readIndex & m_mask;
+	uint32_t firstBytes = GetCapacity() - start < numBytes ? GetCapacity() - start : numBytes;
+	std::memcpy( bytes, &m_buffer[start], firstBytes );
+	if( firstBytes < numBytes )
+	{
+		std::memcpy( bytes + firstBytes, &m_buffer[0], numBytes - firstBytes );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+uint8_t const* ByteRingBuffer::GetContiguousReadable( uint32_t numBytes ) const
+{
+	uint32_t start = m_readIndex & m_mask;
+	if( start + numBytes > GetCapacity() )
+	{
+		return nullptr;
+	}
+	return &m_buffer[start];
+}
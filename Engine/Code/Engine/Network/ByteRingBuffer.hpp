@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+// Fixed-capacity byte FIFO for socket streams. The capacity is a power of two and the indices run freely, so
+// the readable (or writable) bytes are at most two contiguous spans - exactly what readv/writev and
+// WSARecv/WSASend want, letting a whole backlog of frames go out in one call even when it wraps.
+//-------------------------------------------------------------------------------------------------------------
+struct ByteSpan
+{
+	uint8_t*	m_data = nullptr;
+	size_t		m_numBytes = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+class ByteRingBuffer
+{
+public:
+	ByteRingBuffer() = default;
+	explicit ByteRingBuffer( uint32_t capacity );
+
+	void			Reset( uint32_t capacity );		// rounded up to a power of two; drops the contents
+	void			Clear()									{ m_readIndex = m_writeIndex = 0; }
+
+	uint32_t		GetCapacity() const						{ return (uint32_t)m_buffer.size(); }
+	uint32_t		GetNumReadable() const					{ return m_writeIndex - m_readIndex; }
+	uint32_t		GetNumWritable() const					{ return GetCapacity() - GetNumReadable(); }
+	bool			IsEmpty() const							{ return m_writeIndex == m_readIndex; }
+
+	// Zero, one or two spans; returns how many
+	int				GetReadableSpans( ByteSpan out_spans[2] );
+	int				GetWritableSpans( ByteSpan out_spans[2] );
+	void			CommitWrite( uint32_t numBytes )		{ m_writeIndex += numBytes; }
+	void			CommitRead( uint32_t numBytes )			{ m_readIndex += numBytes; }
+
+	bool			Write( void const* data, uint32_t numBytes );		// all or nothing
+	void			Peek( void* out_data, uint32_t numBytes ) const;	// copies without consuming; numBytes <= readable
+	uint8_t const*	GetContiguousReadable( uint32_t numBytes ) const;	// nullptr if the first numBytes wrap around
+
+private:
+	std::vector<uint8_t>	m_buffer;
+	uint32_t				m_mask = 0;
+	uint32_t				m_readIndex = 0;
+	uint32_t				m_writeIndex = 0;
+};
@@ -0,0 +1,821 @@
+#include "Engine/Network/NetConnection.hpp"
+#include "Engine/Network/BitStream.hpp"
+#include "Engine/Network/NetworkLinkSimulator.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <cstring>
+
+//-------------------------------------------------------------------------------------------------------------
+// Packet layout (bit-packed, see BitStream):
+//	sequence 16 | ack 16 | ackBits 32 | numMessages 7 | hasAcks 1
+//	per message:
+//		channel 1 | isFragment 1 | [reliable or fragment: messageId 16] | [fragment: fragmentIdx 8 | numFragments 8]
+//		| numBytes 11 | align | bytes
+//-------------------------------------------------------------------------------------------------------------
+constexpr int		PACKET_HEADER_BYTES			= 9;
+constexpr int		NUM_MESSAGES_BYTE_OFFSET	= 8;
+constexpr int		MAX_MESSAGES_PER_PACKET		= 127;
+constexpr int		MAX_RELIABLE_PER_PACKET		= 64;
+constexpr int		MESSAGE_SIZE_BITS			= 11;
+constexpr int		ACK_BITS					= 32;
+constexpr int		NUM_UNRELIABLE_ASSEMBLIES	= 4;
+constexpr double	MIN_RESEND_SECONDS			= 0.05;
+constexpr double	RTT_SMOOTHING				= 0.1;
+constexpr float		LOSS_SMOOTHING				= 0.05f;
+
+static_assert( NET_FRAGMENT_BYTES < ( 1 << MESSAGE_SIZE_BITS ), "message size field is too small" );
+static_assert( NET_FRAGMENT_BYTES + PACKET_HEADER_BYTES + 8 <= NET_MAX_PACKET_BYTES, "a fragment must fit into an empty packet" );
+static_assert( ( NET_RELIABLE_WINDOW & ( NET_RELIABLE_WINDOW - 1 ) ) == 0, "window must divide the id range" );
+static_assert( ( NET_SENT_PACKET_HISTORY & ( NET_SENT_PACKET_HISTORY - 1 ) ) == 0, "history must divide the sequence range" );
+static_assert( NET_MAX_FRAGMENTS < NET_RELIABLE_WINDOW, "a whole reliable message must fit into the window" );
+
+
+//-------------------------------------------------------------------------------------------------------------
+// true if a is newer than b, allowing for wrap-around
+static bool IsSequenceNewer( uint16_t a, uint16_t b )
+{
+	return a != b && (uint16_t)( a - b ) < 0x8000;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// false (and nothing written) if the message doesn't fit into what's left of the packet
+static bool WriteMessage( BitWriter& writer, eNetChannel channel, uint16_t messageId, uint8_t fragmentIdx, uint8_t numFragments, uint8_t const* data, int numBytes )
+{
+	size_t startBitPosition = writer.GetBitPosition();
+	bool isFragment = numFragments > 1;
+
+	writer.WriteBits( (uint32_t)channel, 1 );
+	writer.WriteBool( isFragment );
+	if( channel == eNetChannel::RELIABLE_ORDERED || isFragment )
+	{
+		writer.WriteBits( messageId, 16 );
+	}
+	if( isFragment )
+	{
+		writer.WriteBits( fragmentIdx, 8 );
+		writer.WriteBits( numFragments, 8 );
+	}
+	writer.WriteBits( (uint32_t)numBytes, MESSAGE_SIZE_BITS );
+	writer.WriteAlign();
+	writer.WriteBytes( data, (size_t)numBytes );
+
+	if( writer.HasOverflowed() )
+	{
+		writer.Rewind( startBitPosition );
+		return false;
+	}
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+NetConnection::NetConnection()
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool NetConnection::QueueMessage( eNetChannel channel, void const* data, int numBytes )
+{
+	if( numBytes < 0 )
+	{
+		return false;
+	}
+	int numFragments = numBytes <= NET_FRAGMENT_BYTES ? 1 : ( numBytes + NET_FRAGMENT_BYTES - 1 ) / NET_FRAGMENT_BYTES;
+	if( numFragments > NET_MAX_FRAGMENTS )
+	{
+		return false;
+	}
+
+	uint8_t const* bytes = static_cast<uint8_t const*>( data );
+	if( channel == eNetChannel::RELIABLE_ORDERED )
+	{
+		if( GetNumUnackedReliable() + numFragments > NET_RELIABLE_WINDOW )
+		{
+			return false;
+		}
+
+		// Every fragment is its own reliable entry with a consecutive id; in-order delivery puts them back together
+		for( int fragmentIdx = 0; fragmentIdx < numFragments; ++fragmentIdx )
+		{
+			int fragmentOffset = fragmentIdx * NET_FRAGMENT_BYTES;
+			int fragmentBytes = numBytes - fragmentOffset < NET_FRAGMENT_BYTES ? numBytes - fragmentOffset : NET_FRAGMENT_BYTES;
+
+			OutgoingReliable& entry = m_outgoingReliable[m_nextReliableId % NET_RELIABLE_WINDOW];
+			entry.m_isInUse = true;
+			entry.m_lastSentSeconds = -1.0;
+			entry.m_fragmentIdx = (uint8_t)fragmentIdx;
+			entry.m_numFragments = (uint8_t)numFragments;
+			entry.m_data.assign( bytes + fragmentOffset, bytes + fragmentOffset + fragmentBytes );
+			++m_nextReliableId;
+		}
+		return true;
+	}
+
+	uint16_t messageId = m_nextUnreliableId++;
+	for( int fragmentIdx = 0; fragmentIdx < numFragments; ++fragmentIdx )
+	{
+		int fragmentOffset = fragmentIdx * NET_FRAGMENT_BYTES;
+		int fragmentBytes = numBytes - fragmentOffset < NET_FRAGMENT_BYTES ? numBytes - fragmentOffset : NET_FRAGMENT_BYTES;
+
+		OutgoingUnreliable outgoing;
+		outgoing.m_byteOffset = (uint32_t)m_outgoingUnreliableBytes.size();
+		outgoing.m_numBytes = (uint16_t)fragmentBytes;
+		outgoing.m_messageId = messageId;
+		outgoing.m_fragmentIdx = (uint8_t)fragmentIdx;
+		outgoing.m_numFragments = (uint8_t)numFragments;
+		m_outgoingUnreliable.push_back( outgoing );
+		m_outgoingUnreliableBytes.insert( m_outgoingUnreliableBytes.end(), bytes + fragmentOffset, bytes + fragmentOffset + fragmentBytes );
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool NetConnection::PopReceivedMessage( NetMessage& out_message )
+{
+	if( m_receivedMessages.empty() )
+	{
+		return false;
+	}
+	out_message = std::move( m_receivedMessages.front() );
+	m_receivedMessages.pop();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int NetConnection::GetNumUnackedReliable() const
+{
+	return (int)(uint16_t)( m_nextReliableId - m_oldestUnackedReliableId );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+double NetConnection::GetResendSeconds() const
+{
+	double resendSeconds = m_stats.m_smoothedRttSeconds * 1.5;
+	return resendSeconds > MIN_RESEND_SECONDS ? resendSeconds : MIN_RESEND_SECONDS;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+void NetConnection::WritePackets( double currentSeconds, std::vector<NetPacket>& out_packets )
+{
+	m_nextOutgoingUnreliableIdx = 0;
+
+	size_t numPackets = 0;
+	while( numPackets < (size_t)NET_MAX_PACKETS_PER_TICK )
+	{
+		if( numPackets == out_packets.size() )
+		{
+			out_packets.emplace_back();
+		}
+		if( !WritePacket( currentSeconds, out_packets[numPackets], numPackets == 0 ) )
+		{
+			break;
+		}
+		++numPackets;
+	}
+	out_packets.resize( numPackets );
+
+	// Unreliable data is only good for the tick it was queued in
+	m_stats.m_numUnreliableDropped += m_outgoingUnreliable.size() - m_nextOutgoingUnreliableIdx;
+	m_outgoingUnreliable.clear();
+	m_outgoingUnreliableBytes.clear();
+	m_nextOutgoingUnreliableIdx = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool NetConnection::WritePacket( double currentSeconds, NetPacket& out_packet, bool isFirstOfTick )
+{
+	BitWriter writer( out_packet.m_data, NET_MAX_PACKET_BYTES );
+	writer.WriteBits( m_localSequence, 16 );
+	writer.WriteBits( m_remoteSequence, 16 );
+	writer.WriteBits( m_remoteAckBits, 32 );
+	writer.WriteBits( 0, 8 );		// numMessages and hasAcks, patched below
+
+	SentPacket sentPacket;
+	int numMessages = 0;
+
+	// Reliable first, oldest id first: anything never sent or unacked for longer than the resend time
+	double resendSeconds = GetResendSeconds();
+	for( uint16_t reliableId = m_oldestUnackedReliableId; reliableId != m_nextReliableId; ++reliableId )
+	{
+		if( sentPacket.m_numReliableIds == MAX_RELIABLE_PER_PACKET || numMessages == MAX_MESSAGES_PER_PACKET )
+		{
+			break;
+		}
+
+		OutgoingReliable& entry = m_outgoingReliable[reliableId % NET_RELIABLE_WINDOW];
+		bool wasSent = entry.m_lastSentSeconds >= 0.0;
+		if( !entry.m_isInUse || ( wasSent && currentSeconds - entry.m_lastSentSeconds < resendSeconds ) )
+		{
+			continue;
+		}
+		if( !WriteMessage( writer, eNetChannel::RELIABLE_ORDERED, reliableId, entry.m_fragmentIdx, entry.m_numFragments, entry.m_data.data(), (int)entry.m_data.size() ) )
+		{
+			break;
+		}
+
+		if( wasSent )
+		{
+			++m_stats.m_numReliableResends;
+		}
+		entry.m_lastSentSeconds = currentSeconds;
+		sentPacket.m_reliableIds[sentPacket.m_numReliableIds++] = reliableId;
+		++numMessages;
+	}
+
+	// Then whatever unreliable messages fit, in the order they were queued
+	while( m_nextOutgoingUnreliableIdx < m_outgoingUnreliable.size() && numMessages < MAX_MESSAGES_PER_PACKET )
+	{
+		OutgoingUnreliable const& outgoing = m_outgoingUnreliable[m_nextOutgoingUnreliableIdx];
+		uint8_t const* data = m_outgoingUnreliableBytes.data() + outgoing.m_byteOffset;
+		if( !WriteMessage( writer, eNetChannel::UNRELIABLE, outgoing.m_messageId, outgoing.m_fragmentIdx, outgoing.m_numFragments, data, outgoing.m_numBytes ) )
+		{
+			break;
+		}
+		++m_nextOutgoingUnreliableIdx;
+		++numMessages;
+	}
+
+	// The first packet of a tick always goes out so the remote end keeps getting acks
+	if( numMessages == 0 && !isFirstOfTick )
+	{
+		return false;
+	}
+
+	// ack and ackBits mean nothing until we've heard from the other end
+	out_packet.m_data[NUM_MESSAGES_BYTE_OFFSET] = (uint8_t)( numMessages | ( m_hasReceivedAnyPacket ? 0x80 : 0 ) );
+	out_packet.m_numBytes = (int)writer.GetNumBytesWritten();
+
+	// Record it; whatever was in this slot is a full history old and never got acked
+	SentPacket& slot = m_sentPackets[m_localSequence % NET_SENT_PACKET_HISTORY];
+	if( slot.m_isInUse && !slot.m_isResolved )
+	{
+		OnPacketResolved( slot, false, currentSeconds );
+	}
+	if( (uint16_t)( m_localSequence - m_oldestUnresolvedSequence ) >= NET_SENT_PACKET_HISTORY )
+	{
+		m_oldestUnresolvedSequence = (uint16_t)( m_localSequence - NET_SENT_PACKET_HISTORY + 1 );
+	}
+
+	slot.m_sequence = m_localSequence;
+	slot.m_isInUse = true;
+	slot.m_isResolved = false;
+	slot.m_sentSeconds = currentSeconds;
+	slot.m_numReliableIds = sentPacket.m_numReliableIds;
+	std::memcpy( slot.m_reliableIds, sentPacket.m_reliableIds, sentPacket.m_numReliableIds * sizeof( uint16_t ) );
+
+	++m_localSequence;
+	++m_stats.m_numPacketsSent;
+	m_stats.m_numBytesSent += out_packet.m_numBytes;
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+void NetConnection::ReadPacket( uint8_t const* data, int numBytes, double currentSeconds )
+{
+	struct ReceivedMessage
+	{
+		eNetChannel		m_channel;
+		uint16_t		m_messageId;
+		uint8_t			m_fragmentIdx;
+		uint8_t			m_numFragments;
+		int				m_numBytes;
+		uint8_t const*	m_data;
+	};
+
+	if( numBytes < PACKET_HEADER_BYTES || numBytes > NET_MAX_PACKET_BYTES )
+	{
+		++m_stats.m_numPacketsDiscarded;
+		return;
+	}
+
+	BitReader reader( data, (size_t)numBytes );
+	uint16_t sequence = (uint16_t)reader.ReadBits( 16 );
+	uint16_t ack = (uint16_t)reader.ReadBits( 16 );
+	uint32_t ackBits = reader.ReadBits( 32 );
+	int numMessages = (int)reader.ReadBits( 7 );
+	bool hasAcks = reader.ReadBool();
+
+	// Parse everything before acting on any of it, so a truncated packet is dropped as a whole
+	ReceivedMessage messages[MAX_MESSAGES_PER_PACKET];
+	for( int messageIdx = 0; messageIdx < numMessages; ++messageIdx )
+	{
+		ReceivedMessage& message = messages[messageIdx];
+		message.m_channel = reader.ReadBool() ? eNetChannel::RELIABLE_ORDERED : eNetChannel::UNRELIABLE;
+		bool isFragment = reader.ReadBool();
+		message.m_messageId = ( message.m_channel == eNetChannel::RELIABLE_ORDERED || isFragment ) ? (uint16_t)reader.ReadBits( 16 ) : 0;
+		message.m_fragmentIdx = isFragment ? (uint8_t)reader.ReadBits( 8 ) : 0;
+		message.m_numFragments = isFragment ? (uint8_t)reader.ReadBits( 8 ) : 1;
+		message.m_numBytes = (int)reader.ReadBits( MESSAGE_SIZE_BITS );
+		reader.ReadAlign();
+		message.m_data = reader.ReadBytesInPlace( (size_t)message.m_numBytes );
+
+		bool isValid = message.m_data != nullptr && message.m_numBytes <= NET_FRAGMENT_BYTES
+			&& message.m_numFragments > 0 && message.m_fragmentIdx < message.m_numFragments;
+		if( reader.HasOverflowed() || !isValid )
+		{
+			++m_stats.m_numPacketsDiscarded;
+			return;
+		}
+	}
+
+	if( !RecordRemoteSequence( sequence ) )
+	{
+		++m_stats.m_numPacketsDiscarded;
+		return;
+	}
+	++m_stats.m_numPacketsReceived;
+	m_stats.m_numBytesReceived += numBytes;
+
+	if( hasAcks )
+	{
+		ProcessAcks( ack, ackBits, currentSeconds );
+	}
+
+	for( int messageIdx = 0; messageIdx < numMessages; ++messageIdx )
+	{
+		ReceivedMessage const& message = messages[messageIdx];
+		if( message.m_channel == eNetChannel::RELIABLE_ORDERED )
+		{
+			ReceiveReliable( message.m_messageId, message.m_fragmentIdx, message.m_numFragments, message.m_data, message.m_numBytes );
+		}
+		else
+		{
+			ReceiveUnreliable( message.m_messageId, message.m_fragmentIdx, message.m_numFragments, message.m_data, message.m_numBytes );
+		}
+	}
+	DeliverReliableInOrder();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool NetConnection::RecordRemoteSequence( uint16_t sequence )
+{
+	if( !m_hasReceivedAnyPacket )
+	{
+		m_hasReceivedAnyPacket = true;
+		m_remoteSequence = sequence;
+		m_remoteAckBits = 0;
+		return true;
+	}
+
+	if( IsSequenceNewer( sequence, m_remoteSequence ) )
+	{
+		int shift = (uint16_t)( sequence - m_remoteSequence );
+		m_remoteAckBits = shift < ACK_BITS ? m_remoteAckBits << shift : 0;
+		if( shift <= ACK_BITS )
+		{
+			m_remoteAckBits |= 1u << ( shift - 1 );
+		}
+		m_remoteSequence = sequence;
+		return true;
+	}
+
+	// Older than the newest: only new if it's inside the ack window and not seen yet
+	int age = (uint16_t)( m_remoteSequence - sequence );
+	if( age == 0 || age > ACK_BITS )
+	{
+		return false;
+	}
+	uint32_t bit = 1u << ( age - 1 );
+	if( ( m_remoteAckBits & bit ) != 0 )
+	{
+		return false;
+	}
+	m_remoteAckBits |= bit;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void NetConnection::ProcessAcks( uint16_t ack, uint32_t ackBits, double currentSeconds )
+{
+	// Nothing sent yet, or an ack for a packet we haven't sent: the remote end is confused, ignore it
+	if( m_localSequence == m_oldestUnresolvedSequence || !IsSequenceNewer( m_localSequence, ack ) )
+	{
+		return;
+	}
+
+	for( int ackIdx = 0; ackIdx <= ACK_BITS; ++ackIdx )
+	{
+		if( ackIdx > 0 && ( ackBits & ( 1u << ( ackIdx - 1 ) ) ) == 0 )
+		{
+			continue;
+		}
+
+		uint16_t sequence = (uint16_t)( ack - ackIdx );
+		SentPacket& sentPacket = m_sentPackets[sequence % NET_SENT_PACKET_HISTORY];
+		if( sentPacket.m_isInUse && !sentPacket.m_isResolved && sentPacket.m_sequence == sequence )
+		{
+			OnPacketResolved( sentPacket, true, currentSeconds );
+		}
+	}
+
+	// Anything older than the ack window that still isn't acked never will be
+	uint16_t lossHorizon = (uint16_t)( ack - ACK_BITS );
+	while( m_oldestUnresolvedSequence != m_localSequence )
+	{
+		SentPacket& sentPacket = m_sentPackets[m_oldestUnresolvedSequence % NET_SENT_PACKET_HISTORY];
+		bool isStillPending = sentPacket.m_isInUse && !sentPacket.m_isResolved && sentPacket.m_sequence == m_oldestUnresolvedSequence;
+		if( isStillPending )
+		{
+			if( !IsSequenceNewer( lossHorizon, m_oldestUnresolvedSequence ) )
+			{
+				break;
+			}
+			OnPacketResolved( sentPacket, false, currentSeconds );
+		}
+		++m_oldestUnresolvedSequence;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void NetConnection::OnPacketResolved( SentPacket& sentPacket, bool wasAcked, double currentSeconds )
+{
+	sentPacket.m_isResolved = true;
+	m_stats.m_packetLossFraction = m_stats.m_packetLossFraction * ( 1.f - LOSS_SMOOTHING ) + ( wasAcked ? 0.f : LOSS_SMOOTHING );
+
+	if( !wasAcked )
+	{
+		++m_stats.m_numPacketsLost;
+
+		// Don't wait out the resend timer for reliable messages we know were lost
+		for( int idx = 0; idx < sentPacket.m_numReliableIds; ++idx )
+		{
+			OutgoingReliable& entry = m_outgoingReliable[sentPacket.m_reliableIds[idx] % NET_RELIABLE_WINDOW];
+			if( entry.m_isInUse && entry.m_lastSentSeconds >= 0.0 && entry.m_lastSentSeconds <= sentPacket.m_sentSeconds )
+			{
+				entry.m_lastSentSeconds = 0.0;
+			}
+		}
+		return;
+	}
+
+	++m_stats.m_numPacketsAcked;
+	double rttSample = currentSeconds - sentPacket.m_sentSeconds;
+	m_stats.m_smoothedRttSeconds = m_stats.m_smoothedRttSeconds * ( 1.0 - RTT_SMOOTHING ) + rttSample * RTT_SMOOTHING;
+
+	int numUnacked = GetNumUnackedReliable();
+	for( int idx = 0; idx < sentPacket.m_numReliableIds; ++idx )
+	{
+		uint16_t reliableId = sentPacket.m_reliableIds[idx];
+		if( (uint16_t)( reliableId - m_oldestUnackedReliableId ) >= numUnacked )
+		{
+			continue;	// acked through an earlier packet already
+		}
+
+		OutgoingReliable& entry = m_outgoingReliable[reliableId % NET_RELIABLE_WINDOW];
+		entry.m_isInUse = false;
+		entry.m_data.clear();
+	}
+
+	while( m_oldestUnackedReliableId != m_nextReliableId && !m_outgoingReliable[m_oldestUnackedReliableId % NET_RELIABLE_WINDOW].m_isInUse )
+	{
+		++m_oldestUnackedReliableId;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+void NetConnection::ReceiveReliable( uint16_t messageId, uint8_t fragmentIdx, uint8_t numFragments, uint8_t const* data, int numBytes )
+{
+	// Already delivered (a resend whose ack got lost) or too far ahead to buffer
+	if( (uint16_t)( messageId - m_nextDeliveredReliableId ) >= NET_RELIABLE_WINDOW )
+	{
+		return;
+	}
+
+	IncomingReliable& entry = m_incomingReliable[messageId % NET_RELIABLE_WINDOW];
+	if( entry.m_isReceived )
+	{
+		return;
+	}
+	entry.m_isReceived = true;
+	entry.m_fragmentIdx = fragmentIdx;
+	entry.m_numFragments = numFragments;
+	entry.m_data.assign( data, data + numBytes );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void NetConnection::DeliverReliableInOrder()
+{
+	for( ;; )
+	{
+		IncomingReliable& first = m_incomingReliable[m_nextDeliveredReliableId % NET_RELIABLE_WINDOW];
+		if( !first.m_isReceived )
+		{
+			return;
+		}
+
+		// A fragmented message goes out once all of its fragments are in
+		int numFragments = first.m_fragmentIdx == 0 ? first.m_numFragments : 1;
+		for( int fragmentIdx = 1; fragmentIdx < numFragments; ++fragmentIdx )
+		{
+			if( !m_incomingReliable[( m_nextDeliveredReliableId + fragmentIdx ) % NET_RELIABLE_WINDOW].m_isReceived )
+			{
+				return;
+			}
+		}
+
+		NetMessage message;
+		message.m_channel = eNetChannel::RELIABLE_ORDERED;
+		if( numFragments == 1 )
+		{
+			message.m_data.swap( first.m_data );
+		}
+		for( int fragmentIdx = 0; fragmentIdx < numFragments; ++fragmentIdx )
+		{
+			IncomingReliable& fragment = m_incomingReliable[( m_nextDeliveredReliableId + fragmentIdx ) % NET_RELIABLE_WINDOW];
+			if( numFragments > 1 )
+			{
+				message.m_data.insert( message.m_data.end(), fragment.m_data.begin(), fragment.m_data.end() );
+			}
+			fragment.m_isReceived = false;
+			fragment.m_data.clear();
+		}
+
+		m_receivedMessages.push( std::move( message ) );
+		m_nextDeliveredReliableId = (uint16_t)( m_nextDeliveredReliableId + numFragments );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void NetConnection::ReceiveUnreliable( uint16_t messageId, uint8_t fragmentIdx, uint8_t numFragments, uint8_t const* data, int numBytes )
+{
+	if( numFragments == 1 )
+	{
+		NetMessage message;
+		message.m_channel = eNetChannel::UNRELIABLE;
+		message.m_data.assign( data, data + numBytes );
+		m_receivedMessages.push( std::move( message ) );
+		return;
+	}
+
+	// Only the last fragment may be short
+	bool isLastFragment = fragmentIdx == numFragments - 1;
+	if( !isLastFragment && numBytes != NET_FRAGMENT_BYTES )
+	{
+		return;
+	}
+
+	// A newer message takes over its slot; a straggler from an older one is ignored
+	UnreliableAssembly& assembly = m_unreliableAssemblies[messageId % NUM_UNRELIABLE_ASSEMBLIES];
+	if( assembly.m_numFragments == 0 || assembly.m_messageId != messageId )
+	{
+		if( assembly.m_numFragments != 0 && !IsSequenceNewer( messageId, assembly.m_messageId ) )
+		{
+			return;
+		}
+		assembly.m_messageId = messageId;
+		assembly.m_numFragments = numFragments;
+		assembly.m_numReceived = 0;
+		assembly.m_numBytes = 0;
+		assembly.m_isFragmentReceived.assign( numFragments, false );
+		assembly.m_data.resize( numFragments * NET_FRAGMENT_BYTES );
+	}
+	if( assembly.m_numFragments != numFragments || assembly.m_isFragmentReceived[fragmentIdx] )
+	{
+		return;
+	}
+
+	assembly.m_isFragmentReceived[fragmentIdx] = true;
+	std::memcpy( &assembly.m_data[fragmentIdx * NET_FRAGMENT_BYTES], data, numBytes );
+	++assembly.m_numReceived;
+	if( isLastFragment )
+	{
+		assembly.m_numBytes = fragmentIdx * NET_FRAGMENT_BYTES + numBytes;
+	}
+
+	if( assembly.m_numReceived == assembly.m_numFragments )
+	{
+		NetMessage message;
+		message.m_channel = eNetChannel::UNRELIABLE;
+		message.m_data.assign( assembly.m_data.begin(), assembly.m_data.begin() + assembly.m_numBytes );
+		m_receivedMessages.push( std::move( message ) );
+		assembly.m_numFragments = 0;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+// test_connection: two connections exchange reliable and unreliable traffic at 60 Hz through a seeded lossy
+// link, first purely in-process and then through a loopback UDPSocket pair, and check that every reliable
+// message arrives exactly once, in order and intact. Time is simulated, so a run takes as long as the CPU
+// work and latency/jitter are exact.
+//-------------------------------------------------------------------------------------------------------------
+constexpr double	TEST_TICK_SECONDS				= 1.0 / 60.0;
+constexpr double	TEST_MAX_DRAIN_SECONDS			= 10.0;
+constexpr int		TEST_LARGE_RELIABLE_BYTES		= 4000;
+constexpr int		TEST_LARGE_UNRELIABLE_BYTES		= 3000;
+constexpr int		TEST_SMALL_MESSAGE_BYTES		= 8;
+constexpr int		TEST_LARGE_RELIABLE_INTERVAL	= 30;
+constexpr int		TEST_LARGE_UNRELIABLE_INTERVAL	= 10;
+
+//-------------------------------------------------------------------------------------------------------------
+struct ConnectionTestEndpoint
+{
+	NetConnection			m_connection;
+	std::vector<NetPacket>	m_packets;
+	std::vector<uint8_t>	m_scratch;
+
+	uint32_t	m_numReliableQueued = 0;
+	uint32_t	m_numUnreliableQueued = 0;
+	uint32_t	m_numReliableReceived = 0;
+	uint32_t	m_numUnreliableReceived = 0;
+	int			m_numErrors = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+// Message index in the first 4 bytes, then a pattern derived from it
+static void BuildTestMessage( std::vector<uint8_t>& out_data, uint32_t messageIdx, int numBytes )
+{
+	out_data.resize( numBytes );
+	std::memcpy( out_data.data(), &messageIdx, sizeof( messageIdx ) );
+	for( int byteIdx = (int)sizeof( messageIdx ); byteIdx < numBytes; ++byteIdx )
+	{
+		out_data[byteIdx] = (uint8_t)( messageIdx * 31u + byteIdx );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static int GetTestMessageBytes( uint32_t messageIdx, int largeInterval, int largeBytes )
+{
+	return ( messageIdx % largeInterval ) == (uint32_t)( largeInterval - 1 ) ? largeBytes : TEST_SMALL_MESSAGE_BYTES;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void QueueTestMessages( ConnectionTestEndpoint& endpoint )
+{
+	// A full reliable window just means trying again next tick
+	int reliableBytes = GetTestMessageBytes( endpoint.m_numReliableQueued, TEST_LARGE_RELIABLE_INTERVAL, TEST_LARGE_RELIABLE_BYTES );
+	BuildTestMessage( endpoint.m_scratch, endpoint.m_numReliableQueued, reliableBytes );
+	if( endpoint.m_connection.QueueMessage( eNetChannel::RELIABLE_ORDERED, endpoint.m_scratch.data(), reliableBytes ) )
+	{
+		++endpoint.m_numReliableQueued;
+	}
+
+	int unreliableBytes = GetTestMessageBytes( endpoint.m_numUnreliableQueued, TEST_LARGE_UNRELIABLE_INTERVAL, TEST_LARGE_UNRELIABLE_BYTES );
+	BuildTestMessage( endpoint.m_scratch, endpoint.m_numUnreliableQueued, unreliableBytes );
+	endpoint.m_connection.QueueMessage( eNetChannel::UNRELIABLE, endpoint.m_scratch.data(), unreliableBytes );
+	++endpoint.m_numUnreliableQueued;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void CheckReceivedTestMessages( ConnectionTestEndpoint& endpoint )
+{
+	NetMessage message;
+	while( endpoint.m_connection.PopReceivedMessage( message ) )
+	{
+		uint32_t messageIdx = 0;
+		if( message.m_data.size() >= sizeof( messageIdx ) )
+		{
+			std::memcpy( &messageIdx, message.m_data.data(), sizeof( messageIdx ) );
+		}
+
+		bool isReliable = message.m_channel == eNetChannel::RELIABLE_ORDERED;
+		int expectedBytes = isReliable
+			? GetTestMessageBytes( messageIdx, TEST_LARGE_RELIABLE_INTERVAL, TEST_LARGE_RELIABLE_BYTES )
+			: GetTestMessageBytes( messageIdx, TEST_LARGE_UNRELIABLE_INTERVAL, TEST_LARGE_UNRELIABLE_BYTES );
+		BuildTestMessage( endpoint.m_scratch, messageIdx, expectedBytes );
+
+		bool isIntact = message.m_data == endpoint.m_scratch;
+		if( isReliable )
+		{
+			if( !isIntact || messageIdx != endpoint.m_numReliableReceived )
+			{
+				++endpoint.m_numErrors;
+			}
+			++endpoint.m_numReliableReceived;
+		}
+		else
+		{
+			if( !isIntact )
+			{
+				++endpoint.m_numErrors;
+			}
+			++endpoint.m_numUnreliableReceived;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Packets written by 'from' go through the simulated link and, if given, a loopback socket pair
+static void TransmitTestPackets( ConnectionTestEndpoint& from, ConnectionTestEndpoint& to, NetworkLinkSimulator& link,
+	UDPSocket* sendSocket, UDPSocket* receiveSocket, double currentSeconds )
+{
+	from.m_connection.WritePackets( currentSeconds, from.m_packets );
+	for( NetPacket const& packet : from.m_packets )
+	{
+		link.Send( packet.m_data, packet.m_numBytes, currentSeconds );
+	}
+
+	int numOnSocket = 0;
+	while( link.Receive( currentSeconds, from.m_scratch ) )
+	{
+		if( sendSocket == nullptr )
+		{
+			to.m_connection.ReadPacket( from.m_scratch.data(), (int)from.m_scratch.size(), currentSeconds );
+			continue;
+		}
+		if( sendSocket->SendMsg( eMessageType::CONNECTION_PACKET, reinterpret_cast<char const*>( from.m_scratch.data() ), (int)from.m_scratch.size() ) > 0 )
+		{
+			++numOnSocket;
+		}
+	}
+
+	// Loopback doesn't lose anything, so read back exactly what went in
+	for( int packetIdx = 0; packetIdx < numOnSocket && receiveSocket->IsDataAvailable(); ++packetIdx )
+	{
+		int length = receiveSocket->Receive();
+		if( length < (int)sizeof( MessageHeader ) )
+		{
+			continue;
+		}
+		MessageHeader const* header = reinterpret_cast<MessageHeader const*>( &receiveSocket->GetReceiveBuffer()[0] );
+		if( header->m_id == (uint16_t)eMessageType::CONNECTION_PACKET )
+		{
+			uint8_t const* payload = reinterpret_cast<uint8_t const*>( &receiveSocket->GetReceiveBuffer()[sizeof( MessageHeader )] );
+			to.m_connection.ReadPacket( payload, length - (int)sizeof( MessageHeader ), currentSeconds );
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+static void RunConnectionTest( char const* label, NetworkLinkConfig const& config, double sendSeconds, UDPSocket* socketA, UDPSocket* socketB )
+{
+	ConnectionTestEndpoint endpoints[2];
+	NetworkLinkConfig reverseConfig = config;
+	reverseConfig.m_seed = config.m_seed + 1;
+	NetworkLinkSimulator linkAToB( config );
+	NetworkLinkSimulator linkBToA( reverseConfig );
+
+	double currentSeconds = 0.0;
+	int numTicks = 0;
+	for( ;; )
+	{
+		bool isSending = currentSeconds < sendSeconds;
+		bool isDone = !isSending
+			&& endpoints[0].m_numReliableReceived == endpoints[1].m_numReliableQueued
+			&& endpoints[1].m_numReliableReceived == endpoints[0].m_numReliableQueued;
+		if( isDone || currentSeconds > sendSeconds + TEST_MAX_DRAIN_SECONDS )
+		{
+			break;
+		}
+
+		if( isSending )
+		{
+			QueueTestMessages( endpoints[0] );
+			QueueTestMessages( endpoints[1] );
+		}
+		TransmitTestPackets( endpoints[0], endpoints[1], linkAToB, socketA, socketB, currentSeconds );
+		TransmitTestPackets( endpoints[1], endpoints[0], linkBToA, socketB, socketA, currentSeconds );
+		CheckReceivedTestMessages( endpoints[0] );
+		CheckReceivedTestMessages( endpoints[1] );
+
+		currentSeconds += TEST_TICK_SECONDS;
+		++numTicks;
+	}
+
+	ConnectionTestEndpoint const& sender = endpoints[0];
+	ConnectionTestEndpoint const& receiver = endpoints[1];
+	NetConnectionStats const& stats = sender.m_connection.GetStats();
+	bool isReliableComplete = receiver.m_numReliableReceived == sender.m_numReliableQueued && sender.m_numReliableReceived == receiver.m_numReliableQueued;
+	int numErrors = sender.m_numErrors + receiver.m_numErrors;
+
+	g_theConsole->PrintString( isReliableComplete && numErrors == 0 ? Rgba8::WHITE : Rgba8::RED,
+		Stringf( "%-10s reliable %u/%u in order, unreliable %u/%u, rtt %6.1f ms, loss %5.1f%%, %llu resends, %7.1f bytes/tick, %.2f packets/tick, %i errors",
+			label, receiver.m_numReliableReceived, sender.m_numReliableQueued, receiver.m_numUnreliableReceived, sender.m_numUnreliableQueued,
+			stats.m_smoothedRttSeconds * 1000.0, stats.m_packetLossFraction * 100.f, (unsigned long long)stats.m_numReliableResends,
+			(double)stats.m_numBytesSent / (double)numTicks, (double)stats.m_numPacketsSent / (double)numTicks, numErrors ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( test_connection, "loss,latency,jitter,seconds,port" )
+{
+	NetworkLinkConfig config;
+	config.m_lossFraction = args.GetValue( "loss", 0.1f );
+	config.m_latencySeconds = args.GetValue( "latency", 0.05f );
+	config.m_jitterSeconds = args.GetValue( "jitter", 0.02f );
+	config.m_duplicateFraction = 0.01f;
+	config.m_seed = 1;
+	float sendSeconds = args.GetValue( "seconds", 10.f );
+	int port = args.GetValue( "port", 48200 );
+	if( sendSeconds <= 0.f || config.m_lossFraction < 0.f || config.m_lossFraction >= 1.f ) {
+		g_theConsole->Error( "test_connection: seconds must be positive and loss in [0,1)" );
+		return;
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "NetConnection over a %.0f%% loss, %.0f +- %.0f ms link for %.1f s at 60 Hz",
+		config.m_lossFraction * 100.f, config.m_latencySeconds * 1000.f, config.m_jitterSeconds * 1000.f, sendSeconds ) );
+	RunConnectionTest( "simulated", config, sendSeconds, nullptr, nullptr );
+
+	UDPSocket socketA( "127.0.0.1", port + 1 );
+	socketA.Bind( port );
+	UDPSocket socketB( "127.0.0.1", port );
+	socketB.Bind( port + 1 );
+	if( !socketA.IsValid() || !socketB.IsValid() ) {
+		g_theConsole->Error( "test_connection: failed to open loopback sockets on ports %i/%i", port, port + 1 );
+		return;
+	}
+	RunConnectionTest( "loopback", config, sendSeconds, &socketA, &socketB );
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include "Engine/Network/UDPSocket.hpp"
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+// One end of a virtual connection carried in UDP datagrams.
+//
+// Every packet has a 16-bit sequence number and acks the newest remote sequence plus a bitfield of the
+// 32 before it, so each packet acknowledges up to 33 others; acks drive RTT and loss stats and tell the
+// reliable channel what got through. Messages queued during a tick are coalesced into as few packets as
+// possible when WritePackets() runs; messages bigger than NET_FRAGMENT_BYTES are split into fragments
+// and reassembled on the other side.
+//
+//	RELIABLE_ORDERED	resent until acked, delivered exactly once and in order (gameplay commands)
+//	UNRELIABLE			sent once, delivered if it arrives (snapshots); dropped if it doesn't fit this tick
+//
+// The connection never touches a socket: feed it datagrams with ReadPacket() and send whatever
+// WritePackets() produces, so it can run over UDPSocket or the in-process NetworkLinkSimulator.
+//-------------------------------------------------------------------------------------------------------------
+constexpr int	NET_MAX_PACKET_BYTES		= UDPSocket::MaxPayloadSize;
+constexpr int	NET_FRAGMENT_BYTES			= 1024;
+constexpr int	NET_MAX_FRAGMENTS			= 255;
+constexpr int	NET_RELIABLE_WINDOW			= 256;		// reliable messages (or fragments) in flight
+constexpr int	NET_SENT_PACKET_HISTORY		= 256;
+constexpr int	NET_MAX_PACKETS_PER_TICK	= 8;
+
+//-------------------------------------------------------------------------------------------------------------
+enum class eNetChannel : uint8_t
+{
+	UNRELIABLE,
+	RELIABLE_ORDERED,
+
+	NUM_CHANNELS
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct NetMessage
+{
+	eNetChannel				m_channel = eNetChannel::UNRELIABLE;
+	std::vector<uint8_t>	m_data;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct NetPacket
+{
+	int			m_numBytes = 0;
+	uint8_t		m_data[NET_MAX_PACKET_BYTES];
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct NetConnectionStats
+{
+	double		m_smoothedRttSeconds = 0.1;
+	float		m_packetLossFraction = 0.f;		// smoothed over roughly the last 20 resolved packets
+
+	uint64_t	m_numPacketsSent = 0;
+	uint64_t	m_numPacketsReceived = 0;
+	uint64_t	m_numPacketsAcked = 0;
+	uint64_t	m_numPacketsLost = 0;
+	uint64_t	m_numPacketsDiscarded = 0;		// duplicates, too old or malformed
+	uint64_t	m_numBytesSent = 0;
+	uint64_t	m_numBytesReceived = 0;
+	uint64_t	m_numReliableResends = 0;
+	uint64_t	m_numUnreliableDropped = 0;		// didn't fit into this tick's packets
+};
+
+
+//-------------------------------------------------------------------------------------------------------------
+class NetConnection
+{
+public:
+	NetConnection();
+
+	// false if the message is too big or the reliable window is full
+	bool						QueueMessage( eNetChannel channel, void const* data, int numBytes );
+	bool						PopReceivedMessage( NetMessage& out_message );
+
+	// Once per tick: coalesces resends and queued messages into out_packets (at least one, so acks flow)
+	void						WritePackets( double currentSeconds, std::vector<NetPacket>& out_packets );
+	void						ReadPacket( uint8_t const* data, int numBytes, double currentSeconds );
+
+	NetConnectionStats const&	GetStats() const		{ return m_stats; }
+	int							GetNumUnackedReliable() const;
+
+private:
+	struct SentPacket
+	{
+		uint16_t	m_sequence = 0;
+		bool		m_isInUse = false;
+		bool		m_isResolved = false;		// acked or declared lost
+		double		m_sentSeconds = 0.0;
+		int			m_numReliableIds = 0;
+		uint16_t	m_reliableIds[64];
+	};
+
+	struct OutgoingReliable
+	{
+		bool					m_isInUse = false;
+		double					m_lastSentSeconds = -1.0;
+		uint8_t					m_fragmentIdx = 0;
+		uint8_t					m_numFragments = 1;
+		std::vector<uint8_t>	m_data;
+	};
+
+	struct IncomingReliable
+	{
+		bool					m_isReceived = false;
+		uint8_t					m_fragmentIdx = 0;
+		uint8_t					m_numFragments = 1;
+		std::vector<uint8_t>	m_data;
+	};
+
+	struct OutgoingUnreliable
+	{
+		uint32_t	m_byteOffset = 0;
+		uint16_t	m_numBytes = 0;
+		uint16_t	m_messageId = 0;
+		uint8_t		m_fragmentIdx = 0;
+		uint8_t		m_numFragments = 1;
+	};
+
+	struct UnreliableAssembly
+	{
+		uint16_t				m_messageId = 0;
+		int						m_numFragments = 0;
+		int						m_numReceived = 0;
+		int						m_numBytes = 0;
+		std::vector<bool>		m_isFragmentReceived;
+		std::vector<uint8_t>	m_data;
+	};
+
+	bool		WritePacket( double currentSeconds, NetPacket& out_packet, bool isFirstOfTick );
+	void		ProcessAcks( uint16_t ack, uint32_t ackBits, double currentSeconds );
+	void		OnPacketResolved( SentPacket& sentPacket, bool wasAcked, double currentSeconds );
+	bool		RecordRemoteSequence( uint16_t sequence );
+	void		ReceiveReliable( uint16_t messageId, uint8_t fragmentIdx, uint8_t numFragments, uint8_t const* data, int numBytes );
+	void		DeliverReliableInOrder();
+	void		ReceiveUnreliable( uint16_t messageId, uint8_t fragmentIdx, uint8_t numFragments, uint8_t const* data, int numBytes );
+	double		GetResendSeconds() const;
+
+private:
+	// packets
+	uint16_t			m_localSequence = 0;
+	uint16_t			m_oldestUnresolvedSequence = 0;
+	SentPacket			m_sentPackets[NET_SENT_PACKET_HISTORY];
+	bool				m_hasReceivedAnyPacket = false;
+	uint16_t			m_remoteSequence = 0;
+	uint32_t			m_remoteAckBits = 0;		// bit n set: received m_remoteSequence - 1 - n
+
+	// reliable-ordered channel
+	uint16_t			m_nextReliableId = 0;
+	uint16_t			m_oldestUnackedReliableId = 0;
+	OutgoingReliable	m_outgoingReliable[NET_RELIABLE_WINDOW];
+	uint16_t			m_nextDeliveredReliableId = 0;
+	IncomingReliable	m_incomingReliable[NET_RELIABLE_WINDOW];
+
+	// unreliable channel; queued bytes live in one buffer that is cleared every tick
+	uint16_t							m_nextUnreliableId = 0;
+	std::vector<OutgoingUnreliable>		m_outgoingUnreliable;
+	std::vector<uint8_t>				m_outgoingUnreliableBytes;
+	size_t								m_nextOutgoingUnreliableIdx = 0;
+	UnreliableAssembly					m_unreliableAssemblies[4];
+
+	std::queue<NetMessage>	m_receivedMessages;
+	NetConnectionStats		m_stats;
+};
@@ -19,7 +19,10 @@ enum class eMessageType : int
 {
 	SERVER_LISTENING = 1,
 	TEXT_MESSAGE,
-	CLIENT_DISCONNECTING
+	CLIENT_DISCONNECTING,
+	SNAPSHOT,			// bit-packed entity snapshot, see the game's SnapshotReplication
+	SNAPSHOT_ACK,
+	CONNECTION_PACKET,	// sequenced/acked packet carrying NetConnection channels
 };
 
 struct MessageHeader
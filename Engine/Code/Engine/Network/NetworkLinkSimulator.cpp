@@ -0,0 +1,59 @@
+#include "Engine/Network/NetworkLinkSimulator.hpp"
+
+
+//-------------------------------------------------------------------------------------------------------------
+NetworkLinkSimulator::NetworkLinkSimulator( NetworkLinkConfig const& config )
+	:m_config( config )
+{
+	m_rng.Reset( config.m_seed );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void NetworkLinkSimulator::Send( uint8_t const* data, int numBytes, double currentSeconds )
+{
+	if( m_rng.RollPercentChance( m_config.m_lossFraction ) )
+	{
+		return;
+	}
+
+	Schedule( data, numBytes, currentSeconds );
+	if( m_rng.RollPercentChance( m_config.m_duplicateFraction ) )
+	{
+		Schedule( data, numBytes, currentSeconds );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool NetworkLinkSimulator::Receive( double currentSeconds, std::vector<uint8_t>& out_data )
+{
+	size_t earliestIdx = m_inFlight.size();
+	for( size_t datagramIdx = 0; datagramIdx < m_inFlight.size(); ++datagramIdx )
+	{
+		double deliverSeconds = m_inFlight[datagramIdx].m_deliverSeconds;
+		if( deliverSeconds <= currentSeconds && ( earliestIdx == m_inFlight.size() || deliverSeconds < m_inFlight[earliestIdx].m_deliverSeconds ) )
+		{
+			earliestIdx = datagramIdx;
+		}
+	}
+	if( earliestIdx == m_inFlight.size() )
+	{
+		return false;
+	}
+
+	out_data.swap( m_inFlight[earliestIdx].m_data );
+	m_inFlight[earliestIdx] = std::move( m_inFlight.back() );
+	m_inFlight.pop_back();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void NetworkLinkSimulator::Schedule( uint8_t const* data, int numBytes, double currentSeconds )
+{
+	float jitter = m_config.m_jitterSeconds > 0.f ? m_rng.RollRandomFloatInRange( -m_config.m_jitterSeconds, m_config.m_jitterSeconds ) : 0.f;
+	float delaySeconds = m_config.m_latencySeconds + jitter;
+
+	Datagram datagram;
+	datagram.m_deliverSeconds = currentSeconds + ( delaySeconds > 0.f ? delaySeconds : 0.f );
+	datagram.m_data.assign( data, data + numBytes );
+	m_inFlight.push_back( std::move( datagram ) );
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------
+// A one-way lossy link for exercising NetConnection without a real network: datagrams handed to Send() come
+// out of Receive() after latency +- jitter, may be dropped or duplicated, and get reordered whenever the
+// jitter lets a later one overtake an earlier one. Seeded, so a run can be repeated exactly.
+//-------------------------------------------------------------------------------------------------------------
+struct NetworkLinkConfig
+{
+	float			m_lossFraction = 0.f;
+	float			m_duplicateFraction = 0.f;
+	float			m_latencySeconds = 0.f;
+	float			m_jitterSeconds = 0.f;
+	unsigned int	m_seed = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+class NetworkLinkSimulator
+{
+public:
+	struct Datagram
+	{
+		double					m_deliverSeconds = 0.0;
+		std::vector<uint8_t>	m_data;
+	};
+
+public:
+	explicit NetworkLinkSimulator( NetworkLinkConfig const& config );
+
+	void	Send( uint8_t const* data, int numBytes, double currentSeconds );
+	bool	Receive( double currentSeconds, std::vector<uint8_t>& out_data );		// one datagram whose time has come
+
+	size_t	GetNumInFlight() const		{ return m_inFlight.size(); }
+
+private:
+	void	Schedule( uint8_t const* data, int numBytes, double currentSeconds );
+
+private:
+	NetworkLinkConfig		m_config;
+	RandomNumberGenerator	m_rng;
+	std::vector<Datagram>	m_inFlight;		// unordered; Receive() picks the earliest due
+};
@@ -1,5 +1,4 @@
 #include "Engine/Network/NetworkSystem.hpp"
-#include "Engine/Network/TCPServer.hpp"
 #include "Engine/Network/TCPClient.hpp"
 #include "Engine/Core/NamedProperties.hpp"
 #include "Engine/Core/Delegate.hpp"
@@ -78,7 +77,10 @@ COMMAND( SendUDPMessage, "msg" )
 {
 	std::string message = args.GetValue( "msg", "" );
 
-	g_theNetwork->GetUDPSocket()->PushMsgIntoQueue( message );
+	if( !g_theNetwork->GetUDPSocket()->PushMsgIntoQueue( message ) )
+	{
+		g_theConsole->Error( "UDP send queue is full, message dropped" );
+	}
 }
 
 //-------------------------------------------------------------------------------------------------------------
@@ -88,6 +90,14 @@ COMMAND( CloseUDPPort, "bindPort" )
 	g_theNetwork->DisconnectUDP();
 }
 
+//-------------------------------------------------------------------------------------------------------------
+// Queued by the UDP reader thread, delivered here on the main thread
+//-------------------------------------------------------------------------------------------------------------
+static void OnUDPTextMessageReceived( NamedProperties& args )
+{
+	g_theConsole->PrintString( Rgba8::CYAN, args.GetValue( "text", std::string() ) );
+}
+
 //-------------------------------------------------------------------------------------------------------------
 NetworkSystem::NetworkSystem()
 	:m_isListening( false )
@@ -102,6 +112,9 @@ NetworkSystem::~NetworkSystem()
 	m_isListening = false;
 	m_clientSocket = INVALID_SOCKET;
 
+	delete m_tcpServer;
+	m_tcpServer = nullptr;
+
 	if( m_UDPSocket )
 	{
 		delete m_UDPSocket;
@@ -120,6 +133,8 @@ void NetworkSystem::StartUp()
 	{
 		g_theConsole->Error( "ERROR: Call to WSAStartup failed: %i", WSAGetLastError() );
 	}
+
+	g_theEventSystem->SubscribeToEvent( UDP_TEXT_MESSAGE_RECEIVED_EVENT, OnUDPTextMessageReceived );
 }
 
 //-------------------------------------------------------------------------------------------------------------
@@ -132,25 +147,10 @@ void NetworkSystem::BeginFrame()
 		case eRole::SERVER:
 		{
 			if( m_tcpServer != nullptr )
-			{ 
-				if( !m_listenSocket.IsValid() )
-				{
-					m_listenSocket = m_tcpServer->Accept();
-					if( m_listenSocket.IsValid() )
-					{
-						g_theConsole->PrintString( Rgba8::GREEN, Stringf( "Client connected from %s", m_listenSocket.GetAddress().c_str() ) );
-					}
-				}
-				else
-				{
-					TCPMessageData data = m_listenSocket.Receive();
-					if( data.m_header.m_id != 0 )
-					{
-						g_theConsole->PrintString( Rgba8::WHITE, data.m_gameName ); 
-					}	
-
-					SendMessageIfDataAvailable();
-				}
+			{
+				// Queue first so this frame's messages go out in the poll's flush
+				SendMessageIfDataAvailable();
+				m_tcpServer->Poll( 0 );
 			}
 		}
 		break;
@@ -180,12 +180,13 @@ void NetworkSystem::BeginFrame()
 
 		case eRole::UDP:
 		{
+			m_receivedUDPMessages.clear();
 			if( m_UDPSocket && m_UDPSocket->IsValid() )
 			{
-				std::string messageStr = m_UDPSocket->GetMsg();
-				if( !messageStr.empty() )
+				UDPSocket::Message message;
+				while( m_UDPSocket->PopMsg( message ) )
 				{
-					g_theConsole->PrintString( Rgba8::CYAN, messageStr );
+					m_receivedUDPMessages.push_back( message );
 				}
 			}
 		}
@@ -221,13 +222,11 @@ void NetworkSystem::CreateTCPServer( int port )
 {
 	if( nullptr == m_tcpServer )
 	{
-		m_tcpServer = new TCPServer( port );
-		m_tcpServer->m_timeval.tv_sec = 0;
-		m_tcpServer->m_timeval.tv_usec = 1;
-		if( m_tcpServer != nullptr )
+		m_tcpServer = new TCPMultiplexer();
+		m_tcpServer->SetEventHandler( [this]( TCPEvent const& tcpEvent ) { OnTCPServerEvent( tcpEvent ); } );
+		if( !m_tcpServer->Listen( port ) )
 		{
-			m_tcpServer->Bind();
-			m_tcpServer->Listen();
+			g_theConsole->Error( "TCP server failed to listen on port %i, error = %i", port, m_tcpServer->GetLastError() );
 		}
 	}
 }
@@ -248,16 +247,43 @@ void NetworkSystem::SetRole( eRole role )
 
 void NetworkSystem::SendMessageIfDataAvailable()
 {
-	for( int i = 0; i < (int)m_messagesWaitingToBeSent.size(); ++i )
+	for( std::string const& message : m_messagesWaitingToBeSent )
 	{
-		if( m_messagesWaitingToBeSent[i] != "" )
+		if( message.empty() )
 		{
-			std::string msgStr = m_messagesWaitingToBeSent[i];
+			continue;
+		}
 
-			m_listenSocket.SendMsg( eMessageType::TEXT_MESSAGE, &msgStr[0], msgStr.length() );
+		if( m_role == eRole::SERVER )
+		{
+			m_tcpServer->Broadcast( (uint16_t)eMessageType::TEXT_MESSAGE, message.data(), (int)message.size() );
+		}
+		else
+		{
+			m_listenSocket.SendMsg( eMessageType::TEXT_MESSAGE, message.data(), message.length() );
+		}
+	}
+	m_messagesWaitingToBeSent.clear();
+}
 
-			m_messagesWaitingToBeSent[i] = "";
+void NetworkSystem::OnTCPServerEvent( TCPEvent const& tcpEvent )
+{
+	switch( tcpEvent.m_type )
+	{
+	case eTCPEventType::CONNECTED:
+		g_theConsole->PrintString( Rgba8::GREEN, Stringf( "Client %u connected, %i connected", tcpEvent.m_connectionId, m_tcpServer->GetNumConnections() ) );
+		break;
+
+	case eTCPEventType::MESSAGE:
+		if( tcpEvent.m_messageId == (uint16_t)eMessageType::TEXT_MESSAGE )
+		{
+			g_theConsole->PrintString( Rgba8::WHITE, std::string( reinterpret_cast<char const*>( tcpEvent.m_data ), tcpEvent.m_numBytes ) );
 		}
+		break;
+
+	case eTCPEventType::DISCONNECTED:
+		g_theConsole->PrintString( Rgba8::GREEN, Stringf( "Client %u disconnected", tcpEvent.m_connectionId ) );
+		break;
 	}
 }
 
@@ -266,12 +292,7 @@ void NetworkSystem::StopServer()
 	SetIsListening(false);
 	if( m_tcpServer != nullptr )
 	{
-		m_tcpServer->StopListen();
-		if( m_listenSocket.IsValid() )
-		{
-			m_listenSocket.ShutDown();
-			m_listenSocket.Close();
-		}
+		m_tcpServer->Shutdown();
 	}
 }
 
@@ -6,6 +6,7 @@
 #endif
 
 #include "Engine/Network/TCPSocket.hpp"
+#include "Engine/Network/TCPMultiplexer.hpp"
 #include "Engine/Network/UDPSocket.hpp"
 #include <WinSock2.h>
 #include <WS2tcpip.h>
@@ -15,7 +16,7 @@
 
 #pragma comment(lib,"ws2_32.lib")
 
-class TCPServer;
+class TCPMultiplexer;
 class TCPClient;
 
 enum class eRole
@@ -45,6 +46,7 @@ public:
 	void CreateTCPClient( int port = 48000 );
 	void SetRole( eRole role );
 	void SendMessageIfDataAvailable();
+	void OnTCPServerEvent( TCPEvent const& tcpEvent );
 
 	void StopServer();
 	void ClientDisconnect();
@@ -57,16 +59,20 @@ public:
 	UDPSocket*	GetUDPSocket() { return m_UDPSocket; }
 	void		DisconnectUDP();
 
+	// Non-text datagrams received since the last BeginFrame, for game-side protocols
+	std::vector<UDPSocket::Message> const&	GetReceivedUDPMessages() const	{ return m_receivedUDPMessages; }
+
 
 public:
 	bool		m_isListening = false;
 	eRole		m_role = eRole::INVALID;
-	TCPServer*	m_tcpServer = nullptr;
+	TCPMultiplexer*	m_tcpServer = nullptr;		// accepts any number of clients, polled in BeginFrame
 	TCPClient*	m_tcpClient = nullptr;
 	TCPSocket	m_listenSocket;
 	SOCKET		m_clientSocket;
 
 	UDPSocket*  m_UDPSocket = nullptr;
+	std::vector<UDPSocket::Message> m_receivedUDPMessages;
 
 	std::vector<std::string> m_messagesWaitingToBeSent;
 };
\ No newline at end of file
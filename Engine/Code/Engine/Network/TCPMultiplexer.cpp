@@ -0,0 +1,803 @@
+#include "Engine/Network/TCPMultiplexer.hpp"
+#include <chrono>
+#include <cstring>
+
+#if defined( _WIN32 )
+//-------------------------------------------------------------------------------------------------------------
+// Winsock
+//-------------------------------------------------------------------------------------------------------------
+static SocketHandle const INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+
+static int	GetLastSocketError()								{ return WSAGetLastError(); }
+static bool	IsWouldBlock( int error )							{ return error == WSAEWOULDBLOCK || error == WSAEINTR; }
+static void	CloseSocketHandle( SocketHandle socketHandle )		{ closesocket( socketHandle ); }
+static int	PollSockets( pollfd* entries, size_t numEntries, int timeoutMilliseconds )	{ return WSAPoll( entries, (ULONG)numEntries, timeoutMilliseconds ); }
+
+static bool SetNonBlocking( SocketHandle socketHandle )
+{
+	u_long isNonBlocking = 1;
+	return ioctlsocket( socketHandle, FIONBIO, &isNonBlocking ) == 0;
+}
+
+// Bytes read, 0 if the peer closed, -1 on error
+static int ReadVectored( SocketHandle socketHandle, ByteSpan const* spans, int numSpans )
+{
+	WSABUF buffers[2];
+	for( int spanIdx = 0; spanIdx < numSpans; ++spanIdx )
+	{
+		buffers[spanIdx].buf = reinterpret_cast<CHAR*>( spans[spanIdx].m_data );
+		buffers[spanIdx].len = (ULONG)spans[spanIdx].m_numBytes;
+	}
+
+	DWORD numBytes = 0;
+	DWORD flags = 0;
+	if( WSARecv( socketHandle, buffers, (DWORD)numSpans, &numBytes, &flags, nullptr, nullptr ) == SOCKET_ERROR )
+	{
+		return -1;
+	}
+	return (int)numBytes;
+}
+
+static int WriteVectored( SocketHandle socketHandle, ByteSpan const* spans, int numSpans )
+{
+	WSABUF buffers[2];
+	for( int spanIdx = 0; spanIdx < numSpans; ++spanIdx )
+	{
+		buffers[spanIdx].buf = reinterpret_cast<CHAR*>( spans[spanIdx].m_data );
+		buffers[spanIdx].len = (ULONG)spans[spanIdx].m_numBytes;
+	}
+
+	DWORD numBytes = 0;
+	if( WSASend( socketHandle, buffers, (DWORD)numSpans, &numBytes, 0, nullptr, nullptr ) == SOCKET_ERROR )
+	{
+		return -1;
+	}
+	return (int)numBytes;
+}
+
+#else
+//-------------------------------------------------------------------------------------------------------------
+// POSIX
+//-------------------------------------------------------------------------------------------------------------
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+#include <sys/epoll.h>
+#endif
+
+static SocketHandle const INVALID_SOCKET_HANDLE = -1;
+
+static int	GetLastSocketError()								{ return errno; }
+static bool	IsWouldBlock( int error )							{ return error == EAGAIN || error == EWOULDBLOCK || error == EINTR; }
+static void	CloseSocketHandle( SocketHandle socketHandle )		{ ::close( socketHandle ); }
+#if !defined( TCP_MULTIPLEXER_USE_EPOLL )
+static int	PollSockets( pollfd* entries, size_t numEntries, int timeoutMilliseconds )	{ return ::poll( entries, (nfds_t)numEntries, timeoutMilliseconds ); }
+#endif
+
+static bool SetNonBlocking( SocketHandle socketHandle )
+{
+	int flags = ::fcntl( socketHandle, F_GETFL, 0 );
+	return flags != -1 && ::fcntl( socketHandle, F_SETFL, flags | O_NONBLOCK ) == 0;
+}
+
+static int ReadVectored( SocketHandle socketHandle, ByteSpan const* spans, int numSpans )
+{
+	iovec vectors[2];
+	for( int spanIdx = 0; spanIdx < numSpans; ++spanIdx )
+	{
+		vectors[spanIdx].iov_base = spans[spanIdx].m_data;
+		vectors[spanIdx].iov_len = spans[spanIdx].m_numBytes;
+	}
+	return (int)::readv( socketHandle, vectors, numSpans );
+}
+
+// sendmsg rather than writev so a peer that went away gives EPIPE instead of SIGPIPE
+static int WriteVectored( SocketHandle socketHandle, ByteSpan const* spans, int numSpans )
+{
+	iovec vectors[2];
+	for( int spanIdx = 0; spanIdx < numSpans; ++spanIdx )
+	{
+		vectors[spanIdx].iov_base = spans[spanIdx].m_data;
+		vectors[spanIdx].iov_len = spans[spanIdx].m_numBytes;
+	}
+
+	msghdr message;
+	std::memset( &message, 0, sizeof( message ) );
+	message.msg_iov = vectors;
+	message.msg_iovlen = (size_t)numSpans;
+	return (int)::sendmsg( socketHandle, &message, MSG_NOSIGNAL );
+}
+
+#endif
+
+//-------------------------------------------------------------------------------------------------------------
+constexpr int		MAX_CONNECTION_SLOTS	= 0xFFFF;		// slot 0xFFFF with generation 0xFFFF would be INVALID_TCP_CONNECTION_ID
+constexpr uint64_t	LISTEN_SOCKET_TOKEN		= ~0ull;
+constexpr int		MAX_EVENTS_PER_POLL		= 256;
+
+//-------------------------------------------------------------------------------------------------------------
+static void SetNoDelay( SocketHandle socketHandle )
+{
+	// Frames are already coalesced per poll; Nagle would only add latency on top
+	int isNoDelay = 1;
+	::setsockopt( socketHandle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char const*>( &isNoDelay ), sizeof( isNoDelay ) );
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+TCPMultiplexer::TCPMultiplexer( TCPMultiplexerConfig const& config )
+	:m_config( config )
+	,m_listenSocket( INVALID_SOCKET_HANDLE )
+{
+	int numSlots = m_config.m_maxConnections < MAX_CONNECTION_SLOTS ? m_config.m_maxConnections : MAX_CONNECTION_SLOTS;
+	m_connections.resize( numSlots );
+	for( int slotIdx = numSlots - 1; slotIdx >= 0; --slotIdx )
+	{
+		m_connections[slotIdx].m_socket = INVALID_SOCKET_HANDLE;
+		m_freeSlots.push_back( slotIdx );
+	}
+
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+	m_epollFd = ::epoll_create1( 0 );
+	if( m_epollFd == -1 )
+	{
+		m_lastError = GetLastSocketError();
+	}
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------------------
+TCPMultiplexer::~TCPMultiplexer()
+{
+	StopThread();
+	Shutdown();
+
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+	if( m_epollFd != -1 )
+	{
+		::close( m_epollFd );
+		m_epollFd = -1;
+	}
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TCPMultiplexer::Listen( int port )
+{
+	if( m_listenSocket != INVALID_SOCKET_HANDLE )
+	{
+		return false;
+	}
+
+	m_listenSocket = ::socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+	if( m_listenSocket == INVALID_SOCKET_HANDLE )
+	{
+		m_lastError = GetLastSocketError();
+		return false;
+	}
+
+	int isReuseAddress = 1;
+	::setsockopt( m_listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<char const*>( &isReuseAddress ), sizeof( isReuseAddress ) );
+
+	sockaddr_in address;
+	std::memset( &address, 0, sizeof( address ) );
+	address.sin_family = AF_INET;
+	address.sin_port = htons( (uint16_t)port );
+	address.sin_addr.s_addr = htonl( INADDR_ANY );
+
+	bool isListening = ::bind( m_listenSocket, reinterpret_cast<sockaddr const*>( &address ), sizeof( address ) ) == 0
+		&& ::listen( m_listenSocket, SOMAXCONN ) == 0
+		&& SetNonBlocking( m_listenSocket );
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+	if( isListening )
+	{
+		epoll_event listenEvent;
+		listenEvent.events = EPOLLIN;
+		listenEvent.data.u64 = LISTEN_SOCKET_TOKEN;
+		isListening = ::epoll_ctl( m_epollFd, EPOLL_CTL_ADD, m_listenSocket, &listenEvent ) == 0;
+	}
+#endif
+
+	if( !isListening )
+	{
+		m_lastError = GetLastSocketError();
+		CloseSocketHandle( m_listenSocket );
+		m_listenSocket = INVALID_SOCKET_HANDLE;
+	}
+	return isListening;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+uint32_t TCPMultiplexer::Connect( std::string const& host, int port )
+{
+	sockaddr_in address;
+	std::memset( &address, 0, sizeof( address ) );
+	address.sin_family = AF_INET;
+	address.sin_port = htons( (uint16_t)port );
+	if( ::inet_pton( AF_INET, host.c_str(), &address.sin_addr ) != 1 )
+	{
+		return INVALID_TCP_CONNECTION_ID;
+	}
+
+	SocketHandle socketHandle = ::socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+	if( socketHandle == INVALID_SOCKET_HANDLE )
+	{
+		m_lastError = GetLastSocketError();
+		return INVALID_TCP_CONNECTION_ID;
+	}
+
+	if( ::connect( socketHandle, reinterpret_cast<sockaddr const*>( &address ), sizeof( address ) ) != 0 || !SetNonBlocking( socketHandle ) )
+	{
+		m_lastError = GetLastSocketError();
+		CloseSocketHandle( socketHandle );
+		return INVALID_TCP_CONNECTION_ID;
+	}
+	SetNoDelay( socketHandle );
+
+	uint32_t connectionId = AddConnection( socketHandle );
+	if( connectionId != INVALID_TCP_CONNECTION_ID )
+	{
+		TCPEvent connectedEvent;
+		connectedEvent.m_type = eTCPEventType::CONNECTED;
+		connectedEvent.m_connectionId = connectionId;
+		DispatchEvent( connectedEvent );
+	}
+	return connectionId;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::Shutdown()
+{
+	for( int slotIdx = 0; slotIdx < (int)m_connections.size(); ++slotIdx )
+	{
+		CloseConnectionNow( slotIdx );
+	}
+	m_closingConnections.clear();
+	m_dirtyConnections.clear();
+
+	if( m_listenSocket != INVALID_SOCKET_HANDLE )
+	{
+		// closing the descriptor also removes it from the epoll set
+		CloseSocketHandle( m_listenSocket );
+		m_listenSocket = INVALID_SOCKET_HANDLE;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+int TCPMultiplexer::Poll( int timeoutMilliseconds )
+{
+	int numReady = 0;
+
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+	epoll_event events[MAX_EVENTS_PER_POLL];
+	numReady = ::epoll_wait( m_epollFd, events, MAX_EVENTS_PER_POLL, timeoutMilliseconds );
+	if( numReady < 0 )
+	{
+		int error = GetLastSocketError();
+		m_lastError = error != EINTR ? error : m_lastError;
+		numReady = 0;
+	}
+
+	for( int eventIdx = 0; eventIdx < numReady; ++eventIdx )
+	{
+		if( events[eventIdx].data.u64 == LISTEN_SOCKET_TOKEN )
+		{
+			AcceptPending();
+			continue;
+		}
+
+		int slotIdx = (int)events[eventIdx].data.u64;
+		uint32_t readyFlags = events[eventIdx].events;
+		if( readyFlags & ( EPOLLIN | EPOLLHUP | EPOLLERR ) )
+		{
+			ReadFromConnection( slotIdx );
+		}
+		if( readyFlags & EPOLLOUT )
+		{
+			FlushConnection( slotIdx );
+		}
+	}
+#else
+	m_pollEntries.clear();
+	m_pollSlots.clear();
+	if( m_listenSocket != INVALID_SOCKET_HANDLE )
+	{
+		pollfd listenEntry;
+		listenEntry.fd = m_listenSocket;
+		listenEntry.events = POLLIN;
+		listenEntry.revents = 0;
+		m_pollEntries.push_back( listenEntry );
+		m_pollSlots.push_back( -1 );
+	}
+	for( int slotIdx = 0; slotIdx < (int)m_connections.size(); ++slotIdx )
+	{
+		Connection const& connection = m_connections[slotIdx];
+		if( connection.m_isOpen && !connection.m_isClosing )
+		{
+			pollfd entry;
+			entry.fd = connection.m_socket;
+			entry.events = (short)( POLLIN | ( connection.m_isWaitingForWritable ? POLLOUT : 0 ) );
+			entry.revents = 0;
+			m_pollEntries.push_back( entry );
+			m_pollSlots.push_back( slotIdx );
+		}
+	}
+
+	// WSAPoll rejects an empty set
+	if( m_pollEntries.empty() )
+	{
+		std::this_thread::sleep_for( std::chrono::milliseconds( timeoutMilliseconds ) );
+		return 0;
+	}
+
+	numReady = PollSockets( m_pollEntries.data(), m_pollEntries.size(), timeoutMilliseconds );
+	if( numReady < 0 )
+	{
+		m_lastError = GetLastSocketError();
+		numReady = 0;
+	}
+
+	for( size_t entryIdx = 0; entryIdx < m_pollEntries.size() && numReady > 0; ++entryIdx )
+	{
+		short readyFlags = m_pollEntries[entryIdx].revents;
+		if( readyFlags == 0 )
+		{
+			continue;
+		}
+
+		int slotIdx = m_pollSlots[entryIdx];
+		if( slotIdx < 0 )
+		{
+			AcceptPending();
+			continue;
+		}
+		if( readyFlags & ( POLLIN | POLLHUP | POLLERR ) )
+		{
+			ReadFromConnection( slotIdx );
+		}
+		if( readyFlags & POLLOUT )
+		{
+			FlushConnection( slotIdx );
+		}
+	}
+#endif
+
+	FlushDirtyConnections();
+	CloseMarkedConnections();
+	return numReady;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+bool TCPMultiplexer::Send( uint32_t connectionId, uint16_t messageId, void const* data, int numBytes )
+{
+	Connection* connection = GetConnection( connectionId );
+	if( connection == nullptr || connection->m_isClosing || numBytes < 0 || numBytes > 0xFFFF )
+	{
+		return false;
+	}
+
+	uint32_t frameBytes = TCP_FRAME_HEADER_BYTES + (uint32_t)numBytes;
+	if( connection->m_writeBuffer.GetNumWritable() < frameBytes )
+	{
+		++m_stats.m_numSendsRejected;
+		return false;
+	}
+
+	uint8_t header[TCP_FRAME_HEADER_BYTES] = {
+		(uint8_t)( messageId & 0xFF ), (uint8_t)( messageId >> 8 ),
+		(uint8_t)( numBytes & 0xFF ), (uint8_t)( numBytes >> 8 )
+	};
+	connection->m_writeBuffer.Write( header, TCP_FRAME_HEADER_BYTES );
+	connection->m_writeBuffer.Write( data, (uint32_t)numBytes );
+	++m_stats.m_numMessagesSent;
+
+	if( !connection->m_isDirty )
+	{
+		connection->m_isDirty = true;
+		m_dirtyConnections.push_back( (int)( connectionId & 0xFFFF ) );
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+int TCPMultiplexer::Broadcast( uint16_t messageId, void const* data, int numBytes )
+{
+	int numQueued = 0;
+	for( int slotIdx = 0; slotIdx < (int)m_connections.size(); ++slotIdx )
+	{
+		if( m_connections[slotIdx].m_isOpen && Send( GetConnectionId( slotIdx ), messageId, data, numBytes ) )
+		{
+			++numQueued;
+		}
+	}
+	return numQueued;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::Close( uint32_t connectionId )
+{
+	Connection* connection = GetConnection( connectionId );
+	if( connection == nullptr || connection->m_isClosing )
+	{
+		return;
+	}
+	connection->m_isClosing = true;
+	m_closingConnections.push_back( (int)( connectionId & 0xFFFF ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::StartThread()
+{
+	if( m_ioThread == nullptr )
+	{
+		m_isQuitting = false;
+		m_ioThread = new std::thread( &TCPMultiplexer::ThreadMain, this );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::StopThread()
+{
+	if( m_ioThread != nullptr )
+	{
+		m_isQuitting = true;
+		m_ioThread->join();
+		delete m_ioThread;
+		m_ioThread = nullptr;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::ThreadMain()
+{
+	while( !m_isQuitting )
+	{
+		Poll( m_config.m_pollTimeoutMilliseconds );
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------
+uint32_t TCPMultiplexer::GetConnectionId( int slotIdx ) const
+{
+	return ( (uint32_t)m_connections[slotIdx].m_generation << 16 ) | (uint32_t)slotIdx;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+TCPMultiplexer::Connection* TCPMultiplexer::GetConnection( uint32_t connectionId )
+{
+	uint32_t slotIdx = connectionId & 0xFFFF;
+	if( slotIdx >= m_connections.size() )
+	{
+		return nullptr;
+	}
+
+	Connection& connection = m_connections[slotIdx];
+	if( !connection.m_isOpen || connection.m_generation != ( connectionId >> 16 ) )
+	{
+		return nullptr;
+	}
+	return &connection;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+uint32_t TCPMultiplexer::AddConnection( SocketHandle socketHandle )
+{
+	if( m_freeSlots.empty() )
+	{
+		CloseSocketHandle( socketHandle );
+		return INVALID_TCP_CONNECTION_ID;
+	}
+
+	int slotIdx = m_freeSlots.back();
+	Connection& connection = m_connections[slotIdx];
+
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+	epoll_event connectionEvent;
+	connectionEvent.events = EPOLLIN;
+	connectionEvent.data.u64 = (uint64_t)slotIdx;
+	if( ::epoll_ctl( m_epollFd, EPOLL_CTL_ADD, socketHandle, &connectionEvent ) != 0 )
+	{
+		m_lastError = GetLastSocketError();
+		CloseSocketHandle( socketHandle );
+		return INVALID_TCP_CONNECTION_ID;
+	}
+#endif
+	m_freeSlots.pop_back();
+
+	// Ring buffers are allocated on a slot's first use and kept for the next connection
+	if( connection.m_readBuffer.GetCapacity() == 0 )
+	{
+		connection.m_readBuffer.Reset( m_config.m_readBufferBytes );
+		connection.m_writeBuffer.Reset( m_config.m_writeBufferBytes );
+	}
+	connection.m_readBuffer.Clear();
+	connection.m_writeBuffer.Clear();
+
+	connection.m_socket = socketHandle;
+	connection.m_isOpen = true;
+	connection.m_isClosing = false;
+	connection.m_isDirty = false;
+	connection.m_isWaitingForWritable = false;
+	++m_numConnections;
+	return GetConnectionId( slotIdx );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::AcceptPending()
+{
+	for( ;; )
+	{
+		SocketHandle socketHandle = ::accept( m_listenSocket, nullptr, nullptr );
+		if( socketHandle == INVALID_SOCKET_HANDLE )
+		{
+			int error = GetLastSocketError();
+			if( !IsWouldBlock( error ) )
+			{
+				m_lastError = error;
+			}
+			return;
+		}
+
+		if( !SetNonBlocking( socketHandle ) )
+		{
+			m_lastError = GetLastSocketError();
+			CloseSocketHandle( socketHandle );
+			continue;
+		}
+		SetNoDelay( socketHandle );
+
+		uint32_t connectionId = AddConnection( socketHandle );
+		if( connectionId == INVALID_TCP_CONNECTION_ID )
+		{
+			continue;
+		}
+
+		++m_stats.m_numAccepted;
+		TCPEvent connectedEvent;
+		connectedEvent.m_type = eTCPEventType::CONNECTED;
+		connectedEvent.m_connectionId = connectionId;
+		DispatchEvent( connectedEvent );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::ReadFromConnection( int slotIdx )
+{
+	Connection& connection = m_connections[slotIdx];
+	if( !connection.m_isOpen || connection.m_isClosing )
+	{
+		return;
+	}
+
+	bool isFinished = false;
+	for( ;; )
+	{
+		ByteSpan spans[2];
+		int numSpans = connection.m_readBuffer.GetWritableSpans( spans );
+		if( numSpans == 0 )
+		{
+			// Ring is full of complete frames; hand them out to make room
+			DispatchFrames( slotIdx );
+			if( connection.m_isClosing )
+			{
+				return;
+			}
+			numSpans = connection.m_readBuffer.GetWritableSpans( spans );
+		}
+
+		int numRead = ReadVectored( connection.m_socket, spans, numSpans );
+		++m_stats.m_numReadCalls;
+		if( numRead > 0 )
+		{
+			connection.m_readBuffer.CommitWrite( (uint32_t)numRead );
+			m_stats.m_numBytesRead += (uint64_t)numRead;
+
+			// A short read means the socket is drained; level-triggered readiness brings us back for more
+			size_t numRequested = spans[0].m_numBytes + ( numSpans > 1 ? spans[1].m_numBytes : 0 );
+			if( (size_t)numRead < numRequested )
+			{
+				break;
+			}
+			continue;
+		}
+
+		if( numRead < 0 )
+		{
+			int error = GetLastSocketError();
+			if( IsWouldBlock( error ) )
+			{
+				break;
+			}
+			m_lastError = error;
+		}
+		isFinished = true;		// orderly shutdown or a hard error
+		break;
+	}
+
+	// Frames that arrived before the peer went away still get delivered
+	DispatchFrames( slotIdx );
+	if( isFinished )
+	{
+		Close( GetConnectionId( slotIdx ) );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::DispatchFrames( int slotIdx )
+{
+	Connection& connection = m_connections[slotIdx];
+	ByteRingBuffer& readBuffer = connection.m_readBuffer;
+	while( !connection.m_isClosing && readBuffer.GetNumReadable() >= TCP_FRAME_HEADER_BYTES )
+	{
+		uint8_t header[TCP_FRAME_HEADER_BYTES];
+		readBuffer.Peek( header, TCP_FRAME_HEADER_BYTES );
+		uint16_t messageId = (uint16_t)( header[0] | ( header[1] << 8 ) );
+		uint32_t numBytes = (uint32_t)( header[2] | ( header[3] << 8 ) );
+		uint32_t frameBytes = TCP_FRAME_HEADER_BYTES + numBytes;
+		if( frameBytes > readBuffer.GetCapacity() )
+		{
+			Close( GetConnectionId( slotIdx ) );
+			return;
+		}
+		if( readBuffer.GetNumReadable() < frameBytes )
+		{
+			return;
+		}
+
+		uint8_t const* frame = readBuffer.GetContiguousReadable( frameBytes );
+		if( frame == nullptr )
+		{
+			m_frameScratch.resize( frameBytes );
+			readBuffer.Peek( m_frameScratch.data(), frameBytes );
+			frame = m_frameScratch.data();
+		}
+
+		TCPEvent messageEvent;
+		messageEvent.m_type = eTCPEventType::MESSAGE;
+		messageEvent.m_connectionId = GetConnectionId( slotIdx );
+		messageEvent.m_messageId = messageId;
+		messageEvent.m_numBytes = (int)numBytes;
+		messageEvent.m_data = frame + TCP_FRAME_HEADER_BYTES;
+		++m_stats.m_numMessagesReceived;
+		DispatchEvent( messageEvent );
+
+		readBuffer.CommitRead( frameBytes );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::FlushConnection( int slotIdx )
+{
+	Connection& connection = m_connections[slotIdx];
+	if( !connection.m_isOpen )
+	{
+		return;
+	}
+
+	while( !connection.m_writeBuffer.IsEmpty() )
+	{
+		ByteSpan spans[2];
+		int numSpans = connection.m_writeBuffer.GetReadableSpans( spans );
+		int numWritten = WriteVectored( connection.m_socket, spans, numSpans );
+		++m_stats.m_numWriteCalls;
+		if( numWritten > 0 )
+		{
+			connection.m_writeBuffer.CommitRead( (uint32_t)numWritten );
+			m_stats.m_numBytesWritten += (uint64_t)numWritten;
+			continue;
+		}
+
+		int error = GetLastSocketError();
+		if( numWritten < 0 && IsWouldBlock( error ) )
+		{
+			SetWaitingForWritable( slotIdx, true );
+			return;
+		}
+
+		m_lastError = error;
+		connection.m_writeBuffer.Clear();
+		Close( GetConnectionId( slotIdx ) );
+		break;
+	}
+	SetWaitingForWritable( slotIdx, false );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::FlushDirtyConnections()
+{
+	// One vectored write per connection for everything queued during this poll
+	for( int slotIdx : m_dirtyConnections )
+	{
+		Connection& connection = m_connections[slotIdx];
+		if( connection.m_isDirty )
+		{
+			connection.m_isDirty = false;
+			if( !connection.m_isWaitingForWritable )
+			{
+				FlushConnection( slotIdx );
+			}
+		}
+	}
+	m_dirtyConnections.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::SetWaitingForWritable( int slotIdx, bool isWaiting )
+{
+	Connection& connection = m_connections[slotIdx];
+	if( connection.m_isWaitingForWritable == isWaiting )
+	{
+		return;
+	}
+	connection.m_isWaitingForWritable = isWaiting;
+
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+	epoll_event connectionEvent;
+	connectionEvent.events = (uint32_t)EPOLLIN | ( isWaiting ? (uint32_t)EPOLLOUT : 0u );
+	connectionEvent.data.u64 = (uint64_t)slotIdx;
+	::epoll_ctl( m_epollFd, EPOLL_CTL_MOD, connection.m_socket, &connectionEvent );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::CloseMarkedConnections()
+{
+	// DISCONNECTED handlers may close more connections, so the list can grow while we walk it
+	for( size_t closingIdx = 0; closingIdx < m_closingConnections.size(); ++closingIdx )
+	{
+		CloseConnectionNow( m_closingConnections[closingIdx] );
+	}
+	m_closingConnections.clear();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::CloseConnectionNow( int slotIdx )
+{
+	Connection& connection = m_connections[slotIdx];
+	if( !connection.m_isOpen )
+	{
+		return;
+	}
+
+	// Last chance for whatever is still queued; no waiting around for a slow peer
+	if( !connection.m_writeBuffer.IsEmpty() )
+	{
+		ByteSpan spans[2];
+		int numSpans = connection.m_writeBuffer.GetReadableSpans( spans );
+		WriteVectored( connection.m_socket, spans, numSpans );
+	}
+
+	TCPEvent disconnectedEvent;
+	disconnectedEvent.m_type = eTCPEventType::DISCONNECTED;
+	disconnectedEvent.m_connectionId = GetConnectionId( slotIdx );
+
+	CloseSocketHandle( connection.m_socket );
+	connection.m_socket = INVALID_SOCKET_HANDLE;
+	connection.m_isOpen = false;
+	connection.m_isClosing = false;
+	connection.m_isDirty = false;
+	connection.m_isWaitingForWritable = false;
+	++connection.m_generation;
+	m_freeSlots.push_back( slotIdx );
+	--m_numConnections;
+	++m_stats.m_numDisconnected;
+
+	DispatchEvent( disconnectedEvent );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void TCPMultiplexer::DispatchEvent( TCPEvent const& tcpEvent )
+{
+	if( m_eventHandler )
+	{
+		m_eventHandler( tcpEvent );
+	}
+}
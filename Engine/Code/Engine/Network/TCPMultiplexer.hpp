@@ -0,0 +1,169 @@
+#pragma once
+#include "Engine/Network/ByteRingBuffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined( _WIN32 )
+	#ifndef _WINSOCK_DEPRECATED_NO_WARNINGS
+	#define _WINSOCK_DEPRECATED_NO_WARNINGS
+	#endif
+	#include <WinSock2.h>
+	#include <WS2tcpip.h>
+	#pragma comment(lib,"ws2_32.lib")
+	using SocketHandle = SOCKET;
+#else
+	#include <poll.h>
+	using SocketHandle = int;
+#endif
+
+// epoll on Linux; poll() elsewhere (WSAPoll on Windows), which is fine for a few hundred connections
+#if defined( __linux__ )
+	#define TCP_MULTIPLEXER_USE_EPOLL
+#endif
+
+//-------------------------------------------------------------------------------------------------------------
+// Many TCP connections driven by readiness on one thread - accepted from a listen port, opened with
+// Connect(), or both. Nothing here depends on the rest of the engine, so a dedicated lobby or telemetry
+// server can build just this and ByteRingBuffer on a Linux host.
+//
+// Frames are length-prefixed with the same MessageHeader layout TCPSocket uses - uint16 id, uint16 payload
+// size, little endian - so TCPClient can talk to it unchanged. Each connection has a read and a write ring;
+// a readiness event reads as much as is there in one vectored call and dispatches every complete frame,
+// and Send() only appends to the write ring, which is flushed with one vectored write per connection at the
+// end of the poll. A connection that sends a frame larger than its read ring is dropped.
+//
+// Threading: Poll() and everything that touches connections (Send, Close, Connect) belong to one thread -
+// either the caller's, or the I/O thread started with StartThread(), in which case they may only be called
+// from the event handler.
+//-------------------------------------------------------------------------------------------------------------
+constexpr uint32_t	INVALID_TCP_CONNECTION_ID	= 0xFFFFFFFF;
+constexpr int		TCP_FRAME_HEADER_BYTES		= 4;
+
+//-------------------------------------------------------------------------------------------------------------
+enum class eTCPEventType
+{
+	CONNECTED,
+	MESSAGE,
+	DISCONNECTED,
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct TCPEvent
+{
+	eTCPEventType	m_type = eTCPEventType::MESSAGE;
+	uint32_t		m_connectionId = INVALID_TCP_CONNECTION_ID;
+	uint16_t		m_messageId = 0;
+	int				m_numBytes = 0;
+	uint8_t const*	m_data = nullptr;			// valid only during the callback
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct TCPMultiplexerConfig
+{
+	int			m_maxConnections = 1024;		// at most 65535
+	uint32_t	m_readBufferBytes = 64 * 1024;
+	uint32_t	m_writeBufferBytes = 64 * 1024;
+	int			m_pollTimeoutMilliseconds = 1;	// I/O thread only
+};
+
+//-------------------------------------------------------------------------------------------------------------
+struct TCPMultiplexerStats
+{
+	uint64_t	m_numAccepted = 0;
+	uint64_t	m_numDisconnected = 0;
+	uint64_t	m_numMessagesReceived = 0;
+	uint64_t	m_numMessagesSent = 0;
+	uint64_t	m_numSendsRejected = 0;		// write ring full
+	uint64_t	m_numReadCalls = 0;
+	uint64_t	m_numWriteCalls = 0;
+	uint64_t	m_numBytesRead = 0;
+	uint64_t	m_numBytesWritten = 0;
+};
+
+
+//-------------------------------------------------------------------------------------------------------------
+class TCPMultiplexer
+{
+public:
+	using EventHandler = std::function<void( TCPEvent const& )>;
+
+public:
+	explicit TCPMultiplexer( TCPMultiplexerConfig const& config = TCPMultiplexerConfig() );
+	~TCPMultiplexer();
+
+	void		SetEventHandler( EventHandler const& handler )		{ m_eventHandler = handler; }
+
+	bool		Listen( int port );
+	uint32_t	Connect( std::string const& host, int port );		// blocking connect; INVALID_TCP_CONNECTION_ID on failure
+	void		Shutdown();											// closes the listen socket and every connection
+
+	// Waits up to timeoutMilliseconds for readiness, accepts, reads, dispatches and flushes; returns the number of ready sockets
+	int			Poll( int timeoutMilliseconds );
+
+	bool		Send( uint32_t connectionId, uint16_t messageId, void const* data, int numBytes );	// false if the write ring is full
+	int			Broadcast( uint16_t messageId, void const* data, int numBytes );					// returns how many were queued
+	void		Close( uint32_t connectionId );						// after the current dispatch; pending writes get one last flush
+
+	void		StartThread();
+	void		StopThread();
+
+	int							GetNumConnections() const		{ return m_numConnections; }
+	TCPMultiplexerStats const&	GetStats() const				{ return m_stats; }
+	int							GetLastError() const			{ return m_lastError; }
+
+private:
+	struct Connection
+	{
+		SocketHandle	m_socket;
+		uint16_t		m_generation = 0;
+		bool			m_isOpen = false;
+		bool			m_isClosing = false;
+		bool			m_isDirty = false;				// in m_dirtyConnections
+		bool			m_isWaitingForWritable = false;	// write ring didn't drain; watching for writability
+		ByteRingBuffer	m_readBuffer;
+		ByteRingBuffer	m_writeBuffer;
+	};
+
+	Connection*	GetConnection( uint32_t connectionId );
+	uint32_t	AddConnection( SocketHandle socket );
+	void		AcceptPending();
+	void		ReadFromConnection( int slotIdx );
+	void		DispatchFrames( int slotIdx );
+	void		FlushConnection( int slotIdx );
+	void		FlushDirtyConnections();
+	void		CloseConnectionNow( int slotIdx );
+	void		CloseMarkedConnections();
+	void		SetWaitingForWritable( int slotIdx, bool isWaiting );
+	uint32_t	GetConnectionId( int slotIdx ) const;
+	void		DispatchEvent( TCPEvent const& tcpEvent );
+	void		ThreadMain();
+
+private:
+	TCPMultiplexerConfig	m_config;
+	EventHandler			m_eventHandler;
+	SocketHandle			m_listenSocket;
+
+	std::vector<Connection>	m_connections;
+	std::vector<int>		m_freeSlots;
+	std::vector<int>		m_dirtyConnections;
+	std::vector<int>		m_closingConnections;
+	std::vector<uint8_t>	m_frameScratch;				// frames that wrap around the read ring
+	int						m_numConnections = 0;
+
+#if defined( TCP_MULTIPLEXER_USE_EPOLL )
+	int						m_epollFd = -1;
+#else
+	std::vector<pollfd>		m_pollEntries;
+	std::vector<int>		m_pollSlots;				// connection slot per poll entry, -1 for the listen socket
+#endif
+
+	std::thread*			m_ioThread = nullptr;
+	std::atomic<bool>		m_isQuitting{ false };
+
+	TCPMultiplexerStats		m_stats;
+	int						m_lastError = 0;
+};
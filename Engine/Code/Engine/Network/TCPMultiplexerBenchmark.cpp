@@ -0,0 +1,136 @@
+#include "Engine/Network/TCPMultiplexer.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// Kept out of NetworkSystem.cpp, which is WinSock only: this needs nothing but TCPMultiplexer, so it runs wherever that does
+
+//-------------------------------------------------------------------------------------------------------------
+// benchmark_tcp: echo round trips over loopback. The server multiplexer runs on its own I/O thread and echoes
+// every frame back; all clients share a second multiplexer polled on this thread, each keeping a few messages
+// in flight. Latency comes from a timestamp carried in the payload.
+//-------------------------------------------------------------------------------------------------------------
+constexpr int		TCP_BENCHMARK_MESSAGES_IN_FLIGHT	= 8;
+constexpr double	TCP_BENCHMARK_TIMEOUT_SECONDS		= 30.0;
+constexpr uint16_t	TCP_BENCHMARK_MESSAGE_ID			= 1;
+
+static void RunTCPBenchmark( int numClients, int messagesPerClient, int payloadBytes, int port )
+{
+	TCPMultiplexerConfig serverConfig;
+	serverConfig.m_maxConnections = numClients + 1;
+	TCPMultiplexer server( serverConfig );
+	server.SetEventHandler( [&server]( TCPEvent const& tcpEvent ) {
+		if( tcpEvent.m_type == eTCPEventType::MESSAGE ) {
+			server.Send( tcpEvent.m_connectionId, tcpEvent.m_messageId, tcpEvent.m_data, tcpEvent.m_numBytes );
+		}
+	} );
+	if( !server.Listen( port ) ) {
+		g_theConsole->Error( "benchmark_tcp: failed to listen on port %i, error = %i", port, server.GetLastError() );
+		return;
+	}
+	server.StartThread();
+
+	TCPMultiplexerConfig clientConfig;
+	clientConfig.m_maxConnections = numClients;
+	TCPMultiplexer clients( clientConfig );
+
+	std::vector<uint32_t> connectionIds;
+	std::unordered_map<uint32_t, int> clientIndices;
+	std::vector<int> numSent( numClients, 0 );
+	std::vector<float> latencies;
+	latencies.reserve( (size_t)numClients * messagesPerClient );
+	std::vector<uint8_t> payload( payloadBytes, 0 );
+
+	auto sendNext = [&]( int clientIdx ) {
+		double currentSeconds = GetCurrentTimeSeconds();
+		std::memcpy( payload.data(), &currentSeconds, sizeof( currentSeconds ) );
+		if( clients.Send( connectionIds[clientIdx], TCP_BENCHMARK_MESSAGE_ID, payload.data(), payloadBytes ) ) {
+			++numSent[clientIdx];
+		}
+	};
+	clients.SetEventHandler( [&]( TCPEvent const& tcpEvent ) {
+		if( tcpEvent.m_type != eTCPEventType::MESSAGE ) {
+			return;
+		}
+		double sentSeconds = 0.0;
+		std::memcpy( &sentSeconds, tcpEvent.m_data, sizeof( sentSeconds ) );
+		latencies.push_back( (float)( GetCurrentTimeSeconds() - sentSeconds ) );
+
+		int clientIdx = clientIndices[tcpEvent.m_connectionId];
+		if( numSent[clientIdx] < messagesPerClient ) {
+			sendNext( clientIdx );
+		}
+	} );
+
+	for( int clientIdx = 0; clientIdx < numClients; ++clientIdx ) {
+		uint32_t connectionId = clients.Connect( "127.0.0.1", port );
+		if( connectionId == INVALID_TCP_CONNECTION_ID ) {
+			g_theConsole->Error( "benchmark_tcp: client %i failed to connect, error = %i", clientIdx, clients.GetLastError() );
+			server.StopThread();
+			return;
+		}
+		clientIndices[connectionId] = clientIdx;
+		connectionIds.push_back( connectionId );
+	}
+
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int clientIdx = 0; clientIdx < numClients; ++clientIdx ) {
+		for( int messageIdx = 0; messageIdx < TCP_BENCHMARK_MESSAGES_IN_FLIGHT && messageIdx < messagesPerClient; ++messageIdx ) {
+			sendNext( clientIdx );
+		}
+	}
+
+	size_t numMessages = (size_t)numClients * messagesPerClient;
+	while( latencies.size() < numMessages && GetCurrentTimeSeconds() - startSeconds < TCP_BENCHMARK_TIMEOUT_SECONDS ) {
+		clients.Poll( 1 );
+	}
+	double elapsedSeconds = GetCurrentTimeSeconds() - startSeconds;
+	server.StopThread();
+
+	if( latencies.empty() ) {
+		g_theConsole->Error( "benchmark_tcp: no messages came back" );
+		return;
+	}
+	std::sort( latencies.begin(), latencies.end() );
+	float p50 = latencies[latencies.size() / 2];
+	float p99 = latencies[( latencies.size() * 99 ) / 100];
+
+	// How many frames each vectored write carried is what the per-connection write rings buy
+	TCPMultiplexerStats const& serverStats = server.GetStats();
+	double messagesPerWrite = serverStats.m_numWriteCalls > 0 ? (double)serverStats.m_numMessagesSent / (double)serverStats.m_numWriteCalls : 0.0;
+	double messagesPerRead = serverStats.m_numReadCalls > 0 ? (double)serverStats.m_numMessagesReceived / (double)serverStats.m_numReadCalls : 0.0;
+
+	g_theConsole->PrintString( latencies.size() == numMessages ? Rgba8::WHITE : Rgba8::RED,
+		Stringf( "%4i clients: %10.0f msgs/s, p50 %8.1f us, p99 %8.1f us, %u/%u echoed, server %.2f msgs/write, %.2f msgs/read",
+			numClients, (double)latencies.size() / elapsedSeconds, p50 * 1000000.f, p99 * 1000000.f,
+			(unsigned int)latencies.size(), (unsigned int)numMessages, messagesPerWrite, messagesPerRead ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_tcp, "clients,messages,bytes,port" )
+{
+	int numClients = args.GetValue( "clients", 0 );
+	int numMessages = args.GetValue( "messages", 200000 );
+	int payloadBytes = args.GetValue( "bytes", 64 );
+	int port = args.GetValue( "port", 48300 );
+	if( numMessages <= 0 || payloadBytes < (int)sizeof( double ) || payloadBytes > 16384 ) {
+		g_theConsole->Error( "benchmark_tcp: messages must be positive and bytes in [8,16384]" );
+		return;
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "TCP echo over loopback, %i messages of %i bytes per run, %i in flight per client",
+		numMessages, payloadBytes, TCP_BENCHMARK_MESSAGES_IN_FLIGHT ) );
+	int clientCounts[] = { 1, 16, 256 };
+	for( int defaultClients : clientCounts ) {
+		int runClients = numClients > 0 ? numClients : defaultClients;
+		int messagesPerClient = numMessages / runClients > TCP_BENCHMARK_MESSAGES_IN_FLIGHT ? numMessages / runClients : TCP_BENCHMARK_MESSAGES_IN_FLIGHT;
+		RunTCPBenchmark( runClients, messagesPerClient, payloadBytes, port );
+		if( numClients > 0 ) {
+			break;
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include "UDPSocket.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Profiler.hpp"
 
 //#ifdef TEST_MODE
 //	#define LOG_ERROR(...) printf(Stringf(__VA_ARGS__) + std::string("\n") ) 
@@ -7,15 +8,22 @@
 //	#define LOG_ERROR(...) g_theConsole->Error( Stringf(__VA_ARGS__) );
 //#endif
  
+// How long the reader thread blocks in select() before re-checking m_isQuitting
+constexpr long READER_SELECT_TIMEOUT_MICROSECONDS = 50000;
+
 UDPSocket::UDPSocket()
-	:m_timeval{0l, 0l}
+	:m_readerQueue( MessageQueueCapacity )
+	,m_writerQueue( MessageQueueCapacity )
+	,m_timeval{0l, READER_SELECT_TIMEOUT_MICROSECONDS}
 {
 	FD_ZERO( &m_fdSet );
 }
 
 UDPSocket::UDPSocket( const std::string& host, int port )
 	:m_socket( INVALID_SOCKET )
-	,m_timeval{0l, 0l}
+	,m_readerQueue( MessageQueueCapacity )
+	,m_writerQueue( MessageQueueCapacity )
+	,m_timeval{0l, READER_SELECT_TIMEOUT_MICROSECONDS}
 {
 	FD_ZERO( &m_fdSet );
 
@@ -32,10 +40,8 @@ UDPSocket::UDPSocket( const std::string& host, int port )
 
 UDPSocket::~UDPSocket()
 {
-	Close();
-	FD_ZERO( &m_fdSet );
-
 	m_isQuitting = true;
+	m_writerQueue.WakeAll();
 
 	if( m_readerThread )
 	{
@@ -50,6 +56,9 @@ UDPSocket::~UDPSocket()
 		delete m_writerThread;
 		m_writerThread = nullptr;
 	}
+
+	Close();
+	FD_ZERO( &m_fdSet );
 }
 
 void UDPSocket::Bind( int port )
@@ -87,11 +96,6 @@ int UDPSocket::Receive()
  		g_theConsole->Error( "Socket receive failed, error = %i", WSAGetLastError() );
 	}
 
-	char fromIp[256];
-	ZeroMemory( fromIp, 256 );
-	inet_ntop( AF_INET, &fromAddr.sin_addr, fromIp, 256 );
-	g_theConsole->Printf( "Receive data from: %s", fromIp );
-
 	//if( result != SOCKET_ERROR )
 	//{
 	//	MessageHeader* pHeader = reinterpret_cast< MessageHeader* >( &m_receiveBuffer[0] );
@@ -118,44 +122,51 @@ bool UDPSocket::IsDataAvailable()
 {
 	FD_ZERO( &m_fdSet );
 	FD_SET( m_socket, &m_fdSet );
-	int iResult = select( 0, &m_fdSet, NULL, NULL, &m_timeval );
+	timeval timeout = m_timeval;	// blocks for up to the timeout instead of spinning
+	int iResult = select( 0, &m_fdSet, NULL, NULL, &timeout );
 	if( iResult == SOCKET_ERROR )
 	{
 		closesocket( m_socket );
+		return false;
 	}
-	return FD_ISSET( m_socket, &m_fdSet );
+	return iResult > 0 && FD_ISSET( m_socket, &m_fdSet );
 }
 
-void UDPSocket::SendMsg( eMessageType id, char const* pData, int length )
+int UDPSocket::SendMsg( eMessageType id, char const* pData, int length )
 {
-	switch( id ) {
-		case eMessageType::TEXT_MESSAGE: 
-		{
-			MessageHeader* header = reinterpret_cast<MessageHeader*>( &m_sendBuffer[0] );
-			header->m_id = (uint16_t)id;
-			header->m_size = (uint16_t)length;
+	length = length < MaxPayloadSize ? length : MaxPayloadSize;
 
-			std::string str( pData );
-			for( int i = 0; i < str.size(); ++i )
-			{
-				m_sendBuffer[i + 4] = str[i];
-			}
+	MessageHeader* header = reinterpret_cast<MessageHeader*>( &m_sendBuffer[0] );
+	header->m_id = (uint16_t)id;
+	header->m_size = (uint16_t)length;
+	std::memcpy( &m_sendBuffer[sizeof( MessageHeader )], pData, length );
 
-			Send( length + 4 );
-			break;
-		}
+	return Send( length + (int)sizeof( MessageHeader ) );
+}
 
-	}
+bool UDPSocket::PushMsgIntoQueue( const std::string& message )
+{
+	return PushMsgIntoQueue( eMessageType::TEXT_MESSAGE, message.data(), (int)message.size() );
 }
 
-void UDPSocket::PushMsgIntoQueue( const std::string& message )
+bool UDPSocket::PushMsgIntoQueue( eMessageType id, char const* pData, int length )
 {
-	m_writerQueue.Push( message );
+	Message* slot = m_writerQueue.TryBeginPush();
+	if( slot == nullptr )
+	{
+		return false;
+	}
+
+	slot->m_id = (uint16_t)id;
+	slot->m_size = length < MaxPayloadSize ? length : MaxPayloadSize;
+	std::memcpy( slot->m_data, pData, slot->m_size );
+	m_writerQueue.CommitPush();
+	return true;
 }
 
-std::string UDPSocket::GetMsg()
+bool UDPSocket::PopMsg( Message& out_message )
 {
-	return m_readerQueue.Pop();
+	return m_readerQueue.TryPop( out_message );
 }
 
 void UDPSocket::SetupThreads()
@@ -166,51 +177,75 @@ void UDPSocket::SetupThreads()
 
 void UDPSocket::WriterThreadMain()
 {
-	while( !m_isQuitting )
+	PROFILER_SET_THREAD_NAME( "UDP Writer" );
+	// Sleeps until the game thread queues a message; WaitForItem() returns false once the
+	// destructor has called WakeAll(), after which whatever is still queued gets flushed
+	do
 	{
-		std::string messageToSend = m_writerQueue.Pop();
-		if( !messageToSend.empty() )
-		{
-			int stringLength = (int)messageToSend.length();
-			std::memcpy( &m_sendBuffer[0], &messageToSend[0], stringLength );
-			SendMsg( eMessageType::TEXT_MESSAGE, messageToSend.c_str(), (int)messageToSend.length() );
-			//Send( stringLength );
-		}
-	}
+		SendQueuedMessages();
+	} while( m_writerQueue.WaitForItem() );
+	SendQueuedMessages();
 
 	g_theConsole->Printf( "Exiting writer thread..." );
 }
 
+void UDPSocket::SendQueuedMessages()
+{
+	// Sends straight out of the queue slots, no copies
+	Message* messageToSend = nullptr;
+	while( ( messageToSend = m_writerQueue.TryBeginPop() ) != nullptr )
+	{
+		PROFILE_SCOPE( "UDPSocket::Send" );
+		SendMsg( (eMessageType)messageToSend->m_id, messageToSend->m_data, messageToSend->m_size );
+		m_writerQueue.CommitPop();
+	}
+}
+
 void UDPSocket::ReaderThreadMain()
 {
+	PROFILER_SET_THREAD_NAME( "UDP Reader" );
 	while( !m_isQuitting )
 	{
 		if( IsDataAvailable() )
 		{
+			PROFILE_SCOPE( "UDPSocket::Receive" );
 			int length = Receive();
-			if( length > 0 )
+			if( length >= (int)sizeof( MessageHeader ) )
 			{
 				MessageHeader* pHeader = reinterpret_cast<MessageHeader*>(&m_receiveBuffer[0]);
-				m_receiveBuffer[length] = NULL;
-				TCPMessageData messageData( *pHeader, &m_receiveBuffer[4] );
+				int payloadSize = length - (int)sizeof( MessageHeader );
+				payloadSize = (int)pHeader->m_size < payloadSize ? (int)pHeader->m_size : payloadSize;
 
-				switch( pHeader->m_id ) {
-					case 2: // Text Message
+				switch( (eMessageType)pHeader->m_id ) {
+					case eMessageType::TEXT_MESSAGE:
+					{
+						// Nothing on the game side polls for these; the main thread gets them at its next DispatchQueuedEvents
+						NamedProperties args;
+						args.SetValue( "text", std::string( &m_receiveBuffer[sizeof( MessageHeader )], payloadSize ) );
+						g_theEventSystem->QueueEvent( UDP_TEXT_MESSAGE_RECEIVED_EVENT, args );
+						break;
+					}
+					case eMessageType::SNAPSHOT:
+					case eMessageType::SNAPSHOT_ACK:
+					case eMessageType::CONNECTION_PACKET:
 					{
-						std::string msg = &m_receiveBuffer[4];
-						m_readerQueue.Push( msg );
+						// Copied straight into the queue slot; dropped if the game thread has fallen behind
+						Message* slot = m_readerQueue.TryBeginPush();
+						if( slot != nullptr )
+						{
+							slot->m_id = pHeader->m_id;
+							slot->m_size = payloadSize;
+							std::memcpy( slot->m_data, &m_receiveBuffer[sizeof( MessageHeader )], payloadSize );
+							m_readerQueue.CommitPush();
+						}
 						break;
 					}
+					default:
+						break;
 				}
-
-				//std::string msg = &m_receiveBuffer[0];
-				
 			}
 		}
 	}
-	// Hack to avoid thread blocking.
-	// ToDo: Remove this
-	m_writerQueue.Push( "" );
 
 	g_theConsole->Printf( "Exiting reader thread..." );
 }
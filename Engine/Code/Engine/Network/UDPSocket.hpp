@@ -1,9 +1,10 @@
 #pragma once
-#include "Engine/Network/SynchronizedBlockingQueue.h"
-#include "Engine/Network/SynchronizedNonBlockingQueue.h"
+#include "Engine/Core/RingQueue.hpp"
 #include "Engine/Network/NetworkDefs.hpp"
 #include <string>
 #include <array>
+#include <atomic>
+#include <thread>
 
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
 #include <WinSock2.h>
@@ -11,12 +12,25 @@
 
 #pragma comment(lib, "Ws2_32.lib")
 
+// Queued by the reader thread for every TEXT_MESSAGE, with the payload as the "text" arg
+constexpr char const* UDP_TEXT_MESSAGE_RECEIVED_EVENT = "UDPTextMessageReceived";
+
 class UDPSocket
 {
 public:
-	static const int BufferSize = 512;
+	static const int BufferSize = 1200;		// one datagram; stays under the 1280 byte IPv6 minimum MTU with IP/UDP headers
+	static const int MaxPayloadSize = BufferSize - (int)sizeof( MessageHeader );
+	static const int MessageQueueCapacity = 256;
 	using Buffer = std::array< char, BufferSize >;
 
+	// Fixed-size so the queues between the game and socket threads never allocate
+	struct Message
+	{
+		uint16_t	m_id = 0;		// eMessageType
+		int		m_size = 0;
+		char	m_data[MaxPayloadSize];
+	};
+
 	UDPSocket();
 	UDPSocket( const std::string& host, int port );
 	~UDPSocket();
@@ -30,31 +44,33 @@ public:
 
 	bool	IsDataAvailable();
 
-	void			SendMsg( eMessageType id, char const* pData, int legnth );
-	void			PushMsgIntoQueue( const std::string& message );
-	std::string		GetMsg();
+	int				SendMsg( eMessageType id, char const* pData, int legnth );	// sends immediately on the calling thread
+	bool			PushMsgIntoQueue( const std::string& message );	// game thread; false if the send queue is full
+	bool			PushMsgIntoQueue( eMessageType id, char const* pData, int length );
+	bool			PopMsg( Message& out_message );					// game thread; false if nothing was received
 
 	void	SetupThreads();
 
 	void	WriterThreadMain();
 	void	ReaderThreadMain();
+	void	SendQueuedMessages();
 
 	Buffer& GetSendBuffer() { return m_sendBuffer; }
 	Buffer& GetReceiveBuffer() { return m_receiveBuffer; }
 
 private:
-	bool			m_isQuitting = false;
+	std::atomic<bool>	m_isQuitting{ false };
 
 	Buffer			m_sendBuffer;
 	Buffer			m_receiveBuffer;
 	sockaddr_in		m_toAddress;
 	sockaddr_in		m_bindAddress;
-	SOCKET			m_socket;
+	SOCKET			m_socket = INVALID_SOCKET;
 
-	// reader - nonblocking
-	// writer - blocking
-	SynchronizedNonBlockingQueue<std::string> m_readerQueue;
-	SynchronizedBlockingQueue<std::string> m_writerQueue;
+	// reader thread -> game thread, polled once a frame
+	// game thread -> writer thread, which sleeps in WaitPop until there is something to send
+	SPSCRingQueue<Message>	m_readerQueue;
+	SPSCRingQueue<Message>	m_writerQueue;
 
 	std::thread* m_writerThread = nullptr;
 	std::thread* m_readerThread = nullptr;
@@ -12,6 +12,32 @@
 #include <algorithm>
 
 
+Physics2D::~Physics2D()
+{
+	// bodies assert their collider is gone, so detach and mark everything before freeing it
+	for( int rbIndex = 0; rbIndex < (int)m_rigidBodies.size(); rbIndex++ )
+	{
+		if( m_rigidBodies[rbIndex] ) {
+			m_rigidBodies[rbIndex]->Destroy();
+		}
+	}
+
+	for( int colliderIndex = 0; colliderIndex < (int)m_colliders.size(); colliderIndex++ )
+	{
+		if( m_colliders[colliderIndex] ) {
+			m_colliders[colliderIndex]->Destroy();
+		}
+	}
+
+	CleanupDestroyedObjects();
+
+	delete m_stepTimer;
+	m_stepTimer = nullptr;
+
+	delete m_clock;
+	m_clock = nullptr;
+}
+
 void Physics2D::StartUp()
 {
 	m_clock = new Clock( Clock::GetMaster() );
@@ -418,8 +444,10 @@ void Physics2D::CalculcateCollisionImpulse()
 		Vec2 contactPointMe = col.GetContactPoint( col.me );
 		Vec2 contactPointThem = col.GetContactPoint( col.them );
 
-		g_theDebugRenderSystem->DebugAddScreenPoint( contactPointMe, 1.f, Rgba8::MAGENTA, 0.1f );
-		g_theDebugRenderSystem->DebugAddScreenPoint( contactPointThem, 1.f, Rgba8::MAGENTA, 0.1f );
+		if( g_theDebugRenderSystem ) {
+			g_theDebugRenderSystem->DebugAddScreenPoint( contactPointMe, 1.f, Rgba8::MAGENTA, 0.1f );
+			g_theDebugRenderSystem->DebugAddScreenPoint( contactPointThem, 1.f, Rgba8::MAGENTA, 0.1f );
+		}
 
 		Vec2 myImpactVelocity = col.me->m_rigidbody->GetImpactVelocity( contactPointMe - col.me->m_rigidbody->m_worldPosition );
 		Vec2 theirImpactVelocity = col.them->m_rigidbody->GetImpactVelocity( contactPointThem - col.them->m_rigidbody->m_worldPosition );
@@ -34,6 +34,8 @@ struct Trigger2D
 class Physics2D
 {
 public:
+	~Physics2D();		// frees every body and collider still owned, plus the step clock
+
 	void StartUp();
 	void BeginFrame();
 	void Update( float deltaSeconds );   
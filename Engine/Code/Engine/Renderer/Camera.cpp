@@ -156,6 +156,13 @@ Mat44 Camera::GetProjectionMatrix() const
 	return m_projection;
 }
 
+Mat44 Camera::GetWorldToClipMatrix() const
+{
+	Mat44 worldToClip = m_projection;
+	worldToClip.TransformBy( GetViewMatrix() );
+	return worldToClip;
+}
+
 
 void Camera::SetPitchRollYawRotation( float pitch, float roll, float yaw )
 {
@@ -173,13 +180,9 @@ void Camera::SetClearMode( unsigned int clearFlags, Rgba8 color, float depth, un
 
 void Camera::ClearDepth( Texture* depthStencilTexture, float depth, uint stencil )
 {
+	UNUSED( depthStencilTexture );	// the clear itself is RenderContext::ClearDepth's
 	m_clearDepth = depth;
 	m_clearStencil = stencil;
-
-	TextureView* view = depthStencilTexture->GetOrCreateShaderResourceView();
-	ID3D11DepthStencilView* dsv = view->GetAsDSV();
-	UNUSED( dsv ); //ToDo: Implement depth function here
-	//m_cameraUBO->m_owner->m_device->ClearDepthStencilView( dsv, D3D11_CLEAR_DEPTH, depth, 0 );
 }
 
 Vec3 Camera::ClientToWorld( Vec2 client, float ndcZ )
@@ -84,6 +84,7 @@ public:
 	// Accessors
 	Mat44		GetViewMatrix() const;          
 	Mat44		GetProjectionMatrix() const;
+	Mat44		GetWorldToClipMatrix() const;	// projection * view
 	
 
 	// Helpers
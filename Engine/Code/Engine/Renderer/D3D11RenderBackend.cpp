@@ -0,0 +1,1136 @@
+#include "Engine/Renderer/D3D11RenderBackend.hpp"
+
+#if defined( _WIN32 )
+#include "Engine/Renderer/RenderContext.hpp"
+#include "Engine/Renderer/RenderBuffer.hpp"
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/Sampler.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Renderer/TextureView.hpp"
+#include "Engine/Renderer/ErrorShader.hpp"
+#include "Engine/Renderer/D3D11Common.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Platform/Window.hpp"
+#include <d3d11_1.h>
+#include <dxgi1_2.h>
+#include <d3dcompiler.h>
+#include <cstring>
+#include <vector>
+
+#pragma comment( lib, "d3d11.lib" )        
+#pragma comment( lib, "dxgi.lib" )         
+#pragma comment( lib, "d3dcompiler.lib" )  
+
+#define MSAA_ENABLED
+//#define VR_ENABLED
+//#define D3D11_DEBUG
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static UINT ToDXUsage( eRenderBufferUsage usage )
+{
+	UINT ret = 0;
+
+	if( usage & VERTEX_BUFFER_BIT )
+	{
+		ret |= D3D11_BIND_VERTEX_BUFFER;
+	}
+
+	if( usage & INDEX_BUFFER_BIT )
+	{
+		ret |= D3D11_BIND_INDEX_BUFFER;
+	}
+
+	if( usage & UNIFORM_BUFFER_BIT )
+	{
+		ret |= D3D11_BIND_CONSTANT_BUFFER;
+	}
+
+	if( usage & STRUCTURED_BUFFER_BIT )
+	{
+		ret |= D3D11_BIND_SHADER_RESOURCE;
+	}
+
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static D3D11_USAGE ToDXMemoryUsage( eRenderMemoryHint hint )
+{
+	switch( hint )
+	{
+	case MEMORY_HINT_GPU:		return D3D11_USAGE_DEFAULT;
+	case MEMORY_HINT_DYNAMIC:	return D3D11_USAGE_DYNAMIC;
+	case MEMORY_HINT_STAGING:	return D3D11_USAGE_STAGING;
+	default:					return D3D11_USAGE_DEFAULT;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static D3D11_COMPARISON_FUNC ToDXCompareFunc( eCompareOp op )
+{
+	switch( op )
+	{
+	case eCompareOp::COMPARE_FUNC_NEVER:			return D3D11_COMPARISON_NEVER;
+	case eCompareOp::COMPARE_FUNC_LESS:				return D3D11_COMPARISON_LESS;
+	case eCompareOp::COMPARE_FUNC_EQUAL:			return D3D11_COMPARISON_EQUAL;
+	case eCompareOp::COMPARE_FUNC_LEQUAL:			return D3D11_COMPARISON_LESS_EQUAL;
+	case eCompareOp::COMPARE_FUNC_GREATER:			return D3D11_COMPARISON_GREATER;
+	case eCompareOp::COMPARE_FUNC_NOT_EQUAL:		return D3D11_COMPARISON_NOT_EQUAL;
+	case eCompareOp::COMPARE_FUNC_GEQUAL:			return D3D11_COMPARISON_GREATER_EQUAL;
+	case eCompareOp::COMPARE_FUNC_ALWAYS:			return D3D11_COMPARISON_ALWAYS;
+	default:										return D3D11_COMPARISON_ALWAYS;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static D3D11_CULL_MODE ToDXCullMode( eCullMode mode )
+{
+	switch( mode )
+	{
+	case eCullMode::CULL_NONE:		return D3D11_CULL_NONE;
+	case eCullMode::CULL_FRONT:		return D3D11_CULL_FRONT;
+	case eCullMode::CULL_BACK:		return D3D11_CULL_BACK;
+	default:						return D3D11_CULL_NONE;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static D3D11_FILL_MODE ToDXFillMode( eFillMode mode )
+{
+	switch( mode )
+	{
+	case eFillMode::FILL_WIREFRAME:	return D3D11_FILL_WIREFRAME;
+	case eFillMode::FILL_SOLID:		return D3D11_FILL_SOLID;
+	default:						return D3D11_FILL_SOLID;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static char const* GetDefaultEntryPointForStage( eShaderType type )
+{
+	switch( type )
+	{
+	case SHADER_TYPE_VERTEX: return "VertexFunction";
+	case SHADER_TYPE_FRAGMENT: return "FragmentFunction";
+	default: GUARANTEE_OR_DIE( false, "Bad stage" );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// what version of the shader language do we want to use - similar to say, C++11 vs C++14
+static char const* GetShaderModelForStage( eShaderType type )
+{
+	switch( type )
+	{
+	case SHADER_TYPE_VERTEX: return "vs_5_0";
+	case SHADER_TYPE_FRAGMENT: return "ps_5_0";
+	default: GUARANTEE_OR_DIE( false, "Unknown shader stage" );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// One layout per shader, made the first time the shader is bound with a layout
+static ID3D11InputLayout* GetOrCreateInputLayout( ID3D11Device* device, Shader* shader, buffer_attribute_t const* layout )
+{
+	if( shader->m_inputLayout )
+	{
+		return shader->m_inputLayout;
+	}
+
+	int length = 0;
+	while( layout[++length].type != BUFFER_FORMAT_NULL ) { }
+	const int NUM_ELEMENTS = length;
+	
+	std::vector<D3D11_INPUT_ELEMENT_DESC> vertexDescription;
+	vertexDescription.reserve( NUM_ELEMENTS );
+
+	for( int i = 0; i < NUM_ELEMENTS; ++i )
+	{
+		const buffer_attribute_t& attribute = layout[i];
+		D3D11_INPUT_ELEMENT_DESC vertexDesc;
+
+		vertexDesc.SemanticName				= attribute.name.c_str();
+		vertexDesc.AlignedByteOffset		= attribute.offset;
+		vertexDesc.SemanticIndex			= 0;
+		vertexDesc.InputSlot				= 0;
+		vertexDesc.InputSlotClass			= D3D11_INPUT_PER_VERTEX_DATA;
+		vertexDesc.InstanceDataStepRate		= 0;
+
+		switch( attribute.type )
+		{
+		case BUFFER_FORMAT_VEC2:				vertexDesc.Format = DXGI_FORMAT_R32G32_FLOAT;		break;
+		case BUFFER_FORMAT_VEC3:				vertexDesc.Format = DXGI_FORMAT_R32G32B32_FLOAT;	break;
+		case BUFFER_FORMAT_R8G8B8A8_UNORM :		vertexDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;		break;			
+		default: GUARANTEE_OR_DIE( false, "Unknown buffer format");
+		}
+		vertexDescription.push_back( vertexDesc );
+	}
+
+	ID3D10Blob* byteCode = shader->m_vertexStage.m_byteCode;
+	device->CreateInputLayout( 
+		&vertexDescription[0],					//*pInputElementDescs
+		NUM_ELEMENTS,
+		byteCode->GetBufferPointer(), 
+		byteCode->GetBufferSize(),
+		&shader->m_inputLayout );	
+
+	return shader->m_inputLayout;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+D3D11RenderBackend::D3D11RenderBackend( RenderContext* owner, Window* window )
+	: m_owner( owner )
+{
+	CreateDeviceAndSwapChain( window );
+	CreateDepthStencilBuffer( window );
+	CreateBlendStates();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+D3D11RenderBackend::~D3D11RenderBackend()
+{
+	delete m_backBuffer;		// releases its device texture through DestroyTexture
+	m_backBuffer = nullptr;
+	DX_SAFE_RELEASE( m_swapchain );
+
+	DX_SAFE_RELEASE( m_alphaBlendState );
+	DX_SAFE_RELEASE( m_additiveBlendState );
+	DX_SAFE_RELEASE( m_opaqueBlendState );
+
+	for( int index = 0; index < NUM_D3D11_DEPTH_STATES; ++index )
+	{
+		DX_SAFE_RELEASE( m_depthStates[index] );
+	}
+	for( int index = 0; index < NUM_D3D11_RASTER_STATES; ++index )
+	{
+		DX_SAFE_RELEASE( m_rasterStates[index] );
+	}
+	m_currentRasterState = nullptr;
+
+	DX_SAFE_RELEASE( m_context );
+	DX_SAFE_RELEASE( m_depthStencilBuffer );
+	DX_SAFE_RELEASE( m_depthStencilState );
+	DX_SAFE_RELEASE( m_depthStencilView );
+
+#if defined( D3D11_DEBUG )
+	ID3D11Debug* d3dDebug;
+	HRESULT hr = m_device->QueryInterface( __uuidof(ID3D11Debug), reinterpret_cast<void**>(&d3dDebug));
+	if( SUCCEEDED( hr ) )
+	{
+		hr = d3dDebug->ReportLiveDeviceObjects( D3D11_RLDO_DETAIL | D3D11_RLDO_IGNORE_INTERNAL );
+	}
+	DX_SAFE_RELEASE( d3dDebug );
+#endif
+
+	DX_SAFE_RELEASE( m_device );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::CreateDeviceAndSwapChain( Window* window )
+{
+	//IDXGISwapChain* pSwapChain = nullptr;
+	//IDXGISwapChain1* pSwapChain1 = nullptr;
+
+	//UINT flags = D3D11_CREATE_DEVICE_SINGLETHREADED;
+	UINT flags = 0;
+#if defined(RENDER_DEBUG)
+	flags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+	// Create D3D11 Device
+	HRESULT result;
+	result = D3D11CreateDevice( nullptr,
+		D3D_DRIVER_TYPE_HARDWARE,
+		nullptr,
+		flags,
+		nullptr,
+		0,
+		D3D11_SDK_VERSION,
+		&m_device,
+		nullptr,
+		&m_context );
+
+	GUARANTEE_OR_DIE( SUCCEEDED( result ), "Fail to D3D11 Device" );
+
+	//-------------------------------------------------------------------------------------------------------------
+	ID3D11Device* device = m_device;
+	IDXGIDevice* dxgiDevice = nullptr;
+	result = device->QueryInterface( __uuidof(dxgiDevice), (void**)&dxgiDevice );
+	IDXGIAdapter* dxgiAdapter = nullptr;
+	result = dxgiDevice->GetParent( __uuidof(IDXGIAdapter), (void**)&dxgiAdapter );
+
+	IDXGIFactory* dxgiFactory = nullptr;
+	result = dxgiAdapter->GetParent( __uuidof(IDXGIFactory), (void**)&dxgiFactory  );
+
+	// Create the swap chain
+	uint msaa = m_owner->m_msaa;
+	GUARANTEE_OR_DIE( msaa == 1 || msaa == 2 || msaa == 4 || msaa == 8 || msaa == 16, "Invalid xMSAA times!" );
+	// Check If x4 MSAA Supported?
+	result = ( device->CheckMultisampleQualityLevels( DXGI_FORMAT_R8G8B8A8_UNORM, msaa, &m_msaaQuality ) );
+	GUARANTEE_OR_DIE( m_msaaQuality > 0, Stringf( "x%dMSAA is not supported!", msaa ) );
+
+	// define the swap chain
+	DXGI_SWAP_CHAIN_DESC swapchainDesc;
+	memset( &swapchainDesc, 0, sizeof( swapchainDesc ) );
+	swapchainDesc.BufferUsage  = DXGI_USAGE_RENDER_TARGET_OUTPUT | DXGI_USAGE_BACK_BUFFER;
+	swapchainDesc.BufferCount = 2;
+	swapchainDesc.Flags = 0;
+	HWND hwnd = (HWND)window->m_hwnd;
+	swapchainDesc.OutputWindow = hwnd; // HWND for the window to be used
+#if defined( MSAA_ENABLED )
+	swapchainDesc.SampleDesc.Count = msaa;
+	swapchainDesc.SampleDesc.Quality = m_msaaQuality - 1;
+	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD; 
+#else
+	swapchainDesc.SampleDesc.Count = 1;
+	swapchainDesc.SampleDesc.Quality = 0;
+	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; // on swap, the old buffer is discarded
+#endif
+	swapchainDesc.Windowed = TRUE;
+	swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	swapchainDesc.BufferDesc.Width = window->GetClientWidth();
+	swapchainDesc.BufferDesc.Height = window->GetClientHeight();
+	result = dxgiFactory->CreateSwapChain( device, &swapchainDesc, &m_swapchain );
+
+	dxgiDevice->Release();
+	dxgiAdapter->Release();
+	dxgiFactory->Release();
+
+	GUARANTEE_OR_DIE( SUCCEEDED( result ), "Fail to creating Render Context" );
+
+	ID3D11Texture2D* backBufferHandle = nullptr;
+	m_swapchain->GetBuffer( 0, __uuidof(ID3D11Texture2D), (void**)&backBufferHandle );
+
+	D3D11_TEXTURE2D_DESC backBufferDesc;
+	backBufferHandle->GetDesc( &backBufferDesc );
+	m_backBuffer = new Texture( "", m_owner, IntVec2( backBufferDesc.Width, backBufferDesc.Height ), backBufferHandle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool D3D11RenderBackend::CreateDepthStencilBuffer( Window* window )
+{
+	ID3D11Device* device = m_device;
+	HRESULT result;
+	D3D11_TEXTURE2D_DESC depthBufferDesc;
+
+	ZeroMemory( &depthBufferDesc, sizeof( depthBufferDesc ) );
+
+	// Set up the description of the depth buffer.
+	
+#ifdef VR_ENABLED
+	//m_recommendedSize = g_gameConfigBlackboard.GetValue( "RecommendedRenderTargetSize", Vec2::ZERO );
+	depthBufferDesc.Width = (UINT)m_owner->m_recommendedSize.x;
+	depthBufferDesc.Height = (UINT)m_owner->m_recommendedSize.y;
+#else
+	depthBufferDesc.Width = window->GetClientWidth();
+	depthBufferDesc.Height = window->GetClientHeight();
+#endif
+	depthBufferDesc.MipLevels = 1;
+	depthBufferDesc.ArraySize = 1;
+	depthBufferDesc.Format = DXGI_FORMAT_D32_FLOAT;
+#if defined( MSAA_ENABLED )
+	depthBufferDesc.SampleDesc.Count = m_owner->m_msaa;
+	depthBufferDesc.SampleDesc.Quality = m_msaaQuality - 1;
+#else
+	depthBufferDesc.SampleDesc.Count = 1;
+	depthBufferDesc.SampleDesc.Quality = 0;
+#endif
+	depthBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	depthBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+	depthBufferDesc.CPUAccessFlags = 0;
+	depthBufferDesc.MiscFlags = 0;
+
+	// Create the texture for the depth buffer using the filled out description.
+	result = device->CreateTexture2D( &depthBufferDesc, NULL, &m_depthStencilBuffer );
+	if( FAILED( result ) )
+	{
+		return false;
+	}
+
+	D3D11_DEPTH_STENCIL_DESC depthStencilDesc;
+	// Initialize the description of the stencil state.
+	ZeroMemory( &depthStencilDesc, sizeof( depthStencilDesc ) );
+
+	// Set up the description of the stencil state.
+	depthStencilDesc.DepthEnable = true;
+	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+	depthStencilDesc.DepthFunc = D3D11_COMPARISON_LESS;
+
+	depthStencilDesc.StencilEnable = true;
+	depthStencilDesc.StencilReadMask = 0xFF;
+	depthStencilDesc.StencilWriteMask = 0xFF;
+
+	// Stencil operations if pixel is front-facing.
+	depthStencilDesc.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_INCR;
+	depthStencilDesc.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+
+	// Stencil operations if pixel is back-facing.
+	depthStencilDesc.BackFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.BackFace.StencilDepthFailOp = D3D11_STENCIL_OP_DECR;
+	depthStencilDesc.BackFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
+	depthStencilDesc.BackFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+
+	// Create the depth stencil state.
+	result = device->CreateDepthStencilState( &depthStencilDesc, &m_depthStencilState );
+	if( FAILED( result ) )
+	{
+		return false;
+	}
+
+	// Bind the depth-stencil state.
+	m_context->OMSetDepthStencilState( m_depthStencilState, 1 );
+
+
+	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
+	// Initialize the depth stencil view.
+	ZeroMemory( &depthStencilViewDesc, sizeof( depthStencilViewDesc ) );
+
+	// Set up the depth stencil view description.
+	depthStencilViewDesc.Format = DXGI_FORMAT_D32_FLOAT;
+#if defined( MSAA_ENABLED )
+	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DMS;
+#else
+	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+#endif
+	depthStencilViewDesc.Texture2D.MipSlice = 0;
+
+	// Create the depth stencil view.
+	result = device->CreateDepthStencilView( m_depthStencilBuffer, &depthStencilViewDesc, &m_depthStencilView );
+	if( FAILED( result ) )
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::CreateBlendStates()
+{
+	ID3D11Device* device = m_device;
+
+	D3D11_BLEND_DESC alphaDesc;
+	alphaDesc.AlphaToCoverageEnable = false;
+	alphaDesc.IndependentBlendEnable = false;
+	alphaDesc.RenderTarget[0].BlendEnable = true;
+	alphaDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	alphaDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+	alphaDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+
+	alphaDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	alphaDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+	alphaDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+	alphaDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+	device->CreateBlendState( &alphaDesc, &m_alphaBlendState );
+
+
+
+	D3D11_BLEND_DESC additiveDesc;
+	additiveDesc.AlphaToCoverageEnable = false;
+	additiveDesc.IndependentBlendEnable = false;
+	additiveDesc.RenderTarget[0].BlendEnable = true;
+	additiveDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	additiveDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+	additiveDesc.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
+
+	additiveDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	additiveDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+	additiveDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+	additiveDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+	device->CreateBlendState( &additiveDesc, &m_additiveBlendState );
+
+
+
+	D3D11_BLEND_DESC opaqueDesc;
+	opaqueDesc.AlphaToCoverageEnable = false;
+	opaqueDesc.IndependentBlendEnable = false;
+	opaqueDesc.RenderTarget[0].BlendEnable = false;
+	opaqueDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	opaqueDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+	opaqueDesc.RenderTarget[0].DestBlend = D3D11_BLEND_ZERO;
+
+	opaqueDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	opaqueDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+	opaqueDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+	opaqueDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+	device->CreateBlendState( &opaqueDesc, &m_opaqueBlendState );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BeginFrame()
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::EndFrame()
+{
+	m_swapchain->Present( 0, 0 );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BeginCamera( Camera const& camera )
+{
+	ID3D11DeviceContext* context = m_context;
+
+#if defined(RENDER_DEBUG)
+	context->ClearState();
+#endif
+
+	Texture* colorTarget = camera.GetColorTarget();
+	if( !colorTarget )
+	{
+		colorTarget = m_backBuffer;
+	}
+
+	std::vector<ID3D11RenderTargetView*> rtvs;
+	int rtvCount = camera.GetColorTargetCount();
+	rtvs.resize( rtvCount );
+
+	if( rtvCount == 0 )
+	{
+		TextureView* view = colorTarget->GetRenderTargetView();
+		ID3D11RenderTargetView* rtv = view->GetAsRTV();
+		context->OMSetRenderTargets( 1, &rtv, nullptr );
+	}
+	else
+	{
+		for( int i = 0; i < rtvCount; ++i )
+		{
+			rtvs[i] = nullptr;
+
+			Texture* theColorTarget = camera.GetColorTarget( i );
+			if( theColorTarget != nullptr )
+			{
+				TextureView* rtv = theColorTarget->GetRenderTargetView();
+				rtvs[i] = rtv->GetAsRTV();
+			}
+		}
+	}
+
+	IntVec2 outputSize = colorTarget->GetTexelSize();
+
+	if( camera.m_canClearDepthBuffer )
+	{
+		context->OMSetRenderTargets( rtvCount, rtvs.data(), m_depthStencilView );
+	}
+	else
+	{
+		context->OMSetRenderTargets( rtvCount, rtvs.data(), nullptr );
+	}
+
+	D3D11_VIEWPORT viewport;
+	viewport.TopLeftX = 0;
+	viewport.TopLeftY = 0;
+#ifdef VR_ENABLED
+	viewport.Width = m_owner->m_recommendedSize.x;
+	viewport.Height = m_owner->m_recommendedSize.y;
+#else
+	viewport.Width = (float)outputSize.x;
+	viewport.Height = (float)outputSize.y;
+#endif
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+
+	context->RSSetViewports( 1, &viewport );
+
+	if( eCameraClearBit::CLEAR_COLOR_BIT & camera.m_clearMode )
+	{
+		Rgba8 clearColor = camera.GetClearColor();
+		float clearFloats[4];
+		clearFloats[0] = (float)clearColor.r / 255.f;
+		clearFloats[1] = (float)clearColor.g / 255.f;
+		clearFloats[2] = (float)clearColor.b / 255.f;
+		clearFloats[3] = (float)clearColor.a / 255.f;
+
+		for( int i = 0; i < rtvCount; ++i )
+		{
+			if( rtvs[i] != nullptr )
+			{
+				context->ClearRenderTargetView( rtvs[i], clearFloats );
+			}
+		}
+	}
+
+	// Clear Depth only the bool on camera is true
+	if( camera.m_canClearDepthBuffer )
+	{
+		context->ClearDepthStencilView( m_depthStencilView, D3D11_CLEAR_DEPTH|D3D11_CLEAR_STENCIL, 1.0f, 0 );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::ClearScreen( Rgba8 const& clearColor )
+{
+	float clearFloats[4];
+	clearFloats[0] = (float) clearColor.r / 255.f;
+	clearFloats[1] = (float) clearColor.g / 255.f;
+	clearFloats[2] = (float) clearColor.b / 255.f;
+	clearFloats[3] = (float) clearColor.a / 255.f;
+
+	TextureView* backbuffer_rtv = m_backBuffer->GetRenderTargetView();
+
+	ID3D11RenderTargetView* rtv = backbuffer_rtv->GetAsRTV();
+	m_context->ClearRenderTargetView( rtv, clearFloats );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::ClearDepth( Texture* depthStencilTexture, float depth, uint stencil )
+{
+	TextureView* view = depthStencilTexture->GetOrCreateShaderResourceView();
+	ID3D11DepthStencilView* dsv = view->GetAsDSV();
+	m_context->ClearDepthStencilView( dsv, D3D11_CLEAR_DEPTH, depth, (UINT8)stencil ); 
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+Texture* D3D11RenderBackend::CreateTexture( char const* filePath, IntVec2 const& texelSize, unsigned char const* rgbaTexels )
+{
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = texelSize.x;
+	desc.Height = texelSize.y;
+	desc.MipLevels = 0;		// We want all the mipmap levels down to 1x1
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;	// GPU needs to be able to write back to this texture, the texture needs to be final output of the pipeline
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+	ID3D11Texture2D* texHandle = nullptr;
+	m_device->CreateTexture2D( &desc, nullptr, &texHandle );
+	GUARANTEE_OR_DIE( texHandle, "RenderContext::CreateTextureFromFile failed to setup texHandle" );
+
+	// write image data into mip level
+	if( rgbaTexels != nullptr )
+	{
+		m_context->UpdateSubresource( texHandle, 0u, nullptr, rgbaTexels, texelSize.x * 4, 0u );
+	}
+
+	return new Texture( filePath, m_owner, texelSize, texHandle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+Texture* D3D11RenderBackend::CreateRenderTarget( IntVec2 const& texelSize )
+{
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = texelSize.x;
+	desc.Height = texelSize.y;
+	desc.MipLevels = 0;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+	
+	ID3D11Texture2D* texHandle = nullptr;
+	HRESULT hResult = m_device->CreateTexture2D( &desc, nullptr, &texHandle );
+	if( FAILED( hResult ) )
+	{
+		ERROR_AND_DIE( "Failed on CreateRenderTarget!" );
+	}
+
+	return new Texture( "", m_owner, texelSize, texHandle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+Texture* D3D11RenderBackend::GetBackBuffer()
+{
+	return m_backBuffer;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::DestroyTexture( Texture* texture )
+{
+	ID3D11Texture2D* handle = texture->GetHandle();
+	DX_SAFE_RELEASE( handle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+TextureView* D3D11RenderBackend::CreateRenderTargetView( Texture* texture )
+{
+	// no view desc: the view takes the texture's format and sample count
+	ID3D11RenderTargetView* rtv = nullptr;
+	m_device->CreateRenderTargetView( texture->GetHandle(), nullptr, &rtv );
+	if( rtv == nullptr )
+	{
+		return nullptr;
+	}
+
+	TextureView* view = new TextureView();
+	view->m_rtv = rtv;
+	return view;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+TextureView* D3D11RenderBackend::CreateShaderResourceView( Texture* texture )
+{
+	D3D11_TEXTURE2D_DESC texDesc;
+	texture->GetHandle()->GetDesc( &texDesc );
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+	srvDesc.Format = texDesc.Format;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = -1;	// Use all the MIP levels
+
+	TextureView* view = new TextureView();
+	HRESULT hr = m_device->CreateShaderResourceView( texture->GetHandle(), &srvDesc, &view->m_srv );
+	GUARANTEE_OR_DIE( SUCCEEDED( hr ), "Failed to create shader resources view!" );
+
+	m_context->GenerateMips( view->m_srv );
+
+	return view;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::DestroyTextureView( TextureView* view )
+{
+	if( view != nullptr )
+	{
+		DX_SAFE_RELEASE( view->m_handle );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::CopyTexture( Texture* dst, Texture* src )
+{
+	m_context->CopyResource( dst->GetHandle(), src->GetHandle() );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::ResolveTexture( Texture* dst, Texture* src )
+{
+	m_context->ResolveSubresource( dst->GetHandle(), D3D11CalcSubresource( 0, 0, 1 ), src->GetHandle(), D3D11CalcSubresource( 0, 0, 1 ), DXGI_FORMAT_R8G8B8A8_UNORM );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool D3D11RenderBackend::CreateShaderStage( ShaderStage& stage, char const* filePath, void const* source, size_t sourceByteSize, eShaderType type )
+{
+	// HLSL - High Level Shading Language
+	// HLSL -> ByteCode
+	// Link ByteCode -> Device Assembly( What we need to get to ) - Device specific
+
+	char const* entrypoint = GetDefaultEntryPointForStage( type );
+	char const* shaderModel = GetShaderModelForStage( type );
+
+	DWORD compileFlags = 0U;
+	#if defined(DEBUG_SHADERS)
+		compileFlags |= D3DCOMPILE_DEBUG;
+		compileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+		compileFlags |= D3DCOMPILE_WARNINGS_ARE_ERRORS;   // cause, FIX YOUR WARNINGS
+		compileFlags |= D3D11_CREATE_DEVICE_DEBUG;
+	#else 
+		// compile_flags |= D3DCOMPILE_SKIP_VALIDATION;       // Only do this if you know for a fact this shader works with this device (so second run through of a game)
+		compileFlags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;   // Yay, fastness (default is level 1)
+	#endif
+
+	ID3DBlob* byteCode = nullptr;
+	ID3DBlob* errors = nullptr;
+
+	HRESULT hr = ::D3DCompile( source,
+		sourceByteSize,                     // plain text source code
+		filePath,                           // optional, used for error messages (If you HLSL has includes - it will not use the includes names, it will use this name)
+		nullptr,                            // pre-compiler defines - used more for compiling multiple versions of a single shader (different quality specs, or shaders that are mostly the same outside some constants)
+		D3D_COMPILE_STANDARD_FILE_INCLUDE,  // include rules - this allows #includes in the shader to work relative to the src_file path or my current working directly
+		entrypoint,                         // Entry Point for this shader
+		shaderModel,                        // Compile Target (MSDN - "Specifying Compiler Targets")
+		compileFlags,                       // Flags that control compilation
+		0,                                  // Effect Flags (we will not be doing Effect Files)
+		&byteCode,                          // [OUT] ID3DBlob (buffer) that will store the byte code.
+		&errors );                          // [OUT] ID3DBlob (buffer) that will store error information
+
+	if( FAILED( hr ) ) 
+	{
+ 		if( errors != nullptr )
+ 		{
+ 			char* error_string = (char*)errors->GetBufferPointer();
+ 			DebuggerPrintf( "Failed to compile [%s].  Compiler gave the following output;\n%s",
+ 				filePath,
+ 				error_string );
+ 		
+ 			DEBUGBREAK();
+ 		}
+
+		byteCode = nullptr;
+		errors = nullptr;
+
+		hr = ::D3DCompile( &errorShaderString[0],
+			errorShaderString.size(),         // plain text source code
+			nullptr,								// optional, used for error messages (If you HLSL has includes - it will not use the includes names, it will use this name)
+			nullptr,                            // pre-compiler defines - used more for compiling multiple versions of a single shader (different quality specs, or shaders that are mostly the same outside some constants)
+			D3D_COMPILE_STANDARD_FILE_INCLUDE,  // include rules - this allows #includes in the shader to work relative to the src_file path or my current working directly
+			entrypoint,							// Entry Point for this shader
+			shaderModel,						// Compile Target (MSDN - "Specifying Compiler Targets")
+			compileFlags,                       // Flags that control compilation
+			0,                                  // Effect Flags (we will not be doing Effect Files)
+			&byteCode,                          // [OUT] ID3DBlob (buffer) that will store the byte code.
+			&errors );                          // [OUT] ID3DBlob (buffer) that will store error information
+	}
+
+	void const* byteCodePtr = byteCode->GetBufferPointer();
+	size_t byteCodeSize = byteCode->GetBufferSize();
+	switch( type )
+	{
+	case SHADER_TYPE_VERTEX:
+	{
+		hr = m_device->CreateVertexShader( byteCodePtr, byteCodeSize, nullptr, &stage.m_vs );
+		GUARANTEE_OR_DIE( SUCCEEDED(hr), "Failed to link shader stage" );
+	} break;
+
+	case SHADER_TYPE_FRAGMENT:
+	{
+		hr = m_device->CreatePixelShader( byteCodePtr, byteCodeSize, nullptr, &stage.m_fs );
+		GUARANTEE_OR_DIE( SUCCEEDED(hr), "Failed to link shader stage" );
+	} break;
+
+	default: GUARANTEE_OR_DIE( false, "Unimplemented stage" ); break;
+	}
+	
+	DX_SAFE_RELEASE( errors );
+
+	// the vertex stage keeps its byte code for the input layout
+	if( type == SHADER_TYPE_VERTEX )
+	{
+		stage.m_byteCode = byteCode;
+	}
+	else
+	{
+		DX_SAFE_RELEASE( byteCode );
+		stage.m_byteCode = nullptr;
+	}
+
+	stage.m_type = type;
+
+	return stage.IsValid();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::DestroyShader( Shader& shader )
+{
+	DX_SAFE_RELEASE( shader.m_inputLayout );
+
+	DX_SAFE_RELEASE( shader.m_vertexStage.m_byteCode );
+	DX_SAFE_RELEASE( shader.m_vertexStage.m_handle );
+	DX_SAFE_RELEASE( shader.m_fragmentStage.m_byteCode );
+	DX_SAFE_RELEASE( shader.m_fragmentStage.m_handle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::CreateSampler( Sampler& sampler, eSamplerType type )
+{
+	D3D11_SAMPLER_DESC desc;
+
+	switch( type )
+	{
+	case SAMPLER_LINEAR:		desc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;			break;
+	case SAMPLER_POINT:			desc.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;			break;
+	case SAMPLER_BILINEAR:		desc.Filter = D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT;	break;
+	case SAMPLER_ANISOTROPIC:	desc.Filter = D3D11_FILTER_ANISOTROPIC;					break;
+	default:					ERROR_AND_DIE( "Unknown sampler type!" );				break;
+	}
+
+	desc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+	desc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+	desc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+
+	if( type == SAMPLER_ANISOTROPIC )
+	{
+		desc.MaxAnisotropy = D3D11_REQ_MAXANISOTROPY;
+	}
+	else
+	{
+		desc.MaxAnisotropy = 0;
+	}
+
+	desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+
+	desc.MipLODBias = 0.f;
+	desc.MinLOD = 0.f;
+	desc.MaxLOD = D3D11_FLOAT32_MAX;
+
+	HRESULT hr = m_device->CreateSamplerState( &desc, &sampler.m_handle );
+	GUARANTEE_OR_DIE( SUCCEEDED( hr ), "Failed to create sampler state!" );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::DestroySampler( Sampler& sampler )
+{
+	DX_SAFE_RELEASE( sampler.m_handle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool D3D11RenderBackend::CreateBuffer( RenderBuffer& buffer, size_t byteSize, size_t elementByteSize )
+{
+	D3D11_BUFFER_DESC desc;
+	desc.ByteWidth = (UINT)byteSize;
+	desc.Usage = ToDXMemoryUsage( buffer.m_memoryHint );
+	desc.BindFlags = ToDXUsage( buffer.m_usage );
+	desc.CPUAccessFlags = 0;
+
+	if( buffer.m_memoryHint == MEMORY_HINT_DYNAMIC )
+	{
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	}
+	else if( buffer.m_memoryHint == MEMORY_HINT_STAGING )
+	{
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE | D3D11_CPU_ACCESS_READ;
+	}
+
+	desc.MiscFlags = 0;
+	desc.StructureByteStride = (UINT)elementByteSize;
+
+	bool isStructured = ( buffer.m_usage & STRUCTURED_BUFFER_BIT ) != 0;
+	if( isStructured )
+	{
+		desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	}
+	m_device->CreateBuffer( &desc, nullptr, &buffer.m_handle );
+
+	if( isStructured && buffer.m_handle != nullptr )
+	{
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+		memset( &srvDesc, 0, sizeof( srvDesc ) );
+		srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+		srvDesc.Buffer.FirstElement = 0;
+		srvDesc.Buffer.NumElements = (UINT)( byteSize / elementByteSize );
+		m_device->CreateShaderResourceView( buffer.m_handle, &srvDesc, &buffer.m_srv );
+		if( buffer.m_srv == nullptr )
+		{
+			DX_SAFE_RELEASE( buffer.m_handle );
+		}
+	}
+
+	return( buffer.m_handle != nullptr );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::DestroyBuffer( RenderBuffer& buffer )
+{
+	DX_SAFE_RELEASE( buffer.m_srv );
+	DX_SAFE_RELEASE( buffer.m_handle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool D3D11RenderBackend::UpdateBuffer( RenderBuffer& buffer, void const* data, size_t byteSize )
+{
+	ID3D11DeviceContext* ctx = m_context;
+
+	if( buffer.m_memoryHint == MEMORY_HINT_DYNAMIC )
+	{
+		D3D11_MAPPED_SUBRESOURCE mapped;
+
+		// CPU -> GPU memory copy
+		HRESULT result = ctx->Map( buffer.m_handle, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped );
+		if( FAILED( result ) )
+		{
+			return false;
+		}
+		memcpy( mapped.pData, data, byteSize );
+		ctx->Unmap( buffer.m_handle, 0 );
+	}
+	else
+	{ // if this is MEMORY_HINT_GPU
+		ctx->UpdateSubresource( buffer.m_handle, 0, nullptr, data, 0, 0 );
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool D3D11RenderBackend::UpdateBufferRange( RenderBuffer& buffer, void const* data, size_t byteOffset, size_t byteSize, bool discard )
+{
+	ID3D11DeviceContext* ctx = m_context;
+	D3D11_MAPPED_SUBRESOURCE mapped;
+
+	// NO_OVERWRITE promises the driver we leave alone anything a queued draw reads, so it doesn't have to stall or copy
+	HRESULT result = ctx->Map( buffer.m_handle, 0, discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped );
+	if( FAILED( result ) )
+	{
+		return false;
+	}
+	memcpy( (unsigned char*)mapped.pData + byteOffset, data, byteSize );
+	ctx->Unmap( buffer.m_handle, 0 );
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindShader( Shader* shader )
+{
+	ID3D11DeviceContext* context = m_context;
+	context->VSSetShader( shader->m_vertexStage.m_vs, nullptr, 0 );
+	context->RSSetState( m_currentRasterState );
+	context->PSSetShader( shader->m_fragmentStage.m_fs, nullptr, 0 );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindInputLayout( Shader* shader, buffer_attribute_t const* layout )
+{
+	ID3D11InputLayout* inputLayout = GetOrCreateInputLayout( m_device, shader, layout );
+	m_context->IASetInputLayout( inputLayout );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindVertexBuffer( VertexBuffer* vbo )
+{
+	ID3D11Buffer* vboHandle = vbo->m_handle;
+	UINT stride = vbo->GetElementStride(); // how far from one vertex to next
+	UINT offset = 0;
+
+	m_context->IASetVertexBuffers( 0, 1, &vboHandle, &stride, &offset );
+	m_context->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindIndexBuffer( IndexBuffer* ibo )
+{
+	ID3D11Buffer* handle = nullptr;
+	DXGI_FORMAT format = DXGI_FORMAT_R32_UINT;
+
+	if( ibo != nullptr )
+	{
+		handle = ibo->m_handle;
+		format = ibo->m_elementByteSize == sizeof( uint16_t ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	}
+
+	m_context->IASetIndexBuffer( handle, format, 0 );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindUniformBuffer( uint slot, RenderBuffer* ubo )
+{
+	ID3D11Buffer* uboHandle = ubo->m_handle;
+
+	m_context->VSSetConstantBuffers( slot, 1, &uboHandle );
+	m_context->PSSetConstantBuffers( slot, 1, &uboHandle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindStructuredBuffer( uint slot, RenderBuffer* buffer )
+{
+	ID3D11ShaderResourceView* srvHandle = buffer->m_srv;
+	m_context->PSSetShaderResources( slot, 1, &srvHandle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindTexture( uint slot, Texture* texture )
+{
+	TextureView* shaderResourceView = texture->GetOrCreateShaderResourceView();
+	ID3D11ShaderResourceView* srvHandle = shaderResourceView->GetAsSRV();
+	m_context->PSSetShaderResources( slot, 1, &srvHandle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::BindSampler( uint slot, Sampler* sampler )
+{
+	ID3D11SamplerState* samplerHandle = sampler->GetHandle();
+	m_context->PSSetSamplers( slot, 1, &samplerHandle );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::SetBlendMode( BlendMode blendMode )
+{
+	float const zeros[] = { 0.f, 0.f, 0.f, 0.f };
+	ID3D11DeviceContext* context = m_context;
+
+	switch( blendMode )
+	{
+	case BlendMode::ALPHA:		context->OMSetBlendState( m_alphaBlendState, zeros, ~(UINT)0 );		break;
+	case BlendMode::ADDITIVE:	context->OMSetBlendState( m_additiveBlendState, zeros, ~(UINT)0 );	break;
+	case BlendMode::_OPAQUE:	context->OMSetBlendState( m_opaqueBlendState, zeros, ~(UINT)0 );		break;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::SetDepthState( eCompareOp op, bool write )
+{
+	int stateIdx = (int)op * 2 + ( write ? 1 : 0 );
+	GUARANTEE_OR_DIE( stateIdx >= 0 && stateIdx < NUM_D3D11_DEPTH_STATES, "Unknown depth compare op!" );
+
+	ID3D11DepthStencilState*& state = m_depthStates[stateIdx];
+	if( state == nullptr )
+	{
+		D3D11_DEPTH_STENCIL_DESC desc;
+		memset( &desc, 0, sizeof( desc ) );
+
+		desc.DepthEnable = TRUE;
+		desc.DepthWriteMask = write ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+		desc.DepthFunc = ToDXCompareFunc( op );
+
+		m_device->CreateDepthStencilState( &desc, &state );
+	}
+
+	m_context->OMSetDepthStencilState( state, 0 );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::SetRasterState( eCullMode cullMode, eFillMode fillMode, bool isFrontCCW )
+{
+	int stateIdx = ( (int)cullMode * 2 + (int)fillMode ) * 2 + ( isFrontCCW ? 1 : 0 );
+	GUARANTEE_OR_DIE( stateIdx >= 0 && stateIdx < NUM_D3D11_RASTER_STATES, "Unknown rasterizer state!" );
+
+	ID3D11RasterizerState*& state = m_rasterStates[stateIdx];
+	if( state == nullptr )
+	{
+		D3D11_RASTERIZER_DESC desc;
+
+		desc.FillMode = ToDXFillMode( fillMode );
+		desc.CullMode = ToDXCullMode( cullMode );
+		desc.FrontCounterClockwise = isFrontCCW ? TRUE : FALSE;
+		desc.DepthBias = 0U;
+		desc.DepthBiasClamp = 0.0f;
+		desc.SlopeScaledDepthBias = 0.0f;
+		desc.DepthClipEnable = TRUE;
+		desc.ScissorEnable = FALSE;
+#if defined ( MSAA_ENABLED )
+		desc.MultisampleEnable = TRUE;
+		desc.AntialiasedLineEnable = TRUE;
+#else
+		desc.MultisampleEnable = FALSE;
+		desc.AntialiasedLineEnable = FALSE;
+#endif
+
+		m_device->CreateRasterizerState( &desc, &state );
+	}
+
+	m_currentRasterState = state;
+	m_context->RSSetState( state );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::Draw( int numVertexes, int vertexOffset )
+{
+	m_context->Draw( numVertexes, vertexOffset );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::DrawIndexed( int indexCount, int indexOffset, int vertexOffset )
+{
+	m_context->DrawIndexed( indexCount, indexOffset, vertexOffset );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void D3D11RenderBackend::DrawFullScreenTriangle()
+{
+	m_context->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+	m_context->Draw( 3, 0 );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+RenderBackend* CreatePlatformRenderBackend( RenderContext* owner, Window* window )
+{
+	return new D3D11RenderBackend( owner, window );
+}
+
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+#include "Engine/Renderer/RenderBackend.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class RenderContext;
+class Window;
+struct ID3D11BlendState;
+struct ID3D11DepthStencilState;
+struct ID3D11DepthStencilView;
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+struct ID3D11RasterizerState;
+struct ID3D11Texture2D;
+struct IDXGISwapChain;
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+
+constexpr int NUM_D3D11_DEPTH_STATES = 8 * 2;			// eCompareOp x write
+constexpr int NUM_D3D11_RASTER_STATES = 3 * 2 * 2;		// eCullMode x eFillMode x winding
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Owns the device, its immediate context, the swap chain and the depth buffer: creates them on construction and
+// releases them on destruction. Everything else made on the device (textures, views, shader stages, input layouts,
+// samplers, buffers) is made and released here too, with the handle kept on the engine object. Blend, depth and raster
+// states are created once and reused instead of being re-created on every change.
+// Made by CreatePlatformRenderBackend; the .cpp builds on Windows only.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class D3D11RenderBackend : public RenderBackend
+{
+public:
+	D3D11RenderBackend( RenderContext* owner, Window* window );
+	virtual ~D3D11RenderBackend();
+
+	virtual char const*	GetName() const override		{ return "d3d11"; }
+	virtual bool		IsHeadless() const override		{ return false; }
+
+	virtual void	BeginFrame() override;
+	virtual void	EndFrame() override;
+	virtual void	BeginCamera( Camera const& camera ) override;
+	virtual void	ClearScreen( Rgba8 const& clearColor ) override;
+	virtual void	ClearDepth( Texture* depthStencilTexture, float depth, uint stencil ) override;
+
+	virtual Texture*		GetBackBuffer() override;
+	virtual Texture*		CreateTexture( char const* filePath, IntVec2 const& texelSize, unsigned char const* rgbaTexels ) override;
+	virtual Texture*		CreateRenderTarget( IntVec2 const& texelSize ) override;
+	virtual void			DestroyTexture( Texture* texture ) override;
+	virtual TextureView*	CreateRenderTargetView( Texture* texture ) override;
+	virtual TextureView*	CreateShaderResourceView( Texture* texture ) override;
+	virtual void			DestroyTextureView( TextureView* view ) override;
+	virtual void			CopyTexture( Texture* dst, Texture* src ) override;
+	virtual void			ResolveTexture( Texture* dst, Texture* src ) override;
+
+	virtual bool	CreateShaderStage( ShaderStage& stage, char const* filePath, void const* source, size_t sourceByteSize, eShaderType type ) override;
+	virtual void	DestroyShader( Shader& shader ) override;
+
+	virtual void	CreateSampler( Sampler& sampler, eSamplerType type ) override;
+	virtual void	DestroySampler( Sampler& sampler ) override;
+
+	virtual bool	CreateBuffer( RenderBuffer& buffer, size_t byteSize, size_t elementByteSize ) override;
+	virtual void	DestroyBuffer( RenderBuffer& buffer ) override;
+	virtual bool	UpdateBuffer( RenderBuffer& buffer, void const* data, size_t byteSize ) override;
+	virtual bool	UpdateBufferRange( RenderBuffer& buffer, void const* data, size_t byteOffset, size_t byteSize, bool discard ) override;
+
+	virtual void	BindShader( Shader* shader ) override;
+	virtual void	BindInputLayout( Shader* shader, buffer_attribute_t const* layout ) override;
+	virtual void	BindVertexBuffer( VertexBuffer* vbo ) override;
+	virtual void	BindIndexBuffer( IndexBuffer* ibo ) override;
+	virtual void	BindUniformBuffer( uint slot, RenderBuffer* ubo ) override;
+	virtual void	BindStructuredBuffer( uint slot, RenderBuffer* buffer ) override;
+	virtual void	BindTexture( uint slot, Texture* texture ) override;
+	virtual void	BindSampler( uint slot, Sampler* sampler ) override;
+
+	virtual void	SetBlendMode( BlendMode blendMode ) override;
+	virtual void	SetDepthState( eCompareOp op, bool write ) override;
+	virtual void	SetRasterState( eCullMode cullMode, eFillMode fillMode, bool isFrontCCW ) override;
+
+	virtual void	Draw( int numVertexes, int vertexOffset ) override;
+	virtual void	DrawIndexed( int indexCount, int indexOffset, int vertexOffset ) override;
+	virtual void	DrawFullScreenTriangle() override;
+
+private:
+	void	CreateDeviceAndSwapChain( Window* window );
+	bool	CreateDepthStencilBuffer( Window* window );
+	void	CreateBlendStates();
+
+private:
+	RenderContext*				m_owner = nullptr;
+
+	ID3D11Device*				m_device = nullptr;
+	ID3D11DeviceContext*		m_context = nullptr;		// immediate context
+	IDXGISwapChain*				m_swapchain = nullptr;
+	Texture*					m_backBuffer = nullptr;
+	uint						m_msaaQuality = 1;			// quality levels the device has for the owner's MSAA count
+
+	ID3D11Texture2D*			m_depthStencilBuffer = nullptr;
+	ID3D11DepthStencilState*	m_depthStencilState = nullptr;
+	ID3D11DepthStencilView*		m_depthStencilView = nullptr;
+
+	ID3D11BlendState*			m_alphaBlendState = nullptr;
+	ID3D11BlendState*			m_additiveBlendState = nullptr;
+	ID3D11BlendState*			m_opaqueBlendState = nullptr;
+	ID3D11DepthStencilState*	m_depthStates[NUM_D3D11_DEPTH_STATES] = {};
+	ID3D11RasterizerState*		m_rasterStates[NUM_D3D11_RASTER_STATES] = {};
+	ID3D11RasterizerState*		m_currentRasterState = nullptr;		// BindShader re-applies it, as it always has
+};
@@ -1,28 +1,116 @@
 #include "Engine/Renderer/DebugRender.hpp"
-#include "Engine/Renderer/QuadDebugObject.hpp"
-#include "Engine/Renderer/SphereDebugObject.hpp"
-#include "Engine/Renderer/LineDebugObject.hpp"
-#include "Engine/Renderer/ArrowDebugObject.hpp"
-#include "Engine/Renderer/TextDebugObject.hpp"
-#include "Engine/Renderer/BillboardTextDebugObject.hpp"
-#include "Engine/Renderer/BasisDebugObject.hpp"
-#include "Engine/Renderer/WireBoundDebugObject.hpp"
-#include "Engine/Renderer/MeshDebugObject.hpp"
-#include "Engine/Renderer/ScreenDebugObject_Point.hpp"
-#include "Engine/Renderer/ScreenDebugObject_Line.hpp"
-#include "Engine/Renderer/ScreenDebugObject_Quad.hpp"
-#include "Engine/Renderer/ScreenDebugObject_Text.hpp"
-#include "Engine/Renderer/ScreenDebugObject_Basis.hpp"
-#include "Engine/Renderer/ConeDebugObject.hpp"
 #include "Engine/Renderer/MeshUtils.hpp"
 #include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/SimpleTriangleFont.hpp"
 #include "Engine/Core/Clock.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/MatrixUtils.hpp"
+#include <utility>
 
 
-DebugRender* g_theDebugRenderSystem = nullptr; 
-extern RenderContext* g_theRenderer; 
+DebugRender* g_theDebugRenderSystem = nullptr;
+extern RenderContext* g_theRenderer;
+
+//----------------------------------------------------------------------------------------------------------------------------
+static Rgba8 InterpolateColor( Rgba8 const& start, Rgba8 const& end, float fractionOfEnd )
+{
+	return Rgba8( (unsigned char)Interpolate( (float)start.r, (float)end.r, fractionOfEnd ),
+		(unsigned char)Interpolate( (float)start.g, (float)end.g, fractionOfEnd ),
+		(unsigned char)Interpolate( (float)start.b, (float)end.b, fractionOfEnd ),
+		(unsigned char)Interpolate( (float)start.a, (float)end.a, fractionOfEnd ) );
+}
+
+//----------------------------------------------------------------------------------------------------------------------------
+// Translucent commands sort far to near ahead of state, so a falling depth replays them in the order they were recorded
+static float GetDrawOrderDepth( int drawIdx, int numDraws )
+{
+	return 1.f - ( (float)drawIdx + 0.5f ) / (float)numDraws;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------
+// A square prism, 36 vertices. AppendLineToVerts builds a 72-sided tube, far too heavy for thousands of raycast lines.
+static void AppendDebugLine( std::vector<Vertex_PCU>& verts, Vec3 const& start, Vec3 const& end, Rgba8 const& startColor, Rgba8 const& endColor, float thickness )
+{
+	if( ( end - start ).GetLengthSquared() == 0.f ) {
+		return;
+	}
+
+	float radius = 0.5f * thickness;
+	Mat44 lookAt = Mat44::CreateLookAtMatrix( start, end );
+	Vec3 iBasis = lookAt.GetIBasis3D().GetNormalized() * radius;
+	Vec3 jBasis = lookAt.GetJBasis3D().GetNormalized() * radius;
+	Vec3 corners[4] = { iBasis + jBasis, -iBasis + jBasis, -iBasis - jBasis, iBasis - jBasis };
+
+	for( int sideIdx = 0; sideIdx < 4; ++sideIdx ) {
+		Vec3 const& a = corners[sideIdx];
+		Vec3 const& b = corners[( sideIdx + 1 ) % 4];
+
+		verts.push_back( Vertex_PCU( start + a, startColor, Vec2::ZERO ) );
+		verts.push_back( Vertex_PCU( start + b, startColor, Vec2::ZERO ) );
+		verts.push_back( Vertex_PCU( end + b, endColor, Vec2::ZERO ) );
+
+		verts.push_back( Vertex_PCU( start + a, startColor, Vec2::ZERO ) );
+		verts.push_back( Vertex_PCU( end + b, endColor, Vec2::ZERO ) );
+		verts.push_back( Vertex_PCU( end + a, endColor, Vec2::ZERO ) );
+	}
+
+	verts.push_back( Vertex_PCU( start + corners[0], startColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( start + corners[2], startColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( start + corners[1], startColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( start + corners[0], startColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( start + corners[3], startColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( start + corners[2], startColor, Vec2::ZERO ) );
+
+	verts.push_back( Vertex_PCU( end + corners[0], endColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( end + corners[1], endColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( end + corners[2], endColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( end + corners[0], endColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( end + corners[2], endColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( end + corners[3], endColor, Vec2::ZERO ) );
+}
+
+//----------------------------------------------------------------------------------------------------------------------------
+// An octahedron, 24 vertices; points are usually impact markers and come in the same numbers as lines
+static void AppendDebugPoint( std::vector<Vertex_PCU>& verts, Vec3 const& center, float radius, Rgba8 const& color )
+{
+	Vec3 xAxis = Vec3( radius, 0.f, 0.f );
+	Vec3 yAxis = Vec3( 0.f, radius, 0.f );
+	Vec3 zAxis = Vec3( 0.f, 0.f, radius );
+
+	for( int faceIdx = 0; faceIdx < 8; ++faceIdx ) {
+		Vec3 x = ( faceIdx & 1 ) ? -xAxis : xAxis;
+		Vec3 y = ( faceIdx & 2 ) ? -yAxis : yAxis;
+		Vec3 z = ( faceIdx & 4 ) ? -zAxis : zAxis;
+
+		verts.push_back( Vertex_PCU( center + x, color, Vec2::ZERO ) );
+		verts.push_back( Vertex_PCU( center + y, color, Vec2::ZERO ) );
+		verts.push_back( Vertex_PCU( center + z, color, Vec2::ZERO ) );
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------------
+static void AppendScreenLine( std::vector<Vertex_PCU>& verts, Vec2 const& start, Vec2 const& end, Rgba8 const& startColor, Rgba8 const& endColor, float thickness )
+{
+	Vec2 fwd = end - start;
+	fwd.SetLength( 0.5f * thickness );
+	Vec2 left = fwd.GetRotated90Degrees();
+
+	Vec2 endLeft = end + fwd + left;
+	Vec2 endRight = end + fwd - left;
+	Vec2 startLeft = start - fwd + left;
+	Vec2 startRight = start - fwd - left;
+
+	verts.push_back( Vertex_PCU( startRight, startColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( endRight, endColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( endLeft, endColor, Vec2::ZERO ) );
+
+	verts.push_back( Vertex_PCU( startRight, startColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( endLeft, endColor, Vec2::ZERO ) );
+	verts.push_back( Vertex_PCU( startLeft, startColor, Vec2::ZERO ) );
+}
 
 DebugRender::DebugRender()
 {
@@ -32,18 +120,17 @@ DebugRender::DebugRender()
 void DebugRender::DebugRenderSystemStartup()
 {
 	m_clock = new Clock( Clock::GetMaster() );
+
+	m_font = m_context->CreateOrGetBitmapFont( "Data/Fonts/SquirrelFixedFont" );
+
+	m_screenCamera.IntialUBO( m_context );
+	m_screenCamera.m_canClearDepthBuffer = false;
+	m_screenCamera.SetClearMode( CLEAR_NONE );
 }
 
 void DebugRender::DebugRenderSystemShutdown()
 {
-	for( int i = 0; i < (int)m_debugObjects.size(); ++i )
-	{
-		if( m_debugObjects[i] != nullptr )
-		{
-			delete m_debugObjects[i];
-			m_debugObjects[i] = nullptr;
-		}
-	}
+	m_screenCamera.CleanUBO();
 
 	delete g_theDebugRenderSystem;
 	g_theDebugRenderSystem = nullptr;
@@ -61,56 +148,36 @@ void DebugRender::DisableDebugRendering()
 
 void DebugRender::ClearDebugRendering()
 {
-	for( int i = 0; i < (int)m_debugObjects.size(); ++i )
-	{
-		if( m_debugObjects[i] != nullptr )
-		{
-			delete m_debugObjects[i];
-			m_debugObjects[i] = nullptr;
-		}
-	}
-
-	m_debugObjects.clear();
-
-	for( int i = 0; i < (int)m_screenDebugObjects.size(); ++i )
-	{
-		if( m_screenDebugObjects[i] != nullptr )
-		{
-			delete m_screenDebugObjects[i];
-			m_screenDebugObjects[i] = nullptr;
-		}
-	}
-
-	m_screenDebugObjects.clear();
+	// the records stay in the pools for re-use
+	m_numWorldPrimitives = 0;
+	m_numScreenPrimitives = 0;
+	m_areWorldStreamsDirty = true;
 }
 
 void DebugRender::DebugRenderBeginFrame()
 {
+	// colors move with time, so last frame's streams are stale even if nothing was added
+	m_areWorldStreamsDirty = true;
 }
 
-void DebugRender::DebugRenderWorldToCamera( Camera camera )
+void DebugRender::DebugRenderWorldToCamera( Camera const& camera )
 {
-	m_camera = camera;
+	if( m_numWorldPrimitives == 0 ) {
+		return;
+	}
 
-	// Check If Needed To Be Finalized
-	if( m_context == nullptr )
-	{
-		m_context = camera.m_cameraUBO->m_owner;
+	if( m_areWorldStreamsDirty ) {
+		BuildWorldStreams();
 	}
+	AppendBillboardText( camera );
 
-	uint tempClearMode = camera.m_clearMode;
-	camera.SetClearMode( CLEAR_NONE );
-	
-	m_context->SetModelMatrix( Mat44::IDENTITY );
+	DrawWorldLayers( DEBUG_RENDER_USE_DEPTH, false );
+	DrawWorldLayers( DEBUG_RENDER_XRAY, true );
+	DrawWorldLayers( DEBUG_RENDER_XRAY, false );
+	DrawWorldLayers( DEBUG_RENDER_ALWAYS, false );
 
-	for( int i = 0; i < (int)m_debugObjects.size(); ++i ) {
-		if( m_debugObjects[i] != nullptr && !m_debugObjects[i]->m_timer->HasElapsed() ) {
-			m_context->BindTexture( nullptr );
-			g_theRenderer->SetModelMatrix( m_debugObjects[i]->m_transform.ToMatrix() );
-			m_debugObjects[i]->DrawDebugObject();
-		}
-	}
-	camera.SetClearMode( tempClearMode );
+	m_context->EnableDepth( eCompareOp::COMPARE_FUNC_LEQUAL, true );
+	m_context->BindTexture( nullptr );
 	m_context->UpdateTintColor( Rgba8::WHITE );
 }
 
@@ -118,83 +185,55 @@ void DebugRender::DebugRenderScreenTo( Texture* texture )
 {
 	m_context = texture->GetRenderContext();
 
-	Camera* camera = new Camera();
-	camera->SetColorTarget( texture );
 	Vec2 min = Vec2::ZERO;
 	Vec2 max = texture->GetDimensions();
-
 	m_screenCameraDimensions = AABB2( min, max );
 
-	camera->SetOutputSize( max );
-	camera->SetProjectionOrthographic( max.y, 10.f, -10.f );
-	camera->SetOrthoView( Vec2::ZERO, Vec2( max.x, max.y ) );
-	camera->IntialUBO( m_context );
-	camera->m_canClearDepthBuffer = false;
-
-	camera->SetClearMode( CLEAR_NONE );
-
-	g_theDebugRenderSystem->m_context->BeginCamera( *camera );
-
-	for( int i = 0; i < (int)m_screenDebugObjects.size(); ++i )
-	{
-		if( m_screenDebugObjects[i] != nullptr )
-		{
-			m_context->BindTexture( nullptr );
-			m_screenDebugObjects[i]->DrawDebugObject();
+	m_screenVerts.clear();
+	m_screenBatches.clear();
+	for( int primitiveIdx = 0; primitiveIdx < m_numScreenPrimitives; ++primitiveIdx ) {
+		if( IsAlive( m_screenPrimitives[primitiveIdx] ) ) {
+			AppendScreenPrimitive( m_screenPrimitives[primitiveIdx] );
 		}
 	}
 
-	g_theDebugRenderSystem->m_context->EndCamera( *camera );
-	camera->CleanUBO();
+	if( m_screenBatches.empty() ) {
+		return;
+	}
 
-	delete camera;
-	camera = nullptr;
+	m_screenCamera.SetColorTarget( texture );
+	m_screenCamera.SetOutputSize( max );
+	m_screenCamera.SetProjectionOrthographic( max.y, 10.f, -10.f );
+	m_screenCamera.SetOrthoView( Vec2::ZERO, Vec2( max.x, max.y ) );
+
+	// batches keep the order things were added in, so later quads and text still draw over earlier ones
+	m_commands.Reset();
+	m_commands.SetLayer( RENDER_LAYER_TRANSLUCENT );
+	int numBatches = (int)m_screenBatches.size();
+	for( int batchIdx = 0; batchIdx < numBatches; ++batchIdx ) {
+		DebugScreenBatch const& batch = m_screenBatches[batchIdx];
+		m_commands.SetDepth( GetDrawOrderDepth( batchIdx, numBatches ) );
+		m_commands.SetTexture( batch.m_texture );
+		m_commands.DrawVertexArray( batch.m_numVertices, &m_screenVerts[batch.m_firstVertex] );
+	}
+
+	m_context->BeginCamera( m_screenCamera );
+	m_context->SubmitCommandBuffer( m_commands );
+	m_context->EndCamera( m_screenCamera );
 }
 
 void DebugRender::DebugRenderEndFrame()
 {
-	for( int i = 0; i < (int)m_debugObjects.size(); ++i )
-	{
-		if( m_debugObjects[i] )
-		{
-			if( m_debugObjects[i]->m_timer->HasElapsed() )
-			{
-				m_debugObjects[i]->MarkForGarbage();
-			}
-
-
-			if( m_debugObjects[i]->IsGarbage() )
-			{
-				delete m_debugObjects[i];
-				m_debugObjects[i] = nullptr;
-			}
-		}	
-	}
-
-	for( int i = 0; i < (int)m_screenDebugObjects.size(); ++i )
-	{
-		if( m_screenDebugObjects[i] )
-		{
-			if( m_screenDebugObjects[i]->m_timer->HasElapsed() )
-			{
-				m_screenDebugObjects[i]->MarkForGarbage();
-			}
-
-
-			if( m_screenDebugObjects[i]->IsGarbage() )
-			{
-				delete m_screenDebugObjects[i];
-				m_screenDebugObjects[i] = nullptr;
-			}
-		}
-	}
+	RemoveExpiredPrimitives( m_worldPrimitives, m_numWorldPrimitives );
+	RemoveExpiredPrimitives( m_screenPrimitives, m_numScreenPrimitives );
+	m_areWorldStreamsDirty = true;
 }
 
 void DebugRender::DebugAddWorldPoint( Vec3 pos, float size, Rgba8 start_color, Rgba8 end_color, float duration, eDebugRenderMode mode )
 {
-	SphereDebugObject* point = new SphereDebugObject( pos, size, start_color, end_color, duration, mode );
-	point->m_isWireMode = false;
-	m_debugObjects.push_back( point );
+	DebugRenderPrimitive& point = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_POINT, mode, start_color, end_color, duration );
+	point.m_points[0] = pos;
+	point.m_size = size;
 }
 
 void DebugRender::DebugAddWorldPoint( Vec3 pos, float size, Rgba8 color, float duration, eDebugRenderMode mode )
@@ -209,115 +248,123 @@ void DebugRender::DebugAddWorldPoint( Vec3 pos, Rgba8 color, float duration, eDe
 
 void DebugRender::DebugAddWorldLine( Vec3 p0, Rgba8 p0_color, Vec3 p1, Rgba8 p1_color, float thickness, float duration, bool isWire, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	LineDebugObject* line = new LineDebugObject( p0, p0_color, p1, p1_color, thickness, duration, isWire );
-	m_debugObjects.push_back( line );
+	DebugRenderPrimitive& line = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_LINE, mode, p0_color, p1_color, duration );
+	line.m_isWire = isWire;
+	line.m_points[0] = p0;
+	line.m_points[1] = p1;
+	line.m_size = thickness;
 }
 
 void DebugRender::DebugAddWorldLine( Vec3 start, Vec3 end, Rgba8 color, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	DebugAddWorldLine( start, color, end, color, 0.5f, duration, mode );
+	DebugAddWorldLine( start, color, end, color, 0.5f, duration, false, mode );
 }
 
 void DebugRender::DebugAddWorldQuad( Vec3 p0, Vec3 p1, Vec3 p2, Vec3 p3, AABB2 uvs, Rgba8 start_color, Rgba8 end_color, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	QuadDebugObject* quad = new QuadDebugObject( p0, p1, p2, p3, uvs, start_color, end_color, duration );
-	m_debugObjects.push_back( quad );
+	DebugRenderPrimitive& quad = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_QUAD, mode, start_color, end_color, duration );
+	quad.m_points[0] = p0;
+	quad.m_points[1] = p1;
+	quad.m_points[2] = p2;
+	quad.m_points[3] = p3;
+	quad.m_uvs = uvs;
 }
 
 void DebugRender::DebugAddWorldArrow( Vec3 start, Rgba8 startColor, Vec3 end, Rgba8 endColor, float duration, float thickness, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	ArrowDebugObject* arrow = new ArrowDebugObject( start, startColor, end, endColor, thickness, duration );
-	m_debugObjects.push_back( arrow );
+	DebugRenderPrimitive& arrow = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_ARROW, mode, startColor, endColor, duration );
+	arrow.m_points[0] = start;
+	arrow.m_points[1] = end;
+	arrow.m_size = thickness;
 }
 
 void DebugRender::DebugAddWorldArrow( Vec3 start, Vec3 end, Rgba8 color, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	DebugAddWorldArrow( start, color, Vec3::ZERO, color, duration, 1.f, mode );
+	DebugAddWorldArrow( start, color, end, color, duration, 1.f, mode );
 }
 
 void DebugRender::DebugAddWorldText( Mat44 basis, Vec2 pivot, Rgba8 start_color, Rgba8 end_color, float duration, char const* text, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	TextDebugObject* worldText = new TextDebugObject( basis, pivot, start_color, end_color, duration, text );
-	m_debugObjects.push_back( worldText );
+	DebugRenderPrimitive& worldText = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_TEXT, mode, start_color, end_color, duration );
+	worldText.m_basis = basis;
+	worldText.m_pivot = pivot;
+	worldText.m_size = 0.5f;
+	worldText.m_text.assign( text );
 }
 
 void DebugRender::DebugAddWorldText( Mat44 basis, Vec2 pivot, Rgba8 color, float duration, float fontSize, char const* text, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	TextDebugObject* worldText = new TextDebugObject( basis, pivot, color, fontSize, text, duration );
-	InsertOrPushBackIntoVector( m_debugObjects, worldText );
+	DebugAddWorldText( basis, pivot, color, color, duration, text, mode );
+	m_worldPrimitives[m_numWorldPrimitives - 1].m_size = fontSize;
 }
 
 void DebugRender::DebugAddWorldBillboardText( Vec3 origin, Vec2 pivot, Rgba8 start_color, Rgba8 end_color, float duration, char const* text, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	BillboardTextDebugObject* BBText = new BillboardTextDebugObject( origin, pivot, start_color, end_color, duration, text );
-	m_debugObjects.push_back( BBText );
+	DebugRenderPrimitive& billboardText = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_BILLBOARD_TEXT, mode, start_color, end_color, duration );
+	billboardText.m_points[0] = origin;
+	billboardText.m_pivot = pivot;
+	billboardText.m_size = 0.5f;
+	billboardText.m_text.assign( text );
 }
 
 void DebugRender::DebugAddWorldBasis( Mat44 basis, Rgba8 start_tint, Rgba8 end_tint, float thickness, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	BasisDebugObject* basisObject = new BasisDebugObject( basis, start_tint, end_tint, thickness, duration );
-	m_debugObjects.push_back( basisObject );
+	DebugRenderPrimitive& basisPrimitive = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_BASIS, mode, start_tint, end_tint, duration );
+	basisPrimitive.m_basis = basis;
+	basisPrimitive.m_size = thickness;
 }
 
 void DebugRender::DebugAddWorldBasis( Mat44 basis, float thickness, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
 	DebugAddWorldBasis( basis, Rgba8::WHITE, Rgba8::WHITE, thickness, duration, mode );
 }
 
 void DebugRender::DebugAddWorldWireSphere( Vec3 pos, float radius, Rgba8 start_color, Rgba8 end_color, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	SphereDebugObject* point = new SphereDebugObject( pos, radius, start_color, end_color, duration, true );
-	m_debugObjects.push_back( point );
+	DebugRenderPrimitive& sphere = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_SPHERE, mode, start_color, end_color, duration );
+	sphere.m_isWire = true;
+	sphere.m_points[0] = pos;
+	sphere.m_size = radius;
 }
 
 void DebugRender::DebugAddWorldWireSphere( Vec3 pos, float radius, Rgba8 color, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
 	DebugAddWorldWireSphere( pos, radius, color, color, duration, mode );
 }
 
 void DebugRender::DebugAddWorldWireBounds( OBB3 bounds, Rgba8 start_color, Rgba8 end_color, float duration, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	WireBoundDebugObject* wireBound = new WireBoundDebugObject( bounds, start_color, end_color, duration );
-	m_debugObjects.push_back( wireBound );
+	DebugRenderPrimitive& wireBounds = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_BOUNDS, mode, start_color, end_color, duration );
+	wireBounds.m_isWire = true;
+	wireBounds.m_obb = bounds;
 }
 
 void DebugRender::DebugAddWorldWireBounds( OBB3 bounds, Rgba8 color, float duration, bool isWire, eDebugRenderMode mode )
 {
-	UNUSED( mode );
-	WireBoundDebugObject* wireBound = new WireBoundDebugObject( bounds, color, color, duration, isWire );
-	m_debugObjects.push_back( wireBound );
+	DebugAddWorldWireBounds( bounds, color, color, duration, mode );
+	m_worldPrimitives[m_numWorldPrimitives - 1].m_isWire = isWire;
 }
 
 void DebugRender::DebugAddWorldWireBounds( AABB3 bounds, Rgba8 color, float duration, bool isWire, eDebugRenderMode mode)
 {
-	UNUSED( mode );
-	WireBoundDebugObject* wireBound = new WireBoundDebugObject( bounds, color, color, duration, isWire );
-	InsertOrPushBackIntoVector( m_debugObjects, wireBound );
+	OBB3 obb;
+	obb.m_center = 0.5f * ( bounds.mins + bounds.maxs );
+	obb.m_halfDimensions = 0.5f * ( bounds.maxs - bounds.mins );
+	DebugAddWorldWireBounds( obb, color, duration, isWire, mode );
 }
 
 void DebugRender::DebugAddWorldCone( Cone cone, Rgba8 startColor, Rgba8 endColor, float duration )
 {
-	ConeDebugObject* coneDebugObject = new ConeDebugObject( cone, startColor, endColor, duration );
-	InsertOrPushBackIntoVector( m_debugObjects, coneDebugObject );
+	DebugRenderPrimitive& conePrimitive = AddWorldPrimitive( DEBUG_PRIMITIVE_WORLD_CONE, DEBUG_RENDER_USE_DEPTH, startColor, endColor, duration );
+	conePrimitive.m_cone = cone;
 }
 
 void DebugRender::DebugAddScreenPoint( Vec2 pos, float size, Rgba8 start_color, Rgba8 end_color, float duration )
 {
-	ScreenDebugObject_Point* point = new ScreenDebugObject_Point( pos, size, start_color, end_color, duration );
-	m_screenDebugObjects.push_back( point );
+	DebugRenderPrimitive& point = AddScreenPrimitive( DEBUG_PRIMITIVE_SCREEN_QUAD, start_color, end_color, duration );
+	point.m_bounds = AABB2( pos - Vec2( 0.5f * size, 0.5f * size ), pos + Vec2( 0.5f * size, 0.5f * size ) );
+	point.m_uvs = AABB2::ZERO_TO_ONE;
+	point.m_texture = nullptr;
 }
 
 void DebugRender::DebugAddScreenPoint( Vec2 pos, float size, Rgba8 color, float duration )
@@ -332,8 +379,10 @@ void DebugRender::DebugAddScreenPoint( Vec2 pos, Rgba8 color )
 
 void DebugRender::DebugAddScreenLine( Vec2 p0, Rgba8 p0_color, Vec2 p1, Rgba8 p1_color, float duration )
 {
-	ScreenDebugObject_Line* line = new ScreenDebugObject_Line( p0, p0_color, p1, p1_color, duration );
-	m_screenDebugObjects.push_back( line );
+	DebugRenderPrimitive& line = AddScreenPrimitive( DEBUG_PRIMITIVE_SCREEN_LINE, p0_color, p1_color, duration );
+	line.m_points[0] = Vec3( p0.x, p0.y, 0.f );
+	line.m_points[1] = Vec3( p1.x, p1.y, 0.f );
+	line.m_size = 5.f;
 }
 
 void DebugRender::DebugAddScreenLine( Vec2 p0, Vec2 p1, Rgba8 color, float duration )
@@ -343,8 +392,10 @@ void DebugRender::DebugAddScreenLine( Vec2 p0, Vec2 p1, Rgba8 color, float durat
 
 void DebugRender::DebugAddScreenQuad( AABB2 bounds, Rgba8 start_color, Rgba8 end_color, float duration )
 {
-	ScreenDebugObject_Quad* quad = new ScreenDebugObject_Quad( bounds, start_color, end_color, duration );
-	m_screenDebugObjects.push_back( quad );
+	DebugRenderPrimitive& quad = AddScreenPrimitive( DEBUG_PRIMITIVE_SCREEN_QUAD, start_color, end_color, duration );
+	quad.m_bounds = bounds;
+	quad.m_uvs = AABB2::ZERO_TO_ONE;
+	quad.m_texture = nullptr;
 }
 
 void DebugRender::DebugAddScreenQuad( AABB2 bounds, Rgba8 color, float duration )
@@ -355,9 +406,10 @@ void DebugRender::DebugAddScreenQuad( AABB2 bounds, Rgba8 color, float duration
 
 void DebugRender::DebugAddScreenTexturedQuad( AABB2 bounds, Texture* tex, AABB2 uvs, Rgba8 tint, float duration )
 {
-	ScreenDebugObject_Quad* quad = new ScreenDebugObject_Quad( bounds, tint, tex, uvs, duration );
-	InsertOrPushBackIntoVector( m_screenDebugObjects , quad );
-	//m_screenDebugObjects.push_back( quad );
+	DebugRenderPrimitive& quad = AddScreenPrimitive( DEBUG_PRIMITIVE_SCREEN_QUAD, tint, tint, duration );
+	quad.m_bounds = bounds;
+	quad.m_uvs = uvs;
+	quad.m_texture = tex;
 }
 
 void DebugRender::DebugAddScreenTexturedQuad( AABB2 bounds, Texture* tex, Rgba8 tint, float duration )
@@ -367,14 +419,18 @@ void DebugRender::DebugAddScreenTexturedQuad( AABB2 bounds, Texture* tex, Rgba8
 
 void DebugRender::DebugAddScreenText( Vec4 pos, Vec2 pivot, float textSize, Rgba8 start_color, Rgba8 end_color, float duration, char const* text )
 {
-	ScreenDebugObject_Text* theText = new ScreenDebugObject_Text( pos, pivot, textSize, start_color, end_color, duration, text );
-	InsertOrPushBackIntoVector( m_screenDebugObjects, theText );
+	DebugRenderPrimitive& screenText = AddScreenPrimitive( DEBUG_PRIMITIVE_SCREEN_TEXT, start_color, end_color, duration );
+	screenText.m_points[0] = Vec3( pos.x, pos.y, 0.f );		// alignment, as a fraction of the screen
+	screenText.m_pivot = pivot;
+	screenText.m_size = textSize;
+	screenText.m_text.assign( text );
 }
 
 void DebugRender::DebugAddScreenBasis( Vec2 screen_origin_location, Mat44 basis_to_render, Rgba8 start_tint, Rgba8 end_tint, float duration )
 {
-	ScreenDebugObject_Basis* basis = new ScreenDebugObject_Basis( screen_origin_location, basis_to_render, start_tint, end_tint, duration );
-	m_screenDebugObjects.push_back( basis );
+	DebugRenderPrimitive& basis = AddScreenPrimitive( DEBUG_PRIMITIVE_SCREEN_BASIS, start_tint, end_tint, duration );
+	basis.m_points[0] = Vec3( screen_origin_location.x, screen_origin_location.y, 0.f );
+	basis.m_basis = basis_to_render;
 }
 
 void DebugRender::DebugAddScreenBasis( Vec2 screen_origin_location, Mat44 basis_to_render, Rgba8 tint, float duration )
@@ -382,19 +438,308 @@ void DebugRender::DebugAddScreenBasis( Vec2 screen_origin_location, Mat44 basis_
 	DebugAddScreenBasis( screen_origin_location, basis_to_render, tint, tint, duration );
 }
 
-void DebugRender::InsertOrPushBackIntoVector( std::vector<DebugRenderObject*>& vector, DebugRenderObject* object )
+DebugRenderPrimitive& DebugRender::AddWorldPrimitive( eDebugPrimitiveType type, eDebugRenderMode mode, Rgba8 startColor, Rgba8 endColor, float duration )
+{
+	m_areWorldStreamsDirty = true;
+
+	DebugRenderPrimitive& primitive = AddPrimitive( m_worldPrimitives, m_numWorldPrimitives, type, startColor, endColor, duration );
+	primitive.m_mode = mode;
+	return primitive;
+}
+
+DebugRenderPrimitive& DebugRender::AddScreenPrimitive( eDebugPrimitiveType type, Rgba8 startColor, Rgba8 endColor, float duration )
+{
+	return AddPrimitive( m_screenPrimitives, m_numScreenPrimitives, type, startColor, endColor, duration );
+}
+
+DebugRenderPrimitive& DebugRender::AddPrimitive( std::vector<DebugRenderPrimitive>& pool, int& numLive, eDebugPrimitiveType type, Rgba8 startColor, Rgba8 endColor, float duration )
+{
+	if( numLive == (int)pool.size() ) {
+		pool.emplace_back();
+	}
+
+	// only the common fields are reset; the adders set everything their type reads
+	DebugRenderPrimitive& primitive = pool[numLive++];
+	primitive.m_type = type;
+	primitive.m_mode = DEBUG_RENDER_USE_DEPTH;
+	primitive.m_isWire = false;
+	primitive.m_startSeconds = m_clock->GetTotalElapsedSeconds();
+	primitive.m_durationSeconds = duration;
+	primitive.m_startColor = startColor;
+	primitive.m_endColor = endColor;
+	return primitive;
+}
+
+void DebugRender::RemoveExpiredPrimitives( std::vector<DebugRenderPrimitive>& pool, int& numLive )
+{
+	// stable, so screen primitives keep their draw order; swapping parks the dead records (and their text buffers) past the end
+	int numKept = 0;
+	for( int primitiveIdx = 0; primitiveIdx < numLive; ++primitiveIdx ) {
+		if( IsAlive( pool[primitiveIdx] ) ) {
+			if( primitiveIdx != numKept ) {
+				std::swap( pool[numKept], pool[primitiveIdx] );
+			}
+			++numKept;
+		}
+	}
+	numLive = numKept;
+}
+
+bool DebugRender::IsAlive( DebugRenderPrimitive const& primitive ) const
+{
+	// same rule as Timer::HasElapsed, so a zero duration still lives for the frame it was added in
+	return m_clock->GetTotalElapsedSeconds() <= primitive.m_startSeconds + primitive.m_durationSeconds;
+}
+
+Rgba8 DebugRender::GetCurrentColor( DebugRenderPrimitive const& primitive ) const
 {
-	bool foundEmptySlot = false;
-	// avoid infinite size of vector
-	for( int i = 0; i < (int)vector.size(); ++i ) {
-		if( vector[i] == nullptr ) {
-			vector[i] = object;
-			foundEmptySlot = true;
-			break;
+	if( primitive.m_durationSeconds <= 0.0 ) {
+		return primitive.m_startColor;
+	}
+
+	double elapsedSeconds = m_clock->GetTotalElapsedSeconds() - primitive.m_startSeconds;
+	float fraction = Clamp( (float)( elapsedSeconds / primitive.m_durationSeconds ), 0.f, 1.f );
+	return InterpolateColor( primitive.m_startColor, primitive.m_endColor, fraction );
+}
+
+void DebugRender::BuildWorldStreams()
+{
+	for( int modeIdx = 0; modeIdx < NUM_DEBUG_RENDER_MODES; ++modeIdx ) {
+		for( int layerIdx = 0; layerIdx < NUM_DEBUG_WORLD_LAYERS; ++layerIdx ) {
+			m_worldVerts[modeIdx][layerIdx].clear();
+		}
+	}
+
+	for( int primitiveIdx = 0; primitiveIdx < m_numWorldPrimitives; ++primitiveIdx ) {
+		DebugRenderPrimitive const& primitive = m_worldPrimitives[primitiveIdx];
+		if( primitive.m_type != DEBUG_PRIMITIVE_WORLD_BILLBOARD_TEXT && IsAlive( primitive ) ) {
+			AppendWorldPrimitive( primitive );
 		}
 	}
-	if( foundEmptySlot == false ) {
-		vector.push_back( object );
+
+	for( int modeIdx = 0; modeIdx < NUM_DEBUG_RENDER_MODES; ++modeIdx ) {
+		m_numCameraIndependentTextVerts[modeIdx] = (int)m_worldVerts[modeIdx][DEBUG_WORLD_LAYER_TEXT].size();
+	}
+	m_areWorldStreamsDirty = false;
+}
+
+void DebugRender::AppendBillboardText( Camera const& camera )
+{
+	for( int modeIdx = 0; modeIdx < NUM_DEBUG_RENDER_MODES; ++modeIdx ) {
+		m_worldVerts[modeIdx][DEBUG_WORLD_LAYER_TEXT].resize( m_numCameraIndependentTextVerts[modeIdx] );
+	}
+
+	Vec3 cameraPosition = camera.m_transform.m_position;
+	for( int primitiveIdx = 0; primitiveIdx < m_numWorldPrimitives; ++primitiveIdx ) {
+		DebugRenderPrimitive const& primitive = m_worldPrimitives[primitiveIdx];
+		if( primitive.m_type != DEBUG_PRIMITIVE_WORLD_BILLBOARD_TEXT || !IsAlive( primitive ) ) {
+			continue;
+		}
+
+		std::vector<Vertex_PCU>& verts = m_worldVerts[primitive.m_mode][DEBUG_WORLD_LAYER_TEXT];
+		size_t firstVertex = verts.size();
+		Vec2 dimensions = m_font->GetDimensionsForText2D( primitive.m_size, primitive.m_text );
+		Vec2 textMins = -( primitive.m_pivot * dimensions );
+		m_font->AddVertsForText3D( verts, textMins, 0.f, primitive.m_size, primitive.m_text, GetCurrentColor( primitive ) );
+
+		Mat44 lookAt = Mat44::CreateLookAtMatrix( primitive.m_points[0], cameraPosition );
+		TransformVertices( lookAt, verts.data() + firstVertex, (int)( verts.size() - firstVertex ) );
+	}
+}
+
+void DebugRender::AppendWorldPrimitive( DebugRenderPrimitive const& primitive )
+{
+	std::vector<Vertex_PCU>* layers = m_worldVerts[primitive.m_mode];
+	std::vector<Vertex_PCU>& verts = layers[primitive.m_isWire ? DEBUG_WORLD_LAYER_WIRE : DEBUG_WORLD_LAYER_SOLID];
+	Rgba8 color = GetCurrentColor( primitive );
+
+	switch( primitive.m_type )
+	{
+	case DEBUG_PRIMITIVE_WORLD_POINT:
+		AppendDebugPoint( verts, primitive.m_points[0], primitive.m_size, color );
+		break;
+	case DEBUG_PRIMITIVE_WORLD_LINE:
+		AppendDebugLine( verts, primitive.m_points[0], primitive.m_points[1], primitive.m_startColor, primitive.m_endColor, primitive.m_size );
+		break;
+	case DEBUG_PRIMITIVE_WORLD_ARROW:
+		AppendArrowToVerts( m_scratchVerts, m_scratchIndices, primitive.m_points[0], primitive.m_points[1], primitive.m_startColor, primitive.m_endColor, primitive.m_size );
+		AppendIndexedScratch( verts );
+		break;
+	case DEBUG_PRIMITIVE_WORLD_QUAD:
+		AppendQuadToVerts( m_scratchVerts, m_scratchIndices, primitive.m_points[0], primitive.m_points[1], primitive.m_points[2], primitive.m_points[3], color );
+		AppendIndexedScratch( verts );
+		break;
+	case DEBUG_PRIMITIVE_WORLD_TEXT:
+	{
+		std::vector<Vertex_PCU>& textVerts = layers[DEBUG_WORLD_LAYER_TEXT];
+		size_t firstVertex = textVerts.size();
+		Vec2 dimensions = m_font->GetDimensionsForText2D( primitive.m_size, primitive.m_text );
+		Vec2 textMins = -( primitive.m_pivot * dimensions );
+		m_font->AddVertsForText3D( textVerts, textMins, 0.f, primitive.m_size, primitive.m_text, color );
+		TransformVertices( primitive.m_basis, textVerts.data() + firstVertex, (int)( textVerts.size() - firstVertex ) );
+		break;
+	}
+	case DEBUG_PRIMITIVE_WORLD_BASIS:
+	{
+		Vec3 origin = primitive.m_basis.GetTranslation3D();
+		AppendArrowToVerts( m_scratchVerts, m_scratchIndices, origin, origin + primitive.m_basis.GetIBasis3D(), Rgba8::RED, Rgba8::RED, primitive.m_size );
+		AppendIndexedScratch( verts );
+		AppendArrowToVerts( m_scratchVerts, m_scratchIndices, origin, origin + primitive.m_basis.GetJBasis3D(), Rgba8::GREEN, Rgba8::GREEN, primitive.m_size );
+		AppendIndexedScratch( verts );
+		AppendArrowToVerts( m_scratchVerts, m_scratchIndices, origin, origin + primitive.m_basis.GetKBasis3D(), Rgba8::BLUE, Rgba8::BLUE, primitive.m_size );
+		AppendIndexedScratch( verts );
+		break;
+	}
+	case DEBUG_PRIMITIVE_WORLD_SPHERE:
+		AddUVSphereToIndexedVertexArray( m_scratchVerts, m_scratchIndices, primitive.m_points[0], primitive.m_size, 10, 10, color );
+		AppendIndexedScratch( verts );
+		break;
+	case DEBUG_PRIMITIVE_WORLD_BOUNDS:
+		AppendOBB3ToVerts( m_scratchVerts, m_scratchIndices, primitive.m_obb, color );
+		AppendIndexedScratch( verts );
+		break;
+	case DEBUG_PRIMITIVE_WORLD_CONE:
+		AddConeToVerts( m_scratchVerts, m_scratchIndices, primitive.m_cone.m_center, primitive.m_cone.m_radius, primitive.m_cone.m_apexPoint, primitive.m_cone.m_height, primitive.m_startColor, primitive.m_endColor );
+		AppendIndexedScratch( verts );
+		break;
+	default:
+		break;
+	}
+}
+
+void DebugRender::AppendScreenPrimitive( DebugRenderPrimitive const& primitive )
+{
+	Texture const* texture = nullptr;
+	int firstVertex = (int)m_screenVerts.size();
+	Rgba8 color = GetCurrentColor( primitive );
+
+	switch( primitive.m_type )
+	{
+	case DEBUG_PRIMITIVE_SCREEN_QUAD:
+	{
+		AABB2 const& box = primitive.m_bounds;
+		AABB2 const& uvs = primitive.m_uvs;
+		m_screenVerts.push_back( Vertex_PCU( Vec2( box.mins.x, box.mins.y ), color, Vec2( uvs.mins.x, uvs.mins.y ) ) );
+		m_screenVerts.push_back( Vertex_PCU( Vec2( box.maxs.x, box.mins.y ), color, Vec2( uvs.maxs.x, uvs.mins.y ) ) );
+		m_screenVerts.push_back( Vertex_PCU( Vec2( box.maxs.x, box.maxs.y ), color, Vec2( uvs.maxs.x, uvs.maxs.y ) ) );
+
+		m_screenVerts.push_back( Vertex_PCU( Vec2( box.mins.x, box.mins.y ), color, Vec2( uvs.mins.x, uvs.mins.y ) ) );
+		m_screenVerts.push_back( Vertex_PCU( Vec2( box.maxs.x, box.maxs.y ), color, Vec2( uvs.maxs.x, uvs.maxs.y ) ) );
+		m_screenVerts.push_back( Vertex_PCU( Vec2( box.mins.x, box.maxs.y ), color, Vec2( uvs.mins.x, uvs.maxs.y ) ) );
+		texture = primitive.m_texture;
+		break;
+	}
+	case DEBUG_PRIMITIVE_SCREEN_LINE:
+	{
+		Vec2 start = Vec2( primitive.m_points[0].x, primitive.m_points[0].y );
+		Vec2 end = Vec2( primitive.m_points[1].x, primitive.m_points[1].y );
+		AppendScreenLine( m_screenVerts, start, end, primitive.m_startColor, primitive.m_endColor, primitive.m_size );
+		break;
+	}
+	case DEBUG_PRIMITIVE_SCREEN_TEXT:
+	{
+		Vec2 alignment = Vec2( primitive.m_points[0].x, primitive.m_points[0].y );
+		Vec2 textMins = alignment * m_screenCameraDimensions.maxs;
+		m_font->AddVertsForText2D( m_screenVerts, textMins, primitive.m_size, primitive.m_text, color, 1.f );
+		texture = m_font->GetTexture();
+		break;
+	}
+	case DEBUG_PRIMITIVE_SCREEN_BASIS:
+	{
+		constexpr float BOX_WIDTH = 100.f;
+		constexpr float BOX_HEIGHT = 7.5f;
+		Vec2 position = Vec2( primitive.m_points[0].x, primitive.m_points[0].y );
+		Vec2 iBasis = primitive.m_basis.GetIBasis2D();
+		Vec2 jBasis = primitive.m_basis.GetJBasis2D();
+
+		AABB2 iBox = AABB2( position, position + Vec2( BOX_WIDTH, BOX_HEIGHT ) );
+		Vec2 iArrowBase = 0.5f * ( iBox.maxs + Vec2( iBox.maxs.x, iBox.mins.y ) );
+		m_screenVerts.push_back( Vertex_PCU( iArrowBase + jBasis * BOX_HEIGHT * 2.f, Rgba8::RED, Vec2::ZERO ) );
+		m_screenVerts.push_back( Vertex_PCU( iArrowBase - jBasis * BOX_HEIGHT * 2.f, Rgba8::RED, Vec2::ZERO ) );
+		m_screenVerts.push_back( Vertex_PCU( iArrowBase + iBasis * BOX_HEIGHT * 1.717f * 2.f, Rgba8::RED, Vec2::ZERO ) );
+		AppendAABB2D( m_screenVerts, iBox, Rgba8::RED );
+
+		AABB2 jBox = AABB2( position, position + Vec2( BOX_HEIGHT, BOX_WIDTH ) );
+		Vec2 jArrowBase = 0.5f * ( jBox.maxs + Vec2( jBox.mins.x, jBox.maxs.y ) );
+		m_screenVerts.push_back( Vertex_PCU( jArrowBase + iBasis * BOX_HEIGHT * 2.f, Rgba8::GREEN, Vec2::ZERO ) );
+		m_screenVerts.push_back( Vertex_PCU( jArrowBase - iBasis * BOX_HEIGHT * 2.f, Rgba8::GREEN, Vec2::ZERO ) );
+		m_screenVerts.push_back( Vertex_PCU( jArrowBase + jBasis * BOX_HEIGHT * 1.717f * 2.f, Rgba8::GREEN, Vec2::ZERO ) );
+		AppendAABB2D( m_screenVerts, jBox, Rgba8::GREEN );
+		break;
+	}
+	default:
+		break;
+	}
+
+	int numVertices = (int)m_screenVerts.size() - firstVertex;
+	if( numVertices == 0 ) {
+		return;
+	}
+
+	if( !m_screenBatches.empty() && m_screenBatches.back().m_texture == texture ) {
+		m_screenBatches.back().m_numVertices += numVertices;
+	}
+	else {
+		DebugScreenBatch batch;
+		batch.m_texture = texture;
+		batch.m_firstVertex = firstVertex;
+		batch.m_numVertices = numVertices;
+		m_screenBatches.push_back( batch );
 	}
 }
 
+void DebugRender::AppendIndexedScratch( std::vector<Vertex_PCU>& verts )
+{
+	for( uint index : m_scratchIndices ) {
+		verts.push_back( m_scratchVerts[index] );
+	}
+
+	m_scratchVerts.clear();
+	m_scratchIndices.clear();
+}
+
+void DebugRender::DrawWorldLayers( eDebugRenderMode mode, bool isOccludedPass )
+{
+	std::vector<Vertex_PCU> const* layers = m_worldVerts[mode];
+
+	switch( mode )
+	{
+	case DEBUG_RENDER_ALWAYS:		m_context->EnableDepth( eCompareOp::COMPARE_FUNC_ALWAYS, false );	break;
+	case DEBUG_RENDER_USE_DEPTH:	m_context->EnableDepth( eCompareOp::COMPARE_FUNC_LEQUAL, true );	break;
+	case DEBUG_RENDER_XRAY:
+		if( isOccludedPass ) {
+			m_context->EnableDepth( eCompareOp::COMPARE_FUNC_GREATER, false );
+		}
+		else {
+			m_context->EnableDepth( eCompareOp::COMPARE_FUNC_LEQUAL, true );
+		}
+		break;
+	default:
+		break;
+	}
+
+	m_commands.Reset();
+	m_commands.SetLayer( RENDER_LAYER_TRANSLUCENT );
+	for( int layerIdx = 0; layerIdx < NUM_DEBUG_WORLD_LAYERS; ++layerIdx ) {
+		std::vector<Vertex_PCU> const* verts = &layers[layerIdx];
+		if( verts->empty() ) {
+			continue;
+		}
+
+		// the hidden half of x-ray is the same geometry at half brightness
+		if( isOccludedPass ) {
+			m_occludedVerts = *verts;
+			for( Vertex_PCU& vert : m_occludedVerts ) {
+				vert.m_color = Rgba8( (unsigned char)( vert.m_color.r / 2 ), (unsigned char)( vert.m_color.g / 2 ), (unsigned char)( vert.m_color.b / 2 ), vert.m_color.a );
+			}
+			verts = &m_occludedVerts;
+		}
+
+		m_commands.SetDepth( GetDrawOrderDepth( layerIdx, NUM_DEBUG_WORLD_LAYERS ) );
+		m_commands.SetTexture( layerIdx == DEBUG_WORLD_LAYER_TEXT ? m_font->GetTexture() : nullptr );
+		m_commands.SetWireframe( layerIdx == DEBUG_WORLD_LAYER_WIRE );
+		m_commands.DrawVertexArray( (int)verts->size(), verts->data() );
+	}
+
+	m_context->SubmitCommandBuffer( m_commands );
+}
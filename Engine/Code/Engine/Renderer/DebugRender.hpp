@@ -3,14 +3,92 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/GPUMesh.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
-#include "Engine/Renderer/DebugRenderObject.hpp"
 #include "Engine/Math/Cone.hpp"
+#include "Engine/Math/OBB3.hpp"
+#include <string>
 #include <vector>
 
 //----------------------------------------------------------------------------------------------------------------------------
+class BitmapFont;
 class Clock;
 //----------------------------------------------------------------------------------------------------------------------------
 
+enum eDebugRenderMode
+{
+	DEBUG_RENDER_ALWAYS,          // what is rendered always shows up
+	DEBUG_RENDER_USE_DEPTH,       // respect the depth buffer
+	DEBUG_RENDER_XRAY,            // renders twice - once darker when it should be hidden, and once more saturated when it should appear
+
+	NUM_DEBUG_RENDER_MODES
+};
+
+enum eDebugPrimitiveType
+{
+	DEBUG_PRIMITIVE_WORLD_POINT,
+	DEBUG_PRIMITIVE_WORLD_LINE,
+	DEBUG_PRIMITIVE_WORLD_ARROW,
+	DEBUG_PRIMITIVE_WORLD_QUAD,
+	DEBUG_PRIMITIVE_WORLD_TEXT,
+	DEBUG_PRIMITIVE_WORLD_BILLBOARD_TEXT,
+	DEBUG_PRIMITIVE_WORLD_BASIS,
+	DEBUG_PRIMITIVE_WORLD_SPHERE,
+	DEBUG_PRIMITIVE_WORLD_BOUNDS,
+	DEBUG_PRIMITIVE_WORLD_CONE,
+
+	DEBUG_PRIMITIVE_SCREEN_QUAD,
+	DEBUG_PRIMITIVE_SCREEN_LINE,
+	DEBUG_PRIMITIVE_SCREEN_TEXT,
+	DEBUG_PRIMITIVE_SCREEN_BASIS,
+};
+
+// which world stream a primitive expands into; each is one draw per render mode
+enum eDebugWorldLayer
+{
+	DEBUG_WORLD_LAYER_SOLID,
+	DEBUG_WORLD_LAYER_WIRE,
+	DEBUG_WORLD_LAYER_TEXT,
+
+	NUM_DEBUG_WORLD_LAYERS
+};
+
+//----------------------------------------------------------------------------------------------------------------------------
+// A debug primitive is only its parameters and lifetime. Nothing is built when it is added; every frame the live ones are
+// expanded into a few shared vertex streams. Records are pooled: an expired one stays constructed past the live count,
+// so re-using it (text included) does not allocate.
+//----------------------------------------------------------------------------------------------------------------------------
+struct DebugRenderPrimitive
+{
+	eDebugPrimitiveType	m_type = DEBUG_PRIMITIVE_WORLD_POINT;
+	eDebugRenderMode	m_mode = DEBUG_RENDER_USE_DEPTH;
+	bool				m_isWire = false;
+
+	double				m_startSeconds = 0.0;
+	double				m_durationSeconds = 0.0;
+
+	// tint over the lifetime; lines and arrows use them as the colors of the two ends instead
+	Rgba8				m_startColor = Rgba8::WHITE;
+	Rgba8				m_endColor = Rgba8::WHITE;
+
+	Vec3				m_points[4];
+	float				m_size = 0.f;		// radius, thickness or text height
+	Vec2				m_pivot = Vec2::ZERO;
+	Mat44				m_basis;
+	AABB2				m_bounds = AABB2::ZERO_TO_ONE;
+	AABB2				m_uvs = AABB2::ZERO_TO_ONE;
+	OBB3				m_obb;
+	Cone				m_cone;
+	Texture const*		m_texture = nullptr;
+	std::string			m_text;
+};
+
+// consecutive screen primitives drawn with the same texture
+struct DebugScreenBatch
+{
+	Texture const*	m_texture = nullptr;
+	int				m_firstVertex = 0;
+	int				m_numVertices = 0;
+};
+
 class DebugRender
 {
 	/************************************************************************/
@@ -45,7 +123,7 @@ public:
 
 	// output
 	void DebugRenderBeginFrame();						// Does nothing, here for completeness.
-	void DebugRenderWorldToCamera( Camera camera );	// Draws all world objects to this camera 
+	void DebugRenderWorldToCamera( Camera const& camera );	// Draws all world objects to this camera 
 	void DebugRenderScreenTo( Texture* texture );		// Draws all screen objects onto this texture (screen coordinate system is up to you.  I like a 1080p default)
 	void DebugRenderEndFrame();							// Clean up dead objects
 
@@ -131,17 +209,49 @@ public:
 	void DebugAddScreenBasis( Vec2 screen_origin_location, Mat44 basis_to_render, Rgba8 start_tint, Rgba8 end_tint, float duration );
 	void DebugAddScreenBasis( Vec2 screen_origin_location, Mat44 basis_to_render, Rgba8 tint = Rgba8::WHITE, float duration = 0.0f );
 
-	// helper functions
-	void InsertOrPushBackIntoVector( std::vector<DebugRenderObject*>& vector, DebugRenderObject* object );
+private:
+	DebugRenderPrimitive&	AddWorldPrimitive( eDebugPrimitiveType type, eDebugRenderMode mode, Rgba8 startColor, Rgba8 endColor, float duration );
+	DebugRenderPrimitive&	AddScreenPrimitive( eDebugPrimitiveType type, Rgba8 startColor, Rgba8 endColor, float duration );
+	DebugRenderPrimitive&	AddPrimitive( std::vector<DebugRenderPrimitive>& pool, int& numLive, eDebugPrimitiveType type, Rgba8 startColor, Rgba8 endColor, float duration );
+	void					RemoveExpiredPrimitives( std::vector<DebugRenderPrimitive>& pool, int& numLive );
+
+	bool					IsAlive( DebugRenderPrimitive const& primitive ) const;
+	Rgba8					GetCurrentColor( DebugRenderPrimitive const& primitive ) const;
+
+	void					BuildWorldStreams();
+	void					AppendBillboardText( Camera const& camera );
+	void					AppendWorldPrimitive( DebugRenderPrimitive const& primitive );
+	void					AppendScreenPrimitive( DebugRenderPrimitive const& primitive );
+	void					AppendIndexedScratch( std::vector<Vertex_PCU>& verts );
+	void					DrawWorldLayers( eDebugRenderMode mode, bool isOccludedPass );
 
 public:
 	RenderContext* m_context = nullptr;
 
-	std::vector<DebugRenderObject*> m_debugObjects;
-	std::vector<DebugRenderObject*> m_screenDebugObjects;
+	std::vector<DebugRenderPrimitive> m_worldPrimitives;
+	std::vector<DebugRenderPrimitive> m_screenPrimitives;
+	int m_numWorldPrimitives = 0;
+	int m_numScreenPrimitives = 0;
+
+	// expanded world geometry, built once a frame and shared by every camera (both eyes); billboards are re-appended per camera
+	std::vector<Vertex_PCU> m_worldVerts[NUM_DEBUG_RENDER_MODES][NUM_DEBUG_WORLD_LAYERS];
+	int m_numCameraIndependentTextVerts[NUM_DEBUG_RENDER_MODES] = {};
+	bool m_areWorldStreamsDirty = true;
+
+	std::vector<Vertex_PCU> m_screenVerts;
+	std::vector<DebugScreenBatch> m_screenBatches;
+
+	// MeshUtils builds indexed geometry; it is staged here and flattened into the streams
+	std::vector<Vertex_PCU> m_scratchVerts;
+	std::vector<uint> m_scratchIndices;
+	std::vector<Vertex_PCU> m_occludedVerts;
+
+	// each pass records its streams here and submits them as one upload, binding the texture and fill mode only on change
+	RenderCommandBuffer m_commands;
 
 	Clock* m_clock = nullptr;
-	Camera m_camera; // Delete later
+	Camera m_screenCamera;
+	BitmapFont* m_font = nullptr;
 
 	AABB2 m_screenCameraDimensions = AABB2::ZERO_TO_ONE;
 
@@ -52,6 +52,16 @@ void GPUMesh::UpdateIndices( uint icount, uint const* indices )
 	}
 }
 
+void GPUMesh::UpdateIndices16( uint icount, uint16_t const* indices )
+{
+	m_indicesCount = icount;
+
+	if( indices != nullptr )
+	{
+		m_indices->Update16( icount, indices );
+	}
+}
+
 void GPUMesh::UpdateIndices( std::vector<uint> const& indices )
 {
 	UpdateIndices( (uint)indices.size(), &indices[0] );
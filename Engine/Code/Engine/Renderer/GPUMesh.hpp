@@ -17,6 +17,7 @@ public:
 	void UpdateVertices( std::vector<Vertex_PCUTBN> const& vertices );
 
 	void UpdateIndices( uint icount, uint const* indices );
+	void UpdateIndices16( uint icount, uint16_t const* indices );	// named apart so UpdateIndices( 0, nullptr ) stays unambiguous
 	void UpdateIndices( std::vector<uint> const& indices );
 
 	int GetIndexCount() const;
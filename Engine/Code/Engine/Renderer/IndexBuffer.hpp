@@ -1,6 +1,6 @@
 #pragma once
 #include "Engine/Renderer/RenderBuffer.hpp"
-#include "D3D11Common.hpp"
+#include <cstdint>
 #include <vector>
 
 class IndexBuffer : public RenderBuffer 
@@ -9,7 +9,6 @@ public:
 	IndexBuffer( RenderContext* ctx, eRenderMemoryHint hint );
 
 	void Update( uint icount, uint const* indices );
+	void Update16( uint icount, uint16_t const* indices );	// 16-bit indices, for meshes of up to 65536 vertices
 	void Update( std::vector<uint> const& indices ); // helper, calls one above
-
-	HRESULT Initialize( ID3D11Device* device, uint* data, UINT numIndices );
 };
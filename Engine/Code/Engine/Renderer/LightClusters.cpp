@@ -0,0 +1,880 @@
+#include "Engine/Renderer/LightClusters.hpp"
+#include "Engine/Renderer/RenderContext.hpp"
+#include "Engine/Math/MatrixUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/Vec4.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/UnitTest.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) || defined( __SSE__ )
+	#define LIGHT_CLUSTERS_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
+extern JobSystem*	g_theJobSystem;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+float GetLightRange( light_t const& light, float cutoff )
+{
+	float brightness = light.intensity * fmaxf( light.color.x, fmaxf( light.color.y, light.color.z ) );
+	if( brightness <= 0.f ) {
+		return 0.f;
+	}
+	if( cutoff <= 0.f ) {
+		return FLT_MAX;
+	}
+
+	// solve brightness / ( c + l*d + q*d^2 ) = cutoff for d
+	float target = brightness / cutoff;
+	float constant = light.attenuation.x;
+	float linear = light.attenuation.y;
+	float quadratic = light.attenuation.z;
+	if( constant >= target ) {
+		return 0.f;
+	}
+	if( quadratic > 0.f ) {
+		return ( -linear + sqrtf( linear * linear + 4.f * quadratic * ( target - constant ) ) ) / ( 2.f * quadratic );
+	}
+	if( linear > 0.f ) {
+		return ( target - constant ) / linear;
+	}
+	return FLT_MAX;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// The tests below are shared by the scalar path and written with the same grouping as the SSE kernel, so both
+// paths agree bit for bit.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static bool IsSphereTouchingBox( float centerX, float centerY, float centerZ, float extentX, float extentY, float extentZ,
+	float sphereX, float sphereY, float sphereZ, float radius )
+{
+	float dx = fmaxf( fabsf( centerX - sphereX ) - extentX, 0.f );
+	float dy = fmaxf( fabsf( centerY - sphereY ) - extentY, 0.f );
+	float dz = fmaxf( fabsf( centerZ - sphereZ ) - extentZ, 0.f );
+	return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static bool IsSphereTouchingBox( Vec3 const& center, Vec3 const& extent, Vec3 const& sphereCenter, float radius )
+{
+	return IsSphereTouchingBox( center.x, center.y, center.z, extent.x, extent.y, extent.z, sphereCenter.x, sphereCenter.y, sphereCenter.z, radius );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Cone against a cluster's bounding sphere: the distance from the sphere's center to the cone's surface, measured
+// perpendicular to the surface, plus caps at the apex and at the light's range.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static bool IsConeTouchingSphere( float sphereX, float sphereY, float sphereZ, float sphereRadius,
+	Vec3 const& apex, Vec3 const& direction, float cosAngle, float sinAngle, float range )
+{
+	float vx = sphereX - apex.x;
+	float vy = sphereY - apex.y;
+	float vz = sphereZ - apex.z;
+	float lengthSquared = vx * vx + vy * vy + vz * vz;
+	float alongAxis = vx * direction.x + vy * direction.y + vz * direction.z;
+	float closest = cosAngle * sqrtf( fmaxf( lengthSquared - alongAxis * alongAxis, 0.f ) ) - alongAxis * sinAngle;
+	bool isOutside = closest > sphereRadius || alongAxis > sphereRadius + range || alongAxis < -sphereRadius;
+	return !isOutside;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static float GetSliceNearDepth( float nearDepth, float farDepth, int slice, int numSlices )
+{
+	return nearDepth * powf( farDepth / nearDepth, (float)slice / (float)numSlices );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static void StretchBounds( Vec3& mins, Vec3& maxs, Vec3 const& point )
+{
+	mins = Vec3( fminf( mins.x, point.x ), fminf( mins.y, point.y ), fminf( mins.z, point.z ) );
+	maxs = Vec3( fmaxf( maxs.x, point.x ), fmaxf( maxs.y, point.y ), fmaxf( maxs.z, point.z ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+LightClusterGrid::LightClusterGrid()
+{
+	BuildClusterBounds();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+LightClusterGrid::~LightClusterGrid()
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::SetDimensions( int tilesX, int tilesY, int numSlices )
+{
+	GUARANTEE_OR_DIE( tilesX > 0 && tilesY > 0 && numSlices > 0, "LightClusterGrid needs at least one cluster" );
+	GUARANTEE_OR_DIE( tilesX * tilesY * numSlices <= 0xffff * 16, "LightClusterGrid: too many clusters" );
+	m_tilesX = tilesX;
+	m_tilesY = tilesY;
+	m_numSlices = numSlices;
+	BuildClusterBounds();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::SetProjection( Mat44 const& viewToClip, float nearDepth, float farDepth )
+{
+	GUARANTEE_OR_DIE( nearDepth > 0.f && farDepth > nearDepth, "LightClusterGrid: depth range must be positive and increasing" );
+
+	m_viewToClip = viewToClip;
+	m_clipToView = GetInvert( viewToClip );
+	m_depthAxis = Vec3( viewToClip.Iw, viewToClip.Jw, viewToClip.Kw );
+	m_depthOffset = viewToClip.Tw;
+	GUARANTEE_OR_DIE( m_depthAxis.GetLengthSquared() > 0.f, "LightClusterGrid needs a perspective projection" );
+
+	m_nearDepth = nearDepth;
+	m_farDepth = farDepth;
+	BuildClusterBounds();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+float LightClusterGrid::GetDepth( Vec3 const& viewPosition ) const
+{
+	return DotProduct( m_depthAxis, viewPosition ) + m_depthOffset;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetSliceForDepth( float depth ) const
+{
+	if( !( depth >= m_nearDepth && depth < m_farDepth ) ) {
+		return -1;
+	}
+	int slice = (int)( logf( depth / m_nearDepth ) * m_sliceScale );
+	return Clamp( slice, 0, m_numSlices - 1 );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+int LightClusterGrid::GetClusterIndexForViewPosition( Vec3 const& viewPosition ) const
+{
+	int slice = GetSliceForDepth( GetDepth( viewPosition ) );
+	if( slice < 0 ) {
+		return -1;
+	}
+
+	Vec4 clip = m_viewToClip.TransformHomogeneousPoint3D( Vec4( viewPosition.x, viewPosition.y, viewPosition.z, 1.f ) );
+	float tileX = floorf( ( clip.x / clip.w + 1.f ) * 0.5f * (float)m_tilesX );
+	float tileY = floorf( ( clip.y / clip.w + 1.f ) * 0.5f * (float)m_tilesY );
+	if( tileX < 0.f || tileX >= (float)m_tilesX || tileY < 0.f || tileY >= (float)m_tilesY ) {
+		return -1;
+	}
+	return GetClusterIndex( (int)tileX, (int)tileY, slice );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Two points on the ray through ( ndcX, ndcY ), then the one at the wanted depth. Clip w is linear in view space, so
+// this holds for off-center projections (every headset eye) as well.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+Vec3 LightClusterGrid::GetViewPositionAt( float ndcX, float ndcY, float depth ) const
+{
+	Vec4 nearPoint = m_clipToView.TransformHomogeneousPoint3D( Vec4( ndcX, ndcY, 0.f, 1.f ) );
+	Vec4 midPoint = m_clipToView.TransformHomogeneousPoint3D( Vec4( ndcX, ndcY, 0.5f, 1.f ) );
+	nearPoint /= nearPoint.w;
+	midPoint /= midPoint.w;
+
+	Vec3 start( nearPoint.x, nearPoint.y, nearPoint.z );
+	Vec3 end( midPoint.x, midPoint.y, midPoint.z );
+	float startDepth = GetDepth( start );
+	float endDepth = GetDepth( end );
+	return start + ( end - start ) * ( ( depth - startDepth ) / ( endDepth - startDepth ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::BuildClusterBounds()
+{
+	int numClusters = GetNumClusters();
+	int numRows = m_numSlices * m_tilesY;
+	m_sliceScale = (float)m_numSlices / logf( m_farDepth / m_nearDepth );
+
+	m_centerX.resize( numClusters );
+	m_centerY.resize( numClusters );
+	m_centerZ.resize( numClusters );
+	m_extentX.resize( numClusters );
+	m_extentY.resize( numClusters );
+	m_extentZ.resize( numClusters );
+	m_radius.resize( numClusters );
+	m_rowCenters.resize( numRows );
+	m_rowExtents.resize( numRows );
+	m_sliceCenters.resize( m_numSlices );
+	m_sliceExtents.resize( m_numSlices );
+	m_sliceOutputs.resize( m_numSlices );
+	m_clusterRanges.resize( numClusters );
+
+	// tile corners on both depth planes of a slice, shared by neighboring clusters
+	int cornersPerPlane = ( m_tilesX + 1 ) * ( m_tilesY + 1 );
+	std::vector<Vec3> corners( 2 * cornersPerPlane );
+
+	for( int slice = 0; slice < m_numSlices; ++slice )
+	{
+		float depths[2] = { GetSliceNearDepth( m_nearDepth, m_farDepth, slice, m_numSlices ), GetSliceNearDepth( m_nearDepth, m_farDepth, slice + 1, m_numSlices ) };
+		for( int plane = 0; plane < 2; ++plane ) {
+			for( int cornerY = 0; cornerY <= m_tilesY; ++cornerY ) {
+				for( int cornerX = 0; cornerX <= m_tilesX; ++cornerX ) {
+					float ndcX = -1.f + 2.f * (float)cornerX / (float)m_tilesX;
+					float ndcY = -1.f + 2.f * (float)cornerY / (float)m_tilesY;
+					corners[plane * cornersPerPlane + cornerY * ( m_tilesX + 1 ) + cornerX] = GetViewPositionAt( ndcX, ndcY, depths[plane] );
+				}
+			}
+		}
+
+		Vec3 sliceMins( FLT_MAX, FLT_MAX, FLT_MAX );
+		Vec3 sliceMaxs( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+		for( int tileY = 0; tileY < m_tilesY; ++tileY )
+		{
+			Vec3 rowMins( FLT_MAX, FLT_MAX, FLT_MAX );
+			Vec3 rowMaxs( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+			for( int tileX = 0; tileX < m_tilesX; ++tileX )
+			{
+				Vec3 mins( FLT_MAX, FLT_MAX, FLT_MAX );
+				Vec3 maxs( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+				for( int plane = 0; plane < 2; ++plane ) {
+					for( int cornerIdx = 0; cornerIdx < 4; ++cornerIdx ) {
+						int cornerX = tileX + ( cornerIdx & 1 );
+						int cornerY = tileY + ( cornerIdx >> 1 );
+						StretchBounds( mins, maxs, corners[plane * cornersPerPlane + cornerY * ( m_tilesX + 1 ) + cornerX] );
+					}
+				}
+
+				Vec3 center = ( mins + maxs ) * 0.5f;
+				Vec3 extent = ( maxs - mins ) * 0.5f;
+				int clusterIdx = GetClusterIndex( tileX, tileY, slice );
+				m_centerX[clusterIdx] = center.x;
+				m_centerY[clusterIdx] = center.y;
+				m_centerZ[clusterIdx] = center.z;
+				m_extentX[clusterIdx] = extent.x;
+				m_extentY[clusterIdx] = extent.y;
+				m_extentZ[clusterIdx] = extent.z;
+				m_radius[clusterIdx] = extent.GetLength();
+
+				StretchBounds( rowMins, rowMaxs, mins );
+				StretchBounds( rowMins, rowMaxs, maxs );
+			}
+
+			int rowIdx = slice * m_tilesY + tileY;
+			m_rowCenters[rowIdx] = ( rowMins + rowMaxs ) * 0.5f;
+			m_rowExtents[rowIdx] = ( rowMaxs - rowMins ) * 0.5f;
+			StretchBounds( sliceMins, sliceMaxs, rowMins );
+			StretchBounds( sliceMins, sliceMaxs, rowMaxs );
+		}
+
+		m_sliceCenters[slice] = ( sliceMins + sliceMaxs ) * 0.5f;
+		m_sliceExtents[slice] = ( sliceMaxs - sliceMins ) * 0.5f;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::Build( Mat44 const& worldToView, std::vector<light_t> const& lights, int numThreads, float cutoff )
+{
+#if defined( LIGHT_CLUSTERS_USE_SSE )
+	BuildInternal( worldToView, lights, numThreads, cutoff, true );
+#else
+	BuildInternal( worldToView, lights, numThreads, cutoff, false );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::BuildScalar( Mat44 const& worldToView, std::vector<light_t> const& lights, int numThreads, float cutoff )
+{
+	BuildInternal( worldToView, lights, numThreads, cutoff, false );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class LightClusterSlicesJob : public Job
+{
+public:
+	LightClusterSlicesJob( LightClusterGrid* grid, int firstSlice, int sliceStep, bool useSIMD, std::atomic<int>* numGroupsLeft )
+		: Job(),
+		m_grid( grid ),
+		m_firstSlice( firstSlice ),
+		m_sliceStep( sliceStep ),
+		m_useSIMD( useSIMD ),
+		m_numGroupsLeft( numGroupsLeft )
+	{
+		m_jobFlags = JOB_FLAG_DELETE_ON_COMPLETE;
+	}
+
+	virtual void Execute() override
+	{
+		m_grid->BinSlices( m_firstSlice, m_sliceStep, m_useSIMD );
+		m_numGroupsLeft->fetch_sub( 1 );	// BuildInternal compacts the slices once every group has checked in
+	}
+
+	virtual void OnCompleteCallback() override
+	{
+	}
+
+public:
+	LightClusterGrid*	m_grid = nullptr;
+	int					m_firstSlice = 0;
+	int					m_sliceStep = 1;
+	bool				m_useSIMD = false;
+	std::atomic<int>*	m_numGroupsLeft = nullptr;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::BuildInternal( Mat44 const& worldToView, std::vector<light_t> const& lights, int numThreads, float cutoff, bool useSIMD )
+{
+	GatherLights( worldToView, lights, cutoff );
+
+	// slices are dealt out round-robin: the near ones are small and the far ones hold most lights
+	bool useWorkers = g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning();
+	int numGroups = useWorkers ? Clamp( numThreads, 1, m_numSlices ) : 1;
+	std::atomic<int> numGroupsLeft( numGroups - 1 );
+	for( int groupIdx = 1; groupIdx < numGroups; ++groupIdx ) {
+		g_theJobSystem->PostJob( new LightClusterSlicesJob( this, groupIdx, numGroups, useSIMD, &numGroupsLeft ) );
+	}
+	BinSlices( 0, numGroups, useSIMD );
+	while( numGroupsLeft.load() > 0 ) {
+		std::this_thread::yield();
+	}
+
+	CompactSlices();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::GatherLights( Mat44 const& worldToView, std::vector<light_t> const& lights, float cutoff )
+{
+	m_lights.clear();
+	m_packedLights.clear();
+	m_packedSources.clear();
+	m_stats = LightClusterStats();
+	m_stats.m_numInputLights = (int)lights.size();
+
+	float depthScale = m_depthAxis.GetLength();
+	for( size_t lightIdx = 0; lightIdx < lights.size(); ++lightIdx )
+	{
+		light_t const& light = lights[lightIdx];
+		if( light.direction_factor != 0.f ) {
+			continue;
+		}
+		float range = GetLightRange( light, cutoff );
+		if( range <= 0.f ) {
+			continue;
+		}
+
+		ClusteredLight clustered;
+		clustered.m_position = worldToView.TransformPosition3D( light.position );
+		clustered.m_radius = range;
+
+		float depth = GetDepth( clustered.m_position );
+		float depthExtent = range * depthScale;
+		if( depth + depthExtent < m_nearDepth || depth - depthExtent >= m_farDepth ) {
+			continue;
+		}
+		clustered.m_firstSlice = depth - depthExtent < m_nearDepth ? 0 : GetSliceForDepth( depth - depthExtent );
+		clustered.m_lastSlice = depth + depthExtent >= m_farDepth ? m_numSlices - 1 : GetSliceForDepth( depth + depthExtent );
+
+		// past a right angle the cone test no longer bounds anything; such lights are treated as point lights
+		if( light.dot_outer_angle > 0.f && light.dot_outer_angle < 1.f ) {
+			clustered.m_isSpot = true;
+			clustered.m_direction = worldToView.TransformVector3D( light.direction ).GetNormalized();
+			clustered.m_cosOuterAngle = light.dot_outer_angle;
+			clustered.m_sinOuterAngle = sqrtf( 1.f - light.dot_outer_angle * light.dot_outer_angle );
+		}
+
+		// packed only if it reaches any slice, so the GPU never fetches a light no cluster points at
+		bool isInsideGrid = false;
+		for( int slice = clustered.m_firstSlice; slice <= clustered.m_lastSlice && !isInsideGrid; ++slice ) {
+			isInsideGrid = IsSphereTouchingBox( m_sliceCenters[slice], m_sliceExtents[slice], clustered.m_position, clustered.m_radius );
+		}
+		if( !isInsideGrid ) {
+			continue;
+		}
+
+		m_lights.push_back( clustered );
+		m_packedLights.push_back( light );
+		m_packedSources.push_back( (uint)lightIdx );
+	}
+	m_stats.m_numPackedLights = (int)m_packedLights.size();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::BinSlices( int firstSlice, int sliceStep, bool useSIMD )
+{
+	for( int slice = firstSlice; slice < m_numSlices; slice += sliceStep ) {
+		BinSlice( slice, useSIMD );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::BinSlice( int slice, bool useSIMD )
+{
+	SliceOutput& output = m_sliceOutputs[slice];
+	output.m_hitClusters.clear();
+	output.m_hitLights.clear();
+	output.m_counts.assign( m_tilesX * m_tilesY, 0 );
+
+#if defined( LIGHT_CLUSTERS_USE_SSE )
+	__m128 zero = _mm_setzero_ps();
+	__m128 signMask = _mm_set1_ps( -0.f );
+#else
+	UNUSED( useSIMD );
+#endif
+
+	for( int lightIdx = 0; lightIdx < (int)m_lights.size(); ++lightIdx )
+	{
+		ClusteredLight const& light = m_lights[lightIdx];
+		if( slice < light.m_firstSlice || slice > light.m_lastSlice ) {
+			continue;
+		}
+		if( !IsSphereTouchingBox( m_sliceCenters[slice], m_sliceExtents[slice], light.m_position, light.m_radius ) ) {
+			continue;
+		}
+
+		for( int tileY = 0; tileY < m_tilesY; ++tileY )
+		{
+			int rowIdx = slice * m_tilesY + tileY;
+			if( !IsSphereTouchingBox( m_rowCenters[rowIdx], m_rowExtents[rowIdx], light.m_position, light.m_radius ) ) {
+				continue;
+			}
+
+			int rowStart = rowIdx * m_tilesX;
+			int tileX = 0;
+
+#if defined( LIGHT_CLUSTERS_USE_SSE )
+			if( useSIMD )
+			{
+				__m128 lightX = _mm_set1_ps( light.m_position.x );
+				__m128 lightY = _mm_set1_ps( light.m_position.y );
+				__m128 lightZ = _mm_set1_ps( light.m_position.z );
+				__m128 radiusSquared = _mm_set1_ps( light.m_radius * light.m_radius );
+				__m128 directionX = _mm_set1_ps( light.m_direction.x );
+				__m128 directionY = _mm_set1_ps( light.m_direction.y );
+				__m128 directionZ = _mm_set1_ps( light.m_direction.z );
+				__m128 cosAngle = _mm_set1_ps( light.m_cosOuterAngle );
+				__m128 sinAngle = _mm_set1_ps( light.m_sinOuterAngle );
+				__m128 range = _mm_set1_ps( light.m_radius );
+
+				for( ; tileX + 4 <= m_tilesX; tileX += 4 )
+				{
+					int clusterIdx = rowStart + tileX;
+					__m128 centerX = _mm_loadu_ps( &m_centerX[clusterIdx] );
+					__m128 centerY = _mm_loadu_ps( &m_centerY[clusterIdx] );
+					__m128 centerZ = _mm_loadu_ps( &m_centerZ[clusterIdx] );
+
+					__m128 dx = _mm_max_ps( _mm_sub_ps( _mm_andnot_ps( signMask, _mm_sub_ps( centerX, lightX ) ), _mm_loadu_ps( &m_extentX[clusterIdx] ) ), zero );
+					__m128 dy = _mm_max_ps( _mm_sub_ps( _mm_andnot_ps( signMask, _mm_sub_ps( centerY, lightY ) ), _mm_loadu_ps( &m_extentY[clusterIdx] ) ), zero );
+					__m128 dz = _mm_max_ps( _mm_sub_ps( _mm_andnot_ps( signMask, _mm_sub_ps( centerZ, lightZ ) ), _mm_loadu_ps( &m_extentZ[clusterIdx] ) ), zero );
+					__m128 distanceSquared = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+					__m128 isTouching = _mm_cmple_ps( distanceSquared, radiusSquared );
+
+					if( light.m_isSpot && _mm_movemask_ps( isTouching ) != 0 )
+					{
+						__m128 sphereRadius = _mm_loadu_ps( &m_radius[clusterIdx] );
+						__m128 vx = _mm_sub_ps( centerX, lightX );
+						__m128 vy = _mm_sub_ps( centerY, lightY );
+						__m128 vz = _mm_sub_ps( centerZ, lightZ );
+						__m128 lengthSquared = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, vx ), _mm_mul_ps( vy, vy ) ), _mm_mul_ps( vz, vz ) );
+						__m128 alongAxis = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, directionX ), _mm_mul_ps( vy, directionY ) ), _mm_mul_ps( vz, directionZ ) );
+						__m128 perpendicular = _mm_sqrt_ps( _mm_max_ps( _mm_sub_ps( lengthSquared, _mm_mul_ps( alongAxis, alongAxis ) ), zero ) );
+						__m128 closest = _mm_sub_ps( _mm_mul_ps( cosAngle, perpendicular ), _mm_mul_ps( alongAxis, sinAngle ) );
+						__m128 isOutside = _mm_or_ps( _mm_cmpgt_ps( closest, sphereRadius ),
+							_mm_or_ps( _mm_cmpgt_ps( alongAxis, _mm_add_ps( sphereRadius, range ) ), _mm_cmplt_ps( alongAxis, _mm_xor_ps( sphereRadius, signMask ) ) ) );
+						isTouching = _mm_andnot_ps( isOutside, isTouching );
+					}
+
+					int touchingMask = _mm_movemask_ps( isTouching );
+					for( int lane = 0; lane < 4; ++lane )
+					{
+						if( touchingMask & ( 1 << lane ) )
+						{
+							uint clusterInSlice = (uint)( tileY * m_tilesX + tileX + lane );
+							output.m_hitClusters.push_back( clusterInSlice );
+							output.m_hitLights.push_back( (uint)lightIdx );
+							++output.m_counts[clusterInSlice];
+						}
+					}
+				}
+			}
+#endif
+
+			for( ; tileX < m_tilesX; ++tileX )
+			{
+				int clusterIdx = rowStart + tileX;
+				bool isTouching = IsSphereTouchingBox( m_centerX[clusterIdx], m_centerY[clusterIdx], m_centerZ[clusterIdx],
+					m_extentX[clusterIdx], m_extentY[clusterIdx], m_extentZ[clusterIdx], light.m_position.x, light.m_position.y, light.m_position.z, light.m_radius );
+				if( isTouching && light.m_isSpot ) {
+					isTouching = IsConeTouchingSphere( m_centerX[clusterIdx], m_centerY[clusterIdx], m_centerZ[clusterIdx], m_radius[clusterIdx],
+						light.m_position, light.m_direction, light.m_cosOuterAngle, light.m_sinOuterAngle, light.m_radius );
+				}
+				if( isTouching )
+				{
+					uint clusterInSlice = (uint)( tileY * m_tilesX + tileX );
+					output.m_hitClusters.push_back( clusterInSlice );
+					output.m_hitLights.push_back( (uint)lightIdx );
+					++output.m_counts[clusterInSlice];
+				}
+			}
+		}
+	}
+
+	// counting sort by cluster; hits were found in light order, so each cluster's list stays sorted by light
+	output.m_cursors.resize( output.m_counts.size() );
+	uint offset = 0;
+	for( size_t clusterInSlice = 0; clusterInSlice < output.m_counts.size(); ++clusterInSlice ) {
+		output.m_cursors[clusterInSlice] = offset;
+		offset += output.m_counts[clusterInSlice];
+	}
+	output.m_indices.resize( offset );
+	for( size_t hitIdx = 0; hitIdx < output.m_hitClusters.size(); ++hitIdx ) {
+		output.m_indices[output.m_cursors[output.m_hitClusters[hitIdx]]++] = output.m_hitLights[hitIdx];
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LightClusterGrid::CompactSlices()
+{
+	size_t numIndices = 0;
+	for( SliceOutput const& output : m_sliceOutputs ) {
+		numIndices += output.m_indices.size();
+	}
+	m_lightIndices.resize( numIndices );
+
+	uint offset = 0;
+	int clustersPerSlice = m_tilesX * m_tilesY;
+	for( int slice = 0; slice < m_numSlices; ++slice )
+	{
+		SliceOutput const& output = m_sliceOutputs[slice];
+		if( !output.m_indices.empty() ) {
+			memcpy( &m_lightIndices[offset], output.m_indices.data(), output.m_indices.size() * sizeof( uint ) );
+		}
+
+		for( int clusterInSlice = 0; clusterInSlice < clustersPerSlice; ++clusterInSlice )
+		{
+			LightClusterRange& range = m_clusterRanges[slice * clustersPerSlice + clusterInSlice];
+			range.m_offset = offset;
+			range.m_count = output.m_counts[clusterInSlice];
+			offset += range.m_count;
+
+			m_stats.m_numOccupiedClusters += range.m_count > 0 ? 1 : 0;
+			m_stats.m_maxLightsPerCluster = std::max( m_stats.m_maxLightsPerCluster, (int)range.m_count );
+		}
+	}
+	m_stats.m_numIndices = (int)numIndices;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// CPU-only clustering benchmark: the same headset-like eye pair as benchmark_culling, with random point and spot lights
+// scattered down the view. Times the scalar and SSE kernels on one thread and SSE spread over the job workers, checks
+// all three produce the same lists, and checks no light reaching a random point is missing from that point's cluster.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static Mat44 MakeBenchmarkEyeProjection()
+{
+	float const fovDegrees = 110.f;
+	float const aspect = 0.9f;
+	float const nearZ = 0.05f;
+	float const farZ = 100.f;
+
+	// Right-handed, depth 0 at nearZ and 1 at farZ (what OpenVR hands back for D3D)
+	float height = 1.f / tanf( ConvertDegreesToRadians( fovDegrees * 0.5f ) );
+	float q = farZ / ( nearZ - farZ );
+	float projection[] = {
+		height / aspect,	0.f,		0.f,				0.f,
+		0.f,				height,		0.f,				0.f,
+		0.f,				0.f,		q,					-1.f,
+		0.f,				0.f,		nearZ * q,			0.f
+	};
+	return Mat44( projection );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static bool DoGridsMatch( LightClusterGrid const& a, LightClusterGrid const& b )
+{
+	if( a.GetLightIndices() != b.GetLightIndices() || a.GetPackedLightSources() != b.GetPackedLightSources() ) {
+		return false;
+	}
+	for( int clusterIdx = 0; clusterIdx < a.GetNumClusters(); ++clusterIdx ) {
+		LightClusterRange const& rangeA = a.GetClusterRanges()[clusterIdx];
+		LightClusterRange const& rangeB = b.GetClusterRanges()[clusterIdx];
+		if( rangeA.m_offset != rangeB.m_offset || rangeA.m_count != rangeB.m_count ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Samples points inside the grid and counts lights that reach one but are not in its cluster's list
+static int CountMissedLights( LightClusterGrid const& grid, Mat44 const& worldToView, std::vector<light_t> const& lights, int numSamples, RandomNumberGenerator& rng )
+{
+	std::vector<int> packedIndexOfSource( lights.size(), -1 );
+	std::vector<uint> const& sources = grid.GetPackedLightSources();
+	for( size_t packedIdx = 0; packedIdx < sources.size(); ++packedIdx ) {
+		packedIndexOfSource[sources[packedIdx]] = (int)packedIdx;
+	}
+
+	int numMissed = 0;
+	for( int sampleIdx = 0; sampleIdx < numSamples; ++sampleIdx )
+	{
+		float depth = 0.05f * powf( 100.f / 0.05f, rng.RollRandomFloatZeroToAlmostOne() );
+		Vec3 point = grid.GetViewPositionAt( rng.RollRandomFloatInRange( -0.999f, 0.999f ), rng.RollRandomFloatInRange( -0.999f, 0.999f ), depth );
+		int clusterIdx = grid.GetClusterIndexForViewPosition( point );
+		if( clusterIdx < 0 ) {
+			continue;
+		}
+		LightClusterRange const& range = grid.GetClusterRanges()[clusterIdx];
+
+		for( size_t lightIdx = 0; lightIdx < lights.size(); ++lightIdx )
+		{
+			light_t const& light = lights[lightIdx];
+			Vec3 toPoint = point - worldToView.TransformPosition3D( light.position );
+			float distance = toPoint.GetLength();
+			if( distance >= 0.999f * GetLightRange( light ) ) {
+				continue;
+			}
+			if( light.dot_outer_angle > -1.f && distance > 0.f ) {
+				Vec3 direction = worldToView.TransformVector3D( light.direction ).GetNormalized();
+				if( DotProduct( toPoint / distance, direction ) < light.dot_outer_angle + 0.001f ) {
+					continue;
+				}
+			}
+
+			bool isListed = false;
+			for( uint entry = range.m_offset; entry < range.m_offset + range.m_count && !isListed; ++entry ) {
+				isListed = (int)grid.GetLightIndices()[entry] == packedIndexOfSource[lightIdx];
+			}
+			numMissed += isListed ? 0 : 1;
+		}
+	}
+	return numMissed;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static void RunLightClusterBenchmark( int numLights, int numIterations, int numThreads )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 1234 );
+	std::vector<light_t> lights( numLights );
+	int numSpotLights = 0;
+	for( light_t& light : lights )
+	{
+		// muzzle flash to lamp sized: quadratic falloff reaching 2-10 units
+		light.color = Vec3( rng.RollRandomFloatInRange( 0.5f, 1.f ), rng.RollRandomFloatInRange( 0.5f, 1.f ), rng.RollRandomFloatInRange( 0.5f, 1.f ) );
+		light.intensity = rng.RollRandomFloatInRange( 0.02f, 0.4f );
+		light.position = Vec3( rng.RollRandomFloatInRange( -40.f, 40.f ), rng.RollRandomFloatInRange( -20.f, 20.f ), rng.RollRandomFloatInRange( -100.f, 5.f ) );
+		light.attenuation = Vec3( 0.f, 0.f, 1.f );
+		if( rng.RollRandomIntLessThan( 4 ) == 0 ) {
+			Vec3 direction( rng.RollRandomFloatInRange( -1.f, 1.f ), rng.RollRandomFloatInRange( -1.f, 1.f ), rng.RollRandomFloatInRange( -1.f, 1.f ) );
+			light.direction = direction.GetLengthSquared() > 0.0001f ? direction.GetNormalized() : Vec3( 0.f, 0.f, -1.f );
+			light.dot_outer_angle = CosDegrees( rng.RollRandomFloatInRange( 15.f, 45.f ) );
+			light.dot_inner_angle = light.dot_outer_angle;
+			++numSpotLights;
+		}
+	}
+
+	Mat44 projection = MakeBenchmarkEyeProjection();
+	Mat44 leftView = Mat44::CreateTranslation3D( Vec3( 0.032f, 0.f, 0.f ) );
+	Mat44 rightView = Mat44::CreateTranslation3D( Vec3( -0.032f, 0.f, 0.f ) );
+
+	LightClusterGrid grids[3][2];
+	for( int config = 0; config < 3; ++config ) {
+		for( int eye = 0; eye < 2; ++eye ) {
+			grids[config][eye].SetProjection( projection, 0.05f, 100.f );
+		}
+	}
+
+	double seconds[3] = {};
+	for( int config = 0; config < 3; ++config )
+	{
+		double startSeconds = GetCurrentTimeSeconds();
+		for( int iteration = 0; iteration < numIterations; ++iteration )
+		{
+			if( config == 0 ) {
+				grids[config][0].BuildScalar( leftView, lights );
+				grids[config][1].BuildScalar( rightView, lights );
+			}
+			else {
+				int threads = config == 1 ? 1 : numThreads;
+				grids[config][0].Build( leftView, lights, threads );
+				grids[config][1].Build( rightView, lights, threads );
+			}
+		}
+		seconds[config] = GetCurrentTimeSeconds() - startSeconds;
+	}
+
+	bool doPathsAgree = true;
+	for( int eye = 0; eye < 2; ++eye ) {
+		doPathsAgree = doPathsAgree && DoGridsMatch( grids[0][eye], grids[1][eye] ) && DoGridsMatch( grids[0][eye], grids[2][eye] );
+	}
+	int numMissed = CountMissedLights( grids[2][0], leftView, lights, 2000, rng ) + CountMissedLights( grids[2][1], rightView, lights, 2000, rng );
+
+	LightClusterGrid const& left = grids[2][0];
+	LightClusterStats const& stats = left.GetStats();
+	double usPerEye = 1e6 / ( 2.0 * (double)numIterations );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Light clustering, %i lights (%i spot), %ix%ix%i clusters x 2 eyes x %i iterations (us per eye)",
+		numLights, numSpotLights, LIGHT_CLUSTER_DEFAULT_TILES_X, LIGHT_CLUSTER_DEFAULT_TILES_Y, LIGHT_CLUSTER_DEFAULT_SLICES, numIterations ) );
+	bool areWorkersRunning = g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning();
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  scalar 1 thread %.1f  SIMD 1 thread %.1f  SIMD %i groups %.1f (%s)",
+		seconds[0] * usPerEye, seconds[1] * usPerEye, numThreads, seconds[2] * usPerEye, areWorkersRunning ? "on job workers" : "no job workers running, runs inline" ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  left eye: %i lights packed, %i indices, %i of %i clusters lit, at most %i per cluster",
+		stats.m_numPackedLights, stats.m_numIndices, stats.m_numOccupiedClusters, left.GetNumClusters(), stats.m_maxLightsPerCluster ) );
+
+	Rgba8 resultColor = doPathsAgree && numMissed == 0 ? Rgba8::GREEN : Rgba8::RED;
+	g_theConsole->PrintString( resultColor, Stringf( "  SIMD and threaded match scalar: %s, lights missing from sampled clusters: %i", doPathsAgree ? "yes" : "NO", numMissed ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_light_clusters, "lights,iterations,threads" )
+{
+	int numLights = args.GetValue( "lights", 0 );
+	int numIterations = args.GetValue( "iterations", 100 );
+	int numWorkers = g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning() ? (int)g_theJobSystem->m_workerThreads.size() : 0;
+	int numThreads = args.GetValue( "threads", numWorkers + 1 );
+	if( numLights < 0 || numIterations <= 0 || numThreads <= 0 ) {
+		g_theConsole->Error( "benchmark_light_clusters: lights must not be negative, iterations and threads must be positive" );
+		return;
+	}
+
+	// no count given: the two sizes we budget for
+	if( numLights == 0 ) {
+		RunLightClusterBenchmark( 256, numIterations, numThreads );
+		RunLightClusterBenchmark( 1024, numIterations, numThreads );
+	}
+	else {
+		RunLightClusterBenchmark( numLights, numIterations, numThreads );
+	}
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Nearest point to p inside a convex cell, the cell given as half-spaces dot( normal, x ) <= distance with unit
+// normals. Dykstra's alternating projections: converges on the exact answer, which the grid's box tests only bound.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static Vec3 GetNearestPointInCell( Vec3 const& point, Vec3 const* normals, float const* distances, int numPlanes, int numIterations )
+{
+	Vec3 nearest = point;
+	Vec3 corrections[6];
+	for( int iteration = 0; iteration < numIterations; ++iteration ) {
+		for( int planeIdx = 0; planeIdx < numPlanes; ++planeIdx ) {
+			Vec3 shifted = nearest + corrections[planeIdx];
+			float excess = DotProduct( normals[planeIdx], shifted ) - distances[planeIdx];
+			nearest = excess > 0.f ? shifted - normals[planeIdx] * excess : shifted;
+			corrections[planeIdx] = shifted - nearest;
+		}
+	}
+	return nearest;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Every cluster's frustum cell rebuilt from its eight corners and tested against every light by brute force. A point
+// light whose sphere reaches into the cell must be listed; a listed light of either kind must at least reach the
+// cell's bounding box, which is all the grid claims to test. SIMD and scalar builds must agree.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+UNIT_TEST( LightClustersMatchBruteForceFrustumTest, "Renderer" )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( 4321 );
+	std::vector<light_t> lights( 96 );
+	for( light_t& light : lights ) {
+		light.color = Vec3( 1.f, rng.RollRandomFloatInRange( 0.5f, 1.f ), rng.RollRandomFloatInRange( 0.5f, 1.f ) );
+		light.intensity = rng.RollRandomFloatInRange( 0.005f, 0.1f );
+		light.position = Vec3( rng.RollRandomFloatInRange( -10.f, 10.f ), rng.RollRandomFloatInRange( -8.f, 8.f ), rng.RollRandomFloatInRange( -32.f, 2.f ) );
+		light.attenuation = Vec3( 0.f, 0.f, 1.f );
+		if( rng.RollRandomIntLessThan( 4 ) == 0 ) {
+			Vec3 direction( rng.RollRandomFloatInRange( -1.f, 1.f ), rng.RollRandomFloatInRange( -1.f, 1.f ), rng.RollRandomFloatInRange( -1.f, 1.f ) );
+			light.direction = direction.GetLengthSquared() > 0.0001f ? direction.GetNormalized() : Vec3( 0.f, 0.f, -1.f );
+			light.dot_outer_angle = CosDegrees( rng.RollRandomFloatInRange( 15.f, 60.f ) );
+			light.dot_inner_angle = light.dot_outer_angle;
+		}
+	}
+
+	Mat44 worldToView = Mat44::CreateTranslation3D( Vec3( 0.032f, 0.f, 0.f ) );
+	LightClusterGrid grid;
+	LightClusterGrid scalarGrid;
+	grid.SetDimensions( 8, 6, 12 );
+	scalarGrid.SetDimensions( 8, 6, 12 );
+	grid.SetProjection( MakeBenchmarkEyeProjection(), 0.1f, 30.f );
+	scalarGrid.SetProjection( MakeBenchmarkEyeProjection(), 0.1f, 30.f );
+	grid.Build( worldToView, lights );
+	scalarGrid.BuildScalar( worldToView, lights );
+	UNIT_TEST_CHECK_MSG( DoGridsMatch( grid, scalarGrid ), "SIMD and scalar builds gave different lists" );
+
+	std::vector<int> packedIndexOfSource( lights.size(), -1 );
+	std::vector<uint> const& sources = grid.GetPackedLightSources();
+	for( size_t packedIdx = 0; packedIdx < sources.size(); ++packedIdx ) {
+		packedIndexOfSource[sources[packedIdx]] = (int)packedIdx;
+	}
+
+	int numRequired = 0;
+	int numMissed = 0;
+	int numListed = 0;
+	int numUnbounded = 0;
+	for( int slice = 0; slice < grid.GetNumSlices(); ++slice ) {
+		float depths[2] = { GetSliceNearDepth( 0.1f, 30.f, slice, grid.GetNumSlices() ), GetSliceNearDepth( 0.1f, 30.f, slice + 1, grid.GetNumSlices() ) };
+		for( int tileY = 0; tileY < grid.GetTilesY(); ++tileY ) {
+			for( int tileX = 0; tileX < grid.GetTilesX(); ++tileX ) {
+				// corner index bits: x, y, depth
+				Vec3 corners[8];
+				Vec3 mins( FLT_MAX, FLT_MAX, FLT_MAX );
+				Vec3 maxs( -FLT_MAX, -FLT_MAX, -FLT_MAX );
+				Vec3 centroid;
+				for( int cornerIdx = 0; cornerIdx < 8; ++cornerIdx ) {
+					float ndcX = -1.f + 2.f * (float)( tileX + ( cornerIdx & 1 ) ) / (float)grid.GetTilesX();
+					float ndcY = -1.f + 2.f * (float)( tileY + ( ( cornerIdx >> 1 ) & 1 ) ) / (float)grid.GetTilesY();
+					corners[cornerIdx] = grid.GetViewPositionAt( ndcX, ndcY, depths[cornerIdx >> 2] );
+					StretchBounds( mins, maxs, corners[cornerIdx] );
+					centroid += corners[cornerIdx] * 0.125f;
+				}
+
+				// each face as a quad in winding order; the normal from its diagonals, turned to face out
+				static int const faces[6][4] = { { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 5, 7, 6 } };
+				Vec3 normals[6];
+				float distances[6];
+				for( int faceIdx = 0; faceIdx < 6; ++faceIdx ) {
+					Vec3 const* quad[4] = { &corners[faces[faceIdx][0]], &corners[faces[faceIdx][1]], &corners[faces[faceIdx][2]], &corners[faces[faceIdx][3]] };
+					Vec3 normal = CrossProduct( *quad[2] - *quad[0], *quad[3] - *quad[1] ).GetNormalized();
+					Vec3 faceCenter = ( *quad[0] + *quad[1] + *quad[2] + *quad[3] ) * 0.25f;
+					if( DotProduct( normal, centroid - faceCenter ) > 0.f ) {
+						normal = -normal;
+					}
+					normals[faceIdx] = normal;
+					distances[faceIdx] = DotProduct( normal, faceCenter );
+				}
+
+				LightClusterRange const& range = grid.GetClusterRanges()[grid.GetClusterIndex( tileX, tileY, slice )];
+				for( size_t lightIdx = 0; lightIdx < lights.size(); ++lightIdx ) {
+					light_t const& light = lights[lightIdx];
+					Vec3 center = worldToView.TransformPosition3D( light.position );
+					float radius = GetLightRange( light );
+
+					Vec3 boxExtent = ( maxs - mins ) * 0.5f;
+					bool isTouchingBox = IsSphereTouchingBox( ( mins + maxs ) * 0.5f, boxExtent, center, radius * 1.001f + 0.0001f );
+
+					bool isListed = false;
+					for( uint entry = range.m_offset; entry < range.m_offset + range.m_count && !isListed; ++entry ) {
+						isListed = (int)grid.GetLightIndices()[entry] == packedIndexOfSource[lightIdx];
+					}
+					numListed += isListed ? 1 : 0;
+					numUnbounded += isListed && !isTouchingBox ? 1 : 0;
+
+					// the box holds the cell, so a sphere missing the box misses the cell too
+					bool isPointLight = light.dot_outer_angle <= -1.f;
+					if( !isPointLight || !isTouchingBox ) {
+						continue;
+					}
+					Vec3 nearest = GetNearestPointInCell( center, normals, distances, 6, 100 );
+					if( ( nearest - center ).GetLength() < 0.999f * radius ) {
+						++numRequired;
+						numMissed += isListed ? 0 : 1;
+					}
+				}
+			}
+		}
+	}
+
+	UNIT_TEST_CHECK_MSG( numRequired > 200, Stringf( "only %i light-cluster overlaps; the scene no longer exercises the grid", numRequired ) );
+	UNIT_TEST_CHECK_MSG( numMissed == 0, Stringf( "%i of %i point lights reaching a cluster's frustum were not listed", numMissed, numRequired ) );
+	UNIT_TEST_CHECK_MSG( numUnbounded == 0, Stringf( "%i of %i listed lights miss the cluster's bounding box", numUnbounded, numListed ) );
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+typedef unsigned int uint;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct light_t;
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+
+constexpr int	LIGHT_CLUSTER_DEFAULT_TILES_X = 16;
+constexpr int	LIGHT_CLUSTER_DEFAULT_TILES_Y = 16;
+constexpr int	LIGHT_CLUSTER_DEFAULT_SLICES = 24;
+constexpr float	LIGHT_CLUSTER_DEFAULT_CUTOFF = 1.f / 256.f;		// one step of an 8-bit channel
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Distance at which a point or spot light's attenuated intensity drops below cutoff; 0 if it never reaches it, and
+// FLT_MAX for lights with constant attenuation only.
+float GetLightRange( light_t const& light, float cutoff = LIGHT_CLUSTER_DEFAULT_CUTOFF );
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct LightClusterRange
+{
+	uint	m_offset = 0;		// first entry in the light index list
+	uint	m_count = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct LightClusterStats
+{
+	int		m_numInputLights = 0;
+	int		m_numPackedLights = 0;		// lights touching the grid at all
+	int		m_numIndices = 0;
+	int		m_numOccupiedClusters = 0;
+	int		m_maxLightsPerCluster = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Bins point and spot lights into a froxel grid of one eye's view: tiles across the screen, slices exponentially
+// spaced in depth between a near and far distance. Each Build produces
+//	- a packed light array: the input lights that touch the grid, in input order, ready to upload as-is
+//	- one range per cluster into a compact list of indices into that packed array
+// so a pixel shades against only the lights of its own cluster instead of a fixed handful for the whole frame.
+// RenderContext::BindLightClusters uploads the result for the lit shaders (Dot3.hlsl looks a pixel's cluster up).
+//
+// Clusters are numbered x fastest, then y (bottom row first), then slice. Depth is the projection's clip w, which for
+// a perspective projection is the distance along the view direction; orthographic projections are not supported.
+// Directional lights light every cluster and are left to the light constants.
+//
+// Lights are tested against a slice's bounds, then each row's, then four clusters at a time (SSE when available),
+// with spot lights also tested cone-vs-sphere. Slices are independent, so Build deals them out to numThreads groups,
+// all but one posted as jobs to the JobSystem workers; without running workers it bins every slice itself. The result
+// is the same for any group count and for the scalar path.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class LightClusterGrid
+{
+	friend class LightClusterSlicesJob;
+
+public:
+	LightClusterGrid();
+	~LightClusterGrid();
+
+	void	SetDimensions( int tilesX, int tilesY, int numSlices );
+
+	// Rebuilds the cluster bounds; only needed when the projection or depth range changes
+	void	SetProjection( Mat44 const& viewToClip, float nearDepth, float farDepth );
+
+	void	Build( Mat44 const& worldToView, std::vector<light_t> const& lights, int numThreads = 1, float cutoff = LIGHT_CLUSTER_DEFAULT_CUTOFF );
+
+	// Plain C++ kernel, for platforms without SSE and for checking the SIMD path
+	void	BuildScalar( Mat44 const& worldToView, std::vector<light_t> const& lights, int numThreads = 1, float cutoff = LIGHT_CLUSTER_DEFAULT_CUTOFF );
+
+	Mat44 const&	GetProjection() const									{ return m_viewToClip; }
+	int		GetTilesX() const												{ return m_tilesX; }
+	int		GetTilesY() const												{ return m_tilesY; }
+	int		GetNumSlices() const											{ return m_numSlices; }
+	float	GetNearDepth() const											{ return m_nearDepth; }
+	float	GetFarDepth() const												{ return m_farDepth; }
+	float	GetSliceScale() const											{ return m_sliceScale; }	// slice = log( depth / near ) * scale
+	int		GetNumClusters() const											{ return m_tilesX * m_tilesY * m_numSlices; }
+	int		GetClusterIndex( int tileX, int tileY, int slice ) const		{ return ( slice * m_tilesY + tileY ) * m_tilesX + tileX; }
+	int		GetSliceForDepth( float depth ) const;							// -1 outside [near, far)
+	int		GetClusterIndexForViewPosition( Vec3 const& viewPosition ) const;	// -1 outside the grid
+	Vec3	GetViewPositionAt( float ndcX, float ndcY, float depth ) const;
+
+	std::vector<light_t> const&				GetPackedLights() const			{ return m_packedLights; }
+	std::vector<uint> const&				GetPackedLightSources() const	{ return m_packedSources; }		// input index of each packed light
+	std::vector<LightClusterRange> const&	GetClusterRanges() const		{ return m_clusterRanges; }
+	std::vector<uint> const&				GetLightIndices() const			{ return m_lightIndices; }
+	LightClusterStats const&				GetStats() const				{ return m_stats; }
+
+private:
+	struct ClusteredLight
+	{
+		Vec3	m_position;			// view space
+		float	m_radius = 0.f;
+		Vec3	m_direction;		// view space, normalized; spot lights only
+		float	m_cosOuterAngle = -1.f;
+		float	m_sinOuterAngle = 0.f;
+		bool	m_isSpot = false;
+		int		m_firstSlice = 0;
+		int		m_lastSlice = 0;
+	};
+
+	// what one slice's worker writes; vectors keep their capacity from build to build
+	struct SliceOutput
+	{
+		std::vector<uint>	m_hitClusters;		// cluster-in-slice of each hit, in light order
+		std::vector<uint>	m_hitLights;		// packed light index of each hit
+		std::vector<uint>	m_counts;			// hits per cluster-in-slice
+		std::vector<uint>	m_cursors;
+		std::vector<uint>	m_indices;			// hits sorted by cluster, then light
+	};
+
+	void	BuildClusterBounds();
+	void	BuildInternal( Mat44 const& worldToView, std::vector<light_t> const& lights, int numThreads, float cutoff, bool useSIMD );
+	void	GatherLights( Mat44 const& worldToView, std::vector<light_t> const& lights, float cutoff );
+	void	BinSlice( int slice, bool useSIMD );
+	void	BinSlices( int firstSlice, int sliceStep, bool useSIMD );
+	void	CompactSlices();
+
+	float	GetDepth( Vec3 const& viewPosition ) const;
+
+private:
+	int		m_tilesX = LIGHT_CLUSTER_DEFAULT_TILES_X;
+	int		m_tilesY = LIGHT_CLUSTER_DEFAULT_TILES_Y;
+	int		m_numSlices = LIGHT_CLUSTER_DEFAULT_SLICES;
+
+	Mat44	m_viewToClip;
+	Mat44	m_clipToView;
+	float	m_nearDepth = 0.1f;
+	float	m_farDepth = 100.f;
+	float	m_sliceScale = 0.f;			// slices per log-unit of depth
+	Vec3	m_depthAxis;				// clip w = dot( m_depthAxis, p ) + m_depthOffset
+	float	m_depthOffset = 0.f;
+
+	// cluster bounds, structure-of-arrays in cluster order; radius is the bounding sphere's for the cone test
+	std::vector<float>	m_centerX;
+	std::vector<float>	m_centerY;
+	std::vector<float>	m_centerZ;
+	std::vector<float>	m_extentX;
+	std::vector<float>	m_extentY;
+	std::vector<float>	m_extentZ;
+	std::vector<float>	m_radius;
+
+	// the same for whole rows (slice * tilesY + y) and whole slices, to skip them early
+	std::vector<Vec3>	m_rowCenters;
+	std::vector<Vec3>	m_rowExtents;
+	std::vector<Vec3>	m_sliceCenters;
+	std::vector<Vec3>	m_sliceExtents;
+
+	// per build
+	std::vector<ClusteredLight>			m_lights;
+	std::vector<SliceOutput>			m_sliceOutputs;
+
+	std::vector<light_t>				m_packedLights;
+	std::vector<uint>					m_packedSources;
+	std::vector<LightClusterRange>		m_clusterRanges;
+	std::vector<uint>					m_lightIndices;
+	LightClusterStats					m_stats;
+};
@@ -0,0 +1,399 @@
+#include "Engine/Renderer/MeshFile.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+#include "Engine/Renderer/MeshOptimizer.hpp"
+#include "Engine/Renderer/MeshUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <cfloat>
+#include <cstddef>
+#include <cstring>
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+AABB3 MeshFileHeader::GetBounds() const
+{
+	return AABB3( Vec3( m_boundsMins[0], m_boundsMins[1], m_boundsMins[2] ), Vec3( m_boundsMaxs[0], m_boundsMaxs[1], m_boundsMaxs[2] ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t AlignMeshFileOffset( size_t offset )
+{
+	return (uint32_t)( ( offset + MESH_FILE_DATA_ALIGNMENT - 1 ) & ~(size_t)( MESH_FILE_DATA_ALIGNMENT - 1 ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+std::string GetCookedMeshPath( char const* sourcePath )
+{
+	// one flat folder: "Data/Models/Cane.obj" becomes "Data_Models_Cane.mesh"
+	std::string meshName = GetShippedMeshPath( sourcePath );
+	for( char& c : meshName ) {
+		if( c == '/' || c == '\\' || c == ':' ) {
+			c = '_';
+		}
+	}
+	return GetUserCacheFolder( "Meshes" ) + meshName;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+std::string GetShippedMeshPath( char const* sourcePath )
+{
+	std::string meshPath = sourcePath;
+	size_t extensionStart = meshPath.find_last_of( '.' );
+	size_t folderEnd = meshPath.find_last_of( "/\\" );
+	if( extensionStart != std::string::npos && ( folderEnd == std::string::npos || extensionStart > folderEnd ) ) {
+		meshPath.erase( extensionStart );
+	}
+	return meshPath + ".mesh";
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+uint32_t HashMeshImportOptions( mesh_import_options_t const& options )
+{
+	// FNV-1a over everything that changes what the import produces
+	uint32_t hash = 2166136261u;
+	auto mixBytes = [&hash]( void const* data, size_t byteSize ) {
+		unsigned char const* bytes = reinterpret_cast<unsigned char const*>( data );
+		for( size_t byteIdx = 0; byteIdx < byteSize; ++byteIdx ) {
+			hash = ( hash ^ bytes[byteIdx] ) * 16777619u;
+		}
+	};
+
+	unsigned char flags[] = { options.invert_v, options.generate_tangents, options.invert_winding_order, options.clean };
+	mixBytes( &options.transform, sizeof( Mat44 ) );
+	mixBytes( flags, sizeof( flags ) );
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t HashMeshSourceBytes( void const* data, size_t byteSize )
+{
+	// FNV-1a
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>( data );
+	uint64_t hash = 14695981039346656037ull;
+	for( size_t byteIdx = 0; byteIdx < byteSize; ++byteIdx ) {
+		hash = ( hash ^ bytes[byteIdx] ) * 1099511628211ull;
+	}
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static bool GetMeshSourceInfo( char const* sourcePath, MeshFileHeader& out_info )
+{
+	std::vector<uint8_t> sourceBytes;
+	if( !GetFileSizeAndWriteTime( sourcePath, out_info.m_sourceByteSize, out_info.m_sourceWriteTime ) || !ReadFileToBuffer( sourcePath, sourceBytes ) ) {
+		return false;
+	}
+	out_info.m_sourceHash = HashMeshSourceBytes( sourceBytes.data(), sourceBytes.size() );
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void LoadWeldedOBJ( char const* objPath, mesh_import_options_t const& options, std::vector<Vertex_PCUTBN>& out_vertices, std::vector<uint>& out_indices )
+{
+	out_vertices.clear();
+	out_indices.clear();
+
+	// tangents are generated on the unwelded triangles, the way MikkTSpace expects them; welding only merges what came out identical
+	LoadOBJToVertexArray( out_vertices, out_indices, objPath, options );
+	WeldVertexArray( out_vertices, out_indices );
+	OptimizeIndexedMesh( out_vertices, out_indices );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool WriteMeshFile( char const* meshPath, std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint> const& indices, MeshFileHeader const& sourceInfo )
+{
+	MeshFileHeader header;
+	header.m_sourceHash = sourceInfo.m_sourceHash;
+	header.m_sourceByteSize = sourceInfo.m_sourceByteSize;
+	header.m_sourceWriteTime = sourceInfo.m_sourceWriteTime;
+	header.m_optionsHash = sourceInfo.m_optionsHash;
+	header.m_vertexStride = sizeof( Vertex_PCUTBN );
+	header.m_vertexCount = (uint32_t)vertices.size();
+	header.m_indexCount = (uint32_t)indices.size();
+	header.m_indexByteSize = vertices.size() <= 0x10000 ? sizeof( uint16_t ) : sizeof( uint32_t );
+	header.m_vertexOffset = AlignMeshFileOffset( sizeof( MeshFileHeader ) );
+	header.m_indexOffset = AlignMeshFileOffset( header.m_vertexOffset + vertices.size() * sizeof( Vertex_PCUTBN ) );
+	header.m_fileByteSize = header.m_indexOffset + header.m_indexCount * header.m_indexByteSize;
+
+	for( int axis = 0; axis < 3; ++axis ) {
+		header.m_boundsMins[axis] = vertices.empty() ? 0.f : FLT_MAX;
+		header.m_boundsMaxs[axis] = vertices.empty() ? 0.f : -FLT_MAX;
+	}
+	for( Vertex_PCUTBN const& vertex : vertices ) {
+		float const position[3] = { vertex.m_position.x, vertex.m_position.y, vertex.m_position.z };
+		for( int axis = 0; axis < 3; ++axis ) {
+			header.m_boundsMins[axis] = fminf( header.m_boundsMins[axis], position[axis] );
+			header.m_boundsMaxs[axis] = fmaxf( header.m_boundsMaxs[axis], position[axis] );
+		}
+	}
+
+	std::vector<uint8_t> fileBytes( header.m_fileByteSize, 0 );
+	memcpy( &fileBytes[0], &header, sizeof( MeshFileHeader ) );
+	if( !vertices.empty() ) {
+		memcpy( &fileBytes[header.m_vertexOffset], vertices.data(), vertices.size() * sizeof( Vertex_PCUTBN ) );
+	}
+	if( header.m_indexByteSize == sizeof( uint16_t ) ) {
+		uint16_t* indices16 = reinterpret_cast<uint16_t*>( &fileBytes[header.m_indexOffset] );
+		for( size_t indexIdx = 0; indexIdx < indices.size(); ++indexIdx ) {
+			indices16[indexIdx] = (uint16_t)indices[indexIdx];
+		}
+	}
+	else if( !indices.empty() ) {
+		memcpy( &fileBytes[header.m_indexOffset], indices.data(), indices.size() * sizeof( uint ) );
+	}
+
+	return WriteBufferToFile( meshPath, fileBytes.data(), fileBytes.size() );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool CookOBJToMeshFile( char const* objPath, char const* meshPath, mesh_import_options_t const& options )
+{
+	MeshFileHeader sourceInfo;
+	if( !GetMeshSourceInfo( objPath, sourceInfo ) ) {
+		return false;
+	}
+	sourceInfo.m_optionsHash = HashMeshImportOptions( options );
+
+	std::vector<Vertex_PCUTBN> vertices;
+	std::vector<uint> indices;
+	LoadWeldedOBJ( objPath, options, vertices, indices );
+	return WriteMeshFile( meshPath, vertices, indices, sourceInfo );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool OpenMeshFile( MemoryMappedFile& file, char const* meshPath, MeshFileView& out_view )
+{
+	out_view = MeshFileView();
+	if( !file.Open( meshPath ) ) {
+		return false;
+	}
+
+	size_t fileByteSize = file.GetSize();
+	unsigned char const* fileBytes = reinterpret_cast<unsigned char const*>( file.GetData() );
+	MeshFileHeader const* header = reinterpret_cast<MeshFileHeader const*>( fileBytes );
+
+	bool isValid = fileByteSize >= sizeof( MeshFileHeader )
+		&& header->m_magic == MESH_FILE_MAGIC
+		&& header->m_version == MESH_FILE_VERSION
+		&& header->m_vertexStride == sizeof( Vertex_PCUTBN )
+		&& ( header->m_indexByteSize == sizeof( uint16_t ) || header->m_indexByteSize == sizeof( uint32_t ) )
+		&& header->m_fileByteSize == fileByteSize
+		&& header->m_vertexOffset % MESH_FILE_DATA_ALIGNMENT == 0
+		&& header->m_indexOffset % MESH_FILE_DATA_ALIGNMENT == 0
+		&& header->m_vertexOffset >= sizeof( MeshFileHeader )
+		&& (uint64_t)header->m_vertexOffset + (uint64_t)header->m_vertexCount * header->m_vertexStride <= fileByteSize
+		&& (uint64_t)header->m_indexOffset + (uint64_t)header->m_indexCount * header->m_indexByteSize <= fileByteSize;
+	if( !isValid ) {
+		file.Close();
+		return false;
+	}
+
+	out_view.m_header = header;
+	out_view.m_vertices = reinterpret_cast<Vertex_PCUTBN const*>( fileBytes + header->m_vertexOffset );
+	out_view.m_indices = fileBytes + header->m_indexOffset;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool IsMeshFileCurrent( MeshFileHeader const& header, char const* sourcePath, uint32_t optionsHash, uint64_t* out_sourceWriteTime )
+{
+	if( header.m_optionsHash != optionsHash ) {
+		return false;
+	}
+
+	uint64_t sourceByteSize = 0;
+	uint64_t sourceWriteTime = 0;
+	if( !GetFileSizeAndWriteTime( sourcePath, sourceByteSize, sourceWriteTime ) ) {
+		if( out_sourceWriteTime ) {
+			*out_sourceWriteTime = header.m_sourceWriteTime;	// nothing to refresh
+		}
+		return true;
+	}
+	if( out_sourceWriteTime ) {
+		*out_sourceWriteTime = sourceWriteTime;
+	}
+	if( sourceByteSize != header.m_sourceByteSize ) {
+		return false;
+	}
+	if( sourceWriteTime == header.m_sourceWriteTime ) {
+		return true;
+	}
+
+	// touched but maybe not changed (checkouts and copies rewrite times): only the contents can tell
+	std::vector<uint8_t> sourceBytes;
+	if( !ReadFileToBuffer( sourcePath, sourceBytes ) ) {
+		return false;
+	}
+	return HashMeshSourceBytes( sourceBytes.data(), sourceBytes.size() ) == header.m_sourceHash;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool RefreshMeshFileSourceWriteTime( char const* meshPath, uint64_t sourceWriteTime )
+{
+	return OverwriteFileBytes( meshPath, offsetof( MeshFileHeader, m_sourceWriteTime ), &sourceWriteTime, sizeof( sourceWriteTime ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static void UploadMeshFileView( GPUMesh* mesh, MeshFileView const& view )
+{
+	MeshFileHeader const& header = *view.m_header;
+	mesh->UpdateVertices( header.m_vertexCount, view.m_vertices, sizeof( Vertex_PCUTBN ), Vertex_PCUTBN::LAYOUT );
+	if( header.m_indexByteSize == sizeof( uint16_t ) ) {
+		mesh->UpdateIndices16( header.m_indexCount, reinterpret_cast<uint16_t const*>( view.m_indices ) );
+	}
+	else {
+		mesh->UpdateIndices( header.m_indexCount, reinterpret_cast<uint const*>( view.m_indices ) );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+GPUMesh* LoadCookedOBJMesh( RenderContext* ctx, char const* objPath, mesh_import_options_t const& options )
+{
+	std::string meshPath = GetCookedMeshPath( objPath );
+	uint32_t optionsHash = HashMeshImportOptions( options );
+	GPUMesh* mesh = new GPUMesh( ctx );
+
+	MemoryMappedFile file;
+	MeshFileView view;
+	uint64_t sourceWriteTime = 0;
+	if( OpenMeshFile( file, meshPath.c_str(), view ) && IsMeshFileCurrent( *view.m_header, objPath, optionsHash, &sourceWriteTime ) )
+	{
+		UploadMeshFileView( mesh, view );
+		bool isWriteTimeStale = sourceWriteTime != view.m_header->m_sourceWriteTime;
+		file.Close();
+
+		// the source was only touched; the hash matched, so record the new time and skip the rehash next load
+		if( isWriteTimeStale && !RefreshMeshFileSourceWriteTime( meshPath.c_str(), sourceWriteTime ) ) {
+			g_theConsole->Error( "Failed to update the source write time in \"%s\"", meshPath.c_str() );
+		}
+		return mesh;
+	}
+	file.Close();
+
+	// shipped cooked-only: the source isn't there to cook from
+	uint64_t sourceByteSize = 0;
+	if( !GetFileSizeAndWriteTime( objPath, sourceByteSize, sourceWriteTime ) ) {
+		std::string shippedMeshPath = GetShippedMeshPath( objPath );
+		if( OpenMeshFile( file, shippedMeshPath.c_str(), view ) && view.m_header->m_optionsHash == optionsHash ) {
+			UploadMeshFileView( mesh, view );
+			return mesh;
+		}
+		file.Close();
+	}
+
+	// cook now and draw from what was just cooked; the next load maps it
+	MeshFileHeader sourceInfo;
+	bool hasSourceInfo = GetMeshSourceInfo( objPath, sourceInfo );
+	sourceInfo.m_optionsHash = optionsHash;
+
+	std::vector<Vertex_PCUTBN> vertices;
+	std::vector<uint> indices;
+	LoadWeldedOBJ( objPath, options, vertices, indices );
+	if( !hasSourceInfo || !WriteMeshFile( meshPath.c_str(), vertices, indices, sourceInfo ) ) {
+		g_theConsole->Error( "Failed to cook \"%s\" to \"%s\"", objPath, meshPath.c_str() );
+	}
+
+	mesh->UpdateVertices( vertices );
+	mesh->UpdateIndices( indices );
+	return mesh;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Compares the OBJ text path with mapping the cooked file, CPU side only: both end with the arrays in memory, ready to
+// upload. Checks the cooked arrays are exactly what the text path produces once welded and optimized.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_mesh_load, "file,iterations" )
+{
+	std::string objPath = args.GetValue( "file", "Data/Models/Cane.obj" );
+	int numIterations = args.GetValue( "iterations", 3 );
+	if( numIterations <= 0 ) {
+		g_theConsole->Error( "benchmark_mesh_load: iterations must be positive" );
+		return;
+	}
+
+	uint64_t sourceByteSize = 0;
+	uint64_t sourceWriteTime = 0;
+	if( !GetFileSizeAndWriteTime( objPath, sourceByteSize, sourceWriteTime ) ) {
+		g_theConsole->Error( "benchmark_mesh_load: can't find \"%s\"", objPath.c_str() );
+		return;
+	}
+
+	mesh_import_options_t options;
+	options.generate_tangents = true;
+	std::string meshPath = GetCookedMeshPath( objPath.c_str() );
+	uint32_t optionsHash = HashMeshImportOptions( options );
+
+	double cookSeconds = 0.0;
+	{
+		MemoryMappedFile file;
+		MeshFileView view;
+		if( !OpenMeshFile( file, meshPath.c_str(), view ) || !IsMeshFileCurrent( *view.m_header, objPath.c_str(), optionsHash ) ) {
+			file.Close();
+			double startSeconds = GetCurrentTimeSeconds();
+			if( !CookOBJToMeshFile( objPath.c_str(), meshPath.c_str(), options ) ) {
+				g_theConsole->Error( "benchmark_mesh_load: failed to write \"%s\"", meshPath.c_str() );
+				return;
+			}
+			cookSeconds = GetCurrentTimeSeconds() - startSeconds;
+		}
+	}
+
+	std::vector<Vertex_PCUTBN> vertices;
+	std::vector<uint> indices;
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int iteration = 0; iteration < numIterations; ++iteration ) {
+		vertices.clear();
+		indices.clear();
+		LoadOBJToVertexArray( vertices, indices, objPath.c_str(), options );
+	}
+	double textSeconds = ( GetCurrentTimeSeconds() - startSeconds ) / numIterations;
+	int numSoupVertices = (int)vertices.size();
+
+	// the copy stands in for the upload, so every page of the mapping is actually read
+	std::vector<Vertex_PCUTBN> mappedVertices;
+	std::vector<uint8_t> mappedIndices;
+	startSeconds = GetCurrentTimeSeconds();
+	for( int iteration = 0; iteration < numIterations; ++iteration ) {
+		MemoryMappedFile file;
+		MeshFileView view;
+		if( !OpenMeshFile( file, meshPath.c_str(), view ) || !IsMeshFileCurrent( *view.m_header, objPath.c_str(), optionsHash ) ) {
+			g_theConsole->Error( "benchmark_mesh_load: \"%s\" did not open", meshPath.c_str() );
+			return;
+		}
+		uint8_t const* indexBytes = reinterpret_cast<uint8_t const*>( view.m_indices );
+		mappedVertices.assign( view.m_vertices, view.m_vertices + view.m_header->m_vertexCount );
+		mappedIndices.assign( indexBytes, indexBytes + view.m_header->m_indexCount * view.m_header->m_indexByteSize );
+	}
+	double mappedSeconds = ( GetCurrentTimeSeconds() - startSeconds ) / numIterations;
+
+	// Correctness: the cooked arrays are the text path's, welded and optimized
+	WeldVertexArray( vertices, indices );
+	OptimizeIndexedMesh( vertices, indices );
+	bool doArraysMatch = vertices.size() == mappedVertices.size()
+		&& ( vertices.empty() || memcmp( vertices.data(), mappedVertices.data(), vertices.size() * sizeof( Vertex_PCUTBN ) ) == 0 );
+	size_t indexByteSize = indices.empty() ? 0 : mappedIndices.size() / indices.size();
+	doArraysMatch = doArraysMatch && ( indices.empty() ? mappedIndices.empty() : mappedIndices.size() == indices.size() * indexByteSize );
+	for( size_t indexIdx = 0; doArraysMatch && indexIdx < indices.size(); ++indexIdx ) {
+		uint mappedIndex = 0;
+		if( indexByteSize == sizeof( uint16_t ) ) {
+			mappedIndex = reinterpret_cast<uint16_t const*>( mappedIndices.data() )[indexIdx];
+		}
+		else {
+			mappedIndex = reinterpret_cast<uint32_t const*>( mappedIndices.data() )[indexIdx];
+		}
+		doArraysMatch = mappedIndex == indices[indexIdx];
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Mesh load, \"%s\" (%llu KB) x %i iterations (ms per load)", objPath.c_str(), (unsigned long long)( sourceByteSize / 1024 ), numIterations ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  OBJ text + tangents %.2f  cooked .mesh mapped %.3f", textSeconds * 1000.0, mappedSeconds * 1000.0 ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  vertices %i -> %i welded, %i indices at %i bytes", numSoupVertices, (int)vertices.size(), (int)indices.size(), (int)indexByteSize ) );
+	if( cookSeconds > 0.0 ) {
+		g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  cooked \"%s\" first, %.2f ms", meshPath.c_str(), cookSeconds * 1000.0 ) );
+	}
+
+	Rgba8 resultColor = doArraysMatch ? Rgba8::GREEN : Rgba8::RED;
+	g_theConsole->PrintString( resultColor, Stringf( "  cooked arrays match the welded, optimized text import: %s", doArraysMatch ? "yes" : "NO" ) );
+}
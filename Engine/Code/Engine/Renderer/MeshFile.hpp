@@ -0,0 +1,82 @@
+#pragma once
+#include "Engine/Core/MemoryMappedFile.hpp"
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef unsigned int uint;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class GPUMesh;
+class RenderContext;
+struct mesh_import_options_t;
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+
+constexpr uint32_t MESH_FILE_MAGIC = 0x4853454d;	// "MESH" read as a little-endian uint32
+constexpr uint32_t MESH_FILE_VERSION = 2;		// 2: arrays are cache, overdraw and fetch optimized
+constexpr uint32_t MESH_FILE_DATA_ALIGNMENT = 16;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// A cooked .mesh file is this header followed by the welded vertex array and the index array, each at a 16-byte
+// aligned offset, in exactly the layout GPUMesh uploads. Nothing is parsed at load: the file is mapped, the header
+// checked, and the arrays handed over.
+//
+// A cook remembers which source it came from (size, write time and a hash of its bytes) and a hash of the import
+// options, so a stale or differently imported .mesh is recooked rather than trusted.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct MeshFileHeader
+{
+	uint32_t	m_magic = MESH_FILE_MAGIC;
+	uint32_t	m_version = MESH_FILE_VERSION;
+	uint64_t	m_sourceHash = 0;
+	uint64_t	m_sourceByteSize = 0;
+	uint64_t	m_sourceWriteTime = 0;		// when size and time still match, the source isn't rehashed
+	uint32_t	m_optionsHash = 0;
+	uint32_t	m_vertexStride = 0;			// sizeof( Vertex_PCUTBN ) at cook time
+	uint32_t	m_vertexCount = 0;
+	uint32_t	m_indexCount = 0;
+	uint32_t	m_indexByteSize = 0;		// 2 when every index fits in 16 bits, else 4
+	uint32_t	m_vertexOffset = 0;			// from the start of the file
+	uint32_t	m_indexOffset = 0;
+	uint32_t	m_fileByteSize = 0;
+	float		m_boundsMins[3] = {};
+	float		m_boundsMaxs[3] = {};
+
+	AABB3		GetBounds() const;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// The arrays of an open .mesh; they point into the mapping and are valid while the MemoryMappedFile stays open
+struct MeshFileView
+{
+	MeshFileHeader const*	m_header = nullptr;
+	Vertex_PCUTBN const*	m_vertices = nullptr;
+	void const*				m_indices = nullptr;		// uint16_t or uint32_t, per m_header->m_indexByteSize
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+std::string	GetCookedMeshPath( char const* sourcePath );					// in the user cache folder, named after the whole source path
+std::string	GetShippedMeshPath( char const* sourcePath );					// same folder and name, .mesh extension; read only
+uint32_t	HashMeshImportOptions( mesh_import_options_t const& options );
+uint64_t	HashMeshSourceBytes( void const* data, size_t byteSize );
+
+// Loads an OBJ the slow way (text parse, triangulation, tangents), welds it into an indexed mesh and optimizes it
+void		LoadWeldedOBJ( char const* objPath, mesh_import_options_t const& options, std::vector<Vertex_PCUTBN>& out_vertices, std::vector<uint>& out_indices );
+
+bool		WriteMeshFile( char const* meshPath, std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint> const& indices, MeshFileHeader const& sourceInfo );
+bool		CookOBJToMeshFile( char const* objPath, char const* meshPath, mesh_import_options_t const& options );
+
+// Maps meshPath and validates its header and array bounds; false (and the file closed) if it isn't a usable .mesh
+bool		OpenMeshFile( MemoryMappedFile& file, char const* meshPath, MeshFileView& out_view );
+
+// True if the cook matches the source and options; a missing source counts as current (shipped cooked-only).
+// out_sourceWriteTime gets the source's write time; when it differs from the header's, the match took a rehash,
+// and RefreshMeshFileSourceWriteTime (once the file is closed) spares the next load that.
+bool		IsMeshFileCurrent( MeshFileHeader const& header, char const* sourcePath, uint32_t optionsHash, uint64_t* out_sourceWriteTime = nullptr );
+bool		RefreshMeshFileSourceWriteTime( char const* meshPath, uint64_t sourceWriteTime );
+
+// The one call a game makes: maps objPath's cooked .mesh from the user cache, cooking it there first when it is
+// missing or stale. A .mesh shipped next to a missing source is used as is.
+GPUMesh*	LoadCookedOBJMesh( RenderContext* ctx, char const* objPath, mesh_import_options_t const& options );
@@ -0,0 +1,482 @@
+#include "Engine/Renderer/MeshOptimizer.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/UnitTest.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static constexpr uint NO_VERTEX = 0xffffffff;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+MeshCacheStats AnalyzeVertexCache( uint const* indices, size_t indexCount, uint vertexCount, uint cacheSize )
+{
+	MeshCacheStats stats;
+	stats.m_numTriangles = (uint)( indexCount / 3 );
+	if( indexCount == 0 ) {
+		return stats;
+	}
+
+	// a vertex is in the FIFO while fewer than cacheSize vertices were pushed after it; 0 is "never pushed"
+	std::vector<uint> timestamps( vertexCount, 0 );
+	uint time = cacheSize + 1;
+	for( size_t indexIdx = 0; indexIdx < indexCount; ++indexIdx ) {
+		uint vertex = indices[indexIdx];
+		if( time - timestamps[vertex] > cacheSize ) {
+			if( timestamps[vertex] == 0 ) {
+				++stats.m_numVertices;
+			}
+			timestamps[vertex] = time++;
+			++stats.m_numTransformed;
+		}
+	}
+
+	stats.m_acmr = (float)stats.m_numTransformed / (float)stats.m_numTriangles;
+	stats.m_atvr = (float)stats.m_numTransformed / (float)stats.m_numVertices;
+	return stats;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Tipsify's way out of a dead end: the most recently used vertex that still has triangles left, else the next one in
+// vertex order; -1 once every triangle is out
+static int SkipTipsifyDeadEnd( std::vector<uint>& deadEnds, std::vector<uint> const& liveCounts, uint& scanCursor )
+{
+	while( !deadEnds.empty() ) {
+		uint vertex = deadEnds.back();
+		deadEnds.pop_back();
+		if( liveCounts[vertex] > 0 ) {
+			return (int)vertex;
+		}
+	}
+
+	while( scanCursor < (uint)liveCounts.size() ) {
+		uint vertex = scanCursor++;
+		if( liveCounts[vertex] > 0 ) {
+			return (int)vertex;
+		}
+	}
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void OptimizeVertexCache( uint* indices, size_t indexCount, uint vertexCount, uint cacheSize )
+{
+	GUARANTEE_OR_DIE( indexCount % 3 == 0, "OptimizeVertexCache needs a triangle list" );
+	uint numTriangles = (uint)( indexCount / 3 );
+	if( numTriangles < 2 ) {
+		return;
+	}
+
+	// triangles around each vertex
+	std::vector<uint> liveCounts( vertexCount, 0 );
+	for( size_t indexIdx = 0; indexIdx < indexCount; ++indexIdx ) {
+		++liveCounts[indices[indexIdx]];
+	}
+	std::vector<uint> adjacencyOffsets( vertexCount + 1, 0 );
+	for( uint vertex = 0; vertex < vertexCount; ++vertex ) {
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveCounts[vertex];
+	}
+	std::vector<uint> adjacency( indexCount );
+	std::vector<uint> adjacencyCursors( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+	for( size_t indexIdx = 0; indexIdx < indexCount; ++indexIdx ) {
+		adjacency[adjacencyCursors[indices[indexIdx]]++] = (uint)( indexIdx / 3 );
+	}
+
+	std::vector<uint> timestamps( vertexCount, 0 );
+	std::vector<uint8_t> isEmitted( numTriangles, 0 );
+	std::vector<uint> deadEnds;
+	std::vector<uint> candidates;
+	std::vector<uint> output;
+	deadEnds.reserve( indexCount );
+	output.reserve( indexCount );
+
+	uint time = cacheSize + 1;
+	uint scanCursor = 0;
+	int fanVertex = SkipTipsifyDeadEnd( deadEnds, liveCounts, scanCursor );
+	while( fanVertex >= 0 ) {
+		// emit every triangle still around the fan vertex
+		candidates.clear();
+		for( uint adjacencyIdx = adjacencyOffsets[fanVertex]; adjacencyIdx < adjacencyOffsets[fanVertex + 1]; ++adjacencyIdx ) {
+			uint triangle = adjacency[adjacencyIdx];
+			if( isEmitted[triangle] ) {
+				continue;
+			}
+			isEmitted[triangle] = 1;
+
+			for( int corner = 0; corner < 3; ++corner ) {
+				uint vertex = indices[triangle * 3 + corner];
+				output.push_back( vertex );
+				deadEnds.push_back( vertex );
+				candidates.push_back( vertex );
+				--liveCounts[vertex];
+				if( time - timestamps[vertex] > cacheSize ) {
+					timestamps[vertex] = time++;
+				}
+			}
+		}
+
+		// fan next around the neighbour that will still be cached once its remaining triangles are out, oldest first
+		int nextVertex = -1;
+		int bestPriority = -1;
+		for( uint vertex : candidates ) {
+			if( liveCounts[vertex] == 0 ) {
+				continue;
+			}
+			int priority = 0;
+			uint age = time - timestamps[vertex];
+			if( age + 2 * liveCounts[vertex] <= cacheSize ) {
+				priority = (int)age;
+			}
+			if( priority > bestPriority ) {
+				bestPriority = priority;
+				nextVertex = (int)vertex;
+			}
+		}
+		fanVertex = nextVertex >= 0 ? nextVertex : SkipTipsifyDeadEnd( deadEnds, liveCounts, scanCursor );
+	}
+
+	memcpy( indices, output.data(), indexCount * sizeof( uint ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static Vec3 GetVertexPosition( uint8_t const* vertexBytes, size_t vertexStride, size_t positionOffset, uint vertex )
+{
+	float position[3];
+	memcpy( position, vertexBytes + vertex * vertexStride + positionOffset, sizeof( position ) );
+	return Vec3( position[0], position[1], position[2] );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void OptimizeOverdraw( uint* indices, size_t indexCount, void const* vertices, size_t vertexStride, size_t positionOffset, uint vertexCount, uint cacheSize, float threshold )
+{
+	GUARANTEE_OR_DIE( indexCount % 3 == 0, "OptimizeOverdraw needs a triangle list" );
+	uint numTriangles = (uint)( indexCount / 3 );
+	if( numTriangles < 2 ) {
+		return;
+	}
+
+	// a cluster starts wherever the cache is cold anyway: every vertex of its first triangle misses, so moving whole
+	// clusters around costs little more than what those restarts already cost
+	std::vector<uint> clusterStarts( 1, 0 );
+	std::vector<uint> timestamps( vertexCount, 0 );
+	uint time = cacheSize + 1;
+	uint numTransformed = 0;
+	for( uint triangle = 0; triangle < numTriangles; ++triangle ) {
+		int numMisses = 0;
+		for( int corner = 0; corner < 3; ++corner ) {
+			uint vertex = indices[triangle * 3 + corner];
+			if( time - timestamps[vertex] > cacheSize ) {
+				timestamps[vertex] = time++;
+				++numMisses;
+			}
+		}
+		if( numMisses == 3 && triangle > 0 ) {
+			clusterStarts.push_back( triangle );
+		}
+		numTransformed += numMisses;
+	}
+	if( clusterStarts.size() < 2 ) {
+		return;
+	}
+	clusterStarts.push_back( numTriangles );
+	uint numClusters = (uint)clusterStarts.size() - 1;
+
+	// area-weighted centroid and normal of each cluster, and of the whole mesh
+	uint8_t const* vertexBytes = reinterpret_cast<uint8_t const*>( vertices );
+	std::vector<Vec3> clusterCentroids( numClusters );
+	std::vector<Vec3> clusterNormals( numClusters );
+	Vec3 meshCentroid;
+	float meshArea = 0.f;
+	for( uint cluster = 0; cluster < numClusters; ++cluster ) {
+		Vec3 centroidSum;
+		Vec3 normalSum;
+		float areaSum = 0.f;
+		for( uint triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle ) {
+			Vec3 a = GetVertexPosition( vertexBytes, vertexStride, positionOffset, indices[triangle * 3 + 0] );
+			Vec3 b = GetVertexPosition( vertexBytes, vertexStride, positionOffset, indices[triangle * 3 + 1] );
+			Vec3 c = GetVertexPosition( vertexBytes, vertexStride, positionOffset, indices[triangle * 3 + 2] );
+			Vec3 normal = CrossProduct( b - a, c - a );
+			float area = normal.GetLength();
+			centroidSum += ( a + b + c ) * ( area / 3.f );
+			normalSum += normal;
+			areaSum += area;
+		}
+		clusterCentroids[cluster] = areaSum > 0.f ? centroidSum / areaSum : Vec3();
+		float normalLength = normalSum.GetLength();
+		clusterNormals[cluster] = normalLength > 0.f ? normalSum / normalLength : Vec3();
+		meshCentroid += centroidSum;
+		meshArea += areaSum;
+	}
+	if( meshArea > 0.f ) {
+		meshCentroid = meshCentroid / meshArea;
+	}
+
+	// clusters on the outside, facing out, tend to occlude the rest from any view: draw them first
+	std::vector<float> sortKeys( numClusters );
+	std::vector<uint> clusterOrder( numClusters );
+	for( uint cluster = 0; cluster < numClusters; ++cluster ) {
+		sortKeys[cluster] = DotProduct( clusterCentroids[cluster] - meshCentroid, clusterNormals[cluster] );
+		clusterOrder[cluster] = cluster;
+	}
+	std::stable_sort( clusterOrder.begin(), clusterOrder.end(), [&sortKeys]( uint a, uint b ) { return sortKeys[a] > sortKeys[b]; } );
+
+	std::vector<uint> sortedIndices;
+	sortedIndices.reserve( indexCount );
+	for( uint cluster : clusterOrder ) {
+		sortedIndices.insert( sortedIndices.end(), indices + clusterStarts[cluster] * 3, indices + clusterStarts[cluster + 1] * 3 );
+	}
+
+	MeshCacheStats sortedStats = AnalyzeVertexCache( sortedIndices.data(), indexCount, vertexCount, cacheSize );
+	if( (float)sortedStats.m_numTransformed <= (float)numTransformed * threshold ) {
+		memcpy( indices, sortedIndices.data(), indexCount * sizeof( uint ) );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+uint OptimizeVertexFetch( void* vertices, size_t vertexStride, uint vertexCount, uint* indices, size_t indexCount )
+{
+	std::vector<uint> remap( vertexCount, NO_VERTEX );
+	uint nextVertex = 0;
+	for( size_t indexIdx = 0; indexIdx < indexCount; ++indexIdx ) {
+		uint& newVertex = remap[indices[indexIdx]];
+		if( newVertex == NO_VERTEX ) {
+			newVertex = nextVertex++;
+		}
+		indices[indexIdx] = newVertex;
+	}
+
+	uint numReferenced = nextVertex;
+	for( uint vertex = 0; vertex < vertexCount; ++vertex ) {
+		if( remap[vertex] == NO_VERTEX ) {
+			remap[vertex] = nextVertex++;
+		}
+	}
+
+	uint8_t* vertexBytes = reinterpret_cast<uint8_t*>( vertices );
+	std::vector<uint8_t> originalBytes( vertexBytes, vertexBytes + vertexCount * vertexStride );
+	for( uint vertex = 0; vertex < vertexCount; ++vertex ) {
+		memcpy( vertexBytes + remap[vertex] * vertexStride, &originalBytes[vertex * vertexStride], vertexStride );
+	}
+	return numReferenced;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+MeshOptimizerReport OptimizeIndexedMesh( void* vertices, size_t vertexStride, size_t positionOffset, uint vertexCount, uint* indices, size_t indexCount, uint cacheSize )
+{
+	GUARANTEE_OR_DIE( indexCount % 3 == 0, "OptimizeIndexedMesh needs a triangle list" );
+	for( size_t indexIdx = 0; indexIdx < indexCount; ++indexIdx ) {
+		GUARANTEE_OR_DIE( indices[indexIdx] < vertexCount, "OptimizeIndexedMesh: index out of range" );
+	}
+
+	MeshOptimizerReport report;
+	report.m_before = AnalyzeVertexCache( indices, indexCount, vertexCount, cacheSize );
+
+	std::vector<uint> originalIndices( indices, indices + indexCount );
+	OptimizeVertexCache( indices, indexCount, vertexCount, cacheSize );
+	OptimizeOverdraw( indices, indexCount, vertices, vertexStride, positionOffset, vertexCount, cacheSize );
+	if( AnalyzeVertexCache( indices, indexCount, vertexCount, cacheSize ).m_numTransformed > report.m_before.m_numTransformed ) {
+		memcpy( indices, originalIndices.data(), indexCount * sizeof( uint ) );
+	}
+
+	OptimizeVertexFetch( vertices, vertexStride, vertexCount, indices, indexCount );
+	report.m_after = AnalyzeVertexCache( indices, indexCount, vertexCount, cacheSize );
+	return report;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Optimizes a sphere-wrapped grid as the MeshUtils builders emit it (row by row) and with its triangles shuffled, the
+// way an unoptimized import tends to arrive. Each vertex carries its original number so the check can confirm the same
+// triangles, with the same winding, come out the other end.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct BenchmarkMeshVertex
+{
+	Vec3	m_position;
+	uint	m_id = 0;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static void BuildBenchmarkSphere( int cuts, std::vector<BenchmarkMeshVertex>& out_vertices, std::vector<uint>& out_indices )
+{
+	out_vertices.clear();
+	out_indices.clear();
+	int rowLength = cuts + 1;
+	for( int ring = 0; ring <= cuts; ++ring ) {
+		float latitude = 90.f - 180.f * (float)ring / (float)cuts;
+		for( int segment = 0; segment <= cuts; ++segment ) {
+			float longitude = 360.f * (float)segment / (float)cuts;
+			BenchmarkMeshVertex vertex;
+			vertex.m_position = Vec3( CosDegrees( latitude ) * CosDegrees( longitude ), SinDegrees( latitude ), -CosDegrees( latitude ) * SinDegrees( longitude ) );
+			vertex.m_id = (uint)out_vertices.size();
+			out_vertices.push_back( vertex );
+		}
+	}
+	for( int ring = 0; ring < cuts; ++ring ) {
+		for( int segment = 0; segment < cuts; ++segment ) {
+			uint k1 = ring * rowLength + segment;
+			uint k2 = k1 + rowLength;
+			out_indices.insert( out_indices.end(), { k1, k2, k1 + 1 } );
+			out_indices.insert( out_indices.end(), { k1 + 1, k2, k2 + 1 } );
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Triangles by original vertex number, each rotated to start at its smallest, then sorted: equal lists mean the same
+// triangles with the same winding
+static std::vector<uint64_t> GetCanonicalTriangles( std::vector<BenchmarkMeshVertex> const& vertices, std::vector<uint> const& indices )
+{
+	std::vector<uint64_t> triangles;
+	triangles.reserve( indices.size() / 3 );
+	for( size_t indexIdx = 0; indexIdx + 2 < indices.size(); indexIdx += 3 ) {
+		uint64_t a = vertices[indices[indexIdx + 0]].m_id;
+		uint64_t b = vertices[indices[indexIdx + 1]].m_id;
+		uint64_t c = vertices[indices[indexIdx + 2]].m_id;
+		while( a > b || a > c ) {
+			uint64_t first = a;
+			a = b;
+			b = c;
+			c = first;
+		}
+		triangles.push_back( ( a << 42 ) | ( b << 21 ) | c );
+	}
+	std::sort( triangles.begin(), triangles.end() );
+	return triangles;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static void ShuffleBenchmarkTriangles( std::vector<uint>& indices, unsigned int seed )
+{
+	RandomNumberGenerator rng;
+	rng.Reset( seed );
+	uint numTriangles = (uint)( indices.size() / 3 );
+	for( uint triangle = numTriangles - 1; triangle > 0; --triangle ) {
+		uint other = (uint)rng.RollRandomIntInRange( 0, (int)triangle );
+		std::swap_ranges( &indices[triangle * 3], &indices[triangle * 3] + 3, &indices[other * 3] );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_mesh_optimizer, "cuts,iterations,cache" )
+{
+	int numCuts = Clamp( args.GetValue( "cuts", 64 ), 4, 1000 );
+	int numIterations = args.GetValue( "iterations", 10 );
+	int cacheSize = args.GetValue( "cache", (int)MESH_OPTIMIZER_DEFAULT_CACHE_SIZE );
+	if( numIterations <= 0 || cacheSize < 3 ) {
+		g_theConsole->Error( "benchmark_mesh_optimizer: iterations must be positive and cache at least 3" );
+		return;
+	}
+
+	std::vector<BenchmarkMeshVertex> rowVertices;
+	std::vector<uint> rowIndices;
+	BuildBenchmarkSphere( numCuts, rowVertices, rowIndices );
+
+	std::vector<BenchmarkMeshVertex> shuffledVertices = rowVertices;
+	std::vector<uint> shuffledIndices = rowIndices;
+	ShuffleBenchmarkTriangles( shuffledIndices, 1234 );
+	uint numTriangles = (uint)( shuffledIndices.size() / 3 );
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Mesh optimizer, %i-cut sphere (%u triangles, %u vertices), FIFO cache %i, x %i iterations",
+		numCuts, numTriangles, (uint)rowVertices.size(), cacheSize, numIterations ) );
+
+	bool isEverythingPreserved = true;
+	struct BenchmarkCase
+	{
+		char const*							m_name;
+		std::vector<BenchmarkMeshVertex>*	m_vertices;
+		std::vector<uint>*					m_indices;
+	};
+	BenchmarkCase cases[] = { { "row order", &rowVertices, &rowIndices }, { "shuffled ", &shuffledVertices, &shuffledIndices } };
+	for( BenchmarkCase const& benchmarkCase : cases ) {
+		std::vector<uint64_t> originalTriangles = GetCanonicalTriangles( *benchmarkCase.m_vertices, *benchmarkCase.m_indices );
+
+		std::vector<BenchmarkMeshVertex> vertices;
+		std::vector<uint> indices;
+		MeshOptimizerReport report;
+		double optimizeSeconds = 0.0;
+		for( int iteration = 0; iteration < numIterations; ++iteration ) {
+			vertices = *benchmarkCase.m_vertices;
+			indices = *benchmarkCase.m_indices;
+			double startSeconds = GetCurrentTimeSeconds();
+			report = OptimizeIndexedMesh( vertices, indices, (uint)cacheSize );
+			optimizeSeconds += GetCurrentTimeSeconds() - startSeconds;
+		}
+
+		bool isPreserved = vertices.size() == benchmarkCase.m_vertices->size() && GetCanonicalTriangles( vertices, indices ) == originalTriangles;
+		isEverythingPreserved = isEverythingPreserved && isPreserved;
+		g_theConsole->PrintString( isPreserved ? Rgba8::WHITE : Rgba8::RED, Stringf( "  %s  ACMR %.3f -> %.3f  ATVR %.3f -> %.3f  %.2f ms",
+			benchmarkCase.m_name, report.m_before.m_acmr, report.m_after.m_acmr, report.m_before.m_atvr, report.m_after.m_atvr, optimizeSeconds * 1000.0 / numIterations ) );
+	}
+
+	Rgba8 resultColor = isEverythingPreserved ? Rgba8::GREEN : Rgba8::RED;
+	g_theConsole->PrintString( resultColor, Stringf( "  same triangles and winding after optimizing: %s", isEverythingPreserved ? "yes" : "NO" ) );
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Each pass on its own and all three together: same triangles and winding, and the cache no worse (each pass) or
+// clearly better (a shuffled list through the vertex cache pass)
+UNIT_TEST( MeshOptimizerKeepsTrianglesAndImprovesCache, "Renderer" )
+{
+	std::vector<BenchmarkMeshVertex> rowVertices;
+	std::vector<uint> rowIndices;
+	BuildBenchmarkSphere( 32, rowVertices, rowIndices );
+	std::vector<uint> shuffledIndices = rowIndices;
+	ShuffleBenchmarkTriangles( shuffledIndices, 1234 );
+	std::vector<uint64_t> originalTriangles = GetCanonicalTriangles( rowVertices, rowIndices );
+	uint vertexCount = (uint)rowVertices.size();
+	size_t indexCount = rowIndices.size();
+
+	MeshCacheStats shuffledStats = AnalyzeVertexCache( shuffledIndices.data(), indexCount, vertexCount );
+	UNIT_TEST_CHECK( shuffledStats.m_numTriangles == indexCount / 3 );
+	UNIT_TEST_CHECK( shuffledStats.m_acmr > 1.5f );
+
+	std::vector<uint> cacheIndices = shuffledIndices;
+	OptimizeVertexCache( cacheIndices.data(), indexCount, vertexCount );
+	MeshCacheStats cacheStats = AnalyzeVertexCache( cacheIndices.data(), indexCount, vertexCount );
+	UNIT_TEST_CHECK( GetCanonicalTriangles( rowVertices, cacheIndices ) == originalTriangles );
+	UNIT_TEST_CHECK_MSG( cacheStats.m_acmr < 0.8f, Stringf( "vertex cache pass left ACMR at %.3f", cacheStats.m_acmr ) );
+	UNIT_TEST_CHECK( cacheStats.m_atvr < 1.3f );
+
+	std::vector<uint> overdrawIndices = cacheIndices;
+	OptimizeOverdraw( overdrawIndices.data(), indexCount, rowVertices.data(), sizeof( BenchmarkMeshVertex ), offsetof( BenchmarkMeshVertex, m_position ), vertexCount );
+	MeshCacheStats overdrawStats = AnalyzeVertexCache( overdrawIndices.data(), indexCount, vertexCount );
+	UNIT_TEST_CHECK( GetCanonicalTriangles( rowVertices, overdrawIndices ) == originalTriangles );
+	UNIT_TEST_CHECK_MSG( overdrawStats.m_acmr <= cacheStats.m_acmr * MESH_OPTIMIZER_DEFAULT_OVERDRAW_THRESHOLD + 0.0001f,
+		Stringf( "overdraw pass gave up too much ACMR: %.3f -> %.3f", cacheStats.m_acmr, overdrawStats.m_acmr ) );
+
+	std::vector<BenchmarkMeshVertex> fetchVertices = rowVertices;
+	std::vector<uint> fetchIndices = shuffledIndices;
+	uint numReferenced = OptimizeVertexFetch( fetchVertices.data(), sizeof( BenchmarkMeshVertex ), vertexCount, fetchIndices.data(), indexCount );
+	UNIT_TEST_CHECK( numReferenced == vertexCount );
+	UNIT_TEST_CHECK( GetCanonicalTriangles( fetchVertices, fetchIndices ) == originalTriangles );
+	uint nextNewVertex = 0;
+	bool isFetchInOrder = true;
+	for( uint index : fetchIndices ) {
+		if( index > nextNewVertex ) {
+			isFetchInOrder = false;
+		}
+		else if( index == nextNewVertex ) {
+			++nextNewVertex;
+		}
+	}
+	UNIT_TEST_CHECK_MSG( isFetchInOrder, "vertex fetch pass did not number vertices in first-use order" );
+
+	std::vector<BenchmarkMeshVertex> vertices[] = { rowVertices, rowVertices };
+	std::vector<uint> indices[] = { rowIndices, shuffledIndices };
+	for( int caseIdx = 0; caseIdx < 2; ++caseIdx ) {
+		MeshOptimizerReport report = OptimizeIndexedMesh( vertices[caseIdx], indices[caseIdx] );
+		UNIT_TEST_CHECK( vertices[caseIdx].size() == rowVertices.size() );
+		UNIT_TEST_CHECK( GetCanonicalTriangles( vertices[caseIdx], indices[caseIdx] ) == originalTriangles );
+		UNIT_TEST_CHECK_MSG( report.m_after.m_acmr <= report.m_before.m_acmr,
+			Stringf( "case %i: ACMR got worse, %.3f -> %.3f", caseIdx, report.m_before.m_acmr, report.m_after.m_acmr ) );
+		UNIT_TEST_CHECK( report.m_after.m_acmr == AnalyzeVertexCache( indices[caseIdx].data(), indexCount, vertexCount ).m_acmr );
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+typedef unsigned int uint;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+constexpr uint	MESH_OPTIMIZER_DEFAULT_CACHE_SIZE = 16;				// FIFO entries; a conservative size for post-transform caches
+constexpr float	MESH_OPTIMIZER_DEFAULT_OVERDRAW_THRESHOLD = 1.05f;	// ACMR the overdraw pass may give up, as a ratio
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// How a triangle list uses a FIFO post-transform cache of a given size
+//	ACMR: vertex shader runs per triangle; 3 for a triangle soup, about 0.5 at best for a regular grid
+//	ATVR: vertex shader runs per vertex the list references; 1 is every vertex shaded exactly once
+struct MeshCacheStats
+{
+	uint	m_numTriangles = 0;
+	uint	m_numVertices = 0;			// distinct vertices referenced
+	uint	m_numTransformed = 0;		// cache misses
+	float	m_acmr = 0.f;
+	float	m_atvr = 0.f;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct MeshOptimizerReport
+{
+	MeshCacheStats	m_before;
+	MeshCacheStats	m_after;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Mesh optimization, CPU only and for indexed triangle lists. Every pass keeps the same set of triangles with the
+// same winding; only their order and the order of the vertices change.
+//
+//	OptimizeVertexCache	- Tipsify (Sander, Nehab & Barczak 2007): fans around a vertex at a time, moving to a neighbour
+//						  still in the cache, so each vertex is shaded about once
+//	OptimizeOverdraw	- splits the cache-ordered list where the cache starts cold and sorts those clusters so the ones
+//						  facing out from the middle of the mesh draw first; kept only within threshold of the ACMR
+//	OptimizeVertexFetch	- renumbers vertices in the order the indices first use them, so fetches walk the vertex buffer
+//						  forward; unreferenced vertices are kept, after the rest
+//
+// OptimizeIndexedMesh runs all three and never leaves the cache worse than it found it.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+MeshCacheStats		AnalyzeVertexCache( uint const* indices, size_t indexCount, uint vertexCount, uint cacheSize = MESH_OPTIMIZER_DEFAULT_CACHE_SIZE );
+
+void				OptimizeVertexCache( uint* indices, size_t indexCount, uint vertexCount, uint cacheSize = MESH_OPTIMIZER_DEFAULT_CACHE_SIZE );
+void				OptimizeOverdraw( uint* indices, size_t indexCount, void const* vertices, size_t vertexStride, size_t positionOffset, uint vertexCount,
+						uint cacheSize = MESH_OPTIMIZER_DEFAULT_CACHE_SIZE, float threshold = MESH_OPTIMIZER_DEFAULT_OVERDRAW_THRESHOLD );
+uint				OptimizeVertexFetch( void* vertices, size_t vertexStride, uint vertexCount, uint* indices, size_t indexCount );	// returns vertices referenced
+
+MeshOptimizerReport	OptimizeIndexedMesh( void* vertices, size_t vertexStride, size_t positionOffset, uint vertexCount, uint* indices, size_t indexCount,
+						uint cacheSize = MESH_OPTIMIZER_DEFAULT_CACHE_SIZE );
+
+// For any vertex type with a Vec3 m_position
+template< typename VERTEX_TYPE >
+MeshOptimizerReport OptimizeIndexedMesh( std::vector<VERTEX_TYPE>& vertices, std::vector<uint>& indices, uint cacheSize = MESH_OPTIMIZER_DEFAULT_CACHE_SIZE )
+{
+	if( vertices.empty() || indices.empty() ) {
+		return MeshOptimizerReport();
+	}
+	return OptimizeIndexedMesh( &vertices[0], sizeof( VERTEX_TYPE ), offsetof( VERTEX_TYPE, m_position ), (uint)vertices.size(), &indices[0], indices.size(), cacheSize );
+}
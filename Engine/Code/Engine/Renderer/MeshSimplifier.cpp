@@ -0,0 +1,486 @@
+#include "Engine/Renderer/MeshSimplifier.hpp"
+#include "Engine/Renderer/Camera.hpp"
+#include "Engine/Renderer/MeshOptimizer.hpp"
+#include "Engine/Renderer/MeshUtils.hpp"
+#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static constexpr uint NO_VERTEX = 0xffffffff;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Sum of squared distances to a set of planes, as the symmetric matrix A, vector b and constant c of p.A.p + 2b.p + c
+struct Quadric
+{
+	float	m_a00 = 0.f, m_a11 = 0.f, m_a22 = 0.f, m_a01 = 0.f, m_a02 = 0.f, m_a12 = 0.f;
+	float	m_b0 = 0.f, m_b1 = 0.f, m_b2 = 0.f;
+	float	m_c = 0.f;
+
+	void AddPlane( Vec3 const& normal, float distance )
+	{
+		m_a00 += normal.x * normal.x;	m_a11 += normal.y * normal.y;	m_a22 += normal.z * normal.z;
+		m_a01 += normal.x * normal.y;	m_a02 += normal.x * normal.z;	m_a12 += normal.y * normal.z;
+		m_b0 += normal.x * distance;	m_b1 += normal.y * distance;	m_b2 += normal.z * distance;
+		m_c += distance * distance;
+	}
+
+	void operator+=( Quadric const& other )
+	{
+		m_a00 += other.m_a00;	m_a11 += other.m_a11;	m_a22 += other.m_a22;
+		m_a01 += other.m_a01;	m_a02 += other.m_a02;	m_a12 += other.m_a12;
+		m_b0 += other.m_b0;		m_b1 += other.m_b1;		m_b2 += other.m_b2;
+		m_c += other.m_c;
+	}
+
+	float GetError( Vec3 const& p ) const
+	{
+		float error = m_a00 * p.x * p.x + m_a11 * p.y * p.y + m_a22 * p.z * p.z
+			+ 2.f * ( m_a01 * p.x * p.y + m_a02 * p.x * p.z + m_a12 * p.y * p.z )
+			+ 2.f * ( m_b0 * p.x + m_b1 * p.y + m_b2 * p.z )
+			+ m_c;
+		return fmaxf( error, 0.f );
+	}
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct EdgeCollapse
+{
+	uint	m_from = 0;		// vertex
+	uint	m_to = 0;
+	float	m_cost = 0.f;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static void GetMeshBounds( std::vector<Vertex_PCUTBN> const& vertices, Vec3& out_center, float& out_radius )
+{
+	out_center = Vec3();
+	out_radius = 0.f;
+	if( vertices.empty() ) {
+		return;
+	}
+
+	Vec3 mins = vertices[0].m_position;
+	Vec3 maxs = vertices[0].m_position;
+	for( Vertex_PCUTBN const& vertex : vertices ) {
+		mins = Vec3( fminf( mins.x, vertex.m_position.x ), fminf( mins.y, vertex.m_position.y ), fminf( mins.z, vertex.m_position.z ) );
+		maxs = Vec3( fmaxf( maxs.x, vertex.m_position.x ), fmaxf( maxs.y, vertex.m_position.y ), fmaxf( maxs.z, vertex.m_position.z ) );
+	}
+	out_center = ( mins + maxs ) * 0.5f;
+	for( Vertex_PCUTBN const& vertex : vertices ) {
+		out_radius = fmaxf( out_radius, ( vertex.m_position - out_center ).GetLength() );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Numbers vertices by position: vertices with bit-identical positions share a number. Returns how many there are.
+static uint BuildPositionIds( std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint>& out_positionIds, std::vector<uint>& out_wedgeCounts, std::vector<Vec3>& out_positions )
+{
+	std::vector<uint> order( vertices.size() );
+	for( uint vertex = 0; vertex < (uint)vertices.size(); ++vertex ) {
+		order[vertex] = vertex;
+	}
+	auto isPositionLess = [&vertices]( uint a, uint b ) {
+		Vec3 const& pa = vertices[a].m_position;
+		Vec3 const& pb = vertices[b].m_position;
+		if( pa.x != pb.x ) return pa.x < pb.x;
+		if( pa.y != pb.y ) return pa.y < pb.y;
+		if( pa.z != pb.z ) return pa.z < pb.z;
+		return a < b;
+	};
+	std::sort( order.begin(), order.end(), isPositionLess );
+
+	out_positionIds.assign( vertices.size(), 0 );
+	out_wedgeCounts.clear();
+	out_positions.clear();
+	for( size_t orderIdx = 0; orderIdx < order.size(); ++orderIdx ) {
+		uint vertex = order[orderIdx];
+		if( orderIdx == 0 || !( vertices[order[orderIdx - 1]].m_position == vertices[vertex].m_position ) ) {
+			out_wedgeCounts.push_back( 0 );
+			out_positions.push_back( vertices[vertex].m_position );
+		}
+		out_positionIds[vertex] = (uint)out_wedgeCounts.size() - 1;
+		++out_wedgeCounts.back();
+	}
+	return (uint)out_wedgeCounts.size();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Moving from onto to must not turn any remaining triangle around from over, and must not swap its shading normal for
+// one too different
+static bool IsCollapseValid( uint from, uint to, std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint> const& positionIds, std::vector<Vec3> const& positions,
+	std::vector<uint> const& indices, std::vector<uint> const& triangleOffsets, std::vector<uint> const& triangles )
+{
+	if( DotProduct( vertices[from].m_normal, vertices[to].m_normal ) < MESH_SIMPLIFY_MIN_NORMAL_DOT ) {
+		return false;
+	}
+
+	uint fromPosition = positionIds[from];
+	uint toPosition = positionIds[to];
+	for( uint adjacencyIdx = triangleOffsets[fromPosition]; adjacencyIdx < triangleOffsets[fromPosition + 1]; ++adjacencyIdx ) {
+		uint const* corners = &indices[triangles[adjacencyIdx] * 3];
+		uint cornerPositions[3] = { positionIds[corners[0]], positionIds[corners[1]], positionIds[corners[2]] };
+		if( cornerPositions[0] == toPosition || cornerPositions[1] == toPosition || cornerPositions[2] == toPosition ) {
+			continue;	// collapses away
+		}
+
+		Vec3 before[3];
+		Vec3 after[3];
+		for( int corner = 0; corner < 3; ++corner ) {
+			before[corner] = positions[cornerPositions[corner]];
+			after[corner] = cornerPositions[corner] == fromPosition ? positions[toPosition] : before[corner];
+		}
+		Vec3 normalBefore = CrossProduct( before[1] - before[0], before[2] - before[0] );
+		Vec3 normalAfter = CrossProduct( after[1] - after[0], after[2] - after[0] );
+		if( DotProduct( normalBefore, normalAfter ) <= 0.f ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+float SimplifyMesh( std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint> const& indices, uint targetIndexCount, float targetError, std::vector<uint>& out_indices )
+{
+	GUARANTEE_OR_DIE( indices.size() % 3 == 0, "SimplifyMesh needs a triangle list" );
+
+	std::vector<uint> positionIds;
+	std::vector<uint> wedgeCounts;
+	std::vector<Vec3> positions;
+	uint numPositions = BuildPositionIds( vertices, positionIds, wedgeCounts, positions );
+
+	Vec3 boundsCenter;
+	float boundsRadius = 0.f;
+	GetMeshBounds( vertices, boundsCenter, boundsRadius );
+	float errorScale = boundsRadius > 0.f ? boundsRadius : 1.f;
+	float errorLimitSq = ( targetError * errorScale ) * ( targetError * errorScale );
+
+	// start from the triangles that have area in position terms
+	out_indices.clear();
+	out_indices.reserve( indices.size() );
+	for( size_t indexIdx = 0; indexIdx < indices.size(); indexIdx += 3 ) {
+		uint a = positionIds[indices[indexIdx + 0]];
+		uint b = positionIds[indices[indexIdx + 1]];
+		uint c = positionIds[indices[indexIdx + 2]];
+		if( a != b && b != c && a != c ) {
+			out_indices.insert( out_indices.end(), &indices[indexIdx], &indices[indexIdx] + 3 );
+		}
+	}
+
+	// seams, open borders and non-manifold edges stay put: an edge used by anything but exactly two triangles locks both ends
+	std::vector<uint8_t> isLocked( numPositions, 0 );
+	for( uint position = 0; position < numPositions; ++position ) {
+		isLocked[position] = wedgeCounts[position] > 1 ? 1 : 0;
+	}
+	std::vector<uint64_t> edges;
+	edges.reserve( out_indices.size() );
+	for( size_t indexIdx = 0; indexIdx < out_indices.size(); ++indexIdx ) {
+		uint64_t a = positionIds[out_indices[indexIdx]];
+		uint64_t b = positionIds[out_indices[indexIdx % 3 == 2 ? indexIdx - 2 : indexIdx + 1]];
+		edges.push_back( a < b ? ( a << 32 ) | b : ( b << 32 ) | a );
+	}
+	std::sort( edges.begin(), edges.end() );
+	for( size_t edgeIdx = 0; edgeIdx < edges.size(); ) {
+		size_t runEnd = edgeIdx;
+		while( runEnd < edges.size() && edges[runEnd] == edges[edgeIdx] ) {
+			++runEnd;
+		}
+		if( runEnd - edgeIdx != 2 ) {
+			isLocked[(uint)( edges[edgeIdx] >> 32 )] = 1;
+			isLocked[(uint)( edges[edgeIdx] & 0xffffffff )] = 1;
+		}
+		edgeIdx = runEnd;
+	}
+
+	// the planes of each position's triangles
+	std::vector<Quadric> quadrics( numPositions );
+	for( size_t indexIdx = 0; indexIdx < out_indices.size(); indexIdx += 3 ) {
+		uint corners[3] = { positionIds[out_indices[indexIdx]], positionIds[out_indices[indexIdx + 1]], positionIds[out_indices[indexIdx + 2]] };
+		Vec3 normal = CrossProduct( positions[corners[1]] - positions[corners[0]], positions[corners[2]] - positions[corners[0]] );
+		float length = normal.GetLength();
+		if( length <= 0.f ) {
+			continue;
+		}
+		normal = normal / length;
+		float distance = -DotProduct( normal, positions[corners[0]] );
+		for( uint corner : corners ) {
+			quadrics[corner].AddPlane( normal, distance );
+		}
+	}
+
+	std::vector<uint> triangleOffsets( numPositions + 1 );
+	std::vector<uint> triangleCursors( numPositions );
+	std::vector<uint> triangles;
+	std::vector<EdgeCollapse> collapses;
+	std::vector<uint8_t> isTouched( numPositions );
+	std::vector<uint> collapseTargets( vertices.size() );
+	float maxErrorSq = 0.f;
+
+	while( out_indices.size() > targetIndexCount ) {
+		uint numTriangles = (uint)( out_indices.size() / 3 );
+
+		// triangles around each position
+		std::fill( triangleOffsets.begin(), triangleOffsets.end(), 0 );
+		for( uint index : out_indices ) {
+			++triangleOffsets[positionIds[index] + 1];
+		}
+		for( uint position = 0; position < numPositions; ++position ) {
+			triangleOffsets[position + 1] += triangleOffsets[position];
+			triangleCursors[position] = triangleOffsets[position];
+		}
+		triangles.resize( out_indices.size() );
+		for( size_t indexIdx = 0; indexIdx < out_indices.size(); ++indexIdx ) {
+			triangles[triangleCursors[positionIds[out_indices[indexIdx]]]++] = (uint)( indexIdx / 3 );
+		}
+
+		// every movable corner onto either other corner of its triangle, cheapest first
+		collapses.clear();
+		for( size_t indexIdx = 0; indexIdx < out_indices.size(); ++indexIdx ) {
+			uint from = out_indices[indexIdx];
+			if( isLocked[positionIds[from]] ) {
+				continue;
+			}
+			size_t triangleStart = indexIdx - indexIdx % 3;
+			for( int step = 1; step <= 2; ++step ) {
+				EdgeCollapse collapse;
+				collapse.m_from = from;
+				collapse.m_to = out_indices[triangleStart + ( indexIdx - triangleStart + step ) % 3];
+				Quadric merged = quadrics[positionIds[from]];
+				merged += quadrics[positionIds[collapse.m_to]];
+				collapse.m_cost = merged.GetError( positions[positionIds[collapse.m_to]] );
+				collapses.push_back( collapse );
+			}
+		}
+		std::sort( collapses.begin(), collapses.end(), []( EdgeCollapse const& a, EdgeCollapse const& b ) {
+			if( a.m_cost != b.m_cost ) return a.m_cost < b.m_cost;
+			if( a.m_from != b.m_from ) return a.m_from < b.m_from;
+			return a.m_to < b.m_to;
+		} );
+
+		// take as many as this pass can without two of them touching the same triangles
+		std::fill( isTouched.begin(), isTouched.end(), (uint8_t)0 );
+		std::fill( collapseTargets.begin(), collapseTargets.end(), NO_VERTEX );
+		uint numToRemove = numTriangles - targetIndexCount / 3;
+		uint numRemoved = 0;
+		uint numCollapses = 0;
+		for( EdgeCollapse const& collapse : collapses ) {
+			if( collapse.m_cost > errorLimitSq || numRemoved >= numToRemove ) {
+				break;
+			}
+			uint fromPosition = positionIds[collapse.m_from];
+			uint toPosition = positionIds[collapse.m_to];
+			if( isTouched[fromPosition] || isTouched[toPosition] ) {
+				continue;
+			}
+			if( !IsCollapseValid( collapse.m_from, collapse.m_to, vertices, positionIds, positions, out_indices, triangleOffsets, triangles ) ) {
+				continue;
+			}
+
+			// an unlocked position has exactly one vertex, so every corner there is m_from
+			collapseTargets[collapse.m_from] = collapse.m_to;
+			quadrics[toPosition] += quadrics[fromPosition];
+			maxErrorSq = fmaxf( maxErrorSq, collapse.m_cost );
+			++numCollapses;
+			for( uint adjacencyIdx = triangleOffsets[fromPosition]; adjacencyIdx < triangleOffsets[fromPosition + 1]; ++adjacencyIdx ) {
+				uint const* corners = &out_indices[triangles[adjacencyIdx] * 3];
+				bool hasTo = false;
+				for( int corner = 0; corner < 3; ++corner ) {
+					isTouched[positionIds[corners[corner]]] = 1;
+					hasTo = hasTo || positionIds[corners[corner]] == toPosition;
+				}
+				numRemoved += hasTo ? 1 : 0;
+			}
+		}
+		if( numCollapses == 0 ) {
+			break;
+		}
+
+		// apply them and drop what collapsed to a line
+		size_t numKept = 0;
+		for( size_t indexIdx = 0; indexIdx < out_indices.size(); indexIdx += 3 ) {
+			uint corners[3];
+			for( int corner = 0; corner < 3; ++corner ) {
+				uint vertex = out_indices[indexIdx + corner];
+				corners[corner] = collapseTargets[vertex] != NO_VERTEX ? collapseTargets[vertex] : vertex;
+			}
+			uint a = positionIds[corners[0]];
+			uint b = positionIds[corners[1]];
+			uint c = positionIds[corners[2]];
+			if( a != b && b != c && a != c ) {
+				out_indices[numKept++] = corners[0];
+				out_indices[numKept++] = corners[1];
+				out_indices[numKept++] = corners[2];
+			}
+		}
+		out_indices.resize( numKept );
+	}
+
+	return sqrtf( maxErrorSq ) / errorScale;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void BuildMeshLODChain( std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint>& indices, MeshLODChain& out_chain, mesh_lod_options_t const& options )
+{
+	out_chain = MeshLODChain();
+	GetMeshBounds( vertices, out_chain.m_boundsCenter, out_chain.m_boundsRadius );
+
+	MeshLOD sourceLOD;
+	sourceLOD.m_indexCount = (uint)indices.size();
+	out_chain.m_lods.push_back( sourceLOD );
+
+	// each LOD is simplified from the last, so their errors add up
+	std::vector<uint> previousIndices = indices;
+	std::vector<uint> lodIndices;
+	for( float errorTarget : options.error_targets ) {
+		MeshLOD const& previousLOD = out_chain.m_lods.back();
+		uint previousTriangles = previousLOD.m_indexCount / 3;
+		if( previousTriangles <= options.min_triangles ) {
+			break;
+		}
+
+		uint targetTriangles = std::max( options.min_triangles, (uint)( previousTriangles * options.triangle_ratio ) );
+		float error = SimplifyMesh( vertices, previousIndices, targetTriangles * 3, fmaxf( errorTarget - previousLOD.m_error, 0.f ), lodIndices );
+		if( lodIndices.empty() || lodIndices.size() / 3 > previousTriangles * 9 / 10 ) {
+			continue;	// not worth a level; a looser target may still be
+		}
+		OptimizeVertexCache( lodIndices.data(), lodIndices.size(), (uint)vertices.size() );
+
+		MeshLOD lod;
+		lod.m_indexOffset = (uint)indices.size();
+		lod.m_indexCount = (uint)lodIndices.size();
+		lod.m_error = previousLOD.m_error + error;
+		indices.insert( indices.end(), lodIndices.begin(), lodIndices.end() );
+		out_chain.m_lods.push_back( lod );
+		previousIndices.swap( lodIndices );
+	}
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+float GetProjectedRadiusPixels( Camera const& camera, Mat44 const& modelMatrix, Vec3 const& center, float radius )
+{
+	float scale = fmaxf( modelMatrix.GetIBasis3D().GetLength(), fmaxf( modelMatrix.GetJBasis3D().GetLength(), modelMatrix.GetKBasis3D().GetLength() ) );
+	float worldRadius = radius * scale;
+	Vec3 viewCenter = camera.GetViewMatrix().TransformPosition3D( modelMatrix.TransformPosition3D( center ) );
+
+	// clip w is the distance along the view direction for a perspective projection
+	Mat44 projection = camera.GetProjectionMatrix();
+	float depth = projection.Iw * viewCenter.x + projection.Jw * viewCenter.y + projection.Kw * viewCenter.z + projection.Tw;
+	if( depth <= worldRadius ) {
+		return FLT_MAX;
+	}
+
+	Vec2 outputSize = camera.m_outputSize;
+	Texture* colorTarget = camera.GetColorTarget();
+	if( colorTarget != nullptr ) {
+		IntVec2 texelSize = colorTarget->GetTexelSize();
+		outputSize = Vec2( (float)texelSize.x, (float)texelSize.y );
+	}
+	float xScale = Vec3( projection.Ix, projection.Jx, projection.Kx ).GetLength() * outputSize.x;
+	float yScale = Vec3( projection.Iy, projection.Jy, projection.Ky ).GetLength() * outputSize.y;
+	return worldRadius * 0.5f * fmaxf( xScale, yScale ) / depth;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+int SelectMeshLOD( MeshLODChain const& chain, float projectedRadiusPixels, float maxPixelError )
+{
+	for( int lodIdx = (int)chain.m_lods.size() - 1; lodIdx > 0; --lodIdx ) {
+		if( chain.m_lods[lodIdx].m_error * projectedRadiusPixels <= maxPixelError ) {
+			return lodIdx;
+		}
+	}
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+int SelectMeshLOD( MeshLODChain const& chain, Mat44 const& modelMatrix, Camera const* const* cameras, int numCameras, float maxPixelError )
+{
+	float projectedRadiusPixels = 0.f;
+	for( int cameraIdx = 0; cameraIdx < numCameras; ++cameraIdx ) {
+		projectedRadiusPixels = fmaxf( projectedRadiusPixels, GetProjectedRadiusPixels( *cameras[cameraIdx], modelMatrix, chain.m_boundsCenter, chain.m_boundsRadius ) );
+	}
+	return SelectMeshLOD( chain, projectedRadiusPixels, maxPixelError );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Builds the LOD chain of a TBN UV sphere and checks each level: valid, no collapsed triangles, fewer triangles than
+// the last, and every seam vertex (the UV seam column and the poles) still in use. Then shows which LOD a 1440-pixel,
+// 100-degree eye picks at a few distances.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_mesh_lod, "cuts,iterations" )
+{
+	int numCuts = Clamp( args.GetValue( "cuts", 64 ), 8, 512 );
+	int numIterations = args.GetValue( "iterations", 5 );
+	if( numIterations <= 0 ) {
+		g_theConsole->Error( "benchmark_mesh_lod: iterations must be positive" );
+		return;
+	}
+
+	std::vector<Vertex_PCUTBN> vertices;
+	std::vector<uint> sourceIndices;
+	AddUVSphereToIndexedVertexArrayTBN( vertices, sourceIndices, Vec3::ZERO, 1.f, (uint)numCuts, (uint)numCuts, Rgba8::WHITE );
+
+	std::vector<uint> indices;
+	MeshLODChain chain;
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int iteration = 0; iteration < numIterations; ++iteration ) {
+		indices = sourceIndices;
+		BuildMeshLODChain( vertices, indices, chain );
+	}
+	double buildSeconds = ( GetCurrentTimeSeconds() - startSeconds ) / numIterations;
+
+	std::vector<uint> positionIds;
+	std::vector<uint> wedgeCounts;
+	std::vector<Vec3> positions;
+	BuildPositionIds( vertices, positionIds, wedgeCounts, positions );
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Mesh LOD chain, %i-cut sphere, %u triangles, %.2f ms to build (x %i iterations)",
+		numCuts, (uint)( sourceIndices.size() / 3 ), buildSeconds * 1000.0, numIterations ) );
+
+	bool isEveryLODValid = true;
+	std::vector<uint8_t> isUsed;
+	for( size_t lodIdx = 0; lodIdx < chain.m_lods.size(); ++lodIdx ) {
+		MeshLOD const& lod = chain.m_lods[lodIdx];
+		bool isValid = lod.m_indexCount % 3 == 0 && lod.m_indexOffset + lod.m_indexCount <= indices.size();
+		isValid = isValid && ( lodIdx == 0 || lod.m_indexCount < chain.m_lods[lodIdx - 1].m_indexCount );
+
+		isUsed.assign( vertices.size(), 0 );
+		for( uint indexIdx = lod.m_indexOffset; isValid && indexIdx < lod.m_indexOffset + lod.m_indexCount; indexIdx += 3 ) {
+			uint const* corners = &indices[indexIdx];
+			isValid = corners[0] < vertices.size() && corners[1] < vertices.size() && corners[2] < vertices.size();
+			isValid = isValid && positionIds[corners[0]] != positionIds[corners[1]] && positionIds[corners[1]] != positionIds[corners[2]] && positionIds[corners[0]] != positionIds[corners[2]];
+			for( int corner = 0; isValid && corner < 3; ++corner ) {
+				isUsed[corners[corner]] = 1;
+			}
+		}
+		for( size_t indexIdx = 0; isValid && indexIdx < sourceIndices.size(); ++indexIdx ) {
+			uint vertex = sourceIndices[indexIdx];
+			isValid = wedgeCounts[positionIds[vertex]] == 1 || isUsed[vertex];
+		}
+		isEveryLODValid = isEveryLODValid && isValid;
+
+		g_theConsole->PrintString( isValid ? Rgba8::WHITE : Rgba8::RED, Stringf( "  LOD %i  %6u triangles  error %.4f of radius", (int)lodIdx, lod.m_indexCount / 3, lod.m_error ) );
+	}
+
+	// a 100 degree vertical field of view over 1440 pixels
+	float pixelsPerUnitAtUnitDepth = 720.f / tanf( ConvertDegreesToRadians( 50.f ) );
+	std::string selections;
+	float distances[] = { 1.f, 4.f, 16.f, 64.f };
+	for( float distance : distances ) {
+		int lodIdx = SelectMeshLOD( chain, chain.m_boundsRadius * pixelsPerUnitAtUnitDepth / distance );
+		selections += Stringf( "  %gm: LOD %i", distance, lodIdx );
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  1 px error at 1440 px, 100 degrees:%s", selections.c_str() ) );
+	Rgba8 resultColor = isEveryLODValid ? Rgba8::GREEN : Rgba8::RED;
+	g_theConsole->PrintString( resultColor, Stringf( "  every LOD valid, smaller than the last and keeps its seams: %s", isEveryLODValid ? "yes" : "NO" ) );
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "Engine/Core/Vertex_PCUTBN.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+typedef unsigned int uint;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class Camera;
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+
+constexpr float MESH_SIMPLIFY_MIN_NORMAL_DOT = 0.7f;		// a collapse may not swap a shading normal for one more than ~45 degrees off
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct mesh_lod_options_t
+{
+	std::vector<float>	error_targets = { 0.005f, 0.02f, 0.05f, 0.12f };	// one LOD each, as a fraction of the mesh's bounding radius
+	float				triangle_ratio = 0.5f;		// each LOD keeps at most this fraction of the previous one's triangles
+	uint				min_triangles = 16;			// the chain stops rather than go below this
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct MeshLOD
+{
+	uint	m_indexOffset = 0;
+	uint	m_indexCount = 0;
+	float	m_error = 0.f;			// fraction of the bounding radius; 0 for the source mesh
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Every LOD indexes the same vertex array, one after another in the same index array, so one GPUMesh holds the whole
+// chain and a LOD is drawn with DrawMesh( mesh, m_indexOffset, m_indexCount ).
+struct MeshLODChain
+{
+	std::vector<MeshLOD>	m_lods;				// finest first
+	Vec3					m_boundsCenter;		// model space
+	float					m_boundsRadius = 0.f;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Quadric edge-collapse simplification (Garland & Heckbert 1997), as half-edge collapses: a vertex moves onto one of
+// its neighbours, so the result indexes the unchanged vertex array and every surviving vertex keeps its exact UV,
+// tangent frame and normal.
+//	- vertices sharing a position with a differently attributed one (UV seams, hard edges) and vertices on open borders
+//	  never move, so seams and silhouettes of open meshes stay where they are
+//	- a collapse is refused if it flips a triangle or swaps a shading normal for one too far off
+// Collapses are made cheapest first, in passes, until the index count is at or below targetIndexCount or the next
+// collapse would cost more than targetError (a fraction of the bounding radius). Returns the error reached, in the
+// same units.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+float	SimplifyMesh( std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint> const& indices, uint targetIndexCount, float targetError, std::vector<uint>& out_indices );
+
+// Appends one simplified LOD per error target to indices (LOD 0 is what indices held on entry), each cache-optimized;
+// a target that removes under a tenth of the previous LOD's triangles is skipped
+void	BuildMeshLODChain( std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint>& indices, MeshLODChain& out_chain, mesh_lod_options_t const& options = mesh_lod_options_t() );
+
+// Screen-space radius, in pixels, of a model-space sphere drawn with modelMatrix through camera's perspective projection;
+// FLT_MAX when the sphere reaches the camera plane
+float	GetProjectedRadiusPixels( Camera const& camera, Mat44 const& modelMatrix, Vec3 const& center, float radius );
+
+// The coarsest LOD whose error stays within maxPixelError at that projected radius
+int		SelectMeshLOD( MeshLODChain const& chain, float projectedRadiusPixels, float maxPixelError = 1.f );
+
+// The same for the object seen from several cameras, e.g. both eyes: the finest any of them needs, so eyes never disagree
+int		SelectMeshLOD( MeshLODChain const& chain, Mat44 const& modelMatrix, Camera const* const* cameras, int numCameras, float maxPixelError = 1.f );
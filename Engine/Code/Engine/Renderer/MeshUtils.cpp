@@ -108,7 +108,7 @@ void LoadOBJToVertexArray( std::vector<Vertex_PCUTBN>& out, std::vector<uint>& i
 	
 	// Generate Mikkt tangents
 	if( options.generate_tangents ) {
-		GenerateTangentsForVertexArray( out );
+		GenerateTangentsForIndexedMesh( out, indices );
 	}
 	file.close();
 }
@@ -393,6 +393,66 @@ void VertexTriangluation( std::vector<uint>& oIndices, const std::vector<Vertex_
 	}
 }
 
+//-------------------------------------------------------------------------------------------------------------
+static uint64_t HashVertexBytes( Vertex_PCUTBN const& vertex )
+{
+	// FNV-1a
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>( &vertex );
+	uint64_t hash = 14695981039346656037ull;
+	for( size_t byteIdx = 0; byteIdx < sizeof( Vertex_PCUTBN ); ++byteIdx )
+	{
+		hash = ( hash ^ bytes[byteIdx] ) * 1099511628211ull;
+	}
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void WeldVertexArray( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices )
+{
+	if( indices.empty() )
+	{
+		indices.resize( vertices.size() );
+		for( uint idx = 0; idx < (uint)vertices.size(); ++idx )
+		{
+			indices[idx] = idx;
+		}
+	}
+
+	// open addressing at most half full; a slot holds welded index + 1, 0 is empty
+	size_t tableSize = 16;
+	while( tableSize < 2 * vertices.size() )
+	{
+		tableSize <<= 1;
+	}
+	std::vector<uint> table( tableSize, 0 );
+	std::vector<uint> remap( vertices.size() );
+	uint numWelded = 0;
+
+	for( size_t vertIdx = 0; vertIdx < vertices.size(); ++vertIdx )
+	{
+		Vertex_PCUTBN const& vertex = vertices[vertIdx];
+		size_t slot = (size_t)HashVertexBytes( vertex ) & ( tableSize - 1 );
+		while( table[slot] != 0 && memcmp( &vertices[table[slot] - 1], &vertex, sizeof( Vertex_PCUTBN ) ) != 0 )
+		{
+			slot = ( slot + 1 ) & ( tableSize - 1 );
+		}
+
+		if( table[slot] == 0 )
+		{
+			// welded vertices are compacted in place; everything before numWelded is already final
+			vertices[numWelded] = vertex;
+			table[slot] = ++numWelded;
+		}
+		remap[vertIdx] = table[slot] - 1;
+	}
+
+	vertices.resize( numWelded );
+	for( uint& index : indices )
+	{
+		index = remap[index];
+	}
+}
+
 //bool BInitAssimp(  )
 //{
 //	const aiScene* scene = aiImportFile( "Data/Models/vr_controller_vive_1_5.obj", aiProcessPreset_TargetRealtime_MaxQuality );
@@ -35,6 +35,9 @@ void GenVerticesFromRawOBJ( std::vector<Vertex_PCUTBN>& oVerts,
 // Triangulate a list of vertices into a face by printing
 //	indices corresponding with triangles within it
 void VertexTriangluation( std::vector<uint>& oIndices, const std::vector<Vertex_PCUTBN>& iVerts );
+
+// Merges bit-identical vertices and rewrites the indices to match; empty indices are read as 0..n-1
+void WeldVertexArray( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices );
 //-----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 //-------------------------------------------------------------------------------------------------------------
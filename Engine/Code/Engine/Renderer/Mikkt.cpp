@@ -2,67 +2,86 @@
 #include "Engine/Math/Vec4.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
 
-int GetNumFaces( SMikkTSpaceContext const* pContext )
+extern JobSystem*	g_theJobSystem;
+
+static constexpr uint NO_VERTEX = 0xffffffff;
+
+//----------------------------------------------------------------------------------------------------------------------------------
+// One MikkTSpace run: the faces it sees (sorted, owned and neighbouring) and the range it owns output for
+struct MikktChunk
 {
-	//std::vector<Vertex_PCUTBN>* vertices = context->m_pUserData;
-	std::vector<Vertex_PCUTBN>& vertices = *(std::vector<Vertex_PCUTBN>*)(pContext->m_pUserData);
-	return (int)vertices.size() / 3;
-}
+	Vertex_PCUTBN const*	m_vertices = nullptr;
+	uint const*				m_indices = nullptr;
+	std::vector<uint>		m_faces;
+	uint					m_firstOwnedFace = 0;
+	uint					m_endOwnedFace = 0;
+	Vec4*					m_cornerTangents = nullptr;		// xyz tangent, w sign; one per index
+};
 
-int GetNumberOfVerticesForFace( SMikkTSpaceContext const* pContext, const int iFace )
+//----------------------------------------------------------------------------------------------------------------------------------
+static Vertex_PCUTBN const& GetChunkVertex( SMikkTSpaceContext const* pContext, int iFace, int iVert )
 {
-	UNUSED(pContext);
-	UNUSED(iFace);
-	return 3;
+	MikktChunk const* chunk = reinterpret_cast<MikktChunk const*>( pContext->m_pUserData );
+	return chunk->m_vertices[chunk->m_indices[chunk->m_faces[iFace] * 3 + iVert]];
 }
 
-void GetPositionForFaceVert( const SMikkTSpaceContext* pContext, float fvPosOut[], const int iFace, const int iVert )
+static int GetNumFaces( SMikkTSpaceContext const* pContext )
 {
-	std::vector<Vertex_PCUTBN>& vertices = *(std::vector<Vertex_PCUTBN>*)(pContext->m_pUserData);
-	int indexInVertexArray = iFace * 3 + iVert;
+	return (int)reinterpret_cast<MikktChunk const*>( pContext->m_pUserData )->m_faces.size();
+}
 
-	Vec3 outPos = vertices[indexInVertexArray].m_position;
+static int GetNumberOfVerticesForFace( SMikkTSpaceContext const* pContext, const int iFace )
+{
+	UNUSED( pContext );
+	UNUSED( iFace );
+	return 3;
+}
 
+static void GetPositionForFaceVert( const SMikkTSpaceContext* pContext, float fvPosOut[], const int iFace, const int iVert )
+{
+	Vec3 const& outPos = GetChunkVertex( pContext, iFace, iVert ).m_position;
 	fvPosOut[0] = outPos.x;
 	fvPosOut[1] = outPos.y;
 	fvPosOut[2] = outPos.z;
 }
 
-void GetNormalForFaceVert( const SMikkTSpaceContext* pContext, float fvNormOut[], const int iFace, const int iVert )
+static void GetNormalForFaceVert( const SMikkTSpaceContext* pContext, float fvNormOut[], const int iFace, const int iVert )
 {
-	std::vector<Vertex_PCUTBN>& vertices = *(std::vector<Vertex_PCUTBN>*)(pContext->m_pUserData);
-	int indexInVertexArray = iFace * 3 + iVert;
-
-	Vec3 outNorm = vertices[indexInVertexArray].m_normal;
-
+	Vec3 const& outNorm = GetChunkVertex( pContext, iFace, iVert ).m_normal;
 	fvNormOut[0] = outNorm.x;
 	fvNormOut[1] = outNorm.y;
 	fvNormOut[2] = outNorm.z;
 }
 
-void GetUVForFaceVert( const SMikkTSpaceContext* pContext, float fvTexcOut[], const int iFace, const int iVert )
+static void GetUVForFaceVert( const SMikkTSpaceContext* pContext, float fvTexcOut[], const int iFace, const int iVert )
 {
-	std::vector<Vertex_PCUTBN>& vertices = *(std::vector<Vertex_PCUTBN>*)(pContext->m_pUserData);
-	int indexInVertexArray = iFace * 3 + iVert;
-
-	Vec2 outUV = vertices[indexInVertexArray].m_uvTexCoords;
-
+	Vec2 const& outUV = GetChunkVertex( pContext, iFace, iVert ).m_uvTexCoords;
 	fvTexcOut[0] = outUV.x;
 	fvTexcOut[1] = outUV.y;
 }
 
-void SetTangent( const SMikkTSpaceContext* pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert )
+static void SetTangent( const SMikkTSpaceContext* pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert )
 {
-	std::vector<Vertex_PCUTBN>& vertices = *(std::vector<Vertex_PCUTBN>*)( pContext->m_pUserData);
-	int indexInVertexArray = iFace * 3 + iVert;
-
-
-	vertices[indexInVertexArray].m_tangent = Vec3( fvTangent[0], fvTangent[1], fvTangent[2] );
-	vertices[indexInVertexArray].m_bitangent = CrossProduct( vertices[indexInVertexArray].m_normal, vertices[indexInVertexArray].m_tangent ) * fSign;
+	MikktChunk const* chunk = reinterpret_cast<MikktChunk const*>( pContext->m_pUserData );
+	uint face = chunk->m_faces[iFace];
+	if( face >= chunk->m_firstOwnedFace && face < chunk->m_endOwnedFace ) {
+		chunk->m_cornerTangents[face * 3 + iVert] = Vec4( fvTangent[0], fvTangent[1], fvTangent[2], fSign );
+	}
 }
 
-void GenerateTangentsForVertexArray( std::vector<Vertex_PCUTBN>& vertices )
+//----------------------------------------------------------------------------------------------------------------------------------
+static void RunMikktChunk( MikktChunk& chunk )
 {
 	SMikkTSpaceInterface interface;
 	interface.m_getNumFaces = GetNumFaces;
@@ -78,8 +97,307 @@ void GenerateTangentsForVertexArray( std::vector<Vertex_PCUTBN>& vertices )
 	// Encapsulate ONE instance of running the algorithm
 	SMikkTSpaceContext context;
 	context.m_pInterface = &interface;
-	context.m_pUserData = &vertices;
+	context.m_pUserData = &chunk;
 
 	// Run the algorithm
-	genTangSpaceDefault( &context ); 
+	genTangSpaceDefault( &context );
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------
+class MikktChunkJob : public Job
+{
+public:
+	MikktChunkJob( MikktChunk* chunk, std::atomic<int>* numChunksLeft )
+		: Job(),
+		m_chunk( chunk ),
+		m_numChunksLeft( numChunksLeft )
+	{
+		m_jobFlags = JOB_FLAG_DELETE_ON_COMPLETE;
+	}
+
+	virtual void Execute() override
+	{
+		RunMikktChunk( *m_chunk );
+		m_numChunksLeft->fetch_sub( 1 );	// the counter lives on the caller's stack, so nothing after this may touch it
+	}
+
+	virtual void OnCompleteCallback() override
+	{
+	}
+
+public:
+	MikktChunk*			m_chunk = nullptr;
+	std::atomic<int>*	m_numChunksLeft = nullptr;
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------
+// MikkTSpace welds corners with equal position, normal and UV before anything else, so those are the vertices whose
+// faces a chunk must see together
+static void BuildMikktVertexIds( std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint>& out_vertexIds )
+{
+	auto getKey = [&vertices]( uint vertex, float* out_key ) {
+		Vertex_PCUTBN const& v = vertices[vertex];
+		float key[8] = { v.m_position.x, v.m_position.y, v.m_position.z, v.m_normal.x, v.m_normal.y, v.m_normal.z, v.m_uvTexCoords.x, v.m_uvTexCoords.y };
+		memcpy( out_key, key, sizeof( key ) );
+	};
+
+	std::vector<uint> order( vertices.size() );
+	for( uint vertex = 0; vertex < (uint)vertices.size(); ++vertex ) {
+		order[vertex] = vertex;
+	}
+	std::sort( order.begin(), order.end(), [&getKey]( uint a, uint b ) {
+		float keyA[8];
+		float keyB[8];
+		getKey( a, keyA );
+		getKey( b, keyB );
+		for( int component = 0; component < 8; ++component ) {
+			if( keyA[component] != keyB[component] ) {
+				return keyA[component] < keyB[component];
+			}
+		}
+		return a < b;
+	} );
+
+	out_vertexIds.assign( vertices.size(), 0 );
+	uint nextId = 0;
+	for( size_t orderIdx = 0; orderIdx < order.size(); ++orderIdx ) {
+		if( orderIdx > 0 ) {
+			float keyA[8];
+			float keyB[8];
+			getKey( order[orderIdx - 1], keyA );
+			getKey( order[orderIdx], keyB );
+			bool isSame = true;
+			for( int component = 0; component < 8; ++component ) {
+				isSame = isSame && keyA[component] == keyB[component];
+			}
+			nextId += isSame ? 0 : 1;
+		}
+		out_vertexIds[order[orderIdx]] = nextId;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------
+static void BuildMikktChunks( std::vector<Vertex_PCUTBN> const& vertices, std::vector<uint> const& indices, uint facesPerChunk, Vec4* cornerTangents, std::vector<MikktChunk>& out_chunks )
+{
+	uint numFaces = (uint)( indices.size() / 3 );
+	uint numChunks = ( numFaces + facesPerChunk - 1 ) / facesPerChunk;
+	out_chunks.resize( numChunks );
+	for( uint chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx ) {
+		MikktChunk& chunk = out_chunks[chunkIdx];
+		chunk.m_vertices = vertices.data();
+		chunk.m_indices = indices.data();
+		chunk.m_firstOwnedFace = chunkIdx * facesPerChunk;
+		chunk.m_endOwnedFace = std::min( numFaces, chunk.m_firstOwnedFace + facesPerChunk );
+		chunk.m_cornerTangents = cornerTangents;
+	}
+	if( numChunks == 1 ) {
+		out_chunks[0].m_faces.resize( numFaces );
+		for( uint face = 0; face < numFaces; ++face ) {
+			out_chunks[0].m_faces[face] = face;
+		}
+		return;
+	}
+
+	// faces around each welded vertex
+	std::vector<uint> vertexIds;
+	BuildMikktVertexIds( vertices, vertexIds );
+	uint numIds = vertices.empty() ? 0 : *std::max_element( vertexIds.begin(), vertexIds.end() ) + 1;
+	std::vector<uint> faceOffsets( numIds + 1, 0 );
+	for( uint index : indices ) {
+		++faceOffsets[vertexIds[index] + 1];
+	}
+	for( uint id = 0; id < numIds; ++id ) {
+		faceOffsets[id + 1] += faceOffsets[id];
+	}
+	std::vector<uint> faceCursors( faceOffsets.begin(), faceOffsets.end() - 1 );
+	std::vector<uint> facesAround( indices.size() );
+	for( size_t indexIdx = 0; indexIdx < indices.size(); ++indexIdx ) {
+		facesAround[faceCursors[vertexIds[indices[indexIdx]]]++] = (uint)( indexIdx / 3 );
+	}
+
+	// a chunk sees its own faces plus every face sharing a vertex with them
+	std::vector<uint> faceStamps( numFaces, NO_VERTEX );
+	for( uint chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx ) {
+		MikktChunk& chunk = out_chunks[chunkIdx];
+		for( uint face = chunk.m_firstOwnedFace; face < chunk.m_endOwnedFace; ++face ) {
+			for( int corner = 0; corner < 3; ++corner ) {
+				uint id = vertexIds[indices[face * 3 + corner]];
+				for( uint aroundIdx = faceOffsets[id]; aroundIdx < faceOffsets[id + 1]; ++aroundIdx ) {
+					uint neighbour = facesAround[aroundIdx];
+					if( faceStamps[neighbour] != chunkIdx ) {
+						faceStamps[neighbour] = chunkIdx;
+						chunk.m_faces.push_back( neighbour );
+					}
+				}
+			}
+		}
+		std::sort( chunk.m_faces.begin(), chunk.m_faces.end() );
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------
+void GenerateTangentsForIndexedMesh( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices, uint facesPerChunk )
+{
+	GUARANTEE_OR_DIE( indices.size() % 3 == 0, "GenerateTangentsForIndexedMesh needs a triangle list" );
+	uint numFaces = (uint)( indices.size() / 3 );
+	if( numFaces == 0 ) {
+		return;
+	}
+
+	bool useWorkers = g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning();
+	if( facesPerChunk == 0 ) {
+		facesPerChunk = useWorkers ? MIKKT_DEFAULT_FACES_PER_CHUNK : numFaces;
+	}
+
+	std::vector<Vec4> cornerTangents( indices.size() );
+	std::vector<MikktChunk> chunks;
+	BuildMikktChunks( vertices, indices, facesPerChunk, cornerTangents.data(), chunks );
+
+	// the calling thread takes the first chunk, then spins until the workers have counted the others down
+	std::atomic<int> numChunksLeft( (int)chunks.size() - 1 );
+	for( size_t chunkIdx = 1; chunkIdx < chunks.size(); ++chunkIdx ) {
+		if( useWorkers ) {
+			g_theJobSystem->PostJob( new MikktChunkJob( &chunks[chunkIdx], &numChunksLeft ) );
+		}
+		else {
+			RunMikktChunk( chunks[chunkIdx] );
+			--numChunksLeft;
+		}
+	}
+	RunMikktChunk( chunks[0] );
+	while( numChunksLeft.load() > 0 ) {
+		std::this_thread::yield();
+	}
+
+	// write back; a vertex gets one copy per distinct tangent among its corners
+	uint numSourceVertices = (uint)vertices.size();
+	std::vector<uint8_t> isWritten( numSourceVertices, 0 );
+	std::vector<uint> nextCopies( numSourceVertices, NO_VERTEX );
+	for( size_t indexIdx = 0; indexIdx < indices.size(); ++indexIdx ) {
+		uint vertex = indices[indexIdx];
+		Vec4 const& result = cornerTangents[indexIdx];
+		Vec3 tangent = Vec3( result.x, result.y, result.z );
+		Vec3 bitangent = CrossProduct( vertices[vertex].m_normal, tangent ) * result.w;
+
+		if( !isWritten[vertex] ) {
+			isWritten[vertex] = 1;
+			vertices[vertex].m_tangent = tangent;
+			vertices[vertex].m_bitangent = bitangent;
+			continue;
+		}
+
+		uint match = vertex;
+		uint last = vertex;
+		while( match != NO_VERTEX && !( vertices[match].m_tangent == tangent && vertices[match].m_bitangent == bitangent ) ) {
+			last = match;
+			match = nextCopies[match];
+		}
+		if( match == NO_VERTEX ) {
+			Vertex_PCUTBN copy = vertices[vertex];
+			copy.m_tangent = tangent;
+			copy.m_bitangent = bitangent;
+			match = (uint)vertices.size();
+			vertices.push_back( copy );
+			nextCopies.push_back( NO_VERTEX );
+			nextCopies[last] = match;
+		}
+		indices[indexIdx] = match;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------
+void GenerateTangentsForVertexArray( std::vector<Vertex_PCUTBN>& vertices )
+{
+	// each vertex is one corner, so nothing is ever split
+	std::vector<uint> indices( vertices.size() / 3 * 3 );
+	for( uint index = 0; index < (uint)indices.size(); ++index ) {
+		indices[index] = index;
+	}
+	GenerateTangentsForIndexedMesh( vertices, indices );
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------
+// Compares the old path (a de-indexed soup, one MikkTSpace run over the whole mesh) with the indexed, chunked one on a
+// TBN sphere. Every corner's tangent frame must match within a small tolerance, and the indexed mesh may only grow by
+// the vertices that genuinely need splitting.
+//----------------------------------------------------------------------------------------------------------------------------------
+COMMAND( benchmark_tangents, "cuts,iterations,chunk" )
+{
+	int numCuts = Clamp( args.GetValue( "cuts", 128 ), 4, 1024 );
+	int numIterations = args.GetValue( "iterations", 3 );
+	int facesPerChunk = args.GetValue( "chunk", (int)MIKKT_DEFAULT_FACES_PER_CHUNK );
+	if( numIterations <= 0 || facesPerChunk <= 0 ) {
+		g_theConsole->Error( "benchmark_tangents: iterations and chunk must be positive" );
+		return;
+	}
+
+	// a sphere-wrapped grid with a UV seam down one side, as the MeshUtils builders make it
+	std::vector<Vertex_PCUTBN> sourceVertices;
+	std::vector<uint> sourceIndices;
+	for( int ring = 0; ring <= numCuts; ++ring ) {
+		float latitude = 90.f - 180.f * (float)ring / (float)numCuts;
+		for( int segment = 0; segment <= numCuts; ++segment ) {
+			float longitude = 360.f * (float)segment / (float)numCuts;
+			Vertex_PCUTBN vertex;
+			vertex.m_position = Vec3( CosDegrees( latitude ) * CosDegrees( longitude ), SinDegrees( latitude ), -CosDegrees( latitude ) * SinDegrees( longitude ) );
+			vertex.m_normal = vertex.m_position;
+			vertex.m_uvTexCoords = Vec2( (float)segment / (float)numCuts, 1.f - (float)ring / (float)numCuts );
+			sourceVertices.push_back( vertex );
+		}
+	}
+	uint rowLength = (uint)numCuts + 1;
+	for( uint ring = 0; ring < (uint)numCuts; ++ring ) {
+		for( uint segment = 0; segment < (uint)numCuts; ++segment ) {
+			uint k1 = ring * rowLength + segment;
+			uint k2 = k1 + rowLength;
+			sourceIndices.insert( sourceIndices.end(), { k1, k2, k1 + 1, k1 + 1, k2, k2 + 1 } );
+		}
+	}
+
+	std::vector<Vertex_PCUTBN> soup;
+	double startSeconds = GetCurrentTimeSeconds();
+	for( int iteration = 0; iteration < numIterations; ++iteration ) {
+		soup.clear();
+		for( uint index : sourceIndices ) {
+			soup.push_back( sourceVertices[index] );
+		}
+		std::vector<uint> soupIndices( soup.size() );
+		for( uint index = 0; index < (uint)soup.size(); ++index ) {
+			soupIndices[index] = index;
+		}
+		GenerateTangentsForIndexedMesh( soup, soupIndices, (uint)( soupIndices.size() / 3 ) );
+	}
+	double soupSeconds = ( GetCurrentTimeSeconds() - startSeconds ) / numIterations;
+
+	std::vector<Vertex_PCUTBN> vertices;
+	std::vector<uint> indices;
+	startSeconds = GetCurrentTimeSeconds();
+	for( int iteration = 0; iteration < numIterations; ++iteration ) {
+		vertices = sourceVertices;
+		indices = sourceIndices;
+		GenerateTangentsForIndexedMesh( vertices, indices, (uint)facesPerChunk );
+	}
+	double indexedSeconds = ( GetCurrentTimeSeconds() - startSeconds ) / numIterations;
+
+	// compared as vectors rather than angles: MikkTSpace leaves a zero tangent where a corner has no usable UV area
+	int numMismatches = 0;
+	float maxDifference = 0.f;
+	for( size_t indexIdx = 0; indexIdx < indices.size(); ++indexIdx ) {
+		Vertex_PCUTBN const& expected = soup[indexIdx];
+		Vertex_PCUTBN const& actual = vertices[indices[indexIdx]];
+		float difference = fmaxf( ( expected.m_tangent - actual.m_tangent ).GetLength(), ( expected.m_bitangent - actual.m_bitangent ).GetLength() );
+		maxDifference = fmaxf( maxDifference, difference );
+		if( difference > 0.01f ) {
+			++numMismatches;
+		}
+	}
+
+	int numFaces = (int)( sourceIndices.size() / 3 );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "MikkTSpace tangents, %i faces x %i iterations, %i faces per chunk (%s)",
+		numFaces, numIterations, facesPerChunk, ( g_theJobSystem != nullptr && g_theJobSystem->AreWorkersRunning() ) ? "on job workers" : "no job workers running, chunks run inline" ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  de-indexed soup %.2f ms  indexed, chunked %.2f ms", soupSeconds * 1000.0, indexedSeconds * 1000.0 ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "  vertices %i soup, %i -> %i indexed (seam splits)", (int)soup.size(), (int)sourceVertices.size(), (int)vertices.size() ) );
+
+	Rgba8 resultColor = numMismatches == 0 ? Rgba8::GREEN : Rgba8::RED;
+	g_theConsole->PrintString( resultColor, Stringf( "  corners whose tangent or bitangent moved by more than 0.01: %i (largest %.6f)", numMismatches, maxDifference ) );
 }
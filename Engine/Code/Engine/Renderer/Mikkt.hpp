@@ -3,27 +3,22 @@
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 #include <vector>
 
-//----------------------------------------------------------------------------------------------------------------------------------
-int		GetNumFaces( SMikkTSpaceContext const* pContext );
-
-//----------------------------------------------------------------------------------------------------------------------------------
-int		GetNumberOfVerticesForFace( SMikkTSpaceContext const* pContext, const int iFace );
+typedef unsigned int uint;
 
 //----------------------------------------------------------------------------------------------------------------------------------
-void		GetPositionForFaceVert( const SMikkTSpaceContext* pContext, float fvPosOut[], const int iFace, const int iVert );
+constexpr uint MIKKT_DEFAULT_FACES_PER_CHUNK = 4096;
 
 //----------------------------------------------------------------------------------------------------------------------------------
-void		GetNormalForFaceVert( const SMikkTSpaceContext * pContext, float fvNormOut[], const int iFace, const int iVert );
+// MikkTSpace tangents for a triangle soup: every three vertices are a face
+void		GenerateTangentsForVertexArray( std::vector<Vertex_PCUTBN>& vertices );
 
 //----------------------------------------------------------------------------------------------------------------------------------
-void		GetUVForFaceVert( const SMikkTSpaceContext* pContext, float fvTexcOut[], const int iFace, const int iVert );
-
+// MikkTSpace tangents for an indexed triangle list, written straight into the shared vertices. A vertex whose corners
+// come out with different tangents (mirrored UVs, tangent seams) is split: the extra copies are appended to vertices
+// and their corners re-pointed, so the mesh draws exactly as the de-indexed result would.
+//
+// Large meshes run as chunks of facesPerChunk faces on the JobSystem workers, when they are running. Each chunk also
+// feeds MikkTSpace every face touching one of its vertices, so its own corners see the same neighbourhood as in one
+// whole-mesh run. facesPerChunk 0 picks: one chunk without workers, MIKKT_DEFAULT_FACES_PER_CHUNK with them.
 //----------------------------------------------------------------------------------------------------------------------------------
-void		SetTangent( const SMikkTSpaceContext* pContext,
-							const float fvTangent[],
-							const float fSign,
-							const int	iFace, const int iVert );
-
-//----------------------------------------------------------------------------------------------------------------------------------
-void			GenerateTangentsForVertexArray( std::vector<Vertex_PCUTBN>& vertices );
-
+void		GenerateTangentsForIndexedMesh( std::vector<Vertex_PCUTBN>& vertices, std::vector<uint>& indices, uint facesPerChunk = 0 );
@@ -0,0 +1,265 @@
+#include "Engine/Renderer/NullRenderBackend.hpp"
+#include "Engine/Renderer/RenderBuffer.hpp"
+#include "Engine/Renderer/Shader.hpp"
+#include "Engine/Renderer/Texture.hpp"
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static eRenderBackendBufferType GetBufferType( RenderBuffer const& buffer )
+{
+	if( buffer.m_usage & INDEX_BUFFER_BIT )
+	{
+		return RENDER_BACKEND_INDEX_BUFFER;
+	}
+	if( buffer.m_usage & UNIFORM_BUFFER_BIT )
+	{
+		return RENDER_BACKEND_UNIFORM_BUFFER;
+	}
+	return RENDER_BACKEND_VERTEX_BUFFER;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+NullRenderBackend::NullRenderBackend( RenderContext* owner )
+	: m_owner( owner )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::ResetStats()
+{
+	m_frameStats = RenderBackendStats();
+	m_lastFrameStats = RenderBackendStats();
+	m_totalStats = RenderBackendStats();
+	m_numFrames = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BeginFrame()
+{
+	m_frameStats = RenderBackendStats();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::EndFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_totalStats += m_frameStats;
+	++m_numFrames;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BeginCamera( Camera const& /*camera*/ )
+{
+	++m_frameStats.m_numCameras;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::ClearScreen( Rgba8 const& /*clearColor*/ )
+{
+	++m_frameStats.m_numClears;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::ClearDepth( Texture* /*depthStencilTexture*/, float /*depth*/, uint /*stencil*/ )
+{
+	++m_frameStats.m_numClears;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+Texture* NullRenderBackend::CreateTexture( char const* filePath, IntVec2 const& texelSize, unsigned char const* /*rgbaTexels*/ )
+{
+	return new Texture( filePath, m_owner, texelSize );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+Texture* NullRenderBackend::CreateRenderTarget( IntVec2 const& texelSize )
+{
+	return new Texture( "", m_owner, texelSize );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::DestroyTexture( Texture* /*texture*/ )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+TextureView* NullRenderBackend::CreateRenderTargetView( Texture* /*texture*/ )
+{
+	return nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+TextureView* NullRenderBackend::CreateShaderResourceView( Texture* /*texture*/ )
+{
+	return nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::DestroyTextureView( TextureView* /*view*/ )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::CopyTexture( Texture* /*dst*/, Texture* /*src*/ )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::ResolveTexture( Texture* /*dst*/, Texture* /*src*/ )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool NullRenderBackend::CreateShaderStage( ShaderStage& stage, char const* /*filePath*/, void const* /*source*/, size_t /*sourceByteSize*/, eShaderType type )
+{
+	stage.m_type = type;
+	return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::DestroyShader( Shader& /*shader*/ )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::CreateSampler( Sampler& /*sampler*/, eSamplerType /*type*/ )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::DestroySampler( Sampler& /*sampler*/ )
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool NullRenderBackend::CreateBuffer( RenderBuffer& /*buffer*/, size_t /*byteSize*/, size_t /*elementByteSize*/ )
+{
+	++m_frameStats.m_numBufferCreates;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::DestroyBuffer( RenderBuffer& /*buffer*/ )
+{
+	++m_frameStats.m_numBufferDestroys;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool NullRenderBackend::UpdateBuffer( RenderBuffer& buffer, void const* /*data*/, size_t byteSize )
+{
+	eRenderBackendBufferType type = GetBufferType( buffer );
+	++m_frameStats.m_numBufferUpdates;
+	++m_frameStats.m_numUploads[type];
+	m_frameStats.m_uploadedBytes[type] += byteSize;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+bool NullRenderBackend::UpdateBufferRange( RenderBuffer& buffer, void const* /*data*/, size_t /*byteOffset*/, size_t byteSize, bool discard )
+{
+	eRenderBackendBufferType type = GetBufferType( buffer );
+	++m_frameStats.m_numBufferUpdates;
+	++m_frameStats.m_numUploads[type];
+	m_frameStats.m_uploadedBytes[type] += byteSize;
+	if( discard )
+	{
+		++m_frameStats.m_numBufferDiscards;
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindShader( Shader* /*shader*/ )
+{
+	++m_frameStats.m_numShaderBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindInputLayout( Shader* /*shader*/, buffer_attribute_t const* /*layout*/ )
+{
+	++m_frameStats.m_numInputLayoutBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindVertexBuffer( VertexBuffer* /*vbo*/ )
+{
+	++m_frameStats.m_numVertexBufferBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindIndexBuffer( IndexBuffer* /*ibo*/ )
+{
+	++m_frameStats.m_numIndexBufferBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindUniformBuffer( uint /*slot*/, RenderBuffer* /*ubo*/ )
+{
+	++m_frameStats.m_numUniformBufferBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindStructuredBuffer( uint /*slot*/, RenderBuffer* /*buffer*/ )
+{
+	++m_frameStats.m_numTextureBinds;		// a shader resource, bound like a texture
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindTexture( uint /*slot*/, Texture* /*texture*/ )
+{
+	++m_frameStats.m_numTextureBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::BindSampler( uint /*slot*/, Sampler* /*sampler*/ )
+{
+	++m_frameStats.m_numSamplerBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::SetBlendMode( BlendMode /*blendMode*/ )
+{
+	++m_frameStats.m_numBlendStateChanges;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::SetDepthState( eCompareOp /*op*/, bool /*write*/ )
+{
+	++m_frameStats.m_numDepthStateChanges;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::SetRasterState( eCullMode /*cullMode*/, eFillMode /*fillMode*/, bool /*isFrontCCW*/ )
+{
+	++m_frameStats.m_numRasterStateChanges;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::Draw( int numVertexes, int /*vertexOffset*/ )
+{
+	++m_frameStats.m_numDraws;
+	m_frameStats.m_numPrimitiveElements += numVertexes;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::DrawIndexed( int indexCount, int /*indexOffset*/, int /*vertexOffset*/ )
+{
+	++m_frameStats.m_numDrawIndexed;
+	m_frameStats.m_numPrimitiveElements += indexCount;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void NullRenderBackend::DrawFullScreenTriangle()
+{
+	Draw( 3, 0 );
+}
+
+#if !defined( _WIN32 )
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// No device backend off Windows yet: a windowed start-up runs headless
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+RenderBackend* CreatePlatformRenderBackend( RenderContext* owner, Window* /*window*/ )
+{
+	return new NullRenderBackend( owner );
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+#include "Engine/Renderer/RenderBackend.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Talks to no device. Every call is counted into the current frame's stats, so CPU-side render code can run on a
+// machine without a GPU and its draw calls, uploads and state changes read back as numbers.
+// Buffers are "created" without a handle; RenderBuffer keeps its sizes, so resize and re-create behave as on D3D11.
+// Textures and render targets keep their size and file path but have no device texture behind them; views, shader
+// stages and samplers are left without handles. Includes nothing platform-specific, so it builds and runs anywhere.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class NullRenderBackend : public RenderBackend
+{
+public:
+	explicit NullRenderBackend( RenderContext* owner );
+
+	virtual char const*	GetName() const override		{ return "null"; }
+	virtual bool		IsHeadless() const override		{ return true; }
+
+	virtual RenderBackendStats const*	GetFrameStats() const override			{ return &m_frameStats; }
+	virtual RenderBackendStats const*	GetLastFrameStats() const override		{ return &m_lastFrameStats; }
+	RenderBackendStats const&			GetTotalStats() const					{ return m_totalStats; }		// all finished frames
+	int									GetNumFrames() const					{ return m_numFrames; }
+	void								ResetStats();
+
+	virtual void	BeginFrame() override;
+	virtual void	EndFrame() override;
+	virtual void	BeginCamera( Camera const& camera ) override;
+	virtual void	ClearScreen( Rgba8 const& clearColor ) override;
+	virtual void	ClearDepth( Texture* depthStencilTexture, float depth, uint stencil ) override;
+
+	virtual Texture*		GetBackBuffer() override		{ return nullptr; }
+	virtual Texture*		CreateTexture( char const* filePath, IntVec2 const& texelSize, unsigned char const* rgbaTexels ) override;
+	virtual Texture*		CreateRenderTarget( IntVec2 const& texelSize ) override;
+	virtual void			DestroyTexture( Texture* texture ) override;
+	virtual TextureView*	CreateRenderTargetView( Texture* texture ) override;
+	virtual TextureView*	CreateShaderResourceView( Texture* texture ) override;
+	virtual void			DestroyTextureView( TextureView* view ) override;
+	virtual void			CopyTexture( Texture* dst, Texture* src ) override;
+	virtual void			ResolveTexture( Texture* dst, Texture* src ) override;
+
+	virtual bool	CreateShaderStage( ShaderStage& stage, char const* filePath, void const* source, size_t sourceByteSize, eShaderType type ) override;
+	virtual void	DestroyShader( Shader& shader ) override;
+
+	virtual void	CreateSampler( Sampler& sampler, eSamplerType type ) override;
+	virtual void	DestroySampler( Sampler& sampler ) override;
+
+	virtual bool	CreateBuffer( RenderBuffer& buffer, size_t byteSize, size_t elementByteSize ) override;
+	virtual void	DestroyBuffer( RenderBuffer& buffer ) override;
+	virtual bool	UpdateBuffer( RenderBuffer& buffer, void const* data, size_t byteSize ) override;
+	virtual bool	UpdateBufferRange( RenderBuffer& buffer, void const* data, size_t byteOffset, size_t byteSize, bool discard ) override;
+
+	virtual void	BindShader( Shader* shader ) override;
+	virtual void	BindInputLayout( Shader* shader, buffer_attribute_t const* layout ) override;
+	virtual void	BindVertexBuffer( VertexBuffer* vbo ) override;
+	virtual void	BindIndexBuffer( IndexBuffer* ibo ) override;
+	virtual void	BindUniformBuffer( uint slot, RenderBuffer* ubo ) override;
+	virtual void	BindStructuredBuffer( uint slot, RenderBuffer* buffer ) override;
+	virtual void	BindTexture( uint slot, Texture* texture ) override;
+	virtual void	BindSampler( uint slot, Sampler* sampler ) override;
+
+	virtual void	SetBlendMode( BlendMode blendMode ) override;
+	virtual void	SetDepthState( eCompareOp op, bool write ) override;
+	virtual void	SetRasterState( eCullMode cullMode, eFillMode fillMode, bool isFrontCCW ) override;
+
+	virtual void	Draw( int numVertexes, int vertexOffset ) override;
+	virtual void	DrawIndexed( int indexCount, int indexOffset, int vertexOffset ) override;
+	virtual void	DrawFullScreenTriangle() override;
+
+private:
+	RenderContext*		m_owner = nullptr;
+	RenderBackendStats	m_frameStats;
+	RenderBackendStats	m_lastFrameStats;
+	RenderBackendStats	m_totalStats;
+	int					m_numFrames = 0;
+};
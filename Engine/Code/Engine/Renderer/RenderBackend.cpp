@@ -0,0 +1,51 @@
+#include "Engine/Renderer/RenderBackend.hpp"
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+int RenderBackendStats::GetNumStateChanges() const
+{
+	return m_numShaderBinds + m_numInputLayoutBinds + m_numVertexBufferBinds + m_numIndexBufferBinds + m_numUniformBufferBinds
+		+ m_numTextureBinds + m_numSamplerBinds + m_numBlendStateChanges + m_numDepthStateChanges + m_numRasterStateChanges;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+size_t RenderBackendStats::GetTotalUploadedBytes() const
+{
+	size_t total = 0;
+	for( int type = 0; type < NUM_RENDER_BACKEND_BUFFER_TYPES; ++type )
+	{
+		total += m_uploadedBytes[type];
+	}
+	return total;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void RenderBackendStats::operator+=( RenderBackendStats const& other )
+{
+	m_numDraws += other.m_numDraws;
+	m_numDrawIndexed += other.m_numDrawIndexed;
+	m_numPrimitiveElements += other.m_numPrimitiveElements;
+	m_numCameras += other.m_numCameras;
+	m_numClears += other.m_numClears;
+	m_numBufferCreates += other.m_numBufferCreates;
+	m_numBufferDestroys += other.m_numBufferDestroys;
+	m_numBufferUpdates += other.m_numBufferUpdates;
+	m_numBufferDiscards += other.m_numBufferDiscards;
+
+	for( int type = 0; type < NUM_RENDER_BACKEND_BUFFER_TYPES; ++type )
+	{
+		m_uploadedBytes[type] += other.m_uploadedBytes[type];
+		m_numUploads[type] += other.m_numUploads[type];
+	}
+
+	m_numShaderBinds += other.m_numShaderBinds;
+	m_numInputLayoutBinds += other.m_numInputLayoutBinds;
+	m_numVertexBufferBinds += other.m_numVertexBufferBinds;
+	m_numIndexBufferBinds += other.m_numIndexBufferBinds;
+	m_numUniformBufferBinds += other.m_numUniformBufferBinds;
+	m_numTextureBinds += other.m_numTextureBinds;
+	m_numSamplerBinds += other.m_numSamplerBinds;
+	m_numBlendStateChanges += other.m_numBlendStateChanges;
+	m_numDepthStateChanges += other.m_numDepthStateChanges;
+	m_numRasterStateChanges += other.m_numRasterStateChanges;
+}
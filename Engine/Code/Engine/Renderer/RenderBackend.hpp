@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+
+typedef unsigned int uint;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class Camera;
+class IndexBuffer;
+class RenderBuffer;
+class RenderContext;
+class Sampler;
+class Shader;
+class ShaderStage;
+class Texture;
+class TextureView;
+class VertexBuffer;
+class Window;
+struct IntVec2;
+struct Rgba8;
+struct buffer_attribute_t;
+enum class BlendMode;
+enum class eCompareOp;
+enum class eCullMode;
+enum class eFillMode;
+enum eSamplerType : int;
+enum eShaderType : int;
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+enum eRenderBackendBufferType
+{
+	RENDER_BACKEND_VERTEX_BUFFER,
+	RENDER_BACKEND_INDEX_BUFFER,
+	RENDER_BACKEND_UNIFORM_BUFFER,
+
+	NUM_RENDER_BACKEND_BUFFER_TYPES
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// Everything a backend saw in one frame. Calls are counted as RenderContext made them, so a backend that filters
+// redundant state itself (the driver does) still reports what the CPU side asked for.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct RenderBackendStats
+{
+	// calls
+	int		m_numDraws = 0;
+	int		m_numDrawIndexed = 0;
+	int		m_numPrimitiveElements = 0;		// vertices for Draw, indices for DrawIndexed
+	int		m_numCameras = 0;
+	int		m_numClears = 0;
+	int		m_numBufferCreates = 0;
+	int		m_numBufferDestroys = 0;
+	int		m_numBufferUpdates = 0;
+	int		m_numBufferDiscards = 0;			// range updates that renamed the buffer
+
+	// uploads
+	size_t	m_uploadedBytes[NUM_RENDER_BACKEND_BUFFER_TYPES] = {};
+	int		m_numUploads[NUM_RENDER_BACKEND_BUFFER_TYPES] = {};
+
+	// state changes
+	int		m_numShaderBinds = 0;
+	int		m_numInputLayoutBinds = 0;
+	int		m_numVertexBufferBinds = 0;
+	int		m_numIndexBufferBinds = 0;
+	int		m_numUniformBufferBinds = 0;
+	int		m_numTextureBinds = 0;
+	int		m_numSamplerBinds = 0;
+	int		m_numBlendStateChanges = 0;
+	int		m_numDepthStateChanges = 0;
+	int		m_numRasterStateChanges = 0;
+
+	int		GetNumDrawCalls() const			{ return m_numDraws + m_numDrawIndexed; }
+	int		GetNumStateChanges() const;
+	size_t	GetTotalUploadedBytes() const;
+	void	operator+=( RenderBackendStats const& other );
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// The device-facing half of RenderContext. RenderContext keeps the engine-side state (current shader, layout, what is
+// bound where) and calls through here only when the device has to hear about it, so draw-call and upload counts taken
+// at this level are the ones the real device would get.
+//
+// The backend also owns the device and everything made on it: the D3D11 one creates the device, swap chain and depth
+// buffer at construction, and makes and releases the textures, views, shader stages, input layouts and samplers that
+// Texture, Shader and Sampler hold handles to. The null one hands out sized textures with no device texture behind them
+// and leaves every handle null. Nothing outside a backend's own .cpp includes a device header.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	virtual char const*	GetName() const = 0;
+	virtual bool		IsHeadless() const = 0;		// no device: nothing is created, drawn or presented
+
+	// nullptr when the backend does not count
+	virtual RenderBackendStats const*	GetFrameStats() const			{ return nullptr; }
+	virtual RenderBackendStats const*	GetLastFrameStats() const		{ return nullptr; }
+
+	virtual void	BeginFrame() = 0;
+	virtual void	EndFrame() = 0;								// presents
+	virtual void	BeginCamera( Camera const& camera ) = 0;	// color/depth targets, viewport and the camera's clears
+	virtual void	ClearScreen( Rgba8 const& clearColor ) = 0;
+	virtual void	ClearDepth( Texture* depthStencilTexture, float depth, uint stencil ) = 0;
+
+	virtual Texture*		GetBackBuffer() = 0;											// nullptr when headless
+	virtual Texture*		CreateTexture( char const* filePath, IntVec2 const& texelSize, unsigned char const* rgbaTexels ) = 0;
+	virtual Texture*		CreateRenderTarget( IntVec2 const& texelSize ) = 0;
+	virtual void			DestroyTexture( Texture* texture ) = 0;							// the device texture; the Texture is the caller's
+	virtual TextureView*	CreateRenderTargetView( Texture* texture ) = 0;					// nullptr when there is no device texture
+	virtual TextureView*	CreateShaderResourceView( Texture* texture ) = 0;
+	virtual void			DestroyTextureView( TextureView* view ) = 0;					// the device view; nullptr is fine
+	virtual void			CopyTexture( Texture* dst, Texture* src ) = 0;
+	virtual void			ResolveTexture( Texture* dst, Texture* src ) = 0;				// multisampled src into a single-sampled dst of its size
+
+	// Compiles the stage's entry point out of the source; a source that does not compile gets the error shader instead
+	virtual bool	CreateShaderStage( ShaderStage& stage, char const* filePath, void const* source, size_t sourceByteSize, eShaderType type ) = 0;
+	virtual void	DestroyShader( Shader& shader ) = 0;		// both stages and the input layout
+
+	virtual void	CreateSampler( Sampler& sampler, eSamplerType type ) = 0;
+	virtual void	DestroySampler( Sampler& sampler ) = 0;
+
+	virtual bool	CreateBuffer( RenderBuffer& buffer, size_t byteSize, size_t elementByteSize ) = 0;
+	virtual void	DestroyBuffer( RenderBuffer& buffer ) = 0;
+	virtual bool	UpdateBuffer( RenderBuffer& buffer, void const* data, size_t byteSize ) = 0;
+	virtual bool	UpdateBufferRange( RenderBuffer& buffer, void const* data, size_t byteOffset, size_t byteSize, bool discard ) = 0;
+
+	virtual void	BindShader( Shader* shader ) = 0;
+	virtual void	BindInputLayout( Shader* shader, buffer_attribute_t const* layout ) = 0;
+	virtual void	BindVertexBuffer( VertexBuffer* vbo ) = 0;
+	virtual void	BindIndexBuffer( IndexBuffer* ibo ) = 0;				// nullptr unbinds
+	virtual void	BindUniformBuffer( uint slot, RenderBuffer* ubo ) = 0;
+	virtual void	BindStructuredBuffer( uint slot, RenderBuffer* buffer ) = 0;		// pixel stage t-register
+	virtual void	BindTexture( uint slot, Texture* texture ) = 0;
+	virtual void	BindSampler( uint slot, Sampler* sampler ) = 0;
+
+	virtual void	SetBlendMode( BlendMode blendMode ) = 0;
+	virtual void	SetDepthState( eCompareOp op, bool write ) = 0;
+	virtual void	SetRasterState( eCullMode cullMode, eFillMode fillMode, bool isFrontCCW ) = 0;
+
+	virtual void	Draw( int numVertexes, int vertexOffset ) = 0;
+	virtual void	DrawIndexed( int indexCount, int indexOffset, int vertexOffset ) = 0;
+	virtual void	DrawFullScreenTriangle() = 0;		// no vertex buffer; the bound shader makes the three vertices
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// The device backend for the platform being built: D3D11 on Windows. RenderContext::StartUpHeadless uses a
+// NullRenderBackend instead, on any platform.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+RenderBackend* CreatePlatformRenderBackend( RenderContext* owner, Window* window );
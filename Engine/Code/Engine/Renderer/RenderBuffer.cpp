@@ -1,6 +1,6 @@
 #include "Engine/Renderer/RenderBuffer.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
-#include "Engine/Renderer/D3D11Common.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 
@@ -17,79 +17,32 @@ RenderBuffer::RenderBuffer( RenderContext* owner, eRenderBufferUsage usage, eRen
 
 RenderBuffer::~RenderBuffer()
 {
-	DX_SAFE_RELEASE(m_handle);
-}
-
-UINT ToDXUsage( eRenderBufferUsage usage )
-{
-	UINT ret = 0;
-
-	if( usage & VERTEX_BUFFER_BIT )
-	{
-		ret |= D3D11_BIND_VERTEX_BUFFER;
-	}
-
-	if( usage & INDEX_BUFFER_BIT )
+	if( m_owner->m_backend != nullptr )
 	{
-		ret |= D3D11_BIND_INDEX_BUFFER;
+		CleanUp();
 	}
-
-	if( usage & UNIFORM_BUFFER_BIT )
-	{
-		ret |= D3D11_BIND_CONSTANT_BUFFER;
-	}
-
-	return ret;
 }
 
-D3D11_USAGE ToDXMemoryUsage( eRenderMemoryHint hint )
-{
-	switch( hint )
-	{
-	case MEMORY_HINT_GPU:		return D3D11_USAGE_DEFAULT;
-	case MEMORY_HINT_DYNAMIC:	return D3D11_USAGE_DYNAMIC;
-	case MEMORY_HINT_STAGING:	return D3D11_USAGE_STAGING;
-	default:					return D3D11_USAGE_DEFAULT;
-	}
-}
+//-------------------------------------------------------------------------------------------------------------
+static uint s_lastBufferCreationId = 0;
 
 bool RenderBuffer::Create( size_t dataByteSize, size_t elementByteSize )
 {
-	ID3D11Device* device = m_owner->m_device;
-
-	D3D11_BUFFER_DESC desc;
-	desc.ByteWidth = (UINT)dataByteSize;
-	desc.Usage = ToDXMemoryUsage( m_memoryHint );
-	desc.BindFlags = ToDXUsage( m_usage );
-	desc.CPUAccessFlags = 0;
-
-	if( m_memoryHint == MEMORY_HINT_DYNAMIC )
-	{
-		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	}
-	else if( m_memoryHint == MEMORY_HINT_STAGING )
+	if( !m_owner->m_backend->CreateBuffer( *this, dataByteSize, elementByteSize ) )
 	{
-		desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE | D3D11_CPU_ACCESS_READ;
+		return false;
 	}
 
-	desc.MiscFlags = 0;
-	desc.StructureByteStride = (UINT)elementByteSize;
-	device->CreateBuffer( &desc, nullptr, &m_handle );
-
-	// testing
-	//std::string name = "Test Name";
-	//device->SetPrivateData( WKPDID_D3DDebugObjectName, name.size(), name.c_str() );
-
 	m_bufferByteSize = dataByteSize;
 	m_elementByteSize = elementByteSize;
+	m_creationId = ++s_lastBufferCreationId;
 
-
-	return( m_handle != nullptr );
+	return true;
 }
 
 bool RenderBuffer::IsCompatible( size_t dataByteSize, size_t elementByteSize ) const
 {
-	if( m_handle == nullptr )
+	if( m_creationId == 0 )
 	{
 		return false;
 	}
@@ -112,7 +65,11 @@ bool RenderBuffer::IsCompatible( size_t dataByteSize, size_t elementByteSize ) c
 
 void RenderBuffer::CleanUp()
 {
-	DX_SAFE_RELEASE( m_handle );
+	if( m_creationId != 0 )
+	{
+		m_owner->m_backend->DestroyBuffer( *this );
+	}
+	m_creationId = 0;
 	m_bufferByteSize = 0;
 	m_elementByteSize = 0;
 }
@@ -125,43 +82,33 @@ bool RenderBuffer::Update( void const* data, size_t dataByteSize, size_t element
 		CleanUp();  // destroy the buffer
 
 		// 2. if no buffer, create one that is compatible
-		Create( dataByteSize, elementByteSize );
-	}
-	
-	
-
-	ID3D11DeviceContext* ctx = m_owner->m_context;
-	// 3. updating the buffer
-	if( m_memoryHint == MEMORY_HINT_DYNAMIC )
-	{
-		D3D11_MAPPED_SUBRESOURCE mapped;
-
-		// CPU -> GPU memory copy
-		HRESULT result = ctx->Map( m_handle, 0, D3D11_MAP_WRITE_DISCARD, 0,  &mapped );
-		if( SUCCEEDED( result ) )
-		{
-			memcpy( mapped.pData, data, dataByteSize );
-			ctx->Unmap( m_handle, 0 );
-		}
-		else
+		if( !Create( dataByteSize, elementByteSize ) )
 		{
 			return false;
 		}
-		
 	}
-	else
-	{ // if this is MEMORY_HINT_GPU
-		ctx->UpdateSubresource( m_handle, 0, nullptr, data, 0, 0 );
+
+	// 3. updating the buffer - mapped for DYNAMIC, a direct copy for GPU
+	return m_owner->m_backend->UpdateBuffer( *this, data, dataByteSize );
+}
+
+bool RenderBuffer::Reserve( size_t dataByteSize, size_t elementByteSize )
+{
+	if( IsCompatible( dataByteSize, elementByteSize ) )
+	{
+		return true;
 	}
 
-	// Mapping
-	// Only available to DYNAMIC buffer
-	// But, don't gave to reallocate if going smaller
+	CleanUp();
+	return Create( dataByteSize, elementByteSize );
+}
+
+bool RenderBuffer::UpdateRange( void const* data, size_t byteOffset, size_t dataByteSize, bool discard )
+{
+	GUARANTEE_OR_DIE( m_memoryHint == MEMORY_HINT_DYNAMIC, "Only dynamic buffers can be updated a range at a time" );
+	GUARANTEE_OR_DIE( byteOffset + dataByteSize <= m_bufferByteSize, "RenderBuffer::UpdateRange past the end of the buffer" );
 
-	// CopySubresource ( direct copy)
-	// This is only available to GPU buffers that have exactly
-	// the same size, and element size
-	return true;
+	return m_owner->m_backend->UpdateBufferRange( *this, data, byteOffset, dataByteSize, discard );
 }
 
 VertexBuffer::VertexBuffer( RenderContext* ctx, eRenderMemoryHint hint )
@@ -177,3 +124,11 @@ void VertexBuffer::Update( uint vcount, void const* vertexData, uint vertexStrid
 	size_t dataBtyeSize = vcount * vertexStride;
 	RenderBuffer::Update( vertexData, dataBtyeSize, vertexStride );
 }
+
+bool VertexBuffer::Reserve( uint vcount, uint vertexStride, buffer_attribute_t const* layout )
+{
+	m_layout = layout;
+	m_elementStride = vertexStride;
+
+	return RenderBuffer::Reserve( (size_t)vcount * vertexStride, vertexStride );
+}
@@ -2,6 +2,7 @@
 #include "Engine/Core/Vertex_PCU.hpp"
 
 struct ID3D11Buffer;
+struct ID3D11ShaderResourceView;
 class RenderContext;
 
 typedef unsigned int uint;
@@ -14,6 +15,7 @@ enum eRenderBufferUsageBit : uint
 	VERTEX_BUFFER_BIT 		= BIT_FLAG( 0 ),		// A02: can be used to store vertices
 	INDEX_BUFFER_BIT		= BIT_FLAG( 1 ),  		// A05: Index Buffer (IBO)
 	UNIFORM_BUFFER_BIT		= BIT_FLAG( 2 ),		// A03: used to store constants
+	STRUCTURED_BUFFER_BIT	= BIT_FLAG( 3 ),		// an array of elementByteSize structs, read in shaders as a StructuredBuffer
 };
 typedef uint eRenderBufferUsage;
 
@@ -33,6 +35,12 @@ public:
 
 	bool Update( void const* data, size_t dataByteSize, size_t elementByteSize );
 
+	// For MEMORY_HINT_DYNAMIC buffers written a piece at a time: Reserve makes sure a buffer of at least dataByteSize
+	// exists, then UpdateRange writes without disturbing the rest. discard hands back fresh memory and leaves the old
+	// contents to draws already issued; without it the range must not be in use by any draw still in flight.
+	bool Reserve( size_t dataByteSize, size_t elementByteSize );
+	bool UpdateRange( void const* data, size_t byteOffset, size_t dataByteSize, bool discard );
+
 private:
 	bool Create( size_t dataByteSize, size_t elementByteSize );
 	bool IsCompatible( size_t dataByteSize, size_t elementByteSize ) const;
@@ -40,13 +48,15 @@ private:
 
 public:
 	RenderContext* m_owner = nullptr;
-	ID3D11Buffer* m_handle = nullptr;
+	ID3D11Buffer* m_handle = nullptr;		// made and released by the render backend; nullptr when headless
+	ID3D11ShaderResourceView* m_srv = nullptr;	// STRUCTURED_BUFFER_BIT only, made and released with m_handle
 
 	eRenderBufferUsage m_usage;
 	eRenderMemoryHint m_memoryHint;
 
 	size_t m_bufferByteSize;
 	size_t m_elementByteSize;
+	uint m_creationId = 0;		// unique per device buffer made, 0 when there is none; rebind checks compare it, not addresses
 
 };
 
@@ -56,6 +66,7 @@ public:
 	VertexBuffer( RenderContext* ctx, eRenderMemoryHint hint );
 
 	void Update( uint vcount, void const* vertexData, uint vertexStride, buffer_attribute_t const* layout );
+	bool Reserve( uint vcount, uint vertexStride, buffer_attribute_t const* layout );
 	buffer_attribute_t const* GetLayout() { return m_layout; }
 	const uint GetElementStride() const { return m_elementStride; }
 
@@ -0,0 +1,126 @@
+#include "Engine/Renderer/RenderCommandBuffer.hpp"
+#include "Engine/Renderer/GPUMesh.hpp"
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+static uint64_t HashPointerToBits( void const* pointer, int numBits )
+{
+	if( pointer == nullptr )
+	{
+		return 0;
+	}
+
+	// 64-bit finalizer, so objects allocated next to each other still spread over the field
+	uint64_t value = (uint64_t)(uintptr_t)pointer;
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	return value & ( ( 1ULL << numBits ) - 1 );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t MakeRenderSortKey( eRenderLayer layer, Shader const* shader, Material const* material, Texture const* texture, float depth01 )
+{
+	constexpr uint64_t MAX_DEPTH = ( 1ULL << 20 ) - 1;
+	float clampedDepth = depth01 < 0.f ? 0.f : ( depth01 > 1.f ? 1.f : depth01 );
+	uint64_t depth = (uint64_t)( clampedDepth * (float)MAX_DEPTH );
+
+	uint64_t state = ( HashPointerToBits( shader, 12 ) << 28 ) | ( HashPointerToBits( material, 12 ) << 16 ) | HashPointerToBits( texture, 16 );
+	uint64_t layerBits = (uint64_t)layer << 60;
+
+	if( layer == RENDER_LAYER_TRANSLUCENT )
+	{
+		return layerBits | ( ( MAX_DEPTH - depth ) << 40 ) | state;
+	}
+	return layerBits | ( state << 20 ) | depth;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void RenderCommandStats::operator+=( RenderCommandStats const& other )
+{
+	m_numCommands += other.m_numCommands;
+	m_numDraws += other.m_numDraws;
+	m_numBinds += other.m_numBinds;
+	m_numSkippedBinds += other.m_numSkippedBinds;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+RenderCommandBuffer::~RenderCommandBuffer()
+{
+	delete m_vertexMesh;
+	m_vertexMesh = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void RenderCommandBuffer::Reset()
+{
+	m_commands.clear();
+	m_vertices.clear();
+	m_areVerticesUploaded = false;
+
+	m_layer = RENDER_LAYER_OPAQUE;
+	m_depth = 0.f;
+	m_material = nullptr;
+	m_shader = nullptr;
+	m_texture = nullptr;
+	m_normalTexture = nullptr;
+	m_isWireframe = false;
+	m_modelMatrix = Mat44::IDENTITY;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+RenderCommand& RenderCommandBuffer::AddCommand()
+{
+	m_commands.emplace_back();
+	RenderCommand& command = m_commands.back();
+	command.m_material = m_material;
+	command.m_shader = m_shader;
+	command.m_texture = m_texture;
+	command.m_normalTexture = m_normalTexture;
+	command.m_isWireframe = m_isWireframe;
+	command.m_modelMatrix = m_modelMatrix;
+
+	Texture const* keyTexture = m_material ? nullptr : m_texture;
+	command.m_sortKey = MakeRenderSortKey( m_layer, m_shader, m_material, keyTexture, m_depth );
+	return command;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void RenderCommandBuffer::DrawMesh( GPUMesh* mesh )
+{
+	RenderCommand& command = AddCommand();
+	command.m_mesh = mesh;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void RenderCommandBuffer::DrawMesh( GPUMesh* mesh, int firstElement, int numElements )
+{
+	RenderCommand& command = AddCommand();
+	command.m_mesh = mesh;
+	command.m_firstElement = firstElement;
+	command.m_numElements = numElements;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void RenderCommandBuffer::DrawVertexArray( int numVertexes, Vertex_PCU const* vertexes )
+{
+	if( numVertexes <= 0 )
+	{
+		return;
+	}
+
+	RenderCommand& command = AddCommand();
+	command.m_firstElement = (int)m_vertices.size();
+	command.m_numElements = numVertexes;
+	m_vertices.insert( m_vertices.end(), vertexes, vertexes + numVertexes );
+	m_areVerticesUploaded = false;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void RenderCommandBuffer::DrawVertexArray( std::vector<Vertex_PCU> const& vertexes )
+{
+	if( !vertexes.empty() )
+	{
+		DrawVertexArray( (int)vertexes.size(), &vertexes[0] );
+	}
+}
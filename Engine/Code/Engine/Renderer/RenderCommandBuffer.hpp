@@ -0,0 +1,115 @@
+#pragma once
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include <cstdint>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class GPUMesh;
+class Material;
+class RenderContext;
+class Shader;
+class Texture;
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+
+enum eRenderLayer
+{
+	RENDER_LAYER_BACKGROUND,
+	RENDER_LAYER_OPAQUE,
+	RENDER_LAYER_TRANSLUCENT,	// sorted back to front, ahead of state
+	RENDER_LAYER_OVERLAY,
+
+	NUM_RENDER_LAYERS
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// 64-bit sort key, most significant first:
+//   layer:4 | shader:12 | material:12 | texture:16 | depth:20		opaque layers - state first, then front to back
+//   layer:4 | depth:20 | shader:12 | material:12 | texture:16		RENDER_LAYER_TRANSLUCENT - far to near, then state
+// The state fields are hashed pointers; a collision only costs an extra bind on replay, never the wrong state.
+// depth01 is any monotonic 0 (near) to 1 (far) value, e.g. view distance / far distance.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+uint64_t MakeRenderSortKey( eRenderLayer layer, Shader const* shader, Material const* material, Texture const* texture, float depth01 );
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct RenderCommand
+{
+	uint64_t		m_sortKey = 0;
+	Material*		m_material = nullptr;			// when set, binds everything and m_shader/m_texture/m_normalTexture are ignored
+	Shader*			m_shader = nullptr;				// nullptr is the default shader
+	Texture const*	m_texture = nullptr;			// slot 0; nullptr is the default white texture
+	Texture const*	m_normalTexture = nullptr;		// slot 1
+	bool			m_isWireframe = false;			// ignored with a material; its shader state picks the fill mode
+	GPUMesh*		m_mesh = nullptr;				// nullptr: the vertices were recorded into the buffer
+	int				m_firstElement = 0;
+	int				m_numElements = -1;				// -1 with a mesh: all of it
+	Mat44			m_modelMatrix;
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct RenderCommandStats
+{
+	int		m_numCommands = 0;
+	int		m_numDraws = 0;
+	int		m_numBinds = 0;				// shader, material, texture, fill mode and model matrix binds that reached the device
+	int		m_numSkippedBinds = 0;		// the same, already bound
+
+	void	operator+=( RenderCommandStats const& other );
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// A list of draws recorded without touching the device, then sorted and replayed by RenderContext::SubmitCommandBuffers.
+// The setters mirror RenderContext's immediate API; each Draw* snapshots the current state into one command.
+//
+// A buffer is not thread safe - give each recording thread (e.g. each job) its own and submit them together from the
+// render thread, between BeginCamera and EndCamera. Recording only reads the pointers it is given, so meshes, textures
+// and materials must stay alive until the submit. A buffer can be submitted more than once (once per eye) before Reset().
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class RenderCommandBuffer
+{
+	friend class RenderContext;
+
+public:
+	RenderCommandBuffer() = default;
+	~RenderCommandBuffer();
+	RenderCommandBuffer( RenderCommandBuffer const& ) = delete;
+	void operator=( RenderCommandBuffer const& ) = delete;
+
+	void	Reset();	// drops the commands and vertices; keeps the memory
+
+	void	SetLayer( eRenderLayer layer )						{ m_layer = layer; }
+	void	SetDepth( float depth01 )							{ m_depth = depth01; }
+	void	SetMaterial( Material* material )					{ m_material = material; }
+	void	SetShader( Shader* shader )							{ m_shader = shader; }
+	void	SetTexture( Texture const* texture )				{ m_texture = texture; }
+	void	SetNormalTexture( Texture const* texture )			{ m_normalTexture = texture; }
+	void	SetWireframe( bool isWireframe )					{ m_isWireframe = isWireframe; }
+	void	SetModelMatrix( Mat44 const& modelMatrix )			{ m_modelMatrix = modelMatrix; }
+
+	void	DrawMesh( GPUMesh* mesh );
+	void	DrawMesh( GPUMesh* mesh, int firstElement, int numElements );
+	void	DrawVertexArray( int numVertexes, Vertex_PCU const* vertexes );		// copied; uploaded once per submit with the rest
+	void	DrawVertexArray( std::vector<Vertex_PCU> const& vertexes );
+
+	int								GetNumCommands() const		{ return (int)m_commands.size(); }
+	std::vector<RenderCommand> const&	GetCommands() const		{ return m_commands; }
+
+private:
+	RenderCommand&	AddCommand();
+
+private:
+	std::vector<RenderCommand>	m_commands;
+	std::vector<Vertex_PCU>		m_vertices;
+	GPUMesh*					m_vertexMesh = nullptr;			// created and filled on the render thread by the first submit
+	bool						m_areVerticesUploaded = false;
+
+	// current state, copied into each command
+	eRenderLayer				m_layer = RENDER_LAYER_OPAQUE;
+	float						m_depth = 0.f;
+	Material*					m_material = nullptr;
+	Shader*						m_shader = nullptr;
+	Texture const*				m_texture = nullptr;
+	Texture const*				m_normalTexture = nullptr;
+	bool						m_isWireframe = false;
+	Mat44						m_modelMatrix;
+};
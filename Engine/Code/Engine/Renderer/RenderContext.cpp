@@ -4,7 +4,6 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Platform/Window.hpp"
 #include "Engine/Renderer/Shader.hpp"
 #include "Engine/Renderer/ShaderState.hpp"
 #include "Engine/Renderer/Material.hpp"
@@ -13,34 +12,20 @@
 #include "Engine/Renderer/DebugRender.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Renderer/GPUMesh.hpp"
-#include "openvr.h"
+#include "Engine/Renderer/TransientVertexBuffer.hpp"
+#include "Engine/Renderer/NullRenderBackend.hpp"
+#include "Engine/Renderer/LightClusters.hpp"
 
 #pragma warning(push, 3)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #pragma warning(pop)
 
-#if !defined(WIN32_LEAN_AND_MEAN) 
-#define WIN32_LEAN_AND_MEAN
-#endif
-
-#define INITGUID
-#include <d3d11.h>  // d3d11 specific objects
-#include <d3d11_1.h>
-#include <dxgi.h>   // shared library used across multiple dx graphical interfaces
-#include <dxgi1_2.h>
-#include <dxgidebug.h>  // debug utility (mostly used for reporting and analytics)
-#include "Engine/Renderer/D3D11Common.hpp"
 #include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <cstring>
 
-#pragma comment( lib, "d3d11.lib" )        
-#pragma comment( lib, "dxgi.lib" )         
-#pragma comment( lib, "d3dcompiler.lib" )  
-
-#define MSAA_ENABLED
-//#define RENDER_DEBUG
 //#define VR_ENABLED // #ToDo: Remove
-//#define D3D11_DEBUG
 
 // ASCII code from 0 to 127
 constexpr auto MAX_CHAR = 128;
@@ -58,89 +43,41 @@ void RenderContext::StartUp( Window* window )
 	}
 #endif
 
-	//IDXGISwapChain* pSwapChain = nullptr;
-	//IDXGISwapChain1* pSwapChain1 = nullptr;
-
-	//UINT flags = D3D11_CREATE_DEVICE_SINGLETHREADED;
-	UINT flags = 0;
-#if defined(RENDER_DEBUG)
-	flags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
-
-	// Create D3D11 Device
-	HRESULT result;
-	result = D3D11CreateDevice( nullptr,
-		D3D_DRIVER_TYPE_HARDWARE,
-		nullptr,
-		flags,
-		nullptr,
-		0,
-		D3D11_SDK_VERSION,
-		&m_device,
-		nullptr,
-		&m_context );
-
-	GUARANTEE_OR_DIE( SUCCEEDED( result ), "Fail to D3D11 Device" );
-
-	//-------------------------------------------------------------------------------------------------------------
-	IDXGIDevice* dxgiDevice = nullptr;
-	result = m_device->QueryInterface( __uuidof(dxgiDevice), (void**)&dxgiDevice );
-	IDXGIAdapter* dxgiAdapter = nullptr;
-	result = dxgiDevice->GetParent( __uuidof(IDXGIAdapter), (void**)&dxgiAdapter );
-
-	IDXGIFactory* dxgiFactory = nullptr;
-	result = dxgiAdapter->GetParent( __uuidof(IDXGIFactory), (void**)&dxgiFactory  );
-
-	// Create the swap chain
-	IDXGISwapChain* swapchain;
-
-	GUARANTEE_OR_DIE( m_msaa == 1 || m_msaa == 2 || m_msaa == 4 || m_msaa == 8 || m_msaa == 16, "Invalid xMSAA times!" );
-	// Check If x4 MSAA Supported?
-	result = ( m_device->CheckMultisampleQualityLevels( DXGI_FORMAT_R8G8B8A8_UNORM, m_msaa, &m_4xMsaaQuality ) );
-	GUARANTEE_OR_DIE( m_4xMsaaQuality > 0, Stringf( "x%dMSAA is not supported!", m_msaa ) );
-
-	// define the swap chain
-	DXGI_SWAP_CHAIN_DESC swapchainDesc;
-	memset( &swapchainDesc, 0, sizeof( swapchainDesc ) );
-	swapchainDesc.BufferUsage  = DXGI_USAGE_RENDER_TARGET_OUTPUT | DXGI_USAGE_BACK_BUFFER;
-	swapchainDesc.BufferCount = 2;
-	swapchainDesc.Flags = 0;
-	HWND hwnd = (HWND)window->m_hwnd;
-	swapchainDesc.OutputWindow = hwnd; // HWND for the window to be used
-#if defined( MSAA_ENABLED )
-	swapchainDesc.SampleDesc.Count = m_msaa;
-	swapchainDesc.SampleDesc.Quality = m_4xMsaaQuality - 1;
-	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD; 
-#else
-	swapchainDesc.SampleDesc.Count = 1;
-	swapchainDesc.SampleDesc.Quality = 0;
-	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; // on swap, the old buffer is discarded
-#endif
-	swapchainDesc.Windowed = TRUE;
-	swapchainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	swapchainDesc.BufferDesc.Width = window->GetClientWidth();
-	swapchainDesc.BufferDesc.Height = window->GetClientHeight();
-	result = dxgiFactory->CreateSwapChain( m_device, &swapchainDesc, &swapchain );
-
-	dxgiDevice->Release();
-	dxgiAdapter->Release();
-	dxgiFactory->Release();
+	m_backend = CreatePlatformRenderBackend( this, window );
+	m_defaultBackBuffer = m_backend->GetBackBuffer();
+	CreateDefaultResources();
+}
 
-	GUARANTEE_OR_DIE( SUCCEEDED( result ), "Fail to creating Render Context" );
+//-------------------------------------------------------------------------------------------------------------
+void RenderContext::StartUpHeadless()
+{
+	m_backend = new NullRenderBackend( this );
+	CreateDefaultResources();
+}
 
-	m_swapchain = new SwapChain( this, swapchain );
-	m_defaultBackBuffer = m_swapchain->GetBackBuffer();
+//-------------------------------------------------------------------------------------------------------------
+void RenderContext::CreateDefaultResources()
+{
 	m_defaultShader = GetOrCreateShader( "Data/Shaders/Default.hlsl" );
-	CreateDepthStencilBuffer();
-	CreateRasterState();
+
+	m_cullMode = eCullMode::CULL_NONE; // Never throw away triangle, every triangle show on the screen
+	m_fillMode = eFillMode::FILL_SOLID;
+	m_isFrontCCW = true;
+	m_backend->SetRasterState( m_cullMode, m_fillMode, m_isFrontCCW );
 
 	m_frameUBO = new RenderBuffer( this, UNIFORM_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
 	m_modelUBO = new RenderBuffer( this, UNIFORM_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
 	m_tintUBO = new RenderBuffer( this, UNIFORM_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
 	m_lightUBO = new RenderBuffer( this, UNIFORM_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
 	m_materialUBO = new RenderBuffer( this, UNIFORM_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
+	m_lightClusterUBO = new RenderBuffer( this, UNIFORM_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
+	m_clusterLightsSBO = new RenderBuffer( this, STRUCTURED_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
+	m_clusterRangesSBO = new RenderBuffer( this, STRUCTURED_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
+	m_clusterIndicesSBO = new RenderBuffer( this, STRUCTURED_BUFFER_BIT, MEMORY_HINT_DYNAMIC );
 
+	constexpr uint TRANSIENT_VERTEX_CAPACITY = 128 * 1024;		// 3 MB of Vertex_PCU
 	m_immediateMesh = new GPUMesh( this );
+	m_transientVertices = new TransientVertexBuffer( this, TRANSIENT_VERTEX_CAPACITY );
 	m_defaultSampler = new Sampler( this, SAMPLER_ANISOTROPIC );
 	//m_defaultSampler = new Sampler( this, SAMPLER_LINEAR );
 	//m_defaultSampler = new Sampler( this, SAMPLER_POINT );
@@ -151,13 +88,14 @@ void RenderContext::StartUp( Window* window )
 	m_effectCamera = new Camera();
 	m_effectCamera->IntialUBO( this );
 	m_effectCamera->SetClearMode( CLEAR_NONE, Rgba8::WHITE );
-
-	CreateBlendState();
 }	
 
 void RenderContext::BeginFrame()
 {
-	
+	m_backend->BeginFrame();
+	m_transientVertices->BeginFrame();
+	m_lastFrameCommandStats = m_frameCommandStats;
+	m_frameCommandStats = RenderCommandStats();
 }
 
 void RenderContext::UpdateFrameTime( float deltaSeconds )
@@ -195,7 +133,7 @@ void RenderContext::BindMaterialBuffer( RenderBuffer* ubo )
 //-------------------------------------------------------------------------------------------------------------
 void RenderContext::EndFrame()
 {
-	m_swapchain->Present();
+	m_backend->EndFrame();
 }
 
 //-------------------------------------------------------------------------------------------------------------
@@ -217,8 +155,8 @@ void RenderContext::Shutdown()
 	delete m_immediateMesh;
 	m_immediateMesh = nullptr;
 
-	delete m_swapchain;
-	m_swapchain = nullptr;
+	delete m_transientVertices;
+	m_transientVertices = nullptr;
 
 	delete m_frameUBO;
 	m_frameUBO = nullptr;
@@ -235,6 +173,18 @@ void RenderContext::Shutdown()
 	delete m_materialUBO;
 	m_materialUBO = nullptr;
 
+	delete m_lightClusterUBO;
+	m_lightClusterUBO = nullptr;
+
+	delete m_clusterLightsSBO;
+	m_clusterLightsSBO = nullptr;
+
+	delete m_clusterRangesSBO;
+	m_clusterRangesSBO = nullptr;
+
+	delete m_clusterIndicesSBO;
+	m_clusterIndicesSBO = nullptr;
+
 	delete m_frameColorTarget;
 	m_frameColorTarget = nullptr;
 
@@ -262,44 +212,14 @@ void RenderContext::Shutdown()
 	}
 
 
-	//DX_SAFE_RELEASE( m_lastVBO );
-	DX_SAFE_RELEASE( m_alphaBlendState );
-	DX_SAFE_RELEASE( m_additiveBlendState );
-	DX_SAFE_RELEASE( m_opaqueBlendState );
-	DX_SAFE_RELEASE( m_rasterState );
-	DX_SAFE_RELEASE( m_context );
-	DX_SAFE_RELEASE( m_context1 );
-	DX_SAFE_RELEASE( m_depthStencilBuffer );
-	DX_SAFE_RELEASE( m_depthStencilState );
-	DX_SAFE_RELEASE( m_depthStencilView );
-
-#if defined( D3D11_DEBUG )
-	ID3D11Debug* d3dDebug;
-	HRESULT hr = m_device->QueryInterface( __uuidof(ID3D11Debug), reinterpret_cast<void**>(&d3dDebug));
-	if( SUCCEEDED( hr ) ) {
-		hr = d3dDebug->ReportLiveDeviceObjects( D3D11_RLDO_DETAIL | D3D11_RLDO_IGNORE_INTERNAL );
-	}
-	DX_SAFE_RELEASE( d3dDebug );
-#endif
-
-	DX_SAFE_RELEASE( m_device );
-	DX_SAFE_RELEASE( m_device1 );
+	delete m_backend;		// releases the swap chain, depth buffer and device
+	m_backend = nullptr;
 }
 
 //-------------------------------------------------------------------------------------------------------------
 void RenderContext::ClearScreen( const Rgba8& clearColor )
 {
-	float clearFloats[4];
-	clearFloats[0] = (float) clearColor.r / 255.f;
-	clearFloats[1] = (float) clearColor.g / 255.f;
-	clearFloats[2] = (float) clearColor.b / 255.f;
-	clearFloats[3] = (float) clearColor.a / 255.f;
-
-	Texture* backbuffer = m_swapchain->GetBackBuffer();
-	TextureView* backbuffer_rtv = backbuffer->GetRenderTargetView();
-
-	ID3D11RenderTargetView* rtv = backbuffer_rtv->GetAsRTV();
-	m_context->ClearRenderTargetView( rtv, clearFloats );
+	m_backend->ClearScreen( clearColor );
 }
 
 //-------------------------------------------------------------------------------------------------------------
@@ -309,95 +229,9 @@ void RenderContext::BeginCamera( const Camera& camera )
 	m_currentCamera.UpdateUBO(); 
 	m_isDrawing = true;
 
-#if defined(RENDER_DEBUG)
-	m_context->ClearState();
-#endif
-
-	Texture* colorTarget = camera.GetColorTarget();
-	if( !colorTarget )
-	{
-		colorTarget = m_swapchain->GetBackBuffer();
-	}
-
-	std::vector<ID3D11RenderTargetView*> rtvs;
-	int rtvCount = camera.GetColorTargetCount();
-	rtvs.resize( rtvCount );
+	m_backend->BeginCamera( camera );
 
-	if( rtvCount == 0 )
-	{
-		TextureView* view = colorTarget->GetRenderTargetView();
-		ID3D11RenderTargetView* rtv = view->GetAsRTV();
-		m_context->OMSetRenderTargets( 1, &rtv, nullptr );
-	}
-	else
-	{
-		for( int i = 0; i < rtvCount; ++i )
-		{
-			rtvs[i] = nullptr;
-
-			Texture* theColorTarget = camera.GetColorTarget( i );
-			if( theColorTarget != nullptr )
-			{
-				TextureView* rtv = theColorTarget->GetRenderTargetView();
-				rtvs[i] = rtv->GetAsRTV();
-			}
-		}
-	}
-	
-
-	IntVec2 outputSize = colorTarget->GetTexelSize();
-
-	if( camera.m_canClearDepthBuffer ) 
-	{
-		m_context->OMSetRenderTargets( rtvCount, rtvs.data(), m_depthStencilView );
-	}
-	else 
-	{	
-		m_context->OMSetRenderTargets( rtvCount, rtvs.data(), nullptr );
-	}
-
-
-	D3D11_VIEWPORT viewport;
-	viewport.TopLeftX = 0;
-	viewport.TopLeftY = 0;
-#ifdef VR_ENABLED
-	//m_recommendedSize = g_gameConfigBlackboard.GetValue( "RecommendedRenderTargetSize", Vec2::ZERO );
-	viewport.Width = m_recommendedSize.x;
-	viewport.Height = m_recommendedSize.y;
-#else
-	viewport.Width = (float)outputSize.x;	// texture->GetWidth();
-	viewport.Height = (float)outputSize.y;	// texture->GetHeigth();
-#endif
-	
-	viewport.MinDepth = 0.0f;
-	viewport.MaxDepth = 1.0f;
-
-
-
-	m_context->RSSetViewports( 1, &viewport );
-
-	if( eCameraClearBit::CLEAR_COLOR_BIT & camera.m_clearMode ) 
-	{
-		Rgba8 clearColor = camera.GetClearColor();
-		float clearFloats[4];
-		clearFloats[0] = (float)clearColor.r / 255.f;
-		clearFloats[1] = (float)clearColor.g / 255.f;
-		clearFloats[2] = (float)clearColor.b / 255.f;
-		clearFloats[3] = (float)clearColor.a / 255.f;
-
-		//TextureView* backbuffer_rtv = colorTarget->GetRenderTargetView();
-		//ID3D11RenderTargetView* rtv = backbuffer_rtv->GetAsRTV();
-
-		for( int i = 0; i < rtvCount; ++i ) 
-		{
-			if( rtvs[i] != nullptr ) 
-			{
-				m_context->ClearRenderTargetView( rtvs[i], clearFloats );
-			}
-		}
-	}
-
-	m_lastVBO = nullptr;
+	m_lastBoundVBOCreationId = 0;
 
 	SetModelMatrix( Mat44::IDENTITY );
 	UpdateTintColor( Rgba8::WHITE );
@@ -411,36 +245,42 @@ void RenderContext::BeginCamera( const Camera& camera )
 	BindSampler( nullptr );
 
 	SetBlendMode( BlendMode::ALPHA );
-	// Clear Depth only the bool on camera is true
-	if( m_currentCamera.m_canClearDepthBuffer )
-	{
-		m_context->ClearDepthStencilView( m_depthStencilView, D3D11_CLEAR_DEPTH|D3D11_CLEAR_STENCIL, 1.0f, 0 );
-	}	
-
 }
 
 //-------------------------------------------------------------------------------------------------------------
 void RenderContext::EndCamera( const Camera& camera )
 {
 	UNUSED( camera );
-	DX_SAFE_RELEASE( m_depthStencilState );
 }
 
 void RenderContext::DrawVertexArray( int numVertexes, const Vertex_PCU* vertexArray )
 {
-	// Update a vertex buffer
-	/*size_t bufferTotalByteSize = numVertexes * sizeof(Vertex_PCU);
-	size_t elementSize = sizeof(Vertex_PCU);
-	m_immediateVBO->Update( vertexArray, bufferTotalByteSize, elementSize );*/
+	if( numVertexes <= 0 )
+	{
+		return;
+	}
 
-	m_immediateMesh->UpdateVertices( numVertexes, vertexArray );
-	m_immediateMesh->UpdateIndices( 0, nullptr );  // ClearIndices()
+	int firstVertex = m_transientVertices->Append( (uint)numVertexes, vertexArray );
+	if( firstVertex < 0 )
+	{
+		// more than the whole ring holds; give it a buffer of its own
+		m_immediateMesh->UpdateVertices( numVertexes, vertexArray );
+		m_immediateMesh->UpdateIndices( 0, nullptr );  // ClearIndices()
+		DrawMesh( m_immediateMesh );
+		return;
+	}
 
-	DrawMesh( m_immediateMesh );
+	BindVertexBuffer( m_transientVertices->GetVertexBuffer() );
+	Draw( numVertexes, firstVertex );
 }
 
 void RenderContext::DrawVertexArray( const std::vector<Vertex_PCU>& verts )
 {
+	if( verts.empty() )
+	{
+		return;
+	}
+
 	int numVertexes = (int)verts.size();
 	DrawVertexArray( numVertexes, &verts[0] );
 }
@@ -449,14 +289,13 @@ void RenderContext::DrawVertexArray( const std::vector<Vertex_PCU>& verts )
 void RenderContext::Draw( int numVertexes, int vertexOffset )
 {
 	FinalizeState();
-	m_context->Draw( numVertexes, vertexOffset );
+	m_backend->Draw( numVertexes, vertexOffset );
 }
 
 void RenderContext::DrawIndexed( int indexCount, int indexOffset, int vertexOffset )
 {
 	FinalizeState();
-
-	m_context->DrawIndexed( indexCount, indexOffset, vertexOffset );
+	m_backend->DrawIndexed( indexCount, indexOffset, vertexOffset );
 }
 
 void RenderContext::DrawLine( const Vec2& start, const Vec2& end, const Rgba8& color, float thickness )
@@ -488,30 +327,38 @@ void RenderContext::DrawLine( const Vec2& start, const Vec2& end, const Rgba8& c
 
 void RenderContext::DrawRing( const Vec2& center, float radius, const Rgba8& color, float thickness )
 {
-	constexpr float NUM_SIDES = 64.f;
-	constexpr float degreesPerSide = 360.f / NUM_SIDES;
-	for( int i = 0; i < 64; i++ )
-	{
-		thetaDegrees[i] = degreesPerSide * (float)i;
-		innerCircleVertexes[i] = Vertex_PCU( Vec3( radius*CosDegrees( thetaDegrees[i] ), radius*SinDegrees( thetaDegrees[i] ), 0.f ), color, Vec2( 0.f, 0.f ) );
-	}
+	constexpr int NUM_SIDES = 64;
+	constexpr float DEGREES_PER_SIDE = 360.f / (float)NUM_SIDES;
+	constexpr int NUM_VERTS = NUM_SIDES * 6;
 
-	Vertex_PCU localInnerCircleVertexes[64] ={};
-	for( int i = 0; i < 64; i++ )
+	// one quad per side, the same shape DrawLine makes, built into one array so the ring is a single draw
+	float halfThickness = 0.5f * thickness;
+	Vertex_PCU verts[NUM_VERTS];
+	for( int sideIdx = 0; sideIdx < NUM_SIDES; ++sideIdx )
 	{
-		localInnerCircleVertexes[i] = innerCircleVertexes[i];
+		Vec2 start = center + radius * Vec2( CosDegrees( DEGREES_PER_SIDE * (float)sideIdx ), SinDegrees( DEGREES_PER_SIDE * (float)sideIdx ) );
+		Vec2 end = center + radius * Vec2( CosDegrees( DEGREES_PER_SIDE * (float)( sideIdx + 1 ) ), SinDegrees( DEGREES_PER_SIDE * (float)( sideIdx + 1 ) ) );
+
+		Vec2 fwd = end - start;
+		fwd.SetLength( halfThickness );
+		Vec2 left = fwd.GetRotated90Degrees();
+
+		Vec2 endLeft = end + fwd + left;
+		Vec2 endRight = end + fwd - left;
+		Vec2 startLeft = start - fwd + left;
+		Vec2 startRight = start - fwd - left;
+
+		Vertex_PCU* quad = &verts[sideIdx * 6];
+		quad[0] = Vertex_PCU( Vec3( startRight.x, startRight.y, 0.f ), color, Vec2( 0.f, 0.f ) );
+		quad[1] = Vertex_PCU( Vec3( endRight.x, endRight.y, 0.f ), color, Vec2( 0.f, 0.f ) );
+		quad[2] = Vertex_PCU( Vec3( endLeft.x, endLeft.y, 0.f ), color, Vec2( 0.f, 0.f ) );
+
+		quad[3] = Vertex_PCU( Vec3( startRight.x, startRight.y, 0.f ), color, Vec2( 0.f, 0.f ) );
+		quad[4] = Vertex_PCU( Vec3( endLeft.x, endLeft.y, 0.f ), color, Vec2( 0.f, 0.f ) );
+		quad[5] = Vertex_PCU( Vec3( startLeft.x, startLeft.y, 0.f ), color, Vec2( 0.f, 0.f ) );
 	}
-	TransfromVertexesArray( 64, localInnerCircleVertexes, 1.f, 0.f, center );
-	for( int i = 0; i < 63; i++ )
-	{
-		g_theRenderer->DrawLine( Vec2( localInnerCircleVertexes[i].m_position.x, localInnerCircleVertexes[i].m_position.y ),
-			Vec2( localInnerCircleVertexes[i+1].m_position.x, localInnerCircleVertexes[i+1].m_position.y ),
-			color, thickness );
-	}
-	g_theRenderer->DrawLine( Vec2( localInnerCircleVertexes[63].m_position.x, localInnerCircleVertexes[63].m_position.y ),
-		Vec2( localInnerCircleVertexes[0].m_position.x, localInnerCircleVertexes[0].m_position.y ),
-		color, thickness );
 
+	DrawVertexArray( NUM_VERTS, verts );
 }
 
 void RenderContext::DrawAABB2( const AABB2& bounds, const Rgba8& tint )
@@ -574,6 +421,188 @@ void RenderContext::DrawMesh( GPUMesh* mesh )
 	}
 }
 
+void RenderContext::DrawMesh( GPUMesh* mesh, int firstElement, int numElements )
+{
+	BindVertexBuffer( mesh->GetVertexBuffer() );
+
+	bool hasIndices = mesh->GetIndexCount() > 0;
+	if( hasIndices )
+	{
+		BindIndexBuffer( mesh->GetIndexBuffer() );
+		DrawIndexed( numElements, firstElement, 0 );
+	}
+	else
+	{
+		Draw( numElements, firstElement );
+	}
+}
+
+RenderCommandStats RenderContext::SubmitCommandBuffer( RenderCommandBuffer& buffer )
+{
+	RenderCommandBuffer* buffers[] = { &buffer };
+	return SubmitCommandBuffers( buffers, 1 );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+// Replay tracks what it has bound itself, starting from "unknown" on every submit, so immediate-mode binds made
+// between submits can never leave it with a stale idea of the device state.
+//-------------------------------------------------------------------------------------------------------------
+RenderCommandStats RenderContext::SubmitCommandBuffers( RenderCommandBuffer* const* buffers, int numBuffers )
+{
+	RenderCommandStats stats;
+
+	m_commandSortScratch.clear();
+	for( int bufferIdx = 0; bufferIdx < numBuffers; ++bufferIdx )
+	{
+		RenderCommandBuffer* buffer = buffers[bufferIdx];
+		if( !buffer->m_vertices.empty() && !buffer->m_areVerticesUploaded )
+		{
+			if( buffer->m_vertexMesh == nullptr )
+			{
+				buffer->m_vertexMesh = new GPUMesh( this );
+			}
+			buffer->m_vertexMesh->UpdateVertices( buffer->m_vertices );
+			buffer->m_vertexMesh->UpdateIndices( 0, nullptr );
+			buffer->m_areVerticesUploaded = true;
+		}
+
+		std::vector<RenderCommand> const& commands = buffer->m_commands;
+		for( int commandIdx = 0; commandIdx < (int)commands.size(); ++commandIdx )
+		{
+			m_commandSortScratch.push_back( { commands[commandIdx].m_sortKey, (uint32_t)bufferIdx, (uint32_t)commandIdx } );
+		}
+	}
+
+	// ties keep recording order, so a submit is deterministic regardless of how the sort handles equal keys
+	std::sort( m_commandSortScratch.begin(), m_commandSortScratch.end(), []( RenderCommandSortEntry const& a, RenderCommandSortEntry const& b )
+	{
+		if( a.m_sortKey != b.m_sortKey )
+		{
+			return a.m_sortKey < b.m_sortKey;
+		}
+		if( a.m_bufferIdx != b.m_bufferIdx )
+		{
+			return a.m_bufferIdx < b.m_bufferIdx;
+		}
+		return a.m_commandIdx < b.m_commandIdx;
+	} );
+
+	bool isStateKnown = false;
+	bool isTextureKnown[2] = { false, false };
+	Material* boundMaterial = nullptr;
+	Shader* boundShader = nullptr;
+	Texture const* boundTextures[2] = { nullptr, nullptr };
+	Mat44 boundModelMatrix;
+	bool isModelMatrixKnown = false;
+	eFillMode fillModeBeforeSubmit = m_fillMode;
+	bool isFillModeKnown = false;
+	bool isWireframeBound = false;
+
+	for( RenderCommandSortEntry const& entry : m_commandSortScratch )
+	{
+		RenderCommandBuffer* buffer = buffers[entry.m_bufferIdx];
+		RenderCommand const& command = buffer->m_commands[entry.m_commandIdx];
+		++stats.m_numCommands;
+
+		if( command.m_material != nullptr )
+		{
+			if( !isStateKnown || boundMaterial != command.m_material )
+			{
+				BindMaterial( command.m_material );
+				++stats.m_numBinds;
+				isStateKnown = true;
+				boundMaterial = command.m_material;
+				boundShader = m_currentShader;
+				isTextureKnown[0] = isTextureKnown[1] = false;	// the material may have bound any slot
+				isFillModeKnown = false;						// and its shader state sets the fill mode
+			}
+			else
+			{
+				++stats.m_numSkippedBinds;
+			}
+		}
+		else
+		{
+			if( !isStateKnown || boundMaterial != nullptr || boundShader != command.m_shader )
+			{
+				BindShader( command.m_shader );
+				++stats.m_numBinds;
+				isStateKnown = true;
+				boundMaterial = nullptr;
+				boundShader = command.m_shader;
+			}
+			else
+			{
+				++stats.m_numSkippedBinds;
+			}
+
+			Texture const* textures[2] = { command.m_texture, command.m_normalTexture };
+			for( int slot = 0; slot < 2; ++slot )
+			{
+				if( !isTextureKnown[slot] || boundTextures[slot] != textures[slot] )
+				{
+					BindTexture( textures[slot], slot );
+					++stats.m_numBinds;
+					isTextureKnown[slot] = true;
+					boundTextures[slot] = textures[slot];
+				}
+				else
+				{
+					++stats.m_numSkippedBinds;
+				}
+			}
+
+			if( !isFillModeKnown || isWireframeBound != command.m_isWireframe )
+			{
+				SetFillMode( command.m_isWireframe ? eFillMode::FILL_WIREFRAME : eFillMode::FILL_SOLID );
+				++stats.m_numBinds;
+				isFillModeKnown = true;
+				isWireframeBound = command.m_isWireframe;
+			}
+			else
+			{
+				++stats.m_numSkippedBinds;
+			}
+		}
+
+		if( !isModelMatrixKnown || memcmp( &boundModelMatrix, &command.m_modelMatrix, sizeof( Mat44 ) ) != 0 )
+		{
+			SetModelMatrix( command.m_modelMatrix );
+			++stats.m_numBinds;
+			isModelMatrixKnown = true;
+			boundModelMatrix = command.m_modelMatrix;
+		}
+		else
+		{
+			++stats.m_numSkippedBinds;
+		}
+
+		if( command.m_mesh == nullptr )
+		{
+			DrawMesh( buffer->m_vertexMesh, command.m_firstElement, command.m_numElements );
+		}
+		else if( command.m_numElements < 0 )
+		{
+			DrawMesh( command.m_mesh );
+		}
+		else
+		{
+			DrawMesh( command.m_mesh, command.m_firstElement, command.m_numElements );
+		}
+		++stats.m_numDraws;
+	}
+
+	// immediate-mode code after the submit keeps the fill mode it had before
+	if( m_fillMode != fillModeBeforeSubmit )
+	{
+		SetFillMode( fillModeBeforeSubmit );
+	}
+
+	m_frameCommandStats += stats;
+	return stats;
+}
+
+//-------------------------------------------------------------------------------------------------------------
 void RenderContext::DrawOBB2( const OBB2& box, const Rgba8& tint )
 {
 	Vec2 center = box.GetCenter();
@@ -603,22 +632,21 @@ void RenderContext::DrawOBB2( const OBB2& box, const Rgba8& tint )
 
 void RenderContext::DrawDisc( const Vec2& center, float radius, const Rgba8& tint )
 {
-	std::vector<Vertex_PCU> verts;
+	constexpr int NUM_SLICES = 36;
+	constexpr float PER_SLICE_DEGREES = 360.f / (float)NUM_SLICES;
+	constexpr int NUM_VERTS = NUM_SLICES * 3;
 
-	constexpr float numSlices = 36.f; 
-	const float perSliceDegrees = 360.f / numSlices;
+	Vertex_PCU verts[NUM_VERTS];
 	Vec2 DispForDrawingHalfCircle = Vec2( 1.f, 0.f ) * radius;
-	float currentDegrees = 0.f;
-	while( currentDegrees < 360.f )
+	for( int sliceIdx = 0; sliceIdx < NUM_SLICES; ++sliceIdx )
 	{
-		verts.push_back( Vertex_PCU( center, tint, Vec2::ZERO ) );
-		verts.push_back( Vertex_PCU( center + DispForDrawingHalfCircle, tint, Vec2::ZERO ) );
-		DispForDrawingHalfCircle.RotateDegrees( perSliceDegrees );
-		verts.push_back( Vertex_PCU( center + DispForDrawingHalfCircle, tint, Vec2::ZERO ) );
-		currentDegrees += perSliceDegrees;
+		verts[sliceIdx * 3 + 0] = Vertex_PCU( center, tint, Vec2::ZERO );
+		verts[sliceIdx * 3 + 1] = Vertex_PCU( center + DispForDrawingHalfCircle, tint, Vec2::ZERO );
+		DispForDrawingHalfCircle.RotateDegrees( PER_SLICE_DEGREES );
+		verts[sliceIdx * 3 + 2] = Vertex_PCU( center + DispForDrawingHalfCircle, tint, Vec2::ZERO );
 	}
 
-	DrawVertexArray( verts );
+	DrawVertexArray( NUM_VERTS, verts );
 }
 
 void RenderContext::DrawCapsule( const Capsule2& capsule, const Rgba8& tint )
@@ -701,9 +729,7 @@ void RenderContext::BindShader( Shader* shader )
 		m_shaderHasChanged = true; 
 	}
 
-	m_context->VSSetShader( m_currentShader->m_vertexStage.m_vs, nullptr, 0 );
-	m_context->RSSetState( m_rasterState ); // Use default stage
-	m_context->PSSetShader( m_currentShader->m_fragmentStage.m_fs, nullptr, 0 );
+	m_backend->BindShader( m_currentShader );
 }
 
 void RenderContext::BindShaderStateFromName( const char* shaderStateName )
@@ -773,7 +799,14 @@ Shader* RenderContext::GetOrCreateShader( const char* filename )
 	}
 	Shader* shader = new Shader( this );
 
-	shader->CreateFromFile( filename );
+	if( IsHeadless() )
+	{
+		shader->m_filePath = filename;
+	}
+	else
+	{
+		shader->CreateFromFile( filename );
+	}
 
 	m_shaderVector.push_back( shader );
 
@@ -798,28 +831,7 @@ ShaderState* RenderContext::GetShaderState( const char* filename )
 
 Texture* RenderContext::CreateRenderTarget( IntVec2 texelSize )
 {
-	D3D11_TEXTURE2D_DESC desc;
-	desc.Width = texelSize.x;
-	desc.Height = texelSize.y;
-	desc.MipLevels = 0;
-	desc.ArraySize = 1;
-	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	desc.SampleDesc.Count = 1;
-	desc.SampleDesc.Quality = 0;
-	desc.Usage = D3D11_USAGE_DEFAULT;
-	desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-	desc.CPUAccessFlags = 0;
-	desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
-	
-	ID3D11Texture2D* texHandle = nullptr;
-	HRESULT hResult = m_device->CreateTexture2D( &desc, nullptr, &texHandle );
-	if( FAILED( hResult ) )
-	{
-		ERROR_AND_DIE( "Failed on CreateRenderTarget!" );
-	}
-
-	Texture* texture = new Texture( this, texHandle );
-	return texture;
+	return m_backend->CreateRenderTarget( texelSize );
 }
 
 Texture* RenderContext::AcquireRenderTargetMatching( Texture* texture )
@@ -857,12 +869,17 @@ void RenderContext::ReleaseRenderTarget( Texture* texture )
 
 Texture* RenderContext::GetBackBuffer() const
 {
-	return m_swapchain->m_backbuffer;
+	return m_backend->GetBackBuffer();
 }
 
 void RenderContext::CopyTexture( Texture* dst, Texture* src )
 {
-	m_context->CopyResource( dst->GetHandle(), src->GetHandle() );
+	m_backend->CopyTexture( dst, src );
+}
+
+void RenderContext::ResolveTexture( Texture* dst, Texture* src )
+{
+	m_backend->ResolveTexture( dst, src );
 }
 
 void RenderContext::StartEffecct( Texture* dst, Texture* src, Shader* shader )
@@ -878,9 +895,8 @@ void RenderContext::StartEffecct( Texture* dst, Texture* src, Shader* shader )
 
 void RenderContext::EndEffect()
 {
-	m_context->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
 	FinalizeState();
-	m_context->Draw(3, 0);
+	m_backend->DrawFullScreenTriangle();
 	EndCamera( *m_effectCamera );
 }
 
@@ -893,58 +909,35 @@ Texture* RenderContext::GetFrameColorTarget()
 void RenderContext::BindVertexBuffer( VertexBuffer* vbo )
 {
 	m_lastBoundVBO = vbo;
-	
-	ID3D11Buffer* vboHandle = vbo->m_handle;
-	UINT stride = vbo->GetElementStride(); // how far from one vertex to next
-	UINT offset = 0;
 
-	if( m_lastVBO != vboHandle )
+	// compared by creation id - a buffer that grew has a new device buffer at the same address
+	if( m_lastBoundVBOCreationId != vbo->m_creationId )
 	{
-		m_context->IASetVertexBuffers( 0, 1, &vboHandle, &stride, &offset );
-		m_context->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-		m_lastVBO = vboHandle;
+		m_backend->BindVertexBuffer( vbo );
+		m_lastBoundVBOCreationId = vbo->m_creationId;
 		m_currentLayout = vbo->GetLayout();
 	}
 }
 
 void RenderContext::BindIndexBuffer( IndexBuffer* ibo )
 {
-	ID3D11Buffer* handle = nullptr;
-
-	if( ibo != nullptr ) {
-		handle = ibo->m_handle;
-	}
-
-	m_context->IASetIndexBuffer( handle, DXGI_FORMAT_R32_UINT, 0 );
+	m_backend->BindIndexBuffer( ibo );
 }
 
 void RenderContext::BindUniformBuffer( uint slot, RenderBuffer* ubo )
 {
-	ID3D11Buffer* uboHandle = ubo->m_handle;
-
-	m_context->VSSetConstantBuffers( slot, 1, &uboHandle );
-	m_context->PSSetConstantBuffers( slot, 1, &uboHandle );
+	m_backend->BindUniformBuffer( slot, ubo );
 }
 
 void RenderContext::BindUniformBuffer( uint slot, const Camera* camera )
 {
-	ID3D11Buffer* uboHandle = camera->m_cameraUBO->m_handle;
-
-	m_context->VSSetConstantBuffers( slot, 1, &uboHandle );
-	m_context->PSSetConstantBuffers( slot, 1, &uboHandle );
+	m_backend->BindUniformBuffer( slot, camera->m_cameraUBO );
 }
 
 
 void RenderContext::BindTexture( const Texture* constTex )
 {
-	Texture* texture = const_cast<Texture*>( constTex );
-	if( texture == nullptr ) {
-		texture = m_defaultColorTex;
-	}
-
-	TextureView* shaderResourceView = texture->GetOrCreateShaderResourceView();
-	ID3D11ShaderResourceView* srvHandle = shaderResourceView->GetAsSRV();
-	m_context->PSSetShaderResources( 0, 1, &srvHandle );
+	BindTexture( constTex, 0 );
 }
 
 void RenderContext::BindTexture( const Texture* constTex, const int slot )
@@ -954,55 +947,27 @@ void RenderContext::BindTexture( const Texture* constTex, const int slot )
 		texture = m_defaultColorTex;
 	}
 
-	TextureView* shaderResourceView = texture->GetOrCreateShaderResourceView();
-	ID3D11ShaderResourceView* srvHandle = shaderResourceView->GetAsSRV();
-	m_context->PSSetShaderResources( slot, 1, &srvHandle );
+	m_backend->BindTexture( slot, texture );
 }
 
 void RenderContext::BindNormalTexture( const Texture* constTex )
 {
-	Texture* texture = const_cast<Texture*>(constTex);
-	if( texture == nullptr ) {
-		texture = m_defaultColorTex;
-	}
-
-	TextureView* shaderResourceView = texture->GetOrCreateShaderResourceView();
-	ID3D11ShaderResourceView* srvHandle = shaderResourceView->GetAsSRV();
-	m_context->PSSetShaderResources( 1, 1, &srvHandle );
+	BindTexture( constTex, 1 );
 }
 
 void RenderContext::BindSpecularTexture( const Texture* constTex )
 {
-	Texture* texture = const_cast<Texture*>(constTex);
-	if( texture == nullptr ) {
-		texture = m_defaultColorTex;
-	}
-
-	TextureView* shaderResourceView = texture->GetOrCreateShaderResourceView();
-	ID3D11ShaderResourceView* srvHandle = shaderResourceView->GetAsSRV();
-	m_context->PSSetShaderResources( 2, 1, &srvHandle );
+	BindTexture( constTex, 2 );
 }
 
 void RenderContext::BindPatternTexture( const Texture* constTex )
 {
-	Texture* texture = const_cast<Texture*>(constTex);
-	if( texture == nullptr ) {
-		texture = m_defaultColorTex;
-	}
-
-	TextureView* shaderResourceView = texture->GetOrCreateShaderResourceView();
-	ID3D11ShaderResourceView* srvHandle = shaderResourceView->GetAsSRV();
-	m_context->PSSetShaderResources( 8, 1, &srvHandle );
+	BindTexture( constTex, 8 );
 }
 
 void RenderContext::BindSampler( Sampler* sampler )
 {
-	if( sampler == nullptr ) {
-		sampler = m_defaultSampler;
-	}
-
-	ID3D11SamplerState* samplerHandle = sampler->GetHandle();
-	m_context->PSSetSamplers( 0, 1, &samplerHandle );
+	BindSampler( sampler, 0 );
 }
 
 void RenderContext::BindSampler( Sampler* sampler, const int slot )
@@ -1011,8 +976,7 @@ void RenderContext::BindSampler( Sampler* sampler, const int slot )
 		sampler = m_defaultSampler;
 	}
 
-	ID3D11SamplerState* samplerHandle = sampler->GetHandle();
-	m_context->PSSetSamplers( slot, 1, &samplerHandle );
+	m_backend->BindSampler( slot, sampler );
 }
 
 Texture* RenderContext::CreateTextureFromFile( const char* filePath )
@@ -1023,6 +987,19 @@ Texture* RenderContext::CreateTextureFromFile( const char* filePath )
 	int numComponents = 0; // This will be filled in for us to indicate how many color components the image had (e.g. 3=RGB=24bit, 4=RGBA=32bit)
 	int numComponentsRequested = 4; // don't care; we support 3 (24-bit RGB) or 4 (32-bit RGBA)
 
+	if( IsHeadless() )
+	{
+		// only the header is read; without the file it is still a usable 1x1
+		if( !stbi_info( filePath, &imageTexelSizeX, &imageTexelSizeY, &numComponents ) )
+		{
+			imageTexelSizeX = 1;
+			imageTexelSizeY = 1;
+		}
+		Texture* texture = m_backend->CreateTexture( filePath, IntVec2( imageTexelSizeX, imageTexelSizeY ), nullptr );
+		m_textureVector.push_back( texture );
+		return texture;
+	}
+
 	// Load (and decompress) the image RGB(A) bytes from a file on disk into a memory buffer (array of bytes)
 	stbi_set_flip_vertically_on_load( 1 ); // We prefer uvTexCoords has origin (0,0) at BOTTOM LEFT
 	unsigned char* imageData = stbi_load( filePath, &imageTexelSizeX, &imageTexelSizeY, &numComponents, numComponentsRequested );
@@ -1031,36 +1008,11 @@ Texture* RenderContext::CreateTextureFromFile( const char* filePath )
 	GUARANTEE_OR_DIE( imageData, Stringf( "Failed to load image \"%s\"", filePath ) );
 	GUARANTEE_OR_DIE( numComponents >= 3 && numComponents <= 4 && imageTexelSizeX > 0 && imageTexelSizeY > 0, Stringf( "ERROR loading image \"%s\" (Bpp=%i, size=%i,%i)", filePath, numComponents, imageTexelSizeX, imageTexelSizeY ) );
 	
-	D3D11_TEXTURE2D_DESC desc;
-	desc.Width = imageTexelSizeX;
-	desc.Height = imageTexelSizeY;
-	desc.MipLevels = 0;		// We want all the mipmap levels down to 1x1
-	desc.ArraySize = 1;
-	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	desc.SampleDesc.Count = 1;
-	desc.SampleDesc.Quality = 0;
-	desc.Usage = D3D11_USAGE_DEFAULT;
-	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;	// GPU needs to be able to write back to this texture, the texture needs to be final output of the pipeline
-	desc.CPUAccessFlags = 0;
-	desc.MiscFlags = D3D11_RESOURCE_MISC_GENERATE_MIPS;
-
-	//D3D11_SUBRESOURCE_DATA initialData;
-	//initialData.pSysMem = imageData;
-	//initialData.SysMemPitch = imageTexelSizeX * 4;
-	//initialData.SysMemSlicePitch = 0;
-
-	ID3D11Texture2D* texHandle = nullptr;
-	//m_device->CreateTexture2D( &desc, &initialData, &texHandle );
-	m_device->CreateTexture2D( &desc, nullptr, &texHandle );
-	GUARANTEE_OR_DIE( texHandle, "RenderContext::CreateTextureFromFile failed to setup texHandle" );
-
-	// write image data into mip level
-	m_context->UpdateSubresource( texHandle, 0u, nullptr, imageData, imageTexelSizeX * 4, 0u );
+	Texture* texture = m_backend->CreateTexture( filePath, IntVec2( imageTexelSizeX, imageTexelSizeY ), imageData );
 
 	// Free the raw image texel data now that we've sent a copy of it down to the GPU to be stored in video memory
 	stbi_image_free( imageData );
 
-	Texture* texture = new Texture( filePath, this, texHandle );
 	m_textureVector.push_back( texture );
 	return texture;
 }
@@ -1076,115 +1028,13 @@ void RenderContext::FinalizeState()
 {
 	if( m_lastBoundLayout != m_currentLayout || m_shaderHasChanged )
 	{
-		ID3D11InputLayout* layout = m_currentShader->GetOrCreateInputLayout( m_currentLayout );
-		m_context->IASetInputLayout( layout );
+		m_backend->BindInputLayout( m_currentShader, m_currentLayout );
 
 		m_lastBoundLayout = m_currentLayout;
 		m_shaderHasChanged = false;
 	}
 }
 
-bool RenderContext::CreateDepthStencilBuffer()
-{
-	HRESULT result;
-	D3D11_TEXTURE2D_DESC depthBufferDesc;
-
-	ZeroMemory( &depthBufferDesc, sizeof( depthBufferDesc ) );
-
-	// Set up the description of the depth buffer.
-	
-#ifdef VR_ENABLED
-	//m_recommendedSize = g_gameConfigBlackboard.GetValue( "RecommendedRenderTargetSize", Vec2::ZERO );
-	depthBufferDesc.Width = (UINT)m_recommendedSize.x;
-	depthBufferDesc.Height = (UINT)m_recommendedSize.y;
-#else
-	depthBufferDesc.Width = g_theWindow->GetClientWidth();
-	depthBufferDesc.Height = g_theWindow->GetClientHeight();
-#endif
-	depthBufferDesc.MipLevels = 1;
-	depthBufferDesc.ArraySize = 1;
-	depthBufferDesc.Format = DXGI_FORMAT_D32_FLOAT;
-#if defined( MSAA_ENABLED )
-	depthBufferDesc.SampleDesc.Count = m_msaa;
-	depthBufferDesc.SampleDesc.Quality = m_4xMsaaQuality - 1;
-#else
-	depthBufferDesc.SampleDesc.Count = 1;
-	depthBufferDesc.SampleDesc.Quality = 0;
-#endif
-	depthBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	depthBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-	depthBufferDesc.CPUAccessFlags = 0;
-	depthBufferDesc.MiscFlags = 0;
-
-	// Create the texture for the depth buffer using the filled out description.
-	result = m_device->CreateTexture2D( &depthBufferDesc, NULL, &m_depthStencilBuffer );
-	if( FAILED( result ) )
-	{
-		return false;
-	}
-
-	D3D11_DEPTH_STENCIL_DESC depthStencilDesc;
-	// Initialize the description of the stencil state.
-	ZeroMemory( &depthStencilDesc, sizeof( depthStencilDesc ) );
-
-	// Set up the description of the stencil state.
-	depthStencilDesc.DepthEnable = true;
-	depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-	depthStencilDesc.DepthFunc = D3D11_COMPARISON_LESS;
-
-	depthStencilDesc.StencilEnable = true;
-	depthStencilDesc.StencilReadMask = 0xFF;
-	depthStencilDesc.StencilWriteMask = 0xFF;
-
-	// Stencil operations if pixel is front-facing.
-	depthStencilDesc.FrontFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_INCR;
-	depthStencilDesc.FrontFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
-
-	// Stencil operations if pixel is back-facing.
-	depthStencilDesc.BackFace.StencilFailOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.BackFace.StencilDepthFailOp = D3D11_STENCIL_OP_DECR;
-	depthStencilDesc.BackFace.StencilPassOp = D3D11_STENCIL_OP_KEEP;
-	depthStencilDesc.BackFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
-
-	// Create the depth stencil state.
-	result = m_device->CreateDepthStencilState( &depthStencilDesc, &m_depthStencilState );
-	if( FAILED( result ) )
-	{
-		return false;
-	}
-
-	// Bind the depth-stencil state.
-	m_context->OMSetDepthStencilState( m_depthStencilState, 1 );
-
-
-	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc;
-	// Initialize the depth stencil view.
-	ZeroMemory( &depthStencilViewDesc, sizeof( depthStencilViewDesc ) );
-
-	// Set up the depth stencil view description.
-	depthStencilViewDesc.Format = DXGI_FORMAT_D32_FLOAT;
-#if defined( MSAA_ENABLED )
-	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DMS;
-#else
-	depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
-#endif
-	depthStencilViewDesc.Texture2D.MipSlice = 0;
-
-	// Create the depth stencil view.
-	result = m_device->CreateDepthStencilView( m_depthStencilBuffer, &depthStencilViewDesc, &m_depthStencilView );
-	if( FAILED( result ) )
-	{
-		return false;
-	}
-
-	// Bind the render target view and depth stencil buffer to the output render pipeline.
-	//m_context->OMSetRenderTargets( 1, &m_renderTargetView, m_depthStencilView );
-
-	return true;
-}
-
 BitmapFont* RenderContext::CreateBitmapFontFromFile( const char* FontFilePath )
 {
 	//BitmapFont* m_bitmapFont;
@@ -1218,33 +1068,7 @@ Vec3 RenderContext::ConvertRgba8ToVec3( Rgba8 rgba8 ) const
 void RenderContext::EnableDepth( eCompareOp op, bool write )
 {
 	//ASSERT_OR_DIE( m_currentCamera != nullptr, "Only call between BeginCamera and EndCamera" );
-
-	// ID3D11DepthStencilState* m_depthStencilState = nullptr; 
-	if( m_depthStencilState != nullptr ) {
-		DX_SAFE_RELEASE( m_depthStencilState );
-	}
-
-	D3D11_DEPTH_STENCIL_DESC desc;
-	memset( &desc, 0, sizeof( desc ) ); 
-
-	desc.DepthEnable = TRUE;
-	desc.DepthWriteMask = write ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
-	switch( op )
-	{
-	case eCompareOp::COMPARE_FUNC_NEVER:			desc.DepthFunc = D3D11_COMPARISON_NEVER;			break;
-	case eCompareOp::COMPARE_FUNC_LESS:				desc.DepthFunc = D3D11_COMPARISON_LESS;				break;
-	case eCompareOp::COMPARE_FUNC_EQUAL:			desc.DepthFunc = D3D11_COMPARISON_EQUAL;			break;
-	case eCompareOp::COMPARE_FUNC_LEQUAL:			desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;		break;
-	case eCompareOp::COMPARE_FUNC_GREATER:			desc.DepthFunc = D3D11_COMPARISON_GREATER;			break;
-	case eCompareOp::COMPARE_FUNC_NOT_EQUAL:		desc.DepthFunc = D3D11_COMPARISON_NOT_EQUAL;		break;
-	case eCompareOp::COMPARE_FUNC_GEQUAL:			desc.DepthFunc = D3D11_COMPARISON_GREATER_EQUAL;	break;
-	case eCompareOp::COMPARE_FUNC_ALWAYS:			desc.DepthFunc = D3D11_COMPARISON_ALWAYS;			break;
-	default:
-		break;
-	}
-
-	m_device->CreateDepthStencilState( &desc, &m_depthStencilState );
-	m_context->OMSetDepthStencilState( m_depthStencilState, 0 );
+	m_backend->SetDepthState( op, write );
 }
 
 void RenderContext::DisableDepth() 
@@ -1254,9 +1078,7 @@ void RenderContext::DisableDepth()
 
 void RenderContext::ClearDepth( Texture* depthStencilTexture, float depth, uint stencil )
 {
-	TextureView* view = depthStencilTexture->GetOrCreateShaderResourceView();
-	ID3D11DepthStencilView* dsv = view->GetAsDSV();
-	m_context->ClearDepthStencilView( dsv, D3D11_CLEAR_DEPTH, depth, (UINT8)stencil ); 
+	m_backend->ClearDepth( depthStencilTexture, depth, stencil );
 }
 
 Texture* RenderContext::CreateOrGetTextureFromFile( const char* imageFileType )
@@ -1269,146 +1091,22 @@ Texture* RenderContext::CreateOrGetTextureFromFile( const char* imageFileType )
 	return CreateTextureFromFile( imageFileType );
 }
 
-void RenderContext::CreateBlendState()
+void RenderContext::SetCullMode( eCullMode newCullMode )
 {
-	D3D11_BLEND_DESC alphaDesc;
-	alphaDesc.AlphaToCoverageEnable = false;
-	alphaDesc.IndependentBlendEnable = false;
-	alphaDesc.RenderTarget[0].BlendEnable = true;
-	alphaDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
-	alphaDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
-	alphaDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
-
-	alphaDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
-	alphaDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
-	alphaDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
-	alphaDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
-
-	m_device->CreateBlendState( &alphaDesc, &m_alphaBlendState );
-
-
-
-	D3D11_BLEND_DESC additiveDesc;
-	additiveDesc.AlphaToCoverageEnable = false;
-	additiveDesc.IndependentBlendEnable = false;
-	additiveDesc.RenderTarget[0].BlendEnable = true;
-	additiveDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
-	additiveDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
-	additiveDesc.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
-
-	additiveDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
-	additiveDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
-	additiveDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
-	additiveDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
-
-	m_device->CreateBlendState( &additiveDesc, &m_additiveBlendState );
-
-
-
-	D3D11_BLEND_DESC opaqueDesc;
-	opaqueDesc.AlphaToCoverageEnable = false;
-	opaqueDesc.IndependentBlendEnable = false;
-	opaqueDesc.RenderTarget[0].BlendEnable = false;
-	opaqueDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
-	opaqueDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
-	opaqueDesc.RenderTarget[0].DestBlend = D3D11_BLEND_ZERO;
-
-	opaqueDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
-	opaqueDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
-	opaqueDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
-	opaqueDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
-
-	m_device->CreateBlendState( &opaqueDesc, &m_opaqueBlendState );
-}
-
-void RenderContext::CreateRasterState()
-{
-	D3D11_RASTERIZER_DESC desc;
-
-	desc.FillMode = D3D11_FILL_SOLID;
-	desc.CullMode = D3D11_CULL_NONE; // Never throw away triangle, every triangle show on the screen
-	desc.FrontCounterClockwise = TRUE; // the only reason we're doing this; 
-	desc.DepthBias = 0U;
-	desc.DepthBiasClamp = 0.0f;
-	desc.SlopeScaledDepthBias = 0.0f;
-	desc.DepthClipEnable = TRUE;
-	desc.ScissorEnable = FALSE;
-#if defined ( MSAA_ENABLED )
-	desc.MultisampleEnable = TRUE;
-	desc.AntialiasedLineEnable = TRUE;
-#else
-	desc.MultisampleEnable = FALSE;
-	desc.AntialiasedLineEnable = FALSE;
-#endif
-	
-	m_device->CreateRasterizerState( &desc, &m_rasterState );
+	m_cullMode = newCullMode;
+	m_backend->SetRasterState( m_cullMode, m_fillMode, m_isFrontCCW );
 }
 
-void RenderContext::SetCullMode( D3D11_CULL_MODE newCullMode )
+void RenderContext::SetFillMode( eFillMode newFillMode )
 {
-	if( m_rasterState == nullptr ) {
-		ERROR_AND_DIE( "Failed to set rasterizer state: The rasterizer state is nullptr." );
-	}
-
-	D3D11_RASTERIZER_DESC desc;
-	m_rasterState->GetDesc( &desc );
-	if( desc.CullMode != newCullMode )
-	{
-		desc.CullMode = newCullMode;
-	}
-
-	ID3D11RasterizerState* tempRasterState;
-	m_device->CreateRasterizerState( &desc, &tempRasterState );
-	m_context->RSSetState( tempRasterState );
-
-	DX_SAFE_RELEASE( m_rasterState );
-	m_rasterState = tempRasterState;
-
-	/*m_device->CreateRasterizerState( &desc, &m_rasterState );*/
-}
-
-void RenderContext::SetFillMode( D3D11_FILL_MODE newFillMode )
-{
-	if( m_rasterState == nullptr ) {
-		ERROR_AND_DIE( "Failed to set rasterizer state: The rasterizer state is nullptr." );
-	}
-
-	D3D11_RASTERIZER_DESC desc;
-	m_rasterState->GetDesc( &desc );
-
-	if( desc.FillMode != newFillMode ) {
-		desc.FillMode = newFillMode;
-	}
-
-	ID3D11RasterizerState* tempRasterState;
-	m_device->CreateRasterizerState( &desc, &tempRasterState );
-	m_context->RSSetState( tempRasterState );
-
-	DX_SAFE_RELEASE( m_rasterState );
-	m_rasterState = tempRasterState;
+	m_fillMode = newFillMode;
+	m_backend->SetRasterState( m_cullMode, m_fillMode, m_isFrontCCW );
 }
 
 void RenderContext::SetFrontCounterClockwise( bool isCCW )
 {
-	if( m_rasterState == nullptr ) {
-		ERROR_AND_DIE( "Failed to set rasterizer state: The rasterizer state is nullptr." );
-	}
-
-	D3D11_RASTERIZER_DESC desc;
-	m_rasterState->GetDesc( &desc );
-
-	if( isCCW ) {
-		desc.FrontCounterClockwise = TRUE;
-	}
-	else {
-		desc.FrontCounterClockwise = FALSE;
-	}
-	ID3D11RasterizerState* tempRasterState;
-	m_device->CreateRasterizerState( &desc, &tempRasterState );
-	m_context->RSSetState( tempRasterState );
-
-	DX_SAFE_RELEASE( m_rasterState );
-	m_rasterState = tempRasterState;
+	m_isFrontCCW = isCCW;
+	m_backend->SetRasterState( m_cullMode, m_fillMode, m_isFrontCCW );
 }
 
 
@@ -1455,6 +1153,47 @@ void RenderContext::DisableLight( uint idx )
 	m_lightConstants.lights[idx].intensity = 0.f;
 }
 
+//-------------------------------------------------------------------------------------------------------------
+// A device buffer can't be empty, so an empty list uploads one default element nothing points at
+template <typename T>
+static void UpdateStructuredBuffer( RenderBuffer* buffer, std::vector<T> const& elements )
+{
+	T const placeholder = T();
+	T const* data = elements.empty() ? &placeholder : elements.data();
+	size_t numElements = elements.empty() ? 1 : elements.size();
+	buffer->Update( data, numElements * sizeof( T ), sizeof( T ) );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void RenderContext::BindLightClusters( LightClusterGrid const& grid )
+{
+	light_cluster_constants_t constants;
+	constants.tiles_x = (uint)grid.GetTilesX();
+	constants.tiles_y = (uint)grid.GetTilesY();
+	constants.num_slices = (uint)grid.GetNumSlices();
+	constants.near_depth = grid.GetNearDepth();
+	constants.far_depth = grid.GetFarDepth();
+	constants.slice_scale = grid.GetSliceScale();
+
+	m_lightClusterUBO->Update( &constants, sizeof( constants ), sizeof( constants ) );
+	UpdateStructuredBuffer( m_clusterLightsSBO, grid.GetPackedLights() );
+	UpdateStructuredBuffer( m_clusterRangesSBO, grid.GetClusterRanges() );
+	UpdateStructuredBuffer( m_clusterIndicesSBO, grid.GetLightIndices() );
+
+	BindUniformBuffer( UBO_LIGHT_CLUSTER_SLOT, m_lightClusterUBO );
+	m_backend->BindStructuredBuffer( SBO_CLUSTER_LIGHTS_SLOT, m_clusterLightsSBO );
+	m_backend->BindStructuredBuffer( SBO_CLUSTER_RANGES_SLOT, m_clusterRangesSBO );
+	m_backend->BindStructuredBuffer( SBO_CLUSTER_INDICES_SLOT, m_clusterIndicesSBO );
+}
+
+//-------------------------------------------------------------------------------------------------------------
+void RenderContext::DisableLightClusters()
+{
+	light_cluster_constants_t constants;
+	m_lightClusterUBO->Update( &constants, sizeof( constants ), sizeof( constants ) );
+	BindUniformBuffer( UBO_LIGHT_CLUSTER_SLOT, m_lightClusterUBO );
+}
+
 void RenderContext::EnableFog( float nearFog, float farFog, Rgba8 nearFogColor, Rgba8 farFogColor )
 {
 	m_lightConstants.fog_near_distance = nearFog;
@@ -1591,14 +1330,49 @@ void RenderContext::SetSpecularPower( const float specularPower )
 
 void RenderContext::SetBlendMode( BlendMode blendMode )
 {
-	float const zeros[] = { 0.f, 0.f, 0.f, 0.f };
+	m_backend->SetBlendMode( blendMode );
+}
 
-	switch( blendMode )
-	{
-	case BlendMode::ALPHA:		m_context->OMSetBlendState( m_alphaBlendState, zeros, ~(UINT)0 );		break;
-	case BlendMode::ADDITIVE:	m_context->OMSetBlendState( m_additiveBlendState, zeros, ~(UINT)0 );	break;
-	case BlendMode::_OPAQUE:	m_context->OMSetBlendState( m_opaqueBlendState, zeros, ~(UINT)0 );		break;
-	}
+
+
+
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( render_command_stats, "" )
+{
+	UNUSED( args );
+	RenderCommandStats const& stats = g_theRenderer->GetLastFrameCommandStats();
+	int numBindRequests = stats.m_numBinds + stats.m_numSkippedBinds;
+	float skippedPercent = numBindRequests > 0 ? 100.f * (float)stats.m_numSkippedBinds / (float)numBindRequests : 0.f;
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Last frame: %i commands, %i draws, %i binds, %i skipped (%.1f%%)",
+		stats.m_numCommands, stats.m_numDraws, stats.m_numBinds, stats.m_numSkippedBinds, skippedPercent ) );
 }
 
+//-------------------------------------------------------------------------------------------------------------
+COMMAND( render_backend_stats, "" )
+{
+	UNUSED( args );
+	TransientVertexStats const& ringStats = g_theRenderer->m_transientVertices->GetLastFrameStats();
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Transient vertices: %i appends, %i vertices of %u, %i wraps, %i discards",
+		ringStats.m_numAppends, ringStats.m_numVertices, g_theRenderer->m_transientVertices->GetCapacity(), ringStats.m_numWraps, ringStats.m_numDiscards ) );
 
+	RenderBackend* backend = g_theRenderer->m_backend;
+	RenderBackendStats const* stats = backend->GetLastFrameStats();
+	if( stats == nullptr )
+	{
+		g_theConsole->Error( "The %s render backend does not count; start up headless for backend stats", backend->GetName() );
+		return;
+	}
+
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Last frame (%s): %i draw calls (%i indexed), %i elements, %i cameras, %i clears",
+		backend->GetName(), stats->GetNumDrawCalls(), stats->m_numDrawIndexed, stats->m_numPrimitiveElements, stats->m_numCameras, stats->m_numClears ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Buffers: %i created, %i destroyed, %i updates, %i discards",
+		stats->m_numBufferCreates, stats->m_numBufferDestroys, stats->m_numBufferUpdates, stats->m_numBufferDiscards ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "Uploads: vertex %u B (%i), index %u B (%i), uniform %u B (%i)",
+		(uint)stats->m_uploadedBytes[RENDER_BACKEND_VERTEX_BUFFER], stats->m_numUploads[RENDER_BACKEND_VERTEX_BUFFER],
+		(uint)stats->m_uploadedBytes[RENDER_BACKEND_INDEX_BUFFER], stats->m_numUploads[RENDER_BACKEND_INDEX_BUFFER],
+		(uint)stats->m_uploadedBytes[RENDER_BACKEND_UNIFORM_BUFFER], stats->m_numUploads[RENDER_BACKEND_UNIFORM_BUFFER] ) );
+	g_theConsole->PrintString( Rgba8::WHITE, Stringf( "State changes: %i - shader %i, layout %i, vbo %i, ibo %i, ubo %i, texture %i, sampler %i, blend %i, depth %i, raster %i",
+		stats->GetNumStateChanges(), stats->m_numShaderBinds, stats->m_numInputLayoutBinds, stats->m_numVertexBufferBinds,
+		stats->m_numIndexBufferBinds, stats->m_numUniformBufferBinds, stats->m_numTextureBinds, stats->m_numSamplerBinds,
+		stats->m_numBlendStateChanges, stats->m_numDepthStateChanges, stats->m_numRasterStateChanges ) );
+}
@@ -4,32 +4,21 @@
 #include "Engine/Core/Vertex_PCUTBN.hpp"
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/Texture.hpp"
-#include "Engine/Renderer/SwapChain.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
+#include "Engine/Renderer/RenderCommandBuffer.hpp"
+#include "Engine/Renderer/RenderBackend.hpp"
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/OBB2.hpp"
 #include "Engine/Math/OBB3.hpp"
 #include "Engine/Math/Vec4.hpp"
 #include "Engine/Math/Capsule2.hpp"
-#include "Engine/Platform/Window.hpp"
 #include <vector>
 
 typedef unsigned int uint;
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------
-struct ID3D11Device;
-struct ID3D11Device1;
-struct ID3D11DeviceContext;
-struct ID3D11DeviceContext1;
-struct ID3D11Buffer;
-struct ID3D11BlendState;
-struct ID3D11RasterizerState;
-struct ID3D11DepthStencilState;
-struct ID3D11DepthStencilView;
-enum D3D11_CULL_MODE : int;
-enum D3D11_FILL_MODE : int;
-//-------------------------------------------------------------------------------------------------------------------------------------------------
+class Window;
 class Shader;
 class ShaderState;
 class Material;
@@ -38,6 +27,8 @@ class VertexBuffer;
 class IndexBuffer;
 class Sampler;
 class GPUMesh;
+class TransientVertexBuffer;
+class LightClusterGrid;
 //-------------------------------------------------------------------------------------------------------------------------------------------------
 
 enum class eCompareOp
@@ -52,6 +43,19 @@ enum class eCompareOp
 	COMPARE_FUNC_NOT_EQUAL,
 };
 
+enum class eCullMode
+{
+	CULL_NONE,
+	CULL_FRONT,
+	CULL_BACK,
+};
+
+enum class eFillMode
+{
+	FILL_WIREFRAME,
+	FILL_SOLID,
+};
+
 enum class eAttenuationMode
 {
 	ATTENUATION_LINEAR,
@@ -88,6 +92,12 @@ enum eBufferSlot
 {
 	UBO_FRAME_SLOT = 0,
 	UBO_CAMERA_SLOT = 1,
+	UBO_LIGHT_CLUSTER_SLOT = 6,
+
+	// structured buffers, pixel stage t-registers
+	SBO_CLUSTER_LIGHTS_SLOT = 14,
+	SBO_CLUSTER_RANGES_SLOT = 15,
+	SBO_CLUSTER_INDICES_SLOT = 16,
 };
 
 struct frame_data_t
@@ -196,11 +206,28 @@ struct light_constants_t
 	float fog_pad01;
 };
 
+// light_cluster_constants in Common.hlsl; num_slices 0 turns clustered lights off
+struct light_cluster_constants_t
+{
+	uint tiles_x = 0;
+	uint tiles_y = 0;
+	uint num_slices = 0;
+	uint cluster_pad00 = 0;
+
+	float near_depth = 0.f;		// clip w
+	float far_depth = 0.f;
+	float slice_scale = 0.f;	// slice = log( depth / near_depth ) * slice_scale
+	float cluster_pad01 = 0.f;
+};
+
 
 class RenderContext 
 {
 public:
 	void StartUp( Window* window );
+	// No window, device or swap chain: everything goes to a NullRenderBackend, which counts it. For benchmarks and
+	// tests of CPU-side render code; shaders are not compiled, textures have a size but no texels, effects are unavailable.
+	void StartUpHeadless();
 	void BeginFrame();
 	void EndFrame();
 	void Shutdown();
@@ -220,6 +247,7 @@ public:
 	void Draw( int numVertexes, int vertexOffset = 0 );
 	void DrawIndexed( int indexCount, int indexOffset = 0, int vertexOffset = 0 );
 	void DrawMesh( GPUMesh* mesh );
+	void DrawMesh( GPUMesh* mesh, int firstElement, int numElements );	// indices if the mesh has them, vertices otherwise
 	void DrawLine( const Vec2& start, const Vec2& end, const Rgba8& color, float thickness );
 	void DrawRing( const Vec2& center, float radius, const Rgba8& color, float thickness );
 	void DrawAABB2( const AABB2& bounds, const Rgba8& tint );
@@ -229,6 +257,12 @@ public:
 	void DrawCapsule( const Capsule2& capsule, const Rgba8& tint );
 	void DrawPolygon( const std::vector<Vec2> points, const Rgba8& tint );
 
+	// Sorts the commands of every buffer together and replays them, skipping binds of state that is already bound.
+	// Call between BeginCamera and EndCamera, on the render thread.
+	RenderCommandStats SubmitCommandBuffers( RenderCommandBuffer* const* buffers, int numBuffers );
+	RenderCommandStats SubmitCommandBuffer( RenderCommandBuffer& buffer );
+	RenderCommandStats const& GetLastFrameCommandStats() const	{ return m_lastFrameCommandStats; }
+
 	void BindTexture( const Texture* constTex );
 	void BindTexture( const Texture* constTex, const int slot);
 	void BindNormalTexture( const Texture* constTex );
@@ -258,6 +292,7 @@ public:
 	Texture* GetBackBuffer() const;
 
 	void CopyTexture( Texture* dst, Texture* src );
+	void ResolveTexture( Texture* dst, Texture* src );	// multisampled src, e.g. the back buffer, into a single-sampled dst of its size
 	//void ApplyEffect( Texture* dst, Texture* src, Material* mat );
 
 	void StartEffecct( Texture* dst, Texture* src, Shader* shader );
@@ -271,21 +306,20 @@ public:
 
 	Vec3 ConvertRgba8ToVec3( Rgba8 rgba8 ) const;
 	bool IsDrawing() { return m_isDrawing; }
+	bool IsHeadless() const { return m_backend != nullptr && m_backend->IsHeadless(); }
 
 public:
 	void FinalizeState();
-	bool CreateDepthStencilBuffer();
 
 	BitmapFont* CreateBitmapFontFromFile( const char* FontFilePath );
 	Texture* CreateTextureFromFile( const char* ImageFilePath );
 	Texture* CreateTextureFromColor( Rgba8 color );
 
 
-	void CreateRasterState();
-	void CreateBlendState();
+	void CreateDefaultResources();
 	void SetBlendMode( BlendMode blendMode );
-	void SetCullMode( D3D11_CULL_MODE newCullMode );
-	void SetFillMode( D3D11_FILL_MODE newFillMode );
+	void SetCullMode( eCullMode newCullMode );
+	void SetFillMode( eFillMode newFillMode );
 	void SetFrontCounterClockwise( bool isCCW );
 	void SetModelMatrix( Mat44 const& mat );
 
@@ -298,6 +332,11 @@ public:
 	void EnableLight( uint idx, light_t lightInfo );
 	void DisableLight( uint idx );
 
+	// Point and spot lights past the fixed eight: uploads a grid built for the camera about to render, and lit shaders
+	// add the lights of each pixel's cluster. Stays bound until the next call.
+	void BindLightClusters( LightClusterGrid const& grid );
+	void DisableLightClusters();
+
 	//------------------------------------------------------------------------------------------------
 	// Fog
 	//------------------------------------------------------------------------------------------------
@@ -325,22 +364,19 @@ private:
 	std::vector< ShaderState* > m_shaderStateList;
 
 	std::vector<Texture*> m_renderTargetPool;
-	int m_totalRenderTargetMade = 0;	// determine if leaking, debug purpose
 
-	float thetaDegrees[64] = {};
-	Vertex_PCU innerCircleVertexes[64] = {};
+	struct RenderCommandSortEntry
+	{
+		uint64_t	m_sortKey;
+		uint32_t	m_bufferIdx;
+		uint32_t	m_commandIdx;
+	};
+	std::vector<RenderCommandSortEntry> m_commandSortScratch;
+	RenderCommandStats m_frameCommandStats;
+	RenderCommandStats m_lastFrameCommandStats;
+	int m_totalRenderTargetMade = 0;	// determine if leaking, debug purpose
 
 public:
-	ID3D11Device*	m_device = nullptr;
-	ID3D11Device1*	m_device1 = nullptr;
-	ID3D11DeviceContext* m_context = nullptr; // immediate context
-	ID3D11DeviceContext1* m_context1 = nullptr; 
-	SwapChain* m_swapchain = nullptr;
-	//----------------------------------------------------
-	ID3D11Texture2D* m_depthStencilBuffer;
-	ID3D11DepthStencilState* m_depthStencilState;
-	ID3D11DepthStencilView* m_depthStencilView;
-	//----------------------------------------------------
 	Shader*			m_defaultShader		= nullptr;
 	Shader*			m_currentShader		= nullptr;
 	Texture*		m_frameColorTarget	= nullptr;
@@ -350,25 +386,28 @@ public:
 	RenderBuffer* m_tintUBO = nullptr;
 	RenderBuffer* m_lightUBO = nullptr;
 	RenderBuffer* m_materialUBO = nullptr;
+	RenderBuffer* m_lightClusterUBO = nullptr;
+	RenderBuffer* m_clusterLightsSBO = nullptr;		// packed light_t
+	RenderBuffer* m_clusterRangesSBO = nullptr;		// LightClusterRange per cluster
+	RenderBuffer* m_clusterIndicesSBO = nullptr;	// uint into the packed lights
 	
 	GPUMesh*		m_immediateMesh	= nullptr;
+	TransientVertexBuffer* m_transientVertices = nullptr;	// DrawVertexArray appends here; m_immediateMesh only takes what the ring can't
 	VertexBuffer*	m_lastBoundVBO	= nullptr;
 	IndexBuffer*	m_indicesBuffer = nullptr;
 
-	ID3D11DepthStencilState* m_currentDepthStencilState = nullptr; 
-
-	ID3D11Buffer* m_lastVBO = nullptr;
+	uint m_lastBoundVBOCreationId = 0;
 	bool m_isDrawing = false;
 
 	Sampler* m_defaultSampler = nullptr;
 	Texture* m_defaultColorTex = nullptr;
 	Texture* m_defaultBackBuffer = nullptr;
 
-	ID3D11BlendState* m_alphaBlendState;
-	ID3D11BlendState* m_additiveBlendState;
-	ID3D11BlendState* m_opaqueBlendState;
+	RenderBackend* m_backend = nullptr;		// owns the device, swap chain and depth buffer
 
-	ID3D11RasterizerState* m_rasterState = nullptr;
+	eCullMode m_cullMode = eCullMode::CULL_NONE;
+	eFillMode m_fillMode = eFillMode::FILL_SOLID;
+	bool m_isFrontCCW = true;
 
 	buffer_attribute_t const* m_lastBoundLayout;
 	buffer_attribute_t const* m_currentLayout;
@@ -394,7 +433,6 @@ public:
 	// VR Related
 	Vec2 m_recommendedSize = Vec2::ZERO;
 
-	// MSAA
-	UINT m_msaa = 4;
-	UINT m_4xMsaaQuality = 1;
+	// MSAA, read by the device backend when it makes the swap chain and depth buffer
+	uint m_msaa = 4;
 };
@@ -3,7 +3,7 @@
 struct ID3D11SamplerState;
 class RenderContext;
 
-enum eSamplerType
+enum eSamplerType : int
 {
 	SAMPLER_POINT,
 	SAMPLER_BILINEAR,
@@ -22,5 +22,5 @@ public:
 
 public:
 	RenderContext* m_owner;
-	ID3D11SamplerState* m_handle;
+	ID3D11SamplerState* m_handle = nullptr;		// made and released by the render backend; nullptr when headless
 };
@@ -13,35 +13,24 @@ struct ID3D11InputLayout;
 struct ID3D10Blob;
 
 
-enum eShaderType
+enum eShaderType : int
 {
 	SHADER_TYPE_VERTEX,
 	SHADER_TYPE_FRAGMENT,
 };
 
+// Compiled and released by the render backend (RenderBackend::CreateShaderStage and DestroyShader)
 class ShaderStage
 {
 public:
-	~ShaderStage();
-
-	bool Compile( RenderContext* ctx,
-		std::string const& filename,
-		void const* source, // East const style
-		size_t const sourceByteLen,
-		eShaderType stage );
-
 	bool IsValid() const { return ( nullptr != m_handle); }
 
-	void const* GetByteCode() const;
-	size_t GetByteCodeLength() const;
-
-
 public:
 	eShaderType m_type;
 	ID3D10Blob* m_byteCode = nullptr; 
 	union 
 	{
-			ID3D11Resource *m_handle;
+			ID3D11Resource *m_handle = nullptr;
 			ID3D11VertexShader *m_vs;
 			ID3D11PixelShader *m_fs;
 	};
@@ -58,9 +47,6 @@ public:
 	std::string GetFilePath() { return m_filePath; }
 	
 
-	//ID3D11InputLayout* GetOrCreateInputLayout();
-	ID3D11InputLayout* GetOrCreateInputLayout( buffer_attribute_t const* layout );
-
 public:
 	RenderContext* m_owner = nullptr; 
 	ShaderStage m_vertexStage;
@@ -69,7 +55,7 @@ public:
 	std::string m_filePath;
 
 	//ID3D11RasterizerState* m_rasterState = nullptr;
-	ID3D11InputLayout* m_inputLayout;
+	ID3D11InputLayout* m_inputLayout = nullptr;		// made by the backend on the first BindInputLayout
 
 	//buffer_attribute_t const* m_lastUsedLayout;
 };
@@ -94,33 +94,33 @@ eCompareOp ShaderState::GetDepthTestModeFromText( const std::string text )
 	}
 }
 
-D3D11_CULL_MODE ShaderState::GetCullModeFromText( const std::string& text )
+eCullMode ShaderState::GetCullModeFromText( const std::string& text )
 {
-	D3D11_CULL_MODE mode = D3D11_CULL_BACK;
+	eCullMode mode = eCullMode::CULL_BACK;
 
 	if( text == "Back" || text == "back" ) {
-		mode =  D3D11_CULL_MODE::D3D11_CULL_BACK;
+		mode =  eCullMode::CULL_BACK;
 	}
 	if( text == "Front" || text == "front" ) {
-		mode = D3D11_CULL_MODE::D3D11_CULL_FRONT;
+		mode = eCullMode::CULL_FRONT;
 	}
 	if( text == "None" || text == "none" ) {
-		mode = D3D11_CULL_MODE::D3D11_CULL_NONE;
+		mode = eCullMode::CULL_NONE;
 	}
 
 	return mode;
 	//ERROR_AND_DIE( "Failed to load cull mode from xml file." );
 }
 
-D3D11_FILL_MODE ShaderState::GetFillModeFromText( const std::string& text )
+eFillMode ShaderState::GetFillModeFromText( const std::string& text )
 {
-	D3D11_FILL_MODE mode = D3D11_FILL_SOLID;
+	eFillMode mode = eFillMode::FILL_SOLID;
 
 	if( text == "Wireframe" || text == "wireframe" ) {
-		mode = D3D11_FILL_MODE::D3D11_FILL_WIREFRAME;
+		mode = eFillMode::FILL_WIREFRAME;
 	}
 	if( text == "Solid" || text == "front" ) {
-		mode = D3D11_FILL_MODE::D3D11_FILL_SOLID;
+		mode = eFillMode::FILL_SOLID;
 	}
 	
 	return mode;
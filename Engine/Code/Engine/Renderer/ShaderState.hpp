@@ -1,7 +1,6 @@
 #pragma once
 #include "Engine/Core/XmlUtils.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
-#include <d3d11.h>
 
 //-----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 class Shader;
@@ -19,8 +18,8 @@ public:
 private:
 	BlendMode GetBlendModeFromText( const std::string& text );
 	eCompareOp GetDepthTestModeFromText( const std::string text );
-	D3D11_CULL_MODE GetCullModeFromText ( const std::string& text );
-	D3D11_FILL_MODE GetFillModeFromText( const std::string& text );
+	eCullMode GetCullModeFromText ( const std::string& text );
+	eFillMode GetFillModeFromText( const std::string& text );
 
 public:
 	Shader* m_shader = nullptr;
@@ -28,8 +27,8 @@ public:
 	eCompareOp m_depthTest		= eCompareOp::COMPARE_FUNC_LEQUAL;
 	bool m_writeDepth			= true;
 	bool m_isWindingOrderCCW	= true;
-	D3D11_CULL_MODE m_culling	= D3D11_CULL_BACK;
-	D3D11_FILL_MODE m_fillMode	= D3D11_FILL_SOLID;
+	eCullMode m_culling			= eCullMode::CULL_BACK;
+	eFillMode m_fillMode		= eFillMode::FILL_SOLID;
 
 	std::string m_filePath;
 
@@ -1,39 +1,26 @@
 #pragma once
 #include "Engine/Math/IntVec2.hpp"
 #include "Engine/Renderer/TextureView.hpp"
-#include "Engine/Platform/Window.hpp"
 #include <string>
 
 struct Vec2;
-struct Rgba8;
 class RenderContext;
 struct ID3D11Texture2D;
-struct ID3D11DepthStencilView;
 
 typedef unsigned int uint; 
 
-extern Window* g_theWindow;
-
 
 class Texture {
 
 public:
-	Texture( const char* filePath, RenderContext* ctx, ID3D11Texture2D* handle );
-	Texture( RenderContext* ctx, ID3D11Texture2D* handle );
-	Texture( const Rgba8& color ,RenderContext* ctx, ID3D11Texture2D* handle );
-	//Texture( const Texture* copyFrom, bool multiSample = false );
-	Texture( const Texture* copyFrom );
+	// Made by the render backend; handle is nullptr for a headless texture, which is sized but has no device texture
+	Texture( const char* filePath, RenderContext* ctx, IntVec2 const& texelSize, ID3D11Texture2D* handle = nullptr );
 
 	~Texture();
 
 	TextureView* GetRenderTargetView();
 	TextureView* GetOrCreateShaderResourceView();
 
-	ID3D11Texture2D* CreateDepthStencilBuffer();
-	ID3D11DepthStencilView* GetOrCreateDepthStencilView();
-
-	static Texture* CreateDepthStencilBuffer( RenderContext* ctx, uint width, uint height );
-
 	RenderContext* GetRenderContext() const { return m_owner; }
 
 	int GetTextureID() const { return m_textureID; }
@@ -54,8 +41,5 @@ private:
 	TextureView* m_renderTargetView = nullptr;
 	TextureView* m_shaderResourceView = nullptr;
 
-	ID3D11DepthStencilView* m_depthStencilView = nullptr;
-	ID3D11Texture2D* m_depthStencilBuffer;
-
 	IntVec2		m_dimensions = IntVec2(0,0);
-};
\ No newline at end of file
+};
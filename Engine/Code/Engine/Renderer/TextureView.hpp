@@ -5,10 +5,9 @@ struct ID3D11ShaderResourceView;
 struct ID3D11DepthStencilView;
 struct ID3D11Resource;
 
+// One device view of a Texture. The render backend makes it and releases the handle (RenderBackend::DestroyTextureView).
 class TextureView {
 public:
-	TextureView();
-	~TextureView();
 	ID3D11RenderTargetView*		GetAsRTV() const { return m_rtv; }
 	ID3D11ShaderResourceView*	GetAsSRV() const { return m_srv; }
 	ID3D11DepthStencilView*		GetAsDSV() const { return m_dsv; }
@@ -16,7 +15,7 @@ public:
 public:
 	union
 	{
-		ID3D11Resource* m_handle;
+		ID3D11Resource* m_handle = nullptr;
 		ID3D11RenderTargetView* m_rtv;
 		ID3D11ShaderResourceView* m_srv;
 		ID3D11DepthStencilView* m_dsv;
@@ -0,0 +1,67 @@
+#include "Engine/Renderer/TransientVertexBuffer.hpp"
+#include "Engine/Renderer/RenderBuffer.hpp"
+
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+TransientVertexBuffer::TransientVertexBuffer( RenderContext* owner, uint vertexCapacity )
+	: m_capacity( vertexCapacity )
+{
+	m_buffer = new VertexBuffer( owner, MEMORY_HINT_DYNAMIC );
+	m_buffer->Reserve( vertexCapacity, sizeof( Vertex_PCU ), Vertex_PCU::LAYOUT );
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+TransientVertexBuffer::~TransientVertexBuffer()
+{
+	delete m_buffer;
+	m_buffer = nullptr;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+void TransientVertexBuffer::BeginFrame()
+{
+	m_lastFrameStats = m_frameStats;
+	m_frameStats = TransientVertexStats();
+
+	++m_frameIndex;
+	m_frameStarts[m_frameIndex % ( TRANSIENT_FRAMES_IN_FLIGHT + 1 )] = m_head;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+int TransientVertexBuffer::Append( uint vcount, Vertex_PCU const* vertices )
+{
+	if( vcount == 0 || vcount > m_capacity ) {
+		return -1;
+	}
+
+	// a draw can't straddle the end of the ring, so the tail is skipped when it doesn't fit
+	uint64_t position = m_head;
+	uint offset = (uint)( position % m_capacity );
+	bool isWrapping = offset + vcount > m_capacity;
+	if( isWrapping ) {
+		position += m_capacity - offset;
+		offset = 0;
+	}
+
+	// everything from the oldest frame the GPU may still be reading up to the new end has to fit in the ring at once
+	uint64_t liveStart = m_frameStarts[( m_frameIndex + 1 ) % ( TRANSIENT_FRAMES_IN_FLIGHT + 1 )];
+	bool isDiscarding = m_needsDiscard || position + vcount - liveStart > m_capacity;
+	if( isDiscarding ) {
+		// the fresh buffer holds nothing anyone draws from, so the frames before this point stop counting
+		for( int frameIdx = 0; frameIdx < TRANSIENT_FRAMES_IN_FLIGHT + 1; ++frameIdx ) {
+			m_frameStarts[frameIdx] = position;
+		}
+		m_needsDiscard = false;
+		++m_frameStats.m_numDiscards;
+	}
+	else if( isWrapping ) {
+		++m_frameStats.m_numWraps;
+	}
+
+	m_buffer->UpdateRange( vertices, (size_t)offset * sizeof( Vertex_PCU ), (size_t)vcount * sizeof( Vertex_PCU ), isDiscarding );
+	m_head = position + vcount;
+
+	++m_frameStats.m_numAppends;
+	m_frameStats.m_numVertices += (int)vcount;
+	return (int)offset;
+}
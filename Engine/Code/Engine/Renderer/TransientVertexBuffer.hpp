@@ -0,0 +1,56 @@
+#pragma once
+#include "Engine/Core/Vertex_PCU.hpp"
+#include <cstdint>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class RenderContext;
+class VertexBuffer;
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+
+constexpr int TRANSIENT_FRAMES_IN_FLIGHT = 3;		// DXGI's default maximum frame latency
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+struct TransientVertexStats
+{
+	int		m_numAppends = 0;
+	int		m_numVertices = 0;
+	int		m_numWraps = 0;			// went back to the start of the ring, no copy
+	int		m_numDiscards = 0;		// the ring was still in use by frames in flight; the buffer was renamed instead
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+// One large dynamic vertex buffer that immediate-mode geometry is appended into, each draw at its own offset, so a
+// frame's quads, discs and text share one buffer and one bind instead of re-uploading a mesh per primitive.
+//
+// Appends never overwrite what the last TRANSIENT_FRAMES_IN_FLIGHT frames wrote: going back to the start of the
+// ring is only allowed once those frames are done with it. When they are not (a frame wrote more than the ring can
+// spare), the buffer is discarded and the driver hands out fresh memory - correct, just no longer free.
+//-------------------------------------------------------------------------------------------------------------------------------------------------
+class TransientVertexBuffer
+{
+public:
+	TransientVertexBuffer( RenderContext* owner, uint vertexCapacity );
+	~TransientVertexBuffer();
+
+	void	BeginFrame();
+
+	// Returns the first vertex of the copy, to draw from with the buffer bound; -1 if the ring could never hold it.
+	int		Append( uint vcount, Vertex_PCU const* vertices );
+
+	VertexBuffer*				GetVertexBuffer() const			{ return m_buffer; }
+	uint						GetCapacity() const				{ return m_capacity; }
+	TransientVertexStats const&	GetLastFrameStats() const		{ return m_lastFrameStats; }
+
+private:
+	VertexBuffer*			m_buffer = nullptr;
+	uint					m_capacity = 0;
+
+	// positions count vertices ever written, so "still in flight" is a plain comparison; the ring offset is position % capacity
+	uint64_t				m_head = 0;
+	uint64_t				m_frameStarts[TRANSIENT_FRAMES_IN_FLIGHT + 1] = {};		// this frame and the ones the GPU may still be reading
+	uint					m_frameIndex = 0;
+	bool					m_needsDiscard = true;		// the first write into a fresh buffer
+
+	TransientVertexStats	m_frameStats;
+	TransientVertexStats	m_lastFrameStats;
+};